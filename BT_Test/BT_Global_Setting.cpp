@@ -817,6 +817,51 @@ int InitializeGlobalSettingContainers(void)
         exit(1);
     }
 
+    setting.type = BT_SETTING_TYPE_INTEGER;
+	g_BTGlobalSettingParam.VSA_SAVE_CAPTURE_ARCHIVE = 0;	
+    if (sizeof(int)==sizeof(g_BTGlobalSettingParam.VSA_SAVE_CAPTURE_ARCHIVE))    // Type_Checking
+    {
+        setting.value = (void*)&g_BTGlobalSettingParam.VSA_SAVE_CAPTURE_ARCHIVE;
+        setting.unit  = "";
+        setting.helpText  = "A flag that to save captures in the background capture archive (compressed, indexed by DUT serial number and test item), 0: OFF, 1: ON, Default is 0.";
+        g_BTGlobalSettingParamMap.insert( pair<string, BT_SETTING_STRUCT>("VSA_SAVE_CAPTURE_ARCHIVE", setting) );
+    }
+    else    
+    {
+        printf("Parameter Type Error!\n");
+        exit(1);
+    }
+
+    setting.type = BT_SETTING_TYPE_STRING;
+    strcpy_s(g_BTGlobalSettingParam.VSA_SAVE_CAPTURE_ARCHIVE_PATH, MAX_BUFFER_SIZE, "./log/capture_archive");
+    if (MAX_BUFFER_SIZE==sizeof(g_BTGlobalSettingParam.VSA_SAVE_CAPTURE_ARCHIVE_PATH))    // Type_Checking
+    {
+        setting.value = (void*)g_BTGlobalSettingParam.VSA_SAVE_CAPTURE_ARCHIVE_PATH;
+        setting.unit  = "";
+        setting.helpText = "Directory of the capture archive and its capture_index.csv.\r\nDefault is ./log/capture_archive";
+        g_BTGlobalSettingParamMap.insert( pair<string, BT_SETTING_STRUCT>("VSA_SAVE_CAPTURE_ARCHIVE_PATH", setting) );
+    }
+    else    
+    {
+        printf("Parameter Type Error!\n");
+        exit(1);
+    }
+
+    setting.type = BT_SETTING_TYPE_INTEGER;
+	g_BTGlobalSettingParam.VSA_SAVE_CAPTURE_QUOTA_MB = 1024;	
+    if (sizeof(int)==sizeof(g_BTGlobalSettingParam.VSA_SAVE_CAPTURE_QUOTA_MB))    // Type_Checking
+    {
+        setting.value = (void*)&g_BTGlobalSettingParam.VSA_SAVE_CAPTURE_QUOTA_MB;
+        setting.unit  = "MB";
+        setting.helpText  = "Disk quota of the capture archive, the oldest captures are deleted when it is exceeded, 0: no quota, Default is 1024.";
+        g_BTGlobalSettingParamMap.insert( pair<string, BT_SETTING_STRUCT>("VSA_SAVE_CAPTURE_QUOTA_MB", setting) );
+    }
+    else    
+    {
+        printf("Parameter Type Error!\n");
+        exit(1);
+    }
+
     setting.type = BT_SETTING_TYPE_INTEGER;
 	g_BTGlobalSettingParam.BER_VSG_TIMEOUT_SEC = 20;
     if (sizeof(int)==sizeof(g_BTGlobalSettingParam.BER_VSG_TIMEOUT_SEC))    // Type_Checking
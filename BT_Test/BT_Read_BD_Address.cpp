@@ -10,6 +10,7 @@ using namespace std;
 // This variable is declared in BT_Test_Internal.cpp
 extern vDUT_ID      g_BT_Dut;
 extern TM_ID        g_BT_Test_ID;
+extern char         g_BTDutBdAddress[MAX_BUFFER_SIZE];
 
 
 // Input Parameter Container
@@ -156,6 +157,7 @@ BT_TEST_API int BT_Read_BD_Address(void)
 			// Print MAC address in log message for debug /* #LPTW# cfy,-2010/04/29- */
 			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[BT] vDUT_GetStringReturn(BD_ADDRESS=%s) return OK.\n", l_readBDAddressReturn.BD_ADDRESS);
 		}
+		strcpy_s(g_BTDutBdAddress, MAX_BUFFER_SIZE, l_readBDAddressReturn.BD_ADDRESS);
 
 		/*-----------------------*
 		 *  Return Test Results  *
@@ -26,6 +26,7 @@ int				 g_Tester_Reconnect = 0;
 
 const char      *g_BT_Test_Version = "1.6.0 (2010-09-17)\n";
 char			 g_defaultFilePath[MAX_BUFFER_SIZE] = {'\0'};
+char			 g_BTDutBdAddress[MAX_BUFFER_SIZE] = {'\0'};	// Last BD address returned by READ_BD_ADDRESS, for the capture archive index
 
 // This global variable is declared in BT_Global_Setting.cpp
 // Input Parameter Container
@@ -410,6 +411,18 @@ BT_TEST_API int  ReturnErrorMessage(char *errParameter, const char *format, ...)
 BT_TEST_API int  LogReturnMessage(char *errMsg, int sizeOfBuf, LOGGER_LEVEL level, const char *format, ...)
 {
     int  err = ERR_OK;
+
+	// Warnings and information the logger discards are not formatted, errMsg only gets the format.
+	// Errors are always formatted, the callers throw errMsg.
+	if ( g_Logger_ID>=0 && level>LOGGER_ERROR && !::LOGGER_IsEnabled(LOG_IQLITE_CORE, level) )
+	{
+		strncpy_s(errMsg, sizeOfBuf, format, _TRUNCATE);
+		return err;
+	}
+	else
+	{
+		// do nothing
+	}
 	
 	// Log message format ... variable argument list
 	va_list ap;
@@ -420,7 +433,7 @@ BT_TEST_API int  LogReturnMessage(char *errMsg, int sizeOfBuf, LOGGER_LEVEL leve
 	// Write error message to log file
 	if (g_Logger_ID>=0)
 	{
-		err = ::LOGGER_Write_Ext(LOG_IQLITE_CORE, g_Logger_ID, level, errMsg);
+		err = ::LOGGER_Write_Ext(LOG_IQLITE_CORE, g_Logger_ID, level, "%s", errMsg);
 		// TODO: if possible, must do the error handling here
 	}
 	else
@@ -495,6 +508,41 @@ BT_TEST_API int  BTSaveSigFile(char* fileName)
 
 	if ( (1==g_BTGlobalSettingParam.VSA_SAVE_CAPTURE_ON_FAILED)||(1==g_BTGlobalSettingParam.VSA_SAVE_CAPTURE_ALWAYS))  
 	{	  
+		if (1==g_BTGlobalSettingParam.VSA_SAVE_CAPTURE_ARCHIVE)
+		{
+			// Only a host copy of the capture is made here, compression and disk write run in the background
+			err = ::LP_CaptureArchiveStart(g_BTGlobalSettingParam.VSA_SAVE_CAPTURE_ARCHIVE_PATH, g_BTGlobalSettingParam.VSA_SAVE_CAPTURE_QUOTA_MB);
+			if ( ERR_OK==err )
+			{
+				// The DUT serial number of TM_SetDutInfo(), else the BD address of the DUT
+				char dutSerial[MAX_BUFFER_SIZE] = {'\0'};
+				char dutInfo[MAX_BUFFER_SIZE]   = {'\0'};
+				if ( TM_ERR_OK!=::TM_GetDutInfo(dutSerial, MAX_BUFFER_SIZE, dutInfo, MAX_BUFFER_SIZE, dutInfo, MAX_BUFFER_SIZE, dutInfo, MAX_BUFFER_SIZE, dutInfo, MAX_BUFFER_SIZE) ||
+					 '\0'==dutSerial[0] )
+				{
+					strcpy_s(dutSerial, MAX_BUFFER_SIZE, g_BTDutBdAddress);
+				}
+				else
+				{
+					// do nothing
+				}
+				err = ::LP_CaptureArchiveSave(fileName, dutSerial, fileName);
+			}
+			if ( ERR_OK!=err )
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[BT] LP_CaptureArchiveSave(\"%s\") return error.\n", fileName);
+			}
+			else
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[BT] Capture archived (\"%s\").\n", fileName);
+			}
+			return err;
+		}
+		else
+		{
+			// do nothing
+		}
+
 		char c_time[MAX_BUFFER_SIZE], c_path[MAX_BUFFER_SIZE];
 #ifdef WIN32
 		// Get system time
@@ -127,6 +127,9 @@ typedef struct tagGlobalSettingParam
     double VSA_PRE_TRIGGER_TIME_US;                 /*!< IQtester VSA signal pre-trigger time setting used for signal capture. */
 	int    VSA_SAVE_CAPTURE_ON_FAILED;				/*!< A flag to save "sig" file when capture fails; 0: OFF, 1: ON, Default=ON */
 	int    VSA_SAVE_CAPTURE_ALWAYS;				    /*!< A flag to save "sig" file always; 0: OFF, 1: ON, Default=OFF */
+	int    VSA_SAVE_CAPTURE_ARCHIVE;				/*!< A flag to save captures through the background capture archive instead of LP_SaveVsaSignalFile(), 0: OFF, 1: ON, Default=OFF */
+	char   VSA_SAVE_CAPTURE_ARCHIVE_PATH[MAX_BUFFER_SIZE];	/*!< Directory of the capture archive. Default=./log/capture_archive */
+	int    VSA_SAVE_CAPTURE_QUOTA_MB;				/*!< Disk quota of the capture archive, the oldest captures are deleted above it; 0: no quota. Default=1024 */
 	int    VSA_PORT;                                /*!< IQtester VSA port setting. Default=PORT_LEFT*/
     int    VSG_PORT;                                /*!< IQtester VSG port setting. Default=PORT_LEFT*/
     //int    VSG_TRIGGER_TYPE;                      /*!< IQtester VSG signal trigger type setting; free-run most of the time*/
@@ -395,6 +395,18 @@ FM_TEST_API int  ReturnErrorMessage(char *errParameter, const char *format, ...)
 FM_TEST_API int  LogReturnMessage(char *errMsg, int sizeOfBuf, LOGGER_LEVEL level, const char *format, ...)
 {
     int  err = ERR_OK;
+
+	// Warnings and information the logger discards are not formatted, errMsg only gets the format.
+	// Errors are always formatted, the callers throw errMsg.
+	if ( g_Logger_ID>=0 && level>LOGGER_ERROR && !::LOGGER_IsEnabled(MAX_LOGGER_SOURCE, level) )
+	{
+		strncpy_s(errMsg, sizeOfBuf, format, _TRUNCATE);
+		return err;
+	}
+	else
+	{
+		// do nothing
+	}
 	
 	// Log message format ... variable argument list
 	va_list ap;
@@ -405,7 +417,7 @@ FM_TEST_API int  LogReturnMessage(char *errMsg, int sizeOfBuf, LOGGER_LEVEL leve
 	// Write error message to log file
 	if (g_Logger_ID>=0)
 	{
-		err = ::LOGGER_Write(g_Logger_ID, level, errMsg);
+		err = ::LOGGER_Write(g_Logger_ID, level, "%s", errMsg);
 		// TODO: if possible, must do the error handling here
 	}
 	else
@@ -4,6 +4,7 @@
 #include "stdafx.h"
 #include "TestManager.h"
 #include "global_settings.h"
+#include "test_flow_plan.h"
 //#define STRICT
 #include <windows.h>
 #include <iostream>
@@ -20,6 +21,7 @@ TM_ID   tmID[MAX_TECHNOLOGY_NUM] = {-1, -1, -1, -1, -1, -1, -1};
 int  ListAllFunction();
 int  SimpleWiFiTestFlow(_TCHAR* ipAddress);
 void GetTestID(int technologyIndex, int* testID);
+int  TestPlanRepeatTest();
 void printProgramInfo();
 LPSTR UnicodeToAnsi(LPCWSTR str);
 
@@ -30,6 +32,7 @@ map<string, RX_PARAM_IN> g_RxParamMap;
 map<string, bool> g_TestItemResultMap;
 typedef pair<string, bool> PairResult;
 STRING_TESTITEM_VECTOR strTestItemVector;
+TEST_PLAN g_TestPlan;
 
 int _tmain(int argc, _TCHAR* argv[])
 {
@@ -59,6 +62,12 @@ int _tmain(int argc, _TCHAR* argv[])
             _getch();
             return 0;
         }
+
+        if( 0==wcscmp(argv[1],_T("-plan_test")) )
+        {
+			// Needs no tester, the exit code is 1 if a repeat does not predict with the updated estimates
+            return TestPlanRepeatTest();
+        }
     }
 	else
 	{
@@ -123,6 +132,7 @@ int _tmain(int argc, _TCHAR* argv[])
 			}
 			else if(nCtrlVal == 999)
 			{
+				::TM_Term();
 				exit(0);
 			}
 			else
@@ -237,6 +247,7 @@ int _tmain(int argc, _TCHAR* argv[])
 			// Exit testing after test flow run finish
 			if(g_tsGlobalSetting.TestCtrl.ExitWhenDone)
 			{
+				::TM_Term();
 				exit(0);
 			}
 
@@ -729,21 +740,49 @@ int SimpleWiFiTestFlow(_TCHAR* ipAddress)
 	}
 	// Here add your code
 
+	// Build the execution plan, it needs the settings read by run_GLOBAL_SETTINGS()
+	BuildTestPlan(&strTestItemVector, &g_TestPlan);
+	{
+		printf("\nTest plan: %d items, %d retunes (script order: %d), predicted time: %2.2f sec\n",
+			(int)g_TestPlan.steps.size(), g_TestPlan.nRetunes, g_TestPlan.nRetunesScript, g_TestPlan.dPredictedSec);
+		ofstream os;
+		os.open(_T(".\\log\\Log_all.txt"),ios_base::app|ios_base::out);
+		os<<"Test plan: "<<g_TestPlan.steps.size()<<" items, "<<g_TestPlan.nRetunes<<" retunes (script order: "<<g_TestPlan.nRetunesScript<<"), predicted time: "<<setprecision(4)<<g_TestPlan.dPredictedSec<<endl;
+		os.close();
+	}
+	clock_t flowStart=clock();
+	double  dFlowPredicted=0.0;
+
 	// start to execute test flow	
 
 	int iRepeatTime = g_tsGlobalSetting.TestCtrl.RepeatTimes;
 	for(iRepeatTime ; iRepeatTime > 0; iRepeatTime-- )
 	{
+		// The previous repeat updated the estimates, so the steps are predicted again
+		if(iRepeatTime<g_tsGlobalSetting.TestCtrl.RepeatTimes)
+		{
+			PredictTestPlan(&g_TestPlan);
+			printf("\nRepeat %d predicted time: %2.2f sec\n", g_tsGlobalSetting.TestCtrl.RepeatTimes-iRepeatTime+1, g_TestPlan.dPredictedSec);
+			ofstream os;
+			os.open(_T(".\\log\\Log_all.txt"),ios_base::app|ios_base::out);
+			os<<"Repeat "<<g_tsGlobalSetting.TestCtrl.RepeatTimes-iRepeatTime+1<<" predicted time: "<<setprecision(4)<<g_TestPlan.dPredictedSec<<endl;
+			os.close();
+		}
 		
 		int iTestNo=6;
 		map<string, TX_PARAM_IN>::iterator iter;
 		map<string, RX_PARAM_IN>::iterator rx_iter;
-		STRING_TESTITEM_VECTOR::iterator item_iter;
-		for(item_iter=strTestItemVector.begin();item_iter!=strTestItemVector.end();item_iter++)
+		vector<TEST_PLAN_STEP>::iterator step_iter;
+		for(step_iter=g_TestPlan.steps.begin();step_iter!=g_TestPlan.steps.end();step_iter++)
 		{
+			const string *item_iter = &step_iter->strItem;
+			dFlowPredicted += step_iter->dPredictedSec;
 			start=clock();
 			iTestNo++;
 			myprintf(item_iter->c_str());
+
+			// With DUT_LOOK_AHEAD=1 the DUT is configured for the next item while this one analyzes
+			run_SET_LOOK_AHEAD( (step_iter+1)!=g_TestPlan.steps.end() ? (step_iter+1)->strItem.c_str() : NULL );
 			if(strstr(item_iter->c_str(),"TX_VERIFY_EVM"))
 			{
 				iter = g_TxParamMap.find(item_iter->c_str());
@@ -986,13 +1025,22 @@ int SimpleWiFiTestFlow(_TCHAR* ipAddress)
 			}
 			finish=clock();
 			duration = (double)(finish - start) / CLOCKS_PER_SEC;
-			printf("Test time: %2.2f sec\n", duration );
+			printf("Test time: %2.2f sec (predicted: %2.2f sec)\n", duration, step_iter->dPredictedSec );
 			ofstream os;
 			os.open(_T(".\\log\\Log_all.txt"),ios_base::app|ios_base::out);
-			os<<"Test time: "<<setprecision(4)<<duration<<endl;
+			os<<"Test time: "<<setprecision(4)<<duration<<" (predicted: "<<setprecision(4)<<step_iter->dPredictedSec<<")"<<endl;
 			os.close();
+			UpdateTestPlanModel(&(*step_iter), duration);
 		}
 	}
+	{
+		duration = (double)(clock() - flowStart) / CLOCKS_PER_SEC;
+		printf("\nTest flow time: %2.2f sec (predicted: %2.2f sec)\n", duration, dFlowPredicted );
+		ofstream os;
+		os.open(_T(".\\log\\Log_all.txt"),ios_base::app|ios_base::out);
+		os<<"Test flow time: "<<setprecision(4)<<duration<<" (predicted: "<<setprecision(4)<<dFlowPredicted<<")"<<endl;
+		os.close();
+	}
 
 __exit_test__:
 
@@ -1050,6 +1098,19 @@ void run_RegisterTechnologyDll(void)
 	{
         printf("\t[Info] TM_RegisterTechnologyDll() return OK.\n");
 	}
+
+	// Structured results for the MES, instead of parsing Log_all.txt
+	if( 0!=g_tsGlobalSetting.TestCtrl.RESULT_SINK_FILE[0] )
+	{
+		LPSTR pSinkFile = UnicodeToAnsi(g_tsGlobalSetting.TestCtrl.RESULT_SINK_FILE);
+		LPSTR pStation  = UnicodeToAnsi(g_tsGlobalSetting.TestCtrl.STATION_NAME);
+		if( TM_ERR_OK!=::TM_ResultSinkOpen(pSinkFile, pStation) )
+		{
+			printf("\t[Warning] Fail to open the result file %s.\n", pSinkFile);
+		}
+		delete[] pSinkFile;
+		delete[] pStation;
+	}
 	
 	return;
 }
@@ -1365,34 +1426,14 @@ void run_TX_VERIFY_EVM(TX_PARAM_IN *txParam, TX_PARAM_RETURN *txReturn)
 	TM_AddDoubleParameter (WiFi_Test, "TX_POWER_DBM", txParam->dTargetPower);
 	TM_AddStringParameter (WiFi_Test, "BANDWIDTH", txParam->szBandWidth);
 	TM_AddStringParameter (WiFi_Test, "DATA_RATE", txParam->szDataRate);
-	LPSTR szPacketFormat = UnicodeToAnsi(g_tsGlobalSetting.TestCtrl.PACKET_FORMAT);
-	TM_AddStringParameter (WiFi_Test, "PACKET_FORMAT_11N", szPacketFormat);
+	TM_AddStringParameter (WiFi_Test, "PACKET_FORMAT_11N", txParam->szPacketFormat11n);
 	//TM_AddStringParameter (WiFi_Test, "PREAMBLE", "LONG");
 	TM_AddStringParameter (WiFi_Test, "GUARD_INTERVAL_11N", "LONG");
 
-	if(strstr(txParam->szDataRate,"DSSS") || strstr(txParam->szDataRate,"CCK") || strstr(txParam->szDataRate,"PBCC"))
-	{
-		TM_AddStringParameter (WiFi_Test, "PREAMBLE", "LONG");
-		TM_AddDoubleParameter (WiFi_Test, "SAMPLING_TIME_US",g_tsGlobalSetting.EVM_11B_L_SAMPLE_INTERVAL_US);
-	}
-	else if(strstr(txParam->szDataRate,"OFDM"))
-	{
-		TM_AddStringParameter (WiFi_Test, "PREAMBLE", "SHORT");
-		TM_AddDoubleParameter (WiFi_Test, "SAMPLING_TIME_US",g_tsGlobalSetting.EVM_11AG_SAMPLE_INTERVAL_US);		
-	}
-	else if(strstr(txParam->szDataRate,"MCS") && strstr(szPacketFormat,"MIXED"))
+	if(txParam->szPreamble[0]!='\0')	// resolved from the data rate by BuildTestPlan()
 	{
-		TM_AddStringParameter (WiFi_Test, "PREAMBLE", "SHORT");
-		TM_AddDoubleParameter (WiFi_Test, "SAMPLING_TIME_US",g_tsGlobalSetting.EVM_11N_MIXED_SAMPLE_INTERVAL_US);			
-	}
-	else if(strstr(txParam->szDataRate,"MCS") && strstr(szPacketFormat,"GREENFIELD"))
-	{
-		TM_AddStringParameter (WiFi_Test, "PREAMBLE", "SHORT");
-		TM_AddDoubleParameter (WiFi_Test, "SAMPLING_TIME_US",g_tsGlobalSetting.EVM_11N_GREENFIELD_SAMPLE_INTERVAL_US);	
-	}
-	else
-	{
-		//
+		TM_AddStringParameter (WiFi_Test, "PREAMBLE", txParam->szPreamble);
+		TM_AddDoubleParameter (WiFi_Test, "SAMPLING_TIME_US", txParam->nSamplingTime);
 	}
 	
 	//--------------------------------------------------------------------------
@@ -1522,34 +1563,14 @@ void run_TX_VERIFY_POWER(TX_PARAM_IN *txParam, TX_PARAM_RETURN *txReturn)
 	TM_AddDoubleParameter (WiFi_Test, "TX_POWER_DBM", txParam->dTargetPower);
 	TM_AddStringParameter (WiFi_Test, "BANDWIDTH", txParam->szBandWidth);
 	TM_AddStringParameter (WiFi_Test, "DATA_RATE", txParam->szDataRate);
-	LPSTR szPacketFormat = UnicodeToAnsi(g_tsGlobalSetting.TestCtrl.PACKET_FORMAT);
-	TM_AddStringParameter (WiFi_Test, "PACKET_FORMAT_11N", szPacketFormat);
+	TM_AddStringParameter (WiFi_Test, "PACKET_FORMAT_11N", txParam->szPacketFormat11n);
 	//TM_AddStringParameter (WiFi_Test, "PREAMBLE", "LONG");
 	TM_AddStringParameter (WiFi_Test, "GUARD_INTERVAL_11N", "LONG");
 
-	if(strstr(txParam->szDataRate,"DSSS") || strstr(txParam->szDataRate,"CCK") || strstr(txParam->szDataRate,"PBCC"))
-	{
-		TM_AddStringParameter (WiFi_Test, "PREAMBLE", "LONG");
-		TM_AddDoubleParameter (WiFi_Test, "SAMPLING_TIME_US",g_tsGlobalSetting.EVM_11B_L_SAMPLE_INTERVAL_US);
-	}
-	else if(strstr(txParam->szDataRate,"OFDM"))
-	{
-		TM_AddStringParameter (WiFi_Test, "PREAMBLE", "SHORT");
-		TM_AddDoubleParameter (WiFi_Test, "SAMPLING_TIME_US",g_tsGlobalSetting.EVM_11AG_SAMPLE_INTERVAL_US);		
-	}
-	else if(strstr(txParam->szDataRate,"MCS") && strstr(szPacketFormat,"MIXED"))
-	{
-		TM_AddStringParameter (WiFi_Test, "PREAMBLE", "SHORT");
-		TM_AddDoubleParameter (WiFi_Test, "SAMPLING_TIME_US",g_tsGlobalSetting.EVM_11N_MIXED_SAMPLE_INTERVAL_US);			
-	}
-	else if(strstr(txParam->szDataRate,"MCS") && strstr(szPacketFormat,"GREENFIELD"))
+	if(txParam->szPreamble[0]!='\0')	// resolved from the data rate by BuildTestPlan()
 	{
-		TM_AddStringParameter (WiFi_Test, "PREAMBLE", "SHORT");
-		TM_AddDoubleParameter (WiFi_Test, "SAMPLING_TIME_US",g_tsGlobalSetting.EVM_11N_GREENFIELD_SAMPLE_INTERVAL_US);	
-	}
-	else
-	{
-		//
+		TM_AddStringParameter (WiFi_Test, "PREAMBLE", txParam->szPreamble);
+		TM_AddDoubleParameter (WiFi_Test, "SAMPLING_TIME_US", txParam->nSamplingTime);
 	}
 
 	//--------------------------------------------------------------------------
@@ -1634,33 +1655,13 @@ void run_TX_VERIFY_MASK(TX_PARAM_IN *txParam, TX_PARAM_RETURN *txReturn)
 	TM_AddDoubleParameter (WiFi_Test, "TX_POWER_DBM", txParam->dTargetPower);
 	TM_AddStringParameter (WiFi_Test, "BANDWIDTH", txParam->szBandWidth);
 	TM_AddStringParameter (WiFi_Test, "DATA_RATE", txParam->szDataRate);
-	LPSTR szPacketFormat = UnicodeToAnsi(g_tsGlobalSetting.TestCtrl.PACKET_FORMAT);
-	TM_AddStringParameter (WiFi_Test, "PACKET_FORMAT_11N", szPacketFormat);
+	TM_AddStringParameter (WiFi_Test, "PACKET_FORMAT_11N", txParam->szPacketFormat11n);
 	//TM_AddStringParameter (WiFi_Test, "PREAMBLE", "LONG");
 	TM_AddStringParameter (WiFi_Test, "GUARD_INTERVAL_11N", "LONG");
-	if(strstr(txParam->szDataRate,"DSSS") || strstr(txParam->szDataRate,"CCK") || strstr(txParam->szDataRate,"PBCC"))
-	{
-		TM_AddStringParameter (WiFi_Test, "PREAMBLE", "LONG");
-		TM_AddDoubleParameter (WiFi_Test, "SAMPLING_TIME_US",g_tsGlobalSetting.EVM_11B_L_SAMPLE_INTERVAL_US);
-	}
-	else if(strstr(txParam->szDataRate,"OFDM"))
+	if(txParam->szPreamble[0]!='\0')	// resolved from the data rate by BuildTestPlan()
 	{
-		TM_AddStringParameter (WiFi_Test, "PREAMBLE", "SHORT");
-		TM_AddDoubleParameter (WiFi_Test, "SAMPLING_TIME_US",g_tsGlobalSetting.EVM_11AG_SAMPLE_INTERVAL_US);		
-	}
-	else if(strstr(txParam->szDataRate,"MCS") && strstr(szPacketFormat,"MIXED"))
-	{
-		TM_AddStringParameter (WiFi_Test, "PREAMBLE", "SHORT");
-		TM_AddDoubleParameter (WiFi_Test, "SAMPLING_TIME_US",g_tsGlobalSetting.EVM_11N_MIXED_SAMPLE_INTERVAL_US);			
-	}
-	else if(strstr(txParam->szDataRate,"MCS") && strstr(szPacketFormat,"GREENFIELD"))
-	{
-		TM_AddStringParameter (WiFi_Test, "PREAMBLE", "SHORT");
-		TM_AddDoubleParameter (WiFi_Test, "SAMPLING_TIME_US",g_tsGlobalSetting.EVM_11N_GREENFIELD_SAMPLE_INTERVAL_US);	
-	}
-	else
-	{
-		//
+		TM_AddStringParameter (WiFi_Test, "PREAMBLE", txParam->szPreamble);
+		TM_AddDoubleParameter (WiFi_Test, "SAMPLING_TIME_US", txParam->nSamplingTime);
 	}
 	//--------------------------------------------------------------------------
 	// (3) Users can now run the specific "Keyword" function.
@@ -1725,6 +1726,63 @@ void run_TX_VERIFY_MASK(TX_PARAM_IN *txParam, TX_PARAM_RETURN *txReturn)
 	return;
 }
 
+//---------------------------------------------------------------------------------
+// Look-ahead: the next TX item, its DUT parameters are kept by TM_SetLookAhead()
+//---------------------------------------------------------------------------------
+void run_SET_LOOK_AHEAD(const char *nextItem)
+{
+	char	keyword[MAX_BUFFER_SIZE] = {'\0'};
+
+	if(NULL==nextItem)
+	{
+		// Last item
+	}
+	else if(strstr(nextItem,"TX_VERIFY_EVM"))
+	{
+		strcpy_s(keyword, MAX_BUFFER_SIZE, "TX_VERIFY_EVM");
+	}
+	else if(strstr(nextItem,"TX_VERIFY_POWER"))
+	{
+		strcpy_s(keyword, MAX_BUFFER_SIZE, "TX_VERIFY_POWER");
+	}
+	else if(strstr(nextItem,"TX_VERIFY_MASK"))
+	{
+		strcpy_s(keyword, MAX_BUFFER_SIZE, "TX_VERIFY_MASK");
+	}
+	else
+	{
+		// RX items configure the DUT themselves
+	}
+
+	map<string, TX_PARAM_IN>::iterator iter;
+	if( keyword[0]=='\0' || (iter=g_TxParamMap.find(nextItem))==g_TxParamMap.end() )
+	{
+		TM_SetLookAhead(WiFi_Test, "");
+		return;
+	}
+
+	// Same DUT parameters as run_TX_VERIFY_xxx(), which clear them again before TM_Run()
+	TX_PARAM_IN *txParam = &iter->second;
+	TM_ClearParameters(WiFi_Test);
+	TM_AddIntegerParameter(WiFi_Test, "FREQ_MHZ", txParam->nFreq);
+	TM_AddIntegerParameter(WiFi_Test, "TX1", txParam->nTx1);
+	TM_AddIntegerParameter(WiFi_Test, "TX2", txParam->nTx2);
+	TM_AddIntegerParameter(WiFi_Test, "TX3", txParam->nTx3);
+	TM_AddIntegerParameter(WiFi_Test, "TX4", txParam->nTx4);
+	TM_AddDoubleParameter (WiFi_Test, "TX_POWER_DBM", txParam->dTargetPower);
+	TM_AddStringParameter (WiFi_Test, "BANDWIDTH", txParam->szBandWidth);
+	TM_AddStringParameter (WiFi_Test, "DATA_RATE", txParam->szDataRate);
+	TM_AddStringParameter (WiFi_Test, "PACKET_FORMAT_11N", txParam->szPacketFormat11n);
+	TM_AddStringParameter (WiFi_Test, "GUARD_INTERVAL_11N", "LONG");
+	if(txParam->szPreamble[0]!='\0')
+	{
+		TM_AddStringParameter (WiFi_Test, "PREAMBLE", txParam->szPreamble);
+		TM_AddDoubleParameter (WiFi_Test, "SAMPLING_TIME_US", txParam->nSamplingTime);
+	}
+
+	TM_SetLookAhead(WiFi_Test, keyword);
+}
+
 
 //---------------------------------------------------------------------------------
 // Step 10: Tx Verify Spectrum Test
@@ -1932,6 +1990,56 @@ void run_DISCONNECT_IQ_TESTER(void)
 	return;
 }
 
+// Runs a plan twice with measured times off the estimates, the second repeat must predict the updated
+// estimates.  Returns 0 if it does.
+int TestPlanRepeatTest()
+{
+	const char *pszItems[] = {"TX_VERIFY_EVM_2412_HT20", "TX_VERIFY_POWER_2412_HT20", "TX_VERIFY_EVM_5180_HT20"};
+	const int   nFreqs[]   = {2412, 2412, 5180};
+	const double dOffsetSec = 1.0;
+
+	g_TxParamMap.clear();
+	g_RxParamMap.clear();
+	strTestItemVector.clear();
+	for(int i=0;i<(int)(sizeof(nFreqs)/sizeof(nFreqs[0]));i++)
+	{
+		TX_PARAM_IN txParam;
+		memset(&txParam, 0, sizeof(txParam));
+		txParam.nFreq = nFreqs[i];
+		strcpy_s(txParam.szBandWidth, sizeof(txParam.szBandWidth), "HT20");
+		strcpy_s(txParam.szDataRate, sizeof(txParam.szDataRate), "MCS7");
+		g_TxParamMap.insert(Tx_Pair(pszItems[i], txParam));
+		strTestItemVector.push_back(pszItems[i]);
+	}
+
+	BuildTestPlan(&strTestItemVector, &g_TestPlan);
+	vector<double> firstPredicted;
+	for(size_t i=0;i<g_TestPlan.steps.size();i++)
+	{
+		firstPredicted.push_back(g_TestPlan.steps[i].dPredictedSec);
+		UpdateTestPlanModel(&g_TestPlan.steps[i], g_TestPlan.steps[i].dPredictedSec+dOffsetSec);
+	}
+	double dFirstSec  = g_TestPlan.dPredictedSec;
+	double dSecondSec = PredictTestPlan(&g_TestPlan);
+
+	// Each step was measured dOffsetSec slower, the estimate moves toward it by the model weight,
+	// or further if an earlier step of the repeat already updated the same estimate
+	bool bPass = (g_TestPlan.steps.size()==firstPredicted.size() && dSecondSec>dFirstSec);
+	for(size_t i=0;i<g_TestPlan.steps.size() && i<firstPredicted.size();i++)
+	{
+		printf("%-28s repeat 1: %2.3f sec, repeat 2: %2.3f sec\n", g_TestPlan.steps[i].strItem.c_str(), firstPredicted[i], g_TestPlan.steps[i].dPredictedSec);
+		if( g_TestPlan.steps[i].dPredictedSec<=firstPredicted[i] || g_TestPlan.steps[i].dPredictedSec>firstPredicted[i]+dOffsetSec )
+			bPass = false;
+	}
+	printf("Plan: repeat 1: %2.3f sec, repeat 2: %2.3f sec\n", dFirstSec, dSecondSec);
+	printf("%s\n", bPass ? "PASS" : "FAIL");
+
+	g_TxParamMap.clear();
+	strTestItemVector.clear();
+	g_TestPlan.steps.clear();
+	return bPass ? 0 : 1;
+}
+
 void printProgramInfo()
 {
 	printf("Program version: \t%s\n",__this__version__);
@@ -3,6 +3,7 @@
 #include "Windows.h"
 #include "TestManager.h"
 #include "global_settings.h"
+#include "test_flow_plan.h"
 #include <string>
 #include <map>
 #include <fstream>
@@ -948,6 +949,9 @@ int read_Global_Settings(char* pszGlobalSettingFileName)
 	GetPrivateProfileString(_T("TEST_CONTROL"),_T("TX_PATHLOSS_FILE"),_T("path_loss.csv"),g_tsGlobalSetting.TestCtrl.szTxPathLossFile,BUFFER_SIZE,szFilenameGlobalSetting);
 	GetPrivateProfileString(_T("TEST_CONTROL"),_T("RX_PATHLOSS_FILE"),_T("path_loss.csv"),g_tsGlobalSetting.TestCtrl.szRxPathLossFile,BUFFER_SIZE,szFilenameGlobalSetting);
 	GetPrivateProfileString(_T("TEST_CONTROL"),_T("PACKET_FORMAT"),_T("MIXED"),g_tsGlobalSetting.TestCtrl.PACKET_FORMAT,BUFFER_SIZE,szFilenameGlobalSetting);
+	GetPrivateProfileString(_T("TEST_CONTROL"),_T("RESULT_SINK_FILE"),_T(""),g_tsGlobalSetting.TestCtrl.RESULT_SINK_FILE,BUFFER_SIZE,szFilenameGlobalSetting);
+	GetPrivateProfileString(_T("TEST_CONTROL"),_T("STATION_NAME"),_T(""),g_tsGlobalSetting.TestCtrl.STATION_NAME,BUFFER_SIZE,szFilenameGlobalSetting);
+	g_tsGlobalSetting.TestCtrl.FLOW_OPTIMIZE=GetPrivateProfileInt(_T("TEST_CONTROL"),_T("FLOW_OPTIMIZE"),0,szFilenameGlobalSetting);
 
 
 	return 0;
@@ -2532,6 +2536,11 @@ int ParseTestItem(char *pszScriptFile)
 	{
 		char szReadLine[256]="";
 		is.getline(szReadLine,sizeof(szReadLine));
+		if(strncmp(szReadLine,FLOW_BARRIER_KEYWORD,strlen(FLOW_BARRIER_KEYWORD))==0)
+		{
+			strTestItemVector.push_back(FLOW_BARRIER_KEYWORD);
+			continue;
+		}
 		if(strstr(szReadLine,"_VERIFY_") ==  NULL)
 			continue;
 		if(szReadLine[0]=='/' || szReadLine[0]==';' || szReadLine[0]=='\\')
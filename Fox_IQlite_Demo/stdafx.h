@@ -146,6 +146,9 @@ typedef struct
 	TCHAR IQ_TESTER_IP3[BUFFER_SIZE];
 	TCHAR IQ_TESTER_IP4[BUFFER_SIZE];
 	TCHAR PACKET_FORMAT[BUFFER_SIZE];
+	TCHAR RESULT_SINK_FILE[BUFFER_SIZE];	// TestManager structured result file, empty: OFF
+	TCHAR STATION_NAME[BUFFER_SIZE];
+	int FLOW_OPTIMIZE;	// 1: group the script items by channel, see test_flow_plan.cpp
 
 	// add by daixin to support dual test, 2012-12-10
 	int DH_ENABLE; //= 0
@@ -1099,6 +1102,9 @@ void run_TX_VERIFY_POWER(TX_PARAM_IN *txParam, TX_PARAM_RETURN *txReturn);
 // Step 9: TX Verify Mask Test     
 void run_TX_VERIFY_MASK(TX_PARAM_IN *txParam, TX_PARAM_RETURN *txReturn);
 
+// Look-ahead: DUT parameters of the next TX item, NULL if none
+void run_SET_LOOK_AHEAD(const char *nextItem);
+
 // Step 10: TX Verify Spectrum Test     
 void run_TX_VERIFY_SPECTRUM(void);
 
@@ -0,0 +1,223 @@
+// test_flow_plan.cpp : Builds the execution plan of the LP_Script.ini items
+//
+// With FLOW_OPTIMIZE=1 the items are grouped by channel (frequency and bandwidth), so the DUT and the
+// VSA/VSG are retuned once per channel instead of once per item.  Inside a channel the items keep the
+// script order, and no item is moved across a FLOW_BARRIER line.
+//
+#include "stdafx.h"
+#include "Windows.h"
+#include "TestManager.h"
+#include "global_settings.h"
+#include "test_flow_plan.h"
+#include <string>
+#include <map>
+#include <algorithm>
+using namespace std;
+extern TS_Global_Setting g_tsGlobalSetting;
+extern map<string, TX_PARAM_IN> g_TxParamMap;
+extern map<string, RX_PARAM_IN> g_RxParamMap;
+LPSTR UnicodeToAnsi(LPCWSTR str);
+
+typedef struct
+{
+	const char *pszKeyword;
+	double dSteadySec;		// same channel as the previous step
+	double dRetuneSec;		// DUT and tester are retuned first
+}TEST_ITEM_COST;
+
+// Initial estimates, refined with the measured time of each step by UpdateTestPlanModel()
+static TEST_ITEM_COST g_TestItemCost[] =
+{
+	{"TX_VERIFY_EVM",	0.30, 0.80},
+	{"TX_VERIFY_POWER",	0.20, 0.70},
+	{"TX_VERIFY_MASK",	0.25, 0.75},
+	{"RX_VERIFY_PER",	0.80, 1.30}
+};
+#define TEST_ITEM_COST_NUM		(int)(sizeof(g_TestItemCost)/sizeof(g_TestItemCost[0]))
+#define TEST_PLAN_MODEL_WEIGHT	0.3
+
+static TEST_ITEM_COST* FindTestItemCost(const char *pszItem)
+{
+	for(int i=0;i<TEST_ITEM_COST_NUM;i++)
+	{
+		if(strstr(pszItem,g_TestItemCost[i].pszKeyword))
+			return &g_TestItemCost[i];
+	}
+	return NULL;
+}
+
+static bool GetItemChannel(const string &strItem, int *pnFreq, string *pstrBandWidth)
+{
+	map<string, TX_PARAM_IN>::iterator tx_iter = g_TxParamMap.find(strItem);
+	if(tx_iter!=g_TxParamMap.end())
+	{
+		*pnFreq = tx_iter->second.nFreq;
+		*pstrBandWidth = tx_iter->second.szBandWidth;
+		return true;
+	}
+	map<string, RX_PARAM_IN>::iterator rx_iter = g_RxParamMap.find(strItem);
+	if(rx_iter!=g_RxParamMap.end())
+	{
+		*pnFreq = rx_iter->second.nFreq;
+		*pstrBandWidth = rx_iter->second.szBandWidth;
+		return true;
+	}
+	return false;
+}
+
+// True if the item needs another channel than the previous one, the previous channel is updated
+static bool IsRetune(const string &strItem, int *pnLastFreq, string *pstrLastBandWidth)
+{
+	int nFreq = -1;
+	string strBandWidth;
+	GetItemChannel(strItem, &nFreq, &strBandWidth);
+
+	bool bRetune = (nFreq!=*pnLastFreq || strBandWidth!=*pstrLastBandWidth);
+	*pnLastFreq = nFreq;
+	*pstrLastBandWidth = strBandWidth;
+	return bRetune;
+}
+
+// PACKET_FORMAT_11N, PREAMBLE and SAMPLING_TIME_US only depend on the data rate and the global settings,
+// so they are resolved once per flow instead of in every run_TX_VERIFY_xxx()
+static void PrecomputeTxParam(TX_PARAM_IN *txParam, const char *pszPacketFormat)
+{
+	strncpy_s(txParam->szPacketFormat11n, sizeof(txParam->szPacketFormat11n), pszPacketFormat, _TRUNCATE);
+	txParam->szPreamble[0] = '\0';
+	txParam->nSamplingTime = 0;
+
+	if(strstr(txParam->szDataRate,"DSSS") || strstr(txParam->szDataRate,"CCK") || strstr(txParam->szDataRate,"PBCC"))
+	{
+		strcpy_s(txParam->szPreamble, sizeof(txParam->szPreamble), "LONG");
+		txParam->nSamplingTime = g_tsGlobalSetting.EVM_11B_L_SAMPLE_INTERVAL_US;
+	}
+	else if(strstr(txParam->szDataRate,"OFDM"))
+	{
+		strcpy_s(txParam->szPreamble, sizeof(txParam->szPreamble), "SHORT");
+		txParam->nSamplingTime = g_tsGlobalSetting.EVM_11AG_SAMPLE_INTERVAL_US;
+	}
+	else if(strstr(txParam->szDataRate,"MCS") && strstr(pszPacketFormat,"MIXED"))
+	{
+		strcpy_s(txParam->szPreamble, sizeof(txParam->szPreamble), "SHORT");
+		txParam->nSamplingTime = g_tsGlobalSetting.EVM_11N_MIXED_SAMPLE_INTERVAL_US;
+	}
+	else if(strstr(txParam->szDataRate,"MCS") && strstr(pszPacketFormat,"GREENFIELD"))
+	{
+		strcpy_s(txParam->szPreamble, sizeof(txParam->szPreamble), "SHORT");
+		txParam->nSamplingTime = g_tsGlobalSetting.EVM_11N_GREENFIELD_SAMPLE_INTERVAL_US;
+	}
+	else
+	{
+		// the test function uses its default
+	}
+}
+
+// Appends the items between two FLOW_BARRIER lines to the plan
+static void AppendPlanSegment(vector<TEST_PLAN_STEP> *pSegment, TEST_PLAN *pPlan)
+{
+	if(g_tsGlobalSetting.TestCtrl.FLOW_OPTIMIZE==0)
+	{
+		pPlan->steps.insert(pPlan->steps.end(), pSegment->begin(), pSegment->end());
+	}
+	else
+	{
+		// Channels in the order of their first item, then the items of each channel in script order
+		vector< pair<int, string> > channels;
+		vector< pair<int, string> > itemChannels;
+		for(size_t i=0;i<pSegment->size();i++)
+		{
+			pair<int, string> channel(-1, "");
+			GetItemChannel((*pSegment)[i].strItem, &channel.first, &channel.second);
+			itemChannels.push_back(channel);
+			if(find(channels.begin(), channels.end(), channel)==channels.end())
+				channels.push_back(channel);
+		}
+		for(size_t c=0;c<channels.size();c++)
+		{
+			for(size_t i=0;i<pSegment->size();i++)
+			{
+				if(itemChannels[i]==channels[c])
+					pPlan->steps.push_back((*pSegment)[i]);
+			}
+		}
+	}
+	pSegment->clear();
+}
+
+int BuildTestPlan(STRING_TESTITEM_VECTOR *pItems, TEST_PLAN *pPlan)
+{
+	pPlan->steps.clear();
+	pPlan->nRetunes = 0;
+	pPlan->nRetunesScript = 0;
+	pPlan->dPredictedSec = 0.0;
+
+	LPSTR pszPacketFormat = UnicodeToAnsi(g_tsGlobalSetting.TestCtrl.PACKET_FORMAT);
+	map<string, TX_PARAM_IN>::iterator tx_iter;
+	for(tx_iter=g_TxParamMap.begin();tx_iter!=g_TxParamMap.end();tx_iter++)
+	{
+		PrecomputeTxParam(&tx_iter->second, pszPacketFormat);
+	}
+	delete[] pszPacketFormat;
+
+	int nLastFreq = -1;
+	string strLastBandWidth;
+	vector<TEST_PLAN_STEP> segment;
+	for(size_t i=0;i<pItems->size();i++)
+	{
+		const string &strItem = (*pItems)[i];
+		if(strstr(strItem.c_str(),FLOW_BARRIER_KEYWORD))
+		{
+			AppendPlanSegment(&segment, pPlan);
+			continue;
+		}
+		if(IsRetune(strItem, &nLastFreq, &strLastBandWidth))
+			pPlan->nRetunesScript++;
+
+		TEST_PLAN_STEP step;
+		step.strItem = strItem;
+		step.nScriptIndex = (int)i;
+		step.bRetune = false;
+		step.dPredictedSec = 0.0;
+		segment.push_back(step);
+	}
+	AppendPlanSegment(&segment, pPlan);
+
+	nLastFreq = -1;
+	strLastBandWidth = "";
+	for(size_t i=0;i<pPlan->steps.size();i++)
+	{
+		TEST_PLAN_STEP *pStep = &pPlan->steps[i];
+		pStep->bRetune = IsRetune(pStep->strItem, &nLastFreq, &strLastBandWidth);
+		if(pStep->bRetune)
+			pPlan->nRetunes++;
+	}
+	PredictTestPlan(pPlan);
+
+	return (int)pPlan->steps.size();
+}
+
+// Predicts the steps with the current estimates, called again before each repeat after UpdateTestPlanModel()
+double PredictTestPlan(TEST_PLAN *pPlan)
+{
+	pPlan->dPredictedSec = 0.0;
+	for(size_t i=0;i<pPlan->steps.size();i++)
+	{
+		TEST_PLAN_STEP *pStep = &pPlan->steps[i];
+		TEST_ITEM_COST *pCost = FindTestItemCost(pStep->strItem.c_str());
+		if(pCost!=NULL)
+			pStep->dPredictedSec = pStep->bRetune ? pCost->dRetuneSec : pCost->dSteadySec;
+		pPlan->dPredictedSec += pStep->dPredictedSec;
+	}
+	return pPlan->dPredictedSec;
+}
+
+// Moves the estimate of the keyword toward the measured time, so the next repeat predicts this station
+void UpdateTestPlanModel(const TEST_PLAN_STEP *pStep, double dActualSec)
+{
+	TEST_ITEM_COST *pCost = FindTestItemCost(pStep->strItem.c_str());
+	if(pCost==NULL)
+		return;
+
+	double *pdEstimate = pStep->bRetune ? &pCost->dRetuneSec : &pCost->dSteadySec;
+	*pdEstimate += TEST_PLAN_MODEL_WEIGHT*(dActualSec-*pdEstimate);
+}
@@ -0,0 +1,26 @@
+#include "stdafx.h"
+#pragma once
+
+// Script line that the flow optimizer never moves an item across,
+// e.g. a RX_VERIFY_PER that must run after the TX calibration items above it.
+#define FLOW_BARRIER_KEYWORD	"FLOW_BARRIER"
+
+typedef struct
+{
+	string	strItem;		// script line, key of g_TxParamMap / g_RxParamMap
+	int		nScriptIndex;	// position in LP_Script.ini, 0-based
+	bool	bRetune;		// frequency or bandwidth differs from the previous step
+	double	dPredictedSec;
+}TEST_PLAN_STEP;
+
+typedef struct
+{
+	vector<TEST_PLAN_STEP> steps;
+	int		nRetunes;			// retunes of the plan
+	int		nRetunesScript;		// retunes of the script order
+	double	dPredictedSec;
+}TEST_PLAN;
+
+int  BuildTestPlan(STRING_TESTITEM_VECTOR *pItems, TEST_PLAN *pPlan);
+double PredictTestPlan(TEST_PLAN *pPlan);
+void UpdateTestPlanModel(const TEST_PLAN_STEP *pStep, double dActualSec);
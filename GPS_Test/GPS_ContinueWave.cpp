@@ -175,7 +175,8 @@ GPS_TEST_API int GPS_ContinueWave(void)
 
 		// Delay for DUT settle
         
-		if (0!=g_GPSGlobalSettingParam.DUT_RX_SETTLE_TIME_MS)
+		// (when DUT_RX_LOCK_TIMEOUT_MS is set, the DUT RX lock is waited for in Step 4 instead)
+		if ( (0!=g_GPSGlobalSettingParam.DUT_RX_SETTLE_TIME_MS)&&(0>=g_GPSGlobalSettingParam.DUT_RX_LOCK_TIMEOUT_MS) )
 		{
 			Sleep(g_GPSGlobalSettingParam.DUT_RX_SETTLE_TIME_MS);
 		}
@@ -187,45 +188,80 @@ GPS_TEST_API int GPS_ContinueWave(void)
         /*-----------------------*
 		 *  Control Tester       *
 		 *-----------------------*/
-        err = LP_GPS_SetActivate();
-		if ( ERR_OK!=err )
+		if (0!=g_GPSGlobalSettingParam.GPS_SESSION_ENABLE)
 		{
-			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[GPS] Fail to set GPS activate, LP_GPS_SetActivate() return error.\n");
-			throw logMessage;
+			// Generator stays on across test items, only a power change is sent to the tester
+			err = LP_GPS_SessionContinueWave(
+					l_CWParam.POWER,
+					l_CWParam.CABLE_LOSS_DB,
+					(IQV_GPS_TRIGGER_STATE)g_GPSGlobalSettingParam.TRIGGER_STATE,
+					l_CWParam.FREQUENCY_OFFSET);
+			if ( ERR_OK!=err )
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[GPS] Fail to start continue wave, LP_GPS_SessionContinueWave() return error.\n");
+				throw logMessage;
+			}
+			else
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[GPS] Start continue wave LP_GPS_SessionContinueWave() return OK.\n");
+			}
 		}
 		else
 		{
-			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[GPS] set GPS activate LP_GPS_SetActivate() return OK.\n");
+			err = LP_GPS_SetActivate();
+			if ( ERR_OK!=err )
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[GPS] Fail to set GPS activate, LP_GPS_SetActivate() return error.\n");
+				throw logMessage;
+			}
+			else
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[GPS] set GPS activate LP_GPS_SetActivate() return OK.\n");
+			}
+
+			err = LP_GPS_ContinueWave(
+									  l_CWParam.POWER, 
+									  l_CWParam.CABLE_LOSS_DB, 
+									  (IQV_GPS_TRIGGER_STATE)g_GPSGlobalSettingParam.TRIGGER_STATE,
+									  l_CWParam.FREQUENCY_OFFSET);
+			if ( ERR_OK!=err )
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[GPS] Fail to start continue wave, LP_GPS_ContinueWave() return error.\n");
+				throw logMessage;
+			}
+			else
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[GPS] Start continue wave LP_GPS_SetActivate() return OK.\n");
+			}
 		}
 
-        err = LP_GPS_ContinueWave(
-								  l_CWParam.POWER, 
-								  l_CWParam.CABLE_LOSS_DB, 
-								  (IQV_GPS_TRIGGER_STATE)g_GPSGlobalSettingParam.TRIGGER_STATE,
-								  l_CWParam.FREQUENCY_OFFSET);
+		// Wait for the DUT to report RX lock instead of a fixed settle delay
+		err = WaitForDutRxLock();
 		if ( ERR_OK!=err )
 		{
-			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[GPS] Fail to start continue wave, LP_GPS_ContinueWave() return error.\n");
+			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[GPS] DUT RX not locked in DUT_RX_LOCK_TIMEOUT_MS, vDUT_Run(RX_WAIT_LOCK) return error.\n");
 			throw logMessage;
 		}
-		else
-		{
-			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[GPS] Start continue wave LP_GPS_SetActivate() return OK.\n");
-		}
+		else{}
 
         //itoa(err, l_CWReturn.ERROR_MESSAGE, 10);
         Sleep(l_CWParam.TIMEOUT*1000);
 
-        err = LP_GPS_SetDeactivate();
-		if ( ERR_OK!=err )
-		{
-			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[GPS] Fail to set GPS deactivate, LP_GPS_SetDeactivate() return error.\n");
-			throw logMessage;
-		}
-		else
+		// In a GPS session the generator stays on for the next test item, see GPS_Disconnect_IQTester
+		if (0==g_GPSGlobalSettingParam.GPS_SESSION_ENABLE)
 		{
-			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[GPS] Set GPS deactivate LP_GPS_SetDeactivate() return OK.\n");
+			err = LP_GPS_SetDeactivate();
+			if ( ERR_OK!=err )
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[GPS] Fail to set GPS deactivate, LP_GPS_SetDeactivate() return error.\n");
+				throw logMessage;
+			}
+			else
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[GPS] Set GPS deactivate LP_GPS_SetDeactivate() return OK.\n");
+			}
 		}
+		else{}
 
 #pragma endregion
 
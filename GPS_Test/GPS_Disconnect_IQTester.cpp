@@ -99,6 +99,13 @@ GPS_TEST_API int GPS_Disconnect_IQTester(void)
 			// do nothing
 		}
 
+		// Turn off the generator left on by a GPS session (GPS_SESSION_ENABLE), no-op otherwise
+		err = LP_GPS_SessionClose();
+		if ( ERR_OK!=err )
+		{
+			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_WARNING, "[GPS] LP_GPS_SessionClose() return error.\n");
+		}
+		else{}
 
 		err = LP_DualHead_ReleaseControl();
 		if ( ERR_OK!=err )
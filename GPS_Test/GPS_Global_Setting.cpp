@@ -153,6 +153,34 @@ void InitializeGlobalSettingContainers(void)
         exit(1);
     }
 
+    /* input:DUT_RX_LOCK_TIMEOUT_MS */
+    setting.type = GPS_SETTING_TYPE_INTEGER;
+	g_GPSGlobalSettingParam.DUT_RX_LOCK_TIMEOUT_MS = 0;
+    if (sizeof(int)==sizeof(g_GPSGlobalSettingParam.DUT_RX_LOCK_TIMEOUT_MS))    // Type_Checking
+    {
+        setting.value = (void*)&g_GPSGlobalSettingParam.DUT_RX_LOCK_TIMEOUT_MS;
+        setting.unit  = "ms";
+        setting.helpText  = "Max time to wait for the DUT to report RX lock (vDUT RX_WAIT_LOCK) after the GPS signal is on.\r\n0: use the fixed DUT_RX_SETTLE_TIME_MS delay instead, Default = 0(ms).";
+        g_GPSGlobalSettingParamMap.insert( pair<string, GPS_SETTING_STRUCT>("DUT_RX_LOCK_TIMEOUT_MS", setting) );
+    }else{
+        printf("Parameter Type Error!\n");
+        exit(1);
+    }
+
+    /* input:GPS_SESSION_ENABLE */
+    setting.type = GPS_SETTING_TYPE_INTEGER;
+	g_GPSGlobalSettingParam.GPS_SESSION_ENABLE = 0;
+    if (sizeof(int)==sizeof(g_GPSGlobalSettingParam.GPS_SESSION_ENABLE))    // Type_Checking
+    {
+        setting.value = (void*)&g_GPSGlobalSettingParam.GPS_SESSION_ENABLE;
+        setting.unit  = "";
+        setting.helpText  = "1: keep the GPS generator activated and the scenario loaded across test items, only changed settings are sent to the tester.\r\n0: activate/deactivate GPS in every test item, Default = 0.";
+        g_GPSGlobalSettingParamMap.insert( pair<string, GPS_SETTING_STRUCT>("GPS_SESSION_ENABLE", setting) );
+    }else{
+        printf("Parameter Type Error!\n");
+        exit(1);
+    }
+
     /* input:doppler_Frequency */
     g_GPSGlobalSettingParam.DOPPLER_FREQUENCY = 0;
     setting.type = GPS_SETTING_TYPE_INTEGER;
@@ -263,7 +263,8 @@ GPS_TEST_API int GPS_ModulatedMode(void)
 
 		// Delay for DUT settle
 
-		if (0!=g_GPSGlobalSettingParam.DUT_RX_SETTLE_TIME_MS)
+		// (when DUT_RX_LOCK_TIMEOUT_MS is set, the DUT RX lock is waited for in Step 4 instead)
+		if ( (0!=g_GPSGlobalSettingParam.DUT_RX_SETTLE_TIME_MS)&&(0>=g_GPSGlobalSettingParam.DUT_RX_LOCK_TIMEOUT_MS) )
 		{
 			Sleep(g_GPSGlobalSettingParam.DUT_RX_SETTLE_TIME_MS);
 		}
@@ -276,17 +277,6 @@ GPS_TEST_API int GPS_ModulatedMode(void)
 		/*-----------------------*
 		 *  Control Tester       *
 		 *-----------------------*/
-		err = LP_GPS_SetActivate();
-		if ( ERR_OK!=err )
-		{
-			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[GPS] Fail to set GPS activate, LP_GPS_SetActivate() return error.\n");
-			throw logMessage;
-		}
-		else
-		{
-			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[GPS] Set GPS activate LP_GPS_SetActivate() return OK.\n");
-		}
-
 		double powerA[6] = {
 			l_MMParam.POWER_1,l_MMParam.POWER_2,
 			l_MMParam.POWER_3,l_MMParam.POWER_4,
@@ -299,22 +289,65 @@ GPS_TEST_API int GPS_ModulatedMode(void)
 			l_MMParam.SATELLITE_NUMBER_5,l_MMParam.SATELLITE_NUMBER_6
 		};
 
-		err = LP_GPS_ModulatedMode(
-				l_MMParam.MODULATED_MODE_NAV_DATA,
-				l_MMParam.CABLE_LOSS_DB,
-				powerA,
-				satelliteNumA,
-				g_GPSGlobalSettingParam.DOPPLER_FREQUENCY,
-				(IQV_GPS_TRIGGER_STATE)g_GPSGlobalSettingParam.TRIGGER_STATE);
-		if ( ERR_OK!=err )
+		if (0!=g_GPSGlobalSettingParam.GPS_SESSION_ENABLE)
 		{
-			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[GPS] Fail to start modulated mode signal, LP_GPS_ModulatedMode() return error.\n");
-			throw logMessage;
+			// Generator stays on across test items, only the changed channels are sent to the tester
+			err = LP_GPS_SessionModulated(
+					l_MMParam.MODULATED_MODE_NAV_DATA,
+					l_MMParam.CABLE_LOSS_DB,
+					powerA,
+					satelliteNumA,
+					g_GPSGlobalSettingParam.DOPPLER_FREQUENCY,
+					(IQV_GPS_TRIGGER_STATE)g_GPSGlobalSettingParam.TRIGGER_STATE);
+			if ( ERR_OK!=err )
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[GPS] Fail to start modulated mode signal, LP_GPS_SessionModulated() return error.\n");
+				throw logMessage;
+			}
+			else
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[GPS] Start modulated mode signal LP_GPS_SessionModulated() return OK.\n");
+			}
 		}
 		else
 		{
-			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[GPS] Start modulated mode signal LP_GPS_ModulatedMode() return OK.\n");
+			err = LP_GPS_SetActivate();
+			if ( ERR_OK!=err )
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[GPS] Fail to set GPS activate, LP_GPS_SetActivate() return error.\n");
+				throw logMessage;
+			}
+			else
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[GPS] Set GPS activate LP_GPS_SetActivate() return OK.\n");
+			}
+
+			err = LP_GPS_ModulatedMode(
+					l_MMParam.MODULATED_MODE_NAV_DATA,
+					l_MMParam.CABLE_LOSS_DB,
+					powerA,
+					satelliteNumA,
+					g_GPSGlobalSettingParam.DOPPLER_FREQUENCY,
+					(IQV_GPS_TRIGGER_STATE)g_GPSGlobalSettingParam.TRIGGER_STATE);
+			if ( ERR_OK!=err )
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[GPS] Fail to start modulated mode signal, LP_GPS_ModulatedMode() return error.\n");
+				throw logMessage;
+			}
+			else
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[GPS] Start modulated mode signal LP_GPS_ModulatedMode() return OK.\n");
+			}
+		}
+
+		// Wait for the DUT to report RX lock instead of a fixed settle delay
+		err = WaitForDutRxLock();
+		if ( ERR_OK!=err )
+		{
+			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[GPS] DUT RX not locked in DUT_RX_LOCK_TIMEOUT_MS, vDUT_Run(RX_WAIT_LOCK) return error.\n");
+			throw logMessage;
 		}
+		else{}
 
 		//itoa(err, l_MMReturn.ERROR_MESSAGE, 10);
 		////////////////////////////////////////////////
@@ -449,16 +482,21 @@ GPS_TEST_API int GPS_ModulatedMode(void)
 		//err = ::vDUT_GetStringReturn(g_GPS_Dut, "ERROR_MESSAGE", temp, MAX_BUFFER_SIZE);
 		// [Jarir Fadlullah] End: Added for Brcm 2076 GPS DUT
 
-		err = LP_GPS_SetDeactivate();
-		if ( ERR_OK!=err )
+		// In a GPS session the generator stays on for the next test item, see GPS_Disconnect_IQTester
+		if (0==g_GPSGlobalSettingParam.GPS_SESSION_ENABLE)
 		{
-			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[GPS] Fail to set GPS deactivate, LP_GPS_SetDeactivate() return error.\n");
-			throw logMessage;
-		}
-		else
-		{
-			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[GPS] Set GPS deactivate LP_GPS_SetDeactivate() return OK.\n");
+			err = LP_GPS_SetDeactivate();
+			if ( ERR_OK!=err )
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[GPS] Fail to set GPS deactivate, LP_GPS_SetDeactivate() return error.\n");
+				throw logMessage;
+			}
+			else
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[GPS] Set GPS deactivate LP_GPS_SetDeactivate() return OK.\n");
+			}
 		}
+		else{}
 
 #pragma endregion
 
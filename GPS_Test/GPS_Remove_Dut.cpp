@@ -108,6 +108,9 @@ GPS_TEST_API int GPS_Remove_Dut(void)
 
 #pragma region Step 4 : Main Step
 
+		// Stop the GPS signal of a session (GPS_SESSION_ENABLE) before the DUT goes away, no-op otherwise
+		LP_GPS_SessionClose();
+
 		// REMOVE_DUT
 		err = vDUT_Run(g_GPS_Dut, "REMOVE_DUT");	
 		if ( ERR_OK!=err )
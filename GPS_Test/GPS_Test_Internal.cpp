@@ -379,6 +379,18 @@ GPS_TEST_API int  ReturnErrorMessage(char *errParameter, const char *format, ...
 GPS_TEST_API int  LogReturnMessage(char *errMsg, int sizeOfBuf, LOGGER_LEVEL level, const char *format, ...)
 {
     int  err = ERR_OK;
+
+	// Warnings and information the logger discards are not formatted, errMsg only gets the format.
+	// Errors are always formatted, the callers throw errMsg.
+	if ( g_Logger_ID>=0 && level>LOGGER_ERROR && !::LOGGER_IsEnabled(LOG_IQLITE_CORE, level) )
+	{
+		strncpy_s(errMsg, sizeOfBuf, format, _TRUNCATE);
+		return err;
+	}
+	else
+	{
+		// do nothing
+	}
 	
 	// Log message format ... variable argument list
 	va_list ap;
@@ -389,7 +401,7 @@ GPS_TEST_API int  LogReturnMessage(char *errMsg, int sizeOfBuf, LOGGER_LEVEL lev
 	// Write error message to log file
 	if (g_Logger_ID>=0)
 	{
-		err = ::LOGGER_Write_Ext(LOG_IQLITE_CORE, g_Logger_ID, level, errMsg);
+		err = ::LOGGER_Write_Ext(LOG_IQLITE_CORE, g_Logger_ID, level, "%s", errMsg);
 		// TODO: if possible, must do the error handling here
 	}
 	else
@@ -530,3 +542,61 @@ GPS_TEST_API int   GetTesterReconnect(int *flag)
     *flag = g_Tester_Reconnect;
     return ERR_OK;
 }
+
+//! Wait for the DUT to report GPS RX lock
+/*!
+ * Runs vDUT "RX_WAIT_LOCK" with TIMEOUT_MS = DUT_RX_LOCK_TIMEOUT_MS, so the test continues as soon as the
+ * DUT has locked instead of sleeping a fixed DUT_RX_SETTLE_TIME_MS.  If the DUT control DLL does not
+ * support RX_WAIT_LOCK, falls back to the fixed settle delay.
+ *
+ * \return ERR_OK DUT locked (or fallback delay done)
+ * \return vDUT_ERR_DUT_FUNCTION_ERROR DUT did not lock before timeout
+ * \return others vDUT_Run(RX_WAIT_LOCK) error
+ */
+int WaitForDutRxLock(void)
+{
+	int err     = ERR_OK;
+	int locked  = 1;
+	int lockTimeMs = 0;
+
+	if (0>=g_GPSGlobalSettingParam.DUT_RX_LOCK_TIMEOUT_MS)
+	{
+		// Nothing to wait for; the fixed DUT_RX_SETTLE_TIME_MS delay is used in Step 3
+		return ERR_OK;
+	}
+
+	::vDUT_AddIntegerParameter(g_GPS_Dut, "TIMEOUT_MS", g_GPSGlobalSettingParam.DUT_RX_LOCK_TIMEOUT_MS);
+	err = ::vDUT_Run(g_GPS_Dut, "RX_WAIT_LOCK");
+	// TIMEOUT_MS is only for RX_WAIT_LOCK, the next vDUT_Run() of the item must not get it
+	::vDUT_RemoveIntegerParameter(g_GPS_Dut, "TIMEOUT_MS");
+	if ( (vDUT_ERR_FUNCTION_NOT_SUPPORTED==err)||(vDUT_ERR_FUNCTION_NOT_DEFINED==err) )
+	{
+		// DUT cannot report lock, use the fixed delay
+		if (0!=g_GPSGlobalSettingParam.DUT_RX_SETTLE_TIME_MS)
+		{
+			Sleep(g_GPSGlobalSettingParam.DUT_RX_SETTLE_TIME_MS);
+		}
+		else{}
+		return ERR_OK;
+	}
+	else if (ERR_OK!=err)
+	{
+		return err;
+	}
+	else
+	{
+		// LOCKED/LOCK_TIME_MS are optional returns
+		if (ERR_OK!=::vDUT_GetIntegerReturn(g_GPS_Dut, "LOCKED", &locked))
+		{
+			locked = 1;
+		}
+		else{}
+		if (ERR_OK==::vDUT_GetIntegerReturn(g_GPS_Dut, "LOCK_TIME_MS", &lockTimeMs))
+		{
+			::LOGGER_Write_Ext(LOG_IQLITE_CORE, g_Logger_ID, LOGGER_INFORMATION, "[GPS] DUT RX locked in %d ms.\n", lockTimeMs);
+		}
+		else{}
+	}
+
+	return (0!=locked) ? ERR_OK : vDUT_ERR_DUT_FUNCTION_ERROR;
+}
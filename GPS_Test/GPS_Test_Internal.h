@@ -81,6 +81,8 @@ typedef struct tagGlobalSettingParam
  char   GPS_HOST_SHELL_SCRIPT[MAX_BUFFER_SIZE];
  char   GPS_HOST_PATH[MAX_BUFFER_SIZE]; 
 	int DELETE_TEMP_FILES;
+	int	   GPS_SESSION_ENABLE;						/*!< 1: keep GPS generator and scenario resident across test items (LP_GPS_Session*), Default = 0. */
+	int	   DUT_RX_LOCK_TIMEOUT_MS;					/*!< Max wait for DUT-reported RX lock (RX_WAIT_LOCK) once the signal is on, 0 = use DUT_RX_SETTLE_TIME_MS. */
 	////////////////////////////////////////////////
 } GPS_GLOBAL_SETTING;
 
@@ -139,5 +141,7 @@ void ClearTransmitScenarioReturn(void);
 void ClearModulatedModeReturn(void);
 void ClearContinueWaveReturn(void);
 
+int  WaitForDutRxLock(void);                                 // Used by GPS_Transmit_Scenario, GPS_ModulatedMode, GPS_ContinueWave
+
 #endif // end of #ifndef _GPS_TEST_INTERNAL_H_
 
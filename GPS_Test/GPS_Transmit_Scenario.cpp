@@ -193,7 +193,8 @@ GPS_TEST_API int GPS_Transmit_Scenario(void)
 		}
 
 		// Delay for DUT settle
-		if (0!=g_GPSGlobalSettingParam.DUT_RX_SETTLE_TIME_MS)
+		// (when DUT_RX_LOCK_TIMEOUT_MS is set, the DUT RX lock is waited for in Step 4 instead)
+		if ( (0!=g_GPSGlobalSettingParam.DUT_RX_SETTLE_TIME_MS)&&(0>=g_GPSGlobalSettingParam.DUT_RX_LOCK_TIMEOUT_MS) )
 		{
 			Sleep(g_GPSGlobalSettingParam.DUT_RX_SETTLE_TIME_MS);
 		}
@@ -206,45 +207,75 @@ GPS_TEST_API int GPS_Transmit_Scenario(void)
 		/*-----------------------*
 		 *  Control Tester       *
 		 *-----------------------*/
-		err = LP_GPS_SetActivate();
-		if ( ERR_OK!=err )
-		{
-			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[GPS] Fail to set GPS activate, LP_GPS_SetActivate() return error.\n");
-			throw logMessage;
-		}
-		else
-		{
-			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[GPS] Set GPS activate LP_GPS_SetActivate() return OK.\n");
-		}
-
 		char fullfile[MAX_BUFFER_SIZE] = {'\0'};
 		sprintf_s(fullfile, MAX_BUFFER_SIZE, "%s/%s", g_GPSGlobalSettingParam.SCENARIO_FILE_PATH, l_TSParam.SCENARIO_FILE);
 
-		err = LP_GPS_LoadScenarioFile(
-				fullfile, //"../mod/IQNavScenarioFile2008241_LondonBigBen.xml",
-				(IQV_GPS_TRIGGER_STATE)g_GPSGlobalSettingParam.TRIGGER_STATE);
-		if ( ERR_OK!=err )
+		if (0!=g_GPSGlobalSettingParam.GPS_SESSION_ENABLE)
 		{
-			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[GPS] Fail to load scenario file, LP_GPS_LoadScenarioFile() return error.\n");
-			throw logMessage;
+			// Scenario stays loaded across test items, only the changed settings are sent to the tester
+			err = LP_GPS_SessionScenario(
+					fullfile,
+					(IQV_GPS_TRIGGER_STATE)g_GPSGlobalSettingParam.TRIGGER_STATE,
+					l_TSParam.POWER,
+					l_TSParam.CABLE_LOSS_DB);
+			if ( ERR_OK!=err )
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[GPS] Fail to play scenario file, LP_GPS_SessionScenario() return error.\n");
+				throw logMessage;
+			}
+			else
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[GPS] Play scenario file LP_GPS_SessionScenario() return OK.\n");
+			}
 		}
 		else
 		{
-			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[GPS] load scenario file LP_GPS_LoadScenarioFile() return OK.\n");
+			err = LP_GPS_SetActivate();
+			if ( ERR_OK!=err )
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[GPS] Fail to set GPS activate, LP_GPS_SetActivate() return error.\n");
+				throw logMessage;
+			}
+			else
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[GPS] Set GPS activate LP_GPS_SetActivate() return OK.\n");
+			}
+
+			err = LP_GPS_LoadScenarioFile(
+					fullfile, //"../mod/IQNavScenarioFile2008241_LondonBigBen.xml",
+					(IQV_GPS_TRIGGER_STATE)g_GPSGlobalSettingParam.TRIGGER_STATE);
+			if ( ERR_OK!=err )
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[GPS] Fail to load scenario file, LP_GPS_LoadScenarioFile() return error.\n");
+				throw logMessage;
+			}
+			else
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[GPS] load scenario file LP_GPS_LoadScenarioFile() return OK.\n");
+			}
+
+			err = LP_GPS_PlayScenarioFile(
+					l_TSParam.POWER,
+					l_TSParam.CABLE_LOSS_DB);
+			if ( ERR_OK!=err )
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[GPS] Fail to play scenario file, LP_GPS_PlayScenarioFile() return error.\n");
+				throw logMessage;
+			}
+			else
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[GPS] Play scenario file LP_GPS_PlayScenarioFile() return OK.\n");
+			}
 		}
 
-		err = LP_GPS_PlayScenarioFile(
-				l_TSParam.POWER,
-				l_TSParam.CABLE_LOSS_DB);
+		// Wait for the DUT to report RX lock instead of a fixed settle delay
+		err = WaitForDutRxLock();
 		if ( ERR_OK!=err )
 		{
-			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[GPS] Fail to play scenario file, LP_GPS_PlayScenarioFile() return error.\n");
+			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[GPS] DUT RX not locked in DUT_RX_LOCK_TIMEOUT_MS, vDUT_Run(RX_WAIT_LOCK) return error.\n");
 			throw logMessage;
 		}
-		else
-		{
-			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[GPS] Play scenario file LP_GPS_PlayScenarioFile() return OK.\n");
-		}
+		else{}
 
 		// [Jarir Fadlullah] Pass timeout value to GPS factory test configuration, for Brcm 2076 GPS DUT
 		//Sleep(l_TSParam.TIMEOUT*1000);
@@ -316,16 +347,21 @@ GPS_TEST_API int GPS_Transmit_Scenario(void)
 		// [Jarir Fadlullah]
 
 
-		err = LP_GPS_SetDeactivate();
-		if ( ERR_OK!=err )
+		// In a GPS session the generator stays on for the next test item, see GPS_Disconnect_IQTester
+		if (0==g_GPSGlobalSettingParam.GPS_SESSION_ENABLE)
 		{
-			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[GPS] Fail to set GPS deactivate, LP_GPS_SetDeactivate() return error.\n");
-			throw logMessage;
-		}
-		else
-		{
-			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[GPS] Set GPS deactivate LP_GPS_SetDeactivate() return OK.\n");
+			err = LP_GPS_SetDeactivate();
+			if ( ERR_OK!=err )
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[GPS] Fail to set GPS deactivate, LP_GPS_SetDeactivate() return error.\n");
+				throw logMessage;
+			}
+			else
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[GPS] Set GPS deactivate LP_GPS_SetDeactivate() return OK.\n");
+			}
 		}
+		else{}
 
 #pragma endregion
 
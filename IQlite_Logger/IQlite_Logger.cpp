@@ -431,13 +431,31 @@ IQLITE_LOGGER_API LOGGER_RETURN LOGGER_GetLoggerSourceLevel(LOGGER_SOURCE logger
 }
 
 
+IQLITE_LOGGER_API int LOGGER_IsEnabled(LOGGER_SOURCE loggerSource, LOGGER_LEVEL level)
+{
+	if ( loggerSource>=0 && loggerSource<MAX_LOGGER_SOURCE && g_IQliteLoggerSource[loggerSource]!=1 )
+	{
+		return 0;	// source OFF
+	}
+	else if ( (g_logAllForDebug==0)&&((level==LOGGER_NONE)||(level>g_loggerLevel)) )
+	{
+		return 0;	// same filter as LOGGER_Write()
+	}
+	else
+	{
+		return 1;
+	}
+}
+
 IQLITE_LOGGER_API LOGGER_RETURN LOGGER_Write_Ext(LOGGER_SOURCE loggerSource, int loggerID, LOGGER_LEVEL level, const char *format, ...)
 {
     LOGGER_RETURN ret = LOGGER_ERR_OK;
 
 	char buffer[MAX_BUFFER_SIZE] = {'\0'};
 
-	if ( g_IQliteLoggerSource[loggerSource]==1 )	// 1 means ON
+	// The file and the callbacks filter on the level alike, so a discarded message is not formatted.
+	// The formatted buffer is written as "%s", a '%' in it is not parsed a second time.
+	if ( LOGGER_IsEnabled(loggerSource, level) )
 	{
         // Log message format ... variable argument list
         va_list ap;
@@ -445,28 +463,28 @@ IQLITE_LOGGER_API LOGGER_RETURN LOGGER_Write_Ext(LOGGER_SOURCE loggerSource, int
 		vsprintf_s(buffer, MAX_BUFFER_SIZE, format, ap);
 		va_end(ap);
 
-		ret = LOGGER_Write( loggerID, level, buffer );    
+		ret = LOGGER_Write( loggerID, level, "%s", buffer );    
 
 		switch(loggerSource)
 		{
 		case LOG_DUT1:
-			LOGGER_Write_CallBack(loggerID, level, dut1Logger, buffer);
+			LOGGER_Write_CallBack(loggerID, level, dut1Logger, "%s", buffer);
 		break;
 
 		case LOG_DUT2:
-			LOGGER_Write_CallBack(loggerID, level, dut2Logger, buffer);
+			LOGGER_Write_CallBack(loggerID, level, dut2Logger, "%s", buffer);
 		break;
 
 		case LOG_DUT3:
-			LOGGER_Write_CallBack(loggerID, level, dut3Logger, buffer);
+			LOGGER_Write_CallBack(loggerID, level, dut3Logger, "%s", buffer);
 		break;
 
 		case LOG_DUT4:
-			LOGGER_Write_CallBack(loggerID, level, dut4Logger, buffer);
+			LOGGER_Write_CallBack(loggerID, level, dut4Logger, "%s", buffer);
 		break;
 
 		default:
-			LOGGER_Write_CallBack(loggerID, level, mainLogger, buffer);
+			LOGGER_Write_CallBack(loggerID, level, mainLogger, "%s", buffer);
 		break;
 		}
 		     
@@ -191,6 +191,16 @@ IQLITE_LOGGER_API LOGGER_RETURN LOGGER_Initialization(void);
 *
 */IQLITE_LOGGER_API LOGGER_RETURN LOGGER_GetLoggerSourceLevel(LOGGER_SOURCE loggerSoure, int* pIntVal);
 
+//! IQlite_Logger check if a message would be written
+/*!
+*
+* \param[in] LOGGER_SOURCE loggerSource, source of LOGGER_Write_Ext(); MAX_LOGGER_SOURCE for LOGGER_Write(), which has no source
+* \param[in] LOGGER_LEVEL level, level of the message
+*
+* \return 1 if LOGGER_Write_Ext()/LOGGER_Write() would write the message, 0 if it would discard it.  Lets a caller skip formatting a message nobody reads.
+*
+*/IQLITE_LOGGER_API int LOGGER_IsEnabled(LOGGER_SOURCE loggerSource, LOGGER_LEVEL level);
+
 
 
 //! IQlite_Logger set callback function for Dut1
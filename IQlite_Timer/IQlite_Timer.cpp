@@ -3,8 +3,10 @@
 #pragma warning(disable : 4996)		// turn off deprecated warning for remaining ones
 
 #include "lp_stdlib.h"
+#include "lp_windows.h" // CRITICAL_SECTION, TlsAlloc
 #include <string>
 #include <map>
+#include <vector>
 #include <errno.h>  // errno
 
 #include "IQlite_Timer.h"
@@ -54,6 +56,41 @@ typedef struct tagIQlite_TimerSummary
 vector <TIMER_SUMMARY_STRUCT> IQliteTimerSummary_Vector[MAX_TIMER_SIZE];
 vector <TIMER_SUMMARY_STRUCT>::size_type vectorSizeOfSummary;
 
+// Trace events, TRACE_EVENT=1 in IQlite_Timer.ini
+#ifndef MAX_TRACE_EVENT_SIZE
+    #define MAX_TRACE_EVENT_SIZE 200000     // per thread, between two TIMER_TraceSave()
+#endif
+#define TRACE_CATEGORY_SIZE 32
+#define TRACE_NAME_SIZE     96
+
+int       g_traceEventOn = 0;
+char      g_timerName[MAX_TIMER_SIZE][TRACE_CATEGORY_SIZE];
+
+typedef struct tagIQlite_TraceEvent
+{
+    char           category[TRACE_CATEGORY_SIZE];
+    char           name[TRACE_NAME_SIZE];
+    double         startInMicroSec;
+    double         durationInMicroSec;  // -1 while the span is open
+} TRACE_EVENT_STRUCT;
+
+// One per thread, the owner thread only waits for its own lock, so recording does not serialize the threads
+typedef struct tagIQlite_TraceThread
+{
+    DWORD                       threadID;
+    HANDLE                      thread;         // signaled once the thread exited, then TIMER_TraceSave() frees the buffer
+    CRITICAL_SECTION            lock;
+    vector <TRACE_EVENT_STRUCT> events;
+    vector <size_t>             openSpans;      // index in events, innermost last
+    int                         droppedEvents;
+} TRACE_THREAD_STRUCT;
+
+DWORD                          g_traceTlsIndex = TLS_OUT_OF_INDEXES;
+CRITICAL_SECTION               g_traceThreadsLock;
+vector <TRACE_THREAD_STRUCT*>  g_traceThreads;
+
+static TIMER_RETURN TIMER_TraceInitiation(void);
+
 // STARTUP
 // DLL startup and initialization code.
 
@@ -133,6 +170,10 @@ static TIMER_RETURN TIMER_IQliteTimerInitiation(void)
 					{
 						g_turnTimerOn = atoi(splits[1].c_str());
 					}
+					else if ( string::npos!=splits[0].find("TRACE_EVENT") )
+					{
+						g_traceEventOn = atoi(splits[1].c_str());
+					}
 					else
 					{
 						// do nothing
@@ -153,9 +194,156 @@ static TIMER_RETURN TIMER_IQliteTimerInitiation(void)
 		g_turnTimerOn = 0;
 	}
 
+	if ( 0!=g_traceEventOn )
+	{
+		TIMER_TraceInitiation();
+	}
+	else
+	{
+		// do nothing
+	}
+
     return ret;
 }
 
+static TIMER_RETURN TIMER_TraceInitiation(void)
+{
+	g_traceTlsIndex = TlsAlloc();
+	if ( TLS_OUT_OF_INDEXES==g_traceTlsIndex )
+	{
+		g_traceEventOn = 0;
+		return TIMER_ERR_TIMER_FUNCTION_ERROR;
+	}
+	else
+	{
+		InitializeCriticalSection(&g_traceThreadsLock);
+	}
+
+	return TIMER_ERR_OK;
+}
+
+// Buffer of the calling thread, created on its first span
+static TRACE_THREAD_STRUCT* TraceThreadBuffer(void)
+{
+	TRACE_THREAD_STRUCT *traceThread = (TRACE_THREAD_STRUCT*)TlsGetValue(g_traceTlsIndex);
+	if ( NULL==traceThread )
+	{
+		traceThread = new TRACE_THREAD_STRUCT;
+		traceThread->threadID = GetCurrentThreadId();
+		traceThread->droppedEvents = 0;
+		if ( !DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(), &traceThread->thread, SYNCHRONIZE, FALSE, 0) )
+		{
+			traceThread->thread = NULL;     // the buffer is then kept until TIMER_Term()
+		}
+		else
+		{
+			// do nothing
+		}
+		InitializeCriticalSection(&traceThread->lock);
+		TlsSetValue(g_traceTlsIndex, traceThread);
+
+		EnterCriticalSection(&g_traceThreadsLock);
+		g_traceThreads.push_back(traceThread);
+		LeaveCriticalSection(&g_traceThreadsLock);
+	}
+	else
+	{
+		// do nothing
+	}
+	return traceThread;
+}
+
+static void TraceFreeThread(TRACE_THREAD_STRUCT *traceThread)
+{
+	if ( NULL!=traceThread->thread )
+	{
+		CloseHandle(traceThread->thread);
+	}
+	else
+	{
+		// do nothing
+	}
+	DeleteCriticalSection(&traceThread->lock);
+	delete traceThread;
+}
+
+static double TraceTimeInMicroSec(void)
+{
+	highrestimer::lp_time_t now;
+	highrestimer::GetTime(now);
+	return highrestimer::GetElapsedMSec(g_highPerformanceFreq, now)*1000;
+}
+
+static void TraceBegin(const char* category, const char* name)
+{
+	TRACE_THREAD_STRUCT *traceThread = TraceThreadBuffer();
+	TRACE_EVENT_STRUCT   traceEvent;
+
+	strncpy_s(traceEvent.category, TRACE_CATEGORY_SIZE, category, _TRUNCATE);
+	strncpy_s(traceEvent.name, TRACE_NAME_SIZE, name, _TRUNCATE);
+	traceEvent.durationInMicroSec = -1;
+
+	EnterCriticalSection(&traceThread->lock);
+	if ( (int)traceThread->events.size()<MAX_TRACE_EVENT_SIZE )
+	{
+		traceEvent.startInMicroSec = TraceTimeInMicroSec();
+		traceThread->openSpans.push_back(traceThread->events.size());
+		traceThread->events.push_back(traceEvent);
+	}
+	else
+	{
+		traceThread->droppedEvents++;
+	}
+	LeaveCriticalSection(&traceThread->lock);
+}
+
+static TIMER_RETURN TraceEnd(const char* name)
+{
+	TIMER_RETURN ret = TIMER_ERR_PARAM_DOES_NOT_EXIST;
+	double stopInMicroSec = TraceTimeInMicroSec();
+	TRACE_THREAD_STRUCT *traceThread = (TRACE_THREAD_STRUCT*)TlsGetValue(g_traceTlsIndex);
+
+	// A thread that never opened a span has no buffer, and gets none here
+	if ( NULL==traceThread )
+	{
+		return ret;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	EnterCriticalSection(&traceThread->lock);
+	for (int i=(int)traceThread->openSpans.size()-1;i>=0;i--)
+	{
+		TRACE_EVENT_STRUCT *traceEvent = &traceThread->events[traceThread->openSpans[i]];
+		if ( 0==strncmp(traceEvent->name, name, TRACE_NAME_SIZE-1) )
+		{
+			traceEvent->durationInMicroSec = stopInMicroSec-traceEvent->startInMicroSec;
+			traceThread->openSpans.erase(traceThread->openSpans.begin()+i);
+			ret = TIMER_ERR_OK;
+			break;
+		}
+		else
+		{
+			// keep searching the enclosing spans
+		}
+	}
+	LeaveCriticalSection(&traceThread->lock);
+
+	return ret;
+}
+
+static void TraceWriteString(FILE *traceFile, const char* value)
+{
+	for (const char *c=value;*c!='\0';c++)
+	{
+		if ( '"'==*c || '\\'==*c )       fprintf(traceFile, "\\%c", *c);
+		else if ( (unsigned char)*c<0x20 ) fprintf(traceFile, "\\u%04x", (unsigned char)*c);
+		else                               fputc(*c, traceFile);
+	}
+}
+
 IQLITE_TIMER_API TIMER_RETURN TIMER_ClearTimerHistory(int supervisorID)
 {
     TIMER_RETURN ret = TIMER_ERR_OK;
@@ -189,6 +377,7 @@ IQLITE_TIMER_API TIMER_RETURN TIMER_CreateTimer(char* timerName, int *timerID, B
 
             *timerID = g_sequenceOfID;
             IQliteTimerID_Map.insert(IQliteTimerID_Pair(timerName, g_sequenceOfID));
+            strncpy_s(g_timerName[g_sequenceOfID], TRACE_CATEGORY_SIZE, timerName, _TRUNCATE);
 
             // Create Supervisor ID
             if ( createSupervisorID==TRUE )
@@ -299,6 +488,15 @@ IQLITE_TIMER_API TIMER_RETURN TIMER_StartTimer(int timerID, char* tag, lp_time_t
 			}
 
 			IQliteTimeStamp_Vector[timerID].push_back(dummyStruct);
+
+			if ( 0!=g_traceEventOn )
+			{
+				TraceBegin(g_timerName[timerID], tag);
+			}
+			else
+			{
+				// do nothing
+			}
 		}
     }
     else
@@ -363,6 +561,15 @@ IQLITE_TIMER_API TIMER_RETURN TIMER_StopTimer(int timerID, char* tag, double *du
 						IQliteTimeStamp_Vector[timerID][i].counterStop = dummyCounter;
 						IQliteTimeStamp_Vector[timerID][i].timerStarted = FALSE;    // Mark this timer stoped
 
+						if ( 0!=g_traceEventOn )
+						{
+							TraceEnd(tag);
+						}
+						else
+						{
+							// do nothing
+						}
+
 						if(NULL!=timeStamp)
 						{
 							*timeStamp = dummyCounter;  // Return this time stamp
@@ -633,4 +840,195 @@ IQLITE_TIMER_API TIMER_RETURN TIMER_ReportTimerDurations(lp_time_t timeStampStar
 
 	return ret;
 
-}
\ No newline at end of file
+}
+
+IQLITE_TIMER_API TIMER_RETURN TIMER_TraceBegin(char* category, char* name)
+{
+	if ( 0!=g_traceEventOn )
+	{
+		TraceBegin(category, name);
+	}
+	else
+	{
+		// do nothing
+	}
+
+	return TIMER_ERR_OK;
+}
+
+IQLITE_TIMER_API TIMER_RETURN TIMER_TraceOn(void)
+{
+	TIMER_RETURN ret = TIMER_ERR_OK;
+
+	if ( 0==g_traceEventOn )
+	{
+		ret = TIMER_TraceInitiation();
+		if ( TIMER_ERR_OK==ret )
+		{
+			g_traceEventOn = 1;
+		}
+		else
+		{
+			// do nothing
+		}
+	}
+	else
+	{
+		// do nothing
+	}
+
+	return ret;
+}
+
+IQLITE_TIMER_API TIMER_RETURN TIMER_TraceEnd(char* name)
+{
+	if ( 0!=g_traceEventOn )
+	{
+		return TraceEnd(name);
+	}
+	else
+	{
+		return TIMER_ERR_OK;
+	}
+}
+
+IQLITE_TIMER_API TIMER_RETURN TIMER_TraceSave(char* fileName)
+{
+	TIMER_RETURN ret = TIMER_ERR_OK;
+	char   c_path[MAX_BUFFER_SIZE] = {'\0'};
+	FILE  *traceFile = NULL;
+
+	if ( 0==g_traceEventOn )
+	{
+		return ret;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	if ( NULL==fileName )
+	{
+		struct tm *current = NULL;
+		time_t bintime = NULL;
+		time(&bintime);
+		current = localtime(&bintime);
+		sprintf_s(c_path, MAX_BUFFER_SIZE, ".\\Timer\\%d.%d.%d-%d.%d.%d_Trace.json", (current->tm_year+1900), (current->tm_mon+1), current->tm_mday, current->tm_hour, current->tm_min, current->tm_sec);
+	}
+	else
+	{
+		sprintf_s(c_path, MAX_BUFFER_SIZE, "%s", fileName);
+	}
+
+	fopen_s( &traceFile, c_path, "w" );
+	if ( NULL==traceFile )
+	{
+		return TIMER_ERR_TIMER_FUNCTION_ERROR;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	DWORD processID = GetCurrentProcessId();
+	bool  firstEvent = true;
+	fprintf(traceFile, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+	EnterCriticalSection(&g_traceThreadsLock);
+	for (size_t t=0;t<g_traceThreads.size();)
+	{
+		TRACE_THREAD_STRUCT *traceThread = g_traceThreads[t];
+		vector <TRACE_EVENT_STRUCT> events;
+		bool threadExited = ( NULL!=traceThread->thread && WAIT_OBJECT_0==WaitForSingleObject(traceThread->thread, 0) );
+
+		// Take the closed spans, the open ones stay for the next save
+		EnterCriticalSection(&traceThread->lock);
+		if ( traceThread->openSpans.empty() )
+		{
+			events.swap(traceThread->events);
+		}
+		else
+		{
+			vector <TRACE_EVENT_STRUCT> openEvents;
+			for (size_t i=0;i<traceThread->events.size();i++)
+			{
+				if ( 0>traceThread->events[i].durationInMicroSec ) openEvents.push_back(traceThread->events[i]);
+				else                                               events.push_back(traceThread->events[i]);
+			}
+			traceThread->events.swap(openEvents);
+			for (size_t i=0;i<traceThread->openSpans.size();i++)
+			{
+				traceThread->openSpans[i] = i;
+			}
+		}
+		int droppedEvents = traceThread->droppedEvents;
+		traceThread->droppedEvents = 0;
+		LeaveCriticalSection(&traceThread->lock);
+
+		for (size_t i=0;i<events.size();i++)
+		{
+			fprintf(traceFile, "%s\n{\"name\":\"", firstEvent ? "" : ",");
+			TraceWriteString(traceFile, events[i].name);
+			fprintf(traceFile, "\",\"cat\":\"");
+			TraceWriteString(traceFile, events[i].category);
+			fprintf(traceFile, "\",\"ph\":\"X\",\"ts\":%.1f,\"dur\":%.1f,\"pid\":%lu,\"tid\":%lu}",
+					events[i].startInMicroSec, events[i].durationInMicroSec, (unsigned long)processID, (unsigned long)traceThread->threadID);
+			firstEvent = false;
+		}
+		if ( 0<droppedEvents )
+		{
+			fprintf(traceFile, "%s\n{\"name\":\"%d spans dropped, over MAX_TRACE_EVENT_SIZE\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.1f,\"pid\":%lu,\"tid\":%lu}",
+					firstEvent ? "" : ",", droppedEvents, TraceTimeInMicroSec(), (unsigned long)processID, (unsigned long)traceThread->threadID);
+			firstEvent = false;
+		}
+		else
+		{
+			// do nothing
+		}
+
+		// An exited thread records nothing more, and its open spans can never close
+		if ( threadExited )
+		{
+			TraceFreeThread(traceThread);
+			g_traceThreads.erase(g_traceThreads.begin()+t);
+		}
+		else
+		{
+			t++;
+		}
+	}
+	LeaveCriticalSection(&g_traceThreadsLock);
+
+	fprintf(traceFile, "\n]}\n");
+	fclose(traceFile);
+
+	return ret;
+}
+
+IQLITE_TIMER_API TIMER_RETURN TIMER_Term(void)
+{
+	TIMER_RETURN ret = TIMER_TraceSave(NULL);
+
+	if ( 0!=g_traceEventOn )
+	{
+		g_traceEventOn = 0;
+
+		EnterCriticalSection(&g_traceThreadsLock);
+		for (size_t t=0;t<g_traceThreads.size();t++)
+		{
+			TraceFreeThread(g_traceThreads[t]);
+		}
+		g_traceThreads.clear();
+		LeaveCriticalSection(&g_traceThreadsLock);
+
+		DeleteCriticalSection(&g_traceThreadsLock);
+		TlsFree(g_traceTlsIndex);
+		g_traceTlsIndex = TLS_OUT_OF_INDEXES;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	return ret;
+}
@@ -146,4 +146,70 @@ IQLITE_TIMER_API TIMER_RETURN TIMER_StopTimer(int timerID, char* tag, double *du
  */
 IQLITE_TIMER_API TIMER_RETURN TIMER_ReportTimerDurations(lp_time_t timeStampStart, lp_time_t timeStampStop);
 
+//! IQlite_Timer Begin Trace Span function
+/*!
+ * Opens a span on the trace of the calling thread, TRACE_EVENT=1 in IQlite_Timer.ini.
+ * TIMER_StartTimer()/TIMER_StopTimer() record their tags as spans already, with the timer name as category.
+ *
+ * \param[in]  char* category, e.g. the module name
+ * \param[in]  char* name, a name of the span
+ *
+ * \return TIMER_ERR_OK If the span is opened or the trace is OFF
+ *
+ */
+IQLITE_TIMER_API TIMER_RETURN TIMER_TraceBegin(char* category, char* name);
+
+//! IQlite_Timer Trace On function
+/*!
+ * Turns the trace ON as TRACE_EVENT=1 in IQlite_Timer.ini does, e.g. for a test.  Call it before the spans to record;
+ * TIMER_Term() turns the trace OFF again.
+ *
+ * \return TIMER_ERR_OK If the trace is ON
+ *
+ */
+IQLITE_TIMER_API TIMER_RETURN TIMER_TraceOn(void);
+
+//! IQlite_Timer End Trace Span function
+/*!
+ *
+ * \param[in]  char* name, the name given to TIMER_TraceBegin(), the innermost open span of this name on the calling thread is closed
+ *
+ * \return TIMER_ERR_OK If the span is closed or the trace is OFF; TIMER_ERR_PARAM_DOES_NOT_EXIST if no such span is open
+ *
+ */
+IQLITE_TIMER_API TIMER_RETURN TIMER_TraceEnd(char* name);
+
+//! IQlite_Timer Save Trace function
+/*!
+ * Writes the closed spans of all threads in Chrome trace event format (chrome://tracing, Perfetto) and clears them.
+ * The buffers of threads that exited are freed; their open spans are dropped.
+ *
+ * \param[in]  char* fileName, default = NULL, Timer/<date-time>_Trace.json
+ *
+ * \return TIMER_ERR_OK If the trace is saved or the trace is OFF
+ *
+ */
+IQLITE_TIMER_API TIMER_RETURN TIMER_TraceSave(char* fileName=NULL);
+
+//! IQlite_Timer Terminate function
+/*!
+ * Saves what is left of the trace to Timer/<date-time>_Trace.json, turns the trace OFF and frees its buffers.
+ * Nothing is saved when the DLL is unloaded, so call it before the process exits, when no other thread is tracing;
+ * TM_Term() of TestManager calls it.
+ *
+ * \return TIMER_ERR_OK If the trace is saved or the trace is OFF
+ *
+ */
+IQLITE_TIMER_API TIMER_RETURN TIMER_Term(void);
+
+//! Trace span of a C++ scope, closed by the destructor on every return path
+class TIMER_TraceScope
+{
+public:
+	TIMER_TraceScope(char* category, char* name) : m_name(name) { TIMER_TraceBegin(category, m_name); }
+	~TIMER_TraceScope() { TIMER_TraceEnd(m_name); }
+private:
+	char* m_name;
+};
+
 #endif //end of _IQTLITE_TIMER_H_
\ No newline at end of file
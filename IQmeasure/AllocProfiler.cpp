@@ -0,0 +1,314 @@
+// AllocProfiler.cpp : operator new hook of the TestManager allocation profiler, see AllocProfiler.h
+//
+// Replaces the global operator new and delete of the module it is linked into; the memory still comes from the CRT
+// malloc() and free(), so blocks may be freed by another module as before.  While the profiler is stopped, or if
+// TestManager.dll was not loaded when the module made its first allocation, the hook costs two compares.  While it
+// runs, each thread adds the allocation to its counters and a byte countdown; the thread calls TestManager only when
+// the countdown expires (a sample, with the call stack) or when the epoch changed (the end of a TM_Run()).  The
+// sample interval is randomized by +/-50%, so periodic allocation patterns do not always sample the same call site.
+//
+// The call stack is walked through frame pointers; in modules built with frame pointer omission (/Oy), the frames
+// after the first one may be missing.
+#include "stdafx.h"
+#include <windows.h>
+#include <stdlib.h>
+#include <new>
+#include <new.h>
+#include "AllocProfiler.h"
+
+typedef USHORT (WINAPI *ALLOC_HOOK_BACKTRACE)(ULONG framesToSkip, ULONG framesToCapture, PVOID *backTrace, PULONG backTraceHash);
+
+typedef struct tagAllocHookThread
+{
+	long			epoch;			// epoch of the counters below
+	unsigned int	allocs;			// since the last record
+	unsigned int	bytes;
+	long			countdown;		// bytes left before the next sample
+	unsigned int	random;			// xorshift state of the sample interval
+	bool			inRecord;		// allocations made by TestManager while recording are not counted
+} ALLOC_HOOK_THREAD;
+
+typedef struct tagAllocHook
+{
+	volatile long			attached;		// 0 not tried yet, 1 attached, 2 attaching, -1 TestManager not loaded
+	ALLOC_PROFILER_STATE	*state;
+	ALLOC_PROFILER_RECORD	record;
+	ALLOC_HOOK_BACKTRACE	backTrace;
+	DWORD					tls;
+} ALLOC_HOOK;
+
+static ALLOC_HOOK g_allocHook = { 0, NULL, NULL, NULL, TLS_OUT_OF_INDEXES };
+
+static void AllocHookAttach(void)
+{
+	if ( 0!=InterlockedCompareExchange(&g_allocHook.attached, 2, 0) )
+	{
+		// Another thread is attaching; its allocations meanwhile are not counted
+		return;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	// TestManager is pinned: the hook keeps pointers into it until the process exits
+	HMODULE testManager = NULL;
+	HMODULE kernel32 = GetModuleHandleA("kernel32.dll");
+	ALLOC_PROFILER_ATTACH attach = NULL;
+	if ( GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_PIN, ALLOC_PROFILER_MODULE, &testManager) && NULL!=kernel32 )
+	{
+		attach                = (ALLOC_PROFILER_ATTACH)GetProcAddress(testManager, ALLOC_PROFILER_ATTACH_NAME);
+		g_allocHook.record    = (ALLOC_PROFILER_RECORD)GetProcAddress(testManager, ALLOC_PROFILER_RECORD_NAME);
+		g_allocHook.backTrace = (ALLOC_HOOK_BACKTRACE)GetProcAddress(kernel32, "RtlCaptureStackBackTrace");
+	}
+	else
+	{
+		// do nothing
+	}
+
+	if ( NULL!=attach && NULL!=g_allocHook.record && NULL!=g_allocHook.backTrace )
+	{
+		g_allocHook.tls   = TlsAlloc();
+		g_allocHook.state = attach();
+	}
+	else
+	{
+		// do nothing
+	}
+
+	if ( TLS_OUT_OF_INDEXES!=g_allocHook.tls && NULL!=g_allocHook.state )
+	{
+		InterlockedExchange(&g_allocHook.attached, 1);
+	}
+	else
+	{
+		InterlockedExchange(&g_allocHook.attached, -1);
+	}
+}
+
+// The thread state is not allocated with operator new, to keep the hook out of its own way
+static ALLOC_HOOK_THREAD* AllocHookNewThread(void)
+{
+	ALLOC_HOOK_THREAD *thread = (ALLOC_HOOK_THREAD*)HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(ALLOC_HOOK_THREAD));
+	if (NULL!=thread)
+	{
+		thread->random    = (GetTickCount()<<8) ^ GetCurrentThreadId() ^ 0x9E3779B9;
+		thread->countdown = g_allocHook.state->sampleInterval;
+		TlsSetValue(g_allocHook.tls, thread);
+	}
+	else
+	{
+		// do nothing
+	}
+	return thread;
+}
+
+static long AllocHookNextInterval(ALLOC_HOOK_THREAD *thread)
+{
+	thread->random ^= thread->random<<13;
+	thread->random ^= thread->random>>17;
+	thread->random ^= thread->random<<5;
+
+	long interval = g_allocHook.state->sampleInterval;
+	if (interval<2)
+	{
+		return 1;
+	}
+	else
+	{
+		return interval/2 + (long)(thread->random%(unsigned int)interval);
+	}
+}
+
+static void AllocHookRecord(ALLOC_HOOK_THREAD *thread, unsigned int sampleSize, void **frames, int frameCount)
+{
+	thread->inRecord = true;
+	g_allocHook.record(thread->epoch, thread->allocs, thread->bytes, sampleSize, frames, frameCount);
+	thread->inRecord = false;
+	thread->allocs = 0;
+	thread->bytes  = 0;
+}
+
+// Not inlined, so the first frame kept is always the caller of operator new
+static __declspec(noinline) void AllocHookSample(ALLOC_HOOK_THREAD *thread, size_t size)
+{
+	void *frames[ALLOC_PROFILER_MAX_FRAMES];
+	// Skips AllocHookSample(), AllocHookCount() and operator new
+	int frameCount = g_allocHook.backTrace(3, ALLOC_PROFILER_MAX_FRAMES, frames, NULL);
+
+	AllocHookRecord(thread, (unsigned int)size, frames, frameCount);
+	thread->countdown = AllocHookNextInterval(thread);
+}
+
+static __declspec(noinline) void AllocHookCount(size_t size)
+{
+	if (1!=g_allocHook.attached)
+	{
+		if (0==g_allocHook.attached)
+		{
+			AllocHookAttach();
+		}
+		else
+		{
+			// do nothing
+		}
+		return;
+	}
+	else if (0==g_allocHook.state->epoch)
+	{
+		return;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	// TlsGetValue() clears the last error, which the caller of new may not have read yet
+	DWORD lastError = GetLastError();
+
+	ALLOC_HOOK_THREAD *thread = (ALLOC_HOOK_THREAD*)TlsGetValue(g_allocHook.tls);
+	if (NULL==thread)
+	{
+		thread = AllocHookNewThread();
+	}
+	else
+	{
+		// do nothing
+	}
+
+	if ( NULL!=thread && !thread->inRecord )
+	{
+		long epoch = g_allocHook.state->epoch;
+		if ( epoch!=thread->epoch && 0!=epoch )
+		{
+			// The counters belong to the previous epoch, and maybe to another TM_Run() keyword
+			if ( 0!=thread->allocs && 0!=thread->epoch )
+			{
+				AllocHookRecord(thread, 0, NULL, 0);
+			}
+			else
+			{
+				thread->allocs = 0;
+				thread->bytes  = 0;
+			}
+			thread->epoch = epoch;
+		}
+		else
+		{
+			// do nothing
+		}
+
+		thread->allocs++;
+		thread->bytes     += (unsigned int)size;
+		thread->countdown -= (long)size;
+		if (thread->countdown<=0)
+		{
+			AllocHookSample(thread, size);
+		}
+		else
+		{
+			// do nothing
+		}
+	}
+	else
+	{
+		// do nothing
+	}
+
+	SetLastError(lastError);
+}
+
+static void* AllocHookMalloc(size_t size)
+{
+	void *memory = NULL;
+	while ( NULL==(memory=malloc(0==size ? 1 : size)) )
+	{
+		// Same as the CRT operator new: give the new handler a chance before failing
+		if ( 0==_callnewh(size) )
+		{
+			return NULL;
+		}
+		else
+		{
+			// do nothing
+		}
+	}
+	return memory;
+}
+
+// Each operator new calls AllocHookCount() itself, so the sampled call stacks all start at the same depth
+void* operator new(size_t size)
+{
+	void *memory = AllocHookMalloc(size);
+	if (NULL==memory)
+	{
+		throw std::bad_alloc();
+	}
+	else
+	{
+		AllocHookCount(size);
+		return memory;
+	}
+}
+
+void* operator new[](size_t size)
+{
+	void *memory = AllocHookMalloc(size);
+	if (NULL==memory)
+	{
+		throw std::bad_alloc();
+	}
+	else
+	{
+		AllocHookCount(size);
+		return memory;
+	}
+}
+
+void* operator new(size_t size, const std::nothrow_t&) throw()
+{
+	void *memory = AllocHookMalloc(size);
+	if (NULL!=memory)
+	{
+		AllocHookCount(size);
+	}
+	else
+	{
+		// do nothing
+	}
+	return memory;
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) throw()
+{
+	void *memory = AllocHookMalloc(size);
+	if (NULL!=memory)
+	{
+		AllocHookCount(size);
+	}
+	else
+	{
+		// do nothing
+	}
+	return memory;
+}
+
+void operator delete(void *memory) throw()
+{
+	free(memory);
+}
+
+void operator delete[](void *memory) throw()
+{
+	free(memory);
+}
+
+void operator delete(void *memory, const std::nothrow_t&) throw()
+{
+	free(memory);
+}
+
+void operator delete[](void *memory, const std::nothrow_t&) throw()
+{
+	free(memory);
+}
@@ -0,0 +1,34 @@
+// AllocProfiler.h : Interface between the operator new hook (AllocProfiler.cpp) and the TestManager profiler
+//
+// AllocProfiler.cpp is linked into each module to profile (IQmeasure, WiFi_Test, IQmeasureTest).  It counts the
+// allocations of every thread and, about once per sample interval of bytes, sends the counts and the call stack to
+// TM_AllocProfilerRecord(), which files them under the TM_Run() keyword running on that thread.  The profiler is
+// off until TM_AllocProfilerStart(); see TestManager.h.
+#ifndef _ALLOC_PROFILER_H_
+#define _ALLOC_PROFILER_H_
+
+#define ALLOC_PROFILER_MODULE				"TestManager.dll"
+#define ALLOC_PROFILER_ATTACH_NAME			"TM_AllocProfilerAttach"
+#define ALLOC_PROFILER_RECORD_NAME			"TM_AllocProfilerRecord"
+
+#define ALLOC_PROFILER_MAX_FRAMES			8
+#define ALLOC_PROFILER_DEFAULT_INTERVAL		(512*1024)		// bytes between two samples, on average
+
+//! Shared by TestManager and the hooks; the hooks only read it
+typedef struct tagAllocProfilerState
+{
+	volatile long	epoch;				/*!< 0 if the profiler is stopped; changes at each TM_Run() start and end */
+	volatile long	sampleInterval;		/*!< Bytes between two samples, on average */
+} ALLOC_PROFILER_STATE;
+
+//! TM_AllocProfilerAttach(): the state read by the hooks
+typedef ALLOC_PROFILER_STATE* (__stdcall *ALLOC_PROFILER_ATTACH)(void);
+
+//! TM_AllocProfilerRecord(): allocations of the calling thread since its last record, all made during epoch
+/*!
+ * sampleSize is 0 if the record only closes an epoch; otherwise it is the size of the allocation that crossed
+ * the sample interval, made from frames[0].
+ */
+typedef void (__stdcall *ALLOC_PROFILER_RECORD)(long epoch, unsigned int allocs, unsigned int bytes, unsigned int sampleSize, void **frames, int frameCount);
+
+#endif
@@ -0,0 +1,89 @@
+// CaptureIndex.h : Fields of the capture_index.csv of the capture archive
+//
+// IQmeasure_CaptureArchive.cpp writes the index and reads it back for the quota; IQreanalyze reads it
+// to find the captures.  Both go through these functions, so they agree on the format:
+//   Timestamp,DUT_Serial,Test_Item,File,Bytes
+// A field holding a ',' or a '"' is quoted, a '"' in it doubled.  Line ends in a field become spaces,
+// one line is always one capture.  Index files written before the quoting have no quoted fields and
+// read the same.
+#ifndef _CAPTURE_INDEX_H_
+#define _CAPTURE_INDEX_H_
+
+#include <string>
+#include <vector>
+
+#define CAPTURE_INDEX_HEADER		"Timestamp,DUT_Serial,Test_Item,File,Bytes"
+#define CAPTURE_INDEX_FILE_COLUMN	3
+
+//! Text of one field, quoted if needed
+inline std::string CaptureIndexField(const char *text)
+{
+	std::string field;
+	bool        quote = false;
+
+	for (const char *c=text; NULL!=c && '\0'!=*c; c++)
+	{
+		if ( '\r'==*c || '\n'==*c )
+		{
+			field += ' ';
+		}
+		else if ('"'==*c)
+		{
+			field += "\"\"";
+			quote  = true;
+		}
+		else
+		{
+			quote  = quote || (','==*c);
+			field += *c;
+		}
+	}
+
+	return quote ? "\"" + field + "\"" : field;
+}
+
+//! Fields of one line, without the line end
+inline void CaptureIndexSplit(const char *line, std::vector<std::string> &fields)
+{
+	std::string field;
+	bool        quoted = false;
+	const char *c      = line;
+
+	fields.clear();
+	while ( NULL!=c && '\0'!=*c && '\r'!=*c && '\n'!=*c )
+	{
+		if (quoted)
+		{
+			if ( '"'==c[0] && '"'==c[1] )
+			{
+				field += '"';
+				c++;
+			}
+			else if ('"'==*c)
+			{
+				quoted = false;
+			}
+			else
+			{
+				field += *c;
+			}
+		}
+		else if ( '"'==*c && field.empty() )
+		{
+			quoted = true;
+		}
+		else if (','==*c)
+		{
+			fields.push_back(field);
+			field.clear();
+		}
+		else
+		{
+			field += *c;
+		}
+		c++;
+	}
+	fields.push_back(field);
+}
+
+#endif // _CAPTURE_INDEX_H_
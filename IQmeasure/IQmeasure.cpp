@@ -29,6 +29,9 @@ int  g_IQtype= IQTYPE_2010;
 
 char g_cTesterName[512] = {'\0'};
 
+// Settings sent by LP_ApplyProfile(), implemented in IQmeasure_Profile.cpp
+void ProfileForget(const char *key);
+
 //---------------------------------------------------------------
 // Macro definition
 //---------------------------------------------------------------
@@ -114,6 +117,10 @@ typedef int		(*LP_GetVsaSettingsType)(double *freqHz, double *ampl, IQAPI_PORT_E
 typedef int		(*LP_VsaDataCaptureType)(double samplingTimeSecs, int triggerType, double sampleFreqHz, int ht40Mode,IQMEASURE_CAPTURE_NONBLOCKING_STATES nonBlockingState);
 typedef int		(*LP_GetSampleDataType)(int vsaNum, double bufferReal[], double bufferImag[], int bufferLength);
 typedef int		(*LP_GetHndlDataPointersType)(double *real[],double *imag[],int *length, double *sampleFreqHz, int arraySize);
+typedef bool	(*LP_MptaAvailableType)();
+typedef int		(*LP_MptaEnableType)();
+typedef int		(*LP_MptaDisableType)();
+typedef int		(*LP_MptaSetupCaptureType)(TX_PATH_ENUM tx_path, double rfFreqHz, double peakSignaldB, double CaptureTimeUs);
 typedef int		(*LP_SaveUserDataToSigFileType)(char* sigFileName,
 		double *real[],
 		double *imag[],
@@ -183,6 +190,7 @@ typedef double	(*LP_GetScalarMeasurmentType)(char *measurement, int index);
 typedef int		(*LP_GetVectorMeasurmentType)(char *measurement, double bufferReal[], double bufferImag[], int bufferLength);
 typedef int		(*LP_GetStringMeasurmentType)(char *measurement, char bufferChar[], int bufferLength);
 typedef double	(*LP_GetScalarMeasurementType)(char *measurement, int index);
+typedef int		(*LP_GetScalarMeasurementArrayType)(char *measurement, double values[], int bufferLength);
 typedef int		(*LP_GetVectorMeasurementType)(char *measurement, double bufferReal[], double bufferImag[], int bufferLength);
 typedef int		(*LP_GetStringMeasurementType)(char *measurement, char bufferChar[], int bufferLength);
 typedef int		(*LP_PlotDataCaptureType)();
@@ -548,6 +556,10 @@ LP_GetVsaSettingsType			LP_GetVsaSettings_Ptr;
 LP_VsaDataCaptureType			LP_VsaDataCapture_Ptr;
 LP_GetSampleDataType			LP_GetSampleData_Ptr;
 LP_GetHndlDataPointersType		LP_GetHndlDataPointers_Ptr;
+LP_MptaAvailableType			LP_MptaAvailable_Ptr;
+LP_MptaEnableType				LP_MptaEnable_Ptr;
+LP_MptaDisableType				LP_MptaDisable_Ptr;
+LP_MptaSetupCaptureType			LP_MptaSetupCapture_Ptr;
 LP_SaveUserDataToSigFileType	LP_SaveUserDataToSigFile_Ptr;
 LP_SelectCaptureRangeForAnalysisType	LP_SelectCaptureRangeForAnalysis_Ptr;
 LP_Analyze80216dType			LP_Analyze80216d_Ptr;
@@ -573,6 +585,7 @@ LP_GetScalarMeasurmentType		LP_GetScalarMeasurment_Ptr;
 LP_GetVectorMeasurmentType		LP_GetVectorMeasurment_Ptr;
 LP_GetStringMeasurmentType		LP_GetStringMeasurment_Ptr;
 LP_GetScalarMeasurementType		LP_GetScalarMeasurement_Ptr;
+LP_GetScalarMeasurementArrayType	LP_GetScalarMeasurementArray_Ptr;
 LP_GetVectorMeasurementType		LP_GetVectorMeasurement_Ptr;
 LP_GetStringMeasurementType		LP_GetStringMeasurement_Ptr;
 LP_PlotDataCaptureType			LP_PlotDataCapture_Ptr;
@@ -881,6 +894,7 @@ static int loadDynamicLibrary(void)
 	LOAD_DLLPTR(LP_GetVectorMeasurment);
 	LOAD_DLLPTR(LP_GetStringMeasurment);
 	LOAD_DLLPTR(LP_GetScalarMeasurement);
+	LOAD_DLLPTR(LP_GetScalarMeasurementArray);
 	LOAD_DLLPTR(LP_GetVectorMeasurement);
 	LOAD_DLLPTR(LP_GetStringMeasurement);
 	LOAD_DLLPTR(LP_PlotDataCapture);
@@ -946,6 +960,10 @@ static int loadDynamicLibrary(void)
 		LOAD_DLLPTR(LP_GetAlcMode);
 		LOAD_DLLPTR(LP_SetVsgTriggerType);
 		LOAD_DLLPTR(LP_GetHndlDataPointers);
+		LOAD_DLLPTR(LP_MptaAvailable);
+		LOAD_DLLPTR(LP_MptaEnable);
+		LOAD_DLLPTR(LP_MptaDisable);
+		LOAD_DLLPTR(LP_MptaSetupCapture);
 		LOAD_DLLPTR(LP_SaveUserDataToSigFile);
 		LOAD_DLLPTR(LP_GetCapture);
 		LOAD_DLLPTR(LP_EnableMultiThread);
@@ -1115,6 +1133,9 @@ IQMEASURE_API int	LP_Term(void)
 		return 1;
 	}
 	//  printf("--> LP_Term()\n");
+	LP_CaptureArchiveStop();
+	LP_GPS_SessionInvalidate();
+	LP_ProfileInvalidate();
 	returnVal = (*LP_Term_Ptr)();
 	FreeLibrary(DynamiclibraryHandle);
 	DynamiclibraryHandle = NULL;
@@ -1144,6 +1165,8 @@ IQMEASURE_API int	LP_InitTester(char *ipAddress)
 	if (loadDynamicLibrary())
 		return 1;
 	// printf("--> LP_InitTester()\n");
+	LP_GPS_SessionInvalidate();
+	LP_ProfileInvalidate();
 	return (*LP_InitTester_Ptr)(ipAddress);
 }
 
@@ -1152,6 +1175,8 @@ IQMEASURE_API int	LP_InitTester2(char *ipAddress1, char *ipAddress2)
 	if (loadDynamicLibrary())
 		return 1;
 	// printf("--> LP_InitTester2()\n");
+	LP_GPS_SessionInvalidate();
+	LP_ProfileInvalidate();
 	return (*LP_InitTester2_Ptr)(ipAddress1,ipAddress2);
 }
 
@@ -1160,6 +1185,8 @@ IQMEASURE_API int	LP_InitTester3(char *ipAddress1, char *ipAddress2, char *ipAdd
 	if (loadDynamicLibrary())
 		return 1;
 	//  printf("--> LP_InitTester3()\n");
+	LP_GPS_SessionInvalidate();
+	LP_ProfileInvalidate();
 	return (*LP_InitTester3_Ptr)(ipAddress1,ipAddress2,ipAddress3);
 }
 
@@ -1168,6 +1195,8 @@ IQMEASURE_API int	LP_InitTester4(char *ipAddress1, char *ipAddress2, char *ipAdd
 	if (loadDynamicLibrary())
 		return 1;
 	// printf("--> LP_InitTester4()\n");
+	LP_GPS_SessionInvalidate();
+	LP_ProfileInvalidate();
 	return (*LP_InitTester4_Ptr)(ipAddress1,ipAddress2,ipAddress3,ipAddress4);
 }
 
@@ -1192,6 +1221,8 @@ IQMEASURE_API int LP_SetDefault(void)
 	if (loadDynamicLibrary())
 		return 1;
 	//  printf("--> LP_SetDefault()\n");
+	LP_GPS_SessionInvalidate();
+	LP_ProfileInvalidate();
 	return (*LP_SetDefault_Ptr)();
 }
 
@@ -1200,6 +1231,7 @@ IQMEASURE_API int LP_ScpiCommandSet(char *scpiCommand)
 	if (loadDynamicLibrary())
 		return 1;
 	//  printf("--> LP_SetDefault()\n");
+	ProfileForget(NULL);
 	return (*LP_ScpiCommandSet_Ptr)(scpiCommand);
 }
 
@@ -1286,6 +1318,7 @@ IQMEASURE_API int	LP_SetVsg(double rfFreqHz, double rfPowerLeveldBm, int port, b
 	if (loadDynamicLibrary())
 		return 1;
 	//  printf("--> LP_SetVsg()\n");
+	ProfileForget("VSG");
 	return (*LP_SetVsg_Ptr)(rfFreqHz, rfPowerLeveldBm, port, setGapPowerOff, dFreqShiftHz);
 }
 
@@ -1314,6 +1347,7 @@ IQMEASURE_API int	LP_SetVsg_GapPower(double rfFreqHz, double rfPowerLeveldBm, in
 	if (loadDynamicLibrary())
 		return 1;
 	//   printf("--> LP_SetVsg_GapPower()\n");
+	ProfileForget("VSG");
 	return (*LP_SetVsg_GapPower_Ptr)(rfFreqHz,rfPowerLeveldBm,port,gapPowerOff);
 }
 
@@ -1322,6 +1356,7 @@ IQMEASURE_API int	LP_SetVsgNxN(double rfFreqHz, double rfPowerLeveldBm[], int po
 	if (loadDynamicLibrary())
 		return 1;
 	//  printf("--> LP_SetVsgNxN()\n");
+	ProfileForget("VSG");
 	return (*LP_SetVsgNxN_Ptr)(rfFreqHz,rfPowerLeveldBm,port, dFreqShiftHz);
 }
 
@@ -1330,6 +1365,7 @@ IQMEASURE_API int	LP_SetVsgCw(double sineFreqHz, double offsetFrequencyMHz, doub
 	if (loadDynamicLibrary())
 		return 1;
 	//  printf("--> LP_SetVsgCw()\n");
+	ProfileForget("VSG");
 	return (*LP_SetVsgCw_Ptr)(sineFreqHz,offsetFrequencyMHz,rfPowerLeveldBm,port);
 }
 
@@ -1419,6 +1455,7 @@ IQMEASURE_API int	LP_SetVsaBluetooth(double rfFreqHz, double rfAmplDb, int port,
 	if (loadDynamicLibrary())
 		return 1;
 	//  printf("--> LP_SetVsaBluetooth()\n");
+	ProfileForget("VSA");
 	return (*LP_SetVsaBluetooth_Ptr)(rfFreqHz,rfAmplDb,port,triggerLevelDb,triggerPreTime);
 }
 
@@ -1427,6 +1464,7 @@ IQMEASURE_API int	LP_SetVsa(double rfFreqHz, double rfAmplDb, int port, double e
 	if (loadDynamicLibrary())
 		return 1;
 	//  printf("--> LP_SetVsa()\n");
+	ProfileForget("VSA");
 	return (*LP_SetVsa_Ptr)(rfFreqHz,rfAmplDb,port,extAttenDb,triggerLevelDb,triggerPreTime, dFreqShiftHz);
 }
 
@@ -1435,6 +1473,7 @@ IQMEASURE_API int	LP_SetVsaTriggerTimeout(double triggerTimeoutSec)
 	if (loadDynamicLibrary())
 		return 1;
 	//  printf("--> LP_SetVsaTriggerTimeout()\n");
+	ProfileForget("VSA_TRIGGER_TIMEOUT");
 	return (*LP_SetVsaTriggerTimeout_Ptr)(triggerTimeoutSec);
 }
 
@@ -1443,6 +1482,7 @@ IQMEASURE_API int	LP_SetVsaNxN(double rfFreqHz, double rfAmplDb[], int port[], d
 	if (loadDynamicLibrary())
 		return 1;
 	//   printf("--> LP_SetVsaNxN()\n");
+	ProfileForget("VSA");
 	return (*LP_SetVsaNxN_Ptr)(rfFreqHz,rfAmplDb,port,extAttenDb,triggerLevelDb,triggerPreTime, dFreqShiftHz);
 }
 
@@ -1451,6 +1491,7 @@ IQMEASURE_API int	LP_SetVsaAmplitudeTolerance(double amplitudeToleranceDb)
 	if (loadDynamicLibrary())
 		return 1;
 	//    printf("--> LP_SetVsaAmplitudeTolerance()\n");
+	ProfileForget("VSA_AMPLITUDE_TOLERANCE");
 	return (*LP_SetVsaAmplitudeTolerance_Ptr)(amplitudeToleranceDb);
 }
 
@@ -1459,6 +1500,7 @@ IQMEASURE_API int	LP_Agc(double *rfAmplDb,bool allTesters)
 	if (loadDynamicLibrary())
 		return 1;
 	//  printf("--> LP_Agc()\n");
+	ProfileForget("VSA");
 	return (*LP_Agc_Ptr)(rfAmplDb,allTesters);
 }
 
@@ -1483,6 +1525,7 @@ IQMEASURE_API int	LP_EnableVsgRF(int enabled)
 	if (loadDynamicLibrary())
 		return 1;
 	//   printf("--> LP_EnableVsgRF()\n");
+	ProfileForget("VSG_RF");
 	return (*LP_EnableVsgRF_Ptr)(enabled);
 }
 
@@ -1491,6 +1534,7 @@ IQMEASURE_API int	LP_EnableVsgRFNxN(int vsg1Enabled, int vsg2Enabled, int vsg3En
 	if (loadDynamicLibrary())
 		return 1;
 	//  printf("--> LP_EnableVsgRFNxN()\n");
+	ProfileForget("VSG_RF");
 	return (*LP_EnableVsgRFNxN_Ptr)(vsg1Enabled,vsg2Enabled,vsg3Enabled,vsg4Enabled);
 }
 
@@ -1499,6 +1543,7 @@ IQMEASURE_API int	LP_EnableSpecifiedVsgRF(int enabled, int vsgNumber)
 	if (loadDynamicLibrary())
 		return 1;
 	//  printf("--> LP_EnableSpecifiedVsgRF()\n");
+	ProfileForget("VSG_RF");
 	return (*LP_EnableSpecifiedVsgRF_Ptr)(enabled,vsgNumber);
 }
 
@@ -1540,9 +1585,50 @@ IQMEASURE_API int	LP_GetHndlDataPointers(double *real[],double *imag[],int *leng
 	if (loadDynamicLibrary())
 		return 1;
 	//  printf("--> LP_GetHndlDataPointers()\n");
+	if (NULL==LP_GetHndlDataPointers_Ptr)
+		return ERR_NO_CAPTURE_DATA;		// not exported by SCPI testers
 	return (*LP_GetHndlDataPointers_Ptr)(real,imag,length,sampleFreqHz,arraySize);
 }
 
+IQMEASURE_API bool	LP_MptaAvailable()
+{
+	if (loadDynamicLibrary())
+		return false;
+	if (NULL==LP_MptaAvailable_Ptr)
+		return false;					// not exported by SCPI testers
+	return (*LP_MptaAvailable_Ptr)();
+}
+
+IQMEASURE_API int	LP_MptaEnable()
+{
+	if (loadDynamicLibrary())
+		return 1;
+	if (NULL==LP_MptaEnable_Ptr)
+		return ERR_MPTA_NOT_ENABLE;		// not exported by SCPI testers
+	return (*LP_MptaEnable_Ptr)();
+}
+
+IQMEASURE_API int	LP_MptaDisable()
+{
+	if (loadDynamicLibrary())
+		return 1;
+	if (NULL==LP_MptaDisable_Ptr)
+		return ERR_MPTA_NOT_DISENABLE;	// not exported by SCPI testers
+	return (*LP_MptaDisable_Ptr)();
+}
+
+IQMEASURE_API int	LP_MptaSetupCapture(TX_PATH_ENUM tx_path, double rfFreqHz, double peakSignaldB, double CaptureTimeUs)
+{
+	if (loadDynamicLibrary())
+		return 1;
+	if (NULL==LP_MptaSetupCapture_Ptr)
+		return ERR_MPTA_CAPTURE_FAILED;	// not exported by SCPI testers
+	// The MPTA capture retunes both the VSA and the VSG
+	ProfileForget("VSA");
+	ProfileForget("VSG");
+	return (*LP_MptaSetupCapture_Ptr)(tx_path,rfFreqHz,peakSignaldB,CaptureTimeUs);
+}
+
 IQMEASURE_API int	LP_SaveUserDataToSigFile(char* sigFileName,
 		double *real[],
 		double *imag[],
@@ -1553,6 +1639,8 @@ IQMEASURE_API int	LP_SaveUserDataToSigFile(char* sigFileName,
 	if (loadDynamicLibrary())
 		return 1;
 	//   printf("--> LP_SaveUserDataToSigFile()\n");
+	if (NULL==LP_SaveUserDataToSigFile_Ptr)
+		return ERR_SAVE_WAVE_FAILED;	// not exported by SCPI testers
 	return (*LP_SaveUserDataToSigFile_Ptr)(sigFileName,real,imag,length,sampleFreqHz,arraySize);
 }
 
@@ -1564,6 +1652,38 @@ IQMEASURE_API int	LP_SelectCaptureRangeForAnalysis(double startPositionUs, doubl
 	return (*LP_SelectCaptureRangeForAnalysis_Ptr)(startPositionUs,lengthUs, packetsOffset, packetsLength);
 }
 
+IQMEASURE_API int	LP_GetCapturePacketRanges(double captureLengthUs, double startUs[], double lengthUs[], int bufferLength)
+{
+	if (loadDynamicLibrary())
+		return 0;
+	//  printf("--> LP_GetCapturePacketRanges()\n");
+	if (ERR_OK!=(*LP_AnalyzePower_Ptr)(0.0, 0.0))
+		return 0;
+
+	// A packet lasts 1 us at least, so the capture length bounds the power profile
+	int packetNum = 0;
+	int maxIndex  = (0.0<captureLengthUs) ? (int)captureLengthUs+1 : 0;
+	double lastStopSec = -1.0;
+	for (int i=0;packetNum<bufferLength && i<maxIndex;i++)
+	{
+		double startSec = (*LP_GetScalarMeasurement_Ptr)("start_sec", i);
+		double stopSec  = (*LP_GetScalarMeasurement_Ptr)("stop_sec", i);
+		if (NA_NUMBER==startSec || NA_NUMBER==stopSec)
+			break;
+		// No packet, or the profile does not advance (the SCPI testers return 0.0 when out of packets)
+		if (stopSec<=startSec || startSec<lastStopSec)
+			break;
+		// The last packet is cut by the end of the capture
+		if (stopSec*1e6>=captureLengthUs*0.999)
+			break;
+		startUs[packetNum]  = startSec*1e6;
+		lengthUs[packetNum] = (stopSec-startSec)*1e6;
+		lastStopSec = stopSec;
+		packetNum++;
+	}
+	return packetNum;
+}
+
 IQMEASURE_API int	LP_Analyze80216d( double sigType	,
 		double bandwidthHz	,
 		double cyclicPrefix	,
@@ -1791,6 +1911,28 @@ IQMEASURE_API double	LP_GetScalarMeasurement(char *measurement, int index)
 	return (*LP_GetScalarMeasurement_Ptr)(measurement,index);
 }
 
+IQMEASURE_API int	LP_GetScalarMeasurementArray(char *measurement, double values[], int bufferLength)
+{
+	// printf("--> LP_GetScalarMeasurementArray()\n");
+	if ( 0==loadDynamicLibrary() && NULL!=LP_GetScalarMeasurementArray_Ptr )
+	{
+		return (*LP_GetScalarMeasurementArray_Ptr)(measurement,values,bufferLength);
+	}
+	else
+	{
+		// IQmeasure_xx.dll built before LP_GetScalarMeasurementArray(), fetch one index at a time;
+		// without IQmeasure_xx.dll, every index is without result
+		int validCount = 0;
+		for (int i=0;i<bufferLength;i++)
+		{
+			values[i] = (NULL!=LP_GetScalarMeasurement_Ptr) ? (*LP_GetScalarMeasurement_Ptr)(measurement,i) : NA_NUMBER;
+			if (NA_NUMBER!=values[i])
+				validCount++;
+		}
+		return validCount;
+	}
+}
+
 IQMEASURE_API int	LP_GetVectorMeasurement(char *measurement, double bufferReal[], double bufferImag[], int bufferLength)
 {
 	if (loadDynamicLibrary())
@@ -2147,6 +2289,7 @@ IQMEASURE_API int	LP_GPS_SetActivate()
 	if (loadDynamicLibrary())
 		return 1;
 	// printf("--> LP_GPS_SetActivate()\n");
+	LP_GPS_SessionInvalidate();
 	return (*LP_GPS_SetActivate_Ptr)();
 }
 
@@ -2188,6 +2331,7 @@ IQMEASURE_API int	LP_GPS_SetDeactivate()
 	if (loadDynamicLibrary())
 		return 1;
 	// printf("--> LP_GPS_SetDeactivate()\n");
+	LP_GPS_SessionInvalidate();
 	return (*LP_GPS_SetDeactivate_Ptr)();
 }
 
@@ -2272,6 +2416,7 @@ IQMEASURE_API int LP_Glonass_SetActivate()
 {
 	if (loadDynamicLibrary())
 		return 1;
+	LP_GPS_SessionInvalidate();
 	return (*LP_Glonass_SetActivate_Ptr)();
 }
 
@@ -2279,6 +2424,7 @@ IQMEASURE_API int LP_Glonass_SetDeactivate()
 {
 	if (loadDynamicLibrary())
 		return 1;
+	LP_GPS_SessionInvalidate();
 	return (*LP_Glonass_SetDeactivate_Ptr)();
 }
 
@@ -2308,6 +2454,7 @@ IQMEASURE_API int	LP_FM_SetVsg(unsigned int carrierFreqHz,
 	if (loadDynamicLibrary())
 		return 1;
 	//  printf("--> LP_FM_SetVsg()\n");
+	ProfileForget("VSG");
 	return (*LP_FM_SetVsg_Ptr)(carrierFreqHz,carrierPowerdBm,modulationEnable,totalFmDeviationHz,stereoEnable,
 			pilotDeviationHz,rdsEnable,rdsDeviationHz,preEmphasisUs,rdsTransmitString);
 }
@@ -2460,6 +2607,7 @@ IQMEASURE_API int	LP_FM_SetVsa(unsigned int carrierFreqHz,
 	if (loadDynamicLibrary())
 		return 1;
 	//   printf("--> LP_FM_SetVsa()\n");
+	ProfileForget("VSA");
 	return (*LP_FM_SetVsa_Ptr)(carrierFreqHz,expectedPeakInputPowerdBm);
 }
 
@@ -2629,6 +2777,11 @@ IQMEASURE_API int	LP_EnableMultiThread(int enableMultiThread,
 	if (loadDynamicLibrary())
 		return 1;
 	//   printf("--> ()\n");
+	if (NULL==LP_EnableMultiThread_Ptr)
+	{
+		// Only IQmeasure_IQapi_Legacy.dll exports LP_EnableMultiThread()
+		return ERR_SET_MULTI_THREAD_FAILED;
+	}
 	return (*LP_EnableMultiThread_Ptr)(enableMultiThread,numberOfThreads);
 }
 
@@ -2645,6 +2798,7 @@ IQMEASURE_API int	LP_SetDefaultNfc()
 	if (loadDynamicLibrary())
 		return 1;
 	// printf("--> LP_SetDefaultNfc()\n");
+	ProfileForget(NULL);
 	return (*LP_SetDefaultNfc_Ptr)();
 }
 
@@ -2726,6 +2880,7 @@ IQMEASURE_API int	LP_SetVsaBluetooth_BTShiftHz(double rfFreqHz, double rfAmplDb,
 	if (loadDynamicLibrary())
 		return 1;
 	//    printf("--> LP_SetVsaBluetooth_BTShiftHz()\n");
+	ProfileForget("VSA");
 	return (*LP_SetVsaBluetooth_BTShiftHz_Ptr)(rfFreqHz,rfAmplDb,port,extAttenDb,
 			triggerLevelDb,triggerPreTime6,btShiftHz);
 }
@@ -2735,6 +2890,7 @@ IQMEASURE_API int	LP_FM_SetVsa_Agc_On(unsigned int carrierFreqHz, double expecte
 	if (loadDynamicLibrary())
 		return 1;
 	//  printf("--> LP_FM_SetVsa_Agc_On()\n");
+	ProfileForget("VSA");
 	return (*LP_FM_SetVsa_Agc_On_Ptr)(carrierFreqHz,expectedPeakInputPowerdBm);
 }
 
@@ -2744,6 +2900,7 @@ IQMEASURE_API int	LP_SetVsg_triggerType(double rfFreqHz, double rfPowerLeveldBm,
 	if (loadDynamicLibrary())
 		return 1;
 	//   printf("--> LP_SetVsg_triggerType()\n");
+	ProfileForget("VSG");
 	return (*LP_SetVsg_triggerType_Ptr)(rfFreqHz,rfPowerLeveldBm,port,triggerType);
 }
 
@@ -2822,6 +2979,7 @@ IQMEASURE_API int		LP_FM_SetFrequency(unsigned int carrierFreqHz, double carrier
 	if (loadDynamicLibrary())
 		return 1;
 	//  printf("--> LP_FM_SetFrequency()\n");
+	ProfileForget("VSG");
 	return (*LP_FM_SetFrequency_Ptr)(carrierFreqHz,carrierPowerdBm);
 }
 
@@ -2831,6 +2989,7 @@ IQMEASURE_API int		LP_FM_SetCarrierPower(double carrierPowerdBm)
 	if (loadDynamicLibrary())
 		return 1;
 	//  printf("--> LP_FM_SetCarrierPower()\n");
+	ProfileForget("VSG");
 	return (*LP_FM_SetCarrierPower_Ptr)(carrierPowerdBm);
 }
 
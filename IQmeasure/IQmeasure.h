@@ -702,6 +702,166 @@ IQMEASURE_API int		LP_CopyVsaCaptureData(int fromVsaNum, int toVsaNum);
  */
 IQMEASURE_API int		LP_SaveVsaSignalFile(char *sigFileName);
 
+//! Starts the capture archive, a background writer that saves VSA captures without stalling the test
+/*!
+ * \param[in] archivePath Directory of the archive files and of capture_index.csv; created if it does not exist
+ * \param[in] quotaMB Disk quota of the archive in MB, the oldest files are deleted above it; 0 means no quota
+ *
+ * \return ERR_OK if successful; otherwise an error code.
+ * \remark Calling it again while running only changes the quota.  Files listed in capture_index.csv by previous runs count against the quota.
+ */
+IQMEASURE_API int		LP_CaptureArchiveStart(char *archivePath, int quotaMB);
+
+//! Archives the current VSA capture
+/*!
+ * \param[in] fileName File name prefix, a time stamp is appended
+ * \param[in] dutSerial DUT serial number for capture_index.csv; may be NULL
+ * \param[in] testItem Test item for capture_index.csv; NULL uses fileName
+ *
+ * \return ERR_OK if the capture was queued or saved; otherwise an error code.
+ * \remark With IQapi testers only a host copy of the capture is made here; it is written as a compressed .iqz file by the archive thread.
+ *         Captures kept in the tester (SCPI) are saved in place with LP_SaveVsaSignalFile().
+ *         If the writer falls behind, the capture is dropped and ERR_SAVE_WAVE_FAILED is returned.
+ */
+IQMEASURE_API int		LP_CaptureArchiveSave(char *fileName, char *dutSerial, char *testItem);
+
+//! Waits until all queued captures are written
+/*!
+ * \param[in] timeoutMs Maximum wait in ms; negative waits forever
+ *
+ * \return ERR_OK if the queue is empty; otherwise ERR_GENERAL_ERR.
+ */
+IQMEASURE_API int		LP_CaptureArchiveFlush(int timeoutMs);
+
+//! Writes the queued captures and stops the capture archive
+/*!
+ * \return ERR_OK if successful; otherwise an error code.
+ * \remark Called by LP_Term().
+ */
+IQMEASURE_API int		LP_CaptureArchiveStop(void);
+
+//! Converts a capture archive file (.iqz) back to a signal file (.sig)
+/*!
+ * \param[in] archiveFile The .iqz file
+ * \param[in] sigFileName Specifies the .sig file name
+ *
+ * \return ERR_OK if successful; otherwise an error code.
+ * \remark Needs an IQapi tester connection for LP_SaveUserDataToSigFile().
+ */
+IQMEASURE_API int		LP_CaptureArchiveRestore(char *archiveFile, char *sigFileName);
+
+//! Predicts the average power at the VSA port from the previous captures of the same signal
+/*!
+ * \param[in] freqMHz Center frequency in MHz
+ * \param[in] signalKey Identifies the signal at that frequency, e.g. data rate, bandwidth and antennas
+ * \param[in] expectedPowerDbm Power at the VSA port expected from the test parameters
+ *
+ * \return The learned power plus a small margin, or expectedPowerDbm if the signal was not learned yet.
+ * \remark The caller adds its peak-to-average ratio and passes the result to LP_SetVsa().
+ */
+IQMEASURE_API double	LP_RefLevelPredict(double freqMHz, char *signalKey, double expectedPowerDbm);
+
+//! Learns the power of a completed capture for LP_RefLevelPredict()
+/*!
+ * \param[in] freqMHz Center frequency in MHz
+ * \param[in] signalKey Same key as for LP_RefLevelPredict()
+ * \param[in] avgPowerDbm Measured average power at the VSA port (without path loss)
+ * \param[in] peakPowerDbm Measured peak power at the VSA port; NA_NUMBER (or <= -99) skips the clipping check
+ * \param[in] vsaAmplitudeDbm The amplitude the capture was taken with; NA_NUMBER skips the clipping check
+ *
+ * \return ERR_OK if learned; ERR_CAPTURE_FAILED if the capture clipped, the signal is then forgotten.
+ */
+IQMEASURE_API int		LP_RefLevelLearn(double freqMHz, char *signalKey, double avgPowerDbm, double peakPowerDbm, double vsaAmplitudeDbm);
+
+//! Forgets a learned signal, e.g. after a trigger timeout
+/*!
+ * \param[in] freqMHz Center frequency in MHz
+ * \param[in] signalKey Same key as for LP_RefLevelPredict(); NULL forgets all signals
+ *
+ * \return ERR_OK
+ */
+IQMEASURE_API int		LP_RefLevelForget(double freqMHz, char *signalKey);
+
+//! Settings of an RF configuration profile, see LP_DefineProfile()
+#define IQ_PROFILE_MAX_ANALYSIS		8
+#define IQ_PROFILE_NAME_SIZE		64
+
+enum IQ_PROFILE_ENABLE
+{
+	IQ_PROFILE_VSA_AMPLITUDE_TOLERANCE	= 0x01,		//!< LP_SetVsaAmplitudeTolerance(vsaAmplitudeToleranceDb)
+	IQ_PROFILE_VSA_TRIGGER_TIMEOUT		= 0x02,		//!< LP_SetVsaTriggerTimeout(vsaTriggerTimeoutSec)
+	IQ_PROFILE_VSA						= 0x04,		//!< LP_SetVsa(vsaFreqHz, ...)
+	IQ_PROFILE_VSG						= 0x08,		//!< LP_SetVsg(vsgFreqHz, ...)
+	IQ_PROFILE_VSG_RF					= 0x10		//!< LP_EnableVsgRF(vsgRfEnabled)
+};
+
+typedef struct tagIqProfileAnalysisParam
+{
+	char	measurement[IQ_PROFILE_NAME_SIZE];
+	char	parameter[IQ_PROFILE_NAME_SIZE];
+	int		value;
+} IQ_PROFILE_ANALYSIS_PARAM;
+
+typedef struct tagIqRfProfile
+{
+	int		enableMask;					//!< IQ_PROFILE_ENABLE bits, settings without a bit are left alone
+	double	vsaAmplitudeToleranceDb;
+	double	vsaTriggerTimeoutSec;
+	double	vsaFreqHz;
+	double	vsaAmplDb;
+	int		vsaPort;
+	double	vsaExtAttenDb;
+	double	vsaTriggerLevelDb;
+	double	vsaTriggerPreTimeSec;
+	double	vsaFreqShiftHz;
+	double	vsgFreqHz;
+	double	vsgPowerDbm;
+	int		vsgPort;
+	int		vsgGapPowerOff;
+	double	vsgFreqShiftHz;
+	int		vsgRfEnabled;
+	int		analysisCount;				//!< LP_SetAnalysisParameterInteger() calls, up to IQ_PROFILE_MAX_ANALYSIS
+	IQ_PROFILE_ANALYSIS_PARAM analysis[IQ_PROFILE_MAX_ANALYSIS];
+} IQ_RF_PROFILE;
+
+//! Defines a named RF configuration profile (VSA, VSG and analysis settings)
+/*!
+ * \param[in] profileName Name of the profile; defining the same name again replaces its settings
+ * \param[in] profile The settings, copied
+ * \param[out] profileId Id for LP_ApplyProfile(), the same for the same name
+ *
+ * \return ERR_OK if successful; otherwise an error code.
+ */
+IQMEASURE_API int		LP_DefineProfile(char *profileName, IQ_RF_PROFILE *profile, int *profileId);
+
+//! Configures the tester with a profile in one call
+/*!
+ * \param[in] profileId Id from LP_DefineProfile()
+ *
+ * \return ERR_OK if successful; otherwise the error of the first LP_ function that failed.
+ * \remark Only settings that differ from what the last LP_ApplyProfile() sent are sent again; the analysis
+ *         parameters are always sent, as the LP_Analyze*() functions overwrite them.
+ *         LP_SetVsa(), LP_SetVsg(), LP_EnableVsgRF(), LP_FM_SetFrequency(), LP_Agc() etc. called directly make
+ *         the profile send that setting again; LP_ScpiCommandSet(), LP_SetDefault(), LP_SetDefaultNfc(),
+ *         LP_InitTester*() and LP_Term() make it send everything again.
+ */
+IQMEASURE_API int		LP_ApplyProfile(int profileId);
+
+//! Forgets what the profiles sent, the next LP_ApplyProfile() sends all of its settings
+/*!
+ * \remark Call this if the tester was configured without IQmeasure, e.g. by another application.
+ */
+IQMEASURE_API int		LP_ProfileInvalidate(void);
+
+//! Gets the number of settings LP_ApplyProfile() sent and skipped since the DLL was loaded
+/*!
+ * \param[out] stepsSent Settings sent to the tester; NULL if not needed
+ * \param[out] stepsSkipped Settings skipped because the tester already had them; NULL if not needed
+ *
+ * \return ERR_OK
+ */
+IQMEASURE_API int		LP_ProfileGetInfo(int *stepsSent, int *stepsSkipped);
+
 //! Loads the signal file (.sig) for analysis
 /*!
  * \param[in] sigFileName The path for the signal (.sig) file to be loaded
@@ -914,6 +1074,69 @@ IQMEASURE_API int		LP_SaveUserDataToSigFile(char* sigFileName,
  */
 IQMEASURE_API int		LP_SelectCaptureRangeForAnalysis(double startPositionUs, double lengthUs,
 														 int packetsOffset = 0, int packetsLength = 0);
+
+//! Find the complete packets of the capture, for analyzing them one by one with LP_SelectCaptureRangeForAnalysis()
+/*!
+ * Runs LP_AnalyzePower() on the whole capture, so it must be called before any LP_SelectCaptureRangeForAnalysis()
+ * of this capture.  A packet that still runs at the end of the capture is not complete and is not returned.
+ *
+ * \param[in] captureLengthUs The length (us) of the capture
+ * \param[out] startUs Start position (us) of each packet
+ * \param[out] lengthUs Length (us) of each packet
+ * \param[in] bufferLength Indicates the number of elements in startUs and lengthUs
+ *
+ * \return The number of complete packets found, 0 if none or if the power analysis failed
+ */
+IQMEASURE_API int		LP_GetCapturePacketRanges(double captureLengthUs, double startUs[], double lengthUs[], int bufferLength);
+
+// Sample formats of the compact capture functions
+#define IQ_FORMAT_FLOAT32		1		/*!< Interleaved I,Q float, 8 bytes per complex sample */
+#define IQ_FORMAT_INT16			2		/*!< Interleaved I,Q 16-bit integer, 32767 = scale, 4 bytes per complex sample */
+
+//! Retrieves the captured I/Q data of a VSA as interleaved float or 16-bit samples
+/*!
+ * Converts from the capture in the IQapi handle, no double copy of the capture is made.
+ *
+ * \param[in] vsaNum Number of VSA (0-3)
+ * \param[in] iqFormat IQ_FORMAT_FLOAT32 or IQ_FORMAT_INT16
+ * \param[out] bufferIQ Returns the I,Q samples, 2*bufferSamples float or short
+ * \param[in] bufferSamples Indicates the number of complex samples bufferIQ can hold
+ * \param[out] sampleCount Returns the number of complex samples, also when bufferIQ is too small
+ * \param[out] scale Returns the value of full scale (IQ_FORMAT_INT16), 1.0 for IQ_FORMAT_FLOAT32
+ *
+ * \return ERR_OK if no errors; ERR_BUFFER_OVERFLOW if bufferIQ is too small; ERR_NO_CAPTURE_DATA if not supported by the tester
+ */
+IQMEASURE_API int		LP_GetSampleDataCompact(int vsaNum, int iqFormat, void *bufferIQ, int bufferSamples, int *sampleCount, double *scale);
+
+//! Converts compact samples of LP_GetSampleDataCompact() to double I and Q arrays
+/*!
+ * \param[in] iqFormat IQ_FORMAT_FLOAT32 or IQ_FORMAT_INT16
+ * \param[in] bufferIQ The I,Q samples
+ * \param[in] sampleCount The number of complex samples to convert
+ * \param[in] scale The scale returned with the samples
+ * \param[out] bufferReal[] Returns I samples
+ * \param[out] bufferImag[] Returns Q samples
+ *
+ * \return ERR_OK if no errors; otherwise call LP_GetErrorString() for detailed error message.
+ */
+IQMEASURE_API int		LP_CompactToDouble(int iqFormat, void *bufferIQ, int sampleCount, double scale, double bufferReal[], double bufferImag[]);
+
+//! Saves the capture of all VSAs to a compact capture file (.iqc)
+/*!
+ * \param[in] fileName The file name
+ * \param[in] iqFormat IQ_FORMAT_FLOAT32 or IQ_FORMAT_INT16; a quarter (IQ_FORMAT_INT16) of the size of a .sig file
+ *
+ * \return ERR_OK if no errors; otherwise call LP_GetErrorString() for detailed error message.
+ */
+IQMEASURE_API int		LP_SaveCaptureCompact(char *fileName, int iqFormat);
+
+//! Loads a compact capture file of LP_SaveCaptureCompact() for analysis, like LP_LoadVsaSignalFile()
+/*!
+ * \param[in] fileName The file name
+ *
+ * \return ERR_OK if no errors; otherwise call LP_GetErrorString() for detailed error message.
+ */
+IQMEASURE_API int		LP_LoadCaptureCompact(char *fileName);
 //! Send a SCPI command to IQxel tester
 /*!
  * \param[in] The string of SCPI command
@@ -1302,6 +1525,19 @@ IQMEASURE_API int		LP_GetStringMeasurment(char *measurement, char bufferChar[],
  */
 IQMEASURE_API double	LP_GetScalarMeasurement(char *measurement, int index=0);
 
+//! Get all indexes of a scalar measurement result in one call
+/*!
+ * Same as calling LP_GetScalarMeasurement(measurement, i) for i = 0 ~ bufferLength-1, e.g. the per-stream
+ * "evmAvgAll" or the NStream x NVsa "rxRmsPowerDb" of a MIMO analysis, with one timer/log entry instead of one per index.
+ *
+ * \param[in] measurement The measurement name.  Please refer to \ref group_scalar_measurement "Scalar Measurements" for all available measurement names
+ * \param[out] values Returns the value of index 0 ~ bufferLength-1; -99999.99 (NA_NUMBER) for an index without result
+ * \param[in] bufferLength Indicates the number of elements in values
+ *
+ * \return The number of elements in values that have a valid result; 0, with all values NA_NUMBER, if IQmeasure cannot be loaded
+ */
+IQMEASURE_API int		LP_GetScalarMeasurementArray(char *measurement, double values[], int bufferLength);
+
 //! Get a vector measurement result
 /*!
  * \param[in] measurement The measurement name.  Please refer to \ref group_vector_measurement "Vector Measurements" for all available measurement names
@@ -2210,6 +2446,84 @@ IQMEASURE_API int LP_Glonass_SetRfOutput(IQV_GPS_RF_OUTPUT rfOutput);
 IQMEASURE_API int LP_Glonass_SetActivate(void);
 IQMEASURE_API int LP_Glonass_SetDeactivate();
 
+/*--------------------------*
+*	GPS Session Functions	*
+*---------------------------*/
+/*! @defgroup gps_session Session
+ *  The session functions keep the GPS/Glonass generator activated and the scenario
+ *  resident across consecutive test items.  Only settings that differ from the
+ *  previous item are pushed to the tester:
+ * 1. Same mode, same scenario/trigger/doppler : power and satellite changes go through LP_GPS_SetChannelInfo
+ * 2. Different mode or scenario               : the signal is set up again, without re-activating the tester
+ * 3. LP_GPS_SessionClose                      : deactivates the tester
+ *
+ *  The session is dropped automatically by LP_Term(), LP_SetDefault(), LP_InitTester*(),
+ *  LP_GPS_SetActivate() and LP_GPS_SetDeactivate(), because all of them reset the generator.
+ */
+enum LP_GPS_SESSION_MODE
+{
+   GPS_SESSION_NONE,			//!< No signal is resident
+   GPS_SESSION_SCENARIO,		//!< A scenario file is loaded and playing
+   GPS_SESSION_MODULATED,		//!< Modulated mode signal
+   GPS_SESSION_CW,				//!< Continuous wave signal
+   GPS_SESSION_GLONASS			//!< Glonass signal
+};
+
+//! Play a scenario file, re-using the loaded scenario if it is already resident.
+/*!
+ * \param[in] fileName     : Path of the scenario file.
+ * \param[in] triggerState : Trigger State.
+ * \param[in] powerDbm     : Power at the DUT.
+ * \param[in] pathlossDb   : Cable loss.
+ *
+ * \return ERR_OK if no errors; otherwise call LP_GetErrorString() for detailed error message.
+ */
+IQMEASURE_API int		LP_GPS_SessionScenario(char* fileName, IQV_GPS_TRIGGER_STATE triggerState, double powerDbm, double pathlossDb);
+
+//! Transmit a modulated mode signal, only updating the channels that changed since the last call.
+/*!
+ * Parameters are the same as LP_GPS_ModulatedMode().
+ *
+ * \return ERR_OK if no errors; otherwise call LP_GetErrorString() for detailed error message.
+ */
+IQMEASURE_API int		LP_GPS_SessionModulated(int Nav_Mode, double pathlossDb, double powerA[6], int satelliteNumA[6], int dopplerFrequency, IQV_GPS_TRIGGER_STATE triggerState);
+
+//! Transmit a continuous wave signal, only updating the power if nothing else changed.
+/*!
+ * Parameters are the same as LP_GPS_ContinueWave().
+ *
+ * \return ERR_OK if no errors; otherwise call LP_GetErrorString() for detailed error message.
+ */
+IQMEASURE_API int		LP_GPS_SessionContinueWave(double powerDbm, double pathlossDb, IQV_GPS_TRIGGER_STATE triggerState, int freqOffset);
+
+//! Transmit a Glonass signal, only updating the fields that changed since the last call.
+/*!
+ * \param[in] operationMode    : Glonass operation mode.
+ * \param[in] powerDbm         : Tester power.
+ * \param[in] frequencyChannel : Glonass frequency channel.
+ *
+ * \return ERR_OK if no errors; otherwise call LP_GetErrorString() for detailed error message.
+ */
+IQMEASURE_API int		LP_Glonass_SessionSetup(IQV_GPS_OPERATION_MODE operationMode, double powerDbm, int frequencyChannel);
+
+//! Deactivate the tester if a session is open.
+IQMEASURE_API int		LP_GPS_SessionClose(void);
+
+//! Forget the session state without touching the tester.
+/*!
+ * \remark Call this if the GPS generator was reconfigured outside the session functions.
+ */
+IQMEASURE_API int		LP_GPS_SessionInvalidate(void);
+
+//! Get the mode of the resident signal.
+/*!
+ * \param[out] mode        : One of LP_GPS_SESSION_MODE.
+ * \param[out] reuseCount  : Number of session calls that re-used the resident signal since the session was opened.
+ *
+ * \return ERR_OK
+ */
+IQMEASURE_API int		LP_GPS_SessionGetInfo(int *mode, int *reuseCount);
+
 //! spcified the path that is used to invoke LitePoint Connectivity server.
 /*!
  * \param[in] litePointConnectionPath The path of connectivity server.
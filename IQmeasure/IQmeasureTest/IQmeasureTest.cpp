@@ -4,11 +4,13 @@
 #include "stdafx.h"
 #include "iqapi.h"
 #include "..\IQmeasure.h"
-#include "..\DebugAlloc.h"
 #include "math.h"
 #include "time.h"
 #include "vector"
+#include "string"
 #include "IQmeasureTest.h"
+#include "..\..\TestManager\TestManager.h"
+#include "..\..\IQlite_Timer\IQlite_Timer.h"
 
 
 
@@ -2430,8 +2432,536 @@ void	Glonass_Test()
 	}
 }
 
+//! Analysis time of recorded 4-stream (3x3/4x4 VHT80) composite captures vs. number of host threads
+/*!
+ * [BENCHMARK] in QA_Setup.ini:
+ *   MIMO_SIG_FILE = capture to analyze (e.g. a 4-stream VHT80 .iqvsa/.sig recorded by WiFiSaveSigFile)
+ *   RUNS          = analyses per thread count, Default = 10
+ *
+ * Also compares fetching the per-stream results one index at a time with LP_GetScalarMeasurementArray().
+ */
+void WiFi_11ac_MIMO_Analysis_Benchmark()
+{
+	char   buffer[MAX_BUFFER_SIZE];
+	char   sigFile[MAX_BUFFER_SIZE] = {'\0'};
+	double evmStream[4] = {0.0};
+	double rxRmsPowerDb[16] = {0.0};
+	lp_time_t startTime, stopTime;
+
+	try
+	{
+		GetPrivateProfileStringA("BENCHMARK", "MIMO_SIG_FILE", "../mod/WiFi_11AC_VHT80_S4_MCS9.iqvsa", sigFile, MAX_BUFFER_SIZE, ".\\QA_Setup.ini");
+		int numRun = GetPrivateProfileIntA("BENCHMARK", "RUNS", 10, ".\\QA_Setup.ini");
+
+		SYSTEM_INFO sysInfo;
+		GetSystemInfo(&sysInfo);
+		int maxThread = (int)sysInfo.dwNumberOfProcessors;
+
+		set_color(CM_GREEN);
+		//----------------------------//
+		//   Initialize the IQTester  //
+		//----------------------------//
+		CheckReturnCode( LP_Init(ciTesterType, ciTesterControlMode), "LP_Init()" );
+		CheckReturnCode( LP_InitTester(g_IP_addr), "LP_InitTester()" );
+		if (LP_GetVersion(buffer, MAX_BUFFER_SIZE)==true)	printf("%s\n", buffer);
+
+		printf("\nLoading capture file %s\n", sigFile);
+		CheckReturnCode( LP_LoadVsaSignalFile(sigFile), "LP_LoadVsaSignalFile()" );
+
+		for (int threadNumber=1; threadNumber<=maxThread; threadNumber*=2)
+		{
+			if ( ERR_OK!=LP_EnableMultiThread((1<threadNumber)?1:0, threadNumber) )
+			{
+				printf("LP_EnableMultiThread(%d) not supported by this tester type, single run only.\n", threadNumber);
+				if (1<threadNumber) break;
+			}
+
+			GetTime(startTime);
+			for (int iRun=0; iRun<numRun; iRun++)
+			{
+				int err = LP_Analyze80211ac("nxn");
+				if (ERR_OK!=err) CheckReturnCode( err, "LP_Analyze80211ac()" );
+			}
+			GetTime(stopTime);
+
+			set_color(CM_YELLOW);
+			printf("[BENCHMARK] LP_Analyze80211ac(nxn), %d thread(s): %.1f ms/analysis\n", threadNumber, (double)GetElapsedMSec(startTime, stopTime)/numRun);
+			::LOGGER_Write(g_logger_id, LOGGER_INFORMATION, "[BENCHMARK],LP_Analyze80211ac,%d,threads,%.1f,ms\n", threadNumber, (double)GetElapsedMSec(startTime, stopTime)/numRun);
+			set_color(CM_GREEN);
+		}
+
+		int numStream = (int)LP_GetScalarMeasurement("rateInfo_spatialStreams", 0);
+		if ( (0>=numStream)||(4<numStream) ) numStream = 4;
+
+		GetTime(startTime);
+		for (int iRun=0; iRun<numRun; iRun++)
+		{
+			for (int i=0; i<numStream; i++)
+			{
+				evmStream[i] = LP_GetScalarMeasurement("evmAvgAll", i);
+				for (int j=0; j<numStream; j++)
+				{
+					rxRmsPowerDb[i*numStream+j] = LP_GetScalarMeasurement("rxRmsPowerDb", i*numStream+j);
+				}
+			}
+		}
+		GetTime(stopTime);
+		printf("[BENCHMARK] LP_GetScalarMeasurement() per index: %.2f ms/fetch\n", (double)GetElapsedMSec(startTime, stopTime)/numRun);
+
+		GetTime(startTime);
+		for (int iRun=0; iRun<numRun; iRun++)
+		{
+			LP_GetScalarMeasurementArray("evmAvgAll", evmStream, numStream);
+			LP_GetScalarMeasurementArray("rxRmsPowerDb", rxRmsPowerDb, numStream*numStream);
+		}
+		GetTime(stopTime);
+		printf("[BENCHMARK] LP_GetScalarMeasurementArray(): %.2f ms/fetch\n", (double)GetElapsedMSec(startTime, stopTime)/numRun);
+
+		for (int i=0; i<numStream; i++)
+		{
+			printf("Stream %d EVM Avg All: %.3f dB\n", i+1, evmStream[i]);
+		}
+
+		//----------------------------//
+		//   Disconnect the IQTester  //
+		//----------------------------//
+		CheckReturnCode( LP_Term(), "LP_Term()" );
+	}
+	catch(char *msg)
+	{
+		printf("ERROR: %s\n", msg);
+	}
+	catch(...)
+	{
+		printf("ERROR!");
+	}
+}
+
+static double FileSizeMB(char *fileName)
+{
+	WIN32_FILE_ATTRIBUTE_DATA fileData;
+	if (!GetFileAttributesExA(fileName, GetFileExInfoStandard, &fileData))
+		return 0.0;
+	return ((double)fileData.nFileSizeHigh*4294967296.0 + fileData.nFileSizeLow)/1048576.0;
+}
+
+// Memory, file size, load time and EVM of a recorded capture kept as double (.sig), float32 and int16 (.iqc)
+void Compact_Capture_Comparison()
+{
+	char   buffer[MAX_BUFFER_SIZE];
+	char   sigFile[MAX_BUFFER_SIZE] = {'\0'};
+	char   *fileName[3]  = {"Log\\Compact_Reference.sig", "Log\\Compact_Float32.iqc", "Log\\Compact_Int16.iqc"};
+	char   *formatName[3] = {"double", "float32", "int16"};
+	int    bytesPerSample[3] = {16, 8, 4};
+	double evmRef[4] = {0.0}, evm[4] = {0.0};
+	double *real[4] = {NULL}, *imag[4] = {NULL};
+	int    length[4] = {0};
+	double sampleFreqHz[4] = {0.0};
+	lp_time_t startTime, stopTime;
+
+	try
+	{
+		GetPrivateProfileStringA("BENCHMARK", "COMPACT_SIG_FILE", "../mod/WiFi_11AC_VHT80_S4_MCS9.iqvsa", sigFile, MAX_BUFFER_SIZE, ".\\QA_Setup.ini");
+		int numRun = GetPrivateProfileIntA("BENCHMARK", "RUNS", 10, ".\\QA_Setup.ini");
+
+		set_color(CM_GREEN);
+		//----------------------------//
+		//   Initialize the IQTester  //
+		//----------------------------//
+		CheckReturnCode( LP_Init(ciTesterType, ciTesterControlMode), "LP_Init()" );
+		CheckReturnCode( LP_InitTester(g_IP_addr), "LP_InitTester()" );
+		if (LP_GetVersion(buffer, MAX_BUFFER_SIZE)==true)	printf("%s\n", buffer);
+
+		printf("\nLoading capture file %s\n", sigFile);
+		CheckReturnCode( LP_LoadVsaSignalFile(sigFile), "LP_LoadVsaSignalFile()" );
+		CheckReturnCode( LP_GetHndlDataPointers(real, imag, length, sampleFreqHz, 4), "LP_GetHndlDataPointers()" );
+
+		int totalSamples = 0, numStream = 0;
+		for (numStream=0; numStream<4 && NULL!=real[numStream] && 0<length[numStream]; numStream++)
+		{
+			totalSamples += length[numStream];
+		}
+		CheckReturnCode( LP_Analyze80211ac("nxn"), "LP_Analyze80211ac()" );
+		LP_GetScalarMeasurementArray("evmAvgAll", evmRef, numStream);
+
+		CheckReturnCode( LP_SaveVsaSignalFile(fileName[0]), "LP_SaveVsaSignalFile()" );
+		CheckReturnCode( LP_SaveCaptureCompact(fileName[1], IQ_FORMAT_FLOAT32), "LP_SaveCaptureCompact(float32)" );
+		CheckReturnCode( LP_SaveCaptureCompact(fileName[2], IQ_FORMAT_INT16), "LP_SaveCaptureCompact(int16)" );
+
+		// Host-side export of one stream: handle arrays to a compact buffer
+		vector<short> bufferIQ(2*length[0]);
+		int    sampleCount = 0;
+		double scale = 1.0;
+		GetTime(startTime);
+		for (int iRun=0; iRun<numRun; iRun++)
+		{
+			CheckReturnCode( LP_GetSampleDataCompact(0, IQ_FORMAT_INT16, &bufferIQ[0], length[0], &sampleCount, &scale), "LP_GetSampleDataCompact()" );
+		}
+		GetTime(stopTime);
+		printf("[COMPACT] LP_GetSampleDataCompact(int16) of %d samples: %.2f ms\n", sampleCount, (double)GetElapsedMSec(startTime, stopTime)/numRun);
+
+		printf("[COMPACT] %d stream(s), %d samples\n", numStream, totalSamples);
+		for (int i=0; i<3; i++)
+		{
+			GetTime(startTime);
+			for (int iRun=0; iRun<numRun; iRun++)
+			{
+				if (0==i)
+					CheckReturnCode( LP_LoadVsaSignalFile(fileName[i]), "LP_LoadVsaSignalFile()" );
+				else
+					CheckReturnCode( LP_LoadCaptureCompact(fileName[i]), "LP_LoadCaptureCompact()" );
+			}
+			GetTime(stopTime);
+
+			CheckReturnCode( LP_Analyze80211ac("nxn"), "LP_Analyze80211ac()" );
+			LP_GetScalarMeasurementArray("evmAvgAll", evm, numStream);
+
+			double maxDeltaDb = 0.0;
+			for (int j=0; j<numStream; j++)
+			{
+				if (fabs(evm[j]-evmRef[j])>maxDeltaDb) maxDeltaDb = fabs(evm[j]-evmRef[j]);
+			}
+
+			set_color(CM_YELLOW);
+			printf("[COMPACT] %-8s memory %8.2f MB, file %8.2f MB, load %7.1f ms, EVM delta %.3f dB\n", formatName[i],
+				(double)totalSamples*bytesPerSample[i]/1048576.0, FileSizeMB(fileName[i]), (double)GetElapsedMSec(startTime, stopTime)/numRun, maxDeltaDb);
+			::LOGGER_Write(g_logger_id, LOGGER_INFORMATION, "[COMPACT],%s,%.2f,MB,%.2f,MB,%.1f,ms,%.3f,dB\n", formatName[i],
+				(double)totalSamples*bytesPerSample[i]/1048576.0, FileSizeMB(fileName[i]), (double)GetElapsedMSec(startTime, stopTime)/numRun, maxDeltaDb);
+			set_color(CM_GREEN);
+		}
+
+		//----------------------------//
+		//   Disconnect the IQTester  //
+		//----------------------------//
+		CheckReturnCode( LP_Term(), "LP_Term()" );
+	}
+	catch(char *msg)
+	{
+		printf("ERROR: %s\n", msg);
+	}
+	catch(...)
+	{
+		printf("ERROR!");
+	}
+}
+
+// Packets of a single VSA capture analyzed one by one (EVM_MULTI_PACKET): only VSA 1 holds data
+void Multi_Packet_Single_Vsa()
+{
+	char   buffer[MAX_BUFFER_SIZE];
+	char   sigFile[MAX_BUFFER_SIZE] = {'\0'};
+	double *real[4] = {NULL}, *imag[4] = {NULL};
+	int    length[4] = {0};
+	double sampleFreqHz[4] = {0.0};
+	const int MAX_PACKETS = 256;
+	double packetStartUs[MAX_PACKETS], packetLengthUs[MAX_PACKETS];
+
+	try
+	{
+		GetPrivateProfileStringA("MULTI_PACKET", "SIG_FILE", "../mod/WiFi_Capture_OFDM-54_10_packets.sig", sigFile, MAX_BUFFER_SIZE, ".\\QA_Setup.ini");
+		int minPackets = GetPrivateProfileIntA("MULTI_PACKET", "MIN_PACKETS", 2, ".\\QA_Setup.ini");
+
+		set_color(CM_GREEN);
+		//----------------------------//
+		//   Initialize the IQTester  //
+		//----------------------------//
+		CheckReturnCode( LP_Init(ciTesterType, ciTesterControlMode), "LP_Init()" );
+		CheckReturnCode( LP_InitTester(g_IP_addr), "LP_InitTester()" );
+		if (LP_GetVersion(buffer, MAX_BUFFER_SIZE)==true)	printf("%s\n", buffer);
+
+		printf("\nLoading capture file %s\n", sigFile);
+		CheckReturnCode( LP_LoadVsaSignalFile(sigFile), "LP_LoadVsaSignalFile()" );
+		CheckReturnCode( LP_GetHndlDataPointers(real, imag, length, sampleFreqHz, 4), "LP_GetHndlDataPointers()" );
+		if ( 0>=length[0] || 0.0>=sampleFreqHz[0] || 0<length[1] )
+		{
+			sprintf_s(buffer, MAX_BUFFER_SIZE, "%s must hold the capture of one VSA", sigFile);
+			throw buffer;
+		}
+		else
+		{
+			// do nothing
+		}
+
+		double captureLengthUs = length[0]/sampleFreqHz[0]*1e6;
+		int packetNum = LP_GetCapturePacketRanges(captureLengthUs, packetStartUs, packetLengthUs, MAX_PACKETS);
+		printf("[MULTI_PACKET] %d complete packets in the %.0f us capture\n", packetNum, captureLengthUs);
+
+		int failures = (packetNum<minPackets) ? 1 : 0;
+		for (int i=0; i<packetNum; i++)
+		{
+			int err = LP_SelectCaptureRangeForAnalysis(packetStartUs[i], packetLengthUs[i]);
+			if (ERR_OK==err)
+			{
+				err = LP_Analyze80211ag();
+			}
+			else
+			{
+				// do nothing
+			}
+			double evm = (ERR_OK==err) ? LP_GetScalarMeasurement("evmAll", 0) : NA_NUMBER;
+			printf("[MULTI_PACKET] packet %2d at %9.1f us, %7.1f us: err %d, EVM %.2f dB\n", i+1, packetStartUs[i], packetLengthUs[i], err, evm);
+			if (ERR_OK!=err)
+			{
+				failures++;
+			}
+			else
+			{
+				// do nothing
+			}
+		}
+
+		set_color( (0==failures) ? CM_YELLOW : CM_RED );
+		printf("[MULTI_PACKET] %s\n", (0==failures) ? "PASS" : "FAIL");
+		::LOGGER_Write(g_logger_id, LOGGER_INFORMATION, "[MULTI_PACKET],%d,packets,%s\n", packetNum, (0==failures) ? "PASS" : "FAIL");
+		set_color(CM_GREEN);
+
+		//----------------------------//
+		//   Disconnect the IQTester  //
+		//----------------------------//
+		CheckReturnCode( LP_Term(), "LP_Term()" );
+	}
+	catch(char *msg)
+	{
+		printf("ERROR: %s\n", msg);
+	}
+	catch(...)
+	{
+		printf("ERROR!");
+	}
+}
+
+// A profile step must be sent again after an LP_ call changed its setting behind the profile's back,
+// and an analysis parameter every time, since the LP_Analyze* call overwrites it
+void Profile_Forget_Test()
+{
+	char buffer[MAX_BUFFER_SIZE];
+	IQ_RF_PROFILE profile;
+	int profileId = 0;
+	int sent[3] = {0}, skipped[3] = {0};
+
+	try
+	{
+		set_color(CM_GREEN);
+		//----------------------------//
+		//   Initialize the IQTester  //
+		//----------------------------//
+		CheckReturnCode( LP_Init(ciTesterType, ciTesterControlMode), "LP_Init()" );
+		CheckReturnCode( LP_InitTester(g_IP_addr), "LP_InitTester()" );
+		if (LP_GetVersion(buffer, MAX_BUFFER_SIZE)==true)	printf("%s\n", buffer);
+
+		memset(&profile, 0, sizeof(profile));
+		profile.enableMask = IQ_PROFILE_VSA_TRIGGER_TIMEOUT;
+		profile.vsaTriggerTimeoutSec = 2.0;
+		profile.analysisCount = 1;
+		strcpy_s(profile.analysis[0].measurement, IQ_PROFILE_NAME_SIZE, "Analyze80211n");
+		strcpy_s(profile.analysis[0].parameter, IQ_PROFILE_NAME_SIZE, "frequencyCorr");
+		profile.analysis[0].value = 2;
+		CheckReturnCode( LP_DefineProfile("PROFILE_FORGET_TEST", &profile, &profileId), "LP_DefineProfile()" );
+
+		CheckReturnCode( LP_ApplyProfile(profileId), "LP_ApplyProfile()" );
+		LP_ProfileGetInfo(&sent[0], &skipped[0]);
+
+		// Same settings again: the trigger timeout is skipped, the analysis parameter is sent
+		CheckReturnCode( LP_ApplyProfile(profileId), "LP_ApplyProfile()" );
+		LP_ProfileGetInfo(&sent[1], &skipped[1]);
+
+		// The direct call changes the trigger timeout, so the next apply has to send both steps
+		CheckReturnCode( LP_SetVsaTriggerTimeout(1.0), "LP_SetVsaTriggerTimeout()" );
+		CheckReturnCode( LP_ApplyProfile(profileId), "LP_ApplyProfile()" );
+		LP_ProfileGetInfo(&sent[2], &skipped[2]);
+
+		bool pass = ( sent[1]==sent[0]+1 && skipped[1]==skipped[0]+1 && sent[2]==sent[1]+2 && skipped[2]==skipped[1] );
+		printf("[PROFILE_FORGET] sent %d/%d/%d, skipped %d/%d/%d\n", sent[0], sent[1], sent[2], skipped[0], skipped[1], skipped[2]);
+		set_color( pass ? CM_YELLOW : CM_RED );
+		printf("[PROFILE_FORGET] %s\n", pass ? "PASS" : "FAIL");
+		::LOGGER_Write(g_logger_id, LOGGER_INFORMATION, "[PROFILE_FORGET],%s\n", pass ? "PASS" : "FAIL");
+		set_color(CM_GREEN);
+
+		//----------------------------//
+		//   Disconnect the IQTester  //
+		//----------------------------//
+		CheckReturnCode( LP_Term(), "LP_Term()" );
+	}
+	catch(char *msg)
+	{
+		printf("ERROR: %s\n", msg);
+	}
+	catch(...)
+	{
+		printf("ERROR!");
+	}
+}
+
+// TM_Term() has to leave a trace file with the spans recorded before it; runs without a tester
+int Trace_Term_Test()
+{
+	char spanName[MAX_BUFFER_SIZE];
+	char buffer[MAX_BUFFER_SIZE];
+	bool pass = true;
+	bool found = false;
+
+	sprintf_s(spanName, MAX_BUFFER_SIZE, "TRACE_TERM_TEST_%lu", GetTickCount());
+
+	pass = pass && ( TIMER_ERR_OK==::TIMER_TraceOn() );
+	// No such span is open
+	pass = pass && ( TIMER_ERR_PARAM_DOES_NOT_EXIST==::TIMER_TraceEnd(spanName) );
+	::TIMER_TraceBegin("IQmeasureTest", spanName);
+	Sleep(10);
+	pass = pass && ( TIMER_ERR_OK==::TIMER_TraceEnd(spanName) );
+	pass = pass && ( TM_ERR_OK==::TM_Term() );
+
+	WIN32_FIND_DATAA findData;
+	HANDLE findHandle = FindFirstFileA(".\\Timer\\*_Trace.json", &findData);
+	if (INVALID_HANDLE_VALUE!=findHandle)
+	{
+		do
+		{
+			std::string content;
+			FILE *traceFile = NULL;
+			sprintf_s(buffer, MAX_BUFFER_SIZE, ".\\Timer\\%s", findData.cFileName);
+			fopen_s(&traceFile, buffer, "r");
+			if (NULL!=traceFile)
+			{
+				size_t readSize = 0;
+				while ( 0<(readSize=fread(buffer, 1, MAX_BUFFER_SIZE, traceFile)) )
+				{
+					content.append(buffer, readSize);
+				}
+				fclose(traceFile);
+				found = ( std::string::npos!=content.find(spanName) );
+			}
+			else
+			{
+				// do nothing
+			}
+		} while ( !found && FindNextFileA(findHandle, &findData) );
+		FindClose(findHandle);
+	}
+	else
+	{
+		// do nothing
+	}
+	pass = pass && found;
+
+	printf("[TRACE_TERM] span %s %s\n", spanName, found ? "saved" : "not saved");
+	printf("[TRACE_TERM] %s\n", pass ? "PASS" : "FAIL");
+	return pass ? 0 : 1;
+}
+
+// Standard normal sample (Box-Muller) from a fixed-seed generator, so the simulation repeats exactly
+static double SimNormal(unsigned int *seed)
+{
+	*seed = *seed*1103515245 + 12345;
+	double u1 = ((*seed>>8) + 1.0)/16777217.0;
+	*seed = *seed*1103515245 + 12345;
+	double u2 = ((*seed>>8) + 1.0)/16777217.0;
+	return sqrt(-2.0*log(u1))*cos(2.0*3.14159265358979*u2);
+}
+
+// Simulates AverageDecisionReached() of WiFi_Test.DLL on N(mean, 1) samples against an upper limit of 0.
+// Every mean far from the limit has to stop early, and no mean may decide early on the wrong side of the limit
+// more often than the bound of the repeated tests, (EVM_AVERAGE-AVERAGE_MIN_SAMPLES+1) x (100-level)/2 %.
+int Average_Early_Exit_Test()
+{
+	typedef bool (*AVERAGE_DECISION_REACHED)(double *resultArray, int averageTimes, int logType, double lowerLimit, double upperLimit);
+	const int    maxSamples  = 10;		// EVM_AVERAGE
+	const int    minSamples  = 3;		// AVERAGE_MIN_SAMPLES
+	const double level       = 99.0;	// AVERAGE_CONFIDENCE_LEVEL
+	const int    trials      = 4000;
+	const double means[]     = { -2.0, -1.0, -0.5, -0.25, 0.25, 0.5, 1.0, 2.0 };
+	const double errorBound  = (maxSamples-minSamples+1)*(100.0-level)/2/100;
+	TM_ID  wifiID = -1;
+	bool   pass   = true;
+
+	::TM_RegisterTechnologyDll("WIFI", "WiFi_Test.DLL", &wifiID);
+	AVERAGE_DECISION_REACHED averageDecisionReached = (AVERAGE_DECISION_REACHED)GetProcAddress(GetModuleHandleA("WiFi_Test.DLL"), "AverageDecisionReached");
+	if ( wifiID<0 || NULL==averageDecisionReached )
+	{
+		printf("[AVERAGE_SIM] WiFi_Test.DLL not loaded\n");
+		return 1;
+	}
+	else
+	{
+		// do nothing
+	}
+	::TM_ClearParameters(wifiID);
+	::TM_AddIntegerParameter(wifiID, "AVERAGE_EARLY_EXIT",       1);
+	::TM_AddIntegerParameter(wifiID, "AVERAGE_MIN_SAMPLES",      minSamples);
+	::TM_AddDoubleParameter (wifiID, "AVERAGE_CONFIDENCE_LEVEL", level);
+	if ( TM_ERR_OK!=::TM_Run(wifiID, "GLOBAL_SETTINGS") )
+	{
+		printf("[AVERAGE_SIM] GLOBAL_SETTINGS failed\n");
+		return 1;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	unsigned int seed = 20141015;
+	printf("[AVERAGE_SIM] %d trials per mean, %d to %d samples, %.1f %% level, wrong decision bound %.1f %%\n", trials, minSamples, maxSamples, level, errorBound*100);
+	printf("[AVERAGE_SIM]   mean   avg samples   early   wrong early\n");
+	for (int m=0;m<sizeof(means)/sizeof(means[0]);m++)
+	{
+		int totalSamples = 0, earlyCount = 0, wrongCount = 0;
+		for (int t=0;t<trials;t++)
+		{
+			double samples[maxSamples];
+			double sum = 0;
+			int    n   = 0;
+			bool   decided = false;
+			while ( n<maxSamples && !decided )
+			{
+				samples[n] = means[m] + SimNormal(&seed);
+				sum += samples[n];
+				n++;
+				decided = averageDecisionReached(samples, n, 1, NA_NUMBER, 0.0);	// Linear
+			}
+			totalSamples += n;
+			if ( decided && n<maxSamples )
+			{
+				earlyCount++;
+				// The decision is on the side of the mean of the samples so far
+				wrongCount += ( (sum/n<0.0)!=(means[m]<0.0) ) ? 1 : 0;
+			}
+			else
+			{
+				// do nothing
+			}
+		}
+		double wrongRate = (double)wrongCount/trials;
+		double avgSamples = (double)totalSamples/trials;
+		printf("[AVERAGE_SIM] %6.2f   %11.2f   %5.1f%%   %10.2f%%\n", means[m], avgSamples, 100.0*earlyCount/trials, wrongRate*100);
+		pass = pass && ( wrongRate<=errorBound );
+		pass = pass && ( fabs(means[m])<2.0 || avgSamples<maxSamples );
+	}
+
+	printf("[AVERAGE_SIM] %s\n", pass ? "PASS" : "FAIL");
+	return pass ? 0 : 1;
+}
+
 int _tmain(int argc, _TCHAR* argv[])
 {
+	// -bench and -bench_baseline run without any keypress, the exit code is the number of regressions and failed cases
+	if( argc>1 && ( 0==wcscmp(argv[1],_T("-bench")) || 0==wcscmp(argv[1],_T("-bench_baseline")) ) )
+	{
+		return Benchmark_Suite( 0==wcscmp(argv[1],_T("-bench_baseline")) );
+	}
+	// -trace_term runs without a tester, the exit code is 1 if the trace file is missing
+	else if( argc>1 && 0==wcscmp(argv[1],_T("-trace_term")) )
+	{
+		return Trace_Term_Test();
+	}
+	// -average_sim needs WiFi_Test.DLL but no tester, the exit code is 1 if the early exit decides wrong too often
+	else if( argc>1 && 0==wcscmp(argv[1],_T("-average_sim")) )
+	{
+		return Average_Early_Exit_Test();
+	}
+	else
+	{
+		//do nothing
+	}
+
 	while (FALSE == bExitFlag)
 	{
 		//tyu;07-04;timer logger
@@ -2506,6 +3036,14 @@ int _tmain(int argc, _TCHAR* argv[])
 				WiFi_11ac_Loopback();
 			}else if( 0==wcscmp(argv[1],_T("-acmimo")) ){
 				WiFi_11ac_MIMO_Loopback();
+			}else if( 0==wcscmp(argv[1],_T("-acmimo_bench")) ){
+				WiFi_11ac_MIMO_Analysis_Benchmark();
+			}else if( 0==wcscmp(argv[1],_T("-compact")) ){
+				Compact_Capture_Comparison();
+			}else if( 0==wcscmp(argv[1],_T("-multi_single")) ){
+				Multi_Packet_Single_Vsa();
+			}else if( 0==wcscmp(argv[1],_T("-profile_forget")) ){
+				Profile_Forget_Test();
 			}else if( 0==wcscmp(argv[1],_T("-evm")) ){
 				Evm_Test();
 			}else if( 0==wcscmp(argv[1],_T("-cw")) ){
@@ -70,7 +70,11 @@ void QA_Dualhead(void);  //tyu;2012-07-16; QA Dualhead
 
 void CheckReturnCode( int returnCode, char *functionName='\0' );
 unsigned int GetElapsedMSec(lp_time_t start, lp_time_t end);
+void GetTime(lp_time_t& time);
 void ReadLogFiles (void);
+int  Benchmark_Suite(bool writeBaseline);
+int  Trace_Term_Test(void);
+int  Average_Early_Exit_Test(void);
 
 
 
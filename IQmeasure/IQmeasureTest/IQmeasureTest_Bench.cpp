@@ -0,0 +1,493 @@
+// IQmeasureTest_Bench.cpp : benchmark and regression-timing suite (-bench)
+//
+// Times the host side of a test run on recorded captures, no tester connection is needed:
+//   api       LP_, TM_ and vDUT_ calls that do no work, i.e. the cost of the dispatch
+//   analysis  LP_Analyze*() of the recorded captures: 11a/g, 11b, 11ac, Bluetooth,
+//             FFT (spectral mask), OBW, power and fast-cal power
+//   fetch     LP_GetScalarMeasurement()/LP_GetVectorMeasurement() of the analysis results
+//   logging   LOGGER_Write() and LOGGER_Write_Ext() to a log file, and LOGGER_Write_Ext() of a message
+//             the logger discards, with and without formatting it first
+//
+// Each case runs SUITE_RUNS batches and keeps its fastest batch, so a busy host does not fail the
+// suite.  The results go to RESULT_FILE as JSON, one case per line, and are compared with
+// BASELINE_FILE: a case slower than its baseline by more than TOLERANCE_PERCENT is reported
+// as a regression.  "IQmeasureTest -bench_baseline" stores the results as the new baseline.
+// A case whose capture is not configured or not found is skipped; a case whose calls return
+// an error has failed, and counts in the exit code like a regression.
+//
+// The TM_ and vDUT_ cases run a no-op that the suite installs on existing keywords of the WIFI
+// technology, CURRENT_TEST and DUT_MISC_FUNCTION9; WiFi_Test is not loaded in this process, so
+// nothing else is installed on them.
+//
+// [BENCHMARK] in QA_Setup.ini:
+//   WIFI_AG_SIG_FILE, WIFI_B_SIG_FILE, MIMO_SIG_FILE, BT_SIG_FILE   recorded captures
+//   SUITE_RUNS, API_CALLS, FETCH_CALLS, LOG_LINES                    batches and calls per batch
+//   RESULT_FILE, BASELINE_FILE, TOLERANCE_PERCENT
+
+#include "stdafx.h"
+#include "..\IQmeasure.h"
+#include "..\..\TestManager\TestManager.h"
+#include "..\..\vDUT\vDUT.h"
+#include "IQmeasureTest.h"
+#include <string>
+#include <vector>
+#include <map>
+
+using namespace std;
+
+extern  int		ciTesterControlMode;
+extern  int		ciTesterType;
+
+#define BENCH_SETUP_FILE		".\\QA_Setup.ini"
+#define BENCH_SECTION			"BENCHMARK"
+#define BENCH_TECHNOLOGY		"WIFI"
+#define BENCH_TM_NOP_KEYWORD		"CURRENT_TEST"
+#define BENCH_DUT_NOP_KEYWORD	"DUT_MISC_FUNCTION9"
+#define BENCH_VECTOR_SIZE		8192
+#define BENCH_ERR_SKIPPED		-1			// capture not configured or not found
+#define BENCH_ERR_FAILED		-2			// the call gave no result
+
+typedef int (*BENCH_FUNCTION)(void);
+
+typedef struct tagBenchCase
+{
+	const char		*name;
+	const char		*group;
+	const char		*captureKey;		// [BENCHMARK] key of the capture loaded before the case, NULL = none
+	BENCH_FUNCTION	prepare;			// called once before the timing, NULL = none
+	BENCH_FUNCTION	function;			// the timed call
+	const char		*callsKey;			// [BENCHMARK] key of the calls per batch, NULL = 1
+	int				callsDefault;
+} BENCH_CASE;
+
+typedef struct tagBenchResult
+{
+	string	name;
+	string	group;
+	int		calls;
+	double	usPerCall;					// fastest batch
+	double	usPerCallAvg;				// all batches
+	double	baselineUs;					// 0 = no baseline
+	string	status;						// ok, regression, new, failed or skipped
+} BENCH_RESULT;
+
+static int		g_benchTmId     = -1;
+static int		g_benchDutId    = -1;
+static int		g_benchLoggerId = -1;
+static double	g_benchReal[BENCH_VECTOR_SIZE];
+static double	g_benchImag[BENCH_VECTOR_SIZE];
+
+static int BenchTmNop(void)
+{
+	::TM_AddDoubleReturn(g_benchTmId, "BENCH_VALUE", 1.0);
+	return 0;
+}
+
+static int BenchDutNop(void)
+{
+	return 0;
+}
+
+/*-----*
+ * api *
+ *-----*/
+static int Bench_LP_GetErrorString(void)
+{
+	return (NULL!=LP_GetErrorString(ERR_OK)) ? ERR_OK : BENCH_ERR_FAILED;
+}
+
+static int Bench_TM_Run(void)
+{
+	return ::TM_Run(g_benchTmId, BENCH_TM_NOP_KEYWORD);
+}
+
+static int Bench_TM_Parameters(void)
+{
+	::TM_ClearParameters(g_benchTmId);
+	::TM_AddIntegerParameter(g_benchTmId, "FREQ_MHZ", 2412);
+	::TM_AddDoubleParameter(g_benchTmId, "TX_POWER_DBM", 15.0);
+	return ::TM_AddStringParameter(g_benchTmId, "DATA_RATE", "OFDM-54");
+}
+
+static int Bench_TM_GetDoubleReturn(void)
+{
+	double value = 0.0;
+	return ::TM_GetDoubleReturn(g_benchTmId, "BENCH_VALUE", &value);
+}
+
+static int Bench_vDUT_Run(void)
+{
+	return ::vDUT_Run(g_benchDutId, BENCH_DUT_NOP_KEYWORD);
+}
+
+static int Bench_vDUT_Parameters(void)
+{
+	::vDUT_ClearParameters(g_benchDutId);
+	::vDUT_AddIntegerParameter(g_benchDutId, "FREQ_MHZ", 2412);
+	::vDUT_AddDoubleParameter(g_benchDutId, "TX_POWER_DBM", 15.0);
+	return ::vDUT_AddStringParameter(g_benchDutId, "DATA_RATE", "OFDM-54");
+}
+
+/*----------*
+ * analysis *
+ *----------*/
+static int Bench_Analyze80211ag(void)
+{
+	return LP_Analyze80211ag();
+}
+
+static int Bench_Analyze80211b(void)
+{
+	return LP_Analyze80211b();
+}
+
+static int Bench_Analyze80211ac(void)
+{
+	return LP_Analyze80211ac("nxn");
+}
+
+static int Bench_AnalyzeBluetooth(void)
+{
+	return LP_AnalyzeBluetooth(1, "AllPlus");
+}
+
+static int Bench_AnalyzeFFT(void)
+{
+	return LP_AnalyzeFFT();
+}
+
+static int Bench_AnalyzeObw(void)
+{
+	return LP_AnalyzeObw();
+}
+
+static int Bench_AnalyzePower(void)
+{
+	return LP_AnalyzePower();
+}
+
+static int Bench_FastCalPower(void)
+{
+	double powerDbm = 0.0;
+	int err = LP_FastCalGetPowerData(1);
+	if (ERR_OK==err)
+	{
+		err = LP_FastCalMeasPower(10, 110, &powerDbm);
+	}
+	LP_FastCalGetPowerData(0);
+	return err;
+}
+
+/*-------*
+ * fetch *
+ *-------*/
+// The results WiFi_TX_Verify_EVM reads for one 11a/g capture
+static int Bench_GetScalarMeasurement(void)
+{
+	double evm = LP_GetScalarMeasurement("evmAll", 0);
+	LP_GetScalarMeasurement("rmsPowerNoGap", 0);
+	LP_GetScalarMeasurement("freqErr", 0);
+	LP_GetScalarMeasurement("ampErrDb", 0);
+	LP_GetScalarMeasurement("phaseErr", 0);
+	LP_GetScalarMeasurement("clockErr", 0);
+	return (-99.00<evm) ? ERR_OK : BENCH_ERR_FAILED;
+}
+
+// Channel estimate of the spectral flatness
+static int Bench_GetVectorFlatness(void)
+{
+	return (0<LP_GetVectorMeasurement("hhEst", g_benchReal, g_benchImag, BENCH_VECTOR_SIZE)) ? ERR_OK : BENCH_ERR_FAILED;
+}
+
+// Spectrum of the mask and OBW checks
+static int Bench_GetVectorSpectrum(void)
+{
+	int sizeX = LP_GetVectorMeasurement("x", g_benchReal, g_benchImag, BENCH_VECTOR_SIZE);
+	int sizeY = LP_GetVectorMeasurement("y", g_benchReal, g_benchImag, BENCH_VECTOR_SIZE);
+	return ( 0<sizeX && 0<sizeY ) ? ERR_OK : BENCH_ERR_FAILED;
+}
+
+/*---------*
+ * logging *
+ *---------*/
+static int Bench_LOGGER_Write(void)
+{
+	return ::LOGGER_Write(g_benchLoggerId, LOGGER_INFORMATION, "[BENCHMARK],%s,%.2f,ms\n", "LP_Analyze80211ag", 12.34);
+}
+
+static int Bench_LOGGER_Write_Ext(void)
+{
+	return ::LOGGER_Write_Ext(LOG_IQMEASURE, g_benchLoggerId, LOGGER_INFORMATION, "[IQMEASURE],[%s],%.2f,ms\n", "LP_Analyze80211ag", 12.34);
+}
+
+// A message below the log level: LOGGER_Write_Ext() checks the level before it formats.
+// Skipped if LOG_LEVEL of the logger ini lets the information through.
+static int Bench_LOGGER_Write_Ext_Discarded(void)
+{
+	if ( ::LOGGER_IsEnabled(LOG_IQMEASURE, LOGGER_INFORMATION) )
+	{
+		return BENCH_ERR_SKIPPED;
+	}
+	return ::LOGGER_Write_Ext(LOG_IQMEASURE, g_benchLoggerId, LOGGER_INFORMATION, "[IQMEASURE],[%s],%.2f,ms\n", "LP_Analyze80211ag", 12.34);
+}
+
+// Same message formatted by the caller first, as LogReturnMessage() did before it checked the level
+static int Bench_LOGGER_Write_Ext_Formatted(void)
+{
+	if ( ::LOGGER_IsEnabled(LOG_IQMEASURE, LOGGER_INFORMATION) )
+	{
+		return BENCH_ERR_SKIPPED;
+	}
+	char message[MAX_BUFFER_SIZE];
+	sprintf_s(message, MAX_BUFFER_SIZE, "[IQMEASURE],[%s],%.2f,ms\n", "LP_Analyze80211ag", 12.34);
+	return ::LOGGER_Write_Ext(LOG_IQMEASURE, g_benchLoggerId, LOGGER_INFORMATION, "%s", message);
+}
+
+static const BENCH_CASE g_benchCases[] =
+{
+	// name							group		capture				prepare					function					calls per batch
+	{"LP_GetErrorString",			"api",		NULL,				NULL,					Bench_LP_GetErrorString,	"API_CALLS", 100000},
+	{"TM_Run",						"api",		NULL,				NULL,					Bench_TM_Run,				"API_CALLS", 100000},
+	{"TM_AddParameters",			"api",		NULL,				NULL,					Bench_TM_Parameters,		"API_CALLS", 100000},
+	{"TM_GetDoubleReturn",			"api",		NULL,				Bench_TM_Run,			Bench_TM_GetDoubleReturn,	"API_CALLS", 100000},
+	{"vDUT_Run",					"api",		NULL,				NULL,					Bench_vDUT_Run,				"API_CALLS", 100000},
+	{"vDUT_AddParameters",			"api",		NULL,				NULL,					Bench_vDUT_Parameters,		"API_CALLS", 100000},
+	{"LP_Analyze80211ag",			"analysis",	"WIFI_AG_SIG_FILE",	NULL,					Bench_Analyze80211ag,		NULL, 1},
+	{"LP_AnalyzeFFT",				"analysis",	"WIFI_AG_SIG_FILE",	NULL,					Bench_AnalyzeFFT,			NULL, 1},
+	{"LP_AnalyzeObw",				"analysis",	"WIFI_AG_SIG_FILE",	NULL,					Bench_AnalyzeObw,			NULL, 1},
+	{"LP_AnalyzePower",				"analysis",	"WIFI_AG_SIG_FILE",	NULL,					Bench_AnalyzePower,			NULL, 1},
+	{"LP_FastCalMeasPower",			"analysis",	"WIFI_AG_SIG_FILE",	NULL,					Bench_FastCalPower,			NULL, 1},
+	{"LP_Analyze80211b",			"analysis",	"WIFI_B_SIG_FILE",	NULL,					Bench_Analyze80211b,		NULL, 1},
+	{"LP_Analyze80211ac",			"analysis",	"MIMO_SIG_FILE",	NULL,					Bench_Analyze80211ac,		NULL, 1},
+	{"LP_AnalyzeBluetooth",			"analysis",	"BT_SIG_FILE",		NULL,					Bench_AnalyzeBluetooth,		NULL, 1},
+	{"LP_GetScalarMeasurement",		"fetch",	"WIFI_AG_SIG_FILE",	Bench_Analyze80211ag,	Bench_GetScalarMeasurement,	"FETCH_CALLS", 1000},
+	{"LP_GetVectorMeasurement(hhEst)",	"fetch",	"WIFI_AG_SIG_FILE",	Bench_Analyze80211ag,	Bench_GetVectorFlatness,	"FETCH_CALLS", 1000},
+	{"LP_GetVectorMeasurement(x,y)",	"fetch",	"WIFI_AG_SIG_FILE",	Bench_AnalyzeFFT,		Bench_GetVectorSpectrum,	"FETCH_CALLS", 1000},
+	{"LOGGER_Write",				"logging",	NULL,				NULL,					Bench_LOGGER_Write,			"LOG_LINES", 10000},
+	{"LOGGER_Write_Ext",			"logging",	NULL,				NULL,					Bench_LOGGER_Write_Ext,		"LOG_LINES", 10000},
+	{"LOGGER_Write_Ext(discarded)",	"logging",	NULL,				NULL,					Bench_LOGGER_Write_Ext_Discarded,	"LOG_LINES", 10000},
+	{"LOGGER_Write_Ext(formatted)",	"logging",	NULL,				NULL,					Bench_LOGGER_Write_Ext_Formatted,	"LOG_LINES", 10000},
+};
+
+static double BenchTimeBatch(BENCH_FUNCTION function, int calls, int *err)
+{
+	LARGE_INTEGER frequency, start, stop;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&start);
+	for (int i=0; i<calls && ERR_OK==*err; i++)
+	{
+		*err = function();
+	}
+	QueryPerformanceCounter(&stop);
+
+	return (double)(stop.QuadPart-start.QuadPart)*1e6/(double)frequency.QuadPart/calls;
+}
+
+// Loads the capture of the case unless it is already loaded
+static int BenchLoadCapture(const char *captureKey, string &loadedCapture)
+{
+	char sigFile[MAX_BUFFER_SIZE] = {'\0'};
+	GetPrivateProfileStringA(BENCH_SECTION, captureKey, "", sigFile, MAX_BUFFER_SIZE, BENCH_SETUP_FILE);
+	if ( '\0'==sigFile[0] || INVALID_FILE_ATTRIBUTES==GetFileAttributesA(sigFile) )
+	{
+		return BENCH_ERR_SKIPPED;
+	}
+	else if (loadedCapture==sigFile)
+	{
+		return ERR_OK;
+	}
+	else
+	{
+		loadedCapture = "";
+	}
+
+	int err = LP_LoadVsaSignalFile(sigFile);
+	if (ERR_OK==err)
+	{
+		loadedCapture = sigFile;
+	}
+	return err;
+}
+
+// "name": "...", "usPerCall": ... of each line of an earlier result file
+static void BenchReadBaseline(const char *fileName, map<string, double> &baseline)
+{
+	FILE *fp = NULL;
+	if ( 0!=fopen_s(&fp, fileName, "r") || NULL==fp )
+	{
+		return;
+	}
+
+	char line[MAX_BUFFER_SIZE];
+	const char *nameTag = "\"name\": \"";
+	const char *usTag   = "\"usPerCall\": ";
+	while (NULL!=fgets(line, MAX_BUFFER_SIZE, fp))
+	{
+		char *name = strstr(line, nameTag);
+		char *us   = strstr(line, usTag);
+		char *end  = (NULL==name) ? NULL : strchr(name+strlen(nameTag), '"');
+		if ( NULL!=name && NULL!=us && NULL!=end )
+		{
+			baseline[string(name+strlen(nameTag), end)] = atof(us+strlen(usTag));
+		}
+	}
+	fclose(fp);
+}
+
+static bool BenchWriteResults(const char *fileName, const vector<BENCH_RESULT> &results, double tolerancePercent, int regressions, int failures)
+{
+	FILE *fp = NULL;
+	if ( 0!=fopen_s(&fp, fileName, "w") || NULL==fp )
+	{
+		return false;
+	}
+
+	fprintf(fp, "{\n");
+	fprintf(fp, "  \"suite\": \"IQmeasureTest\",\n");
+	fprintf(fp, "  \"testerType\": %d,\n", ciTesterType);
+	fprintf(fp, "  \"tolerancePercent\": %.1f,\n", tolerancePercent);
+	fprintf(fp, "  \"cases\": [\n");
+	for (size_t i=0;i<results.size();i++)
+	{
+		const BENCH_RESULT &result = results[i];
+		fprintf(fp, "    {\"name\": \"%s\", \"group\": \"%s\", \"calls\": %d, \"usPerCall\": %.3f, \"usPerCallAvg\": %.3f, ",
+				result.name.c_str(), result.group.c_str(), result.calls, result.usPerCall, result.usPerCallAvg);
+		if (0<result.baselineUs)
+		{
+			fprintf(fp, "\"baselineUs\": %.3f, ", result.baselineUs);
+		}
+		else
+		{
+			fprintf(fp, "\"baselineUs\": null, ");
+		}
+		fprintf(fp, "\"status\": \"%s\"}%s\n", result.status.c_str(), (i+1<results.size()) ? "," : "");
+	}
+	fprintf(fp, "  ],\n");
+	fprintf(fp, "  \"regressions\": %d,\n", regressions);
+	fprintf(fp, "  \"failures\": %d\n", failures);
+	fprintf(fp, "}\n");
+	fclose(fp);
+
+	return true;
+}
+
+//! Runs the benchmark suite, returns the number of regressions and failed cases (-1 if the suite cannot run)
+int Benchmark_Suite(bool writeBaseline)
+{
+	char resultFile[MAX_BUFFER_SIZE]   = {'\0'};
+	char baselineFile[MAX_BUFFER_SIZE] = {'\0'};
+	char buffer[MAX_BUFFER_SIZE]       = {'\0'};
+
+	ciTesterType        = GetPrivateProfileIntA("TESTER_SETUP", "TESTER_TYPE", 0, BENCH_SETUP_FILE);
+	ciTesterControlMode = GetPrivateProfileIntA("TESTER_SETUP", "TESTER_CONTROL_MODE", 0, BENCH_SETUP_FILE);
+	int numRun = GetPrivateProfileIntA(BENCH_SECTION, "SUITE_RUNS", 5, BENCH_SETUP_FILE);
+	numRun = (0<numRun) ? numRun : 1;
+	GetPrivateProfileStringA(BENCH_SECTION, "RESULT_FILE", "Log\\Benchmark.json", resultFile, MAX_BUFFER_SIZE, BENCH_SETUP_FILE);
+	GetPrivateProfileStringA(BENCH_SECTION, "BASELINE_FILE", "Benchmark_Baseline.json", baselineFile, MAX_BUFFER_SIZE, BENCH_SETUP_FILE);
+	GetPrivateProfileStringA(BENCH_SECTION, "TOLERANCE_PERCENT", "10", buffer, MAX_BUFFER_SIZE, BENCH_SETUP_FILE);
+	double tolerancePercent = atof(buffer);
+
+	_mkdir(".\\Log");
+	map<string, double> baseline;
+	BenchReadBaseline(baselineFile, baseline);
+
+	if (ERR_OK!=LP_Init(ciTesterType, ciTesterControlMode))
+	{
+		printf("[BENCHMARK] LP_Init() returned error.\n");
+		return -1;
+	}
+	if ( TM_ERR_OK!=::TM_RegisterTechnology(BENCH_TECHNOLOGY, &g_benchTmId) ||
+		 TM_ERR_OK!=::TM_InstallCallbackFunction(g_benchTmId, BENCH_TM_NOP_KEYWORD, BenchTmNop) )
+	{
+		printf("[BENCHMARK] Fail to install %s of TestManager %s.\n", BENCH_TM_NOP_KEYWORD, BENCH_TECHNOLOGY);
+		::TM_UnregisterTechnology(BENCH_TECHNOLOGY);
+		LP_Term();
+		return -1;
+	}
+	else if ( vDUT_ERR_OK!=::vDUT_RegisterTechnology(BENCH_TECHNOLOGY, &g_benchDutId) ||
+			  vDUT_ERR_OK!=::vDUT_InstallCallbackFunction(g_benchDutId, BENCH_DUT_NOP_KEYWORD, BenchDutNop) )
+	{
+		printf("[BENCHMARK] Fail to install %s of vDUT %s.\n", BENCH_DUT_NOP_KEYWORD, BENCH_TECHNOLOGY);
+		::TM_UnregisterTechnology(BENCH_TECHNOLOGY);
+		::vDUT_UnregisterTechnology(BENCH_TECHNOLOGY);
+		LP_Term();
+		return -1;
+	}
+	::LOGGER_CreateLogger("IQmeasure_Bench", &g_benchLoggerId, "Benchmark");
+
+	vector<BENCH_RESULT> results;
+	string loadedCapture;
+	int regressions = 0;
+	int failures    = 0;
+	for (size_t i=0;i<sizeof(g_benchCases)/sizeof(g_benchCases[0]);i++)
+	{
+		const BENCH_CASE &benchCase = g_benchCases[i];
+		BENCH_RESULT result;
+		result.name         = benchCase.name;
+		result.group        = benchCase.group;
+		result.calls        = (NULL==benchCase.callsKey) ? 1 : GetPrivateProfileIntA(BENCH_SECTION, benchCase.callsKey, benchCase.callsDefault, BENCH_SETUP_FILE);
+		result.calls        = (0<result.calls) ? result.calls : 1;
+		result.usPerCall    = 0.0;
+		result.usPerCallAvg = 0.0;
+		result.baselineUs   = (baseline.end()!=baseline.find(result.name)) ? baseline[result.name] : 0.0;
+
+		int err = (NULL==benchCase.captureKey) ? ERR_OK : BenchLoadCapture(benchCase.captureKey, loadedCapture);
+		if ( ERR_OK==err && NULL!=benchCase.prepare )
+		{
+			err = benchCase.prepare();
+		}
+		// The first call is not timed: it loads the DLLs and fills the caches a test run has warm
+		if (ERR_OK==err)
+		{
+			err = benchCase.function();
+		}
+
+		for (int iRun=0; iRun<numRun && ERR_OK==err; iRun++)
+		{
+			double usPerCall = BenchTimeBatch(benchCase.function, result.calls, &err);
+			result.usPerCall     = (0==iRun || usPerCall<result.usPerCall) ? usPerCall : result.usPerCall;
+			result.usPerCallAvg += usPerCall/numRun;
+		}
+
+		if (BENCH_ERR_SKIPPED==err)
+		{
+			result.status = "skipped";
+		}
+		else if (ERR_OK!=err)
+		{
+			result.status = "failed";
+			failures++;
+		}
+		else if (0>=result.baselineUs)
+		{
+			result.status = "new";
+		}
+		else if ( result.usPerCall>result.baselineUs*(1.0+tolerancePercent/100.0) )
+		{
+			result.status = "regression";
+			regressions++;
+		}
+		else
+		{
+			result.status = "ok";
+		}
+		results.push_back(result);
+
+		printf("[BENCHMARK] %-32s %-9s %12.3f us/call  %s\n", result.name.c_str(), result.group.c_str(), result.usPerCall, result.status.c_str());
+		::LOGGER_Write(g_benchLoggerId, LOGGER_INFORMATION, "[BENCHMARK],%s,%s,%.3f,us,%s\n", result.name.c_str(), result.group.c_str(), result.usPerCall, result.status.c_str());
+	}
+
+	::TM_UnregisterTechnology(BENCH_TECHNOLOGY);
+	::vDUT_UnregisterTechnology(BENCH_TECHNOLOGY);
+	LP_Term();
+
+	if ( !BenchWriteResults(resultFile, results, tolerancePercent, regressions, failures) ||
+		 ( writeBaseline && !BenchWriteResults(baselineFile, results, tolerancePercent, 0, failures) ) )
+	{
+		printf("[BENCHMARK] Fail to write the results.\n");
+		return -1;
+	}
+
+	printf("[BENCHMARK] %d regression(s) against %s, %d failed case(s), results in %s%s\n", regressions, baselineFile, failures, resultFile, writeBaseline ? ", baseline updated" : "");
+	return writeBaseline ? failures : regressions+failures;
+}
@@ -1,7 +1,6 @@
 #include "stdafx.h"
 #include "iqapi.h"
 #include "IQmeasure.h"
-#include "DebugAlloc.h"
 #include "math.h"
 #include "time.h"
 #include "vector"
@@ -0,0 +1,581 @@
+// Capture archive
+//
+// Saves VSA captures for failure analysis off the test critical path.  The caller
+// only pays for a host-memory snapshot of the capture; a background thread does the
+// encoding, the disk write, the index file and the disk quota.
+//
+// Archive file (.iqz) layout, little-endian:
+//   char[8]  "LPIQZ01"
+//   int      vsaCount
+//   per VSA: int length, double sampleFreqHz, then ceil(length/CAPTURE_ARCHIVE_BLOCK) blocks of
+//            { float scale, short iq[2*blockLength] }   (I0,Q0,I1,Q1,...; sample = iq*scale)
+//
+// Block-scaled 16 bit I/Q is 4x smaller than the double samples of a .sig file and keeps
+// the resolution of quiet gaps next to the bursts.  LP_CaptureArchiveRestore() converts
+// an archive file back to a .sig file.
+
+#include "stdafx.h"
+#include "IQmeasure.h"
+#include "IQlite_Logger.h"
+#include "CaptureIndex.h"
+#include <math.h>
+#include <direct.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+#ifndef CAPTURE_ARCHIVE_MAX_VSA
+#define CAPTURE_ARCHIVE_MAX_VSA		4
+#endif
+
+#ifndef CAPTURE_ARCHIVE_BLOCK
+#define CAPTURE_ARCHIVE_BLOCK		1024		// samples per scale factor
+#endif
+
+#ifndef CAPTURE_ARCHIVE_MAX_PENDING
+#define CAPTURE_ARCHIVE_MAX_PENDING	16			// snapshots waiting for the writer, newer ones are dropped
+#endif
+
+#define CAPTURE_ARCHIVE_MAGIC		"LPIQZ01"
+#define CAPTURE_ARCHIVE_INDEX		"capture_index.csv"
+
+using namespace std;
+
+// These global variables are declared in IQmeasure.cpp
+extern int *LP_loggerIQmeasure_Ptr;
+extern int  g_IQtype;
+
+// Block-scaled 16-bit encoder, implemented in IQmeasure_Compact.cpp
+void CompactEncodeInt16(const double *real, const double *imag, int sampleCount, short *iq, double *scale);
+
+struct tagArchiveJob
+{
+	string	fileName;						// full path without extension
+	string	dutSerial;
+	string	testItem;
+	string	timeStamp;
+	int		vsaCount;						// 0: file already written by LP_SaveVsaSignalFile(), bookkeeping only
+	int		length[CAPTURE_ARCHIVE_MAX_VSA];
+	double	sampleFreqHz[CAPTURE_ARCHIVE_MAX_VSA];
+	double	*real[CAPTURE_ARCHIVE_MAX_VSA];
+	double	*imag[CAPTURE_ARCHIVE_MAX_VSA];
+};
+
+struct tagArchivedFile
+{
+	string	fileName;
+	__int64	bytes;
+};
+
+struct tagCaptureArchive
+{
+	bool					started;
+	bool					stopRequest;
+	char					archivePath[MAX_PATH];
+	__int64					quotaBytes;
+	__int64					usedBytes;
+	int						droppedCount;
+	HANDLE					thread;
+	HANDLE					jobEvent;		// auto-reset, a job was queued or stop requested
+	HANDLE					idleEvent;		// manual-reset, set while the queue is empty and nothing is being written
+	CRITICAL_SECTION		lock;
+	deque<tagArchiveJob*>	jobs;
+	deque<tagArchivedFile>	files;			// oldest first, for the quota
+} g_CaptureArchive;
+
+static void ArchiveLog(LOGGER_LEVEL level, const char *format, const char *detail)
+{
+	if (NULL!=LP_loggerIQmeasure_Ptr)
+	{
+		::LOGGER_Write_Ext(LOG_IQMEASURE, *LP_loggerIQmeasure_Ptr, level, format, detail);
+	}
+	else
+	{
+		// do nothing
+	}
+}
+
+static __int64 ArchiveFileBytes(const char *fileName)
+{
+	WIN32_FILE_ATTRIBUTE_DATA fileInfo;
+	if (GetFileAttributesExA(fileName, GetFileExInfoStandard, &fileInfo))
+	{
+		return ((__int64)fileInfo.nFileSizeHigh<<32) + fileInfo.nFileSizeLow;
+	}
+	else
+	{
+		return -1;
+	}
+}
+
+static void ArchiveFreeJob(tagArchiveJob *job)
+{
+	for (int i=0;i<job->vsaCount;i++)
+	{
+		delete [] job->real[i];
+		delete [] job->imag[i];
+	}
+	delete job;
+}
+
+// Rebuild the list of archived files from the index of a previous run, so the quota covers them as well
+static void ArchiveLoadIndex(void)
+{
+	char indexFile[MAX_PATH];
+	char line[MAX_PATH*2];
+	FILE *fp = NULL;
+	vector<string> fields;
+
+	g_CaptureArchive.files.clear();
+	g_CaptureArchive.usedBytes = 0;
+
+	sprintf_s(indexFile, MAX_PATH, "%s/%s", g_CaptureArchive.archivePath, CAPTURE_ARCHIVE_INDEX);
+	if ( 0!=fopen_s(&fp, indexFile, "r") || NULL==fp )
+	{
+		return;
+	}
+
+	while (NULL!=fgets(line, sizeof(line), fp))
+	{
+		// Timestamp,DUT_Serial,Test_Item,File,Bytes
+		CaptureIndexSplit(line, fields);
+		if (CAPTURE_INDEX_FILE_COLUMN+1>=fields.size()) continue;
+
+		__int64 bytes = ArchiveFileBytes(fields[CAPTURE_INDEX_FILE_COLUMN].c_str());
+		if (0<=bytes)
+		{
+			tagArchivedFile archived;
+			archived.fileName = fields[CAPTURE_INDEX_FILE_COLUMN];
+			archived.bytes    = bytes;
+			g_CaptureArchive.files.push_back(archived);
+			g_CaptureArchive.usedBytes += bytes;
+		}
+		else
+		{
+			// deleted by the quota or by hand
+		}
+	}
+	fclose(fp);
+}
+
+static void ArchiveAppendIndex(const tagArchiveJob *job, const char *fileName, __int64 bytes)
+{
+	char indexFile[MAX_PATH];
+	FILE *fp = NULL;
+
+	sprintf_s(indexFile, MAX_PATH, "%s/%s", g_CaptureArchive.archivePath, CAPTURE_ARCHIVE_INDEX);
+	bool newIndex = (0>ArchiveFileBytes(indexFile));
+	if ( 0!=fopen_s(&fp, indexFile, "a") || NULL==fp )
+	{
+		ArchiveLog(LOGGER_ERROR, "[IQMEASURE],[CAPTURE_ARCHIVE],Fail to open %s\n", indexFile);
+		return;
+	}
+
+	if (newIndex)
+	{
+		fprintf(fp, "%s\n", CAPTURE_INDEX_HEADER);
+	}
+	fprintf(fp, "%s,%s,%s,%s,%I64d\n", CaptureIndexField(job->timeStamp.c_str()).c_str(), CaptureIndexField(job->dutSerial.c_str()).c_str(),
+			CaptureIndexField(job->testItem.c_str()).c_str(), CaptureIndexField(fileName).c_str(), bytes);
+	fclose(fp);
+}
+
+// Takes the oldest files over the quota off the list, under the lock; the caller deletes them after it
+static void ArchiveEnforceQuota(vector<string> &overQuota)
+{
+	while ( 0<g_CaptureArchive.quotaBytes && g_CaptureArchive.usedBytes>g_CaptureArchive.quotaBytes && 1<g_CaptureArchive.files.size() )
+	{
+		tagArchivedFile oldest = g_CaptureArchive.files.front();
+		g_CaptureArchive.files.pop_front();
+		g_CaptureArchive.usedBytes -= oldest.bytes;
+
+		overQuota.push_back(oldest.fileName);
+	}
+}
+
+static void ArchiveDeleteFiles(const vector<string> &overQuota)
+{
+	for (size_t i=0;i<overQuota.size();i++)
+	{
+		DeleteFileA(overQuota[i].c_str());
+		ArchiveLog(LOGGER_INFORMATION, "[IQMEASURE],[CAPTURE_ARCHIVE],Quota reached, %s deleted\n", overQuota[i].c_str());
+	}
+}
+
+static int ArchiveWriteIqz(const tagArchiveJob *job, const char *fileName)
+{
+	FILE  *fp = NULL;
+	double fullScale;
+	float  scale;
+	short  iq[2*CAPTURE_ARCHIVE_BLOCK];
+
+	if ( 0!=fopen_s(&fp, fileName, "wb") || NULL==fp )
+	{
+		return ERR_SAVE_WAVE_FAILED;
+	}
+
+	fwrite(CAPTURE_ARCHIVE_MAGIC, 1, 8, fp);
+	fwrite(&job->vsaCount, sizeof(int), 1, fp);
+
+	for (int vsa=0;vsa<job->vsaCount;vsa++)
+	{
+		fwrite(&job->length[vsa], sizeof(int), 1, fp);
+		fwrite(&job->sampleFreqHz[vsa], sizeof(double), 1, fp);
+
+		for (int start=0;start<job->length[vsa];start+=CAPTURE_ARCHIVE_BLOCK)
+		{
+			int blockLength = min(CAPTURE_ARCHIVE_BLOCK, job->length[vsa]-start);
+
+			CompactEncodeInt16(&job->real[vsa][start], &job->imag[vsa][start], blockLength, iq, &fullScale);
+			scale = (float)(fullScale/32767.0);
+
+			fwrite(&scale, sizeof(float), 1, fp);
+			fwrite(iq, sizeof(short), 2*blockLength, fp);
+		}
+	}
+
+	int err = ferror(fp) ? ERR_SAVE_WAVE_FAILED : ERR_OK;
+	fclose(fp);
+
+	return err;
+}
+
+static DWORD WINAPI ArchiveWorker(LPVOID)
+{
+	while (true)
+	{
+		tagArchiveJob *job = NULL;
+
+		EnterCriticalSection(&g_CaptureArchive.lock);
+		if (!g_CaptureArchive.jobs.empty())
+		{
+			job = g_CaptureArchive.jobs.front();
+			g_CaptureArchive.jobs.pop_front();
+		}
+		else
+		{
+			SetEvent(g_CaptureArchive.idleEvent);
+		}
+		bool stop = g_CaptureArchive.stopRequest;
+		LeaveCriticalSection(&g_CaptureArchive.lock);
+
+		if (NULL==job)
+		{
+			if (stop) break;
+			WaitForSingleObject(g_CaptureArchive.jobEvent, INFINITE);
+			continue;
+		}
+
+		char fileName[MAX_PATH];
+		int  err = ERR_OK;
+		if (0<job->vsaCount)
+		{
+			sprintf_s(fileName, MAX_PATH, "%s.iqz", job->fileName.c_str());
+			err = ArchiveWriteIqz(job, fileName);
+		}
+		else
+		{
+			sprintf_s(fileName, MAX_PATH, "%s", job->fileName.c_str());
+		}
+
+		if (ERR_OK==err)
+		{
+			tagArchivedFile archived;
+			archived.fileName = fileName;
+			archived.bytes    = max((__int64)0, ArchiveFileBytes(fileName));
+
+			ArchiveAppendIndex(job, fileName, archived.bytes);
+
+			vector<string> overQuota;
+			EnterCriticalSection(&g_CaptureArchive.lock);
+			g_CaptureArchive.files.push_back(archived);
+			g_CaptureArchive.usedBytes += archived.bytes;
+			ArchiveEnforceQuota(overQuota);
+			LeaveCriticalSection(&g_CaptureArchive.lock);
+
+			// LP_CaptureArchiveSave() does not wait for the disk while the files are deleted
+			ArchiveDeleteFiles(overQuota);
+		}
+		else
+		{
+			ArchiveLog(LOGGER_ERROR, "[IQMEASURE],[CAPTURE_ARCHIVE],Fail to write %s\n", fileName);
+		}
+
+		ArchiveFreeJob(job);
+	}
+
+	return 0;
+}
+
+IQMEASURE_API int LP_CaptureArchiveStart(char *archivePath, int quotaMB)
+{
+	if (g_CaptureArchive.started)
+	{
+		// Already running, only the quota may change
+		EnterCriticalSection(&g_CaptureArchive.lock);
+		g_CaptureArchive.quotaBytes = (__int64)quotaMB*1024*1024;
+		LeaveCriticalSection(&g_CaptureArchive.lock);
+		return ERR_OK;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	if ( NULL==archivePath || '\0'==archivePath[0] )
+	{
+		strcpy_s(g_CaptureArchive.archivePath, MAX_PATH, "./log");
+	}
+	else
+	{
+		strcpy_s(g_CaptureArchive.archivePath, MAX_PATH, archivePath);
+	}
+	_mkdir(g_CaptureArchive.archivePath);
+
+	g_CaptureArchive.quotaBytes   = (__int64)quotaMB*1024*1024;
+	g_CaptureArchive.droppedCount = 0;
+	g_CaptureArchive.stopRequest  = false;
+	ArchiveLoadIndex();
+
+	InitializeCriticalSection(&g_CaptureArchive.lock);
+	g_CaptureArchive.jobEvent  = CreateEvent(NULL, FALSE, FALSE, NULL);
+	g_CaptureArchive.idleEvent = CreateEvent(NULL, TRUE, TRUE, NULL);
+	g_CaptureArchive.thread    = CreateThread(NULL, 0, ArchiveWorker, NULL, 0, NULL);
+	if (NULL==g_CaptureArchive.thread)
+	{
+		CloseHandle(g_CaptureArchive.jobEvent);
+		CloseHandle(g_CaptureArchive.idleEvent);
+		DeleteCriticalSection(&g_CaptureArchive.lock);
+		return ERR_GENERAL_ERR;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	// Below normal, so the writer never competes with the test for the CPU
+	SetThreadPriority(g_CaptureArchive.thread, THREAD_PRIORITY_BELOW_NORMAL);
+	g_CaptureArchive.started = true;
+
+	return ERR_OK;
+}
+
+IQMEASURE_API int LP_CaptureArchiveSave(char *fileName, char *dutSerial, char *testItem)
+{
+	int    err = ERR_OK;
+	double *real[CAPTURE_ARCHIVE_MAX_VSA]         = {NULL};
+	double *imag[CAPTURE_ARCHIVE_MAX_VSA]         = {NULL};
+	int    length[CAPTURE_ARCHIVE_MAX_VSA]        = {0};
+	double sampleFreqHz[CAPTURE_ARCHIVE_MAX_VSA]  = {0.0};
+	char   timeStamp[MAX_PATH];
+	char   fullName[MAX_PATH];
+
+	if (!g_CaptureArchive.started)
+	{
+		err = LP_CaptureArchiveStart(NULL, 0);
+		if (ERR_OK!=err) return err;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	SYSTEMTIME sysTime;
+	::GetLocalTime(&sysTime);
+	sprintf_s(timeStamp, MAX_PATH, "%d.%d.%d-%d.%d.%d.%d", sysTime.wYear, sysTime.wMonth, sysTime.wDay, sysTime.wHour, sysTime.wMinute, sysTime.wSecond, sysTime.wMilliseconds);
+	sprintf_s(fullName, MAX_PATH, "%s/%s-%s", g_CaptureArchive.archivePath, fileName, timeStamp);
+
+	tagArchiveJob *job = new tagArchiveJob;
+	job->fileName  = fullName;
+	job->dutSerial = (NULL!=dutSerial) ? dutSerial : "";
+	job->testItem  = (NULL!=testItem) ? testItem : fileName;
+	job->timeStamp = timeStamp;
+	job->vsaCount  = 0;
+
+	// Only the IQapi (IQ2010/IQview/IQflex) backend keeps the capture in host memory
+	if ( ERR_OK==LP_GetHndlDataPointers(real, imag, length, sampleFreqHz, CAPTURE_ARCHIVE_MAX_VSA) )
+	{
+		for (int i=0;i<CAPTURE_ARCHIVE_MAX_VSA && NULL!=real[i] && NULL!=imag[i] && 0<length[i];i++)
+		{
+			// The snapshot is the only copy made on the caller's thread
+			job->length[i]       = length[i];
+			job->sampleFreqHz[i] = sampleFreqHz[i];
+			job->real[i]         = new double[length[i]];
+			job->imag[i]         = new double[length[i]];
+			memcpy(job->real[i], real[i], length[i]*sizeof(double));
+			memcpy(job->imag[i], imag[i], length[i]*sizeof(double));
+			job->vsaCount++;
+		}
+	}
+	else
+	{
+		// do nothing
+	}
+
+	if (0==job->vsaCount)
+	{
+		// The capture lives in the tester (SCPI), it can only be saved in place; index and quota still go to the writer
+		job->fileName += (0==g_IQtype) ? ".sig" : ".iqvsa";
+		err = LP_SaveVsaSignalFile((char*)job->fileName.c_str());
+		if (ERR_OK!=err)
+		{
+			ArchiveFreeJob(job);
+			return err;
+		}
+		else
+		{
+			// do nothing
+		}
+	}
+	else
+	{
+		// do nothing
+	}
+
+	EnterCriticalSection(&g_CaptureArchive.lock);
+	if ( 0<job->vsaCount && CAPTURE_ARCHIVE_MAX_PENDING<=g_CaptureArchive.jobs.size() )
+	{
+		// Writer cannot keep up, never make the test wait for it
+		g_CaptureArchive.droppedCount++;
+		LeaveCriticalSection(&g_CaptureArchive.lock);
+
+		ArchiveLog(LOGGER_WARNING, "[IQMEASURE],[CAPTURE_ARCHIVE],Writer busy, %s dropped\n", fullName);
+		ArchiveFreeJob(job);
+		return ERR_SAVE_WAVE_FAILED;
+	}
+	else
+	{
+		ResetEvent(g_CaptureArchive.idleEvent);
+		g_CaptureArchive.jobs.push_back(job);
+		LeaveCriticalSection(&g_CaptureArchive.lock);
+		SetEvent(g_CaptureArchive.jobEvent);
+	}
+
+	return ERR_OK;
+}
+
+IQMEASURE_API int LP_CaptureArchiveFlush(int timeoutMs)
+{
+	if (!g_CaptureArchive.started)
+	{
+		return ERR_OK;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	DWORD ret = WaitForSingleObject(g_CaptureArchive.idleEvent, (0>timeoutMs) ? INFINITE : (DWORD)timeoutMs);
+
+	return (WAIT_OBJECT_0==ret) ? ERR_OK : ERR_GENERAL_ERR;
+}
+
+IQMEASURE_API int LP_CaptureArchiveStop(void)
+{
+	if (!g_CaptureArchive.started)
+	{
+		return ERR_OK;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	// The worker drains the queue before it exits
+	EnterCriticalSection(&g_CaptureArchive.lock);
+	g_CaptureArchive.stopRequest = true;
+	LeaveCriticalSection(&g_CaptureArchive.lock);
+	SetEvent(g_CaptureArchive.jobEvent);
+
+	WaitForSingleObject(g_CaptureArchive.thread, INFINITE);
+	CloseHandle(g_CaptureArchive.thread);
+	CloseHandle(g_CaptureArchive.jobEvent);
+	CloseHandle(g_CaptureArchive.idleEvent);
+	DeleteCriticalSection(&g_CaptureArchive.lock);
+
+	if (0<g_CaptureArchive.droppedCount)
+	{
+		char dropped[MAX_PATH];
+		sprintf_s(dropped, MAX_PATH, "%d", g_CaptureArchive.droppedCount);
+		ArchiveLog(LOGGER_WARNING, "[IQMEASURE],[CAPTURE_ARCHIVE],%s captures dropped, writer too slow\n", dropped);
+	}
+	else
+	{
+		// do nothing
+	}
+
+	g_CaptureArchive.files.clear();
+	g_CaptureArchive.started = false;
+
+	return ERR_OK;
+}
+
+IQMEASURE_API int LP_CaptureArchiveRestore(char *archiveFile, char *sigFileName)
+{
+	int    err = ERR_OK;
+	FILE   *fp = NULL;
+	char   magic[8];
+	int    vsaCount = 0;
+	double *real[CAPTURE_ARCHIVE_MAX_VSA]        = {NULL};
+	double *imag[CAPTURE_ARCHIVE_MAX_VSA]        = {NULL};
+	int    length[CAPTURE_ARCHIVE_MAX_VSA]       = {0};
+	double sampleFreqHz[CAPTURE_ARCHIVE_MAX_VSA] = {0.0};
+	float  scale;
+	short  iq[2*CAPTURE_ARCHIVE_BLOCK];
+
+	if ( 0!=fopen_s(&fp, archiveFile, "rb") || NULL==fp )
+	{
+		return ERR_SAVE_WAVE_FAILED;
+	}
+
+	if ( 8!=fread(magic, 1, 8, fp) || 0!=memcmp(magic, CAPTURE_ARCHIVE_MAGIC, 8) ||
+		 1!=fread(&vsaCount, sizeof(int), 1, fp) || 0>=vsaCount || CAPTURE_ARCHIVE_MAX_VSA<vsaCount )
+	{
+		fclose(fp);
+		return ERR_SAVE_WAVE_FAILED;
+	}
+
+	for (int vsa=0;vsa<vsaCount && ERR_OK==err;vsa++)
+	{
+		if ( 1!=fread(&length[vsa], sizeof(int), 1, fp) || 1!=fread(&sampleFreqHz[vsa], sizeof(double), 1, fp) || 0>=length[vsa] )
+		{
+			err = ERR_SAVE_WAVE_FAILED;
+			break;
+		}
+
+		real[vsa] = new double[length[vsa]];
+		imag[vsa] = new double[length[vsa]];
+		for (int start=0;start<length[vsa];start+=CAPTURE_ARCHIVE_BLOCK)
+		{
+			int blockLength = min(CAPTURE_ARCHIVE_BLOCK, length[vsa]-start);
+			if ( 1!=fread(&scale, sizeof(float), 1, fp) || (size_t)(2*blockLength)!=fread(iq, sizeof(short), 2*blockLength, fp) )
+			{
+				err = ERR_SAVE_WAVE_FAILED;
+				break;
+			}
+			for (int i=0;i<blockLength;i++)
+			{
+				real[vsa][start+i] = iq[2*i]*(double)scale;
+				imag[vsa][start+i] = iq[2*i+1]*(double)scale;
+			}
+		}
+	}
+	fclose(fp);
+
+	if (ERR_OK==err)
+	{
+		err = LP_SaveUserDataToSigFile(sigFileName, real, imag, length, sampleFreqHz, vsaCount);
+	}
+	else
+	{
+		// do nothing
+	}
+
+	for (int vsa=0;vsa<vsaCount;vsa++)
+	{
+		delete [] real[vsa];
+		delete [] imag[vsa];
+	}
+
+	return err;
+}
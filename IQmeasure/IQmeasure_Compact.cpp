@@ -0,0 +1,300 @@
+// Compact capture samples
+//
+// The IQapi handle keeps every capture as separate double I and Q arrays, 16
+// bytes per complex sample.  The functions below hand the capture out, save it
+// and load it back as interleaved float (8 bytes) or 16-bit integer (4 bytes)
+// I/Q, so a host that keeps many captures or long multi-stream captures holds
+// a half or a quarter of the memory.  Conversion to double is done on demand,
+// a block at a time, with LP_CompactToDouble().
+//
+// A 16-bit capture is scaled per stream: full scale (32767) is the largest |I|
+// or |Q| of the stream, returned as "scale".  The quantization noise is about
+// 90 dB below full scale, well below the EVM floor of the testers.  The capture
+// archive (.iqz) uses the same encoder, CompactEncodeInt16(), one block at a time.
+//
+// Compact capture file (.iqc), little endian:
+//   IQ_COMPACT_FILE_HEADER, then the interleaved samples of stream 0, 1, ...
+
+#include "stdafx.h"
+#include "IQmeasure.h"
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+using namespace std;
+
+#define IQ_COMPACT_MAX_STREAMS		4
+#define IQ_COMPACT_INT16_FULL_SCALE	32767.0
+#define IQ_COMPACT_BLOCK_SAMPLES	65536		// samples converted to double at a time when loading a file
+
+#ifndef IQ_COMPACT_MAX_SAMPLES
+#define IQ_COMPACT_MAX_SAMPLES		(16*1024*1024)	// per stream, longer than any tester capture; a larger length in a file is corrupt
+#endif
+
+static const char g_compactFileMagic[4] = {'I','Q','C','1'};
+
+typedef struct tagCompactFileHeader
+{
+	char	magic[4];
+	int		iqFormat;
+	int		streamNum;
+	int		length[IQ_COMPACT_MAX_STREAMS];
+	double	sampleFreqHz[IQ_COMPACT_MAX_STREAMS];
+	double	scale[IQ_COMPACT_MAX_STREAMS];
+} IQ_COMPACT_FILE_HEADER;
+
+static int CompactSampleBytes(int iqFormat)
+{
+	if (IQ_FORMAT_INT16==iqFormat)
+		return 2*sizeof(short);
+	else if (IQ_FORMAT_FLOAT32==iqFormat)
+		return 2*sizeof(float);
+	else
+		return 0;
+}
+
+// Interleaved 16-bit I/Q of a block of samples, 32767 = the largest |I| or |Q| of the block, returned as scale.
+// Also used by the capture archive (IQmeasure_CaptureArchive.cpp).
+void CompactEncodeInt16(const double *real, const double *imag, int sampleCount, short *iq, double *scale)
+{
+	double maxAbs = 0.0;
+	for (int i=0;i<sampleCount;i++)
+	{
+		if (fabs(real[i])>maxAbs) maxAbs = fabs(real[i]);
+		if (fabs(imag[i])>maxAbs) maxAbs = fabs(imag[i]);
+	}
+	*scale = (0.0<maxAbs) ? maxAbs : 1.0;
+
+	double gain = IQ_COMPACT_INT16_FULL_SCALE/(*scale);
+	for (int i=0;i<sampleCount;i++)
+	{
+		iq[2*i]   = (short)floor(real[i]*gain+0.5);
+		iq[2*i+1] = (short)floor(imag[i]*gain+0.5);
+	}
+}
+
+static void DoubleToCompact(int iqFormat, double *real, double *imag, int sampleCount, void *bufferIQ, double *scale)
+{
+	if (IQ_FORMAT_INT16==iqFormat)
+	{
+		CompactEncodeInt16(real, imag, sampleCount, (short*)bufferIQ, scale);
+	}
+	else
+	{
+		*scale = 1.0;
+
+		float *iq = (float*)bufferIQ;
+		for (int i=0;i<sampleCount;i++)
+		{
+			iq[2*i]   = (float)real[i];
+			iq[2*i+1] = (float)imag[i];
+		}
+	}
+}
+
+IQMEASURE_API int LP_CompactToDouble(int iqFormat, void *bufferIQ, int sampleCount, double scale, double bufferReal[], double bufferImag[])
+{
+	if (NULL==bufferIQ || NULL==bufferReal || NULL==bufferImag || 0==CompactSampleBytes(iqFormat))
+	{
+		return ERR_ANALYSIS_NULL_POINTER;
+	}
+
+	if (IQ_FORMAT_INT16==iqFormat)
+	{
+		short *iq = (short*)bufferIQ;
+		double gain = scale/IQ_COMPACT_INT16_FULL_SCALE;
+		for (int i=0;i<sampleCount;i++)
+		{
+			bufferReal[i] = iq[2*i]*gain;
+			bufferImag[i] = iq[2*i+1]*gain;
+		}
+	}
+	else
+	{
+		float *iq = (float*)bufferIQ;
+		for (int i=0;i<sampleCount;i++)
+		{
+			bufferReal[i] = iq[2*i];
+			bufferImag[i] = iq[2*i+1];
+		}
+	}
+
+	return ERR_OK;
+}
+
+IQMEASURE_API int LP_GetSampleDataCompact(int vsaNum, int iqFormat, void *bufferIQ, int bufferSamples, int *sampleCount, double *scale)
+{
+	double	*real[IQ_COMPACT_MAX_STREAMS] = {NULL};
+	double	*imag[IQ_COMPACT_MAX_STREAMS] = {NULL};
+	int		length[IQ_COMPACT_MAX_STREAMS] = {0};
+	double	sampleFreqHz[IQ_COMPACT_MAX_STREAMS] = {0.0};
+
+	if (NULL==bufferIQ || NULL==sampleCount || NULL==scale || 0==CompactSampleBytes(iqFormat))
+	{
+		return ERR_ANALYSIS_NULL_POINTER;
+	}
+	if (0>vsaNum || IQ_COMPACT_MAX_STREAMS<=vsaNum)
+	{
+		return ERR_VSA_NUM_OUT_OF_RANGE;
+	}
+
+	// The handle arrays are read in place, no double copy of the capture is made
+	int err = LP_GetHndlDataPointers(real, imag, length, sampleFreqHz, IQ_COMPACT_MAX_STREAMS);
+	if (ERR_OK!=err)
+	{
+		return err;
+	}
+	if (NULL==real[vsaNum] || NULL==imag[vsaNum] || 0>=length[vsaNum])
+	{
+		return ERR_NO_CAPTURE_DATA;
+	}
+	if (length[vsaNum]>bufferSamples)
+	{
+		*sampleCount = length[vsaNum];
+		return ERR_BUFFER_OVERFLOW;
+	}
+
+	DoubleToCompact(iqFormat, real[vsaNum], imag[vsaNum], length[vsaNum], bufferIQ, scale);
+	*sampleCount = length[vsaNum];
+
+	return ERR_OK;
+}
+
+IQMEASURE_API int LP_SaveCaptureCompact(char *fileName, int iqFormat)
+{
+	double	*real[IQ_COMPACT_MAX_STREAMS] = {NULL};
+	double	*imag[IQ_COMPACT_MAX_STREAMS] = {NULL};
+	IQ_COMPACT_FILE_HEADER header;
+
+	if (NULL==fileName || 0==CompactSampleBytes(iqFormat))
+	{
+		return ERR_ANALYSIS_NULL_POINTER;
+	}
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, g_compactFileMagic, sizeof(header.magic));
+	header.iqFormat = iqFormat;
+
+	int err = LP_GetHndlDataPointers(real, imag, header.length, header.sampleFreqHz, IQ_COMPACT_MAX_STREAMS);
+	if (ERR_OK!=err)
+	{
+		return err;
+	}
+	for (header.streamNum=0; header.streamNum<IQ_COMPACT_MAX_STREAMS; header.streamNum++)
+	{
+		if (NULL==real[header.streamNum] || 0>=header.length[header.streamNum])
+			break;
+	}
+	if (0==header.streamNum)
+	{
+		return ERR_NO_CAPTURE_DATA;
+	}
+
+	FILE *fp = NULL;
+	if (0!=fopen_s(&fp, fileName, "wb") || NULL==fp)
+	{
+		return ERR_SAVE_WAVE_FAILED;
+	}
+
+	// The header is written again once the scales are known
+	err = ERR_OK;
+	fwrite(&header, sizeof(header), 1, fp);
+	vector<char> bufferIQ;
+	for (int i=0;i<header.streamNum;i++)
+	{
+		bufferIQ.resize((size_t)header.length[i]*CompactSampleBytes(iqFormat));
+		DoubleToCompact(iqFormat, real[i], imag[i], header.length[i], &bufferIQ[0], &header.scale[i]);
+		if (bufferIQ.size()!=fwrite(&bufferIQ[0], 1, bufferIQ.size(), fp))
+		{
+			err = ERR_SAVE_WAVE_FAILED;
+			break;
+		}
+	}
+	if (ERR_OK==err)
+	{
+		fseek(fp, 0, SEEK_SET);
+		fwrite(&header, sizeof(header), 1, fp);
+	}
+	fclose(fp);
+
+	return err;
+}
+
+IQMEASURE_API int LP_LoadCaptureCompact(char *fileName)
+{
+	IQ_COMPACT_FILE_HEADER header;
+
+	if (NULL==fileName)
+	{
+		return ERR_ANALYSIS_NULL_POINTER;
+	}
+
+	FILE *fp = NULL;
+	if (0!=fopen_s(&fp, fileName, "rb") || NULL==fp)
+	{
+		return ERR_LOAD_WAVE_FAILED;
+	}
+	if ( 1!=fread(&header, sizeof(header), 1, fp) || 0!=memcmp(header.magic, g_compactFileMagic, sizeof(header.magic)) ||
+		 0==CompactSampleBytes(header.iqFormat) || 0>=header.streamNum || IQ_COMPACT_MAX_STREAMS<header.streamNum )
+	{
+		fclose(fp);
+		return ERR_LOAD_WAVE_FAILED;
+	}
+	for (int i=0;i<header.streamNum;i++)
+	{
+		if ( 0>=header.length[i] || IQ_COMPACT_MAX_SAMPLES<header.length[i] || !(0.0<header.sampleFreqHz[i]) )
+		{
+			fclose(fp);
+			return ERR_LOAD_WAVE_FAILED;
+		}
+	}
+
+	// The IQapi handle only loads double samples, from a .sig file
+	int err = ERR_OK;
+	vector< vector<double> > real(header.streamNum), imag(header.streamNum);
+	vector<char> bufferIQ((size_t)IQ_COMPACT_BLOCK_SAMPLES*CompactSampleBytes(header.iqFormat));
+	for (int i=0;i<header.streamNum && ERR_OK==err;i++)
+	{
+		real[i].resize(header.length[i]);
+		imag[i].resize(header.length[i]);
+		for (int offset=0; offset<header.length[i]; offset+=IQ_COMPACT_BLOCK_SAMPLES)
+		{
+			int blockSamples = min(IQ_COMPACT_BLOCK_SAMPLES, header.length[i]-offset);
+			if ((size_t)blockSamples!=fread(&bufferIQ[0], CompactSampleBytes(header.iqFormat), blockSamples, fp))
+			{
+				err = ERR_LOAD_WAVE_FAILED;
+				break;
+			}
+			LP_CompactToDouble(header.iqFormat, &bufferIQ[0], blockSamples, header.scale[i], &real[i][offset], &imag[i][offset]);
+		}
+	}
+	fclose(fp);
+	if (ERR_OK!=err)
+	{
+		return err;
+	}
+
+	char tempPath[MAX_PATH] = {'\0'};
+	char sigFileName[MAX_PATH] = {'\0'};
+	GetTempPathA(MAX_PATH, tempPath);
+	if (0==GetTempFileNameA(tempPath, "iqc", 0, sigFileName))
+	{
+		return ERR_LOAD_WAVE_FAILED;
+	}
+
+	double	*realPtr[IQ_COMPACT_MAX_STREAMS] = {NULL};
+	double	*imagPtr[IQ_COMPACT_MAX_STREAMS] = {NULL};
+	for (int i=0;i<header.streamNum;i++)
+	{
+		realPtr[i] = &real[i][0];
+		imagPtr[i] = &imag[i][0];
+	}
+	err = LP_SaveUserDataToSigFile(sigFileName, realPtr, imagPtr, header.length, header.sampleFreqHz, header.streamNum);
+	if (ERR_OK==err)
+	{
+		err = LP_LoadVsaSignalFile(sigFileName);
+	}
+	DeleteFileA(sigFileName);
+
+	return err;
+}
@@ -0,0 +1,419 @@
+// GPS/Glonass session manager
+//
+// Keeps the GPS generator activated and the scenario resident across consecutive
+// test items.  Only the settings that differ from the previous item are pushed to
+// the tester, so a multi-item GPS flow pays for LP_GPS_SetActivate() and
+// LP_GPS_LoadScenarioFile() once instead of once per item.
+
+#include "stdafx.h"
+#include "IQmeasure.h"
+#include "IQlite_Logger.h"
+
+#ifndef GPS_SESSION_CHANNEL_COUNT
+#define GPS_SESSION_CHANNEL_COUNT	6
+#endif
+
+#ifndef GPS_SESSION_POWER_TOLERANCE_DB
+#define GPS_SESSION_POWER_TOLERANCE_DB	0.01
+#endif
+
+using namespace std;
+
+// This global variable is declared in IQmeasure.cpp
+extern int *LP_loggerIQmeasure_Ptr;
+
+struct tagGpsSession
+{
+	int						mode;				// LP_GPS_SESSION_MODE
+	bool					activated;
+	bool					glonassActivated;
+	int						reuseCount;
+	char					scenarioFile[MAX_PATH];
+	IQV_GPS_TRIGGER_STATE	triggerState;
+	int						navMode;
+	int						dopplerFrequency;
+	int						freqOffset;
+	double					pathlossDb;
+	double					testerPowerDbm[GPS_SESSION_CHANNEL_COUNT];
+	int						satelliteNum[GPS_SESSION_CHANNEL_COUNT];
+	IQV_GPS_OPERATION_MODE	glonassOperationMode;
+	int						glonassFrequencyChannel;
+};
+
+static struct tagGpsSession g_GpsSession = { GPS_SESSION_NONE, false, false, 0 };
+
+static void GpsSessionLog(LOGGER_LEVEL level, const char *format, const char *detail)
+{
+	if (NULL!=LP_loggerIQmeasure_Ptr)
+	{
+		::LOGGER_Write_Ext(LOG_IQMEASURE, *LP_loggerIQmeasure_Ptr, level, format, detail);
+	}
+	else
+	{
+		// do nothing
+	}
+}
+
+// Same rule as LP_GPS_CaculateTesterPower() in the IQmeasure_xx.dll, which is not exported by every backend
+static double GpsSessionTesterPower(double powerDbm, double pathlossDb)
+{
+	if ( powerDbm<=-60 && powerDbm>=-145 )
+	{
+		return powerDbm + pathlossDb;
+	}
+	else
+	{
+		// power is out of range : set standard
+		return -130 + pathlossDb;
+	}
+}
+
+static bool GpsSessionPowerChanged(double oldPowerDbm, double newPowerDbm)
+{
+	return (fabs(oldPowerDbm-newPowerDbm) > GPS_SESSION_POWER_TOLERANCE_DB);
+}
+
+// Same range as LP_GPS_ModulatedMode(), which leaves the channel off for another satellite number
+static bool GpsSessionSatelliteValid(int satelliteNum)
+{
+	return ( satelliteNum>=1 && satelliteNum<=37 );
+}
+
+static void GpsSessionReset(void)
+{
+	g_GpsSession.mode		= GPS_SESSION_NONE;
+	g_GpsSession.activated	= false;
+	g_GpsSession.glonassActivated = false;
+	g_GpsSession.reuseCount	= 0;
+	g_GpsSession.scenarioFile[0] = '\0';
+	for (int i=0;i<GPS_SESSION_CHANNEL_COUNT;i++)
+	{
+		g_GpsSession.testerPowerDbm[i] = 0;
+		g_GpsSession.satelliteNum[i]   = 0;
+	}
+}
+
+// Activate the tester only once per session.
+// LP_GPS_SetActivate()/LP_Glonass_SetActivate() reset the session, so the state is (re)built after they return.
+static int GpsSessionActivate(bool glonass)
+{
+	int err = ERR_OK;
+
+	if ( g_GpsSession.activated && glonass==g_GpsSession.glonassActivated )
+	{
+		return ERR_OK;
+	}
+	else if (g_GpsSession.activated)
+	{
+		// Switching between GPS and Glonass, the other generator has to be released first
+		err = LP_GPS_SessionClose();
+		if (ERR_OK!=err)
+		{
+			return err;
+		}
+		else{}
+	}
+	else{}
+
+	err = glonass ? LP_Glonass_SetActivate() : LP_GPS_SetActivate();
+	if (ERR_OK==err)
+	{
+		GpsSessionReset();
+		g_GpsSession.activated = true;
+		g_GpsSession.glonassActivated = glonass;
+		GpsSessionLog(LOGGER_INFORMATION, "[IQMEASURE],[GPS_SESSION],%s activated\n", glonass ? "Glonass" : "GPS");
+	}
+	else
+	{
+		GpsSessionReset();
+	}
+
+	return err;
+}
+
+IQMEASURE_API int LP_GPS_SessionScenario(char* fileName, IQV_GPS_TRIGGER_STATE triggerState, double powerDbm, double pathlossDb)
+{
+	int err = ERR_OK;
+
+	bool resident = ( GPS_SESSION_SCENARIO==g_GpsSession.mode &&
+					  triggerState==g_GpsSession.triggerState &&
+					  0==_stricmp(fileName, g_GpsSession.scenarioFile) );
+
+	if (!resident)
+	{
+		err = GpsSessionActivate(false);
+		if (ERR_OK!=err) return err;
+
+		err = LP_GPS_LoadScenarioFile(fileName, triggerState);
+		if (ERR_OK==err)
+		{
+			err = LP_GPS_PlayScenarioFile(powerDbm, pathlossDb);
+		}
+		else{}
+
+		if (ERR_OK==err)
+		{
+			g_GpsSession.mode			= GPS_SESSION_SCENARIO;
+			g_GpsSession.triggerState	= triggerState;
+			g_GpsSession.pathlossDb		= pathlossDb;
+			strcpy_s(g_GpsSession.scenarioFile, MAX_PATH, fileName);
+
+			// The satellites come from the scenario file, remember them for later power changes
+			for (int i=0;i<GPS_SESSION_CHANNEL_COUNT;i++)
+			{
+				double						channelPowerDbm = 0;
+				IQV_GPS_MODULATION_STATE	modulationState;
+				g_GpsSession.testerPowerDbm[i] = GpsSessionTesterPower(powerDbm, pathlossDb);
+				LP_GPS_GetChannelInfo((IQV_GPS_CHANNEL_NUMBER)i, &g_GpsSession.satelliteNum[i], &channelPowerDbm, &modulationState);
+			}
+			GpsSessionLog(LOGGER_INFORMATION, "[IQMEASURE],[GPS_SESSION],Scenario %s loaded\n", fileName);
+		}
+		else
+		{
+			g_GpsSession.mode = GPS_SESSION_NONE;
+		}
+	}
+	else
+	{
+		// Scenario is resident, only the power may have changed
+		double testerPowerDbm = GpsSessionTesterPower(powerDbm, pathlossDb);
+		for (int i=0;i<GPS_SESSION_CHANNEL_COUNT && ERR_OK==err;i++)
+		{
+			if (GpsSessionPowerChanged(g_GpsSession.testerPowerDbm[i], testerPowerDbm))
+			{
+				err = LP_GPS_SetChannelInfo((IQV_GPS_CHANNEL_NUMBER)i, g_GpsSession.satelliteNum[i], testerPowerDbm, IQV_MODULATION_STATE_ON);
+				g_GpsSession.testerPowerDbm[i] = testerPowerDbm;
+			}
+			else{}
+		}
+		g_GpsSession.pathlossDb = pathlossDb;
+		g_GpsSession.reuseCount++;
+
+		if (ERR_OK!=err)
+		{
+			// Channel state is unknown now, reload on the next call
+			g_GpsSession.mode = GPS_SESSION_NONE;
+		}
+		else{}
+	}
+
+	return err;
+}
+
+IQMEASURE_API int LP_GPS_SessionModulated(int Nav_Mode, double pathlossDb, double powerA[6], int satelliteNumA[6], int dopplerFrequency, IQV_GPS_TRIGGER_STATE triggerState)
+{
+	int err = ERR_OK;
+
+	bool resident = ( GPS_SESSION_MODULATED==g_GpsSession.mode &&
+					  triggerState==g_GpsSession.triggerState &&
+					  Nav_Mode==g_GpsSession.navMode &&
+					  dopplerFrequency==g_GpsSession.dopplerFrequency );
+
+	if (!resident)
+	{
+		err = GpsSessionActivate(false);
+		if (ERR_OK!=err) return err;
+
+		err = LP_GPS_ModulatedMode(Nav_Mode, pathlossDb, powerA, satelliteNumA, dopplerFrequency, triggerState);
+		if (ERR_OK==err)
+		{
+			g_GpsSession.mode				= GPS_SESSION_MODULATED;
+			g_GpsSession.triggerState		= triggerState;
+			g_GpsSession.navMode			= Nav_Mode;
+			g_GpsSession.dopplerFrequency	= dopplerFrequency;
+			g_GpsSession.pathlossDb			= pathlossDb;
+			for (int i=0;i<GPS_SESSION_CHANNEL_COUNT;i++)
+			{
+				g_GpsSession.testerPowerDbm[i]	= GpsSessionTesterPower(powerA[i], pathlossDb);
+				g_GpsSession.satelliteNum[i]	= satelliteNumA[i];
+			}
+		}
+		else
+		{
+			g_GpsSession.mode = GPS_SESSION_NONE;
+		}
+	}
+	else
+	{
+		// Same signal type, push only the channels that changed
+		for (int i=0;i<GPS_SESSION_CHANNEL_COUNT && ERR_OK==err;i++)
+		{
+			if ( !GpsSessionSatelliteValid(satelliteNumA[i]) )
+			{
+				// satellite Number is not vaild, the channel is off as after a full LP_GPS_ModulatedMode()
+				if (GpsSessionSatelliteValid(g_GpsSession.satelliteNum[i]))
+				{
+					err = LP_GPS_SetChannelInfo((IQV_GPS_CHANNEL_NUMBER)i, g_GpsSession.satelliteNum[i], g_GpsSession.testerPowerDbm[i], IQV_MODULATION_STATE_OFF);
+				}
+				else{}
+				g_GpsSession.satelliteNum[i] = satelliteNumA[i];
+				continue;
+			}
+			else{}
+
+			double testerPowerDbm = GpsSessionTesterPower(powerA[i], pathlossDb);
+			if ( satelliteNumA[i]!=g_GpsSession.satelliteNum[i] ||
+				 GpsSessionPowerChanged(g_GpsSession.testerPowerDbm[i], testerPowerDbm) )
+			{
+				err = LP_GPS_SetChannelInfo((IQV_GPS_CHANNEL_NUMBER)i, satelliteNumA[i], testerPowerDbm, IQV_MODULATION_STATE_ON);
+				g_GpsSession.testerPowerDbm[i]	= testerPowerDbm;
+				g_GpsSession.satelliteNum[i]	= satelliteNumA[i];
+			}
+			else{}
+		}
+		g_GpsSession.pathlossDb = pathlossDb;
+		g_GpsSession.reuseCount++;
+
+		if (ERR_OK!=err)
+		{
+			g_GpsSession.mode = GPS_SESSION_NONE;
+		}
+		else{}
+	}
+
+	return err;
+}
+
+IQMEASURE_API int LP_GPS_SessionContinueWave(double powerDbm, double pathlossDb, IQV_GPS_TRIGGER_STATE triggerState, int freqOffset)
+{
+	int err = ERR_OK;
+
+	bool resident = ( GPS_SESSION_CW==g_GpsSession.mode &&
+					  triggerState==g_GpsSession.triggerState &&
+					  freqOffset==g_GpsSession.freqOffset );
+
+	if (!resident)
+	{
+		err = GpsSessionActivate(false);
+		if (ERR_OK!=err) return err;
+
+		err = LP_GPS_ContinueWave(powerDbm, pathlossDb, triggerState, freqOffset);
+		if (ERR_OK==err)
+		{
+			g_GpsSession.mode				= GPS_SESSION_CW;
+			g_GpsSession.triggerState		= triggerState;
+			g_GpsSession.freqOffset			= freqOffset;
+			g_GpsSession.pathlossDb			= pathlossDb;
+			g_GpsSession.testerPowerDbm[0]	= GpsSessionTesterPower(powerDbm, pathlossDb);
+			g_GpsSession.satelliteNum[0]	= 1;
+		}
+		else
+		{
+			g_GpsSession.mode = GPS_SESSION_NONE;
+		}
+	}
+	else
+	{
+		double testerPowerDbm = GpsSessionTesterPower(powerDbm, pathlossDb);
+		if (GpsSessionPowerChanged(g_GpsSession.testerPowerDbm[0], testerPowerDbm))
+		{
+			err = LP_GPS_SetChannelInfo((IQV_GPS_CHANNEL_NUMBER)0, g_GpsSession.satelliteNum[0], testerPowerDbm, IQV_MODULATION_STATE_ON);
+			g_GpsSession.testerPowerDbm[0] = testerPowerDbm;
+		}
+		else{}
+		g_GpsSession.pathlossDb = pathlossDb;
+		g_GpsSession.reuseCount++;
+
+		if (ERR_OK!=err)
+		{
+			g_GpsSession.mode = GPS_SESSION_NONE;
+		}
+		else{}
+	}
+
+	return err;
+}
+
+IQMEASURE_API int LP_Glonass_SessionSetup(IQV_GPS_OPERATION_MODE operationMode, double powerDbm, int frequencyChannel)
+{
+	int err = ERR_OK;
+
+	if (GPS_SESSION_GLONASS!=g_GpsSession.mode)
+	{
+		err = GpsSessionActivate(true);
+		if (ERR_OK!=err) return err;
+
+		err = LP_Glonass_SetOperationMode(operationMode);
+		if (ERR_OK==err) err = LP_Glonass_SetFrequency(frequencyChannel);
+		if (ERR_OK==err) err = LP_Glonass_SetPower(powerDbm);
+		if (ERR_OK==err) err = LP_Glonass_SetRfOutput(IQV_RF_OUTPUT_ON);
+
+		if (ERR_OK==err)
+		{
+			g_GpsSession.mode						= GPS_SESSION_GLONASS;
+			g_GpsSession.glonassOperationMode		= operationMode;
+			g_GpsSession.glonassFrequencyChannel	= frequencyChannel;
+			g_GpsSession.testerPowerDbm[0]			= powerDbm;
+		}
+		else
+		{
+			g_GpsSession.mode = GPS_SESSION_NONE;
+		}
+	}
+	else
+	{
+		if (operationMode!=g_GpsSession.glonassOperationMode)
+		{
+			err = LP_Glonass_SetOperationMode(operationMode);
+			g_GpsSession.glonassOperationMode = operationMode;
+		}
+		else{}
+
+		if (ERR_OK==err && frequencyChannel!=g_GpsSession.glonassFrequencyChannel)
+		{
+			err = LP_Glonass_SetFrequency(frequencyChannel);
+			g_GpsSession.glonassFrequencyChannel = frequencyChannel;
+		}
+		else{}
+
+		if (ERR_OK==err && GpsSessionPowerChanged(g_GpsSession.testerPowerDbm[0], powerDbm))
+		{
+			err = LP_Glonass_SetPower(powerDbm);
+			g_GpsSession.testerPowerDbm[0] = powerDbm;
+		}
+		else{}
+		g_GpsSession.reuseCount++;
+
+		if (ERR_OK!=err)
+		{
+			g_GpsSession.mode = GPS_SESSION_NONE;
+		}
+		else{}
+	}
+
+	return err;
+}
+
+IQMEASURE_API int LP_GPS_SessionClose(void)
+{
+	int err = ERR_OK;
+
+	if (g_GpsSession.activated)
+	{
+		bool glonass = g_GpsSession.glonassActivated;
+		GpsSessionLog(LOGGER_INFORMATION, "[IQMEASURE],[GPS_SESSION],%s deactivated\n", glonass ? "Glonass" : "GPS");
+
+		// LP_GPS_SetDeactivate()/LP_Glonass_SetDeactivate() reset the session as well
+		err = glonass ? LP_Glonass_SetDeactivate() : LP_GPS_SetDeactivate();
+	}
+	else{}
+
+	GpsSessionReset();
+
+	return err;
+}
+
+IQMEASURE_API int LP_GPS_SessionInvalidate(void)
+{
+	GpsSessionReset();
+
+	return ERR_OK;
+}
+
+IQMEASURE_API int LP_GPS_SessionGetInfo(int *mode, int *reuseCount)
+{
+	if (NULL!=mode)			*mode		= g_GpsSession.mode;
+	if (NULL!=reuseCount)	*reuseCount	= g_GpsSession.reuseCount;
+
+	return ERR_OK;
+}
@@ -5,7 +5,6 @@
 //#include "lp_stdio.h"
 #include "iqapi.h"
 #include "..\IQmeasure.h"
-//#include "..\DebugAlloc.h"
 #include "IQlite_Timer.h"
 #include "IQlite_Logger.h"
 #include "StringUtil.h"
@@ -250,7 +249,6 @@ int LP_InitializeIQ2010ExtMap(void);
 //		case DLL_THREAD_DETACH:
 //			break;
 //		case DLL_PROCESS_DETACH:
-//			//debug_ext::debug_mem_allocation::SendOutCurrentLog();
 //			LP_FreeMemory();
 //			break;
 //    }
@@ -4110,12 +4108,14 @@ IQMEASURE_API int LP_SelectCaptureRangeForAnalysis(double startPositionUs, doubl
 			g_userData = new iqapiCapture();
 
 			int i = 0;
+			int testersWithData = 0;
 			int	startOffsetArray[MAX_TESTER_NUM] = {0};
 			int	lengthArray[MAX_TESTER_NUM] = {0};
 			for(i = 0 ; i < MAX_TESTER_NUM ; i++){
 				if(!hndl->data->length[i]){
-					err = ERR_NO_CAPTURE_DATA;
+					// Tester not in use, e.g. a single VSA station
 				}else{
+					testersWithData++;
 					g_userData->sampleFreqHz[i] = hndl->data->sampleFreqHz[i];
 					startOffsetArray[i] = (int)(g_userData->sampleFreqHz[i]*1.0e-6*startPositionUs);
 					lengthArray[i]      = (int)(g_userData->sampleFreqHz[i]*1.0e-6*lengthUs);
@@ -4133,6 +4133,14 @@ IQMEASURE_API int LP_SelectCaptureRangeForAnalysis(double startPositionUs, doubl
 					}
 				}
 			}
+			if (0==testersWithData)
+			{
+				err = ERR_NO_CAPTURE_DATA;
+			}
+			else
+			{
+				// do nothing
+			}
 		}
 	}
 	else
@@ -7847,6 +7855,27 @@ IQMEASURE_API double LP_GetScalarMeasurement(char *measurement, int index)
 	return value;
 }
 
+IQMEASURE_API int LP_GetScalarMeasurementArray(char *measurement, double values[], int bufferLength)
+{
+	::TIMER_StartTimer(timerIQmeasure, "LP_GetScalarMeasurementArray", &timeStart);
+
+	int validCount = 0;
+	for (int i=0;i<bufferLength;i++)
+	{
+		values[i] = LP_GetScalarMeasurement_NoTimer(measurement, i);
+		if (NA_NUMBER!=values[i])
+		{
+			validCount++;
+		}
+		else{}
+	}
+
+	::TIMER_StopTimer(timerIQmeasure, "LP_GetScalarMeasurementArray", &timeDuration, &timeStop);
+	::LOGGER_Write_Ext(LOG_IQMEASURE, loggerIQmeasure, LOGGER_INFORMATION, "[IQMEASURE],[%s],%.2f,ms\n", "LP_GetScalarMeasurementArray", timeDuration);
+
+	return validCount;
+}
+
 // Keep this function with typo for backward compatibility
 IQMEASURE_API int LP_GetVectorMeasurment(char *measurement, double bufferReal[], double bufferImag[], int bufferLength)
 {
@@ -4,7 +4,6 @@
 #include "lp_stdio.h"
 #include "iqapi.h"
 #include "IQmeasure.h"
-//#include "DebugAlloc.h"
 #include "IQlite_Timer.h"
 #include "IQlite_Logger.h"
 #include "StringUtil.h"
@@ -231,7 +230,6 @@ BOOL APIENTRY DllMain(HANDLE hModule, DWORD  ul_reason_for_call, LPVOID lpReserv
 		case DLL_THREAD_DETACH:
 			break;
 		case DLL_PROCESS_DETACH:
-			//debug_ext::debug_mem_allocation::SendOutCurrentLog();
 			LP_FreeMemory();
 			break;
     }
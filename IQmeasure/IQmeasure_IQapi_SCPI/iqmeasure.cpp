@@ -6,7 +6,6 @@
 #include "iqapi.h"
 #include "iqapiCommon.h"
 #include "..\IQmeasure.h"
-//#include "..\DebugAlloc.h"
 #include "IQlite_Timer.h"
 #include "IQlite_Logger.h"
 #include "StringUtil.h"
@@ -3436,12 +3435,14 @@ IQMEASURE_API int LP_SelectCaptureRangeForAnalysis(double startPositionUs, doubl
 			g_userData = new iqapiCapture();
 
 			int i = 0;
+			int testersWithData = 0;
 			int	startOffsetArray[MAX_TESTER_NUM] = {0};
 			int	lengthArray[MAX_TESTER_NUM] = {0};
 			for(i = 0 ; i < MAX_TESTER_NUM ; i++){
 				if(!hndl->data->length[i]){
-					err = ERR_NO_CAPTURE_DATA;
+					// Tester not in use, e.g. a single VSA station
 				}else{
+					testersWithData++;
 					g_userData->sampleFreqHz[i] = hndl->data->sampleFreqHz[i];
 					startOffsetArray[i] = (int)(g_userData->sampleFreqHz[i]*1.0e-6*startPositionUs);
 					lengthArray[i]      = (int)(g_userData->sampleFreqHz[i]*1.0e-6*lengthUs);
@@ -3459,6 +3460,14 @@ IQMEASURE_API int LP_SelectCaptureRangeForAnalysis(double startPositionUs, doubl
 					}
 				}
 			}
+			if (0==testersWithData)
+			{
+				err = ERR_NO_CAPTURE_DATA;
+			}
+			else
+			{
+				// do nothing
+			}
 		}
 	}
 	else
@@ -6458,6 +6467,27 @@ IQMEASURE_API double LP_GetScalarMeasurement(char *measurement, int index)
 	return value;
 }
 
+IQMEASURE_API int LP_GetScalarMeasurementArray(char *measurement, double values[], int bufferLength)
+{
+	::TIMER_StartTimer(timerIQmeasure, "LP_GetScalarMeasurementArray", &timeStart);
+
+	int validCount = 0;
+	for (int i=0;i<bufferLength;i++)
+	{
+		values[i] = LP_GetScalarMeasurement_NoTimer(measurement, i);
+		if (NA_NUMBER!=values[i])
+		{
+			validCount++;
+		}
+		else{}
+	}
+
+	::TIMER_StopTimer(timerIQmeasure, "LP_GetScalarMeasurementArray", &timeDuration, &timeStop);
+	::LOGGER_Write_Ext(LOG_IQMEASURE, loggerIQmeasure, LOGGER_INFORMATION, "[IQMEASURE],[%s],%.2f,ms\n", "LP_GetScalarMeasurementArray", timeDuration);
+
+	return validCount;
+}
+
 // Keep this function with typo for backward compatibility
 IQMEASURE_API int LP_GetVectorMeasurment(char *measurement, double bufferReal[], double bufferImag[], int bufferLength)
 {
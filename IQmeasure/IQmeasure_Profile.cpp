@@ -0,0 +1,322 @@
+// RF configuration profiles
+//
+// A test item sets up the tester with the same chain of calls every time:
+// LP_SetVsaAmplitudeTolerance(), LP_SetVsaTriggerTimeout(), LP_SetVsa(),
+// LP_SetVsg(), LP_EnableVsgRF() and LP_SetAnalysisParameterInteger().
+// LP_DefineProfile() compiles such a chain once into an ordered list of steps,
+// LP_ApplyProfile() sends only the steps whose value differs from what this
+// module last sent to the tester.
+//
+// Every dispatcher function that changes one of these settings outside a
+// profile forgets the matching step (ProfileForget() in IQmeasure.cpp), so a
+// skipped step is always one the tester still has.
+//
+// Analysis parameters are always sent: the LP_Analyze* functions of the
+// backends rewrite the analysis objects from their own arguments (e.g.
+// frequencyCorr of LP_Analyze80211n()), so a value set before is not kept.
+// Setting one costs no tester I/O.
+
+#include "stdafx.h"
+#include "IQmeasure.h"
+#include "IQlite_Logger.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <string>
+#include <vector>
+#include <map>
+
+using namespace std;
+
+// This global variable is declared in IQmeasure.cpp
+extern int *LP_loggerIQmeasure_Ptr;
+
+enum PROFILE_STEP_TYPE
+{
+	PROFILE_STEP_VSA_AMPLITUDE_TOLERANCE,
+	PROFILE_STEP_VSA_TRIGGER_TIMEOUT,
+	PROFILE_STEP_VSA,
+	PROFILE_STEP_VSG,
+	PROFILE_STEP_VSG_RF,
+	PROFILE_STEP_ANALYSIS_INTEGER
+};
+
+typedef struct tagProfileStep
+{
+	PROFILE_STEP_TYPE	type;
+	string				key;		// shadow entry written by this step
+	string				value;		// printed arguments, compared against the shadow
+} PROFILE_STEP;
+
+typedef struct tagProfile
+{
+	string					name;
+	IQ_RF_PROFILE			settings;
+	vector<PROFILE_STEP>	steps;
+} PROFILE;
+
+static vector<PROFILE>		g_profiles;
+static map<string, string>	g_profileShadow;		// key -> value last sent to the tester by LP_ApplyProfile()
+static int					g_profileStepsSent    = 0;
+static int					g_profileStepsSkipped = 0;
+
+#define PROFILE_KEY_VSA_AMPLITUDE_TOLERANCE	"VSA_AMPLITUDE_TOLERANCE"
+#define PROFILE_KEY_VSA_TRIGGER_TIMEOUT		"VSA_TRIGGER_TIMEOUT"
+#define PROFILE_KEY_VSA						"VSA"
+#define PROFILE_KEY_VSG						"VSG"
+#define PROFILE_KEY_VSG_RF					"VSG_RF"
+#define PROFILE_KEY_ANALYSIS				"ANALYSIS:"
+#define PROFILE_VALUE_SIZE					256
+
+static void ProfileLog(LOGGER_LEVEL level, const char *format, const char *detail)
+{
+	if (NULL!=LP_loggerIQmeasure_Ptr)
+	{
+		::LOGGER_Write_Ext(LOG_IQMEASURE, *LP_loggerIQmeasure_Ptr, level, format, detail);
+	}
+	else
+	{
+		// do nothing
+	}
+}
+
+static void ProfileAddStep(vector<PROFILE_STEP> &steps, PROFILE_STEP_TYPE type, const string &key, const char *format, ...)
+{
+	char buffer[PROFILE_VALUE_SIZE] = {'\0'};
+	va_list ap;
+	va_start(ap, format);
+	vsprintf_s(buffer, PROFILE_VALUE_SIZE, format, ap);
+	va_end(ap);
+
+	PROFILE_STEP step;
+	step.type  = type;
+	step.key   = key;
+	step.value = buffer;
+	steps.push_back(step);
+}
+
+static string ProfileAnalysisKey(const char *measurement, const char *parameter)
+{
+	return string(PROFILE_KEY_ANALYSIS) + measurement + ":" + parameter;
+}
+
+// Order of the steps is the order a test function used to call them: the amplitude tolerance
+// decides how LP_SetVsa() treats the amplitude, so it has to be sent first.
+static void ProfileCompile(PROFILE &profile)
+{
+	const IQ_RF_PROFILE &settings = profile.settings;
+
+	profile.steps.clear();
+	if (0!=(settings.enableMask&IQ_PROFILE_VSA_AMPLITUDE_TOLERANCE))
+	{
+		ProfileAddStep(profile.steps, PROFILE_STEP_VSA_AMPLITUDE_TOLERANCE, PROFILE_KEY_VSA_AMPLITUDE_TOLERANCE, "%.6f", settings.vsaAmplitudeToleranceDb);
+	}
+	else
+	{
+		// do nothing
+	}
+	if (0!=(settings.enableMask&IQ_PROFILE_VSA_TRIGGER_TIMEOUT))
+	{
+		ProfileAddStep(profile.steps, PROFILE_STEP_VSA_TRIGGER_TIMEOUT, PROFILE_KEY_VSA_TRIGGER_TIMEOUT, "%.6f", settings.vsaTriggerTimeoutSec);
+	}
+	else
+	{
+		// do nothing
+	}
+	if (0!=(settings.enableMask&IQ_PROFILE_VSA))
+	{
+		ProfileAddStep(profile.steps, PROFILE_STEP_VSA, PROFILE_KEY_VSA, "%.3f,%.6f,%d,%.6f,%.6f,%.9f,%.3f",
+			settings.vsaFreqHz, settings.vsaAmplDb, settings.vsaPort, settings.vsaExtAttenDb,
+			settings.vsaTriggerLevelDb, settings.vsaTriggerPreTimeSec, settings.vsaFreqShiftHz);
+	}
+	else
+	{
+		// do nothing
+	}
+	if (0!=(settings.enableMask&IQ_PROFILE_VSG))
+	{
+		ProfileAddStep(profile.steps, PROFILE_STEP_VSG, PROFILE_KEY_VSG, "%.3f,%.6f,%d,%d,%.3f",
+			settings.vsgFreqHz, settings.vsgPowerDbm, settings.vsgPort, settings.vsgGapPowerOff, settings.vsgFreqShiftHz);
+	}
+	else
+	{
+		// do nothing
+	}
+	if (0!=(settings.enableMask&IQ_PROFILE_VSG_RF))
+	{
+		ProfileAddStep(profile.steps, PROFILE_STEP_VSG_RF, PROFILE_KEY_VSG_RF, "%d", settings.vsgRfEnabled);
+	}
+	else
+	{
+		// do nothing
+	}
+	for (int i=0;i<settings.analysisCount;i++)
+	{
+		ProfileAddStep(profile.steps, PROFILE_STEP_ANALYSIS_INTEGER,
+			ProfileAnalysisKey(settings.analysis[i].measurement, settings.analysis[i].parameter), "%d", settings.analysis[i].value);
+	}
+}
+
+static int ProfileSendStep(const IQ_RF_PROFILE &settings, const PROFILE_STEP &step, int analysisIndex)
+{
+	switch (step.type)
+	{
+	case PROFILE_STEP_VSA_AMPLITUDE_TOLERANCE:
+		return LP_SetVsaAmplitudeTolerance(settings.vsaAmplitudeToleranceDb);
+	case PROFILE_STEP_VSA_TRIGGER_TIMEOUT:
+		return LP_SetVsaTriggerTimeout(settings.vsaTriggerTimeoutSec);
+	case PROFILE_STEP_VSA:
+		return LP_SetVsa(settings.vsaFreqHz, settings.vsaAmplDb, settings.vsaPort, settings.vsaExtAttenDb,
+						 settings.vsaTriggerLevelDb, settings.vsaTriggerPreTimeSec, settings.vsaFreqShiftHz);
+	case PROFILE_STEP_VSG:
+		return LP_SetVsg(settings.vsgFreqHz, settings.vsgPowerDbm, settings.vsgPort, 0!=settings.vsgGapPowerOff, settings.vsgFreqShiftHz);
+	case PROFILE_STEP_VSG_RF:
+		return LP_EnableVsgRF(settings.vsgRfEnabled);
+	case PROFILE_STEP_ANALYSIS_INTEGER:
+		return LP_SetAnalysisParameterInteger((char*)settings.analysis[analysisIndex].measurement,
+											  (char*)settings.analysis[analysisIndex].parameter,
+											  settings.analysis[analysisIndex].value);
+	default:
+		return ERR_ANALYSIS_INVALID_PARAM_VALUE;
+	}
+}
+
+// Called by the dispatcher functions of IQmeasure.cpp, see the note on top
+void ProfileForget(const char *key)
+{
+	if (NULL==key)
+	{
+		g_profileShadow.clear();
+	}
+	else
+	{
+		g_profileShadow.erase(key);
+	}
+}
+
+IQMEASURE_API int LP_DefineProfile(char *profileName, IQ_RF_PROFILE *profile, int *profileId)
+{
+	if ( NULL==profileName || NULL==profile || NULL==profileId )
+	{
+		return ERR_ANALYSIS_NULL_POINTER;
+	}
+	else if ( 0>profile->analysisCount || IQ_PROFILE_MAX_ANALYSIS<profile->analysisCount )
+	{
+		return ERR_ANALYSIS_INVALID_PARAM_VALUE;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	// Defining a name again replaces the settings and keeps the id
+	int id = 0;
+	for (id=0;id<(int)g_profiles.size();id++)
+	{
+		if (g_profiles[id].name==profileName)
+		{
+			break;
+		}
+		else
+		{
+			// do nothing
+		}
+	}
+	if (id==(int)g_profiles.size())
+	{
+		g_profiles.push_back(PROFILE());
+		g_profiles[id].name = profileName;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	g_profiles[id].settings = *profile;
+	ProfileCompile(g_profiles[id]);
+	*profileId = id;
+
+	return ERR_OK;
+}
+
+IQMEASURE_API int LP_ApplyProfile(int profileId)
+{
+	if ( 0>profileId || (int)g_profiles.size()<=profileId )
+	{
+		return ERR_ANALYSIS_INVALID_PARAM_VALUE;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	int err = ERR_OK;
+	const PROFILE &profile = g_profiles[profileId];
+	int analysisIndex = 0;
+	for (size_t i=0;i<profile.steps.size();i++)
+	{
+		const PROFILE_STEP &step = profile.steps[i];
+		map<string, string>::iterator shadow_Iter = g_profileShadow.find(step.key);
+		if ( PROFILE_STEP_ANALYSIS_INTEGER!=step.type && shadow_Iter!=g_profileShadow.end() && shadow_Iter->second==step.value )
+		{
+			g_profileStepsSkipped++;
+		}
+		else
+		{
+			// The LP_ function forgets the key itself, the new value is only recorded once the tester accepted it
+			err = ProfileSendStep(profile.settings, step, analysisIndex);
+			g_profileStepsSent++;
+			if (ERR_OK!=err)
+			{
+				ProfileLog(LOGGER_ERROR, "[IQMEASURE],[PROFILE],Apply %s failed\n", profile.name.c_str());
+				break;
+			}
+			else if (PROFILE_STEP_ANALYSIS_INTEGER!=step.type)
+			{
+				g_profileShadow[step.key] = step.value;
+			}
+			else
+			{
+				// do nothing
+			}
+		}
+		if (PROFILE_STEP_ANALYSIS_INTEGER==step.type)
+		{
+			analysisIndex++;
+		}
+		else
+		{
+			// do nothing
+		}
+	}
+
+	return err;
+}
+
+IQMEASURE_API int LP_ProfileInvalidate(void)
+{
+	ProfileForget(NULL);
+
+	return ERR_OK;
+}
+
+IQMEASURE_API int LP_ProfileGetInfo(int *stepsSent, int *stepsSkipped)
+{
+	if (NULL!=stepsSent)
+	{
+		*stepsSent = g_profileStepsSent;
+	}
+	else
+	{
+		// do nothing
+	}
+	if (NULL!=stepsSkipped)
+	{
+		*stepsSkipped = g_profileStepsSkipped;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	return ERR_OK;
+}
@@ -0,0 +1,126 @@
+// VSA reference level model
+//
+// Remembers the average power at the VSA port of every signal the station has
+// captured, keyed by frequency and a caller-defined signal key (data rate,
+// bandwidth, antennas...).  The next capture of the same signal sets the VSA
+// amplitude from the learned power instead of the configured target power, so
+// a DUT that transmits off target no longer needs a failed capture, a ranging
+// capture and a retry (QuickCaptureRetry(), LP_Agc()) in every cycle.
+//
+// An entry is dropped when the capture clipped or did not trigger, the caller
+// then falls back to the configured power and its ranging path.
+//
+// Only the WiFi_Test TX verify functions use it; the BT TX verify functions
+// still range with LP_Agc() after a failed capture.
+
+#include "stdafx.h"
+#include "IQmeasure.h"
+#include <map>
+#include <string>
+
+#ifndef REF_LEVEL_MARGIN_DB
+#define REF_LEVEL_MARGIN_DB			1.0		// added to the learned power, for the unit-to-unit spread
+#endif
+
+#ifndef REF_LEVEL_CLIP_MARGIN_DB
+#define REF_LEVEL_CLIP_MARGIN_DB	1.0		// peak above the VSA amplitude by more than this is taken as clipping
+#endif
+
+#define REF_LEVEL_LEARN_WEIGHT		0.5		// weight of the newest capture
+
+using namespace std;
+
+struct tagRefLevelEntry
+{
+	double	avgPowerDbm;
+};
+
+// TM_RunAsync workers and the DUT look-ahead thread can predict and learn while the test thread does.
+// Constructed when the DLL loads, before any of them runs.
+static class RefLevelLock
+{
+public:
+	RefLevelLock()  { InitializeCriticalSection(&cs); }
+	~RefLevelLock() { DeleteCriticalSection(&cs); }
+	CRITICAL_SECTION cs;
+} g_refLevelLock;
+
+static map<string, tagRefLevelEntry> g_refLevelModel;
+
+static string RefLevelKey(double freqMHz, char *signalKey)
+{
+	char key[MAX_PATH];
+	sprintf_s(key, MAX_PATH, "%.3f|%s", freqMHz, (NULL!=signalKey) ? signalKey : "");
+	return key;
+}
+
+IQMEASURE_API double LP_RefLevelPredict(double freqMHz, char *signalKey, double expectedPowerDbm)
+{
+	double predictedDbm = expectedPowerDbm;
+	string key = RefLevelKey(freqMHz, signalKey);
+
+	EnterCriticalSection(&g_refLevelLock.cs);
+	map<string, tagRefLevelEntry>::iterator entry_Iter = g_refLevelModel.find(key);
+	if (entry_Iter!=g_refLevelModel.end())
+	{
+		predictedDbm = entry_Iter->second.avgPowerDbm + REF_LEVEL_MARGIN_DB;
+	}
+	else
+	{
+		// do nothing
+	}
+	LeaveCriticalSection(&g_refLevelLock.cs);
+
+	return predictedDbm;
+}
+
+IQMEASURE_API int LP_RefLevelLearn(double freqMHz, char *signalKey, double avgPowerDbm, double peakPowerDbm, double vsaAmplitudeDbm)
+{
+	string key = RefLevelKey(freqMHz, signalKey);
+
+	if (-99.0>=avgPowerDbm)
+	{
+		return ERR_NO_MEASUREMENT_RESULT;
+	}
+
+	if ( -99.0<peakPowerDbm && -99.0<vsaAmplitudeDbm && peakPowerDbm>vsaAmplitudeDbm+REF_LEVEL_CLIP_MARGIN_DB )
+	{
+		// Clipped, the learned power is too low; the next capture starts from the configured power again
+		EnterCriticalSection(&g_refLevelLock.cs);
+		g_refLevelModel.erase(key);
+		LeaveCriticalSection(&g_refLevelLock.cs);
+		return ERR_CAPTURE_FAILED;
+	}
+
+	EnterCriticalSection(&g_refLevelLock.cs);
+	map<string, tagRefLevelEntry>::iterator entry_Iter = g_refLevelModel.find(key);
+	if (entry_Iter==g_refLevelModel.end())
+	{
+		tagRefLevelEntry entry;
+		entry.avgPowerDbm = avgPowerDbm;
+		g_refLevelModel.insert(pair<string, tagRefLevelEntry>(key, entry));
+	}
+	else
+	{
+		entry_Iter->second.avgPowerDbm += REF_LEVEL_LEARN_WEIGHT*(avgPowerDbm-entry_Iter->second.avgPowerDbm);
+	}
+	LeaveCriticalSection(&g_refLevelLock.cs);
+
+	return ERR_OK;
+}
+
+IQMEASURE_API int LP_RefLevelForget(double freqMHz, char *signalKey)
+{
+	EnterCriticalSection(&g_refLevelLock.cs);
+	if (NULL==signalKey)
+	{
+		g_refLevelModel.clear();
+	}
+	else
+	{
+		g_refLevelModel.erase(RefLevelKey(freqMHz, signalKey));
+	}
+	LeaveCriticalSection(&g_refLevelLock.cs);
+
+	return ERR_OK;
+}
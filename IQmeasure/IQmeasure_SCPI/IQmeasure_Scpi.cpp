@@ -75,7 +75,7 @@ extern iqapiHndl *hndl;
 //     memset(resp_string, 0x0, LP_LENGTH_IDENTITY);					\
 
 CIQxstream  iqx;                                // obj to manage scpi communications with IQxtream
-bool        g_checkLocal = false;                // always check tester state from local map before sending out scpi command to tester
+bool        g_checkLocal = true;                 // keep settings in the tester shadow model of iqx, see CIQxstream::SetTesterState()
 
 
 // Jarir, 12/9/11, removed trigger type map, now relevant functions take in iqapi compatible trigger values and set Trigger with a switch statement
@@ -1141,6 +1141,10 @@ int CIQmeasure_Scpi::SetVsaTriggerTimeout(double triggerTimeoutSec)
 		rxLen = iqx.SendCommand("SYS_WAI", "", true);       // SYS;*WAI -- wait for previous operations
 		rxLen = iqx.SendCommand("SYS_ERR","?",true);	    // SYST:ERR:ALL? -- check all accumulated errors
 	}
+	else
+	{
+		return err;                                         // tester already has this timeout, nothing to check
+	}
 
 	char *pch = NULL;
 	pch = strtok(iqx.scpiRxBuffer, ",");
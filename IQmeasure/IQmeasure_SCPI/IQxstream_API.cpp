@@ -34,7 +34,7 @@ CIQxstream::CIQxstream(void)
 	scpiLogFileName         = "log_scpi.txt";   // save scpi related log to this file
 
 	CreatScpiMap();                             // create SCPI map
-	testerStateMap.clear();                     // clear testerStateMap
+	CreateTesterStateModel();                   // create tester shadow model, uses the SCPI map
 	resultHistory.clear();                      // clear test results
 
 	scpiRxBuffer = (char*)malloc(SCPI_RX_BUFFER_SIZE*sizeof(char)); // allocate memory for scpiRxBuffer
@@ -54,7 +54,7 @@ CIQxstream::~CIQxstream(void)
 {
 	free(scpiRxBuffer);       // clear memory
 	resultHistory.clear();
-	testerStateMap.clear();
+	testerState.clear();
 	ScpiMap.clear();
 
 	if (connectSocket!=INVALID_SOCKET)
@@ -105,7 +105,8 @@ int CIQxstream::SendCommand(char *command, char* cmd2, bool scpiKeyUsed, bool ch
 
 	char            sockBuffer[SOCK_BUFFER_SIZE]    = {0};
 	unsigned int    timeDiff  = 0;
-	int             have2Send = 1; // Whether current scpi cmd will be sent to the tester; 0 = no, 1 = yes, 2 = yes and first user
+	int             have2Send = -1; // Whether current scpi cmd is kept in the tester shadow model; 0 = tester has it, 1 = sent with the next flush, -1 = send now
+	int             stateCount = 0; // number of dirty settings sent in front of this command
 
 	bLastScpiSkipped = false;
 
@@ -116,27 +117,25 @@ int CIQxstream::SendCommand(char *command, char* cmd2, bool scpiKeyUsed, bool ch
 		checkStatus = false;
 
 	//-----------------------------------------
-	// check tester state from stateMap
+	// keep settings in the tester shadow model
 	//-----------------------------------------
 	if(scpiKeyUsed&&checkStatus)
 	{
-		have2Send = CheckLocalState(command,cmd2,checkStatus);  // check whether the scpi command should be sent to the tester
-		if(have2Send < 0)                                       // error in function call, and report error
+		have2Send = SetTesterState(command,cmd2);               // check whether the scpi command should be sent to the tester
+		if (have2Send == 0)                                     // don't need to change tester status, and don't need to send scpi command
 		{
-			set_color(RED);
-			LogPrintf("ERROR in CheckLocalState()!!! \n\n");
-			set_color(WHITE);
-			return have2Send;
+			bLastScpiSkipped =  true;                           // update class member variable to indicate that last SCPI cmd is skipped!
+			SAFE_DELETE_ARRAY(buffer);
+			return 0;
 		}
-		else if (have2Send == 0)                                // don't need to change tester status, and don't need to send scpi command
+		else if (have2Send == 1)                                // marked dirty, sent in front of the next command that needs the tester
 		{
-			//LogPrintf("Info: the same state, no need to change! \n");
-			bLastScpiSkipped =  true;                           // update class member variable to indicate that last SCPI cmd is skipped!
-			return have2Send;
+			SAFE_DELETE_ARRAY(buffer);
+			return 0;
 		}
 		else
 		{
-			//do nothing!                                          // tester status needs to be changed, and program will go on
+			//do nothing!                                          // not in the shadow model, and program will go on
 		}
 	}
 
@@ -221,17 +220,36 @@ int CIQxstream::SendCommand(char *command, char* cmd2, bool scpiKeyUsed, bool ch
 	}
 	_ftime64(&timerStart);
 
+	string stateBlock = TakeDirtyState(&stateCount);                // dirty settings go out in front of this command
+	if (stateCount>0 && bEnableDebugMessage)
+	{
+		set_color(MEGNETA);
+		LogPrintf("[SCPI] STATE (%d) : %s", stateCount, stateBlock.c_str());
+		set_color(WHITE);
+	}
 
+	int sendStatus = 0;                                             // not statusSocket, which holds whatever the last call left in it
 	if( strstr(command, "MMEM:DATA") )
-		statusSocket = send( connectSocket, buffer, m_iCmdDataSize+1, 0 ); // command, data, and carriage return
+	{
+		if (stateCount>0)
+			sendStatus = send( connectSocket, stateBlock.c_str(), (int)stateBlock.size(), 0 );
+		if (sendStatus != SOCKET_ERROR)
+			sendStatus = send( connectSocket, buffer, m_iCmdDataSize+1, 0 ); // command, data, and carriage return
+	}
 	else
-		statusSocket = send( connectSocket, buffer, (int)strlen(buffer), 0 );
-	if (statusSocket == SOCKET_ERROR)
+	{
+		stateBlock.append(buffer);
+		sendStatus = send( connectSocket, stateBlock.c_str(), (int)stateBlock.size(), 0 );
+	}
+	if (sendStatus == SOCKET_ERROR)
 	{
 		LogPrintf("Winsock send failed with error: %d\n", WSAGetLastError());
 		memset (scpiRxBuffer,'\0',SCPI_RX_BUFFER_SIZE);             // clear response buffer
+		InvalidateTesterState(STATE_GROUP_ALL);                     // unknown what the tester got
+		SAFE_DELETE_ARRAY(buffer);
 		return FAIL;
 	}
+	ForgetChangedState(command, cmd2, scpiKeyUsed);
 	// printf("  SCPI buffer is %s %s::%s::%d \n", buffer, __FILE__, __FUNCTION__, __LINE__);
 
 	//-----------------------------------------
@@ -302,13 +320,8 @@ int CIQxstream::SendCommand(char *command, char* cmd2, bool scpiKeyUsed, bool ch
 		memset (scpiRxBuffer,'\0',SCPI_RX_BUFFER_SIZE);// clear response buffer
 	}
 
-	//-----------------------------------------
-	// Update tester stateMap
-	//-----------------------------------------
-	if(scpiKeyUsed&checkStatus)
-	{
-		UpdateLocalState(command,cmd2,checkStatus,scpiRxBuffer);
-	}
+	if (scpiKeyUsed && !strcmp(command, "SYS_ERR"))
+		CheckFlushedState();                                        // the error queue tells whether the flushed settings were taken
 
 	SAFE_DELETE_ARRAY(buffer);
 	return rxLenTot;
@@ -340,14 +353,22 @@ int CIQxstream::SendCommand_only(char *command, char* cmd2, bool scpiKeyUsed)
 	//-----------------------------------------
 	// Send SCPI command
 	//-----------------------------------------
+	int stateCount = 0;
+	string stateBlock = TakeDirtyState(&stateCount);    // dirty settings go out in front of this command
 	set_color(MEGNETA);
 	if (bEnableDebugMessage)
+	{
+		if (stateCount>0)
+			LogPrintf("[SCPI] STATE (%d) : %s", stateCount, stateBlock.c_str());
 		LogPrintf("[SCPI] INPUT : %s", buffer);
+	}
 
-	statusSocket = send( connectSocket, buffer, (int)strlen(buffer), 0 );
+	stateBlock.append(buffer);
+	statusSocket = send( connectSocket, stateBlock.c_str(), (int)stateBlock.size(), 0 );
 	if (statusSocket == SOCKET_ERROR)
 	{
 		printf("Winsock send failed with error: %d\n", WSAGetLastError());
+		InvalidateTesterState(STATE_GROUP_ALL);
 		return FAIL;
 	}
 	return rxLenTot;
@@ -614,179 +635,208 @@ string CIQxstream::ConvertToScpi(char *cmdKey)
 	return scpiCmd;
 }
 
-//int CIQxstream::getLocalState(char *scpiCmdKey, char *parameters)
-//{
-//    int retErr = -1;
-//    return retErr;
-//}
-
-
-// 12/29/12, added by Jacky,
-// Check from the local map to find whether the tester status need to be changed based on the current input SCPI,
-// if needed, return 1, otherwise 0;
-// If the scpi keyword corresponding satus cannot be found in the map, it will return 2 (instead of 1).
-// If other exceptions happen, return negative values, -1 or less than -1;
-int  CIQxstream::CheckLocalState(char *scpiCmdKey, char *parameters, bool checkStatus)
+// Tester shadow model.
+// Settings sent with checkStatus are kept here instead of being sent right away: a setting
+// the tester already has is dropped, a changed one is marked dirty.  All dirty settings go
+// out as one block in front of the next command that needs the tester (capture, play, query,
+// *WAI, ...), so a test item that sets up VSA/VSG/routing sends a single message for them.
+// The model trusts what it sent; it does not query the tester back, but a SYST:ERR? that reports
+// an error makes it forget the settings flushed since the previous SYST:ERR?.
+static const struct
 {
-	int retErr              = -1;                   /* 0 = cmd state found and the same as expected;
-	/* 1 = cmd state found, but not the same as expected;
-	/* 2 = cmd state cannot be found;
-	/* -1,-2,... for exceptions        */
-
-	int rxLen               = 0;                    // scpi return length
-	char * pch              = NULL;                 //
-	string testerStateName  = scpiCmdKey;
-	string targetParaStr    = parameters;
-	string currentParaStr   = "";
-	string queryStr         = "?";
-
-	if(!checkStatus)
-		return 1;                                   // bypass the following operation and make sure the scpi is sent
-
-	if (strstr(scpiCmdKey, "ROUT_PORT_RES"))
-	{
-		testerStateName     += "_Q";
-		queryStr            =  "";
-	}
+	const char  *scpiCmdKey;
+	int         group;
+	bool        numeric;
+} g_testerStateFields[] =
+{
+	{"ROUT_PORT_RES_RF1A",      STATE_GROUP_ROUT,   false},
+	{"ROUT_PORT_RES_RF2A",      STATE_GROUP_ROUT,   false},
+	{"ROUT_PORT_RES_RF3A",      STATE_GROUP_ROUT,   false},
+	{"ROUT_PORT_RES_RF4A",      STATE_GROUP_ROUT,   false},
+	{"ROUT_PORT_RES_STRM1A",    STATE_GROUP_ROUT,   false},
+	{"VSA_FREQ",                STATE_GROUP_VSA,    true },
+	{"VSA_FREQ_LOOF",           STATE_GROUP_VSA,    true },
+	{"VSA_SRATE",               STATE_GROUP_VSA,    true },
+	{"VSA_RLEV",                STATE_GROUP_VSA,    true },
+	{"VSA_TRIG_LEV",            STATE_GROUP_VSA,    true },
+	{"VSA_TRIG_OFFS",           STATE_GROUP_VSA,    true },
+	{"VSA_TRIG_TIME",           STATE_GROUP_VSA,    true },
+	{"VSA_TRIG_SOUR",           STATE_GROUP_VSA,    false},
+	{"VSA_TRIG_MODE",           STATE_GROUP_VSA,    false},
+	{"VSA_TRIG_SLOPE",          STATE_GROUP_VSA,    false},
+	{"VSA_TRIG_TYPE",           STATE_GROUP_VSA,    false},
+	{"VSA_MEAS_COUP",           STATE_GROUP_VSA,    false},
+	{"VSG_FREQ",                STATE_GROUP_VSG,    true },
+	{"VSG_FREQ_LOOF",           STATE_GROUP_VSG,    true },
+	{"VSG_SRATE",               STATE_GROUP_VSG,    true },
+	{"VSG_POW_LEV",             STATE_GROUP_VSG,    true },
+	{"VSG_POW_STATUS",          STATE_GROUP_VSG,    false},
+	{"VSG_TRIG_SOUR",           STATE_GROUP_VSG,    false},
+	{"VSG_TRIG_MODE",           STATE_GROUP_VSG,    false},
+	{"VSG_TRIG_SLOPE",          STATE_GROUP_VSG,    false},
+	{"VSG_TRIG_TYPE",           STATE_GROUP_VSG,    false},
+	{"SYS_FORM_DATA",           STATE_GROUP_SYS,    false}
+};
+
+// Compare two parameter strings the way the tester would see them
+static bool sameStateValue(const string &value1, const string &value2, bool numeric)
+{
+	if (value1 == value2)
+		return true;
+	else if (numeric && !value1.empty() && !value2.empty())
+		return atof(value1.c_str()) == atof(value2.c_str());
 	else
-	{
-		queryStr = "?";                             // query string remains "?"
-	}
-
-	map<string, string>::iterator it;
-	it = testerStateMap.find(testerStateName);      // find input cmd tester state in the tester state map
+		return false;
+}
 
+void CIQxstream::CreateTesterStateModel(void)
+{
+	testerState.clear();
+	testerStateIndex.clear();
+	dirtyState.clear();
+	flushedState.clear();
 
-	if (it==testerStateMap.end())                   // tester state doesn't exist in local map, return 1
+	for (int i=0; i<(int)(sizeof(g_testerStateFields)/sizeof(g_testerStateFields[0])); i++)
 	{
-		retErr = 2;
+		TESTER_STATE_FIELD field;
+		field.scpiCmdKey    = g_testerStateFields[i].scpiCmdKey;
+		field.group         = g_testerStateFields[i].group;
+		field.numeric       = g_testerStateFields[i].numeric;
+		field.known         = false;
+		field.dirty         = false;
+		field.scpiCmd       = ConvertToScpi((char*)field.scpiCmdKey);
+		testerState.push_back(field);
+		testerStateIndex.insert(pair<string, int>(field.scpiCmdKey, i));
 	}
-	else                                            // tester state exists in stateMapp, then compare it with expected state
+}
+
+int CIQxstream::SetTesterState(char *scpiCmdKey, char *parameters)
+{
+	map<string, int>::iterator it = testerStateIndex.find(scpiCmdKey);
+	if (it==testerStateIndex.end())
 	{
-		string currentParaStr = it->second;         // erase '\n' in currentParaStr
-		size_t found = currentParaStr.find('\n');
-		if(found !=string::npos)
-			currentParaStr.erase(found,found+1);
+		return -1;                                                  // not a setting, or not in the model: send it now
+	}
 
-		found = targetParaStr.find('\n');           // erase '\n' in targetParaStr
-		if(found !=string::npos)
-			targetParaStr.erase(found,found+1);
+	TESTER_STATE_FIELD &field = testerState[it->second];
+	string targetValue = parameters;
+	size_t found = targetValue.find('\n');                          // erase '\n' in the parameters
+	if (found!=string::npos)
+		targetValue.erase(found);
 
-		if(targetParaStr.compare(currentParaStr)== 0) // the same
-		{
-			retErr = 0;
-			sprintf_s(scpiRxBuffer,SCPI_RX_BUFFER_SIZE,"%s",currentParaStr.c_str()); // copy to scpiRxBuffer return
-		}
-		else if(atof(currentParaStr.c_str()) && atof(targetParaStr.c_str()) ) // check double value are the same
+	if (field.known && sameStateValue(field.testerValue, targetValue, field.numeric))
+	{
+		if (field.dirty)                                            // set back before it was sent, e.g. RF1A OFF then RF1A VSA1
 		{
-			double currVal = atof(currentParaStr.c_str());
-			double targVal = atof( targetParaStr.c_str());
-			if (currVal == targVal)
+			field.dirty = false;
+			for (vector<int>::iterator dirty_Iter=dirtyState.begin(); dirty_Iter!=dirtyState.end(); dirty_Iter++)
 			{
-				retErr = 0; // double values match,
-				sprintf_s(scpiRxBuffer,SCPI_RX_BUFFER_SIZE,"%s",currentParaStr.c_str()); // copy to scpiRxBuffer return
+				if (*dirty_Iter==it->second)
+				{
+					dirtyState.erase(dirty_Iter);
+					break;
+				}
 			}
-			else
-				retErr = 1;    // double values don't match,
-		}
-		else
-		{
-			retErr = 1;
 		}
+		return 0;
 	}
 
-	return retErr;
+	field.targetValue = targetValue;
+	if (!field.dirty)
+	{
+		field.dirty = true;
+		dirtyState.push_back(it->second);
+	}
+	return 1;
 }
 
-// 12/29/12, added by Jacky,
-// update the local tester status table
-int CIQxstream::UpdateLocalState(char *scpiCmdKey, char *parameters, bool checkStatus, char *scpiReturn)
+string CIQxstream::TakeDirtyState(int *count)
 {
-	// in two conditions, it is required to update the local state map
-	// 1) scpi state name exists, but has different values
-	// 2) scpi state name doesnot exist, need to insert
-	// Before updating the local state, need to query from the tester directly
-
-	int     retErr          = 0;
-	int     rxLen           = 0;                                                    // scpi return length
-	char    *pch            = NULL;                                                 //
-	string  testerStateName = scpiCmdKey;
-	string  targetParaStr   = parameters;
-	string  currentParaStr  = "";
-	string  queryStr        = "?";
-
-	if(!checkStatus)
-		return 0;                                                                   // bypass all following operation if checkStatus is disable
+	string block = "";
 
-
-	if (strstr(scpiCmdKey, "ROUT_PORT_RES"))
+	*count = (int)dirtyState.size();
+	for (vector<int>::iterator dirty_Iter=dirtyState.begin(); dirty_Iter!=dirtyState.end(); dirty_Iter++)
 	{
-		testerStateName     += "_Q";                                                //
-		queryStr            =  "";                                                  //
-	}
-	else
-	{
-		queryStr = "?";                                                              // query string remains "?"
+		TESTER_STATE_FIELD &field = testerState[*dirty_Iter];
+		block.append(field.scpiCmd);
+		block.append(" ");
+		block.append(field.targetValue);
+		block.append("\n");
+
+		field.testerValue   = field.targetValue;
+		field.known         = true;
+		field.dirty         = false;
+		flushedState.push_back(*dirty_Iter);
 	}
+	dirtyState.clear();
 
-	//** query state from the tester directly
-	SendCommand((char*)testerStateName.c_str(),(char*)queryStr.c_str(),true,false); // cmd directly to tester
-	if(targetParaStr.empty())
-	{
-		if(0==strcmp(scpiReturn,""))
-			targetParaStr = scpiReturn;
-		else
-			targetParaStr = scpiRxBuffer;
-	}
+	return block;
+}
 
-	//** find insert point in stateMap
-	map<string, string>::iterator it;
-	it = testerStateMap.find(testerStateName);                                      // find input cmd tester state in the tester state map
-	if (it==testerStateMap.end())                                                   // tester state doesn't exist in local map, insert a new one
+void CIQxstream::CheckFlushedState(void)
+{
+	// "0,..." is no error; anything else, or no answer, means a flushed setting may have been
+	// rejected, and the queue does not tell which one
+	if (strlen(scpiRxBuffer)==0 || atoi(scpiRxBuffer)!=0)
 	{
-		testerStateMap.insert(pair<string,string>(testerStateName, targetParaStr));
-		if (bEnableDebugMessage && bEnableTesterStatePrint)                           // print updated tester state
+		for (vector<int>::iterator flushed_Iter=flushedState.begin(); flushed_Iter!=flushedState.end(); flushed_Iter++)
 		{
-			set_color(LIGHT_GREEN);
-			LogPrintf("[SCPI] [%s] is added to testerStateMap! SIZE(%d) \n", testerStateName.c_str(),testerStateMap.size());
-			LogPrintf("[SCPI] [%s] = %s \n", testerStateName.c_str(),targetParaStr.c_str());
-			set_color(WHITE);
+			testerState[*flushed_Iter].known = false;
 		}
 	}
-	else                                                                            // tester state exists, and update its value
-	{
-		if (bEnableDebugMessage && bEnableTesterStatePrint)                           // print tester state, before updating
-		{
-			set_color(LIGHT_GREEN);
-			LogPrintf("[SCPI] [%s] = %s \n", testerStateName.c_str(),it->second.c_str());
-		}
-		it->second.assign(targetParaStr.c_str());                                   // update tester status in local state map
-
+	flushedState.clear();
+}
 
-		if (bEnableDebugMessage && bEnableTesterStatePrint)                           // print tester state, after updating
+void CIQxstream::InvalidateTesterState(int group)
+{
+	for (vector<TESTER_STATE_FIELD>::iterator state_Iter=testerState.begin(); state_Iter!=testerState.end(); state_Iter++)
+	{
+		if (STATE_GROUP_ALL==group || state_Iter->group==group)
 		{
-			LogPrintf("[SCPI] [%s] is updated to: %s \n", testerStateName.c_str(),it->second.c_str());
-			set_color(WHITE);
+			state_Iter->known = false;                              // dirty settings stay dirty, they still have to be sent
 		}
 	}
+}
 
-	// double check from the map, which is not necessary
-	int statusTmp = CheckLocalState(scpiCmdKey, parameters,true);                      // double check the status
-	if(statusTmp != 0)                                                                 // update status fails!
+void CIQxstream::ForgetChangedState(char *command, char *cmd2, bool scpiKeyUsed)
+{
+	if (!scpiKeyUsed)
 	{
-		set_color(RED);
-		LogPrintf(("ERROR:UpdateLocalState() fails !!!\n"));
-		set_color(WHITE);
-		retErr = -1;
+		if (!strstr(command, "?") && !strstr(cmd2, "?"))
+			InvalidateTesterState(STATE_GROUP_ALL);                 // direct SCPI setting, could be anything
+	}
+	else if (!strcmp(command, "SYS_RST") || !strcmp(command, "SYS_CLEAR_MODULE") || strstr(command, "_MRST"))
+	{
+		InvalidateTesterState(STATE_GROUP_ALL);
+	}
+	else if (!strcmp(command, "ROUT_MRCL"))
+	{
+		InvalidateTesterState(STATE_GROUP_ROUT);
+	}
+	else if (!strcmp(command, "VSA_RLEV_AUTO"))
+	{
+		RemoveTesterState("VSA_RLEV");
+	}
+	else
+	{
+		// do nothing
 	}
-
-	return retErr;
 }
 
+bool CIQxstream::IsStatePending(void)
+{
+	return !dirtyState.empty();
+}
 
 void CIQxstream::ClearTesterStateMap(void)
 {
-	testerStateMap.clear();     // clear testerStateMap
+	InvalidateTesterState(STATE_GROUP_ALL);
+	for (vector<TESTER_STATE_FIELD>::iterator state_Iter=testerState.begin(); state_Iter!=testerState.end(); state_Iter++)
+	{
+		state_Iter->dirty = false;                                  // nothing set before a (re)connection is sent after it
+	}
+	dirtyState.clear();
+	flushedState.clear();
 }
 
 void CIQxstream::CreatScpiMap(void)
@@ -1055,11 +1105,11 @@ void CIQxstream::ClearResultHistory(void)
 
 void CIQxstream::RemoveTesterState(char *scpiCmdKey)
 {
-	map <string, string>::iterator it;
-	it = testerStateMap.find(scpiCmdKey);
-	if(it!=testerStateMap.end())
+	map <string, int>::iterator it;
+	it = testerStateIndex.find(scpiCmdKey);
+	if(it!=testerStateIndex.end())
 	{
-		testerStateMap.erase(it);
+		testerState[it->second].known = false;
 	}
 }
 
@@ -13,6 +13,8 @@
 #include <sys/timeb.h>
 #include <time.h>
 #include "string"
+#include <vector>
+#include <map>
 using namespace std;
 #include "IQlite_Logger.h"
 
@@ -41,6 +43,21 @@ using namespace std;
 #endif
 
 enum {FAIL, PASS};
+
+// Tester shadow model, see CIQxstream::SetTesterState()
+enum TESTER_STATE_GROUP {STATE_GROUP_ALL = -1, STATE_GROUP_ROUT, STATE_GROUP_VSA, STATE_GROUP_VSG, STATE_GROUP_SYS};
+
+struct TESTER_STATE_FIELD                                                               // one setting of the tester shadow model
+{
+	const char  *scpiCmdKey;                                                            // SCPI keyword of the setting in ScpiMap
+	int         group;                                                                  // TESTER_STATE_GROUP the setting belongs to
+	bool        numeric;                                                                // compare values as doubles, "2412000000.000000" == "2.412e9"
+	bool        known;                                                                  // testerValue is what the tester has
+	bool        dirty;                                                                  // targetValue has not been sent yet
+	string      scpiCmd;                                                                // SCPI command, looked up once from ScpiMap
+	string      testerValue;                                                            // last value sent to the tester
+	string      targetValue;                                                            // value to send with the next flush
+};
 enum {BLACK, BLUE, GREEN, CYAN, RED, MEGNETA, YELLOW, WHITE, GREY, LIGHT_BLUE, LIGHT_GREEN, LIGHT_CYAN, LIGHT_RED, LIGHT_MAGENTA, LIGHT_YELLOW, LIGHT_WHITE};
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -60,8 +77,9 @@ class CIQxstream
 				);                                                              //
 		int     SendCommand_only(char *command, char* cmd2 ="", bool scpiKeyUsed= false);   // Jarir included this function only for SaveVsaSignalFile, can be removed later, after some functions moved from IQmeasure_SCPI.cpp to IQxstream_API.cpp, 12/9/11
 		void    LogPrintf(const char *format, ...);                                         // Print log information to log file and console screen.
-		void    ClearTesterStateMap(void);                                                  // Clear testerStateMap
-		void    RemoveTesterState(char *scpiCmdKey);                                        // remove a center tester state from local tester state map
+		void    ClearTesterStateMap(void);                                                  // Forget the whole tester shadow model, e.g. after connecting
+		void    RemoveTesterState(char *scpiCmdKey);                                        // Forget one setting of the tester shadow model
+		bool    IsStatePending(void);                                                       // whether settings are waiting for the next flush
 		void    DebugEnable(bool enable = true);                                            // turn on SCPI related debug information if enable = true, otherwise disable
 		bool    GetLogDebug(void);                                                          // return a bool flag that controls log
 		bool    GetLogScpiKey(void);                                                        // return a bool flag that controls Scpi-key log
@@ -84,22 +102,17 @@ class CIQxstream
 	public:     //** public variables here please! **
 		SOCKET  connectSocket;                                                              //
 		char    *scpiRxBuffer;                                                              // Save most recent SCPI command return values, its size is [SCPI_RX_BUFFER_SIZE]
-		map <string, string> testerStateMap;                                                // a map that store current tester status
 		int     m_iCmdDataSize;
 
 	private:    //** private functions here! **
 		void    CreatScpiMap(void);                                                         // Create a map that stores all supported SCPI commands and their corresponding SCPI_keywords.
 		string  ConvertToScpi(char *cmdKey);                                                // Convert SCPI key to SCPI command.
-		int     UpdateLocalState(char *scpiCmdKey,                                          // update tester state map
-				char *parameters,                                          //
-				bool checkStatus = false,                                  //
-				char *scpiReturn = ""                                      // the scpi return for current scpi command
-				);                                                          //
-		int     CheckLocalState(char *scpiCmdKey,                                           // check from the tester state map to see whether the tester status need to be changed
-				char *parameters,                                           //
-				bool checkStatus = false                                    //
-				) ;                                                         //
-		//int     getLocalState(char *scpiCmdKey, char *parameters);                        // get tester status from local state map, it may change to a PUBLIC:
+		void    CreateTesterStateModel(void);                                               // Create the tester shadow model, after CreatScpiMap()
+		int     SetTesterState(char *scpiCmdKey, char *parameters);                         // 0 = tester has it, 1 = marked dirty, -1 = not in the shadow model
+		string  TakeDirtyState(int *count);                                                 // SCPI block of all dirty settings, which are clean afterwards
+		void    CheckFlushedState(void);                                                    // after SYST:ERR?, forget the flushed settings if it reports an error
+		void    InvalidateTesterState(int group);                                           // forget the settings of a TESTER_STATE_GROUP
+		void    ForgetChangedState(char *command, char *cmd2, bool scpiKeyUsed);            // forget settings a command may have changed on the tester
 
 	private:    //** private member variables here: **
 		int     statusSocket;                                                                     // used only in scpi socket communications
@@ -112,6 +125,10 @@ class CIQxstream
 		struct  __timeb64   timerStart;                                                     //
 		struct  __timeb64   timerStop;                                                      //
 		map<string, string> ScpiMap;                                                        // SCPI command map that stores all supported SCPI commands and their corresponding keys.
+		vector<TESTER_STATE_FIELD>  testerState;                                            // tester shadow model
+		map<string, int>    testerStateIndex;                                               // SCPI keyword -> index in testerState
+		vector<int>         dirtyState;                                                     // dirty settings, in the order they were set
+		vector<int>         flushedState;                                                   // settings flushed since the last SYST:ERR?
 		map<string, vector<double>>  resultHistory;                                         // measurement result history
 		string  testerType;                                                                 // current tester type used
 		string  testerSerialNumber;                                                         // current tester serial number
@@ -5,7 +5,6 @@
 //#include "lp_stdio.h"
 #include "iqapi.h"
 #include "..\IQmeasure.h"
-//#include "..\DebugAlloc.h"
 #include "IQlite_Timer.h"
 #include "IQlite_Logger.h"
 #include "StringUtil.h"
@@ -4976,6 +4975,46 @@ IQMEASURE_API double LP_GetScalarMeasurement(char *measurement, int index)
 	return value;
 }
 
+IQMEASURE_API int LP_GetScalarMeasurementArray(char *measurement, double values[], int bufferLength)
+{
+	::TIMER_StartTimer(timerIQmeasure, "LP_GetScalarMeasurementArray", &timeStart);
+
+	int validCount = 0;
+	CIQmeasure_Scpi *scpiPt = NULL;
+	if(true == g_useScpi)
+	{
+		scpiPt = dynamic_cast <CIQmeasure_Scpi *> (iqMeasure);
+	}
+	else{}
+
+	for (int i=0;i<bufferLength;i++)
+	{
+		if(NULL != scpiPt)
+		{
+			values[i] = scpiPt->GetScalarMeasurement(measurement, i);
+		}
+		else if(g_useIQapi)
+		{
+			values[i] = LP_GetScalarMeasurement_NoTimer(measurement, i);
+		}
+		else
+		{
+			values[i] = NA_NUMBER;
+		}
+
+		if (NA_NUMBER!=values[i])
+		{
+			validCount++;
+		}
+		else{}
+	}
+
+	::TIMER_StopTimer(timerIQmeasure, "LP_GetScalarMeasurementArray", &timeDuration, &timeStop);
+	::LOGGER_Write_Ext(LOG_IQMEASURE, loggerIQmeasure, LOGGER_INFORMATION, "[IQMEASURE]-[%s]:%.2f,ms\n", "LP_GetScalarMeasurementArray", timeDuration);
+
+	return validCount;
+}
+
 // Keep this function with typo for backward compatibility
 IQMEASURE_API int LP_GetVectorMeasurment(char *measurement, double bufferReal[], double bufferImag[], int bufferLength)
 {
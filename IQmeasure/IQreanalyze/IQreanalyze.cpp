@@ -0,0 +1,694 @@
+// IQreanalyze.cpp : runs IQmeasure analysis again on saved captures, no tester needed
+//
+// Usage:
+//   IQreanalyze <capture directory | index file> <analysis .ini> [result .csv] [-workers N]
+//
+// Captures are the files saved by WiFiSaveSigFile()/BTSaveSigFile() (.sig, .iqvsa), by
+// LP_CaptureArchiveSave() (.iqz) or by LP_SaveCaptureCompact() (.iqc).  A directory is scanned
+// for these extensions; an index file lists one capture per line, or is the capture_index.csv
+// of a capture archive.  IQreanalyze.ini describes the analysis settings.
+//
+// The IQapi handle behind IQmeasure is one per process, so the captures are shared out to
+// worker processes, one per core by default, each with its own LP_Init().  A worker takes the
+// next capture from a counter shared by all workers, a long capture does not hold up the rest.
+//
+// Result .csv, one line per TestManager return, in capture order:
+//   Index,Capture,Name,Value,Unit
+// ERROR_MESSAGE is empty when the capture was analyzed, as in the returns of a test item.
+
+#include "stdafx.h"
+#include "IQmeasure.h"
+#include "CaptureIndex.h"
+#include <math.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+#define REANALYZE_BUFFER_SIZE		1024
+#define REANALYZE_MAX_STREAMS		4
+#define REANALYZE_SECTION			"ANALYSIS"
+#define REANALYZE_WORKER_OPTION		"-worker"
+#define REANALYZE_INDEX_HEADER		"Timestamp,"		// capture_index.csv of LP_CaptureArchiveStart()
+#define REANALYZE_NA_NUMBER			-99999.99
+
+typedef struct tagAnalysisConfig
+{
+	char	type[REANALYZE_BUFFER_SIZE];			// 11AG, 11B, 11N, 11AC or BT
+	int		testerType;
+	double	freqMHz;								// FREQ_ERROR_AVG is in ppm of this frequency
+	double	cableLossDb;
+
+	int		ph_corr_mode;
+	int		ch_estimate;
+	int		sym_tim_corr;
+	int		freq_sync;
+	int		ampl_track;
+
+	int		eq_taps;
+	int		DCremove11b_flag;
+	int		method_11b;
+
+	int		phaseCorr11n;
+	int		symTimingCorr11n;
+	int		amplitudeTracking11n;
+	int		decodePSDU11n;
+	int		fullPacketChannelEst11n;
+	int		frequencyCorr11n;
+	char	referenceFile[REANALYZE_BUFFER_SIZE];
+
+	double	btDataRate;
+} ANALYSIS_CONFIG;
+
+typedef struct tagReturnPair
+{
+	string	name;
+	string	value;
+	string	unit;
+} RETURN_PAIR;
+
+typedef pair<int, string> RESULT_LINE;		// capture index, line of the result file
+
+static void AddReturn(vector<RETURN_PAIR> &returns, const char *name, double value, const char *unit)
+{
+	char buffer[REANALYZE_BUFFER_SIZE];
+	sprintf_s(buffer, REANALYZE_BUFFER_SIZE, "%.4f", value);
+
+	RETURN_PAIR returnPair;
+	returnPair.name  = name;
+	returnPair.value = buffer;
+	returnPair.unit  = unit;
+	returns.push_back(returnPair);
+}
+
+static void AddStreamReturn(vector<RETURN_PAIR> &returns, const char *name, int stream, double value, const char *unit)
+{
+	char buffer[REANALYZE_BUFFER_SIZE];
+	sprintf_s(buffer, REANALYZE_BUFFER_SIZE, "%s_%d", name, stream+1);
+	AddReturn(returns, buffer, value, unit);
+}
+
+// Same as AverageTestResult() of the test DLLs, RMS_LOG_20 for EVM and LOG_10 for power
+static double AverageDb(const double *valueDb, int count)
+{
+	double sum = 0.0;
+	for (int i=0;i<count;i++)
+	{
+		sum += pow(10.0, valueDb[i]/10.0);
+	}
+	return (0<count) ? 10.0*log10(sum/count) : REANALYZE_NA_NUMBER;
+}
+
+static void ReadConfig(const char *configFile, ANALYSIS_CONFIG *config)
+{
+	char buffer[REANALYZE_BUFFER_SIZE];
+
+	GetPrivateProfileStringA(REANALYZE_SECTION, "TYPE", "11AG", config->type, REANALYZE_BUFFER_SIZE, configFile);
+	_strupr_s(config->type, REANALYZE_BUFFER_SIZE);
+	config->testerType = GetPrivateProfileIntA(REANALYZE_SECTION, "TESTER_TYPE", IQTYPE_XEL, configFile);
+	GetPrivateProfileStringA(REANALYZE_SECTION, "FREQ_MHZ", "0", buffer, REANALYZE_BUFFER_SIZE, configFile);
+	config->freqMHz = atof(buffer);
+	GetPrivateProfileStringA(REANALYZE_SECTION, "CABLE_LOSS_DB", "0", buffer, REANALYZE_BUFFER_SIZE, configFile);
+	config->cableLossDb = atof(buffer);
+
+	// Same names and defaults as the global settings of WiFi_Test
+	config->ph_corr_mode            = GetPrivateProfileIntA(REANALYZE_SECTION, "ANALYSIS_11AG_PH_CORR_MODE", 2, configFile);
+	config->ch_estimate             = GetPrivateProfileIntA(REANALYZE_SECTION, "ANALYSIS_11AG_CH_ESTIMATE", 1, configFile);
+	config->sym_tim_corr            = GetPrivateProfileIntA(REANALYZE_SECTION, "ANALYSIS_11AG_SYM_TIM_CORR", 2, configFile);
+	config->freq_sync               = GetPrivateProfileIntA(REANALYZE_SECTION, "ANALYSIS_11AG_FREQ_SYNC", 2, configFile);
+	config->ampl_track              = GetPrivateProfileIntA(REANALYZE_SECTION, "ANALYSIS_11AG_AMPL_TRACK", 1, configFile);
+	config->eq_taps                 = GetPrivateProfileIntA(REANALYZE_SECTION, "ANALYSIS_11B_EQ_TAPS", 1, configFile);
+	config->DCremove11b_flag        = GetPrivateProfileIntA(REANALYZE_SECTION, "ANALYSIS_11B_DC_REMOVE_FLAG", 0, configFile);
+	config->method_11b              = GetPrivateProfileIntA(REANALYZE_SECTION, "ANALYSIS_11B_METHOD_11B", 1, configFile);
+	config->phaseCorr11n            = GetPrivateProfileIntA(REANALYZE_SECTION, "ANALYSIS_11N_PHASE_CORR", 1, configFile);
+	config->symTimingCorr11n        = GetPrivateProfileIntA(REANALYZE_SECTION, "ANALYSIS_11N_SYM_TIMING_CORR", 1, configFile);
+	config->amplitudeTracking11n    = GetPrivateProfileIntA(REANALYZE_SECTION, "ANALYSIS_11N_AMPLITUDE_TRACKING", 0, configFile);
+	config->decodePSDU11n           = GetPrivateProfileIntA(REANALYZE_SECTION, "ANALYSIS_11N_DECODE_PSDU", 0, configFile);
+	config->fullPacketChannelEst11n = GetPrivateProfileIntA(REANALYZE_SECTION, "ANALYSIS_11N_FULL_PACKET_CHANNEL_EST", 0, configFile);
+	config->frequencyCorr11n        = GetPrivateProfileIntA(REANALYZE_SECTION, "ANALYSIS_11N_FREQUENCY_CORRELATION", 2, configFile);
+	GetPrivateProfileStringA(REANALYZE_SECTION, "REFERENCE_FILE", "", config->referenceFile, REANALYZE_BUFFER_SIZE, configFile);
+
+	GetPrivateProfileStringA(REANALYZE_SECTION, "BT_DATA_RATE", "0", buffer, REANALYZE_BUFFER_SIZE, configFile);
+	config->btDataRate = atof(buffer);
+}
+
+static string FileExtension(const string &fileName)
+{
+	size_t dot = fileName.find_last_of('.');
+	string extension = (string::npos==dot) ? "" : fileName.substr(dot);
+	transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+	return extension;
+}
+
+static bool IsCaptureFile(const string &fileName)
+{
+	string extension = FileExtension(fileName);
+	return ( ".sig"==extension || ".iqvsa"==extension || ".iqz"==extension || ".iqc"==extension );
+}
+
+static string FullPath(const string &fileName)
+{
+	char fullPath[MAX_PATH] = {'\0'};
+	if ( 0==GetFullPathNameA(fileName.c_str(), MAX_PATH, fullPath, NULL) )
+	{
+		return fileName;
+	}
+	else
+	{
+		return fullPath;
+	}
+}
+
+static string DirectoryOf(const string &fileName)
+{
+	size_t slash = fileName.find_last_of("\\/");
+	return (string::npos==slash) ? "." : fileName.substr(0, slash);
+}
+
+static bool FileExists(const string &fileName)
+{
+	return ( INVALID_FILE_ATTRIBUTES!=GetFileAttributesA(fileName.c_str()) );
+}
+
+static void ListCaptureDirectory(const string &directory, vector<string> &captures)
+{
+	WIN32_FIND_DATAA findData;
+	HANDLE find = FindFirstFileA((directory + "\\*").c_str(), &findData);
+	if (INVALID_HANDLE_VALUE==find)
+	{
+		return;
+	}
+
+	do
+	{
+		if ( 0==(findData.dwFileAttributes&FILE_ATTRIBUTE_DIRECTORY) && IsCaptureFile(findData.cFileName) )
+		{
+			captures.push_back(FullPath(directory + "\\" + findData.cFileName));
+		}
+		else
+		{
+			// do nothing
+		}
+	} while (FindNextFileA(find, &findData));
+	FindClose(find);
+
+	sort(captures.begin(), captures.end());
+}
+
+// One capture per line; lines of a capture_index.csv give the file in the 4th column
+static void ListCaptureIndex(const string &indexFile, vector<string> &captures)
+{
+	FILE *fp = NULL;
+	if ( 0!=fopen_s(&fp, indexFile.c_str(), "r") || NULL==fp )
+	{
+		return;
+	}
+
+	char line[REANALYZE_BUFFER_SIZE];
+	bool archiveIndex = false;
+	vector<string> fields;
+	while (NULL!=fgets(line, REANALYZE_BUFFER_SIZE, fp))
+	{
+		string capture = line;
+		capture.erase(capture.find_last_not_of(" \t\r\n")+1);
+		if (capture.empty() || '#'==capture[0])
+		{
+			continue;
+		}
+		else if (0==capture.find(REANALYZE_INDEX_HEADER))
+		{
+			archiveIndex = true;
+			continue;
+		}
+		else if (archiveIndex)
+		{
+			CaptureIndexSplit(capture.c_str(), fields);
+			if (CAPTURE_INDEX_FILE_COLUMN>=fields.size())
+			{
+				continue;
+			}
+			capture = fields[CAPTURE_INDEX_FILE_COLUMN];
+		}
+		else
+		{
+			// do nothing
+		}
+
+		// Relative names are relative to the test program that saved them, or to the index file
+		if ( !FileExists(capture) && FileExists(DirectoryOf(indexFile) + "\\" + capture) )
+		{
+			capture = DirectoryOf(indexFile) + "\\" + capture;
+		}
+		else
+		{
+			// do nothing
+		}
+		captures.push_back(FullPath(capture));
+	}
+	fclose(fp);
+}
+
+static int LoadCapture(const string &capture)
+{
+	string extension = FileExtension(capture);
+	if (".iqc"==extension)
+	{
+		return LP_LoadCaptureCompact((char*)capture.c_str());
+	}
+	else if (".iqz"==extension)
+	{
+		char tempPath[MAX_PATH] = {'\0'};
+		char sigFileName[MAX_PATH] = {'\0'};
+		GetTempPathA(MAX_PATH, tempPath);
+		if (0==GetTempFileNameA(tempPath, "iqz", 0, sigFileName))
+		{
+			return ERR_LOAD_WAVE_FAILED;
+		}
+
+		int err = LP_CaptureArchiveRestore((char*)capture.c_str(), sigFileName);
+		if (ERR_OK==err)
+		{
+			err = LP_LoadVsaSignalFile(sigFileName);
+		}
+		else
+		{
+			// do nothing
+		}
+		DeleteFileA(sigFileName);
+		return err;
+	}
+	else
+	{
+		return LP_LoadVsaSignalFile((char*)capture.c_str());
+	}
+}
+
+// Returns of WiFi_TX_Verify_EVM for one capture of a single stream (11a/g/b)
+static int GetSisoReturns(const ANALYSIS_CONFIG &config, bool mode11b, vector<RETURN_PAIR> &returns, string &errorMessage)
+{
+	double evm   = LP_GetScalarMeasurement("evmAll", 0);
+	double power = LP_GetScalarMeasurement("rmsPowerNoGap", 0);
+	if ( -99.00>=evm || -99.00>=power )
+	{
+		errorMessage = "LP_GetScalarMeasurement() return error.";
+		return -1;
+	}
+
+	AddReturn(returns, "EVM_AVG_DB", evm, "dB");
+	AddReturn(returns, "EVM_AVG_PERCENT", 100*pow(10, evm/20), "%");
+	if (mode11b)
+	{
+		AddReturn(returns, "EVM_PK_DB", LP_GetScalarMeasurement("evmPk", 0), "dB");
+		AddReturn(returns, "DATA_RATE", LP_GetScalarMeasurement("bitRateInMHz", 0), "");
+	}
+	else
+	{
+		AddReturn(returns, "DATA_RATE", LP_GetScalarMeasurement("dataRate", 0), "");
+	}
+	AddReturn(returns, "POWER_AVG_DBM", power+config.cableLossDb, "dBm");
+	AddReturn(returns, "AMP_ERR_DB", LP_GetScalarMeasurement("ampErrDb", 0), "dB");
+	AddReturn(returns, "PHASE_ERR", LP_GetScalarMeasurement("phaseErr", 0), "Degree");
+	AddReturn(returns, "PHASE_NOISE_RMS_ALL", LP_GetScalarMeasurement("rmsPhaseNoise", 0), "Degree");
+	AddReturn(returns, "SYMBOL_CLK_ERR", LP_GetScalarMeasurement("clockErr", 0), "ppm");
+	AddReturn(returns, "FREQ_ERROR_AVG", (0<config.freqMHz) ? LP_GetScalarMeasurement("freqErr", 0)/config.freqMHz : REANALYZE_NA_NUMBER, "ppm");
+	AddReturn(returns, "SPATIAL_STREAM", 1, "");
+
+	return ERR_OK;
+}
+
+// Returns of WiFi_TX_Verify_EVM for one capture of a MIMO (11n/11ac nxn) signal
+static int GetMimoReturns(const ANALYSIS_CONFIG &config, vector<RETURN_PAIR> &returns, string &errorMessage)
+{
+	double evm[REANALYZE_MAX_STREAMS]   = {0.0};
+	double power[REANALYZE_MAX_STREAMS] = {0.0};
+
+	int streams = (int)LP_GetScalarMeasurement("rateInfo_spatialStreams", 0);
+	if ( 0>=streams || REANALYZE_MAX_STREAMS<streams )
+	{
+		errorMessage = "LP_GetScalarMeasurement(rateInfo_spatialStreams) return error.";
+		return -1;
+	}
+
+	for (int i=0;i<streams;i++)
+	{
+		evm[i]   = LP_GetScalarMeasurement("evmAvgAll", i);
+		power[i] = LP_GetScalarMeasurement("rxRmsPowerDb", i*(streams+1));
+		if ( -99.00>=evm[i] || -99.00>=power[i] )
+		{
+			errorMessage = "LP_GetScalarMeasurement() return error.";
+			return -1;
+		}
+		power[i] += config.cableLossDb;
+		AddStreamReturn(returns, "EVM_AVG", i, evm[i], "dB");
+		AddStreamReturn(returns, "POWER_AVG", i, power[i], "dBm");
+		AddStreamReturn(returns, "AMP_ERR_DB", i, LP_GetScalarMeasurement("IQImbal_amplDb", i), "dB");
+		AddStreamReturn(returns, "PHASE_ERR", i, LP_GetScalarMeasurement("IQImbal_phaseDeg", i), "Degree");
+	}
+
+	double evmAvgDb = AverageDb(evm, streams);
+	AddReturn(returns, "EVM_AVG_DB", evmAvgDb, "dB");
+	AddReturn(returns, "EVM_AVG_PERCENT", 100*pow(10, evmAvgDb/20), "%");
+	AddReturn(returns, "POWER_AVG_DBM", AverageDb(power, streams), "dBm");
+	AddReturn(returns, "DATA_RATE", LP_GetScalarMeasurement("rateInfo_dataRateMbps", 0), "");
+	AddReturn(returns, "PHASE_NOISE_RMS_ALL", LP_GetScalarMeasurement("PhaseNoiseDeg_RmsAll", 0), "Degree");
+	AddReturn(returns, "SYMBOL_CLK_ERR", LP_GetScalarMeasurement("symClockErrorPpm", 0), "ppm");
+	AddReturn(returns, "FREQ_ERROR_AVG", (0<config.freqMHz) ? LP_GetScalarMeasurement("freqErrorHz", 0)/config.freqMHz : REANALYZE_NA_NUMBER, "ppm");
+	AddReturn(returns, "SPATIAL_STREAM", streams, "");
+
+	return ERR_OK;
+}
+
+// Returns of BT_TX_Verify_BDR for one capture
+static int GetBluetoothReturns(const ANALYSIS_CONFIG &config, vector<RETURN_PAIR> &returns, string &errorMessage)
+{
+	if ( 1!=LP_GetScalarMeasurement("valid", 0) )
+	{
+		errorMessage = "BT retrieve analysis results not valid.";
+		return -1;
+	}
+
+	AddReturn(returns, "POWER_AVERAGE_DBM", LP_GetScalarMeasurement("P_av_each_burst", 0)+config.cableLossDb, "dBm");
+	AddReturn(returns, "POWER_PEAK_DBM", LP_GetScalarMeasurement("P_pk_each_burst", 0)+config.cableLossDb, "dBm");
+	AddReturn(returns, "DATA_RATE_DETECT", LP_GetScalarMeasurement("dataRateDetect", 0), "Mbps");
+	AddReturn(returns, "BANDWIDTH_20DB", LP_GetScalarMeasurement("bandwidth20dB", 0)/1000, "MHz");
+	AddReturn(returns, "FREQ_EST", LP_GetScalarMeasurement("freq_est", 0)/1000, "kHz");
+	AddReturn(returns, "PAYLOAD_ERRORS", LP_GetScalarMeasurement("payloadErrors", 0), "");
+
+	return ERR_OK;
+}
+
+static int AnalyzeCapture(const ANALYSIS_CONFIG &config, const string &capture, vector<RETURN_PAIR> &returns, string &errorMessage)
+{
+	int err = LoadCapture(capture);
+	if (ERR_OK!=err)
+	{
+		errorMessage = "Load capture failed. ";
+		errorMessage += LP_GetErrorString(err);
+		return err;
+	}
+
+	string type = config.type;
+	char *referenceFile = ('\0'==config.referenceFile[0]) ? NULL : (char*)config.referenceFile;
+	if ("11AG"==type)
+	{
+		err = LP_Analyze80211ag(config.ph_corr_mode, config.ch_estimate, config.sym_tim_corr, config.freq_sync, config.ampl_track);
+	}
+	else if ("11B"==type)
+	{
+		err = LP_Analyze80211b(config.eq_taps, config.DCremove11b_flag, config.method_11b);
+	}
+	else if ("11N"==type)
+	{
+		err = LP_Analyze80211n("EWC", "nxn", config.phaseCorr11n, config.symTimingCorr11n, config.amplitudeTracking11n,
+							   config.decodePSDU11n, config.fullPacketChannelEst11n, referenceFile, 0, config.frequencyCorr11n);
+	}
+	else if ("11AC"==type)
+	{
+		err = LP_Analyze80211ac("nxn", config.phaseCorr11n, config.symTimingCorr11n, config.amplitudeTracking11n,
+								config.decodePSDU11n, config.fullPacketChannelEst11n, config.frequencyCorr11n, referenceFile);
+	}
+	else if ("BT"==type)
+	{
+		err = LP_AnalyzeBluetooth(config.btDataRate, "AllPlus");
+	}
+	else
+	{
+		errorMessage = "Unknown analysis TYPE " + type + ".";
+		return -1;
+	}
+	if (ERR_OK!=err)
+	{
+		errorMessage = "Analysis failed. ";
+		errorMessage += LP_GetErrorString(err);
+		return err;
+	}
+
+	if ( "11AG"==type || "11B"==type )
+	{
+		return GetSisoReturns(config, "11B"==type, returns, errorMessage);
+	}
+	else if ("BT"==type)
+	{
+		return GetBluetoothReturns(config, returns, errorMessage);
+	}
+	else
+	{
+		return GetMimoReturns(config, returns, errorMessage);
+	}
+}
+
+static void WriteResult(FILE *fp, int index, const string &capture, const string &name, const string &value, const string &unit)
+{
+	// A comma of a message would start a new column
+	string text = value;
+	replace(text.begin(), text.end(), ',', ';');
+	replace(text.begin(), text.end(), '\n', ' ');
+	fprintf(fp, "%d,%s,%s,%s,%s\n", index, capture.c_str(), name.c_str(), text.c_str(), unit.c_str());
+}
+
+static int RunWorker(const char *listFile, const char *configFile, const char *resultFile, const char *counterName)
+{
+	ANALYSIS_CONFIG config;
+	vector<string> captures;
+
+	ReadConfig(configFile, &config);
+	ListCaptureIndex(listFile, captures);
+
+	HANDLE counter = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, counterName);
+	LONG volatile *nextCapture = (NULL==counter) ? NULL : (LONG volatile*)MapViewOfFile(counter, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(LONG));
+	FILE *fp = NULL;
+	if ( NULL==nextCapture || 0!=fopen_s(&fp, resultFile, "w") || NULL==fp )
+	{
+		printf("[ERROR] Worker fails to start.\n");
+		return -1;
+	}
+
+	int err = LP_Init(config.testerType);
+	for (LONG index=InterlockedIncrement(nextCapture)-1; index<(LONG)captures.size(); index=InterlockedIncrement(nextCapture)-1)
+	{
+		vector<RETURN_PAIR> returns;
+		string errorMessage;
+		if (ERR_OK!=err)
+		{
+			errorMessage = "LP_Init() return error.";
+		}
+		else
+		{
+			AnalyzeCapture(config, captures[index], returns, errorMessage);
+		}
+
+		for (size_t i=0;i<returns.size();i++)
+		{
+			WriteResult(fp, index, captures[index], returns[i].name, returns[i].value, returns[i].unit);
+		}
+		WriteResult(fp, index, captures[index], "ERROR_MESSAGE", errorMessage, "");
+	}
+	fclose(fp);
+
+	if (ERR_OK==err)
+	{
+		LP_Term();
+	}
+	else
+	{
+		// do nothing
+	}
+	UnmapViewOfFile((LPCVOID)nextCapture);
+	CloseHandle(counter);
+
+	return ERR_OK;
+}
+
+static bool ReadResults(const char *partFile, vector<RESULT_LINE> &lines)
+{
+	FILE *fp = NULL;
+	if ( 0!=fopen_s(&fp, partFile, "r") || NULL==fp )
+	{
+		return false;
+	}
+
+	char line[REANALYZE_BUFFER_SIZE*2];
+	while (NULL!=fgets(line, sizeof(line), fp))
+	{
+		lines.push_back(RESULT_LINE(atoi(line), line));
+	}
+	fclose(fp);
+
+	return true;
+}
+
+static bool CompareCaptureIndex(const RESULT_LINE &a, const RESULT_LINE &b)
+{
+	return a.first<b.first;
+}
+
+static int RunMaster(const char *source, const char *configFile, const char *resultFile, int workers)
+{
+	vector<string> captures;
+	if ( INVALID_FILE_ATTRIBUTES==GetFileAttributesA(source) || !FileExists(configFile) )
+	{
+		printf("[ERROR] %s or %s not found.\n", source, configFile);
+		return -1;
+	}
+	else if (0!=(GetFileAttributesA(source)&FILE_ATTRIBUTE_DIRECTORY))
+	{
+		ListCaptureDirectory(source, captures);
+	}
+	else
+	{
+		ListCaptureIndex(source, captures);
+	}
+	if (captures.empty())
+	{
+		printf("[ERROR] No capture in %s.\n", source);
+		return -1;
+	}
+
+	workers = min(workers, (int)captures.size());
+	workers = min(workers, MAXIMUM_WAIT_OBJECTS);
+
+	// The workers read the same list, the index of a capture is its line
+	char listFile[MAX_PATH];
+	sprintf_s(listFile, MAX_PATH, "%s.list", resultFile);
+	FILE *fp = NULL;
+	if ( 0!=fopen_s(&fp, listFile, "w") || NULL==fp )
+	{
+		printf("[ERROR] Fail to write %s.\n", listFile);
+		return -1;
+	}
+	for (size_t i=0;i<captures.size();i++)
+	{
+		fprintf(fp, "%s\n", captures[i].c_str());
+	}
+	fclose(fp);
+
+	char counterName[MAX_PATH];
+	sprintf_s(counterName, MAX_PATH, "IQreanalyze_%lu", GetCurrentProcessId());
+	HANDLE counter = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, sizeof(LONG), counterName);
+	LONG volatile *nextCapture = (NULL==counter) ? NULL : (LONG volatile*)MapViewOfFile(counter, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(LONG));
+	if (NULL==nextCapture)
+	{
+		printf("[ERROR] Fail to create the capture counter.\n");
+		DeleteFileA(listFile);
+		return -1;
+	}
+	*nextCapture = 0;
+
+	char exeFile[MAX_PATH] = {'\0'};
+	GetModuleFileNameA(NULL, exeFile, MAX_PATH);
+	string fullConfigFile = FullPath(configFile);
+
+	printf("Analyzing %d capture(s) of %s with %d worker(s)...\n", (int)captures.size(), source, workers);
+	DWORD startTime = GetTickCount();
+
+	vector<HANDLE> processes;
+	char commandLine[REANALYZE_BUFFER_SIZE*4];
+	for (int i=0;i<workers;i++)
+	{
+		STARTUPINFOA startupInfo;
+		PROCESS_INFORMATION processInfo;
+		memset(&startupInfo, 0, sizeof(startupInfo));
+		startupInfo.cb = sizeof(startupInfo);
+
+		sprintf_s(commandLine, sizeof(commandLine), "\"%s\" %s \"%s\" \"%s\" \"%s.%d\" %s",
+				  exeFile, REANALYZE_WORKER_OPTION, listFile, fullConfigFile.c_str(), resultFile, i, counterName);
+		if (CreateProcessA(NULL, commandLine, NULL, NULL, FALSE, 0, NULL, NULL, &startupInfo, &processInfo))
+		{
+			CloseHandle(processInfo.hThread);
+			processes.push_back(processInfo.hProcess);
+		}
+		else
+		{
+			printf("[ERROR] Fail to start worker %d.\n", i);
+		}
+	}
+	if (!processes.empty())
+	{
+		WaitForMultipleObjects((DWORD)processes.size(), &processes[0], TRUE, INFINITE);
+	}
+	else
+	{
+		// do nothing
+	}
+	for (size_t i=0;i<processes.size();i++)
+	{
+		CloseHandle(processes[i]);
+	}
+	UnmapViewOfFile((LPCVOID)nextCapture);
+	CloseHandle(counter);
+	DeleteFileA(listFile);
+
+	// Merge the results of the workers in capture order
+	vector<RESULT_LINE> lines;
+	char partFile[MAX_PATH];
+	for (int i=0;i<workers;i++)
+	{
+		sprintf_s(partFile, MAX_PATH, "%s.%d", resultFile, i);
+		ReadResults(partFile, lines);
+		DeleteFileA(partFile);
+	}
+	stable_sort(lines.begin(), lines.end(), CompareCaptureIndex);
+
+	if ( 0!=fopen_s(&fp, resultFile, "w") || NULL==fp )
+	{
+		printf("[ERROR] Fail to write %s.\n", resultFile);
+		return -1;
+	}
+	fprintf(fp, "Index,Capture,Name,Value,Unit\n");
+	int failed = 0;
+	for (size_t i=0;i<lines.size();i++)
+	{
+		fputs(lines[i].second.c_str(), fp);
+		if ( string::npos!=lines[i].second.find(",ERROR_MESSAGE,") && string::npos==lines[i].second.find(",ERROR_MESSAGE,,") )
+		{
+			failed++;
+		}
+		else
+		{
+			// do nothing
+		}
+	}
+	fclose(fp);
+
+	double elapsedSec = (GetTickCount()-startTime)/1000.0;
+	printf("%d capture(s), %d failed, %.1f s (%.2f captures/s). Results in %s\n",
+		   (int)captures.size(), failed, elapsedSec, (0<elapsedSec) ? captures.size()/elapsedSec : 0.0, resultFile);
+
+	return (0==failed) ? ERR_OK : -1;
+}
+
+int main(int argc, char* argv[])
+{
+	if ( 6==argc && 0==strcmp(argv[1], REANALYZE_WORKER_OPTION) )
+	{
+		return RunWorker(argv[2], argv[3], argv[4], argv[5]);
+	}
+	else if (3>argc)
+	{
+		printf("Usage: IQreanalyze <capture directory | index file> <analysis .ini> [result .csv] [-workers N]\n");
+		return -1;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	SYSTEM_INFO sysInfo;
+	GetSystemInfo(&sysInfo);
+	int workers = (int)sysInfo.dwNumberOfProcessors;
+	const char *resultFile = "IQreanalyze_Result.csv";
+	for (int i=3;i<argc;i++)
+	{
+		if ( 0==strcmp(argv[i], "-workers") && i+1<argc )
+		{
+			workers = max(1, atoi(argv[++i]));
+		}
+		else
+		{
+			resultFile = argv[i];
+		}
+	}
+
+	return RunMaster(argv[1], FullPath(argv[2]).c_str(), resultFile, workers);
+}
@@ -0,0 +1,292 @@
+/*! \file WiFi_RateTable.h
+ * \brief WiFi data rate and channel tables, shared by TestManager, vDUT and the WiFi test DLLs
+ *
+ * The tables are static const data, so nothing is built at load time and a lookup never
+ * allocates.  A rate is found by its index in O(1) and by its name within its family
+ * (at most 32 rows), the family being picked by the name prefix.
+ *
+ * Rates are ordered by index and grouped by family; keep g_wifiRateFamilies in step when
+ * a rate is added.  Channels are ordered by frequency.
+ */
+#ifndef _WIFI_RATE_TABLE_H_
+#define _WIFI_RATE_TABLE_H_
+
+#include <string.h>
+
+typedef enum tagWiFiRateFamily
+{
+	WIFI_RATE_DSSS,
+	WIFI_RATE_CCK,
+	WIFI_RATE_PBCC,
+	WIFI_RATE_OFDM,
+	WIFI_RATE_HT,
+	WIFI_RATE_BT,
+	WIFI_RATE_HALF,			// 802.11p, 10 MHz
+	WIFI_RATE_QUAR			// 802.11p, 5 MHz
+} WIFI_RATE_FAMILY;
+
+typedef struct tagWiFiRateDescriptor
+{
+	const char			*name;				// data rate name of the test items, e.g. "OFDM-54", "MCS7"
+	int					index;				// TM_WiFiConvertDataRateNameToIndex(), same as vDUT_DATA_RATE
+	int					iq2010ExtIndex;		// TM_WiFiConvertDataRateNameToIQ2010ExtIndex(), -1 = none
+	WIFI_RATE_FAMILY	family;
+	double				mbps;				// HT: 20 MHz, long GI. 0 = none
+	double				mbpsHt40;			// HT only: 40 MHz, long GI
+	const char			*waveformKey;		// rate part of the PER_* waveform and packet number settings
+} WIFI_RATE_DESCRIPTOR;
+
+typedef struct tagWiFiChannel
+{
+	int		freqMHz;
+	int		channel;
+} WIFI_CHANNEL;
+
+static const WIFI_RATE_DESCRIPTOR g_wifiRates[] =
+{
+	// name          index  IQ2010Ext  family         Mbps   HT40   waveform key
+	{ "DSSS-1",       0,   0, WIFI_RATE_DSSS,        1,      0, "1"        },
+	{ "DSSS-2",       1,   1, WIFI_RATE_DSSS,        2,      0, "2"        },
+	{ "CCK-5_5",      2,   2, WIFI_RATE_CCK,       5.5,      0, "5_5"      },
+	{ "CCK-11",       3,   3, WIFI_RATE_CCK,        11,      0, "11"       },
+	{ "PBCC-22",      4,  -1, WIFI_RATE_PBCC,       22,      0, "22"       },
+	{ "OFDM-6",       5,   4, WIFI_RATE_OFDM,        6,      0, "6"        },
+	{ "OFDM-9",       6,   5, WIFI_RATE_OFDM,        9,      0, "9"        },
+	{ "OFDM-12",      7,   6, WIFI_RATE_OFDM,       12,      0, "12"       },
+	{ "OFDM-18",      8,   7, WIFI_RATE_OFDM,       18,      0, "18"       },
+	{ "OFDM-24",      9,   8, WIFI_RATE_OFDM,       24,      0, "24"       },
+	{ "OFDM-36",     10,   9, WIFI_RATE_OFDM,       36,      0, "36"       },
+	{ "OFDM-48",     11,  10, WIFI_RATE_OFDM,       48,      0, "48"       },
+	{ "OFDM-54",     12,  11, WIFI_RATE_OFDM,       54,      0, "54"       },
+	{ "MCS0",        14,  12, WIFI_RATE_HT,        6.5,   13.5, "MCS0"     },
+	{ "MCS1",        15,  13, WIFI_RATE_HT,         13,     27, "MCS1"     },
+	{ "MCS2",        16,  14, WIFI_RATE_HT,       19.5,   40.5, "MCS2"     },
+	{ "MCS3",        17,  15, WIFI_RATE_HT,         26,     54, "MCS3"     },
+	{ "MCS4",        18,  16, WIFI_RATE_HT,         39,     81, "MCS4"     },
+	{ "MCS5",        19,  17, WIFI_RATE_HT,         52,    108, "MCS5"     },
+	{ "MCS6",        20,  18, WIFI_RATE_HT,       58.5,  121.5, "MCS6"     },
+	{ "MCS7",        21,  19, WIFI_RATE_HT,         65,    135, "MCS7"     },
+	{ "MCS8",        22,  -1, WIFI_RATE_HT,         13,     27, "MCS8"     },
+	{ "MCS9",        23,  -1, WIFI_RATE_HT,         26,     54, "MCS9"     },
+	{ "MCS10",       24,  -1, WIFI_RATE_HT,         39,     81, "MCS10"    },
+	{ "MCS11",       25,  -1, WIFI_RATE_HT,         52,    108, "MCS11"    },
+	{ "MCS12",       26,  -1, WIFI_RATE_HT,         78,    162, "MCS12"    },
+	{ "MCS13",       27,  -1, WIFI_RATE_HT,        104,    216, "MCS13"    },
+	{ "MCS14",       28,  -1, WIFI_RATE_HT,        117,    243, "MCS14"    },
+	{ "MCS15",       29,  -1, WIFI_RATE_HT,        130,    270, "MCS15"    },
+	{ "MCS16",       30,  -1, WIFI_RATE_HT,       19.5,   40.5, "MCS16"    },
+	{ "MCS17",       31,  -1, WIFI_RATE_HT,         39,     81, "MCS17"    },
+	{ "MCS18",       32,  -1, WIFI_RATE_HT,       58.5,  121.5, "MCS18"    },
+	{ "MCS19",       33,  -1, WIFI_RATE_HT,         78,    162, "MCS19"    },
+	{ "MCS20",       34,  -1, WIFI_RATE_HT,        117,    243, "MCS20"    },
+	{ "MCS21",       35,  -1, WIFI_RATE_HT,        156,    324, "MCS21"    },
+	{ "MCS22",       36,  -1, WIFI_RATE_HT,      175.5,  364.5, "MCS22"    },
+	{ "MCS23",       37,  -1, WIFI_RATE_HT,        195,    405, "MCS23"    },
+	{ "MCS24",       38,  -1, WIFI_RATE_HT,         26,     54, "MCS24"    },
+	{ "MCS25",       39,  -1, WIFI_RATE_HT,         52,    108, "MCS25"    },
+	{ "MCS26",       40,  -1, WIFI_RATE_HT,         78,    162, "MCS26"    },
+	{ "MCS27",       41,  -1, WIFI_RATE_HT,        104,    216, "MCS27"    },
+	{ "MCS28",       42,  -1, WIFI_RATE_HT,        156,    324, "MCS28"    },
+	{ "MCS29",       43,  -1, WIFI_RATE_HT,        208,    432, "MCS29"    },
+	{ "MCS30",       44,  -1, WIFI_RATE_HT,        234,    486, "MCS30"    },
+	{ "MCS31",       45,  -1, WIFI_RATE_HT,        260,    540, "MCS31"    },
+	{ "1DH1",       100,  -1, WIFI_RATE_BT,          0,      0, "1DH1"     },
+	{ "1DH3",       101,  -1, WIFI_RATE_BT,          0,      0, "1DH3"     },
+	{ "1DH5",       102,  -1, WIFI_RATE_BT,          0,      0, "1DH5"     },
+	{ "2DH1",       103,  -1, WIFI_RATE_BT,          0,      0, "2DH1"     },
+	{ "2DH3",       104,  -1, WIFI_RATE_BT,          0,      0, "2DH3"     },
+	{ "2DH5",       105,  -1, WIFI_RATE_BT,          0,      0, "2DH5"     },
+	{ "3DH1",       106,  -1, WIFI_RATE_BT,          0,      0, "3DH1"     },
+	{ "3DH3",       107,  -1, WIFI_RATE_BT,          0,      0, "3DH3"     },
+	{ "3DH5",       108,  -1, WIFI_RATE_BT,          0,      0, "3DH5"     },
+	{ "1LE",        109,  -1, WIFI_RATE_BT,          0,      0, "1LE"      },
+	{ "HALF-3",     200,  -1, WIFI_RATE_HALF,        3,      0, "HALF-3"   },
+	{ "HALF-4_5",   201,  -1, WIFI_RATE_HALF,      4.5,      0, "HALF-4_5" },
+	{ "HALF-6",     202,  -1, WIFI_RATE_HALF,        6,      0, "HALF-6"   },
+	{ "HALF-9",     203,  -1, WIFI_RATE_HALF,        9,      0, "HALF-9"   },
+	{ "HALF-12",    204,  -1, WIFI_RATE_HALF,       12,      0, "HALF-12"  },
+	{ "HALF-18",    205,  -1, WIFI_RATE_HALF,       18,      0, "HALF-18"  },
+	{ "HALF-24",    206,  -1, WIFI_RATE_HALF,       24,      0, "HALF-24"  },
+	{ "HALF-27",    207,  -1, WIFI_RATE_HALF,       27,      0, "HALF-27"  },
+	{ "QUAR-1_5",   208,  -1, WIFI_RATE_QUAR,      1.5,      0, "QUAR-1_5" },
+	{ "QUAR-2_25",  209,  -1, WIFI_RATE_QUAR,     2.25,      0, "QUAR-2_25" },
+	{ "QUAR-3",     210,  -1, WIFI_RATE_QUAR,        3,      0, "QUAR-3"   },
+	{ "QUAR-4_5",   211,  -1, WIFI_RATE_QUAR,      4.5,      0, "QUAR-4_5" },
+	{ "QUAR-6",     212,  -1, WIFI_RATE_QUAR,        6,      0, "QUAR-6"   },
+	{ "QUAR-9",     213,  -1, WIFI_RATE_QUAR,        9,      0, "QUAR-9"   },
+	{ "QUAR-12",    214,  -1, WIFI_RATE_QUAR,       12,      0, "QUAR-12"  },
+	{ "QUAR-13_5",  215,  -1, WIFI_RATE_QUAR,     13.5,      0, "QUAR-13_5" },
+};
+
+typedef struct tagWiFiRateFamilyRange
+{
+	const char	*prefix;			// "" matches any name, keep it last
+	int			firstRow;
+	int			numRows;
+	int			firstIndex;
+} WIFI_RATE_FAMILY_RANGE;
+
+// Rows of g_wifiRates per family, the indexes of a family are consecutive
+static const WIFI_RATE_FAMILY_RANGE g_wifiRateFamilies[] =
+{
+	{"DSSS-",  0,  2,   0},
+	{"CCK-",   2,  2,   2},
+	{"PBCC-",  4,  1,   4},
+	{"OFDM-",  5,  8,   5},
+	{"MCS",   13, 32,  14},
+	{"HALF-", 55,  8, 200},
+	{"QUAR-", 63,  8, 208},
+	{"",      45, 10, 100},			// Bluetooth packet types, e.g. "1DH1"
+};
+
+// The formula for converting between freq in MHz is center freq(MHz)=5000+5xN, N=0,1,2...199
+// Parts of this table have not been verified and may not be valid.
+static const WIFI_CHANNEL g_wifiChannels[] =
+{
+	{2412,   1}, {2417,   2}, {2422,   3}, {2427,   4}, {2432,   5}, {2437,   6},
+	{2442,   7}, {2447,   8}, {2452,   9}, {2457,  10}, {2462,  11}, {2467,  12},
+	{2472,  13}, {2484,  14}, {4920, 184}, {4940, 188}, {4960, 192}, {4980, 196},
+	{5040,   8}, {5060,  12}, {5080,  16}, {5170,  34}, {5180,  36}, {5190,  38},
+	{5200,  40}, {5210,  42}, {5220,  44}, {5230,  46}, {5240,  48}, {5250,  50},
+	{5260,  52}, {5270,  54}, {5280,  56}, {5290,  58}, {5300,  60}, {5310,  62},
+	{5320,  64}, {5330,  66}, {5400,  80}, {5500, 100}, {5510, 102}, {5520, 104},
+	{5530, 106}, {5540, 108}, {5550, 110}, {5560, 112}, {5570, 114}, {5580, 116},
+	{5590, 118}, {5600, 120}, {5610, 122}, {5620, 124}, {5630, 126}, {5640, 128},
+	{5660, 132}, {5670, 134}, {5680, 136}, {5690, 138}, {5700, 140}, {5710, 142},
+	{5720, 144}, {5745, 149}, {5755, 151}, {5765, 153}, {5775, 155}, {5785, 157},
+	{5795, 159}, {5805, 161}, {5815, 163}, {5820, 164}, {5825, 165}, {5845, 169},
+	{5865, 173}, {5885, 177}, {5905, 181}, {5925, 185}, {5945, 189},
+};
+
+//! Returns the rate with this index, NULL if there is none
+inline const WIFI_RATE_DESCRIPTOR* WiFiRate_FindByIndex(int index)
+{
+	for (size_t i=0;i<sizeof(g_wifiRateFamilies)/sizeof(g_wifiRateFamilies[0]);i++)
+	{
+		const WIFI_RATE_FAMILY_RANGE &range = g_wifiRateFamilies[i];
+		if ( index>=range.firstIndex && index<range.firstIndex+range.numRows )
+		{
+			return &g_wifiRates[range.firstRow+index-range.firstIndex];
+		}
+		else
+		{
+			// keep searching...
+		}
+	}
+	return NULL;
+}
+
+//! Returns the rate with this name, NULL if there is none
+inline const WIFI_RATE_DESCRIPTOR* WiFiRate_FindByName(const char *name)
+{
+	if (NULL==name)
+	{
+		return NULL;
+	}
+
+	for (size_t i=0;i<sizeof(g_wifiRateFamilies)/sizeof(g_wifiRateFamilies[0]);i++)
+	{
+		const WIFI_RATE_FAMILY_RANGE &range = g_wifiRateFamilies[i];
+		if ( 0==strncmp(name, range.prefix, strlen(range.prefix)) )
+		{
+			for (int row=range.firstRow;row<range.firstRow+range.numRows;row++)
+			{
+				if ( 0==strcmp(name, g_wifiRates[row].name) )
+				{
+					return &g_wifiRates[row];
+				}
+			}
+			return NULL;
+		}
+		else
+		{
+			// keep searching...
+		}
+	}
+	return NULL;
+}
+
+//! Data rate in Mbps of a rate name, HT rates need the bandwidth: "HT20_MCS7" or "MCS7_HT20"
+inline bool WiFiRate_GetMbps(const char *name, double *mbps)
+{
+	char rateName[16] = {'\0'};
+	int  bandwidth    = 0;			// HT only: 20 or 40
+
+	if ( NULL==name || strlen(name)>=sizeof(rateName) )
+	{
+		return false;
+	}
+	else if ( 0==strncmp(name, "HT20_", 5) || 0==strncmp(name, "HT40_", 5) )
+	{
+		bandwidth = ('2'==name[2]) ? 20 : 40;
+		strcpy_s(rateName, sizeof(rateName), name+5);
+	}
+	else
+	{
+		strcpy_s(rateName, sizeof(rateName), name);
+		char *suffix = strstr(rateName, "_HT");
+		if ( NULL!=suffix && ( 0==strcmp(suffix, "_HT20") || 0==strcmp(suffix, "_HT40") ) )
+		{
+			bandwidth = ('2'==suffix[3]) ? 20 : 40;
+			*suffix   = '\0';
+		}
+		else
+		{
+			// do nothing
+		}
+	}
+
+	const WIFI_RATE_DESCRIPTOR *rate = WiFiRate_FindByName(rateName);
+	if ( NULL==rate || 0==rate->mbps || (WIFI_RATE_HT==rate->family)!=(0!=bandwidth) )
+	{
+		return false;
+	}
+
+	*mbps = (40==bandwidth) ? rate->mbpsHt40 : rate->mbps;
+	return true;
+}
+
+//! Channel number of a center frequency, false if the frequency is not a WiFi channel
+inline bool WiFiChannel_FreqToChannel(int freqMHz, int *channel)
+{
+	int low  = 0;
+	int high = (int)(sizeof(g_wifiChannels)/sizeof(g_wifiChannels[0]))-1;
+	while (low<=high)
+	{
+		int middle = (low+high)/2;
+		if (g_wifiChannels[middle].freqMHz==freqMHz)
+		{
+			*channel = g_wifiChannels[middle].channel;
+			return true;
+		}
+		else if (g_wifiChannels[middle].freqMHz<freqMHz)
+		{
+			low = middle+1;
+		}
+		else
+		{
+			high = middle-1;
+		}
+	}
+	return false;
+}
+
+//! Center frequency of a channel number, the lowest one if the number is used in two bands
+inline bool WiFiChannel_ChannelToFreq(int channel, int *freqMHz)
+{
+	for (size_t i=0;i<sizeof(g_wifiChannels)/sizeof(g_wifiChannels[0]);i++)
+	{
+		if (channel==g_wifiChannels[i].channel)
+		{
+			*freqMHz = g_wifiChannels[i].freqMHz;
+			return true;
+		}
+		else
+		{
+			// keep searching...
+		}
+	}
+	return false;
+}
+
+#endif // _WIFI_RATE_TABLE_H_
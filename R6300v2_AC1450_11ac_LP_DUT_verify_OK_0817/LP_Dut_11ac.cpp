@@ -56,6 +56,7 @@ struct
 	char szCmdPrefixReserved[16];
 	bool bRunTelnetEnabled;
 	char szUsbHwID[64];
+	int  nReadyTimeoutMs;
 }csSocket;
 
 #define BUFSIZE 256
@@ -522,43 +523,29 @@ int LP_initialize_dut(void)
 			g_socket=INVALID_SOCKET;
 		}
 
-		//Add "arp -d"		
-		TCHAR szArpCommand[128] = "";
-		sprintf_s(szArpCommand,"arp -d");
-		RunSpecifyExeAndRead(szArpCommand , false); 
-		//printf("send command \"arp -d \" ok!!!\r\n");
-		memset(szArpCommand,0,128);
-		//Add end
-
-		DeleteSpecifyExe("ping.exe");
-
-		if(!PingSpecifyIP(csSocket.szDutIP,ErrorCode))
-		{
-			api_status = ErrorCode; 
-			switch(ErrorCode)
-			{
-			case 1:
-				CheckReturnError(api_status, "[Error] Run ping return error.\n");
-				break;
-			case 2:
-				CheckReturnError(api_status, "[Error] Create pipe return error.\n");
-				break;
-			case 3:
-				CheckReturnError(api_status, "[Error] Read pipe return error.\n");
-				break;
-			};
-		}
-		DeleteSpecifyExe("ping");
-		if(api_status != 0)
-		{
-			return api_status;
-		}
+		// Wait for the DUT in process, no arp/ping child processes; boot and telnet share one deadline
+		DWORD dwReadyStart = GetTickCount();
+		DWORD dwReadyMs    = 0;
+		ClearDutArpEntry(csSocket.szDutIP);
 
 		//char szDutMac[30]="000000000001";
 		char szDutMac[30]="00904C012001";
 		if(csSocket.bRunTelnetEnabled)
 		{
-			if (!IP_ArpMac(csSocket.szDutIP,szDutMac))
+			// telnetenable needs the MAC, so the DUT must answer ARP first
+			DWORD dwBackoff = 100;
+			bool  bArpOK    = false;
+			while(GetTickCount()-dwReadyStart < (DWORD)csSocket.nReadyTimeoutMs)
+			{
+				if (IP_ArpMac(csSocket.szDutIP,szDutMac))
+				{
+					bArpOK = true;
+					break;
+				}
+				Sleep(dwBackoff);
+				dwBackoff = min(dwBackoff*2,(DWORD)2000);
+			}
+			if (!bArpOK)
 			{
 				api_status=4;
 				CheckReturnError(api_status, "[Error] Failed to get dut mac.\n");			
@@ -568,39 +555,44 @@ int LP_initialize_dut(void)
 
 		ErrorCode=0;
 
-		int nTelnetNum=6;
 		bool IsTelnet=false;
 		strSocketBuf.clear();
-		while(nTelnetNum--)
+		do
 		{
-			if(csSocket.bRunTelnetEnabled && !IP_TelnetEnable(csSocket.szDutIP,szDutMac))
+			DWORD dwSpent = GetTickCount()-dwReadyStart;
+			DWORD dwLeft  = (dwSpent<(DWORD)csSocket.nReadyTimeoutMs)? (DWORD)csSocket.nReadyTimeoutMs-dwSpent : 0;
+			if(csSocket.bRunTelnetEnabled)
 			{
-				ErrorCode=5;
-				CheckReturnError(api_status, "[Error] Failed to get dut mac.\n");
-				continue;
-			}
-			printf("beging to Init Socket");
-			if(InitSocket(csSocket.szDutIP,ErrorCode))
-			{
-				Sleep(1000);
-				if(strSocketBuf.find(csSocket.szKeyWord))	
+				// telnetd is started by the enable packet, send it again if the DUT does not answer
+				if(!IP_TelnetEnable(csSocket.szDutIP,szDutMac))
 				{
-					printf("socket connected!\n");
-					IsTelnet=true;
-					break;
+					ErrorCode=5;
+					Sleep(min(dwLeft,(DWORD)500));
+					continue;
 				}
+				dwLeft = min(dwLeft,(DWORD)5000);
 			}
-			Sleep(500);
-		}
+			if(WaitDutReady(csSocket.szDutIP,23,csSocket.szKeyWord,dwLeft,ErrorCode,NULL))
+			{
+				printf("socket connected!\n");
+				IsTelnet=true;
+			}
+		}while(!IsTelnet && GetTickCount()-dwReadyStart < (DWORD)csSocket.nReadyTimeoutMs);
 
 		if(!IsTelnet)
 		{
 			api_status = 6;
-			CheckReturnError(api_status, "[Error] Create socket return error.\n");
+			CheckReturnError(api_status, "[Error] DUT not ready in %d ms (error %d).\n", csSocket.nReadyTimeoutMs, ErrorCode);
 		}
 		else
 		{
-
+			dwReadyMs = GetTickCount()-dwReadyStart;
+			printf("DUT ready in %lu ms\n", dwReadyMs);
+			if (g_logger_id>=0)
+			{
+				::LOGGER_Write(g_logger_id, LOGGER_INFORMATION, "[LP_Dut] DUT %s ready for the first command %lu ms after INITIALIZE_DUT\n", csSocket.szDutIP, dwReadyMs);
+			}
+			::vDUT_AddIntegerReturn(g_LP_DUT_11ac_id, "DUT_READY_MS", (int)dwReadyMs);
 		}
 		//initialize the DUT at the very beginning
 
@@ -2013,6 +2005,7 @@ int LP_read_ini (char* pathStr )
 		stringLength = GetPrivateProfileString("Configuration","USB_HWID", "", csSocket.szUsbHwID, MAX_BUFFER_SIZE, iniPath);
 		stringLength = GetPrivateProfileString("Configuration","Mod File Path", "Null", pathStr, MAX_BUFFER_SIZE, iniPath);
         csSocket.bRunTelnetEnabled = GetPrivateProfileInt("Configuration","RunTelnetEnable", false, iniPath);
+		csSocket.nReadyTimeoutMs = GetPrivateProfileInt("Configuration","DUT_READY_TIMEOUT_MS", 30000, iniPath);
 
 		// check if the usb device id is null.
 		if(csSocket.szUsbHwID[0]=='\0')
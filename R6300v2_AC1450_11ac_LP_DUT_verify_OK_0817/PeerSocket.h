@@ -22,6 +22,8 @@ void ambit_WSACleanup();
 bool Initialize_WSA();
 bool InitSocket(TCHAR *ip,int &ErrorType);
 bool PingSpecifyIP(TCHAR* IP,int &ErrorType,int nFailCount=35);
+bool ClearDutArpEntry(char *ip);
+bool WaitDutReady(char *ip,int port,char *keyWord,DWORD deadlineMs,int &ErrorType,DWORD *readyMs=NULL);
 bool PeerCreateSocket(SOCKET *pNewSocket,int iSockType);
 bool PeerBindSocket(SOCKET BindSocket,TCHAR *szHostAddr,int iHostPort);
 bool PeerConnectSocket(SOCKET BindSocket,TCHAR *szHostAddr,int iHostPort);
@@ -13,8 +13,14 @@
 #include "Tlhelp32.h"
 #include "stdio.h"
 #include <string>
+#include <iphlpapi.h>	// DeleteIpNetEntry
 using namespace std;
 #define MAXBUFSIZE 2048
+#define DUT_PROBE_BACKOFF_MIN_MS	100		// first wait between two connect probes
+#define DUT_PROBE_BACKOFF_MAX_MS	2000
+#define DUT_PROBE_CONNECT_MS		1000	// connect timeout of one probe
+#define DUT_PROBE_BANNER_MS		3000	// wait for the prompt once connected
+#define DUT_PROBE_NUDGE_MS			500		// silence before an empty line is sent
 
 SOCKET g_socket; // dut socket
 string strSocketBuf;
@@ -158,6 +164,174 @@ bool InitSocket(char *ip,int &ErrorType)
 	return TRUE;
 }
 
+// Removes the ARP cache entry of the DUT in process, instead of running "arp -d",
+// so a DUT replaced by another one with the same IP is resolved again
+bool ClearDutArpEntry(char *ip)
+{
+	MIB_IPNETROW arpRow;
+	DWORD dwIfIndex = 0;
+	IPAddr dutAddr = inet_addr(ip);
+
+	if(NO_ERROR != GetBestInterface(dutAddr,&dwIfIndex))
+	{
+		return false;
+	}
+	memset(&arpRow,0,sizeof(arpRow));
+	arpRow.dwIndex = dwIfIndex;
+	arpRow.dwAddr  = dutAddr;
+
+	DWORD dwRet = DeleteIpNetEntry(&arpRow);
+	return (NO_ERROR==dwRet || ERROR_NOT_FOUND==dwRet);
+}
+
+static DWORD DutTimeLeft(DWORD dwStart,DWORD timeoutMs)
+{
+	DWORD dwSpent = GetTickCount()-dwStart;
+	return (dwSpent<timeoutMs)? timeoutMs-dwSpent : 0;
+}
+
+static void DutTimeval(timeval *tv,DWORD timeoutMs)
+{
+	tv->tv_sec  = timeoutMs/1000;
+	tv->tv_usec = (timeoutMs%1000)*1000;
+}
+
+// Non-blocking connect, false if the DUT refuses or does not answer within timeoutMs
+static bool DutProbeConnect(SOCKET probe,sockaddr_in *addr,DWORD timeoutMs)
+{
+	if(SOCKET_ERROR==connect(probe,(SOCKADDR*)addr,sizeof(*addr)) && WSAEWOULDBLOCK!=WSAGetLastError())
+	{
+		return false;
+	}
+
+	fd_set writeSet,errorSet;
+	FD_ZERO(&writeSet);
+	FD_SET(probe,&writeSet);
+	FD_ZERO(&errorSet);
+	FD_SET(probe,&errorSet);
+	timeval tv;
+	DutTimeval(&tv,timeoutMs);
+
+	// Windows reports a failed non-blocking connect in the error set
+	return (0<select(0,NULL,&writeSet,&errorSet,&tv) && FD_ISSET(probe,&writeSet) && !FD_ISSET(probe,&errorSet));
+}
+
+// Reads the banner until keyWord shows up; one empty line is sent if the DUT stays silent
+static bool DutProbeBanner(SOCKET probe,char *keyWord,DWORD timeoutMs,string &strBanner)
+{
+	DWORD dwStart = GetTickCount();
+	bool  bNudged = false;
+
+	strBanner.clear();
+	while(0<DutTimeLeft(dwStart,timeoutMs))
+	{
+		fd_set readSet;
+		FD_ZERO(&readSet);
+		FD_SET(probe,&readSet);
+		timeval tv;
+		DutTimeval(&tv,min(DutTimeLeft(dwStart,timeoutMs),(DWORD)DUT_PROBE_NUDGE_MS));
+
+		int nReady = select(0,&readSet,NULL,NULL,&tv);
+		if(SOCKET_ERROR==nReady)
+		{
+			return false;
+		}
+		else if(0==nReady)
+		{
+			if(!bNudged)
+			{
+				send(probe,"\r\n",2,0);
+				bNudged = true;
+			}
+			continue;
+		}
+
+		char szBuf[MAXBUFSIZE+1]="";
+		int nRead = recv(probe,szBuf,MAXBUFSIZE,0);
+		if(nRead<=0)
+		{
+			return false;	// closed by the DUT, telnetd is not ready yet
+		}
+		strBanner.append(szBuf,nRead);
+		if(strBanner.find(keyWord) != string::npos)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+// Waits, within deadlineMs, for the DUT to accept a TCP connection on port and show keyWord,
+// without ping.exe: non-blocking connect probes, DUT_PROBE_BACKOFF_MIN_MS apart at first and
+// twice as far each time up to DUT_PROBE_BACKOFF_MAX_MS.
+// Like InitSocket(), the connected socket becomes g_socket and the receive thread is started;
+// strSocketBuf holds the banner.  readyMs gets the time the DUT took.
+// ErrorType: 1 create socket failed, 2 no connection before the deadline, 3 connected but no keyWord
+bool WaitDutReady(char *ip,int port,char *keyWord,DWORD deadlineMs,int &ErrorType,DWORD *readyMs)
+{
+	DWORD  dwStart   = GetTickCount();
+	DWORD  dwBackoff = DUT_PROBE_BACKOFF_MIN_MS;
+	string strBanner;
+
+	Read_ini();
+	ErrorType = 2;
+
+	sockaddr_in dutService;
+	dutService.sin_family = AF_INET;
+	dutService.sin_addr.s_addr = inet_addr( ip );
+	dutService.sin_port = htons( (u_short)port );
+
+	while(0<DutTimeLeft(dwStart,deadlineMs))
+	{
+		SOCKET probe = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+		if(INVALID_SOCKET==probe)
+		{
+			ErrorType=1;
+			return false;
+		}
+		u_long iMode = 1;
+		ioctlsocket(probe, FIONBIO, &iMode);
+
+		DWORD dwProbeStart = GetTickCount();
+		if(DutProbeConnect(probe,&dutService,min(DutTimeLeft(dwStart,deadlineMs),(DWORD)DUT_PROBE_CONNECT_MS)))
+		{
+			if(DutProbeBanner(probe,keyWord,min(DutTimeLeft(dwStart,deadlineMs),(DWORD)DUT_PROBE_BANNER_MS),strBanner))
+			{
+				iMode = 0;
+				ioctlsocket(probe, FIONBIO, &iMode);
+
+				if(h_socketThread!=NULL)
+				{
+					TerminateThread(h_socketThread,0);
+				}
+				g_socket = probe;
+				strSocketBuf = strBanner;
+				bRequestExit = false;
+				h_socketThread=CreateThread(NULL,0,_socket_receive,&g_socket,0,NULL);
+
+				if(readyMs != NULL)
+				{
+					*readyMs = GetTickCount()-dwStart;
+				}
+				ErrorType=0;
+				return true;
+			}
+			ErrorType=3;
+		}
+		closesocket(probe);
+
+		// A refused connect returns at once, wait the rest of the backoff
+		DWORD dwSpent = GetTickCount()-dwProbeStart;
+		if(dwSpent<dwBackoff)
+		{
+			Sleep(min(dwBackoff-dwSpent,DutTimeLeft(dwStart,deadlineMs)));
+		}
+		dwBackoff = min(dwBackoff*2,(DWORD)DUT_PROBE_BACKOFF_MAX_MS);
+	}
+
+	return false;
+}
+
 bool PingSpecifyIP(TCHAR* IP,int &ErrorType,int nFailCount)
 {
 	HANDLE hWritePipe  = NULL;
@@ -533,8 +707,8 @@ int Read_ini()
 		ShowDebugInfor=GetPrivateProfileInt("Configuration","DEBUG_SHOW",0,iniPath);
 
 		ini_status = 1;  
+		fclose(iniFile);
 	}
-	fclose(iniFile);
 	return ini_status;
 }
 
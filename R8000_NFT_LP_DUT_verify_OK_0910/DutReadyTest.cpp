@@ -0,0 +1,188 @@
+// DutReadyTest.cpp : console test of WaitDutReady() against a local listener that starts late
+//
+// The listener stands in for the DUT telnetd.  It starts listening only after WaitDutReady() has been
+// refused a few times, sends its banner in two parts, and sends one more line once the DUT is found
+// ready.  The test checks that WaitDutReady() connects, finds the prompt in the banner, and that the
+// receive thread it starts gets the later line.  A second case checks that, with no listener at all,
+// WaitDutReady() gives up at its deadline.
+//
+// Usage: DutReadyTest.exe; the exit code is the number of failed checks
+
+#include "stdafx.h"
+#include "PeerSocket.h"
+#include <string>
+using namespace std;
+
+#define TEST_LATE_START_MS		1500	// after the 100, 200, 400 and 800 ms backoff probes
+#define TEST_DEADLINE_MS		10000
+#define TEST_NO_DUT_DEADLINE_MS	1000
+#define TEST_MESSAGE_WAIT_MS	3000
+#define TEST_PROMPT				"#"
+#define TEST_NEW_MESSAGE		"DUT_READY_TEST_NEW_MESSAGE"
+
+// PeerSocket.cpp
+extern SOCKET g_socket;
+extern string strSocketBuf;
+extern bool   bRequestExit;
+
+typedef struct tagLateListener
+{
+	u_short	port;
+	HANDLE	readyEvent;		// set by the test once WaitDutReady() returned
+	DWORD	listenTick;		// GetTickCount() when the listener started
+	bool	accepted;
+} LATE_LISTENER;
+
+static int g_failures = 0;
+
+static void Check(bool passed, const char *name)
+{
+	printf("[%s] %s\n", passed ? "PASS" : "FAIL", name);
+	if(!passed)
+	{
+		g_failures++;
+	}
+}
+
+static void LocalService(sockaddr_in *service, u_short port)
+{
+	memset(service, 0, sizeof(*service));
+	service->sin_family = AF_INET;
+	service->sin_addr.s_addr = inet_addr("127.0.0.1");
+	service->sin_port = htons(port);
+}
+
+// A port nothing listens on, so the first probes are refused
+static u_short FreeLocalPort(void)
+{
+	sockaddr_in service;
+	int nameLen = sizeof(service);
+	u_short port = 0;
+
+	SOCKET probe = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	LocalService(&service, 0);
+	if(INVALID_SOCKET!=probe && 0==bind(probe, (SOCKADDR*)&service, sizeof(service)) &&
+	   0==getsockname(probe, (SOCKADDR*)&service, &nameLen))
+	{
+		port = ntohs(service.sin_port);
+	}
+	closesocket(probe);
+	return port;
+}
+
+static void SendText(SOCKET dut, const char *text)
+{
+	send(dut, text, (int)strlen(text), 0);
+}
+
+static DWORD WINAPI LateListener(LPVOID lpParameter)
+{
+	LATE_LISTENER *listener = (LATE_LISTENER*)lpParameter;
+	sockaddr_in service;
+
+	Sleep(TEST_LATE_START_MS);
+
+	SOCKET listenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	LocalService(&service, listener->port);
+	listener->listenTick = GetTickCount();
+	if(INVALID_SOCKET==listenSocket || 0!=bind(listenSocket, (SOCKADDR*)&service, sizeof(service)) || 0!=listen(listenSocket, 1))
+	{
+		closesocket(listenSocket);
+		return 1;
+	}
+	SOCKET dut = accept(listenSocket, NULL, NULL);
+	closesocket(listenSocket);
+	if(INVALID_SOCKET==dut)
+	{
+		return 1;
+	}
+	listener->accepted = true;
+
+	// The prompt comes in a second segment, as from a slow telnetd
+	SendText(dut, "\r\nBusyBox built-in shell (ash)\r\n");
+	Sleep(200);
+	SendText(dut, "root@DUT:/" TEST_PROMPT " ");
+
+	WaitForSingleObject(listener->readyEvent, TEST_DEADLINE_MS);
+	SendText(dut, TEST_NEW_MESSAGE "\r\n");
+
+	// Until the test closes its side
+	char szBuf[256];
+	while(0<recv(dut, szBuf, sizeof(szBuf), 0))
+	{
+	}
+	closesocket(dut);
+	return 0;
+}
+
+static void TestLateListener(void)
+{
+	LATE_LISTENER listener;
+	char  ip[] = "127.0.0.1";
+	char  prompt[] = TEST_PROMPT;
+	int   errorType = -1;
+	DWORD readyMs = 0;
+
+	listener.port       = FreeLocalPort();
+	listener.readyEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+	listener.listenTick = 0;
+	listener.accepted   = false;
+	HANDLE hListener = CreateThread(NULL, 0, LateListener, &listener, 0, NULL);
+
+	bool  bReady  = WaitDutReady(ip, listener.port, prompt, TEST_DEADLINE_MS, errorType, &readyMs);
+	DWORD dwReady = GetTickCount();
+	SetEvent(listener.readyEvent);
+	printf("Listener on port %d started after %d ms, DUT ready after %lu ms\n", listener.port, TEST_LATE_START_MS, readyMs);
+
+	Check(bReady && 0==errorType, "late listener: WaitDutReady() connects");
+	Check(listener.accepted && (int)(dwReady-listener.listenTick)>=0, "late listener: ready only once the listener started");
+	Check(string::npos!=strSocketBuf.find("BusyBox") && string::npos!=strSocketBuf.find(TEST_PROMPT), "late listener: banner kept in strSocketBuf");
+
+	// The receive thread started by WaitDutReady() gets what the DUT sends afterwards
+	DWORD dwWait = GetTickCount();
+	while(string::npos==strSocketBuf.find(TEST_NEW_MESSAGE) && GetTickCount()-dwWait<TEST_MESSAGE_WAIT_MS)
+	{
+		Sleep(50);
+	}
+	Check(string::npos!=strSocketBuf.find(TEST_NEW_MESSAGE), "late listener: new message received");
+
+	if(bReady)
+	{
+		bRequestExit = true;
+		closesocket(g_socket);
+		g_socket = INVALID_SOCKET;
+	}
+	WaitForSingleObject(hListener, TEST_DEADLINE_MS);
+	CloseHandle(hListener);
+	CloseHandle(listener.readyEvent);
+}
+
+static void TestNoListener(void)
+{
+	char  ip[] = "127.0.0.1";
+	char  prompt[] = TEST_PROMPT;
+	int   errorType = -1;
+
+	DWORD dwStart = GetTickCount();
+	bool  bReady = WaitDutReady(ip, FreeLocalPort(), prompt, TEST_NO_DUT_DEADLINE_MS, errorType, NULL);
+	DWORD dwSpent = GetTickCount()-dwStart;
+
+	Check(!bReady && 2==errorType, "no listener: WaitDutReady() fails with no connection");
+	Check(dwSpent<TEST_NO_DUT_DEADLINE_MS+500, "no listener: WaitDutReady() returns at the deadline");
+}
+
+int main(void)
+{
+	if(!Initialize_WSA())
+	{
+		printf("WSAStartup failed\n");
+		return 1;
+	}
+
+	TestLateListener();
+	TestNoListener();
+
+	printf("%d failed\n", g_failures);
+	ambit_WSACleanup();
+	return g_failures;
+}
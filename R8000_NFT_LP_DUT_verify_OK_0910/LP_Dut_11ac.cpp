@@ -57,6 +57,7 @@ struct
 	char szCmdPrefixReserved[16];
 	bool bRunTelnetEnabled;
 	char szUsbHwID[64];
+	int  nReadyTimeoutMs;
 }csSocket;
 
 #define BUFSIZE 256
@@ -189,6 +190,31 @@ int  CheckReturnError(int errorCode, const char *format, ...)
     return err;
 }
 
+// "nvram set" of one ADDRESS=VALUE, no commit: the commit is in LP_finalize_eeprom()
+static void AppendNvramSet(string &cmd, const char *address, const char *value)
+{
+	if ( '\0'==address[0] || NULL!=strpbrk(address, " ;=\r\n") || NULL!=strpbrk(value, ";\r\n") )
+	{
+		throw "[Error] EEPROM address or value not allowed in an nvram command.\n";
+	}
+	else
+	{
+		// do nothing
+	}
+	if (!cmd.empty())
+	{
+		cmd += ";";
+	}
+	else
+	{
+		// do nothing
+	}
+	cmd += "nvram set ";
+	cmd += address;
+	cmd += "=";
+	cmd += value;
+}
+
 
 /*LP_DUT_11AC_API int BT_DutRegister(void)
 {
@@ -298,8 +324,10 @@ LP_DUT_11AC_API int WIFI_11AC_DutRegister(void)
 
         vDUT_InstallCallbackFunction(dutID, "WRITE_MAC_ADDRESS"     ,LP_write_mac_address);
         vDUT_InstallCallbackFunction(dutID, "READ_MAC_ADDRESS"      ,NULL);
-        vDUT_InstallCallbackFunction(dutID, "READ_EEPROM"           ,NULL);
-        vDUT_InstallCallbackFunction(dutID, "WRITE_EEPROM"          ,NULL);
+        vDUT_InstallCallbackFunction(dutID, "READ_EEPROM"           ,LP_read_eeprom);
+        vDUT_InstallCallbackFunction(dutID, "WRITE_EEPROM"          ,LP_write_eeprom);
+        vDUT_InstallCallbackFunction(dutID, "WRITE_EEPROM_BATCH"    ,LP_write_eeprom_batch);
+        vDUT_InstallCallbackFunction(dutID, "FINALIZE_EEPROM"       ,LP_finalize_eeprom);
         vDUT_InstallCallbackFunction(dutID, "GET_SERIAL_NUMBER"     ,LP_get_serial_number);
 
         vDUT_InstallCallbackFunction(dutID, "RF_SET_FREQ"           ,LP_set_freq);
@@ -429,9 +457,10 @@ int LP_remove_dut(void)
 			GetPrivateProfileString("DUTTE_HH","TE_HH","N/A",szHH,sizeof(szHH),".\\HH.txt");
 			if(strcmp(szHH,"N/A") != 0)
 			{
-				char szLocalCmd[128]="";
-				sprintf_s(szLocalCmd,sizeof(szLocalCmd),"nvram set TE_HH=%s;nvram commit",szHH);
-				SendDutCmd("",szLocalCmd);
+				string szLocalCmd;
+				AppendNvramSet(szLocalCmd,"TE_HH",szHH);
+				szLocalCmd += ";nvram commit";		// burnt after FINALIZE_EEPROM, so it needs its own commit
+				SendDutCmd("",(char*)szLocalCmd.c_str());
 			}		
 			DeleteFile(".\\HH.txt");
 		}
@@ -524,42 +553,28 @@ int LP_initialize_dut(void)
 			g_socket=INVALID_SOCKET;
 		}
 
-		//Add "arp -d"		
-		TCHAR szArpCommand[128] = "";
-		sprintf_s(szArpCommand,"arp -d");
-		RunSpecifyExeAndRead(szArpCommand , false); 
-		//printf("send command \"arp -d \" ok!!!\r\n");
-		memset(szArpCommand,0,128);
-		//Add end
-
-		DeleteSpecifyExe("ping.exe");
-
-		if(!PingSpecifyIP(csSocket.szDutIP,ErrorCode))
-		{
-			api_status = ErrorCode; 
-			switch(ErrorCode)
-			{
-			case 1:
-				CheckReturnError(api_status, "[Error] Run ping return error.\n");
-				break;
-			case 2:
-				CheckReturnError(api_status, "[Error] Create pipe return error.\n");
-				break;
-			case 3:
-				CheckReturnError(api_status, "[Error] Read pipe return error.\n");
-				break;
-			};
-		}
-		DeleteSpecifyExe("ping");
-		if(api_status != 0)
-		{
-			return api_status;
-		}
+		// Wait for the DUT in process, no arp/ping child processes; boot and telnet share one deadline
+		DWORD dwReadyStart = GetTickCount();
+		DWORD dwReadyMs    = 0;
+		ClearDutArpEntry(csSocket.szDutIP);
 
 		char szDutMac[30]="00904C012001";
 		if(csSocket.bRunTelnetEnabled)
 		{
-			if (!IP_ArpMac(csSocket.szDutIP,szDutMac))
+			// telnetenable needs the MAC, so the DUT must answer ARP first
+			DWORD dwBackoff = 100;
+			bool  bArpOK    = false;
+			while(GetTickCount()-dwReadyStart < (DWORD)csSocket.nReadyTimeoutMs)
+			{
+				if (IP_ArpMac(csSocket.szDutIP,szDutMac))
+				{
+					bArpOK = true;
+					break;
+				}
+				Sleep(dwBackoff);
+				dwBackoff = min(dwBackoff*2,(DWORD)2000);
+			}
+			if (!bArpOK)
 			{
 				api_status=4;
 				CheckReturnError(api_status, "[Error] Failed to get dut mac.\n");			
@@ -569,39 +584,44 @@ int LP_initialize_dut(void)
 
 		ErrorCode=0;
 
-		int nTelnetNum=6;
 		bool IsTelnet=false;
 		strSocketBuf.clear();
-		while(nTelnetNum--)
+		do
 		{
-			if(csSocket.bRunTelnetEnabled && !IP_TelnetEnable(csSocket.szDutIP,szDutMac))
-			{
-				ErrorCode=5;
-				CheckReturnError(api_status, "[Error] Failed to get dut mac.\n");
-				continue;
-			}
-			printf("beging to Init Socket");
-			if(InitSocket(csSocket.szDutIP,ErrorCode))
+			DWORD dwSpent = GetTickCount()-dwReadyStart;
+			DWORD dwLeft  = (dwSpent<(DWORD)csSocket.nReadyTimeoutMs)? (DWORD)csSocket.nReadyTimeoutMs-dwSpent : 0;
+			if(csSocket.bRunTelnetEnabled)
 			{
-				Sleep(1000);
-				if(strSocketBuf.find(csSocket.szKeyWord))	
+				// telnetd is started by the enable packet, send it again if the DUT does not answer
+				if(!IP_TelnetEnable(csSocket.szDutIP,szDutMac))
 				{
-					printf("socket connected!\n");
-					IsTelnet=true;
-					break;
+					ErrorCode=5;
+					Sleep(min(dwLeft,(DWORD)500));
+					continue;
 				}
+				dwLeft = min(dwLeft,(DWORD)5000);
 			}
-			Sleep(500);
-		}
+			if(WaitDutReady(csSocket.szDutIP,23,csSocket.szKeyWord,dwLeft,ErrorCode,NULL))
+			{
+				printf("socket connected!\n");
+				IsTelnet=true;
+			}
+		}while(!IsTelnet && GetTickCount()-dwReadyStart < (DWORD)csSocket.nReadyTimeoutMs);
 
 		if(!IsTelnet)
 		{
 			api_status = 6;
-			CheckReturnError(api_status, "[Error] Create socket return error.\n");
+			CheckReturnError(api_status, "[Error] DUT not ready in %d ms (error %d).\n", csSocket.nReadyTimeoutMs, ErrorCode);
 		}
 		else
 		{
-
+			dwReadyMs = GetTickCount()-dwReadyStart;
+			printf("DUT ready in %lu ms\n", dwReadyMs);
+			if (g_logger_id>=0)
+			{
+				::LOGGER_Write(g_logger_id, LOGGER_INFORMATION, "[LP_Dut] DUT %s ready for the first command %lu ms after INITIALIZE_DUT\n", csSocket.szDutIP, dwReadyMs);
+			}
+			::vDUT_AddIntegerReturn(g_LP_DUT_11ac_id, "DUT_READY_MS", (int)dwReadyMs);
 		}
 		//initialize the DUT at the very beginning
 	}
@@ -2096,6 +2116,206 @@ int LP_write_mac_address(void)
     return api_status;
 }
 
+int LP_write_eeprom(void)
+{
+    int  api_status = 0;
+	char address[MAX_BUFFER_SIZE] = "";
+	char value[MAX_BUFFER_SIZE]   = "";
+
+	::vDUT_ClearReturns(g_LP_DUT_11ac_id);
+
+	try
+	{
+		api_status = ::vDUT_GetStringParameter(g_LP_DUT_11ac_id, "ADDRESS", address, MAX_BUFFER_SIZE);
+		CheckReturnError(api_status, "[Error] vDUT_GetStringParameter(ADDRESS) return error.\n");
+		api_status = ::vDUT_GetStringParameter(g_LP_DUT_11ac_id, "VALUE", value, MAX_BUFFER_SIZE);
+		CheckReturnError(api_status, "[Error] vDUT_GetStringParameter(VALUE) return error.\n");
+
+		string cmd;
+		AppendNvramSet(cmd, address, value);
+		cmd += "\n";
+		if (!SendSocketCmd((char*)cmd.c_str()))
+		{
+			api_status = -1;
+			CheckReturnError(api_status, "[Error] nvram set %s failed.\n", address);
+		}
+		else
+		{
+			// do nothing
+		}
+
+		api_status = ::vDUT_AddStringReturn(g_LP_DUT_11ac_id, "EEPROM_RETURN", value);
+		CheckReturnError(api_status, "[Error] vDUT_AddStringReturn(EEPROM_RETURN) return error.\n");
+	}
+	catch(char *msg)
+    {
+        vDUT_AddStringReturn(g_LP_DUT_11ac_id, "ERROR_MESSAGE", msg);
+    }
+    catch(...)
+    {
+		vDUT_AddStringReturn(g_LP_DUT_11ac_id, "ERROR_MESSAGE", "[Error] Unknown Error!\n");
+    }
+
+    return api_status;
+}
+
+// ENTRIES is "ADDRESS=VALUE\n..." from the vDUT EEPROM cache, sent as one line of "nvram set"
+int LP_write_eeprom_batch(void)
+{
+    int  api_status = 0;
+	int  count = 0;
+	char entries[MAX_BUFFER_SIZE] = "";
+
+	::vDUT_ClearReturns(g_LP_DUT_11ac_id);
+
+	try
+	{
+		api_status = ::vDUT_GetStringParameter(g_LP_DUT_11ac_id, "ENTRIES", entries, MAX_BUFFER_SIZE);
+		CheckReturnError(api_status, "[Error] vDUT_GetStringParameter(ENTRIES) return error.\n");
+
+		string cmd;
+		char *context = NULL;
+		for (char *entry=strtok_s(entries, "\n", &context); NULL!=entry; entry=strtok_s(NULL, "\n", &context))
+		{
+			char *separator = strchr(entry, '=');
+			if (NULL==separator)
+			{
+				api_status = -1;
+				CheckReturnError(api_status, "[Error] EEPROM entry %s has no value.\n", entry);
+			}
+			else
+			{
+				*separator = '\0';
+				AppendNvramSet(cmd, entry, separator+1);
+				count++;
+			}
+		}
+		cmd += "\n";
+		if ( 0<count && !SendSocketCmd((char*)cmd.c_str()) )
+		{
+			api_status = -1;
+			CheckReturnError(api_status, "[Error] nvram set of %d entries failed.\n", count);
+		}
+		else
+		{
+			// do nothing
+		}
+
+		api_status = ::vDUT_AddIntegerReturn(g_LP_DUT_11ac_id, "COUNT", count);
+		CheckReturnError(api_status, "[Error] vDUT_AddIntegerReturn(COUNT) return error.\n");
+	}
+	catch(char *msg)
+    {
+        vDUT_AddStringReturn(g_LP_DUT_11ac_id, "ERROR_MESSAGE", msg);
+    }
+    catch(...)
+    {
+		vDUT_AddStringReturn(g_LP_DUT_11ac_id, "ERROR_MESSAGE", "[Error] Unknown Error!\n");
+    }
+
+    return api_status;
+}
+
+int LP_read_eeprom(void)
+{
+    int  api_status = 0;
+	char address[MAX_BUFFER_SIZE] = "";
+	char szCmd[MAX_BUFFER_SIZE]   = "";
+
+	::vDUT_ClearReturns(g_LP_DUT_11ac_id);
+
+	try
+	{
+		api_status = ::vDUT_GetStringParameter(g_LP_DUT_11ac_id, "ADDRESS", address, MAX_BUFFER_SIZE);
+		CheckReturnError(api_status, "[Error] vDUT_GetStringParameter(ADDRESS) return error.\n");
+		if ( '\0'==address[0] || NULL!=strpbrk(address, " ;=\r\n") )
+		{
+			throw "[Error] EEPROM address not allowed in an nvram command.\n";
+		}
+		else
+		{
+			// do nothing
+		}
+
+		sprintf_s(szCmd, sizeof(szCmd), "nvram get %s\n", address);
+		if (!SendSocketCmd(szCmd))
+		{
+			api_status = -1;
+			CheckReturnError(api_status, "[Error] nvram get %s failed.\n", address);
+		}
+		else
+		{
+			// do nothing
+		}
+
+		// The reply is the echoed command, the value and the prompt, one per line
+		string value;
+		size_t lineBegin = 0;
+		while (lineBegin<strSocketBuf.size())
+		{
+			size_t lineEnd = strSocketBuf.find_first_of("\r\n", lineBegin);
+			string line = strSocketBuf.substr(lineBegin, (string::npos==lineEnd) ? string::npos : lineEnd-lineBegin);
+			if ( !line.empty() && string::npos==line.find("nvram get") && string::npos==line.find(csSocket.szKeyWord) )
+			{
+				value = line;
+				break;
+			}
+			else
+			{
+				// do nothing
+			}
+			lineBegin = (string::npos==lineEnd) ? strSocketBuf.size() : lineEnd+1;
+		}
+
+		api_status = ::vDUT_AddStringReturn(g_LP_DUT_11ac_id, "EEPROM_RETURN", (char*)value.c_str());
+		CheckReturnError(api_status, "[Error] vDUT_AddStringReturn(EEPROM_RETURN) return error.\n");
+	}
+	catch(char *msg)
+    {
+        vDUT_AddStringReturn(g_LP_DUT_11ac_id, "ERROR_MESSAGE", msg);
+    }
+    catch(...)
+    {
+		vDUT_AddStringReturn(g_LP_DUT_11ac_id, "ERROR_MESSAGE", "[Error] Unknown Error!\n");
+    }
+
+    return api_status;
+}
+
+// The only "nvram commit" of the EEPROM writes
+int LP_finalize_eeprom(void)
+{
+    int  api_status = 0;
+
+	::vDUT_ClearReturns(g_LP_DUT_11ac_id);
+
+	try
+	{
+		if (!SendSocketCmd("nvram commit\n"))
+		{
+			api_status = -1;
+			CheckReturnError(api_status, "[Error] nvram commit failed.\n");
+		}
+		else
+		{
+			// do nothing
+		}
+
+		api_status = ::vDUT_AddStringReturn(g_LP_DUT_11ac_id, "EEPROM_RETURN", "nvram commit");
+		CheckReturnError(api_status, "[Error] vDUT_AddStringReturn(EEPROM_RETURN) return error.\n");
+	}
+	catch(char *msg)
+    {
+        vDUT_AddStringReturn(g_LP_DUT_11ac_id, "ERROR_MESSAGE", msg);
+    }
+    catch(...)
+    {
+		vDUT_AddStringReturn(g_LP_DUT_11ac_id, "ERROR_MESSAGE", "[Error] Unknown Error!\n");
+    }
+
+    return api_status;
+}
+
 int LP_read_ini (char* pathStr )
 {
 // by LJ
@@ -2136,6 +2356,7 @@ int LP_read_ini (char* pathStr )
 		stringLength = GetPrivateProfileString("Configuration","USB_HWID", "", csSocket.szUsbHwID, MAX_BUFFER_SIZE, iniPath);
 		stringLength = GetPrivateProfileString("Configuration","Mod File Path", "Null", pathStr, MAX_BUFFER_SIZE, iniPath);
         csSocket.bRunTelnetEnabled = GetPrivateProfileInt("Configuration","RunTelnetEnable", false, iniPath);
+		csSocket.nReadyTimeoutMs = GetPrivateProfileInt("Configuration","DUT_READY_TIMEOUT_MS", 30000, iniPath);
 
 		// check if the usb device id is null.
 		if(csSocket.szUsbHwID[0]=='\0')
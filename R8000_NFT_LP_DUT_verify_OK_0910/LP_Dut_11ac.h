@@ -48,6 +48,10 @@ int LP_rx_start(void);
 int LP_rx_stop(void);
 int LP_get_serial_number(void);
 int LP_write_mac_address(void);
+int LP_write_eeprom(void);
+int LP_write_eeprom_batch(void);
+int LP_read_eeprom(void);
+int LP_finalize_eeprom(void);
 int GetWaveformFileName(char* filePath, char* fileType, int streamNum_11AC, int chBW, char* datarate, 
 						 char* preamble, char* packetFormat, char* waveformFileName, int bufferSize);
 
@@ -0,0 +1,860 @@
+// TM_Adaptive.cpp : Adaptive test-time reduction of TM_Run(), see TM_AdaptiveOpen()
+//
+// Every TM_Run() adds the double returns of the item to running statistics (Welford mean and variance),
+// kept per item and return.  An item is a function keyword with its integer and string parameters, so the
+// TX_VERIFY_EVM of each channel and rate has its own statistics.  Once every return of an item given a limit
+// by TM_AdaptiveSetLimit() has a Cpk above the policy, the item runs on 1 of sampleRate units only.  A failure,
+// a function error, or a value beyond driftSigma of the history restores full coverage for recoveryUnits units.
+//
+// The same engine replays a TM_ResultSink file in TM_AdaptiveSimulate(), to validate a policy against history.
+#include "stdafx.h"
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <map>
+#include "TestManager.h"
+#include "TM_ResultSink.h"
+#include "TM_RunAsync.h"
+
+using namespace std;
+
+// Containers of TestManager.cpp
+extern map <string, int>             g_intParams[MAX_TECHNOLOGY_NUM];
+extern map <string, string>          g_stringParams[MAX_TECHNOLOGY_NUM];
+extern map <string, double>          g_doubleReturns[MAX_TECHNOLOGY_NUM];
+
+#define TM_ADAPTIVE_FILE_HEADER		"# TM adaptive statistics 1"
+
+typedef struct tagAdaptiveStat
+{
+	int		count;
+	double	mean;
+	double	m2;				// sum of the squared deviations from the mean
+} TM_ADAPTIVE_STAT;
+
+typedef struct tagAdaptiveItem
+{
+	map<string, TM_ADAPTIVE_STAT>	stats;			// per double return
+	int								unitsSkipped;	// units skipped since the item last ran
+	int								fullCoverage;	// units left at full coverage after a drift or a failure
+	int								runs;			// TM_AdaptiveSimulate() report only
+	int								skips;
+	int								escapes;		// failing runs the policy would have skipped
+} TM_ADAPTIVE_ITEM;
+
+typedef struct tagAdaptiveLimit
+{
+	double	lower;
+	double	upper;
+} TM_ADAPTIVE_LIMIT;
+
+typedef struct tagAdaptivePolicy
+{
+	int		minSamples;
+	double	cpkSkip;
+	int		sampleRate;
+	double	driftSigma;
+	int		recoveryUnits;
+} TM_ADAPTIVE_POLICY;
+
+typedef map<string, TM_ADAPTIVE_ITEM>						TM_ADAPTIVE_ITEMS;
+typedef map<string, map<string, TM_ADAPTIVE_LIMIT> >		TM_ADAPTIVE_LIMITS;		// <technology|keyword, <return, limit>>
+
+typedef struct tagAdaptive
+{
+	bool				enabled;
+	string				fileName;
+	TM_ADAPTIVE_POLICY	policy;
+	TM_ADAPTIVE_LIMITS	limits;
+	TM_ADAPTIVE_ITEMS	items;
+	CRITICAL_SECTION	lock;		// TM_Run() of different technologies may run on different threads
+} TM_ADAPTIVE;
+
+TM_ADAPTIVE g_adaptive;
+
+static string AdaptiveKeywordKey(TM_ID technologyID, const string &functionKeyword)
+{
+	char technology[16];
+	sprintf_s(technology, sizeof(technology), "%d|", technologyID);
+	return technology + functionKeyword;
+}
+
+static string AdaptiveItemKey(TM_ID technologyID, const string &functionKeyword, const map<string, int> &intParams, const map<string, string> &stringParams)
+{
+	string key = AdaptiveKeywordKey(technologyID, functionKeyword);
+	char value[32];
+
+	// Double parameters are left out, they carry the cable loss that changes with calibration
+	for (map<string, int>::const_iterator int_Iter=intParams.begin(); int_Iter!=intParams.end(); int_Iter++)
+	{
+		sprintf_s(value, sizeof(value), "%d", int_Iter->second);
+		key += "|" + int_Iter->first + "=" + value;
+	}
+	for (map<string, string>::const_iterator string_Iter=stringParams.begin(); string_Iter!=stringParams.end(); string_Iter++)
+	{
+		key += "|" + string_Iter->first + "=" + string_Iter->second;
+	}
+
+	return key;
+}
+
+static double AdaptiveSigma(const TM_ADAPTIVE_STAT &stat)
+{
+	return (stat.count>1) ? sqrt(stat.m2/(stat.count-1)) : 0.0;
+}
+
+// Process capability of a return against its limits, NA_NUMBER if it cannot be computed
+static double AdaptiveCpk(const TM_ADAPTIVE_STAT &stat, const TM_ADAPTIVE_LIMIT &limit)
+{
+	double sigma = AdaptiveSigma(stat);
+	double cpk   = NA_NUMBER;
+
+	if (NA_NUMBER!=limit.upper)
+	{
+		cpk = (limit.upper-stat.mean)/(3*sigma);
+	}
+	else
+	{
+		// do nothing
+	}
+	if (NA_NUMBER!=limit.lower)
+	{
+		double cpkLower = (stat.mean-limit.lower)/(3*sigma);
+		cpk = (NA_NUMBER==cpk) ? cpkLower : min(cpk, cpkLower);
+	}
+	else
+	{
+		// do nothing
+	}
+
+	return cpk;
+}
+
+// Decides whether the item is skipped on this unit; the reason is set either way
+static bool AdaptiveDecideSkip(const TM_ADAPTIVE_POLICY &policy, const TM_ADAPTIVE_LIMITS &limits, TM_ID technologyID,
+							   const string &functionKeyword, TM_ADAPTIVE_ITEM &item, string &reason)
+{
+	char text[MAX_BUFFER_SIZE];
+
+	TM_ADAPTIVE_LIMITS::const_iterator limits_Iter = limits.find(AdaptiveKeywordKey(technologyID, functionKeyword));
+	if ( policy.sampleRate<=1 || limits_Iter==limits.end() || limits_Iter->second.empty() )
+	{
+		reason = "no limits";
+		return false;
+	}
+	else if ( 0<item.fullCoverage )
+	{
+		sprintf_s(text, sizeof(text), "full coverage for %d more units", item.fullCoverage);
+		reason = text;
+		return false;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	// Every return with a limit must be capable
+	double cpkMin = 0.0;
+	int    samples = 0;
+	for (map<string, TM_ADAPTIVE_LIMIT>::const_iterator limit_Iter=limits_Iter->second.begin(); limit_Iter!=limits_Iter->second.end(); limit_Iter++)
+	{
+		map<string, TM_ADAPTIVE_STAT>::iterator stat_Iter = item.stats.find(limit_Iter->first);
+		if ( stat_Iter==item.stats.end() || stat_Iter->second.count<policy.minSamples )
+		{
+			sprintf_s(text, sizeof(text), "%s has fewer than %d samples", limit_Iter->first.c_str(), policy.minSamples);
+			reason = text;
+			return false;
+		}
+		else
+		{
+			// do nothing
+		}
+
+		double cpk = AdaptiveCpk(stat_Iter->second, limit_Iter->second);
+		if ( NA_NUMBER==cpk || cpk<policy.cpkSkip )
+		{
+			sprintf_s(text, sizeof(text), "%s Cpk %.2f below %.2f", limit_Iter->first.c_str(), cpk, policy.cpkSkip);
+			reason = text;
+			return false;
+		}
+		else
+		{
+			cpkMin  = (limit_Iter==limits_Iter->second.begin()) ? cpk : min(cpkMin, cpk);
+			samples = (limit_Iter==limits_Iter->second.begin()) ? stat_Iter->second.count : min(samples, stat_Iter->second.count);
+		}
+	}
+
+	if ( item.unitsSkipped+1>=policy.sampleRate )
+	{
+		sprintf_s(text, sizeof(text), "sampled unit, 1 of %d", policy.sampleRate);
+		reason = text;
+		return false;
+	}
+	else
+	{
+		sprintf_s(text, sizeof(text), "Cpk %.2f >= %.2f over %d runs, runs on 1 of %d units", cpkMin, policy.cpkSkip, samples, policy.sampleRate);
+		reason = text;
+		return true;
+	}
+}
+
+// True, with the reason, if the run failed: a function error, or a return beyond its limits
+static bool AdaptiveFailed(const TM_ADAPTIVE_LIMITS &limits, TM_ID technologyID, const string &functionKeyword,
+						   const map<string, double> &doubleReturns, TM_RETURN tmReturn, string &reason)
+{
+	char text[MAX_BUFFER_SIZE];
+
+	if (TM_ERR_OK!=tmReturn)
+	{
+		reason = "function error";
+		return true;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	TM_ADAPTIVE_LIMITS::const_iterator limits_Iter = limits.find(AdaptiveKeywordKey(technologyID, functionKeyword));
+	if (limits_Iter==limits.end())
+	{
+		return false;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	for (map<string, TM_ADAPTIVE_LIMIT>::const_iterator limit_Iter=limits_Iter->second.begin(); limit_Iter!=limits_Iter->second.end(); limit_Iter++)
+	{
+		map<string, double>::const_iterator double_Iter = doubleReturns.find(limit_Iter->first);
+		if ( double_Iter==doubleReturns.end() || NA_NUMBER==double_Iter->second )
+		{
+			// do nothing
+		}
+		else if ( (NA_NUMBER!=limit_Iter->second.lower && double_Iter->second<limit_Iter->second.lower) ||
+				  (NA_NUMBER!=limit_Iter->second.upper && double_Iter->second>limit_Iter->second.upper) )
+		{
+			sprintf_s(text, sizeof(text), "%s %.3f beyond the limits", limit_Iter->first.c_str(), double_Iter->second);
+			reason = text;
+			return true;
+		}
+		else
+		{
+			// do nothing
+		}
+	}
+
+	return false;
+}
+
+// Adds a run to the statistics; returns true, with the reason, if it restores full coverage
+static bool AdaptiveUpdate(const TM_ADAPTIVE_POLICY &policy, const TM_ADAPTIVE_LIMITS &limits, TM_ID technologyID,
+						   const string &functionKeyword, TM_ADAPTIVE_ITEM &item, const map<string, double> &doubleReturns,
+						   TM_RETURN tmReturn, string &reason)
+{
+	char text[MAX_BUFFER_SIZE];
+	reason = "";
+
+	AdaptiveFailed(limits, technologyID, functionKeyword, doubleReturns, tmReturn, reason);
+
+	TM_ADAPTIVE_LIMITS::const_iterator limits_Iter = limits.find(AdaptiveKeywordKey(technologyID, functionKeyword));
+	for (map<string, double>::const_iterator double_Iter=doubleReturns.begin(); double_Iter!=doubleReturns.end(); double_Iter++)
+	{
+		double value = double_Iter->second;
+		if (NA_NUMBER==value)
+		{
+			continue;
+		}
+		else
+		{
+			// do nothing
+		}
+
+		// Drift of a return with limits, from the history before this run
+		TM_ADAPTIVE_STAT &stat = item.stats[double_Iter->first];
+		if ( limits_Iter!=limits.end() && reason.empty() &&
+			 limits_Iter->second.end()!=limits_Iter->second.find(double_Iter->first) )
+		{
+			double sigma = AdaptiveSigma(stat);
+			if ( stat.count>=policy.minSamples && 0<sigma && fabs(value-stat.mean)>policy.driftSigma*sigma )
+			{
+				sprintf_s(text, sizeof(text), "%s %.3f drifted %.1f sigma from %.3f", double_Iter->first.c_str(), value, fabs(value-stat.mean)/sigma, stat.mean);
+				reason = text;
+			}
+			else
+			{
+				// do nothing
+			}
+		}
+		else
+		{
+			// do nothing
+		}
+
+		stat.count++;
+		double delta = value-stat.mean;
+		stat.mean += delta/stat.count;
+		stat.m2   += delta*(value-stat.mean);
+	}
+
+	item.unitsSkipped = 0;
+	if (!reason.empty())
+	{
+		item.fullCoverage = policy.recoveryUnits;
+		return true;
+	}
+	else if (0<item.fullCoverage)
+	{
+		item.fullCoverage--;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	return false;
+}
+
+static TM_ADAPTIVE_ITEM AdaptiveNewItem(void)
+{
+	TM_ADAPTIVE_ITEM item;
+	item.unitsSkipped = 0;
+	item.fullCoverage = 0;
+	item.runs         = 0;
+	item.skips        = 0;
+	item.escapes      = 0;
+	return item;
+}
+
+static bool AdaptiveReadLine(FILE *fp, string &line)
+{
+	char buffer[MAX_BUFFER_SIZE];
+
+	line = "";
+	while ( NULL!=fgets(buffer, sizeof(buffer), fp) )
+	{
+		line += buffer;
+		if ('\n'==line[line.size()-1])
+		{
+			break;
+		}
+		else
+		{
+			// do nothing
+		}
+	}
+	while ( !line.empty() && ('\n'==line[line.size()-1] || '\r'==line[line.size()-1]) )
+	{
+		line.erase(line.size()-1);
+	}
+
+	return !line.empty() || !feof(fp);
+}
+
+static void AdaptiveLoad(const string &fileName, TM_ADAPTIVE_ITEMS &items)
+{
+	FILE *fp = NULL;
+	if ( 0!=fopen_s(&fp, fileName.c_str(), "r") || NULL==fp )
+	{
+		// First run of the station
+		return;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	// ITEM<TAB>key<TAB>unitsSkipped<TAB>fullCoverage, followed by STAT<TAB>return<TAB>count<TAB>mean<TAB>m2 lines
+	string line;
+	TM_ADAPTIVE_ITEM *item = NULL;
+	while ( AdaptiveReadLine(fp, line) )
+	{
+		vector<string> fields;
+		for (string::size_type start=0; start<=line.size(); )
+		{
+			string::size_type stop = line.find('\t', start);
+			if (string::npos==stop) stop = line.size();
+			fields.push_back(line.substr(start, stop-start));
+			start = stop+1;
+		}
+
+		if ( 4==fields.size() && "ITEM"==fields[0] )
+		{
+			item = &items[fields[1]];
+			*item = AdaptiveNewItem();
+			item->unitsSkipped = atoi(fields[2].c_str());
+			item->fullCoverage = atoi(fields[3].c_str());
+		}
+		else if ( 5==fields.size() && "STAT"==fields[0] && NULL!=item )
+		{
+			TM_ADAPTIVE_STAT &stat = item->stats[fields[1]];
+			stat.count = atoi(fields[2].c_str());
+			stat.mean  = atof(fields[3].c_str());
+			stat.m2    = atof(fields[4].c_str());
+		}
+		else
+		{
+			// Header or comment
+		}
+	}
+	fclose(fp);
+}
+
+static TM_RETURN AdaptiveSave(const string &fileName, const TM_ADAPTIVE_ITEMS &items)
+{
+	// Written to a temporary file first, so that a crash does not lose the history
+	string tempName = fileName + ".tmp";
+	FILE *fp = NULL;
+	if ( 0!=fopen_s(&fp, tempName.c_str(), "w") || NULL==fp )
+	{
+		return TM_ERR_FAILED_TO_OPEN_FILE;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	fprintf(fp, "%s\n", TM_ADAPTIVE_FILE_HEADER);
+	for (TM_ADAPTIVE_ITEMS::const_iterator item_Iter=items.begin(); item_Iter!=items.end(); item_Iter++)
+	{
+		fprintf(fp, "ITEM\t%s\t%d\t%d\n", item_Iter->first.c_str(), item_Iter->second.unitsSkipped, item_Iter->second.fullCoverage);
+		for (map<string, TM_ADAPTIVE_STAT>::const_iterator stat_Iter=item_Iter->second.stats.begin(); stat_Iter!=item_Iter->second.stats.end(); stat_Iter++)
+		{
+			fprintf(fp, "STAT\t%s\t%d\t%.17g\t%.17g\n", stat_Iter->first.c_str(), stat_Iter->second.count, stat_Iter->second.mean, stat_Iter->second.m2);
+		}
+	}
+	fclose(fp);
+
+	if ( !MoveFileExA(tempName.c_str(), fileName.c_str(), MOVEFILE_REPLACE_EXISTING) )
+	{
+		return TM_ERR_FAILED_TO_OPEN_FILE;
+	}
+	else
+	{
+		return TM_ERR_OK;
+	}
+}
+
+void Adaptive_Initialize(void)
+{
+	g_adaptive.enabled              = false;
+	g_adaptive.policy.minSamples    = 30;
+	g_adaptive.policy.cpkSkip       = 2.0;
+	g_adaptive.policy.sampleRate    = 10;
+	g_adaptive.policy.driftSigma    = 4.0;
+	g_adaptive.policy.recoveryUnits = 50;
+	InitializeCriticalSection(&g_adaptive.lock);
+}
+
+// Called by TM_Run() before the test function; true if the item is skipped on this unit
+bool Adaptive_Skip(TM_ID technologyID, const TM_STR functionKeyword, string &reason)
+{
+	if ( !g_adaptive.enabled || IQREPORT==technologyID ||
+		 TM_CONTAINER(intParams, technologyID).end()!=TM_CONTAINER(intParams, technologyID).find("QUERY_INPUT") ||
+		 TM_CONTAINER(intParams, technologyID).end()!=TM_CONTAINER(intParams, technologyID).find("QUERY_RETURN") )
+	{
+		return false;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	string key = AdaptiveItemKey(technologyID, functionKeyword, TM_CONTAINER(intParams, technologyID), TM_CONTAINER(stringParams, technologyID));
+
+	EnterCriticalSection(&g_adaptive.lock);
+	TM_ADAPTIVE_ITEMS::iterator item_Iter = g_adaptive.items.find(key);
+	if (item_Iter==g_adaptive.items.end())
+	{
+		item_Iter = g_adaptive.items.insert(make_pair(key, AdaptiveNewItem())).first;
+	}
+	else
+	{
+		// do nothing
+	}
+	bool skip = AdaptiveDecideSkip(g_adaptive.policy, g_adaptive.limits, technologyID, functionKeyword, item_Iter->second, reason);
+	if (skip)
+	{
+		item_Iter->second.unitsSkipped++;
+	}
+	else
+	{
+		// do nothing
+	}
+	LeaveCriticalSection(&g_adaptive.lock);
+
+	return skip;
+}
+
+// Called by TM_Run() after the test function; true, with the reason, if the run restored full coverage
+bool Adaptive_Record(TM_ID technologyID, const TM_STR functionKeyword, TM_RETURN tmReturn, string &reason)
+{
+	if ( !g_adaptive.enabled || IQREPORT==technologyID ||
+		 TM_CONTAINER(intParams, technologyID).end()!=TM_CONTAINER(intParams, technologyID).find("QUERY_INPUT") ||
+		 TM_CONTAINER(intParams, technologyID).end()!=TM_CONTAINER(intParams, technologyID).find("QUERY_RETURN") )
+	{
+		return false;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	string key = AdaptiveItemKey(technologyID, functionKeyword, TM_CONTAINER(intParams, technologyID), TM_CONTAINER(stringParams, technologyID));
+
+	EnterCriticalSection(&g_adaptive.lock);
+	TM_ADAPTIVE_ITEMS::iterator item_Iter = g_adaptive.items.find(key);
+	if (item_Iter==g_adaptive.items.end())
+	{
+		item_Iter = g_adaptive.items.insert(make_pair(key, AdaptiveNewItem())).first;
+	}
+	else
+	{
+		// do nothing
+	}
+	bool restored = AdaptiveUpdate(g_adaptive.policy, g_adaptive.limits, technologyID, functionKeyword, item_Iter->second,
+								   TM_CONTAINER(doubleReturns, technologyID), tmReturn, reason);
+	LeaveCriticalSection(&g_adaptive.lock);
+
+	return restored;
+}
+
+// Called at DLL_PROCESS_DETACH, under the loader lock: no file I/O here, the statistics not saved by
+// TM_AdaptiveClose() are lost
+void Adaptive_Abandon(void)
+{
+	g_adaptive.enabled = false;
+	g_adaptive.items.clear();
+	DeleteCriticalSection(&g_adaptive.lock);
+}
+
+TM_API TM_RETURN __stdcall TM_AdaptiveOpen(const TM_STR statisticsFileName)
+{
+	if (NULL==statisticsFileName)
+	{
+		return TM_ERR_FAILED_TO_OPEN_FILE;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	EnterCriticalSection(&g_adaptive.lock);
+	if (!g_adaptive.enabled)
+	{
+		g_adaptive.fileName = statisticsFileName;
+		g_adaptive.items.clear();
+		AdaptiveLoad(g_adaptive.fileName, g_adaptive.items);
+		g_adaptive.enabled = true;
+	}
+	else
+	{
+		// do nothing
+	}
+	LeaveCriticalSection(&g_adaptive.lock);
+
+	return TM_ERR_OK;
+}
+
+TM_API TM_RETURN __stdcall TM_AdaptiveClose(void)
+{
+	TM_RETURN ret = TM_ERR_OK;
+
+	EnterCriticalSection(&g_adaptive.lock);
+	if (g_adaptive.enabled)
+	{
+		g_adaptive.enabled = false;
+		ret = AdaptiveSave(g_adaptive.fileName, g_adaptive.items);
+		g_adaptive.items.clear();
+	}
+	else
+	{
+		// do nothing
+	}
+	LeaveCriticalSection(&g_adaptive.lock);
+
+	return ret;
+}
+
+TM_API TM_RETURN __stdcall TM_AdaptiveSetPolicy(int minSamples, double cpkSkip, int sampleRate, double driftSigma, int recoveryUnits)
+{
+	EnterCriticalSection(&g_adaptive.lock);
+	g_adaptive.policy.minSamples    = max(2, minSamples);
+	g_adaptive.policy.cpkSkip       = cpkSkip;
+	g_adaptive.policy.sampleRate    = max(1, sampleRate);
+	g_adaptive.policy.driftSigma    = driftSigma;
+	g_adaptive.policy.recoveryUnits = max(0, recoveryUnits);
+	LeaveCriticalSection(&g_adaptive.lock);
+
+	return TM_ERR_OK;
+}
+
+TM_API TM_RETURN __stdcall TM_AdaptiveSetLimit(TM_ID technologyID, const TM_STR functionKeyword, const TM_STR returnName, double lowerLimit, double upperLimit)
+{
+	if ( technologyID<0 || technologyID>=MAX_TECHNOLOGY_NUM )
+	{
+		return TM_ERR_INVALID_TECHNOLOGY_ID;
+	}
+	else if ( NULL==functionKeyword || NULL==returnName )
+	{
+		return TM_ERR_PARAM_DOES_NOT_EXIST;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	TM_ADAPTIVE_LIMIT limit;
+	limit.lower = lowerLimit;
+	limit.upper = upperLimit;
+
+	EnterCriticalSection(&g_adaptive.lock);
+	if ( NA_NUMBER==lowerLimit && NA_NUMBER==upperLimit )
+	{
+		g_adaptive.limits[AdaptiveKeywordKey(technologyID, functionKeyword)].erase(returnName);
+	}
+	else
+	{
+		g_adaptive.limits[AdaptiveKeywordKey(technologyID, functionKeyword)][returnName] = limit;
+	}
+	LeaveCriticalSection(&g_adaptive.lock);
+
+	return TM_ERR_OK;
+}
+
+// Reads the little-endian fields of a TM_ResultSink record
+static bool SimGet(const string &record, size_t &pos, void *value, size_t size)
+{
+	if (pos+size>record.size())
+	{
+		return false;
+	}
+	else
+	{
+		memcpy(value, record.data()+pos, size);
+		pos += size;
+		return true;
+	}
+}
+
+static bool SimGetString(const string &record, size_t &pos, string &value)
+{
+	unsigned short length = 0;
+	if ( !SimGet(record, pos, &length, sizeof(length)) || pos+length>record.size() )
+	{
+		return false;
+	}
+	else
+	{
+		value.assign(record.data()+pos, length);
+		pos += length;
+		return true;
+	}
+}
+
+TM_API TM_RETURN __stdcall TM_AdaptiveSimulate(const TM_STR resultFileName, const TM_STR reportFileName, int *runCount, int *skipCount, int *escapeCount)
+{
+	FILE *fp = NULL;
+	if ( NULL==resultFileName || 0!=fopen_s(&fp, resultFileName, "rb") || NULL==fp )
+	{
+		return TM_ERR_FAILED_TO_OPEN_FILE;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	// The simulation starts from empty statistics, with the policy and limits of the station
+	EnterCriticalSection(&g_adaptive.lock);
+	TM_ADAPTIVE_POLICY policy = g_adaptive.policy;
+	TM_ADAPTIVE_LIMITS limits = g_adaptive.limits;
+	LeaveCriticalSection(&g_adaptive.lock);
+
+	TM_ADAPTIVE_ITEMS items;
+	int runs = 0, skips = 0, escapes = 0;
+
+	// File header: magic, version, station name, technology names
+	char magic[8];
+	int version = 0;
+	unsigned short technologyNum = 0;
+	bool ok = ( 1==fread(magic, sizeof(magic), 1, fp) && 0==memcmp(magic, TM_RESULT_SINK_MAGIC, sizeof(magic)) &&
+				1==fread(&version, sizeof(version), 1, fp) );
+	if (ok)
+	{
+		unsigned short length = 0;
+		ok = ( 1==fread(&length, sizeof(length), 1, fp) && 0==fseek(fp, length, SEEK_CUR) &&
+			   1==fread(&technologyNum, sizeof(technologyNum), 1, fp) );
+	}
+	else
+	{
+		// do nothing
+	}
+	for (int i=0; ok && i<technologyNum; i++)
+	{
+		unsigned short length = 0;
+		ok = ( 1==fread(&length, sizeof(length), 1, fp) && 0==fseek(fp, length, SEEK_CUR) );
+	}
+	if (!ok)
+	{
+		fclose(fp);
+		return TM_ERR_FAILED_TO_OPEN_FILE;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	// Records, in the order the station ran them
+	unsigned int recordSize = 0;
+	while ( 1==fread(&recordSize, sizeof(recordSize), 1, fp) )
+	{
+		string record(recordSize, '\0');
+		if ( 0<recordSize && 1!=fread(&record[0], recordSize, 1, fp) )
+		{
+			break;
+		}
+		else
+		{
+			// do nothing
+		}
+
+		size_t pos = sizeof(unsigned __int64)+sizeof(double);
+		int technologyID = -1, tmReturn = TM_ERR_OK;
+		string functionKeyword, serialNumber;
+		unsigned short itemCount = 0;
+		if ( !SimGet(record, pos, &technologyID, sizeof(technologyID)) || !SimGetString(record, pos, functionKeyword) ||
+			 !SimGet(record, pos, &tmReturn, sizeof(tmReturn)) || !SimGetString(record, pos, serialNumber) ||
+			 !SimGet(record, pos, &itemCount, sizeof(itemCount)) )
+		{
+			continue;
+		}
+		else
+		{
+			// do nothing
+		}
+
+		map<string, int>    intParams;
+		map<string, string> stringParams;
+		map<string, double> doubleReturns;
+		bool recordOK = true;
+		for (int i=0; i<itemCount && recordOK; i++)
+		{
+			unsigned char type = 0;
+			string name, unit, stringValue;
+			int intValue = 0, arraySize = 0;
+			double doubleValue = 0.0;
+
+			recordOK = SimGet(record, pos, &type, sizeof(type)) && SimGetString(record, pos, name) && SimGetString(record, pos, unit);
+			switch (type)
+			{
+			case TM_ITEM_INT_PARAM:
+				recordOK = recordOK && SimGet(record, pos, &intValue, sizeof(intValue));
+				intParams[name] = intValue;
+				break;
+			case TM_ITEM_STRING_PARAM:
+				recordOK = recordOK && SimGetString(record, pos, stringValue);
+				stringParams[name] = stringValue;
+				break;
+			case TM_ITEM_DOUBLE_RETURN:
+				recordOK = recordOK && SimGet(record, pos, &doubleValue, sizeof(doubleValue));
+				doubleReturns[name] = doubleValue;
+				break;
+			case TM_ITEM_INT_RETURN:
+				recordOK = recordOK && SimGet(record, pos, &intValue, sizeof(intValue));
+				break;
+			case TM_ITEM_DOUBLE_PARAM:
+				recordOK = recordOK && SimGet(record, pos, &doubleValue, sizeof(doubleValue));
+				break;
+			case TM_ITEM_STRING_RETURN:
+				recordOK = recordOK && SimGetString(record, pos, stringValue);
+				break;
+			case TM_ITEM_ARRAY_DOUBLE_RETURN:
+				recordOK = recordOK && SimGet(record, pos, &arraySize, sizeof(arraySize));
+				pos += (size_t)max(0, arraySize)*sizeof(double);
+				break;
+			default:
+				// Newer item types cannot be skipped item by item, the rest of the record is ignored
+				i = itemCount;
+				break;
+			}
+		}
+		if ( !recordOK || technologyID<0 || technologyID>=MAX_TECHNOLOGY_NUM )
+		{
+			continue;
+		}
+		else
+		{
+			// do nothing
+		}
+
+		string key = AdaptiveItemKey(technologyID, functionKeyword, intParams, stringParams);
+		TM_ADAPTIVE_ITEMS::iterator item_Iter = items.find(key);
+		if (item_Iter==items.end())
+		{
+			item_Iter = items.insert(make_pair(key, AdaptiveNewItem())).first;
+		}
+		else
+		{
+			// do nothing
+		}
+		TM_ADAPTIVE_ITEM &item = item_Iter->second;
+
+		string reason;
+		if ( AdaptiveDecideSkip(policy, limits, technologyID, functionKeyword, item, reason) )
+		{
+			// A skipped run is not seen by the policy; it escapes if it would have failed
+			item.unitsSkipped++;
+			item.skips++;
+			skips++;
+
+			if ( AdaptiveFailed(limits, technologyID, functionKeyword, doubleReturns, (TM_RETURN)tmReturn, reason) )
+			{
+				item.escapes++;
+				escapes++;
+			}
+			else
+			{
+				// do nothing
+			}
+		}
+		else
+		{
+			AdaptiveUpdate(policy, limits, technologyID, functionKeyword, item, doubleReturns, (TM_RETURN)tmReturn, reason);
+			item.runs++;
+			runs++;
+		}
+	}
+	fclose(fp);
+
+	if (NULL!=reportFileName)
+	{
+		FILE *report = NULL;
+		if ( 0!=fopen_s(&report, reportFileName, "w") || NULL==report )
+		{
+			return TM_ERR_FAILED_TO_OPEN_FILE;
+		}
+		else
+		{
+			// do nothing
+		}
+
+		fprintf(report, "Item,Runs,Skips,Escapes\n");
+		for (TM_ADAPTIVE_ITEMS::iterator item_Iter=items.begin(); item_Iter!=items.end(); item_Iter++)
+		{
+			fprintf(report, "\"%s\",%d,%d,%d\n", item_Iter->first.c_str(), item_Iter->second.runs, item_Iter->second.skips, item_Iter->second.escapes);
+		}
+		fclose(report);
+	}
+	else
+	{
+		// do nothing
+	}
+
+	if (NULL!=runCount)    *runCount    = runs;
+	if (NULL!=skipCount)   *skipCount   = skips;
+	if (NULL!=escapeCount) *escapeCount = escapes;
+
+	return TM_ERR_OK;
+}
@@ -0,0 +1,509 @@
+// TM_AllocProfiler.cpp : Sampled allocation profile of TM_Run(), see TM_AllocProfilerStart()
+//
+// The operator new hook of ..\IQmeasure\AllocProfiler.cpp counts the allocations of each thread and calls
+// TM_AllocProfilerRecord() about once per sample interval of bytes, with the call stack of the allocation that
+// crossed it.  Each thread appends the records, and its TM_Run() start and end markers, to its own log: a list of
+// fixed size chunks from the process heap, each published by an interlocked count, so recording takes no lock and
+// TM_AllocProfilerReport() reads the logs while they grow.  The records carry the epoch of their allocations; the
+// epoch changes at each TM_Run() start and end, and the markers of the thread map it to the function keyword.
+#include "stdafx.h"
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include "TestManager.h"
+#include "..\IQmeasure\AllocProfiler.h"
+
+using namespace std;
+
+// Defined in TM_ResultSink.cpp
+extern const char *g_resultSinkTechnologyNames[MAX_TECHNOLOGY_NUM];
+
+#define TM_ALLOC_CHUNK_RECORDS		256
+#define TM_ALLOC_MARKERS			16			// late records of a thread resolve against its last markers only
+#define TM_ALLOC_REPORT_FRAMES		3			// frames that name a call site in the report
+#define TM_ALLOC_REPORT_SITES		10			// call sites reported per keyword
+
+typedef struct tagAllocRecord
+{
+	long			epoch;
+	int				keyword;		// index in g_allocProfiler.keywords, -1 outside TM_Run()
+	unsigned int	runs;			// 1 for a TM_Run() start marker
+	unsigned int	allocs;
+	unsigned int	bytes;
+	unsigned int	sampleSize;		// 0 if not a sample
+	int				frameCount;
+	void			*frames[ALLOC_PROFILER_MAX_FRAMES];
+} TM_ALLOC_RECORD;
+
+typedef struct tagAllocChunk
+{
+	TM_ALLOC_RECORD					records[TM_ALLOC_CHUNK_RECORDS];
+	volatile long					count;			// records visible to the report
+	struct tagAllocChunk * volatile	next;
+} TM_ALLOC_CHUNK;
+
+typedef struct tagAllocMarker
+{
+	long	epoch;
+	int		keyword;
+} TM_ALLOC_MARKER;
+
+typedef struct tagAllocThread
+{
+	TM_ALLOC_CHUNK					*first;
+	TM_ALLOC_CHUNK					*last;			// owner thread only, as the markers
+	TM_ALLOC_MARKER					markers[TM_ALLOC_MARKERS];
+	int								markerCount;
+	struct tagAllocThread			*next;
+} TM_ALLOC_THREAD;
+
+typedef struct tagAllocProfiler
+{
+	ALLOC_PROFILER_STATE			state;
+	volatile long					epochCounter;
+	volatile long					startEpoch;		// older records belong to a previous TM_AllocProfilerStart()
+	DWORD							tls;
+	TM_ALLOC_THREAD * volatile		threads;
+	vector< pair<int, string> >		keywords;		// <technology, keyword>
+	map<string, int>				keywordIndex;	// technology|keyword
+	CRITICAL_SECTION				lock;			// keywords
+} TM_ALLOC_PROFILER;
+
+TM_ALLOC_PROFILER g_allocProfiler;
+
+typedef struct tagAllocSite
+{
+	unsigned int	samples;
+	double			bytes;			// estimated
+} TM_ALLOC_SITE;
+
+typedef struct tagAllocKeywordStat
+{
+	unsigned int					runs;
+	double							allocs;
+	double							bytes;
+	unsigned int					samples;
+	map<vector<void*>, TM_ALLOC_SITE>	sites;
+} TM_ALLOC_KEYWORD_STAT;
+
+// Log of the calling thread, created at its first record; logs are kept until the process exits
+static TM_ALLOC_THREAD* AllocProfilerThread(void)
+{
+	TM_ALLOC_THREAD *thread = (TM_ALLOC_THREAD*)TlsGetValue(g_allocProfiler.tls);
+	if (NULL!=thread)
+	{
+		return thread;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	thread = (TM_ALLOC_THREAD*)HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(TM_ALLOC_THREAD));
+	TM_ALLOC_CHUNK *chunk = (TM_ALLOC_CHUNK*)HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(TM_ALLOC_CHUNK));
+	if ( NULL==thread || NULL==chunk )
+	{
+		if (NULL!=thread)
+		{
+			HeapFree(GetProcessHeap(), 0, thread);
+		}
+		else
+		{
+			// do nothing
+		}
+		if (NULL!=chunk)
+		{
+			HeapFree(GetProcessHeap(), 0, chunk);
+		}
+		else
+		{
+			// do nothing
+		}
+		return NULL;
+	}
+	else
+	{
+		thread->first = chunk;
+		thread->last  = chunk;
+	}
+
+	// Lock-free push on the list read by TM_AllocProfilerReport()
+	TM_ALLOC_THREAD *head = NULL;
+	do
+	{
+		head = g_allocProfiler.threads;
+		thread->next = head;
+	} while ( head!=(TM_ALLOC_THREAD*)InterlockedCompareExchangePointer((PVOID volatile*)&g_allocProfiler.threads, thread, head) );
+
+	TlsSetValue(g_allocProfiler.tls, thread);
+	return thread;
+}
+
+// Next free record of the thread log; it is visible to the report after AllocProfilerPublish()
+static TM_ALLOC_RECORD* AllocProfilerAppend(TM_ALLOC_THREAD *thread)
+{
+	TM_ALLOC_CHUNK *chunk = thread->last;
+	if (TM_ALLOC_CHUNK_RECORDS==chunk->count)
+	{
+		TM_ALLOC_CHUNK *newChunk = (TM_ALLOC_CHUNK*)HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(TM_ALLOC_CHUNK));
+		if (NULL==newChunk)
+		{
+			return NULL;
+		}
+		else
+		{
+			InterlockedExchangePointer((PVOID volatile*)&chunk->next, newChunk);
+			thread->last = newChunk;
+			chunk = newChunk;
+		}
+	}
+	else
+	{
+		// do nothing
+	}
+
+	TM_ALLOC_RECORD *record = &chunk->records[chunk->count];
+	memset(record, 0, sizeof(TM_ALLOC_RECORD));
+	return record;
+}
+
+static void AllocProfilerPublish(TM_ALLOC_THREAD *thread)
+{
+	InterlockedIncrement(&thread->last->count);
+}
+
+// Keyword of the thread at epoch: the last TM_Run() start or end marker of the thread not after it
+static int AllocProfilerKeywordAt(TM_ALLOC_THREAD *thread, long epoch)
+{
+	int oldest = max(0, thread->markerCount-TM_ALLOC_MARKERS);
+	for (int i=thread->markerCount-1; i>=oldest; i--)
+	{
+		const TM_ALLOC_MARKER &marker = thread->markers[i%TM_ALLOC_MARKERS];
+		if (marker.epoch<=epoch)
+		{
+			return marker.keyword;
+		}
+		else
+		{
+			// do nothing
+		}
+	}
+	return -1;
+}
+
+// Starts a new epoch, seen by the hooks at their next allocation; the epoch never goes back, nor restarts a stopped profiler
+static long AllocProfilerNewEpoch(void)
+{
+	long epoch = InterlockedIncrement(&g_allocProfiler.epochCounter);
+	long current = g_allocProfiler.state.epoch;
+	while ( 0!=current && current<epoch )
+	{
+		long previous = InterlockedCompareExchange(&g_allocProfiler.state.epoch, epoch, current);
+		if (previous==current)
+		{
+			break;
+		}
+		else
+		{
+			current = previous;
+		}
+	}
+	return epoch;
+}
+
+static void AllocProfilerMark(int keyword, unsigned int runs)
+{
+	TM_ALLOC_THREAD *thread = AllocProfilerThread();
+	if (NULL==thread)
+	{
+		return;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	long epoch = AllocProfilerNewEpoch();
+	thread->markers[thread->markerCount%TM_ALLOC_MARKERS].epoch   = epoch;
+	thread->markers[thread->markerCount%TM_ALLOC_MARKERS].keyword = keyword;
+	thread->markerCount++;
+
+	TM_ALLOC_RECORD *record = AllocProfilerAppend(thread);
+	if (NULL!=record)
+	{
+		record->epoch   = epoch;
+		record->keyword = keyword;
+		record->runs    = runs;
+		AllocProfilerPublish(thread);
+	}
+	else
+	{
+		// do nothing
+	}
+}
+
+void AllocProfiler_Initialize(void)
+{
+	g_allocProfiler.state.epoch          = 0;
+	g_allocProfiler.state.sampleInterval = ALLOC_PROFILER_DEFAULT_INTERVAL;
+	g_allocProfiler.epochCounter         = 0;
+	g_allocProfiler.startEpoch           = 0;
+	g_allocProfiler.threads              = NULL;
+	g_allocProfiler.tls                  = TlsAlloc();
+	InitializeCriticalSection(&g_allocProfiler.lock);
+}
+
+// Called by TM_Run() before the test function
+void AllocProfiler_BeginRun(TM_ID technologyID, const TM_STR functionKeyword)
+{
+	if ( 0==g_allocProfiler.state.epoch || TLS_OUT_OF_INDEXES==g_allocProfiler.tls )
+	{
+		return;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	char technology[16];
+	sprintf_s(technology, sizeof(technology), "%d|", technologyID);
+	string key = string(technology) + functionKeyword;
+
+	EnterCriticalSection(&g_allocProfiler.lock);
+	map<string, int>::iterator keyword_Iter = g_allocProfiler.keywordIndex.find(key);
+	if (keyword_Iter==g_allocProfiler.keywordIndex.end())
+	{
+		keyword_Iter = g_allocProfiler.keywordIndex.insert(make_pair(key, (int)g_allocProfiler.keywords.size())).first;
+		g_allocProfiler.keywords.push_back(make_pair((int)technologyID, string(functionKeyword)));
+	}
+	else
+	{
+		// do nothing
+	}
+	int keyword = keyword_Iter->second;
+	LeaveCriticalSection(&g_allocProfiler.lock);
+
+	AllocProfilerMark(keyword, 1);
+}
+
+// Called by TM_Run() after the test function
+void AllocProfiler_EndRun(void)
+{
+	if ( 0==g_allocProfiler.state.epoch || TLS_OUT_OF_INDEXES==g_allocProfiler.tls )
+	{
+		return;
+	}
+	else
+	{
+		AllocProfilerMark(-1, 0);
+	}
+}
+
+// The hooks may still be called while the process exits, so the logs and the TLS index are left to the system
+void AllocProfiler_Abandon(void)
+{
+	InterlockedExchange(&g_allocProfiler.state.epoch, 0);
+	DeleteCriticalSection(&g_allocProfiler.lock);
+}
+
+// TM_AllocProfilerAttach() and TM_AllocProfilerRecord() are exported for the hooks only, see AllocProfiler.h
+TM_API ALLOC_PROFILER_STATE* __stdcall TM_AllocProfilerAttach(void)
+{
+	return &g_allocProfiler.state;
+}
+
+TM_API void __stdcall TM_AllocProfilerRecord(long epoch, unsigned int allocs, unsigned int bytes, unsigned int sampleSize, void **frames, int frameCount)
+{
+	if (TLS_OUT_OF_INDEXES==g_allocProfiler.tls)
+	{
+		return;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	TM_ALLOC_THREAD *thread = AllocProfilerThread();
+	TM_ALLOC_RECORD *record = ( NULL==thread ? NULL : AllocProfilerAppend(thread) );
+	if (NULL==record)
+	{
+		return;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	record->epoch      = epoch;
+	record->keyword    = AllocProfilerKeywordAt(thread, epoch);
+	record->allocs     = allocs;
+	record->bytes      = bytes;
+	record->sampleSize = sampleSize;
+	record->frameCount = min(max(frameCount, 0), ALLOC_PROFILER_MAX_FRAMES);
+	if ( NULL!=frames && 0<record->frameCount )
+	{
+		memcpy(record->frames, frames, record->frameCount*sizeof(void*));
+	}
+	else
+	{
+		record->frameCount = 0;
+	}
+	AllocProfilerPublish(thread);
+}
+
+TM_API TM_RETURN __stdcall TM_AllocProfilerStart(int sampleIntervalBytes)
+{
+	if (TLS_OUT_OF_INDEXES==g_allocProfiler.tls)
+	{
+		return TM_ERR_FUNCTION_NOT_SUPPORTED;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	InterlockedExchange(&g_allocProfiler.state.sampleInterval, (0<sampleIntervalBytes) ? sampleIntervalBytes : ALLOC_PROFILER_DEFAULT_INTERVAL);
+	long epoch = InterlockedIncrement(&g_allocProfiler.epochCounter);
+	InterlockedExchange(&g_allocProfiler.startEpoch, epoch);
+	InterlockedExchange(&g_allocProfiler.state.epoch, epoch);
+
+	return TM_ERR_OK;
+}
+
+TM_API TM_RETURN __stdcall TM_AllocProfilerStop(void)
+{
+	InterlockedExchange(&g_allocProfiler.state.epoch, 0);
+
+	return TM_ERR_OK;
+}
+
+// module+offset, the offset being relative to the load address, as in the .map file of the module
+static string AllocProfilerFrameName(void *address)
+{
+	HMODULE module = NULL;
+	char path[MAX_PATH] = "";
+	char name[MAX_PATH+32];
+	if ( GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS|GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, (LPCSTR)address, &module) &&
+		 0<GetModuleFileNameA(module, path, MAX_PATH) )
+	{
+		const char *file = strrchr(path, '\\');
+		sprintf_s(name, sizeof(name), "%s+0x%x", (NULL==file) ? path : file+1, (unsigned int)((char*)address-(char*)module));
+	}
+	else
+	{
+		sprintf_s(name, sizeof(name), "0x%p", address);
+	}
+	return name;
+}
+
+static bool AllocProfilerSiteGreater(const pair<vector<void*>, TM_ALLOC_SITE> &a, const pair<vector<void*>, TM_ALLOC_SITE> &b)
+{
+	return a.second.bytes>b.second.bytes;
+}
+
+TM_API TM_RETURN __stdcall TM_AllocProfilerReport(const TM_STR fileName)
+{
+	FILE *fp = NULL;
+	if ( NULL==fileName || 0!=fopen_s(&fp, fileName, "w") || NULL==fp )
+	{
+		return TM_ERR_FAILED_TO_OPEN_FILE;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	long   startEpoch     = g_allocProfiler.startEpoch;
+	double sampleInterval = (double)g_allocProfiler.state.sampleInterval;
+
+	// Records published so far, of the logs of all threads; the logs keep growing meanwhile
+	map<int, TM_ALLOC_KEYWORD_STAT> stats;
+	for (TM_ALLOC_THREAD *thread=g_allocProfiler.threads; NULL!=thread; thread=thread->next)
+	{
+		for (TM_ALLOC_CHUNK *chunk=thread->first; NULL!=chunk; chunk=chunk->next)
+		{
+			long count = InterlockedCompareExchange(&chunk->count, 0, 0);
+			for (long i=0; i<count; i++)
+			{
+				const TM_ALLOC_RECORD &record = chunk->records[i];
+				if (record.epoch<startEpoch)
+				{
+					continue;
+				}
+				else
+				{
+					// do nothing
+				}
+
+				TM_ALLOC_KEYWORD_STAT &stat = stats[record.keyword];
+				stat.runs   += record.runs;
+				stat.allocs += record.allocs;
+				stat.bytes  += record.bytes;
+				if (0<record.sampleSize)
+				{
+					// A sample stands for one interval of bytes, or for itself if it is larger
+					vector<void*> site(record.frames, record.frames+min(record.frameCount, TM_ALLOC_REPORT_FRAMES));
+					TM_ALLOC_SITE &siteStat = stat.sites[site];
+					siteStat.samples++;
+					siteStat.bytes += max((double)record.sampleSize, sampleInterval);
+					stat.samples++;
+				}
+				else
+				{
+					// do nothing
+				}
+			}
+		}
+	}
+
+	EnterCriticalSection(&g_allocProfiler.lock);
+	vector< pair<int, string> > keywords = g_allocProfiler.keywords;
+	LeaveCriticalSection(&g_allocProfiler.lock);
+
+	fprintf(fp, "Technology,Keyword,Runs,Allocations,Bytes,Allocations per run,Bytes per run,Samples\n");
+	for (map<int, TM_ALLOC_KEYWORD_STAT>::iterator stat_Iter=stats.begin(); stat_Iter!=stats.end(); stat_Iter++)
+	{
+		const TM_ALLOC_KEYWORD_STAT &stat = stat_Iter->second;
+		int runs = (0<stat.runs) ? stat.runs : 1;
+		if ( 0<=stat_Iter->first && stat_Iter->first<(int)keywords.size() )
+		{
+			fprintf(fp, "%s,\"%s\",", g_resultSinkTechnologyNames[keywords[stat_Iter->first].first], keywords[stat_Iter->first].second.c_str());
+		}
+		else
+		{
+			fprintf(fp, ",\"(outside TM_Run)\",");
+		}
+		fprintf(fp, "%u,%.0f,%.0f,%.1f,%.0f,%u\n", stat.runs, stat.allocs, stat.bytes, stat.allocs/runs, stat.bytes/runs, stat.samples);
+	}
+
+	fprintf(fp, "\nTechnology,Keyword,Call site,Samples,Estimated bytes\n");
+	for (map<int, TM_ALLOC_KEYWORD_STAT>::iterator stat_Iter=stats.begin(); stat_Iter!=stats.end(); stat_Iter++)
+	{
+		vector< pair<vector<void*>, TM_ALLOC_SITE> > sites(stat_Iter->second.sites.begin(), stat_Iter->second.sites.end());
+		sort(sites.begin(), sites.end(), AllocProfilerSiteGreater);
+		for (size_t i=0; i<sites.size() && i<TM_ALLOC_REPORT_SITES; i++)
+		{
+			// Innermost frame first
+			string siteName;
+			for (size_t frame=0; frame<sites[i].first.size(); frame++)
+			{
+				siteName += (0==frame ? "" : " < ") + AllocProfilerFrameName(sites[i].first[frame]);
+			}
+			if ( 0<=stat_Iter->first && stat_Iter->first<(int)keywords.size() )
+			{
+				fprintf(fp, "%s,\"%s\",", g_resultSinkTechnologyNames[keywords[stat_Iter->first].first], keywords[stat_Iter->first].second.c_str());
+			}
+			else
+			{
+				fprintf(fp, ",\"(outside TM_Run)\",");
+			}
+			fprintf(fp, "\"%s\",%u,%.0f\n", siteName.c_str(), sites[i].second.samples, sites[i].second.bytes);
+		}
+	}
+	fclose(fp);
+
+	return TM_ERR_OK;
+}
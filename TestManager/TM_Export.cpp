@@ -0,0 +1,296 @@
+// TM_Export.cpp : TM_ExportReturns() and TM_ImportParameters(), see TM_EXPORT_HEADER in TestManager.h
+//
+// One call moves all returns of a technology to a caller buffer, instead of one TM_GetxxxReturnPair() call per
+// item.  The entries only hold offsets, so the buffer can be read in place by a host that maps structures.
+#include "stdafx.h"
+#include <string.h>
+#include <string>
+#include <vector>
+#include <map>
+#include "TestManager.h"
+#include "TM_RunAsync.h"
+
+using namespace std;
+
+// Containers of TestManager.cpp
+extern map <string, int>             g_intReturns[MAX_TECHNOLOGY_NUM];
+extern map <string, double>          g_doubleReturns[MAX_TECHNOLOGY_NUM];
+extern map <string, string>          g_stringReturns[MAX_TECHNOLOGY_NUM];
+extern map <string, vector<double> > g_arrayDoubleReturns[MAX_TECHNOLOGY_NUM];
+extern map <string, string>          g_itemUnits[MAX_TECHNOLOGY_NUM];
+extern map <string, string>          g_helpText[MAX_TECHNOLOGY_NUM];
+
+// Builds the layout in two passes: the first one only counts (data==NULL), the second one copies
+class ExportWriter
+{
+public:
+	ExportWriter(char *data) : m_data(data), m_size(0) {}
+
+	int Size(void) const { return m_size; }
+
+	int Reserve(int size, int align)
+	{
+		m_size = (m_size+align-1)/align*align;
+		int offset = m_size;
+		m_size += size;
+		return offset;
+	}
+
+	int PutBytes(const void *value, int size, int align)
+	{
+		int offset = Reserve(size, align);
+		if (NULL!=m_data)
+		{
+			memcpy(m_data+offset, value, size);
+		}
+		else
+		{
+			// do nothing
+		}
+		return offset;
+	}
+
+	int PutString(const string &value)
+	{
+		return PutBytes(value.c_str(), (int)value.size()+1, 1);
+	}
+
+private:
+	char	*m_data;
+	int		m_size;
+};
+
+static int ExportText(ExportWriter &writer, const map<string, string> &texts, const string &name)
+{
+	map<string, string>::const_iterator text_Iter = texts.find(name);
+	return (text_Iter!=texts.end()) ? writer.PutString(text_Iter->second) : 0;
+}
+
+// Returns the size of the layout
+static int ExportLayout(TM_ID technologyID, char *data)
+{
+	ExportWriter writer(data);
+
+	int entryCount = (int)( TM_CONTAINER(intReturns, technologyID).size() + TM_CONTAINER(doubleReturns, technologyID).size() +
+							TM_CONTAINER(stringReturns, technologyID).size() + TM_CONTAINER(arrayDoubleReturns, technologyID).size() );
+	writer.Reserve(sizeof(TM_EXPORT_HEADER), 8);
+	int entryOffset = writer.Reserve(entryCount*sizeof(TM_EXPORT_ENTRY), 8);
+
+	vector<TM_EXPORT_ENTRY> entries;
+	entries.reserve(entryCount);
+	const map<string, string> &units     = TM_CONTAINER(itemUnits, technologyID);
+	const map<string, string> &helpTexts = TM_CONTAINER(helpText, technologyID);
+	TM_EXPORT_ENTRY entry;
+
+	for (map<string, int>::iterator int_Iter=TM_CONTAINER(intReturns, technologyID).begin(); int_Iter!=TM_CONTAINER(intReturns, technologyID).end(); int_Iter++)
+	{
+		entry.type           = TM_EXPORT_INTEGER;
+		entry.nameOffset     = writer.PutString(int_Iter->first);
+		entry.unitOffset     = ExportText(writer, units, int_Iter->first);
+		entry.helpTextOffset = ExportText(writer, helpTexts, int_Iter->first);
+		entry.valueOffset    = writer.PutBytes(&int_Iter->second, sizeof(int), 8);
+		entry.valueCount     = 1;
+		entries.push_back(entry);
+	}
+	for (map<string, double>::iterator double_Iter=TM_CONTAINER(doubleReturns, technologyID).begin(); double_Iter!=TM_CONTAINER(doubleReturns, technologyID).end(); double_Iter++)
+	{
+		entry.type           = TM_EXPORT_DOUBLE;
+		entry.nameOffset     = writer.PutString(double_Iter->first);
+		entry.unitOffset     = ExportText(writer, units, double_Iter->first);
+		entry.helpTextOffset = ExportText(writer, helpTexts, double_Iter->first);
+		entry.valueOffset    = writer.PutBytes(&double_Iter->second, sizeof(double), 8);
+		entry.valueCount     = 1;
+		entries.push_back(entry);
+	}
+	for (map<string, string>::iterator string_Iter=TM_CONTAINER(stringReturns, technologyID).begin(); string_Iter!=TM_CONTAINER(stringReturns, technologyID).end(); string_Iter++)
+	{
+		entry.type           = TM_EXPORT_STRING;
+		entry.nameOffset     = writer.PutString(string_Iter->first);
+		entry.unitOffset     = ExportText(writer, units, string_Iter->first);
+		entry.helpTextOffset = ExportText(writer, helpTexts, string_Iter->first);
+		entry.valueOffset    = writer.PutString(string_Iter->second);
+		entry.valueCount     = 1;
+		entries.push_back(entry);
+	}
+	for (map<string, vector<double> >::iterator array_Iter=TM_CONTAINER(arrayDoubleReturns, technologyID).begin(); array_Iter!=TM_CONTAINER(arrayDoubleReturns, technologyID).end(); array_Iter++)
+	{
+		entry.type           = TM_EXPORT_ARRAY_DOUBLE;
+		entry.nameOffset     = writer.PutString(array_Iter->first);
+		entry.unitOffset     = ExportText(writer, units, array_Iter->first);
+		entry.helpTextOffset = ExportText(writer, helpTexts, array_Iter->first);
+		entry.valueCount     = (int)array_Iter->second.size();
+		entry.valueOffset    = (0<entry.valueCount) ? writer.PutBytes(&array_Iter->second[0], entry.valueCount*sizeof(double), 8) : writer.Reserve(0, 8);
+		entries.push_back(entry);
+	}
+
+	if (NULL!=data)
+	{
+		TM_EXPORT_HEADER header;
+		header.version    = TM_EXPORT_VERSION;
+		header.totalSize  = writer.Size();
+		header.entryCount = entryCount;
+		header.reserved   = 0;
+		memcpy(data, &header, sizeof(header));
+		if (0<entryCount)
+		{
+			memcpy(data+entryOffset, &entries[0], entryCount*sizeof(TM_EXPORT_ENTRY));
+		}
+		else
+		{
+			// do nothing
+		}
+	}
+	else
+	{
+		// do nothing
+	}
+
+	return writer.Size();
+}
+
+TM_API TM_RETURN __stdcall TM_ExportReturns(TM_ID technologyID, void *buffer, int bufferSize, int *requiredSize)
+{
+	if ( technologyID<0 || technologyID>=MAX_TECHNOLOGY_NUM )
+	{
+		return TM_ERR_INVALID_TECHNOLOGY_ID;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	int size = ExportLayout(technologyID, NULL);
+	if (NULL!=requiredSize)
+	{
+		*requiredSize = size;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	if ( NULL==buffer || bufferSize<size )
+	{
+		return TM_ERR_BUFFER_TOO_SMALL;
+	}
+	else
+	{
+		ExportLayout(technologyID, (char*)buffer);
+	}
+
+	return TM_ERR_OK;
+}
+
+// Pointer to a '\0' terminated string of the buffer, NULL if it is not within the buffer
+static const char* ImportString(const char *data, int bufferSize, int offset)
+{
+	if ( offset<(int)sizeof(TM_EXPORT_HEADER) || offset>=bufferSize || NULL==memchr(data+offset, '\0', bufferSize-offset) )
+	{
+		return NULL;
+	}
+	else
+	{
+		return data+offset;
+	}
+}
+
+TM_API TM_RETURN __stdcall TM_ImportParameters(TM_ID technologyID, const void *buffer, int bufferSize)
+{
+	if ( technologyID<0 || technologyID>=MAX_TECHNOLOGY_NUM )
+	{
+		return TM_ERR_INVALID_TECHNOLOGY_ID;
+	}
+	else if ( NULL==buffer || bufferSize<(int)sizeof(TM_EXPORT_HEADER) )
+	{
+		return TM_ERR_BUFFER_TOO_SMALL;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	const char *data = (const char*)buffer;
+	TM_EXPORT_HEADER header;
+	memcpy(&header, data, sizeof(header));
+	if ( TM_EXPORT_VERSION!=header.version || header.totalSize>bufferSize || header.entryCount<0 ||
+		 header.entryCount>(bufferSize-(int)sizeof(TM_EXPORT_HEADER))/(int)sizeof(TM_EXPORT_ENTRY) )
+	{
+		return TM_ERR_BUFFER_TOO_SMALL;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	// All entries are checked before any parameter is added
+	vector<TM_EXPORT_ENTRY> entries(header.entryCount);
+	if (0<header.entryCount)
+	{
+		memcpy(&entries[0], data+sizeof(TM_EXPORT_HEADER), header.entryCount*sizeof(TM_EXPORT_ENTRY));
+	}
+	else
+	{
+		// do nothing
+	}
+	for (int i=0;i<header.entryCount;i++)
+	{
+		int valueSize = (TM_EXPORT_INTEGER==entries[i].type) ? sizeof(int) : sizeof(double);
+		if ( NULL==ImportString(data, header.totalSize, entries[i].nameOffset) )
+		{
+			return TM_ERR_BUFFER_TOO_SMALL;
+		}
+		else if ( TM_EXPORT_STRING==entries[i].type )
+		{
+			if ( NULL==ImportString(data, header.totalSize, entries[i].valueOffset) )
+			{
+				return TM_ERR_BUFFER_TOO_SMALL;
+			}
+			else
+			{
+				// do nothing
+			}
+		}
+		else if ( TM_EXPORT_INTEGER==entries[i].type || TM_EXPORT_DOUBLE==entries[i].type )
+		{
+			if ( entries[i].valueOffset<(int)sizeof(TM_EXPORT_HEADER) || entries[i].valueOffset>header.totalSize-valueSize )
+			{
+				return TM_ERR_BUFFER_TOO_SMALL;
+			}
+			else
+			{
+				// do nothing
+			}
+		}
+		else
+		{
+			// Arrays are returns only
+		}
+	}
+
+	for (int i=0;i<header.entryCount;i++)
+	{
+		TM_STR name = (TM_STR)(data+entries[i].nameOffset);
+		if (TM_EXPORT_INTEGER==entries[i].type)
+		{
+			int value;
+			memcpy(&value, data+entries[i].valueOffset, sizeof(value));
+			::TM_AddIntegerParameter(technologyID, name, value);
+		}
+		else if (TM_EXPORT_DOUBLE==entries[i].type)
+		{
+			double value;
+			memcpy(&value, data+entries[i].valueOffset, sizeof(value));
+			::TM_AddDoubleParameter(technologyID, name, value);
+		}
+		else if (TM_EXPORT_STRING==entries[i].type)
+		{
+			::TM_AddStringParameter(technologyID, name, (TM_STR)(data+entries[i].valueOffset));
+		}
+		else
+		{
+			// do nothing
+		}
+	}
+
+	return TM_ERR_OK;
+}
@@ -0,0 +1,217 @@
+// TM_LookAhead.cpp : Look-ahead DUT preparation of the next test item
+//
+// The station declares the next item with TM_SetLookAhead() before it runs the current one.  Once the
+// current test function has completed its last capture, it calls TM_StartLookAhead(): the look-ahead
+// function of the technology then runs on a TestManager thread with the parameters of the next item, and
+// configures the DUT while the current function analyzes.  TM_Run() waits for it before the next test
+// function of the technology starts, so the test functions never share the DUT control with it.
+#include "stdafx.h"
+#include <string>
+#include <vector>
+#include <map>
+#include "TestManager.h"
+#include "TM_RunAsync.h"
+
+using namespace std;
+
+// Containers of TestManager.cpp
+extern map <string, int>             g_intParams[MAX_TECHNOLOGY_NUM];
+extern map <string, double>          g_doubleParams[MAX_TECHNOLOGY_NUM];
+extern map <string, string>          g_stringParams[MAX_TECHNOLOGY_NUM];
+
+typedef struct tagLookAhead
+{
+	int					(*pointerToFunction)(void);
+	TM_RUN_CONTEXT		*next;			// parameters of the next item, NULL if not set
+	TM_RUN_CONTEXT		*running;		// parameters of the running look-ahead function
+	HANDLE				thread;
+} TM_LOOK_AHEAD;
+
+TM_LOOK_AHEAD g_lookAhead[MAX_TECHNOLOGY_NUM];
+// TM_Run() of a technology may run on a TM_RunAsync() worker while the station calls TM_SetLookAhead()
+CRITICAL_SECTION g_lookAheadLock;
+
+static DWORD WINAPI LookAheadThread(LPVOID param)
+{
+	TM_RUN_CONTEXT *context = (TM_RUN_CONTEXT*)param;
+
+	RunAsync_SetContext(context);
+	int ret = g_lookAhead[context->technologyID].pointerToFunction();
+	RunAsync_SetContext(NULL);
+
+	return (DWORD)ret;
+}
+
+static void LookAheadRelease(TM_RUN_CONTEXT **context)
+{
+	if (NULL!=*context)
+	{
+		delete *context;
+		*context = NULL;
+	}
+	else
+	{
+		// do nothing
+	}
+}
+
+// Called by TM_Run() before the test function, returns the look-ahead function result
+static int LookAheadJoin(TM_ID technologyID)
+{
+	DWORD ret = 0;
+
+	// The thread is taken under the lock and waited for outside of it
+	EnterCriticalSection(&g_lookAheadLock);
+	HANDLE thread = g_lookAhead[technologyID].thread;
+	TM_RUN_CONTEXT *running = g_lookAhead[technologyID].running;
+	g_lookAhead[technologyID].thread  = NULL;
+	g_lookAhead[technologyID].running = NULL;
+	LeaveCriticalSection(&g_lookAheadLock);
+
+	if (NULL!=thread)
+	{
+		WaitForSingleObject(thread, INFINITE);
+		GetExitCodeThread(thread, &ret);
+		CloseHandle(thread);
+		LookAheadRelease(&running);
+	}
+	else
+	{
+		// do nothing
+	}
+
+	return (int)ret;
+}
+
+void LookAhead_Initialize(void)
+{
+	InitializeCriticalSection(&g_lookAheadLock);
+}
+
+void LookAhead_Abandon(void)
+{
+	DeleteCriticalSection(&g_lookAheadLock);
+}
+
+void LookAhead_Wait(TM_ID technologyID)
+{
+	LookAheadJoin(technologyID);
+}
+
+TM_API TM_RETURN __stdcall TM_InstallLookAheadFunction(TM_ID technologyID, int (*pointerToFunction)(void))
+{
+	if ( technologyID<0 || technologyID>=MAX_TECHNOLOGY_NUM )
+	{
+		return TM_ERR_INVALID_TECHNOLOGY_ID;
+	}
+	else
+	{
+		LookAheadJoin(technologyID);
+		EnterCriticalSection(&g_lookAheadLock);
+		g_lookAhead[technologyID].pointerToFunction = pointerToFunction;
+		LeaveCriticalSection(&g_lookAheadLock);
+	}
+
+	return TM_ERR_OK;
+}
+
+TM_API TM_RETURN __stdcall TM_SetLookAhead(TM_ID technologyID, const TM_STR functionKeyword)
+{
+	if ( technologyID<0 || technologyID>=MAX_TECHNOLOGY_NUM )
+	{
+		return TM_ERR_INVALID_TECHNOLOGY_ID;
+	}
+	else if ( NULL==functionKeyword || '\0'==functionKeyword[0] )
+	{
+		// No next item
+		EnterCriticalSection(&g_lookAheadLock);
+		LookAheadRelease(&g_lookAhead[technologyID].next);
+		LeaveCriticalSection(&g_lookAheadLock);
+		return TM_ERR_OK;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	TM_RUN_CONTEXT *context = new TM_RUN_CONTEXT;
+	context->handle          = 0;
+	context->technologyID    = technologyID;
+	context->functionKeyword = functionKeyword;
+	context->intParams       = g_intParams[technologyID];
+	context->doubleParams    = g_doubleParams[technologyID];
+	context->stringParams    = g_stringParams[technologyID];
+	context->stringParams["LOOK_AHEAD_KEYWORD"] = functionKeyword;
+	context->tmReturn        = TM_ERR_OK;
+	context->callback        = NULL;
+	context->userData        = NULL;
+	context->doneEvent       = NULL;
+	context->done            = 0;
+
+	EnterCriticalSection(&g_lookAheadLock);
+	LookAheadRelease(&g_lookAhead[technologyID].next);
+	g_lookAhead[technologyID].next = context;
+	LeaveCriticalSection(&g_lookAheadLock);
+
+	return TM_ERR_OK;
+}
+
+TM_API TM_RETURN __stdcall TM_StartLookAhead(TM_ID technologyID)
+{
+	if ( technologyID<0 || technologyID>=MAX_TECHNOLOGY_NUM )
+	{
+		return TM_ERR_INVALID_TECHNOLOGY_ID;
+	}
+	else
+	{
+		LookAheadJoin(technologyID);
+	}
+
+	// The next item is prepared once; a retry of the current item does not prepare it again
+	EnterCriticalSection(&g_lookAheadLock);
+	TM_RUN_CONTEXT *context = g_lookAhead[technologyID].next;
+	TM_RETURN ret = TM_ERR_OK;
+	if ( NULL==g_lookAhead[technologyID].pointerToFunction || NULL==context )
+	{
+		ret = TM_ERR_NO_VALUE_DEFINED;
+	}
+	else
+	{
+		g_lookAhead[technologyID].next   = NULL;
+		g_lookAhead[technologyID].thread = CreateThread(NULL, 0, LookAheadThread, context, 0, NULL);
+		if (NULL==g_lookAhead[technologyID].thread)
+		{
+			delete context;
+			ret = TM_ERR_FUNCTION_ERROR;
+		}
+		else
+		{
+			g_lookAhead[technologyID].running = context;
+		}
+	}
+	LeaveCriticalSection(&g_lookAheadLock);
+
+	return ret;
+}
+
+TM_API TM_RETURN __stdcall TM_WaitLookAhead(TM_ID technologyID, int *functionReturn)
+{
+	if ( technologyID<0 || technologyID>=MAX_TECHNOLOGY_NUM )
+	{
+		return TM_ERR_INVALID_TECHNOLOGY_ID;
+	}
+	else
+	{
+		int ret = LookAheadJoin(technologyID);
+		if (NULL!=functionReturn)
+		{
+			*functionReturn = ret;
+		}
+		else
+		{
+			// do nothing
+		}
+	}
+
+	return TM_ERR_OK;
+}
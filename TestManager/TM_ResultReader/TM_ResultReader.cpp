@@ -0,0 +1,252 @@
+// TM_ResultReader.cpp : Converts the TestManager result file (TM_ResultSinkOpen) to CSV
+//
+// Usage: TM_ResultReader <result file> [-keyword KEYWORD] [-serial SERIAL]
+//
+// One CSV line per return value, with the inputs of the run joined in one column:
+//   Time_UTC,Station,Technology,Keyword,Status,DUT_Serial,Duration_ms,Inputs,Name,Unit,Value
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include "../TM_ResultSink.h"
+
+using namespace std;
+
+class RecordBuffer
+{
+public:
+	RecordBuffer(const char *data, size_t size) : m_data(data), m_size(size), m_pos(0), m_error(false) {}
+
+	bool Error(void) const { return m_error; }
+
+	void Get(void *value, size_t size)
+	{
+		if (m_pos+size>m_size)
+		{
+			m_error = true;
+			memset(value, 0, size);
+			return;
+		}
+		memcpy(value, m_data+m_pos, size);
+		m_pos += size;
+	}
+	int GetInt(void)                   { int value; Get(&value, sizeof(value)); return value; }
+	double GetDouble(void)             { double value; Get(&value, sizeof(value)); return value; }
+	unsigned char GetByte(void)        { unsigned char value; Get(&value, sizeof(value)); return value; }
+	unsigned short GetShort(void)      { unsigned short value; Get(&value, sizeof(value)); return value; }
+	string GetString(void)
+	{
+		unsigned short length = GetShort();
+		if (m_error || m_pos+length>m_size)
+		{
+			m_error = true;
+			return "";
+		}
+		string value(m_data+m_pos, length);
+		m_pos += length;
+		return value;
+	}
+
+private:
+	const char	*m_data;
+	size_t		m_size;
+	size_t		m_pos;
+	bool		m_error;
+};
+
+// CSV field, quoted when needed
+static string CsvField(const string &value)
+{
+	if (string::npos==value.find_first_of(",\"\r\n"))
+	{
+		return value;
+	}
+	string quoted = "\"";
+	for (size_t i=0;i<value.size();i++)
+	{
+		if ('"'==value[i]) quoted += '"';
+		quoted += value[i];
+	}
+	return quoted + "\"";
+}
+
+static string FileTimeToString(unsigned long long fileTime)
+{
+	// FILETIME counts 100 ns from 1601-01-01
+	long long unixMs  = (long long)(fileTime/10000) - 11644473600000LL;
+	time_t    seconds = (time_t)(unixMs/1000);
+	struct tm utc;
+#ifdef WIN32
+	gmtime_s(&utc, &seconds);
+#else
+	gmtime_r(&seconds, &utc);
+#endif
+	char buffer[64];
+	sprintf(buffer, "%04d-%02d-%02d %02d:%02d:%02d.%03d", utc.tm_year+1900, utc.tm_mon+1, utc.tm_mday,
+		utc.tm_hour, utc.tm_min, utc.tm_sec, (int)(unixMs%1000));
+	return buffer;
+}
+
+static string DoubleToString(double value)
+{
+	char buffer[64];
+	sprintf(buffer, "%.6g", value);
+	return buffer;
+}
+
+int main(int argc, char* argv[])
+{
+	const char *fileName = NULL;
+	const char *keywordFilter = NULL;
+	const char *serialFilter = NULL;
+
+	for (int i=1;i<argc;i++)
+	{
+		if (0==strcmp(argv[i], "-keyword") && i+1<argc)		keywordFilter = argv[++i];
+		else if (0==strcmp(argv[i], "-serial") && i+1<argc)	serialFilter = argv[++i];
+		else												fileName = argv[i];
+	}
+	if (NULL==fileName)
+	{
+		printf("Usage: TM_ResultReader <result file> [-keyword KEYWORD] [-serial SERIAL]\n");
+		return 1;
+	}
+
+	FILE *fp = fopen(fileName, "rb");
+	if (NULL==fp)
+	{
+		fprintf(stderr, "[Error] Fail to open %s\n", fileName);
+		return 1;
+	}
+
+	// File header
+	char magic[8];
+	unsigned int version = 0;
+	if ( 8!=fread(magic, 1, 8, fp) || 0!=memcmp(magic, TM_RESULT_SINK_MAGIC, 8) || 1!=fread(&version, sizeof(version), 1, fp) )
+	{
+		fprintf(stderr, "[Error] %s is not a TestManager result file\n", fileName);
+		fclose(fp);
+		return 1;
+	}
+
+	unsigned short length = 0;
+	string station;
+	vector<string> technologies;
+	if (1==fread(&length, sizeof(length), 1, fp))
+	{
+		station.resize(length);
+		if (0<length && length!=fread(&station[0], 1, length, fp)) station = "";
+	}
+	unsigned short technologyNum = 0;
+	if (1==fread(&technologyNum, sizeof(technologyNum), 1, fp))
+	{
+		for (int i=0;i<technologyNum;i++)
+		{
+			string name;
+			if (1!=fread(&length, sizeof(length), 1, fp)) break;
+			name.resize(length);
+			if (0<length && length!=fread(&name[0], 1, length, fp)) break;
+			technologies.push_back(name);
+		}
+	}
+
+	printf("Time_UTC,Station,Technology,Keyword,Status,DUT_Serial,Duration_ms,Inputs,Name,Unit,Value\n");
+
+	int records = 0;
+	unsigned int recordSize = 0;
+	vector<char> data;
+	while (1==fread(&recordSize, sizeof(recordSize), 1, fp))
+	{
+		data.resize(recordSize);
+		if (0<recordSize && recordSize!=fread(&data[0], 1, recordSize, fp))
+		{
+			fprintf(stderr, "[Warning] Record %d is truncated, the station may still be writing\n", records+1);
+			break;
+		}
+		records++;
+
+		RecordBuffer record(data.empty() ? NULL : &data[0], data.size());
+		unsigned long long startTime;
+		record.Get(&startTime, sizeof(startTime));
+		double durationMs   = record.GetDouble();
+		int    technologyID = record.GetInt();
+		string keyword      = record.GetString();
+		int    tmReturn     = record.GetInt();
+		string serial       = record.GetString();
+		int    itemCount    = record.GetShort();
+
+		if ( (NULL!=keywordFilter && keyword!=keywordFilter) || (NULL!=serialFilter && serial!=serialFilter) )
+		{
+			continue;
+		}
+
+		string technology = (0<=technologyID && technologyID<(int)technologies.size()) ? technologies[technologyID] : DoubleToString(technologyID);
+		string prefix = CsvField(FileTimeToString(startTime)) + "," + CsvField(station) + "," + CsvField(technology) + "," +
+						CsvField(keyword) + "," + (0==tmReturn ? "PASS" : "FAIL(" + DoubleToString(tmReturn) + ")") + "," +
+						CsvField(serial) + "," + DoubleToString(durationMs) + ",";
+
+		string inputs;
+		vector<string> returns;
+		for (int i=0;i<itemCount && !record.Error();i++)
+		{
+			unsigned char type = record.GetByte();
+			string name  = record.GetString();
+			string unit  = record.GetString();
+			string value;
+
+			switch (type)
+			{
+			case TM_ITEM_INT_PARAM:
+			case TM_ITEM_INT_RETURN:
+				value = DoubleToString(record.GetInt());
+				break;
+			case TM_ITEM_DOUBLE_PARAM:
+			case TM_ITEM_DOUBLE_RETURN:
+				value = DoubleToString(record.GetDouble());
+				break;
+			case TM_ITEM_STRING_PARAM:
+			case TM_ITEM_STRING_RETURN:
+				value = record.GetString();
+				break;
+			case TM_ITEM_ARRAY_DOUBLE_RETURN:
+				{
+					int size = record.GetInt();
+					for (int j=0;j<size && !record.Error();j++)
+					{
+						value += (0==j ? "" : ";") + DoubleToString(record.GetDouble());
+					}
+				}
+				break;
+			default:
+				// Unknown item type of a newer version, the rest of the record cannot be parsed
+				i = itemCount;
+				continue;
+			}
+
+			if (type<TM_ITEM_INT_RETURN)
+			{
+				inputs += (inputs.empty() ? "" : " ") + name + "=" + value;
+			}
+			else
+			{
+				returns.push_back(CsvField(name) + "," + CsvField(unit) + "," + CsvField(value));
+			}
+		}
+
+		if (returns.empty())
+		{
+			printf("%s%s,,,\n", prefix.c_str(), CsvField(inputs).c_str());
+		}
+		for (size_t i=0;i<returns.size();i++)
+		{
+			printf("%s%s,%s\n", prefix.c_str(), CsvField(inputs).c_str(), returns[i].c_str());
+		}
+	}
+
+	fclose(fp);
+	fprintf(stderr, "[Info] %d records of station \"%s\", file version %u\n", records, station.c_str(), version);
+
+	return 0;
+}
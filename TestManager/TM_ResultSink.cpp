@@ -0,0 +1,328 @@
+// TM_ResultSink.cpp : Structured result file of TM_Run(), see TM_ResultSink.h for the layout
+//
+// The record is serialized on the caller's thread (a copy of the parameter and return containers),
+// and appended to the file by a writer thread, so TM_Run() never waits for the disk.
+#include "stdafx.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include "TestManager.h"
+#include "TM_ResultSink.h"
+#include "TM_RunAsync.h"
+
+using namespace std;
+
+// Containers of TestManager.cpp
+extern map <string, int>             g_intParams[MAX_TECHNOLOGY_NUM];
+extern map <string, double>          g_doubleParams[MAX_TECHNOLOGY_NUM];
+extern map <string, string>          g_stringParams[MAX_TECHNOLOGY_NUM];
+extern map <string, int>             g_intReturns[MAX_TECHNOLOGY_NUM];
+extern map <string, double>          g_doubleReturns[MAX_TECHNOLOGY_NUM];
+extern map <string, string>          g_stringReturns[MAX_TECHNOLOGY_NUM];
+extern map <string, vector<double> > g_arrayDoubleReturns[MAX_TECHNOLOGY_NUM];
+extern map <string, string>          g_itemUnits[MAX_TECHNOLOGY_NUM];
+
+// Same order as enum tagTechnology
+const char *g_resultSinkTechnologyNames[MAX_TECHNOLOGY_NUM] =
+{
+	"WIFI", "WIFI_MIMO", "WIFI_11AC", "WIFI_11AC_MIMO", "WIFI_MPS", "BT", "WIMAX", "GPS", "FM", "IQREPORT"
+};
+
+typedef struct tagResultSink
+{
+	bool				opened;
+	bool				stopRequest;
+	FILE				*fp;
+	HANDLE				thread;
+	HANDLE				recordEvent;
+	CRITICAL_SECTION	lock;				// created with TestManager; guards opened, stopRequest and records
+	deque<string>		records;
+} TM_RESULT_SINK;
+
+TM_RESULT_SINK g_resultSink;
+
+static void SinkPutBytes(string &buffer, const void *data, size_t size)
+{
+	buffer.append((const char*)data, size);
+}
+
+static void SinkPutInt(string &buffer, int value)
+{
+	SinkPutBytes(buffer, &value, sizeof(int));
+}
+
+static void SinkPutDouble(string &buffer, double value)
+{
+	SinkPutBytes(buffer, &value, sizeof(double));
+}
+
+static void SinkPutString(string &buffer, const string &value)
+{
+	unsigned short length = (unsigned short)min(value.size(), (size_t)0xFFFF);
+	SinkPutBytes(buffer, &length, sizeof(length));
+	SinkPutBytes(buffer, value.data(), length);
+}
+
+static string SinkUnit(TM_ID technologyID, const string &name)
+{
+	map <string, string>::iterator unit_Iter = TM_CONTAINER(itemUnits, technologyID).find(name);
+	return (unit_Iter!=TM_CONTAINER(itemUnits, technologyID).end()) ? unit_Iter->second : string("");
+}
+
+static DWORD WINAPI ResultSinkWriter(LPVOID)
+{
+	deque<string> pending;
+
+	while (true)
+	{
+		EnterCriticalSection(&g_resultSink.lock);
+		pending.swap(g_resultSink.records);
+		bool stop = g_resultSink.stopRequest;
+		LeaveCriticalSection(&g_resultSink.lock);
+
+		if (!pending.empty())
+		{
+			for (deque<string>::iterator record_Iter=pending.begin(); record_Iter!=pending.end(); record_Iter++)
+			{
+				fwrite(record_Iter->data(), 1, record_Iter->size(), g_resultSink.fp);
+			}
+			fflush(g_resultSink.fp);
+			pending.clear();
+		}
+		else if (stop)
+		{
+			break;
+		}
+		else
+		{
+			WaitForSingleObject(g_resultSink.recordEvent, INFINITE);
+		}
+	}
+
+	return 0;
+}
+
+void ResultSink_Initialize(void)
+{
+	InitializeCriticalSection(&g_resultSink.lock);
+}
+
+// Called by TM_Run() after the test function returned
+void ResultSink_Record(TM_ID technologyID, const TM_STR functionKeyword, TM_RETURN tmReturn, double durationInMiniSec, const string &dutSerialNumber)
+{
+	EnterCriticalSection(&g_resultSink.lock);
+	bool opened = g_resultSink.opened;
+	LeaveCriticalSection(&g_resultSink.lock);
+
+	if (!opened || technologyID<0 || technologyID>=MAX_TECHNOLOGY_NUM || IQREPORT==technologyID)
+	{
+		return;
+	}
+
+	// QUERY_INPUT and QUERY_RETURN only list the items, they are not test results
+	if ( TM_CONTAINER(intParams, technologyID).end()!=TM_CONTAINER(intParams, technologyID).find("QUERY_INPUT") ||
+		 TM_CONTAINER(intParams, technologyID).end()!=TM_CONTAINER(intParams, technologyID).find("QUERY_RETURN") )
+	{
+		return;
+	}
+
+	string	body;
+	int		itemCount = 0;
+	string	items;
+
+	for (map <string, int>::iterator int_Iter=TM_CONTAINER(intParams, technologyID).begin(); int_Iter!=TM_CONTAINER(intParams, technologyID).end(); int_Iter++, itemCount++)
+	{
+		items += (char)TM_ITEM_INT_PARAM;
+		SinkPutString(items, int_Iter->first);
+		SinkPutString(items, "");
+		SinkPutInt(items, int_Iter->second);
+	}
+	for (map <string, double>::iterator double_Iter=TM_CONTAINER(doubleParams, technologyID).begin(); double_Iter!=TM_CONTAINER(doubleParams, technologyID).end(); double_Iter++, itemCount++)
+	{
+		items += (char)TM_ITEM_DOUBLE_PARAM;
+		SinkPutString(items, double_Iter->first);
+		SinkPutString(items, "");
+		SinkPutDouble(items, double_Iter->second);
+	}
+	for (map <string, string>::iterator string_Iter=TM_CONTAINER(stringParams, technologyID).begin(); string_Iter!=TM_CONTAINER(stringParams, technologyID).end(); string_Iter++, itemCount++)
+	{
+		items += (char)TM_ITEM_STRING_PARAM;
+		SinkPutString(items, string_Iter->first);
+		SinkPutString(items, "");
+		SinkPutString(items, string_Iter->second);
+	}
+	for (map <string, int>::iterator int_Iter=TM_CONTAINER(intReturns, technologyID).begin(); int_Iter!=TM_CONTAINER(intReturns, technologyID).end(); int_Iter++, itemCount++)
+	{
+		items += (char)TM_ITEM_INT_RETURN;
+		SinkPutString(items, int_Iter->first);
+		SinkPutString(items, SinkUnit(technologyID, int_Iter->first));
+		SinkPutInt(items, int_Iter->second);
+	}
+	for (map <string, double>::iterator double_Iter=TM_CONTAINER(doubleReturns, technologyID).begin(); double_Iter!=TM_CONTAINER(doubleReturns, technologyID).end(); double_Iter++, itemCount++)
+	{
+		items += (char)TM_ITEM_DOUBLE_RETURN;
+		SinkPutString(items, double_Iter->first);
+		SinkPutString(items, SinkUnit(technologyID, double_Iter->first));
+		SinkPutDouble(items, double_Iter->second);
+	}
+	for (map <string, string>::iterator string_Iter=TM_CONTAINER(stringReturns, technologyID).begin(); string_Iter!=TM_CONTAINER(stringReturns, technologyID).end(); string_Iter++, itemCount++)
+	{
+		items += (char)TM_ITEM_STRING_RETURN;
+		SinkPutString(items, string_Iter->first);
+		SinkPutString(items, SinkUnit(technologyID, string_Iter->first));
+		SinkPutString(items, string_Iter->second);
+	}
+	for (map <string, vector<double> >::iterator array_Iter=TM_CONTAINER(arrayDoubleReturns, technologyID).begin(); array_Iter!=TM_CONTAINER(arrayDoubleReturns, technologyID).end(); array_Iter++, itemCount++)
+	{
+		items += (char)TM_ITEM_ARRAY_DOUBLE_RETURN;
+		SinkPutString(items, array_Iter->first);
+		SinkPutString(items, SinkUnit(technologyID, array_Iter->first));
+		SinkPutInt(items, (int)array_Iter->second.size());
+		if (!array_Iter->second.empty())
+		{
+			SinkPutBytes(items, &array_Iter->second[0], array_Iter->second.size()*sizeof(double));
+		}
+	}
+
+	// Start time = now - duration
+	FILETIME fileTime;
+	GetSystemTimeAsFileTime(&fileTime);
+	unsigned __int64 startTime = (((unsigned __int64)fileTime.dwHighDateTime)<<32) + fileTime.dwLowDateTime;
+	startTime -= (unsigned __int64)(durationInMiniSec*10000.0);
+
+	SinkPutBytes(body, &startTime, sizeof(startTime));
+	SinkPutDouble(body, durationInMiniSec);
+	SinkPutInt(body, technologyID);
+	SinkPutString(body, functionKeyword);
+	SinkPutInt(body, (int)tmReturn);
+	SinkPutString(body, dutSerialNumber);
+	unsigned short count = (unsigned short)itemCount;
+	SinkPutBytes(body, &count, sizeof(count));
+	body += items;
+
+	string record;
+	unsigned int recordSize = (unsigned int)body.size();
+	record.reserve(sizeof(recordSize)+body.size());
+	SinkPutBytes(record, &recordSize, sizeof(recordSize));
+	record += body;
+
+	// The file may have been closed while the record was serialized
+	EnterCriticalSection(&g_resultSink.lock);
+	if (g_resultSink.opened)
+	{
+		g_resultSink.records.push_back(record);
+		SetEvent(g_resultSink.recordEvent);
+	}
+	else
+	{
+		// do nothing
+	}
+	LeaveCriticalSection(&g_resultSink.lock);
+}
+
+TM_API TM_RETURN __stdcall TM_ResultSinkOpen(const TM_STR fileName, const TM_STR stationName)
+{
+	EnterCriticalSection(&g_resultSink.lock);
+	bool opened = g_resultSink.opened;
+	LeaveCriticalSection(&g_resultSink.lock);
+
+	if (opened)
+	{
+		return TM_ERR_OK;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	// Append-only: an existing file of the station keeps growing, the header is only written once
+	bool newFile = (INVALID_FILE_ATTRIBUTES==GetFileAttributesA(fileName));
+	if ( 0!=fopen_s(&g_resultSink.fp, fileName, "ab") || NULL==g_resultSink.fp )
+	{
+		return TM_ERR_FAILED_TO_OPEN_FILE;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	if (newFile)
+	{
+		string header;
+		SinkPutBytes(header, TM_RESULT_SINK_MAGIC, 8);
+		SinkPutInt(header, TM_RESULT_SINK_VERSION);
+		SinkPutString(header, (NULL!=stationName) ? stationName : "");
+		unsigned short technologyNum = MAX_TECHNOLOGY_NUM;
+		SinkPutBytes(header, &technologyNum, sizeof(technologyNum));
+		for (int i=0;i<MAX_TECHNOLOGY_NUM;i++)
+		{
+			SinkPutString(header, g_resultSinkTechnologyNames[i]);
+		}
+		fwrite(header.data(), 1, header.size(), g_resultSink.fp);
+		fflush(g_resultSink.fp);
+	}
+	else
+	{
+		// do nothing
+	}
+
+	g_resultSink.stopRequest = false;
+	g_resultSink.recordEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+	g_resultSink.thread      = CreateThread(NULL, 0, ResultSinkWriter, NULL, 0, NULL);
+	if (NULL==g_resultSink.thread)
+	{
+		CloseHandle(g_resultSink.recordEvent);
+		fclose(g_resultSink.fp);
+		g_resultSink.fp = NULL;
+		return TM_ERR_FAILED_TO_OPEN_FILE;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	EnterCriticalSection(&g_resultSink.lock);
+	g_resultSink.opened = true;
+	LeaveCriticalSection(&g_resultSink.lock);
+
+	return TM_ERR_OK;
+}
+
+TM_API TM_RETURN __stdcall TM_ResultSinkClose(void)
+{
+	// The writer empties the queue before it exits
+	EnterCriticalSection(&g_resultSink.lock);
+	bool opened = g_resultSink.opened;
+	g_resultSink.opened      = false;
+	g_resultSink.stopRequest = true;
+	LeaveCriticalSection(&g_resultSink.lock);
+
+	if (!opened)
+	{
+		return TM_ERR_OK;
+	}
+	else
+	{
+		SetEvent(g_resultSink.recordEvent);
+	}
+
+	WaitForSingleObject(g_resultSink.thread, INFINITE);
+	CloseHandle(g_resultSink.thread);
+	CloseHandle(g_resultSink.recordEvent);
+
+	fclose(g_resultSink.fp);
+	g_resultSink.fp = NULL;
+
+	return TM_ERR_OK;
+}
+
+// Called at DLL_PROCESS_DETACH, under the loader lock: neither the writer thread nor the file is touched.
+// The records still queued if TM_ResultSinkClose() was not called are lost.
+void ResultSink_Abandon(void)
+{
+	g_resultSink.opened = false;
+	g_resultSink.records.clear();
+	DeleteCriticalSection(&g_resultSink.lock);
+}
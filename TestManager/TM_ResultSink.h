@@ -0,0 +1,45 @@
+/*! \file TM_ResultSink.h
+ * \brief Record layout of the TestManager result file, shared by TestManager and TM_ResultReader
+ *
+ * All values are little-endian.  A string is a 16 bit length followed by the characters, without '\\0'.
+ *
+ * File header, written once when the file is created:
+ *   - char[8]  TM_RESULT_SINK_MAGIC
+ *   - uint32   TM_RESULT_SINK_VERSION
+ *   - string   station name
+ *   - uint16   number of technologies, then one string per TM_ID (technology name)
+ *
+ * One record per TM_Run():
+ *   - uint32   record size in bytes, not counting this field
+ *   - uint64   start time, FILETIME (UTC, 100 ns since 1601-01-01)
+ *   - double   duration in ms
+ *   - int32    TM_ID
+ *   - string   function keyword
+ *   - int32    TM_RETURN of TM_Run(), TM_ERR_OK is a pass
+ *   - string   DUT serial number, from TM_SetDutInfo()
+ *   - uint16   number of items, then per item:
+ *       - uint8  item type, TM_RESULT_ITEM_TYPE
+ *       - string name
+ *       - string unit (empty for input parameters)
+ *       - value: int32, double, string, or uint32 count followed by count doubles
+ *
+ * Readers must skip unknown item types by the record size, newer versions may append types.
+ */
+#ifndef _TM_RESULT_SINK_H_
+#define _TM_RESULT_SINK_H_
+
+#define TM_RESULT_SINK_MAGIC		"LPTMRS1"
+#define TM_RESULT_SINK_VERSION		1
+
+typedef enum tagTmResultItemType
+{
+	TM_ITEM_INT_PARAM			= 0x01,
+	TM_ITEM_DOUBLE_PARAM		= 0x02,
+	TM_ITEM_STRING_PARAM		= 0x03,
+	TM_ITEM_INT_RETURN			= 0x11,
+	TM_ITEM_DOUBLE_RETURN		= 0x12,
+	TM_ITEM_STRING_RETURN		= 0x13,
+	TM_ITEM_ARRAY_DOUBLE_RETURN	= 0x14
+} TM_RESULT_ITEM_TYPE;
+
+#endif
@@ -0,0 +1,443 @@
+// TM_RunAsync.cpp : TM_RunAsync(), TM_Poll() and TM_Wait(), see TM_RunAsync.h
+//
+// One worker thread per technology, created by the first TM_RunAsync() of the technology.  The worker
+// runs the queued jobs with TM_Run(), with the job context in its thread local storage, so that the
+// containers of the technology resolve to the job copy for the whole run.  TM_RunAsyncStop() tells the
+// workers to exit once their queue is empty and joins them; if it times out, the workers that have not
+// exited go on, and TM_RunAsync() replaces the ones that have.
+#include "stdafx.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include "TestManager.h"
+#include "TM_RunAsync.h"
+
+using namespace std;
+
+// Containers of TestManager.cpp
+extern map <string, int>             g_intParams[MAX_TECHNOLOGY_NUM];
+extern map <string, double>          g_doubleParams[MAX_TECHNOLOGY_NUM];
+extern map <string, string>          g_stringParams[MAX_TECHNOLOGY_NUM];
+extern map <string, int>             g_intReturns[MAX_TECHNOLOGY_NUM];
+extern map <string, double>          g_doubleReturns[MAX_TECHNOLOGY_NUM];
+extern map <string, string>          g_stringReturns[MAX_TECHNOLOGY_NUM];
+extern map <string, vector<double> > g_arrayDoubleReturns[MAX_TECHNOLOGY_NUM];
+extern map <string, string>          g_itemUnits[MAX_TECHNOLOGY_NUM];
+extern map <string, string>          g_helpText[MAX_TECHNOLOGY_NUM];
+extern map <string, SEQ_MEAS_TYPE_RESULTS> g_seqDataRateResults[MAX_TECHNOLOGY_NUM];
+
+typedef struct tagRunWorker
+{
+	HANDLE						thread;
+	HANDLE						jobEvent;
+	deque<TM_RUN_CONTEXT*>		jobs;
+	bool						exiting;		// the thread takes no more jobs
+} TM_RUN_WORKER;
+
+TM_RUN_WORKER							g_runWorkers[MAX_TECHNOLOGY_NUM];
+map<TM_ASYNC_HANDLE, TM_RUN_CONTEXT*>	g_runJobs;
+TM_ASYNC_HANDLE							g_runNextHandle = 1;
+CRITICAL_SECTION						g_runAsyncLock;		// g_runWorkers, g_runJobs, g_runShutdown
+DWORD									g_runTlsIndex = TLS_OUT_OF_INDEXES;
+volatile LONG							g_runShutdown = 0;			// the workers exit once their queue is empty
+HANDLE									g_runShutdownEvent = NULL;	// manual-reset, set while g_runShutdown is 1
+
+TM_RUN_CONTEXT* RunAsync_Context(TM_ID technologyID)
+{
+	if (TLS_OUT_OF_INDEXES==g_runTlsIndex)
+	{
+		return NULL;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	TM_RUN_CONTEXT *context = (TM_RUN_CONTEXT*)TlsGetValue(g_runTlsIndex);
+	return (NULL!=context && context->technologyID==technologyID) ? context : NULL;
+}
+
+void RunAsync_SetContext(TM_RUN_CONTEXT *context)
+{
+	TlsSetValue(g_runTlsIndex, context);
+}
+
+static DWORD WINAPI RunAsyncWorker(LPVOID param)
+{
+	TM_ID technologyID = (TM_ID)(INT_PTR)param;
+
+	while (true)
+	{
+		TM_RUN_CONTEXT *context = NULL;
+		bool           shutdown = false;
+
+		EnterCriticalSection(&g_runAsyncLock);
+		if (!g_runWorkers[technologyID].jobs.empty())
+		{
+			context = g_runWorkers[technologyID].jobs.front();
+			g_runWorkers[technologyID].jobs.pop_front();
+		}
+		else
+		{
+			shutdown = (0!=g_runShutdown);
+			g_runWorkers[technologyID].exiting = shutdown;
+		}
+		LeaveCriticalSection(&g_runAsyncLock);
+
+		if (shutdown)
+		{
+			break;
+		}
+		else if (NULL==context)
+		{
+			HANDLE events[2] = { g_runWorkers[technologyID].jobEvent, g_runShutdownEvent };
+			WaitForMultipleObjects(2, events, FALSE, INFINITE);
+			continue;
+		}
+		else
+		{
+			// do nothing
+		}
+
+		RunAsync_SetContext(context);
+		TM_RETURN tmReturn = ::TM_Run(technologyID, (TM_STR)context->functionKeyword.c_str());
+		RunAsync_SetContext(NULL);
+
+		// TM_Wait() may release the context as soon as the event is set
+		TM_ASYNC_HANDLE   handle   = context->handle;
+		TM_ASYNC_CALLBACK callback = context->callback;
+		void              *userData = context->userData;
+
+		context->tmReturn = tmReturn;
+		InterlockedExchange(&context->done, 1);
+		SetEvent(context->doneEvent);
+
+		if (NULL!=callback)
+		{
+			callback(handle, tmReturn, userData);
+		}
+		else
+		{
+			// do nothing
+		}
+	}
+
+	return 0;
+}
+
+void RunAsync_Initialize(void)
+{
+	InitializeCriticalSection(&g_runAsyncLock);
+	g_runTlsIndex = TlsAlloc();
+	g_runShutdown = 0;
+	g_runShutdownEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+
+	for (int i=0;i<MAX_TECHNOLOGY_NUM;i++)
+	{
+		g_runWorkers[i].thread   = NULL;
+		g_runWorkers[i].jobEvent = NULL;
+		g_runWorkers[i].exiting  = false;
+	}
+}
+
+// Called at DLL_PROCESS_DETACH, under the loader lock.  At process exit the workers have already been
+// terminated; after TM_RunAsyncStop() there are none.  A worker still running cannot exit while the loader
+// lock is held, so it is not waited for: it is told to stop, and the state it may still use is left alone.
+void RunAsync_Abandon(void)
+{
+	bool workerRunning = false;
+
+	g_runShutdown = 1;
+	SetEvent(g_runShutdownEvent);
+	for (int i=0;i<MAX_TECHNOLOGY_NUM;i++)
+	{
+		if (NULL==g_runWorkers[i].thread)
+		{
+			// do nothing
+		}
+		else if (WAIT_OBJECT_0==WaitForSingleObject(g_runWorkers[i].thread, 0))
+		{
+			CloseHandle(g_runWorkers[i].thread);
+			CloseHandle(g_runWorkers[i].jobEvent);
+			g_runWorkers[i].thread   = NULL;
+			g_runWorkers[i].jobEvent = NULL;
+			g_runWorkers[i].jobs.clear();
+		}
+		else
+		{
+			workerRunning = true;
+		}
+	}
+	if (workerRunning)
+	{
+		return;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	// Jobs never passed to TM_Wait(), including the ones the workers had not started
+	for (map<TM_ASYNC_HANDLE, TM_RUN_CONTEXT*>::iterator job_Iter=g_runJobs.begin(); job_Iter!=g_runJobs.end(); job_Iter++)
+	{
+		CloseHandle(job_Iter->second->doneEvent);
+		delete job_Iter->second;
+	}
+	g_runJobs.clear();
+
+	if (TLS_OUT_OF_INDEXES!=g_runTlsIndex)
+	{
+		TlsFree(g_runTlsIndex);
+		g_runTlsIndex = TLS_OUT_OF_INDEXES;
+	}
+	else
+	{
+		// do nothing
+	}
+	CloseHandle(g_runShutdownEvent);
+	g_runShutdownEvent = NULL;
+	DeleteCriticalSection(&g_runAsyncLock);
+}
+
+TM_API TM_RETURN __stdcall TM_RunAsync(TM_ID technologyID, const TM_STR functionKeyword, TM_ASYNC_HANDLE *handle,
+									   TM_ASYNC_CALLBACK callback, void *userData)
+{
+	if ( technologyID<0 || technologyID>=MAX_TECHNOLOGY_NUM )
+	{
+		return TM_ERR_INVALID_TECHNOLOGY_ID;
+	}
+	else if ( NULL==functionKeyword || NULL==handle )
+	{
+		return TM_ERR_FUNCTION_NOT_DEFINED;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	// Snapshot of the inputs; the returns start empty, as the test functions clear them anyway
+	TM_RUN_CONTEXT *context = new TM_RUN_CONTEXT;
+	context->technologyID    = technologyID;
+	context->functionKeyword = functionKeyword;
+	context->intParams       = g_intParams[technologyID];
+	context->doubleParams    = g_doubleParams[technologyID];
+	context->stringParams    = g_stringParams[technologyID];
+	context->tmReturn        = TM_ERR_OK;
+	context->callback        = callback;
+	context->userData        = userData;
+	context->doneEvent       = CreateEvent(NULL, TRUE, FALSE, NULL);
+	context->done            = 0;
+
+	EnterCriticalSection(&g_runAsyncLock);
+
+	TM_RUN_WORKER *worker = &g_runWorkers[technologyID];
+	if (0!=g_runShutdown)
+	{
+		// A TM_RunAsyncStop() is joining the workers
+		LeaveCriticalSection(&g_runAsyncLock);
+
+		CloseHandle(context->doneEvent);
+		delete context;
+		return TM_ERR_FUNCTION_ERROR;
+	}
+	else if ( NULL!=worker->thread && worker->exiting )
+	{
+		// Left by a TM_RunAsyncStop() that timed out; the thread does not take the lock any more
+		WaitForSingleObject(worker->thread, INFINITE);
+		CloseHandle(worker->thread);
+		CloseHandle(worker->jobEvent);
+		worker->thread   = NULL;
+		worker->jobEvent = NULL;
+		worker->exiting  = false;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	if (NULL==worker->thread)
+	{
+		worker->jobEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+		worker->thread   = CreateThread(NULL, 0, RunAsyncWorker, (LPVOID)(INT_PTR)technologyID, 0, NULL);
+		if (NULL==worker->thread)
+		{
+			CloseHandle(worker->jobEvent);
+			worker->jobEvent = NULL;
+			LeaveCriticalSection(&g_runAsyncLock);
+
+			CloseHandle(context->doneEvent);
+			delete context;
+			return TM_ERR_FUNCTION_ERROR;
+		}
+		else
+		{
+			// do nothing
+		}
+	}
+	else
+	{
+		// do nothing
+	}
+
+	context->handle = g_runNextHandle++;
+	g_runJobs[context->handle] = context;
+	worker->jobs.push_back(context);
+	*handle = context->handle;
+
+	LeaveCriticalSection(&g_runAsyncLock);
+	SetEvent(worker->jobEvent);
+
+	return TM_ERR_OK;
+}
+
+TM_API TM_RETURN __stdcall TM_Poll(TM_ASYNC_HANDLE handle, int *done)
+{
+	TM_RETURN ret = TM_ERR_OK;
+
+	EnterCriticalSection(&g_runAsyncLock);
+	map<TM_ASYNC_HANDLE, TM_RUN_CONTEXT*>::iterator job_Iter = g_runJobs.find(handle);
+	if (job_Iter!=g_runJobs.end())
+	{
+		if (NULL!=done)
+		{
+			*done = (0!=job_Iter->second->done) ? 1 : 0;
+		}
+		else
+		{
+			// do nothing
+		}
+	}
+	else
+	{
+		ret = TM_ERR_INVALID_HANDLE;
+	}
+	LeaveCriticalSection(&g_runAsyncLock);
+
+	return ret;
+}
+
+TM_API TM_RETURN __stdcall TM_Wait(TM_ASYNC_HANDLE handle, int timeoutMs, TM_RETURN *tmReturn)
+{
+	EnterCriticalSection(&g_runAsyncLock);
+	map<TM_ASYNC_HANDLE, TM_RUN_CONTEXT*>::iterator job_Iter = g_runJobs.find(handle);
+	TM_RUN_CONTEXT *context = (job_Iter!=g_runJobs.end()) ? job_Iter->second : NULL;
+	LeaveCriticalSection(&g_runAsyncLock);
+
+	if (NULL==context)
+	{
+		return TM_ERR_INVALID_HANDLE;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	DWORD timeout = (timeoutMs<0) ? INFINITE : (DWORD)timeoutMs;
+	if (WAIT_OBJECT_0!=WaitForSingleObject(context->doneEvent, timeout))
+	{
+		return TM_ERR_TIMEOUT;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	EnterCriticalSection(&g_runAsyncLock);
+	job_Iter = g_runJobs.find(handle);
+	if (job_Iter==g_runJobs.end())
+	{
+		// Another thread has already waited for the handle
+		LeaveCriticalSection(&g_runAsyncLock);
+		return TM_ERR_INVALID_HANDLE;
+	}
+	else
+	{
+		g_runJobs.erase(job_Iter);
+	}
+
+	// Returns of the job become the returns of the technology, as after TM_Run()
+	TM_ID technologyID = context->technologyID;
+	g_intReturns[technologyID].swap(context->intReturns);
+	g_doubleReturns[technologyID].swap(context->doubleReturns);
+	g_stringReturns[technologyID].swap(context->stringReturns);
+	g_arrayDoubleReturns[technologyID].swap(context->arrayDoubleReturns);
+	g_itemUnits[technologyID].swap(context->itemUnits);
+	g_helpText[technologyID].swap(context->helpText);
+	g_seqDataRateResults[technologyID].swap(context->seqDataRateResults);
+	LeaveCriticalSection(&g_runAsyncLock);
+
+	if (NULL!=tmReturn)
+	{
+		*tmReturn = context->tmReturn;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	CloseHandle(context->doneEvent);
+	delete context;
+
+	return TM_ERR_OK;
+}
+
+TM_API TM_RETURN __stdcall TM_RunAsyncStop(int timeoutMs)
+{
+	HANDLE threads[MAX_TECHNOLOGY_NUM];
+	int    threadCount = 0;
+
+	EnterCriticalSection(&g_runAsyncLock);
+	g_runShutdown = 1;
+	for (int i=0;i<MAX_TECHNOLOGY_NUM;i++)
+	{
+		if (NULL!=g_runWorkers[i].thread)
+		{
+			threads[threadCount++] = g_runWorkers[i].thread;
+		}
+		else
+		{
+			// do nothing
+		}
+	}
+	LeaveCriticalSection(&g_runAsyncLock);
+	SetEvent(g_runShutdownEvent);
+
+	// The workers finish their queued jobs first
+	DWORD timeout = (timeoutMs<0) ? INFINITE : (DWORD)timeoutMs;
+	if ( 0<threadCount && WAIT_OBJECT_0!=WaitForMultipleObjects(threadCount, threads, TRUE, timeout) )
+	{
+		// Not latched: the workers still running go on, TM_RunAsync() works again, and a later call joins them
+		EnterCriticalSection(&g_runAsyncLock);
+		g_runShutdown = 0;
+		ResetEvent(g_runShutdownEvent);
+		LeaveCriticalSection(&g_runAsyncLock);
+		return TM_ERR_TIMEOUT;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	EnterCriticalSection(&g_runAsyncLock);
+	for (int i=0;i<MAX_TECHNOLOGY_NUM;i++)
+	{
+		if (NULL!=g_runWorkers[i].thread)
+		{
+			CloseHandle(g_runWorkers[i].thread);
+			CloseHandle(g_runWorkers[i].jobEvent);
+			g_runWorkers[i].thread   = NULL;
+			g_runWorkers[i].jobEvent = NULL;
+			g_runWorkers[i].exiting  = false;
+		}
+		else
+		{
+			// do nothing
+		}
+	}
+	g_runShutdown = 0;
+	ResetEvent(g_runShutdownEvent);
+	LeaveCriticalSection(&g_runAsyncLock);
+
+	return TM_ERR_OK;
+}
@@ -0,0 +1,81 @@
+/*! \file TM_RunAsync.h
+ * \brief Run context of TM_RunAsync(), shared by TestManager.cpp, TM_ResultSink.cpp and TM_RunAsync.cpp
+ *
+ * A TM_RunAsync() job owns a copy of the parameter and return containers of its technology.  While the
+ * worker thread runs the test function, every container access of that technology from the worker thread
+ * (the test function, the IQreport calls, the result file) goes to the copy through TM_CONTAINER(), so the
+ * caller can fill the parameters of the next run at the same time.  TM_Wait() copies the returns back.
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include "TestManager.h"
+
+// map<dataRate, measureMaps>, measureMap<string, resultMap>, resultMap<string, doubleResult>
+//Sequence result structures
+typedef struct tagSeqReturnValue
+{
+    std::vector <double>  values;
+    std::string  unit;
+} SEQ_PARAM_RETURN_VALUES;
+
+//map<paramName, SEQ_RETURN_VALUES> SEQ_MEAS_RESULTS
+typedef std::map<std::string, SEQ_PARAM_RETURN_VALUES> SEQ_MEAS_PARAM_RETURN;
+typedef std::pair<std::string, SEQ_PARAM_RETURN_VALUES> seqMeasParamReturnPair;
+//map<measType, SEQ_MEAS_RESULTS> SEQ_MEAS_TYPE_RESULTS
+typedef std::map<int, SEQ_MEAS_PARAM_RETURN> SEQ_MEAS_TYPE_RESULTS;
+typedef std::pair<int, SEQ_MEAS_PARAM_RETURN> seqMeasTypeResultsPair;
+
+typedef struct tagRunContext
+{
+    TM_ASYNC_HANDLE     handle;
+    TM_ID               technologyID;
+    std::string         functionKeyword;
+
+    // Same names as the g_xxx containers of TestManager.cpp, see TM_CONTAINER()
+    std::map <std::string, int>                     intParams;
+    std::map <std::string, double>                  doubleParams;
+    std::map <std::string, std::string>             stringParams;
+    std::map <std::string, int>                     intReturns;
+    std::map <std::string, double>                  doubleReturns;
+    std::map <std::string, std::string>             stringReturns;
+    std::map <std::string, std::vector<double> >    arrayDoubleReturns;
+    std::map <std::string, std::string>             itemUnits;
+    std::map <std::string, std::string>             helpText;
+    std::map <std::string, SEQ_MEAS_TYPE_RESULTS>   seqDataRateResults;
+
+    // Cursors of the TM_GetXxxPair functions, same names as the g_xxx_Iter of TestManager.cpp
+    std::map <std::string, int>::iterator                   intParams_Iter;
+    std::map <std::string, double>::iterator                doubleParam_Iter;
+    std::map <std::string, std::string>::iterator           stringParam_Iter;
+    std::map <std::string, int>::iterator                   intReturn_Iter;
+    std::map <std::string, double>::iterator                doubleReturn_Iter;
+    std::map <std::string, std::string>::iterator           stringReturn_Iter;
+    std::map <std::string, std::vector<double> >::iterator  arrayDoubleReturn_Iter;
+
+    TM_RETURN           tmReturn;
+    TM_ASYNC_CALLBACK   callback;
+    void                *userData;
+    HANDLE              doneEvent;      // manual-reset, set when tmReturn is valid
+    volatile LONG       done;
+} TM_RUN_CONTEXT;
+
+//! Context of the TM_RunAsync() job running on this thread, NULL if none or if it runs another technology
+TM_RUN_CONTEXT* RunAsync_Context(TM_ID technologyID);
+
+//! Makes the containers of context->technologyID resolve to the context on this thread, NULL to restore
+void RunAsync_SetContext(TM_RUN_CONTEXT *context);
+
+//! Container of a technology: the job copy on its worker thread, the global container everywhere else
+#define TM_CONTAINER(name, technologyID) \
+    ( NULL!=RunAsync_Context(technologyID) ? RunAsync_Context(technologyID)->name : g_##name[technologyID] )
+
+void RunAsync_Initialize(void);
+void RunAsync_Abandon(void);
+
+// Implemented in TM_LookAhead.cpp
+void LookAhead_Initialize(void);
+void LookAhead_Wait(TM_ID technologyID);
+void LookAhead_Abandon(void);
@@ -10,6 +10,7 @@
 #include <limits>
 #include <map>
 #include "TestManager.h"
+#include "TM_RunAsync.h"
 #include "StringUtil.h"
 #include "IQlite_Timer.h"
 #include "IQlite_Logger.h"
@@ -18,6 +19,7 @@
 //#include "lp_string.h"
 //#include "lp_stdio.h"
 #include "Version.h"
+#include "WiFi_RateTable.h"
 
 
 #ifdef _MANAGED
@@ -63,6 +65,7 @@ typedef pair<string , TM_INFO> technologyPair;
 
 map <string, int> g_intParams[MAX_TECHNOLOGY_NUM];
 typedef pair<string , int> intParamPair;
+// The cursors of the TM_GetXxxPair functions; a TM_RunAsync() worker uses the ones of its job context, see TM_CONTAINER()
 map <string, int>::iterator g_intParams_Iter[MAX_TECHNOLOGY_NUM];
 
 map <string, double> g_doubleParams[MAX_TECHNOLOGY_NUM];
@@ -92,37 +95,17 @@ map <string, vector<double> > g_arrayDoubleReturns[MAX_TECHNOLOGY_NUM];
 typedef pair<string , vector<double> > arrayDoubleReturnPair;
 map <string, vector<double> >::iterator g_arrayDoubleReturn_Iter[MAX_TECHNOLOGY_NUM];
 
-// map<dataRate, measureMaps>, measureMap<string, resultMap>, resultMap<string, doubleResult>
-//Sequence result structures
-typedef struct tagSeqReturnValue
-{
-    vector <double>  values;
-    string  unit;
-} SEQ_PARAM_RETURN_VALUES;
-
-//map<paramName, SEQ_RETURN_VALUES> SEQ_MEAS_RESULTS
-typedef map<string, SEQ_PARAM_RETURN_VALUES> SEQ_MEAS_PARAM_RETURN;
-typedef pair<string, SEQ_PARAM_RETURN_VALUES> seqMeasParamReturnPair;
-//map<measType, SEQ_MEAS_RESULTS> SEQ_MEAS_TYPE_RESULTS
-typedef map<int, SEQ_MEAS_PARAM_RETURN> SEQ_MEAS_TYPE_RESULTS;
-typedef pair<int, SEQ_MEAS_PARAM_RETURN> seqMeasTypeResultsPair;
+// Sequence result structures are defined in TM_RunAsync.h
 //map<dataRate, SEQ_MEAS_TYPE_RESULTS> SEQ_DATA_RATE_RESULTS;
 map<string, SEQ_MEAS_TYPE_RESULTS> g_seqDataRateResults[MAX_TECHNOLOGY_NUM];
 
 // itemUnits works as companion container with three return value containers
 // to indicate the unit of items in each return value container
 map <string, string> g_itemUnits[MAX_TECHNOLOGY_NUM];
-map <string, string>::iterator g_itemUnit_Iter[MAX_TECHNOLOGY_NUM];
 
 // helpText works as companion container with three return value containers
 // to the help text for in each return value container
 map <string, string> g_helpText[MAX_TECHNOLOGY_NUM];
-map <string, string>::iterator g_helpText_Iter[MAX_TECHNOLOGY_NUM];
-
-map <int, int>       wifiChannels;
-map <string, int>    wifiDataRates;
-map <string, double> wifiDataRatesMbps;
-map <string, int>	 dataRateIQ2010Ext;
 
 // Global Multi-Segment Waveform map
 map <string, int> g_multiWaveformIndexMap;
@@ -146,6 +129,9 @@ typedef struct
 } DEVICE_INFO;
 DEVICE_INFO g_dutInfo;
 
+// IQREPORT containers are shared by the TM_RunAsync() workers of all technologies
+CRITICAL_SECTION g_reportLock;
+
 int Initialize_TM();
 void Free_TM_Memory();
 
@@ -153,6 +139,23 @@ void ProcessExtensions(TM_ID technologyID, TM_STR technologyDllFileName);
 void LogTestInputParameters(TM_ID technologyID, const TM_STR functionKeyword);
 void LogTestResults(TM_ID technologyID, const TM_STR functionKeyword);
 
+// Implemented in TM_ResultSink.cpp
+void ResultSink_Initialize(void);
+void ResultSink_Record(TM_ID technologyID, const TM_STR functionKeyword, TM_RETURN tmReturn, double durationInMiniSec, const string &dutSerialNumber);
+void ResultSink_Abandon(void);
+
+// Implemented in TM_Adaptive.cpp
+void Adaptive_Initialize(void);
+bool Adaptive_Skip(TM_ID technologyID, const TM_STR functionKeyword, string &reason);
+bool Adaptive_Record(TM_ID technologyID, const TM_STR functionKeyword, TM_RETURN tmReturn, string &reason);
+void Adaptive_Abandon(void);
+
+// Implemented in TM_AllocProfiler.cpp
+void AllocProfiler_Initialize(void);
+void AllocProfiler_BeginRun(TM_ID technologyID, const TM_STR functionKeyword);
+void AllocProfiler_EndRun(void);
+void AllocProfiler_Abandon(void);
+
                                            
 typedef struct tagPosition
 {
@@ -217,6 +220,18 @@ TM_API char* __stdcall TM_GetErrorString(TM_RETURN errorNum)
 	case TM_ERR_WIFI_FREQ_DOES_NOT_EXIST:
 		ret = "The specified WiFi frequency does not exist";
 		break;
+	case TM_ERR_INVALID_HANDLE:
+		ret = "The specified TM_RunAsync handle does not exist";
+		break;
+	case TM_ERR_TIMEOUT:
+		ret = "The TM_RunAsync job did not complete in time";
+		break;
+	case TM_ERR_ADAPTIVE_SKIPPED:
+		ret = "The test item is skipped on this unit by the adaptive test policy";
+		break;
+	case TM_ERR_BUFFER_TOO_SMALL:
+		ret = "The buffer is too small, or not a valid TM_ExportReturns layout";
+		break;
     }
 
     return ret;
@@ -224,10 +239,14 @@ TM_API char* __stdcall TM_GetErrorString(TM_RETURN errorNum)
 
 void Free_TM_Memory()
 {
+	ResultSink_Abandon();
+	Adaptive_Abandon();
+	RunAsync_Abandon();
+	LookAhead_Abandon();
+	AllocProfiler_Abandon();
+	DeleteCriticalSection(&g_reportLock);
+
 	g_technologies.clear();
-	wifiChannels.clear();
-	wifiDataRates.clear();
-	dataRateIQ2010Ext.clear();
 	g_multiWaveformIndexMap.clear();
 
 	for (int i=0;i<MAX_TECHNOLOGY_NUM;i++)
@@ -250,6 +269,33 @@ void Free_TM_Memory()
 	}
 }
 
+TM_API TM_RETURN __stdcall TM_Term(void)
+{
+	TM_RETURN ret = ::TM_ResultSinkClose();
+
+	TM_RETURN adaptiveReturn = ::TM_AdaptiveClose();
+	if ( TM_ERR_OK==ret )
+	{
+		ret = adaptiveReturn;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	// The trace of IQlite_Timer, TRACE_EVENT=1 in IQlite_Timer.ini
+	if ( TIMER_ERR_OK!=::TIMER_Term() && TM_ERR_OK==ret )
+	{
+		ret = TM_ERR_FAILED_TO_OPEN_FILE;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	return ret;
+}
+
 /*! @defgroup wifi_test_function_keywords Function Keywords for WiFi Test
  *
  * The following function keywords have been defined for WiFi Test:
@@ -318,6 +364,13 @@ int Initialize_TM()
 
     callBack.pointerToFunction = NULL;
 
+	InitializeCriticalSection(&g_reportLock);
+	ResultSink_Initialize();
+	RunAsync_Initialize();
+	LookAhead_Initialize();
+	Adaptive_Initialize();
+	AllocProfiler_Initialize();
+
     g_technologies.clear();
     TM_INFO tmInfo;
     tmInfo.technologyID    = -1;
@@ -831,261 +884,7 @@ int Initialize_TM()
     // Create the logger ID 
 	LOGGER_CreateLogger("IQREPORT_TM", &g_tmLoggerID[IQREPORT]);
 
-    // Initialize the WiFi Frequency-Channel map, The formula for converting between freq in MHz is cneter freq(MHz)=5000+5xN, N=0,1,2...199
-    // Parts of this map have not been verified and may not be valid.
-	wifiChannels.clear();
-	wifiChannels.insert( pair<int,int>( 2412, 1   ));
-	wifiChannels.insert( pair<int,int>( 2417, 2   ));
-	wifiChannels.insert( pair<int,int>( 2422, 3   ));
-	wifiChannels.insert( pair<int,int>( 2427, 4   ));
-	wifiChannels.insert( pair<int,int>( 2432, 5   ));
-	wifiChannels.insert( pair<int,int>( 2437, 6   ));
-	wifiChannels.insert( pair<int,int>( 2442, 7   ));
-	wifiChannels.insert( pair<int,int>( 2447, 8   ));
-	wifiChannels.insert( pair<int,int>( 2452, 9   ));
-	wifiChannels.insert( pair<int,int>( 2457, 10  ));
-	wifiChannels.insert( pair<int,int>( 2462, 11  ));
-	wifiChannels.insert( pair<int,int>( 2467, 12  ));
-	wifiChannels.insert( pair<int,int>( 2472, 13  ));
-	wifiChannels.insert( pair<int,int>( 2484, 14  ));
-	wifiChannels.insert( pair<int,int>( 4920, 184 ));
-	wifiChannels.insert( pair<int,int>( 4940, 188 ));
-	wifiChannels.insert( pair<int,int>( 4960, 192 ));
-	wifiChannels.insert( pair<int,int>( 4980, 196 ));
-	wifiChannels.insert( pair<int,int>( 5040, 8   ));
-	wifiChannels.insert( pair<int,int>( 5060, 12  ));
-	wifiChannels.insert( pair<int,int>( 5080, 16  ));
-	wifiChannels.insert( pair<int,int>( 5170, 34  ));
-	wifiChannels.insert( pair<int,int>( 5180, 36  ));
-	wifiChannels.insert( pair<int,int>( 5190, 38  ));
-	wifiChannels.insert( pair<int,int>( 5200, 40  ));
-	wifiChannels.insert( pair<int,int>( 5210, 42  ));
-	wifiChannels.insert( pair<int,int>( 5220, 44  ));
-	wifiChannels.insert( pair<int,int>( 5230, 46  ));
-	wifiChannels.insert( pair<int,int>( 5240, 48  ));
-	wifiChannels.insert( pair<int,int>( 5260, 52  ));
-    wifiChannels.insert( pair<int,int>( 5270, 54  ));
-	wifiChannels.insert( pair<int,int>( 5280, 56  ));
-	wifiChannels.insert( pair<int,int>( 5300, 60  ));
-    wifiChannels.insert( pair<int,int>( 5310, 62  ));
-	wifiChannels.insert( pair<int,int>( 5320, 64  ));
-	wifiChannels.insert( pair<int,int>( 5400, 80  ));  //Add this channel number, which is not defined in 11a spec, for Atheros calibration. 
-	wifiChannels.insert( pair<int,int>( 5500, 100 ));
-    wifiChannels.insert( pair<int,int>( 5510, 102 ));
-	wifiChannels.insert( pair<int,int>( 5520, 104 ));
-	wifiChannels.insert( pair<int,int>( 5540, 108 ));
-    wifiChannels.insert( pair<int,int>( 5550, 110 ));
-	wifiChannels.insert( pair<int,int>( 5560, 112 ));
-	wifiChannels.insert( pair<int,int>( 5580, 116 ));
-    wifiChannels.insert( pair<int,int>( 5590, 118 ));
-	wifiChannels.insert( pair<int,int>( 5600, 120 ));
-	wifiChannels.insert( pair<int,int>( 5620, 124 ));
-    wifiChannels.insert( pair<int,int>( 5630, 126 ));
-	wifiChannels.insert( pair<int,int>( 5640, 128 ));
-	wifiChannels.insert( pair<int,int>( 5660, 132 ));
-    wifiChannels.insert( pair<int,int>( 5670, 134 ));
-	wifiChannels.insert( pair<int,int>( 5680, 136 ));
-	wifiChannels.insert( pair<int,int>( 5700, 140 ));
-	wifiChannels.insert( pair<int,int>( 5720, 144 ));  //Add this channel number, which is not defined in 11a spec, for Atheros calibration. 
-	wifiChannels.insert( pair<int,int>( 5745, 149 ));
-	wifiChannels.insert( pair<int,int>( 5755, 151 ));
-    wifiChannels.insert( pair<int,int>( 5765, 153 ));
-	wifiChannels.insert( pair<int,int>( 5785, 157 ));
-    wifiChannels.insert( pair<int,int>( 5795, 159 ));
-	wifiChannels.insert( pair<int,int>( 5805, 161 ));
-	wifiChannels.insert( pair<int,int>( 5820, 164 ));  //Add this channel number, which is not defined in 11a spec, for Atheros calibration. 
-	wifiChannels.insert( pair<int,int>( 5825, 165 ));
-	wifiChannels.insert( pair<int,int>( 5845, 169 ));
-	wifiChannels.insert( pair<int,int>( 5865, 173 ));
-	wifiChannels.insert( pair<int,int>( 5885, 177 ));
-	wifiChannels.insert( pair<int,int>( 5905, 181 ));
-	wifiChannels.insert( pair<int,int>( 5925, 185 ));
-	wifiChannels.insert( pair<int,int>( 5945, 189 ));
-
-	// Initializes the WiFi data rate index map
-	wifiDataRates.clear();
-	wifiDataRates.insert( pair<string, int>( "DSSS-1",   0 ));
-	wifiDataRates.insert( pair<string, int>( "DSSS-2",   1 ));
-	wifiDataRates.insert( pair<string, int>( "CCK-5_5",  2 ));
-	wifiDataRates.insert( pair<string, int>( "CCK-11",   3 ));
-	wifiDataRates.insert( pair<string, int>( "PBCC-22",  4 ));
-	wifiDataRates.insert( pair<string, int>( "OFDM-6",   5 ));
-	wifiDataRates.insert( pair<string, int>( "OFDM-9",   6 ));
-	wifiDataRates.insert( pair<string, int>( "OFDM-12",  7 ));
-	wifiDataRates.insert( pair<string, int>( "OFDM-18",  8 ));
-	wifiDataRates.insert( pair<string, int>( "OFDM-24",  9 ));
-	wifiDataRates.insert( pair<string, int>( "OFDM-36", 10 ));
-	wifiDataRates.insert( pair<string, int>( "OFDM-48", 11 ));
-	wifiDataRates.insert( pair<string, int>( "OFDM-54", 12 ));
-	wifiDataRates.insert( pair<string, int>( "MCS0",    14 ));
-	wifiDataRates.insert( pair<string, int>( "MCS1",    15 ));
-	wifiDataRates.insert( pair<string, int>( "MCS2",    16 ));
-	wifiDataRates.insert( pair<string, int>( "MCS3",    17 ));
-	wifiDataRates.insert( pair<string, int>( "MCS4",    18 ));
-	wifiDataRates.insert( pair<string, int>( "MCS5",    19 ));
-	wifiDataRates.insert( pair<string, int>( "MCS6",    20 ));
-	wifiDataRates.insert( pair<string, int>( "MCS7",    21 ));
-	wifiDataRates.insert( pair<string, int>( "MCS8",    22 ));
-	wifiDataRates.insert( pair<string, int>( "MCS9",    23 ));
-	wifiDataRates.insert( pair<string, int>( "MCS10",   24 ));
-	wifiDataRates.insert( pair<string, int>( "MCS11",   25 ));
-	wifiDataRates.insert( pair<string, int>( "MCS12",   26 ));
-	wifiDataRates.insert( pair<string, int>( "MCS13",   27 ));
-	wifiDataRates.insert( pair<string, int>( "MCS14",   28 ));
-	wifiDataRates.insert( pair<string, int>( "MCS15",   29 ));
-	wifiDataRates.insert( pair<string, int>( "MCS16",   30 ));
-	wifiDataRates.insert( pair<string, int>( "MCS17",   31 ));
-	wifiDataRates.insert( pair<string, int>( "MCS18",   32 ));
-	wifiDataRates.insert( pair<string, int>( "MCS19",   33 ));
-	wifiDataRates.insert( pair<string, int>( "MCS20",   34 ));
-	wifiDataRates.insert( pair<string, int>( "MCS21",   35 ));
-	wifiDataRates.insert( pair<string, int>( "MCS22",   36 ));
-	wifiDataRates.insert( pair<string, int>( "MCS23",   37 ));
-	wifiDataRates.insert( pair<string, int>( "MCS24",   38 ));
-	wifiDataRates.insert( pair<string, int>( "MCS25",   39 ));
-	wifiDataRates.insert( pair<string, int>( "MCS26",   40 ));
-	wifiDataRates.insert( pair<string, int>( "MCS27",   41 ));
-	wifiDataRates.insert( pair<string, int>( "MCS28",   42 ));
-	wifiDataRates.insert( pair<string, int>( "MCS29",   43 ));
-	wifiDataRates.insert( pair<string, int>( "MCS30",   44 ));
-	wifiDataRates.insert( pair<string, int>( "MCS31",   45 ));
-	wifiDataRates.insert( pair<string, int>( "HALF-3",		200 ));
-	wifiDataRates.insert( pair<string, int>( "HALF-4_5",	201 ));
-	wifiDataRates.insert( pair<string, int>( "HALF-6",		202 ));
-	wifiDataRates.insert( pair<string, int>( "HALF-9",		203 ));
-	wifiDataRates.insert( pair<string, int>( "HALF-12",		204 ));
-	wifiDataRates.insert( pair<string, int>( "HALF-18",		205 ));
-	wifiDataRates.insert( pair<string, int>( "HALF-24",		206 ));
-	wifiDataRates.insert( pair<string, int>( "HALF-27",		207 ));
-	wifiDataRates.insert( pair<string, int>( "QUAR-1_5",	208 ));
-	wifiDataRates.insert( pair<string, int>( "QUAR-2_25",	209 ));
-	wifiDataRates.insert( pair<string, int>( "QUAR-3",		210 ));
-	wifiDataRates.insert( pair<string, int>( "QUAR-4_5",	211 ));
-	wifiDataRates.insert( pair<string, int>( "QUAR-6",		212 ));
-	wifiDataRates.insert( pair<string, int>( "QUAR-9",		213 ));
-	wifiDataRates.insert( pair<string, int>( "QUAR-12",		214 ));
-	wifiDataRates.insert( pair<string, int>( "QUAR-13_5",	215 ));
-
-	// Initializes the WiFi data rate Mbps map
-	wifiDataRatesMbps.clear();
-	wifiDataRatesMbps.insert( pair<string, double>( "DSSS-1",   1 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "DSSS-2",   2 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "CCK-5_5",  5.5 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "CCK-11",   11 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "PBCC-22",  22 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "OFDM-6",   5 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "OFDM-9",   9 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "OFDM-12",  12 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "OFDM-18",  18 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "OFDM-24",  24 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "OFDM-36",  36 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "OFDM-48",  48 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "OFDM-54",  54 ));
-
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS0", 6.5 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS1", 13 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS2", 19.5 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS3", 26 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS4", 39 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS5", 52 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS6", 58.5 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS7", 65 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS8", 13 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS9", 26 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS10", 39 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS11", 52 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS12", 78 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS13", 104 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS14", 117 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS15", 130 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS16", 19.5 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS17", 39 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS18", 58.5 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS19", 78 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS20", 117 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS21", 156 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS22", 175.5 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS23", 195 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS24", 26 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS25", 52 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS26", 78 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS27", 104 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS28", 156 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS29", 208 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS30", 234 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT20_MCS31", 260 ));
-
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS0", 13.5 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS1", 27 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS2", 40.5 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS3", 54 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS4", 81 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS5", 108 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS6", 121.5 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS7", 135 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS8", 27 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS9", 54 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS10", 81 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS11", 108 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS12", 162 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS13", 216 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS14", 243 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS15", 270 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS16", 40.5 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS17", 81 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS18", 121.5 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS19", 162 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS20", 243 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS21", 324 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS22", 364.5 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS23", 405 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS24", 54 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS25", 108 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS26", 162 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS27", 216 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS28", 324 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS29", 432 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS30", 486 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HT40_MCS31", 540 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HALF-3",	3 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HALF-4_5",	4.5 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HALF-6",	6 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HALF-9",	9 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HALF-12",	12 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HALF-18",	18 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HALF-24",	24 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HALF-27",	27 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "QUAR-1_5",	1.5 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "QUAR-2_25",2.25 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "QUAR-3",	3 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "QUAR-4_5",	4.5 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "QUAR-6",	6 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "QUAR-9",	9 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "QUAR-12",	12 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "QUAR-13_5",13.5 ));
-
-	// Initializes the WiFi data rate IQ2010Ext map
-	dataRateIQ2010Ext.clear();
-	dataRateIQ2010Ext.insert( pair<string, int>( "DSSS-1",   0 ));
-	dataRateIQ2010Ext.insert( pair<string, int>( "DSSS-2",   1 ));
-	dataRateIQ2010Ext.insert( pair<string, int>( "CCK-5_5",  2 ));
-	dataRateIQ2010Ext.insert( pair<string, int>( "CCK-11",   3 ));
-	dataRateIQ2010Ext.insert( pair<string, int>( "OFDM-6",   4 ));
-	dataRateIQ2010Ext.insert( pair<string, int>( "OFDM-9",   5 ));
-	dataRateIQ2010Ext.insert( pair<string, int>( "OFDM-12",  6 ));
-	dataRateIQ2010Ext.insert( pair<string, int>( "OFDM-18",  7 ));
-	dataRateIQ2010Ext.insert( pair<string, int>( "OFDM-24",  8 ));
-	dataRateIQ2010Ext.insert( pair<string, int>( "OFDM-36",  9 ));
-	dataRateIQ2010Ext.insert( pair<string, int>( "OFDM-48",  10 ));
-	dataRateIQ2010Ext.insert( pair<string, int>( "OFDM-54",  11 ));
-	dataRateIQ2010Ext.insert( pair<string, int>( "MCS0",	  12 ));
-	dataRateIQ2010Ext.insert( pair<string, int>( "MCS1",	  13 ));
-	dataRateIQ2010Ext.insert( pair<string, int>( "MCS2",	  14 ));
-	dataRateIQ2010Ext.insert( pair<string, int>( "MCS3",	  15 ));
-	dataRateIQ2010Ext.insert( pair<string, int>( "MCS4",	  16 ));
-	dataRateIQ2010Ext.insert( pair<string, int>( "MCS5",	  17 ));
-	dataRateIQ2010Ext.insert( pair<string, int>( "MCS6",	  18 ));
-	dataRateIQ2010Ext.insert( pair<string, int>( "MCS7",	  19 ));
+    // The WiFi channel and data rate tables are static, see WiFi_RateTable.h
 
     //-----------------//
     //   Device Info   //
@@ -1133,9 +932,9 @@ TM_API TM_RETURN __stdcall TM_ClearParameters(TM_ID technologyID)
 
     if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
     {
-        g_intParams[technologyID].clear();
-        g_doubleParams[technologyID].clear();
-        g_stringParams[technologyID].clear();
+        TM_CONTAINER(intParams, technologyID).clear();
+        TM_CONTAINER(doubleParams, technologyID).clear();
+        TM_CONTAINER(stringParams, technologyID).clear();
     }
     else
     {
@@ -1151,20 +950,20 @@ TM_API TM_RETURN __stdcall TM_ClearReturns(TM_ID technologyID)
 
     if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
     {
-        g_intReturns[technologyID].clear();
-        g_doubleReturns[technologyID].clear();
-        g_stringReturns[technologyID].clear();
-        g_itemUnits[technologyID].clear();
-        g_helpText[technologyID].clear();
-        g_seqDataRateResults[technologyID].clear();
+        TM_CONTAINER(intReturns, technologyID).clear();
+        TM_CONTAINER(doubleReturns, technologyID).clear();
+        TM_CONTAINER(stringReturns, technologyID).clear();
+        TM_CONTAINER(itemUnits, technologyID).clear();
+        TM_CONTAINER(helpText, technologyID).clear();
+        TM_CONTAINER(seqDataRateResults, technologyID).clear();
 
-        g_arrayDoubleReturn_Iter[technologyID] = g_arrayDoubleReturns[technologyID].begin();
-        while( g_arrayDoubleReturn_Iter[technologyID] != g_arrayDoubleReturns[technologyID].end() )
+        map <string, vector<double> >::iterator arrayDoubleReturn_Iter = TM_CONTAINER(arrayDoubleReturns, technologyID).begin();
+        while( arrayDoubleReturn_Iter != TM_CONTAINER(arrayDoubleReturns, technologyID).end() )
         {
-            g_arrayDoubleReturn_Iter[technologyID]->second.clear();
-            g_arrayDoubleReturn_Iter[technologyID]++;
+            arrayDoubleReturn_Iter->second.clear();
+            arrayDoubleReturn_Iter++;
         }
-        g_arrayDoubleReturns[technologyID].clear();
+        TM_CONTAINER(arrayDoubleReturns, technologyID).clear();
     }
     else
     {
@@ -1180,7 +979,7 @@ TM_API TM_RETURN __stdcall TM_AddIntegerParameter(TM_ID technologyID, const TM_S
 
     if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
     {
-        g_intParams[technologyID].insert( intParamPair(paramName, paramValue) );
+        TM_CONTAINER(intParams, technologyID).insert( intParamPair(paramName, paramValue) );
     }
     else
     {
@@ -1195,7 +994,7 @@ TM_API TM_RETURN __stdcall TM_AddIntegerReturn(TM_ID technologyID, const TM_STR
 
     if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
     {
-        g_intReturns[technologyID].insert( intReturnPair(paramName, paramValue) );
+        TM_CONTAINER(intReturns, technologyID).insert( intReturnPair(paramName, paramValue) );
     }
     else
     {
@@ -1212,8 +1011,8 @@ TM_API TM_RETURN __stdcall TM_GetIntegerParameter(TM_ID technologyID, const TM_S
 
     if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
     {
-        intParam_Iter = g_intParams[technologyID].find(paramName);
-        if( intParam_Iter!=g_intParams[technologyID].end() )
+        intParam_Iter = TM_CONTAINER(intParams, technologyID).find(paramName);
+        if( intParam_Iter!=TM_CONTAINER(intParams, technologyID).end() )
         {
             *paramValue = intParam_Iter->second;
         }
@@ -1238,8 +1037,8 @@ TM_API TM_RETURN __stdcall TM_GetIntegerReturn(TM_ID technologyID, const TM_STR
 
     if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
     {
-        intParam_Iter = g_intReturns[technologyID].find(paramName);
-        if( intParam_Iter!=g_intReturns[technologyID].end() )
+        intParam_Iter = TM_CONTAINER(intReturns, technologyID).find(paramName);
+        if( intParam_Iter!=TM_CONTAINER(intReturns, technologyID).end() )
         {
             *paramValue = intParam_Iter->second;
         }
@@ -1267,42 +1066,44 @@ TM_API TM_RETURN __stdcall TM_GetIntegerReturnPair(TM_ID technologyID,
                                          int order)
 {
     TM_RETURN ret = TM_ERR_OK;
+    map <string, string>::iterator itemUnit_Iter;
+    map <string, string>::iterator helpText_Iter;
 
     if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
     {
         if( FIRST==order )
         {
             // The first time to retrieve the info
-            g_intReturn_Iter[technologyID] = g_intReturns[technologyID].begin();
+            TM_CONTAINER(intReturn_Iter, technologyID) = TM_CONTAINER(intReturns, technologyID).begin();
         }
         else
         {
             // Next
-            g_intReturn_Iter[technologyID]++;
+            TM_CONTAINER(intReturn_Iter, technologyID)++;
         }
-        if( g_intReturn_Iter[technologyID]!=g_intReturns[technologyID].end() )
+        if( TM_CONTAINER(intReturn_Iter, technologyID)!=TM_CONTAINER(intReturns, technologyID).end() )
         {
-            strcpy_s((char*)paramName, bufferSize, g_intReturn_Iter[technologyID]->first.c_str());
+            strcpy_s((char*)paramName, bufferSize, TM_CONTAINER(intReturn_Iter, technologyID)->first.c_str());
             if(NULL!=paramValue)
             {
-                *paramValue = g_intReturn_Iter[technologyID]->second;
+                *paramValue = TM_CONTAINER(intReturn_Iter, technologyID)->second;
             }
             if( NULL!=unit  )
             {
                 // Get the item unit from the itemUnits container
-                g_itemUnit_Iter[technologyID] = g_itemUnits[technologyID].find(g_intReturn_Iter[technologyID]->first);
-                if( g_itemUnit_Iter[technologyID]!=g_itemUnits[technologyID].end() )
+                itemUnit_Iter = TM_CONTAINER(itemUnits, technologyID).find(TM_CONTAINER(intReturn_Iter, technologyID)->first);
+                if( itemUnit_Iter!=TM_CONTAINER(itemUnits, technologyID).end() )
                 {
-                    strcpy_s((char*)unit, unitSize, g_itemUnit_Iter[technologyID]->second.c_str());
+                    strcpy_s((char*)unit, unitSize, itemUnit_Iter->second.c_str());
                 }
             }
             if( NULL!=helpText  )
             {
                 // Get the help text from the helpText container
-                g_helpText_Iter[technologyID] = g_helpText[technologyID].find(g_intReturn_Iter[technologyID]->first);
-                if( g_helpText_Iter[technologyID]!=g_helpText[technologyID].end() )
+                helpText_Iter = TM_CONTAINER(helpText, technologyID).find(TM_CONTAINER(intReturn_Iter, technologyID)->first);
+                if( helpText_Iter!=TM_CONTAINER(helpText, technologyID).end() )
                 {
-                    strcpy_s((char*)helpText, helpTextSize, g_helpText_Iter[technologyID]->second.c_str());
+                    strcpy_s((char*)helpText, helpTextSize, helpText_Iter->second.c_str());
                 }
             }
         }
@@ -1330,42 +1131,44 @@ TM_API TM_RETURN __stdcall TM_GetIntegerParamPair(TM_ID technologyID,
                                                   int order)
 {
     TM_RETURN ret = TM_ERR_OK;
+    map <string, string>::iterator itemUnit_Iter;
+    map <string, string>::iterator helpText_Iter;
 
     if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
     {
         if( FIRST==order )
         {
             // The first time to retrieve the info
-            g_intParams_Iter[technologyID] = g_intParams[technologyID].begin();
+            TM_CONTAINER(intParams_Iter, technologyID) = TM_CONTAINER(intParams, technologyID).begin();
         }
         else
         {
             // Next
-            g_intParams_Iter[technologyID]++;
+            TM_CONTAINER(intParams_Iter, technologyID)++;
         }
-        if( g_intParams_Iter[technologyID]!=g_intParams[technologyID].end() )
+        if( TM_CONTAINER(intParams_Iter, technologyID)!=TM_CONTAINER(intParams, technologyID).end() )
         {
-            strcpy_s((char*)paramName, bufferSize, g_intParams_Iter[technologyID]->first.c_str());
+            strcpy_s((char*)paramName, bufferSize, TM_CONTAINER(intParams_Iter, technologyID)->first.c_str());
             if(NULL!=paramValue)
             {
-                *paramValue = g_intParams_Iter[technologyID]->second;
+                *paramValue = TM_CONTAINER(intParams_Iter, technologyID)->second;
             }
             if( NULL!=unit )
             {
                 // Get the item unit from the itemUnits container
-                g_itemUnit_Iter[technologyID] = g_itemUnits[technologyID].find(g_intParams_Iter[technologyID]->first);
-                if( g_itemUnit_Iter[technologyID]!=g_itemUnits[technologyID].end() )
+                itemUnit_Iter = TM_CONTAINER(itemUnits, technologyID).find(TM_CONTAINER(intParams_Iter, technologyID)->first);
+                if( itemUnit_Iter!=TM_CONTAINER(itemUnits, technologyID).end() )
                 {
-                    strcpy_s((char*)unit, unitSize, g_itemUnit_Iter[technologyID]->second.c_str());
+                    strcpy_s((char*)unit, unitSize, itemUnit_Iter->second.c_str());
                 }
             }
             if( NULL!=helpText )
             {
                 // Get the help text from the helpText container
-                g_helpText_Iter[technologyID] = g_helpText[technologyID].find(g_intParams_Iter[technologyID]->first);
-                if( g_helpText_Iter[technologyID]!=g_helpText[technologyID].end() )
+                helpText_Iter = TM_CONTAINER(helpText, technologyID).find(TM_CONTAINER(intParams_Iter, technologyID)->first);
+                if( helpText_Iter!=TM_CONTAINER(helpText, technologyID).end() )
                 {
-                    strcpy_s((char*)helpText, helpTextSize, g_helpText_Iter[technologyID]->second.c_str());
+                    strcpy_s((char*)helpText, helpTextSize, helpText_Iter->second.c_str());
                 }
             }
         }
@@ -1388,7 +1191,7 @@ TM_API TM_RETURN __stdcall TM_AddDoubleParameter(TM_ID technologyID, const TM_ST
 
     if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
     {
-        g_doubleParams[technologyID].insert( doubleParamPair(paramName, paramValue) );
+        TM_CONTAINER(doubleParams, technologyID).insert( doubleParamPair(paramName, paramValue) );
     }
     else
     {
@@ -1403,7 +1206,7 @@ TM_API TM_RETURN __stdcall TM_AddDoubleReturn(TM_ID technologyID, const TM_STR p
 
     if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
     {
-        g_doubleReturns[technologyID].insert( doubleReturnPair(paramName, paramValue) );
+        TM_CONTAINER(doubleReturns, technologyID).insert( doubleReturnPair(paramName, paramValue) );
     }
     else
     {
@@ -1420,8 +1223,8 @@ TM_API TM_RETURN __stdcall TM_SetDoubleParameter(TM_ID technologyID, const TM_ST
 
 	if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
 	{
-		doubleParam_Iter = g_doubleParams[technologyID].find(paramName);
-		if( doubleParam_Iter!=g_doubleParams[technologyID].end() )
+		doubleParam_Iter = TM_CONTAINER(doubleParams, technologyID).find(paramName);
+		if( doubleParam_Iter!=TM_CONTAINER(doubleParams, technologyID).end() )
 		{
 			doubleParam_Iter->second = paramValue;
 		}
@@ -1446,8 +1249,8 @@ TM_API TM_RETURN __stdcall TM_GetDoubleParameter(TM_ID technologyID, const TM_ST
 
     if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
     {
-        doubleParam_Iter = g_doubleParams[technologyID].find(paramName);
-        if( doubleParam_Iter!=g_doubleParams[technologyID].end() )
+        doubleParam_Iter = TM_CONTAINER(doubleParams, technologyID).find(paramName);
+        if( doubleParam_Iter!=TM_CONTAINER(doubleParams, technologyID).end() )
         {
             *paramValue = doubleParam_Iter->second;
         }
@@ -1472,8 +1275,8 @@ TM_API TM_RETURN __stdcall TM_GetDoubleReturn(TM_ID technologyID, const TM_STR p
 
     if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
     {
-        doubleReturn_Iter = g_doubleReturns[technologyID].find(paramName);
-        if( doubleReturn_Iter!=g_doubleReturns[technologyID].end() )
+        doubleReturn_Iter = TM_CONTAINER(doubleReturns, technologyID).find(paramName);
+        if( doubleReturn_Iter!=TM_CONTAINER(doubleReturns, technologyID).end() )
         {
             *paramValue = doubleReturn_Iter->second;
         }
@@ -1501,42 +1304,44 @@ TM_API TM_RETURN __stdcall TM_GetDoubleParamPair(TM_ID technologyID,
                                                  int order)
 {
     TM_RETURN ret = TM_ERR_OK;
+    map <string, string>::iterator itemUnit_Iter;
+    map <string, string>::iterator helpText_Iter;
 
     if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
     {
         if( FIRST==order )
         {
             // The first time to retrieve the info
-            g_doubleParam_Iter[technologyID] = g_doubleParams[technologyID].begin();
+            TM_CONTAINER(doubleParam_Iter, technologyID) = TM_CONTAINER(doubleParams, technologyID).begin();
         }
         else
         {
             // Next
-            g_doubleParam_Iter[technologyID]++;
+            TM_CONTAINER(doubleParam_Iter, technologyID)++;
         }
-        if( g_doubleParam_Iter[technologyID]!=g_doubleParams[technologyID].end() )
+        if( TM_CONTAINER(doubleParam_Iter, technologyID)!=TM_CONTAINER(doubleParams, technologyID).end() )
         {
-            strcpy_s((char*)paramName, bufferSize, g_doubleParam_Iter[technologyID]->first.c_str());
+            strcpy_s((char*)paramName, bufferSize, TM_CONTAINER(doubleParam_Iter, technologyID)->first.c_str());
             if(NULL!=paramValue)
             {
-                *paramValue = g_doubleParam_Iter[technologyID]->second;
+                *paramValue = TM_CONTAINER(doubleParam_Iter, technologyID)->second;
             }
             if( NULL!=unit )
             {
                 // Get the item unit from the itemUnits container
-                g_itemUnit_Iter[technologyID] = g_itemUnits[technologyID].find(g_doubleParam_Iter[technologyID]->first);
-                if( g_itemUnit_Iter[technologyID]!=g_itemUnits[technologyID].end() )
+                itemUnit_Iter = TM_CONTAINER(itemUnits, technologyID).find(TM_CONTAINER(doubleParam_Iter, technologyID)->first);
+                if( itemUnit_Iter!=TM_CONTAINER(itemUnits, technologyID).end() )
                 {
-                    strcpy_s((char*)unit, unitSize, g_itemUnit_Iter[technologyID]->second.c_str());
+                    strcpy_s((char*)unit, unitSize, itemUnit_Iter->second.c_str());
                 }
             }
             if( NULL!=helpText )
             {
                 // Get the help text from the helpText container
-                g_helpText_Iter[technologyID] = g_helpText[technologyID].find(g_doubleParam_Iter[technologyID]->first);
-                if( g_helpText_Iter[technologyID]!=g_helpText[technologyID].end() )
+                helpText_Iter = TM_CONTAINER(helpText, technologyID).find(TM_CONTAINER(doubleParam_Iter, technologyID)->first);
+                if( helpText_Iter!=TM_CONTAINER(helpText, technologyID).end() )
                 {
-                    strcpy_s((char*)helpText, helpTextSize, g_helpText_Iter[technologyID]->second.c_str());
+                    strcpy_s((char*)helpText, helpTextSize, helpText_Iter->second.c_str());
                 }
             }
         }
@@ -1564,42 +1369,44 @@ TM_API TM_RETURN __stdcall TM_GetDoubleReturnPair(TM_ID technologyID,
                                          int order)
 {
     TM_RETURN ret = TM_ERR_OK;
+    map <string, string>::iterator itemUnit_Iter;
+    map <string, string>::iterator helpText_Iter;
 
     if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
     {
         if( FIRST==order )
         {
             // The first time to retrieve the info
-            g_doubleReturn_Iter[technologyID] = g_doubleReturns[technologyID].begin();
+            TM_CONTAINER(doubleReturn_Iter, technologyID) = TM_CONTAINER(doubleReturns, technologyID).begin();
         }
         else
         {
             // Next
-            g_doubleReturn_Iter[technologyID]++;
+            TM_CONTAINER(doubleReturn_Iter, technologyID)++;
         }
-        if( g_doubleReturn_Iter[technologyID]!=g_doubleReturns[technologyID].end() )
+        if( TM_CONTAINER(doubleReturn_Iter, technologyID)!=TM_CONTAINER(doubleReturns, technologyID).end() )
         {
-            strcpy_s((char*)paramName, bufferSize, g_doubleReturn_Iter[technologyID]->first.c_str());
+            strcpy_s((char*)paramName, bufferSize, TM_CONTAINER(doubleReturn_Iter, technologyID)->first.c_str());
             if(NULL!=paramValue)
             {
-                *paramValue = g_doubleReturn_Iter[technologyID]->second;
+                *paramValue = TM_CONTAINER(doubleReturn_Iter, technologyID)->second;
             }
             if( NULL!=unit  )
             {
                 // Get the item unit from the itemUnits container
-                g_itemUnit_Iter[technologyID] = g_itemUnits[technologyID].find(g_doubleReturn_Iter[technologyID]->first);
-                if( g_itemUnit_Iter[technologyID]!=g_itemUnits[technologyID].end() )
+                itemUnit_Iter = TM_CONTAINER(itemUnits, technologyID).find(TM_CONTAINER(doubleReturn_Iter, technologyID)->first);
+                if( itemUnit_Iter!=TM_CONTAINER(itemUnits, technologyID).end() )
                 {
-                    strcpy_s((char*)unit, unitSize, g_itemUnit_Iter[technologyID]->second.c_str());
+                    strcpy_s((char*)unit, unitSize, itemUnit_Iter->second.c_str());
                 }
             }
             if( NULL!=helpText  )
             {
                 // Get the help text from the helpText container
-                g_helpText_Iter[technologyID] = g_helpText[technologyID].find(g_doubleReturn_Iter[technologyID]->first);
-                if( g_helpText_Iter[technologyID]!=g_helpText[technologyID].end() )
+                helpText_Iter = TM_CONTAINER(helpText, technologyID).find(TM_CONTAINER(doubleReturn_Iter, technologyID)->first);
+                if( helpText_Iter!=TM_CONTAINER(helpText, technologyID).end() )
                 {
-                    strcpy_s((char*)helpText, helpTextSize, g_helpText_Iter[technologyID]->second.c_str());
+                    strcpy_s((char*)helpText, helpTextSize, helpText_Iter->second.c_str());
                 }
             }
         }
@@ -1622,7 +1429,7 @@ TM_API TM_RETURN __stdcall TM_AddStringParameter(TM_ID technologyID, const TM_ST
 
     if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
     {
-        g_stringParams[technologyID].insert( stringParamPair(paramName, paramValue) );
+        TM_CONTAINER(stringParams, technologyID).insert( stringParamPair(paramName, paramValue) );
     }
     else
     {
@@ -1637,7 +1444,7 @@ TM_API TM_RETURN __stdcall TM_AddStringReturn(TM_ID technologyID, const TM_STR p
 
     if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
     {
-        g_stringReturns[technologyID].insert( stringReturnPair(paramName, paramValue) );
+        TM_CONTAINER(stringReturns, technologyID).insert( stringReturnPair(paramName, paramValue) );
     }
     else
     {
@@ -1659,12 +1466,12 @@ TM_API TM_RETURN __stdcall TM_AddArrayDoubleReturn(TM_ID technologyID, const TM_
             {
                 arrayDouble.push_back( paramValue[i] );
             }
-            g_arrayDoubleReturns[technologyID].insert( arrayDoubleReturnPair(paramName, arrayDouble) );
+            TM_CONTAINER(arrayDoubleReturns, technologyID).insert( arrayDoubleReturnPair(paramName, arrayDouble) );
         }
         else
         {
             vector<double> arrayDouble;
-            g_arrayDoubleReturns[technologyID].insert( arrayDoubleReturnPair(paramName, arrayDouble) );
+            TM_CONTAINER(arrayDoubleReturns, technologyID).insert( arrayDoubleReturnPair(paramName, arrayDouble) );
         
         }
     }
@@ -1681,7 +1488,7 @@ TM_API TM_RETURN __stdcall TM_AddUnitReturn(TM_ID technologyID, const TM_STR par
 
     if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
     {
-        g_itemUnits[technologyID].insert( pair<string,string>(paramName, unit) );
+        TM_CONTAINER(itemUnits, technologyID).insert( pair<string,string>(paramName, unit) );
     }
     else
     {
@@ -1698,8 +1505,8 @@ TM_API TM_RETURN __stdcall TM_GetUnitReturn(TM_ID technologyID, const TM_STR par
 
     if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
     {
-        stringParam_Iter = g_itemUnits[technologyID].find(paramName);
-        if( stringParam_Iter!=g_itemUnits[technologyID].end() )
+        stringParam_Iter = TM_CONTAINER(itemUnits, technologyID).find(paramName);
+        if( stringParam_Iter!=TM_CONTAINER(itemUnits, technologyID).end() )
         {
             strcpy_s(unitValue, bufferSize, stringParam_Iter->second.c_str()); 
         }
@@ -1722,7 +1529,7 @@ TM_API TM_RETURN __stdcall TM_AddHelpTextReturn(TM_ID technologyID, const TM_STR
 
     if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
     {
-        g_helpText[technologyID].insert( pair<string,string>(paramName, help) );
+        TM_CONTAINER(helpText, technologyID).insert( pair<string,string>(paramName, help) );
     }
     else
     {
@@ -1739,8 +1546,8 @@ TM_API TM_RETURN __stdcall TM_GetStringParameter(TM_ID technologyID, const TM_ST
 
     if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
     {
-        stringParam_Iter = g_stringParams[technologyID].find(paramName);
-        if( stringParam_Iter!=g_stringParams[technologyID].end() )
+        stringParam_Iter = TM_CONTAINER(stringParams, technologyID).find(paramName);
+        if( stringParam_Iter!=TM_CONTAINER(stringParams, technologyID).end() )
         {
             strcpy_s(paramValue, bufferSize, stringParam_Iter->second.c_str()); 
         }
@@ -1769,8 +1576,8 @@ TM_API TM_RETURN __stdcall TM_GetStringReturn(TM_ID technologyID, const TM_STR p
     }
     if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
     {
-        stringReturn_Iter = g_stringReturns[technologyID].find(paramName);
-        if( stringReturn_Iter!=g_stringReturns[technologyID].end() )
+        stringReturn_Iter = TM_CONTAINER(stringReturns, technologyID).find(paramName);
+        if( stringReturn_Iter!=TM_CONTAINER(stringReturns, technologyID).end() )
         {
             //paramValue = (TM_STR)reinterpret_cast<const char *>(stringReturn_Iter->second.c_str());
             strcpy_s(paramValue, bufferSize, stringReturn_Iter->second.c_str());
@@ -1797,8 +1604,8 @@ TM_API TM_RETURN __stdcall TM_GetArrayDoubleReturnSize(TM_ID technologyID, const
 
     if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
     {
-        arrayDoubleReturn_Iter = g_arrayDoubleReturns[technologyID].find(paramName);
-        if( arrayDoubleReturn_Iter!=g_arrayDoubleReturns[technologyID].end() )
+        arrayDoubleReturn_Iter = TM_CONTAINER(arrayDoubleReturns, technologyID).find(paramName);
+        if( arrayDoubleReturn_Iter!=TM_CONTAINER(arrayDoubleReturns, technologyID).end() )
         {
 			*arraySize = (int) arrayDoubleReturn_Iter->second.size();
         }
@@ -1831,8 +1638,8 @@ TM_API TM_RETURN __stdcall TM_GetArrayDoubleReturn(TM_ID technologyID, const TM_
     //}
     if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
     {
-        arrayDoubleReturn_Iter = g_arrayDoubleReturns[technologyID].find(paramName);
-        if( arrayDoubleReturn_Iter!=g_arrayDoubleReturns[technologyID].end() )
+        arrayDoubleReturn_Iter = TM_CONTAINER(arrayDoubleReturns, technologyID).find(paramName);
+        if( arrayDoubleReturn_Iter!=TM_CONTAINER(arrayDoubleReturns, technologyID).end() )
         {
             for(int i=0; i<min(arraySize,(int)arrayDoubleReturn_Iter->second.size()); i++)
             {
@@ -1864,42 +1671,44 @@ TM_API TM_RETURN __stdcall TM_GetStringParamPair(TM_ID technologyID,
                                                  int order)
 {
     TM_RETURN ret = TM_ERR_OK;
+    map <string, string>::iterator itemUnit_Iter;
+    map <string, string>::iterator helpText_Iter;
 
     if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
     {
         if( FIRST==order )
         {
             // The first time to retrieve the info
-            g_stringParam_Iter[technologyID] = g_stringParams[technologyID].begin();
+            TM_CONTAINER(stringParam_Iter, technologyID) = TM_CONTAINER(stringParams, technologyID).begin();
         }
         else
         {
             // Next
-            g_stringParam_Iter[technologyID]++;
+            TM_CONTAINER(stringParam_Iter, technologyID)++;
         }
-        if( g_stringParam_Iter[technologyID]!=g_stringParams[technologyID].end() )
+        if( TM_CONTAINER(stringParam_Iter, technologyID)!=TM_CONTAINER(stringParams, technologyID).end() )
         {
-            strcpy_s((char*)paramName, bufferSize, g_stringParam_Iter[technologyID]->first.c_str());
+            strcpy_s((char*)paramName, bufferSize, TM_CONTAINER(stringParam_Iter, technologyID)->first.c_str());
             if(NULL!=paramValue)
             {
-                strcpy_s((char*)paramValue, paramValueBufferSize, g_stringParam_Iter[technologyID]->second.c_str());
+                strcpy_s((char*)paramValue, paramValueBufferSize, TM_CONTAINER(stringParam_Iter, technologyID)->second.c_str());
             }
             if( NULL!=unit )
             {
                 // Get the item unit from the itemUnits container
-                g_itemUnit_Iter[technologyID] = g_itemUnits[technologyID].find(g_stringParam_Iter[technologyID]->first);
-                if( g_itemUnit_Iter[technologyID]!=g_itemUnits[technologyID].end() )
+                itemUnit_Iter = TM_CONTAINER(itemUnits, technologyID).find(TM_CONTAINER(stringParam_Iter, technologyID)->first);
+                if( itemUnit_Iter!=TM_CONTAINER(itemUnits, technologyID).end() )
                 {
-                    strcpy_s((char*)unit, unitSize, g_itemUnit_Iter[technologyID]->second.c_str());
+                    strcpy_s((char*)unit, unitSize, itemUnit_Iter->second.c_str());
                 }
             }
             if( NULL!=helpText )
             {
                 // Get the help text from the helpText container
-                g_helpText_Iter[technologyID] = g_helpText[technologyID].find(g_stringParam_Iter[technologyID]->first);
-                if( g_helpText_Iter[technologyID]!=g_helpText[technologyID].end() )
+                helpText_Iter = TM_CONTAINER(helpText, technologyID).find(TM_CONTAINER(stringParam_Iter, technologyID)->first);
+                if( helpText_Iter!=TM_CONTAINER(helpText, technologyID).end() )
                 {
-                    strcpy_s((char*)helpText, helpTextSize, g_helpText_Iter[technologyID]->second.c_str());
+                    strcpy_s((char*)helpText, helpTextSize, helpText_Iter->second.c_str());
                 }
             }
         }
@@ -1928,42 +1737,44 @@ TM_API TM_RETURN __stdcall TM_GetStringReturnPair(TM_ID technologyID,
                                         int order)
 {
     TM_RETURN ret = TM_ERR_OK;
+    map <string, string>::iterator itemUnit_Iter;
+    map <string, string>::iterator helpText_Iter;
 
     if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
     {
         if( FIRST==order )
         {
             // The first time to retrieve the info
-            g_stringReturn_Iter[technologyID] = g_stringReturns[technologyID].begin();
+            TM_CONTAINER(stringReturn_Iter, technologyID) = TM_CONTAINER(stringReturns, technologyID).begin();
         }
         else
         {
             // Next
-            g_stringReturn_Iter[technologyID]++;
+            TM_CONTAINER(stringReturn_Iter, technologyID)++;
         }
-        if( g_stringReturn_Iter[technologyID]!=g_stringReturns[technologyID].end() )
+        if( TM_CONTAINER(stringReturn_Iter, technologyID)!=TM_CONTAINER(stringReturns, technologyID).end() )
         {
-            strcpy_s((char*)paramName, bufferSize, g_stringReturn_Iter[technologyID]->first.c_str());
+            strcpy_s((char*)paramName, bufferSize, TM_CONTAINER(stringReturn_Iter, technologyID)->first.c_str());
             if(NULL!=paramValue)
             {
-                strcpy_s((char*)paramValue, paramValueBufferSize, g_stringReturn_Iter[technologyID]->second.c_str());
+                strcpy_s((char*)paramValue, paramValueBufferSize, TM_CONTAINER(stringReturn_Iter, technologyID)->second.c_str());
             }
             if( NULL!=unit  )
             {
                 // Get the item unit from the itemUnits container
-                g_itemUnit_Iter[technologyID] = g_itemUnits[technologyID].find(g_stringReturn_Iter[technologyID]->first);
-                if( g_itemUnit_Iter[technologyID]!=g_itemUnits[technologyID].end() )
+                itemUnit_Iter = TM_CONTAINER(itemUnits, technologyID).find(TM_CONTAINER(stringReturn_Iter, technologyID)->first);
+                if( itemUnit_Iter!=TM_CONTAINER(itemUnits, technologyID).end() )
                 {
-                    strcpy_s((char*)unit, unitSize, g_itemUnit_Iter[technologyID]->second.c_str());
+                    strcpy_s((char*)unit, unitSize, itemUnit_Iter->second.c_str());
                 }
             }
             if( NULL!=helpText  )
             {
                 // Get the help text from the helpText container
-                g_helpText_Iter[technologyID] = g_helpText[technologyID].find(g_stringReturn_Iter[technologyID]->first);
-                if( g_helpText_Iter[technologyID]!=g_helpText[technologyID].end() )
+                helpText_Iter = TM_CONTAINER(helpText, technologyID).find(TM_CONTAINER(stringReturn_Iter, technologyID)->first);
+                if( helpText_Iter!=TM_CONTAINER(helpText, technologyID).end() )
                 {
-                    strcpy_s((char*)helpText, helpTextSize, g_helpText_Iter[technologyID]->second.c_str());
+                    strcpy_s((char*)helpText, helpTextSize, helpText_Iter->second.c_str());
                 }
             }
         }
@@ -1991,42 +1802,44 @@ TM_API TM_RETURN __stdcall TM_GetArrayDoubleReturnPair(TM_ID technologyID,
                                         int order)
 {
     TM_RETURN ret = TM_ERR_OK;
+    map <string, string>::iterator itemUnit_Iter;
+    map <string, string>::iterator helpText_Iter;
 
     if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
     {
         if( FIRST==order )
         {
             // The first time to retrieve the info
-            g_arrayDoubleReturn_Iter[technologyID] = g_arrayDoubleReturns[technologyID].begin();
+            TM_CONTAINER(arrayDoubleReturn_Iter, technologyID) = TM_CONTAINER(arrayDoubleReturns, technologyID).begin();
         }
         else
         {
             // Next
-            g_arrayDoubleReturn_Iter[technologyID]++;
+            TM_CONTAINER(arrayDoubleReturn_Iter, technologyID)++;
         }
-        if( g_arrayDoubleReturn_Iter[technologyID]!=g_arrayDoubleReturns[technologyID].end() )
+        if( TM_CONTAINER(arrayDoubleReturn_Iter, technologyID)!=TM_CONTAINER(arrayDoubleReturns, technologyID).end() )
         {
-            strcpy_s((char*)paramName, bufferSize, g_arrayDoubleReturn_Iter[technologyID]->first.c_str());
+            strcpy_s((char*)paramName, bufferSize, TM_CONTAINER(arrayDoubleReturn_Iter, technologyID)->first.c_str());
             if(NULL!=paramValue)
             {
-                *paramValue = g_arrayDoubleReturn_Iter[technologyID]->second.size();
+                *paramValue = TM_CONTAINER(arrayDoubleReturn_Iter, technologyID)->second.size();
             }
             if( NULL!=unit  )
             {
                 // Get the item unit from the itemUnits container
-                g_itemUnit_Iter[technologyID] = g_itemUnits[technologyID].find(g_arrayDoubleReturn_Iter[technologyID]->first);
-                if( g_itemUnit_Iter[technologyID]!=g_itemUnits[technologyID].end() )
+                itemUnit_Iter = TM_CONTAINER(itemUnits, technologyID).find(TM_CONTAINER(arrayDoubleReturn_Iter, technologyID)->first);
+                if( itemUnit_Iter!=TM_CONTAINER(itemUnits, technologyID).end() )
                 {
-                    strcpy_s((char*)unit, unitSize, g_itemUnit_Iter[technologyID]->second.c_str());
+                    strcpy_s((char*)unit, unitSize, itemUnit_Iter->second.c_str());
                 }
             }
             if( NULL!=helpText  )
             {
                 // Get the help text from the helpText container
-                g_helpText_Iter[technologyID] = g_helpText[technologyID].find(g_arrayDoubleReturn_Iter[technologyID]->first);
-                if( g_helpText_Iter[technologyID]!=g_helpText[technologyID].end() )
+                helpText_Iter = TM_CONTAINER(helpText, technologyID).find(TM_CONTAINER(arrayDoubleReturn_Iter, technologyID)->first);
+                if( helpText_Iter!=TM_CONTAINER(helpText, technologyID).end() )
                 {
-                    strcpy_s((char*)helpText, helpTextSize, g_helpText_Iter[technologyID]->second.c_str());
+                    strcpy_s((char*)helpText, helpTextSize, helpText_Iter->second.c_str());
                 }
             }
         }
@@ -2059,14 +1872,29 @@ TM_API TM_RETURN __stdcall TM_Run(TM_ID technologyID, const TM_STR functionKeywo
 
         if( function_Iter!=g_testFunctions[technologyID].end() )
         {
-            if( NULL!=function_Iter->second.pointerToFunction )
+            string adaptiveReason;
+            if( NULL!=function_Iter->second.pointerToFunction && Adaptive_Skip(technologyID, functionKeyword, adaptiveReason) )
+            {
+                // Low-risk item, sampled on 1 of N units; the station reads the reason from ADAPTIVE_SKIPPED
+                ::TM_ClearReturns( technologyID );
+                ::TM_AddStringReturn( technologyID, "ADAPTIVE_SKIPPED", (TM_STR)adaptiveReason.c_str() );
+                ::LOGGER_Write_Ext(LOG_IQLITE_TM, g_tmLoggerID[technologyID], LOGGER_INFORMATION, "\n[ TM ]=>TM_Run[%s] skipped, %s\n", functionKeyword, adaptiveReason.c_str());
+                ret = TM_ERR_ADAPTIVE_SKIPPED;
+            }
+            else if( NULL!=function_Iter->second.pointerToFunction )
             {
+                // The DUT is not shared with the look-ahead function of the previous item
+                LookAhead_Wait( technologyID );
+
                 // Start Timer
 				::TIMER_StartTimer(g_tmTimerID[technologyID], functionKeyword);
 				::LOGGER_Write_Ext(LOG_IQLITE_TM, g_tmLoggerID[technologyID], LOGGER_INFORMATION, "\n[ TM ]=>TM_Run[%s]\n", functionKeyword);
 
 				LogTestInputParameters( technologyID, functionKeyword );
 
+				// Allocations of the test function are filed under its keyword, if TM_AllocProfilerStart() was called
+				AllocProfiler_BeginRun( technologyID, functionKeyword );
+
                 if( 0==function_Iter->second.pointerToFunction() )
                 {
                     // DUT function ran OK
@@ -2078,6 +1906,8 @@ TM_API TM_RETURN __stdcall TM_Run(TM_ID technologyID, const TM_STR functionKeywo
                     // Option 1: to insert a string message before returing
                     ret = TM_ERR_FUNCTION_ERROR;
                 }
+
+				AllocProfiler_EndRun();
                 
 				LogTestResults( technologyID, functionKeyword );
 
@@ -2085,6 +1915,17 @@ TM_API TM_RETURN __stdcall TM_Run(TM_ID technologyID, const TM_STR functionKeywo
 				::TIMER_StopTimer(g_tmTimerID[technologyID], functionKeyword, &durationInMiniSec);
 				// Save to log
 				::LOGGER_Write_Ext(LOG_IQLITE_TM, g_tmLoggerID[technologyID], LOGGER_INFORMATION, "[ TM ]=>[%s],%.2f,ms\n", functionKeyword, durationInMiniSec);
+				// Save to result file, if TM_ResultSinkOpen() was called
+				ResultSink_Record( technologyID, functionKeyword, ret, durationInMiniSec, g_dutInfo.sSerialNumber );
+				// Update the statistics, if TM_AdaptiveOpen() was called
+				if ( Adaptive_Record( technologyID, functionKeyword, ret, adaptiveReason ) )
+				{
+					::LOGGER_Write_Ext(LOG_IQLITE_TM, g_tmLoggerID[technologyID], LOGGER_INFORMATION, "[ TM ]=>[%s] full coverage restored, %s\n", functionKeyword, adaptiveReason.c_str());
+				}
+				else
+				{
+					// do nothing
+				}
 
             }
             else
@@ -2424,16 +2265,13 @@ TM_API TM_RETURN __stdcall TM_WiFiConvertFrequencyToChannel(int freq, int* chann
 {
     TM_RETURN ret = TM_ERR_OK;
 
-    map <int, int>::iterator channel_Iter;
-
-    channel_Iter = wifiChannels.find(freq);
-    if( channel_Iter!=wifiChannels.end() )
+    if( !WiFiChannel_FreqToChannel(freq, channel) )
     {
-        *channel = channel_Iter->second;
+        *channel = (int)NA_NUMBER;	//ret = TM_ERR_WIFI_FREQ_DOES_NOT_EXIST;
     }
     else
     {
-        *channel = (int)NA_NUMBER;	//ret = TM_ERR_WIFI_FREQ_DOES_NOT_EXIST;
+        // do nothing
     }
 
     return ret;
@@ -2443,30 +2281,13 @@ TM_API TM_RETURN __stdcall TM_WiFiConvertChannelToFrequency(int channel, int *fr
 {
     TM_RETURN ret = TM_ERR_OK;
 
-    map <int, int>::iterator freq_Iter;
-
-    freq_Iter = wifiChannels.begin();
-    if( freq_Iter!=wifiChannels.end() )
+    if( !WiFiChannel_ChannelToFreq(channel, freq) )
     {
-        while( freq_Iter!=wifiChannels.end() )
-        {
-            if ( channel==freq_Iter->second )
-            {
-                *freq = freq_Iter->first;
-                ret = TM_ERR_OK;
-                break;
-            }
-            else
-            {                
-                // keep searching...
-                freq_Iter++;
-                ret = TM_ERR_WIFI_FREQ_DOES_NOT_EXIST;
-            }
-        }
+        ret = TM_ERR_WIFI_FREQ_DOES_NOT_EXIST;
     }
     else
     {
-        ret = TM_ERR_WIFI_FREQ_DOES_NOT_EXIST;
+        // do nothing
     }
 
     return ret;
@@ -2476,12 +2297,10 @@ TM_API TM_RETURN __stdcall TM_WiFiConvertDataRateNameToIndex(TM_STR name, int* i
 {
     TM_RETURN ret = TM_ERR_OK;
 
-    map <string, int>::iterator dataRate_Iter;
-
-    dataRate_Iter = wifiDataRates.find(name);
-    if( dataRate_Iter!=wifiDataRates.end() )
+    const WIFI_RATE_DESCRIPTOR *rate = WiFiRate_FindByName(name);
+    if( NULL!=rate && WIFI_RATE_BT!=rate->family )
     {
-        *index = dataRate_Iter->second;
+        *index = rate->index;
     }
     else
     {
@@ -2494,23 +2313,13 @@ TM_API TM_RETURN __stdcall TM_WiFiConvertDataRateNameToIndex(TM_STR name, int* i
 TM_API TM_RETURN __stdcall TM_WiFiConvertIndexToDataRateName(int index, TM_STR name, int nameTextSize)
 {
     TM_RETURN ret = TM_ERR_OK;
-    bool keyWordFound = false;
-
-    map <string, int>::iterator dataRate_Iter;
 
-    dataRate_Iter = wifiDataRates.begin();
-    while( dataRate_Iter != wifiDataRates.end() )
+    const WIFI_RATE_DESCRIPTOR *rate = WiFiRate_FindByIndex(index);
+    if( NULL!=rate && WIFI_RATE_BT!=rate->family )
     {
-        if (index == dataRate_Iter->second)
-        {
-            strcpy_s(name, nameTextSize, dataRate_Iter->first.c_str()); 
-            keyWordFound = true;
-            break;
-        }
-        dataRate_Iter++;
+        strcpy_s(name, nameTextSize, rate->name);
     }
-    
-    if (keyWordFound == false)
+    else
     {
         ret = TM_ERR_WIFI_FREQ_DOES_NOT_EXIST;
     }
@@ -2522,16 +2331,13 @@ TM_API TM_RETURN __stdcall TM_WiFiConvertDataRateNameToMbps(TM_STR name, double*
 {
     TM_RETURN ret = TM_ERR_OK;
 
-    map <string, double>::iterator dataRateMbps_Iter;
-
-    dataRateMbps_Iter = wifiDataRatesMbps.find(name);
-    if( dataRateMbps_Iter!=wifiDataRatesMbps.end() )
+    if( !WiFiRate_GetMbps(name, dataRateMbps) )
     {
-        *dataRateMbps = dataRateMbps_Iter->second;
+        ret = TM_ERR_WIFI_FREQ_DOES_NOT_EXIST;
     }
     else
     {
-        ret = TM_ERR_WIFI_FREQ_DOES_NOT_EXIST;
+        // do nothing
     }
 
     return ret;
@@ -2541,12 +2347,10 @@ TM_API TM_RETURN __stdcall TM_WiFiConvertDataRateNameToIQ2010ExtIndex(TM_STR nam
 {
     TM_RETURN ret = TM_ERR_OK;
 
-    map <string, int>::iterator dataRateIQ2010Ext_Iter;
-
-    dataRateIQ2010Ext_Iter = dataRateIQ2010Ext.find(name);
-    if( dataRateIQ2010Ext_Iter!=dataRateIQ2010Ext.end() )
+    const WIFI_RATE_DESCRIPTOR *rate = WiFiRate_FindByName(name);
+    if( NULL!=rate && -1!=rate->iq2010ExtIndex )
     {
-        *dataRateIndex = dataRateIQ2010Ext_Iter->second;
+        *dataRateIndex = rate->iq2010ExtIndex;
     }
     else
     {
@@ -3118,8 +2922,8 @@ TM_API TM_RETURN __stdcall TM_ApplyDataRateMeasTypeReturn(TM_ID technologyID, co
             }
         }
 
-        seqDataRateResults_Iter = g_seqDataRateResults[technologyID].find(dataRate);
-        if(seqDataRateResults_Iter != g_seqDataRateResults[technologyID].end())
+        seqDataRateResults_Iter = TM_CONTAINER(seqDataRateResults, technologyID).find(dataRate);
+        if(seqDataRateResults_Iter != TM_CONTAINER(seqDataRateResults, technologyID).end())
         {
             seqMeasTypeResults_Iter = seqDataRateResults_Iter->second.find(measType);
             if (seqMeasTypeResults_Iter != seqDataRateResults_Iter->second.end())
@@ -3136,7 +2940,7 @@ TM_API TM_RETURN __stdcall TM_ApplyDataRateMeasTypeReturn(TM_ID technologyID, co
         {
             seqMeasResults.insert(seqMeasParamReturnPair(paramName, seqReturnValues));
             seqMeasTypeResults.insert(seqMeasTypeResultsPair(measType, seqMeasResults));
-            g_seqDataRateResults[technologyID].insert(pair<string, SEQ_MEAS_TYPE_RESULTS>(dataRate,seqMeasTypeResults));
+            TM_CONTAINER(seqDataRateResults, technologyID).insert(pair<string, SEQ_MEAS_TYPE_RESULTS>(dataRate,seqMeasTypeResults));
         }
     }
     else
@@ -3150,13 +2954,13 @@ TM_API TM_RETURN __stdcall TM_ApplyDataRateMeasTypeReturn(TM_ID technologyID, co
 TM_API TM_RETURN __stdcall TM_GetSeqDataRateReturn(TM_ID technologyID, int *numOfDataRate, TM_STR *dataRateList)
 {
     TM_RETURN ret = TM_ERR_OK;
-    map<string, SEQ_MEAS_TYPE_RESULTS>::iterator seqDataRateResults_Iter = g_seqDataRateResults[technologyID].begin();
+    map<string, SEQ_MEAS_TYPE_RESULTS>::iterator seqDataRateResults_Iter = TM_CONTAINER(seqDataRateResults, technologyID).begin();
     
-    *numOfDataRate = (int)g_seqDataRateResults[technologyID].size();
+    *numOfDataRate = (int)TM_CONTAINER(seqDataRateResults, technologyID).size();
 
     if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
     {
-        while(seqDataRateResults_Iter != g_seqDataRateResults[technologyID].end())
+        while(seqDataRateResults_Iter != TM_CONTAINER(seqDataRateResults, technologyID).end())
         {
             *dataRateList = (TM_STR)seqDataRateResults_Iter->first.c_str();
             dataRateList ++;
@@ -3179,8 +2983,8 @@ TM_API TM_RETURN __stdcall TM_GetSeqOneDataRateMeasTypeReturn(TM_ID technologyID
     if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
     {  
 
-        seqDataRateResults_Iter = g_seqDataRateResults[technologyID].find(dataRate);
-        if(seqDataRateResults_Iter != g_seqDataRateResults[technologyID].end())
+        seqDataRateResults_Iter = TM_CONTAINER(seqDataRateResults, technologyID).find(dataRate);
+        if(seqDataRateResults_Iter != TM_CONTAINER(seqDataRateResults, technologyID).end())
         {
             seqMeasTypeResults_Iter = seqDataRateResults_Iter->second.begin();
             *numOfMeasType = (int)seqDataRateResults_Iter->second.size();
@@ -3214,8 +3018,8 @@ TM_API TM_RETURN __stdcall TM_GetSeqOneMeasTypeReturn(TM_ID technologyID, const
 
     if( technologyID>-1 && technologyID<MAX_TECHNOLOGY_NUM )
     {  
-        seqDataRateResults_Iter = g_seqDataRateResults[technologyID].find(dataRate);
-        if(seqDataRateResults_Iter != g_seqDataRateResults[technologyID].end())
+        seqDataRateResults_Iter = TM_CONTAINER(seqDataRateResults, technologyID).find(dataRate);
+        if(seqDataRateResults_Iter != TM_CONTAINER(seqDataRateResults, technologyID).end())
         {
             seqMeasTypeResults_Iter = seqDataRateResults_Iter->second.find(measType);
             if (seqMeasTypeResults_Iter != seqDataRateResults_Iter->second.end())
@@ -3261,10 +3065,12 @@ void LogTestInputParameters( TM_ID technologyID, const TM_STR functionKeyword)
         && TM_ERR_OK != TM_GetIntegerParameter( technologyID, "QUERY_RETURN", &dummyValue )
         && technologyID != IQREPORT )
     {
+        EnterCriticalSection(&g_reportLock);
         ::TM_ClearParameters( IQREPORT );
         ::TM_AddIntegerParameter( IQREPORT, "TECHNOLOGY_ID", technologyID );
         ::TM_AddStringParameter( IQREPORT, "FUNCTION_KEYWORD", functionKeyword );
         ::TM_Run( IQREPORT, "REPORT_INPUT" );
+        LeaveCriticalSection(&g_reportLock);
     }
 }
 
@@ -3276,10 +3082,12 @@ void LogTestResults( TM_ID technologyID, const TM_STR functionKeyword )
         && TM_ERR_OK != TM_GetIntegerParameter( technologyID, "QUERY_RETURN", &dummyValue )
         && technologyID != IQREPORT )
     {
+        EnterCriticalSection(&g_reportLock);
         ::TM_ClearParameters( IQREPORT );
         ::TM_AddIntegerParameter( IQREPORT, "TECHNOLOGY_ID", technologyID );
         ::TM_AddStringParameter( IQREPORT, "FUNCTION_KEYWORD", functionKeyword );
         ::TM_Run( IQREPORT, "REPORT_RESULT" );
+        LeaveCriticalSection(&g_reportLock);
 
     }
 }
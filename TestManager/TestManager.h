@@ -264,10 +264,54 @@ typedef enum TM_EC
     TM_ERR_FAILED_TO_OPEN_FILE,                   /*!< Failed to open file*/
     TM_ERR_DATARATE_DOES_NOT_EXIST,           /*!< The specified parameter does not exist*/
     TM_ERR_MEAS_TYPE_DOES_NOT_EXIST,            /*!< The specified measurement type does not exist*/
+    TM_ERR_INVALID_HANDLE,                      /*!< The specified TM_RunAsync() handle does not exist*/
+    TM_ERR_TIMEOUT,                             /*!< The TM_RunAsync() job did not complete in time*/
+    TM_ERR_ADAPTIVE_SKIPPED,                    /*!< The test item is skipped on this unit by the adaptive test policy*/
+    TM_ERR_BUFFER_TOO_SMALL,                    /*!< The buffer is too small, or not a valid TM_ExportReturns() layout*/
 
     TM_ERR_MAXIMUM_NUM              
 } TM_RETURN;
 
+typedef int TM_ASYNC_HANDLE;    /*!< Handle of a TM_RunAsync() job*/
+
+#ifndef TM_ASYNC_INFINITE
+    #define TM_ASYNC_INFINITE -1
+#endif
+
+//! Completion callback of TM_RunAsync(), called on the worker thread
+typedef void (__stdcall *TM_ASYNC_CALLBACK)(TM_ASYNC_HANDLE handle, TM_RETURN tmReturn, void *userData);
+
+#define TM_EXPORT_VERSION   1
+
+//! Value type of a TM_EXPORT_ENTRY
+typedef enum tagTmExportType
+{
+    TM_EXPORT_INTEGER = 1,      /*!< int at valueOffset*/
+    TM_EXPORT_DOUBLE,           /*!< double at valueOffset*/
+    TM_EXPORT_STRING,           /*!< '\0' terminated string at valueOffset*/
+    TM_EXPORT_ARRAY_DOUBLE      /*!< valueCount doubles at valueOffset*/
+} TM_EXPORT_TYPE;
+
+//! Start of a TM_ExportReturns() buffer, followed by entryCount TM_EXPORT_ENTRY
+typedef struct tagTmExportHeader
+{
+    int     version;            /*!< TM_EXPORT_VERSION*/
+    int     totalSize;          /*!< Bytes used in the buffer, header included*/
+    int     entryCount;
+    int     reserved;
+} TM_EXPORT_HEADER;
+
+//! One item of a TM_ExportReturns() buffer; offsets are in bytes from the start of the buffer, 0 if not present
+typedef struct tagTmExportEntry
+{
+    int     type;               /*!< TM_EXPORT_TYPE*/
+    int     nameOffset;         /*!< '\0' terminated name*/
+    int     unitOffset;         /*!< '\0' terminated unit, 0 if none*/
+    int     helpTextOffset;     /*!< '\0' terminated help text, 0 if none*/
+    int     valueOffset;        /*!< Value, 8 byte aligned*/
+    int     valueCount;         /*!< Number of doubles of a TM_EXPORT_ARRAY_DOUBLE, 1 otherwise*/
+} TM_EXPORT_ENTRY;
+
 typedef enum tagTmSeqMeasType
 {
     TM_SEQ_MEAS_EVM,
@@ -442,6 +486,137 @@ TM_API TM_RETURN __stdcall TM_InstallCallbackFunction(TM_ID technologyID, const
  */
 TM_API TM_RETURN __stdcall TM_Run(TM_ID technologyID, const TM_STR functionKeyword);
 
+//! Run a Test function on the worker thread of the technology, without waiting for it
+/*!
+ * The input parameters of the technology are copied when the job is queued, so the caller can clear and fill
+ * the parameters of the next run right away.  The test function writes its returns to a copy of the return
+ * containers; TM_Wait() moves them to the technology, where TM_GetxxxReturn() reads them as after TM_Run().
+ *
+ * Each technology has one worker thread: the jobs of a technology run one after the other, in queue order,
+ * while the jobs of different technologies overlap (e.g. a BT RX test during the WiFi TX analysis).
+ *
+ * \param[in] technologyID The registered technology ID
+ * \param[in] functionKeyword The function name (one of the pre-defined function names)
+ * \param[out] handle Handle of the job, for TM_Poll() and TM_Wait()
+ * \param[in] callback Called on the worker thread when the job completes, NULL if not used
+ * \param[in] userData Passed to the callback
+ *
+ * \return TM_ERR_OK if the job has been queued; the result of the test function is returned by TM_Wait()
+ * \return TM_ERR_INVALID_TECHNOLOGY_ID The specified Technology ID is invalid
+ * \return TM_ERR_FUNCTION_ERROR The worker thread could not be created, or TM_RunAsyncStop() is running
+ *
+ * \remark The tester and the DUT control are shared by all technologies; only overlap technologies that do not
+ * use the same tester or DUT at the same time.  Do not call TM_Run() or the TM_GetxxxReturn() functions of a
+ * technology while one of its jobs is pending, and call TM_Wait() once for every handle.
+ */
+TM_API TM_RETURN __stdcall TM_RunAsync(TM_ID technologyID, const TM_STR functionKeyword, TM_ASYNC_HANDLE *handle,
+                                       TM_ASYNC_CALLBACK callback, void *userData);
+
+//! Check if a TM_RunAsync() job has completed
+/*!
+ * \param[in] handle Handle returned by TM_RunAsync()
+ * \param[out] done 1 if the job has completed, 0 otherwise
+ *
+ * \return TM_ERR_OK if no errors
+ * \return TM_ERR_INVALID_HANDLE The handle does not exist, or TM_Wait() has already been called for it
+ */
+TM_API TM_RETURN __stdcall TM_Poll(TM_ASYNC_HANDLE handle, int *done);
+
+//! Wait for a TM_RunAsync() job, and move its returns to the technology
+/*!
+ * \param[in] handle Handle returned by TM_RunAsync()
+ * \param[in] timeoutMs Longest wait in ms, TM_ASYNC_INFINITE to wait until the job completes
+ * \param[out] tmReturn Return value of the job, same as the return value of TM_Run()
+ *
+ * \return TM_ERR_OK if the job has completed; the handle is released
+ * \return TM_ERR_INVALID_HANDLE The handle does not exist, or TM_Wait() has already been called for it
+ * \return TM_ERR_TIMEOUT The job has not completed within timeoutMs; the handle stays valid
+ */
+TM_API TM_RETURN __stdcall TM_Wait(TM_ASYNC_HANDLE handle, int timeoutMs, TM_RETURN *tmReturn);
+
+//! Stop the TM_RunAsync() worker threads
+/*!
+ * Each worker runs the jobs still in its queue, then exits; the handles of the jobs stay valid for TM_Wait().
+ * A later TM_RunAsync() starts the worker of its technology again.
+ *
+ * \param[in] timeoutMs Longest wait in ms, TM_ASYNC_INFINITE to wait until the workers have exited
+ *
+ * \return TM_ERR_OK if no worker is left
+ * \return TM_ERR_TIMEOUT A worker has not exited within timeoutMs; the workers still running go on taking jobs and
+ *         TM_RunAsync() works again, call TM_RunAsyncStop() again to join them
+ *
+ * \remark Call it before unloading TestManager: the workers cannot be waited for while TestManager is unloaded.
+ */
+TM_API TM_RETURN __stdcall TM_RunAsyncStop(int timeoutMs);
+
+//! Save what TestManager keeps until the end of the test program
+/*!
+ * Closes the structured result file (TM_ResultSinkClose()), saves the adaptive statistics (TM_AdaptiveClose()) and
+ * saves the trace of IQlite_Timer to Timer/<date-time>_Trace.json (TIMER_Term()).  None of them is saved when
+ * TestManager is unloaded.
+ *
+ * \return TM_ERR_OK if no errors
+ * \return TM_ERR_FAILED_TO_OPEN_FILE if the statistics or the trace cannot be saved
+ *
+ * \remark Call it at the end of the test program, after TM_RunAsyncStop() and when no test function runs.
+ */
+TM_API TM_RETURN __stdcall TM_Term(void);
+
+//! Install the look-ahead function of a technology
+/*!
+ * The look-ahead function configures the DUT for the next test item while the current test function analyzes
+ * its captures.  It reads the parameters of the next item with TM_GetxxxParameter(), and its keyword from the
+ * string parameter LOOK_AHEAD_KEYWORD.
+ *
+ * \param[in] technologyID The registered technology ID
+ * \param[in] pointerToFunction The look-ahead function, NULL to remove it
+ *
+ * \return TM_ERR_OK if no errors
+ * \return TM_ERR_INVALID_TECHNOLOGY_ID The specified Technology ID is invalid
+ */
+TM_API TM_RETURN __stdcall TM_InstallLookAheadFunction(TM_ID technologyID, int (*pointerToFunction)(void));
+
+//! Declare the next test item of a technology
+/*!
+ * Copies the current input parameters of the technology as the parameters of the next item.  The station fills
+ * the parameters of the next item, calls TM_SetLookAhead(), then fills the parameters of the current item and
+ * calls TM_Run().
+ *
+ * \param[in] technologyID The registered technology ID
+ * \param[in] functionKeyword Function name of the next item, NULL or "" if there is no next item
+ *
+ * \return TM_ERR_OK if no errors
+ * \return TM_ERR_INVALID_TECHNOLOGY_ID The specified Technology ID is invalid
+ */
+TM_API TM_RETURN __stdcall TM_SetLookAhead(TM_ID technologyID, const TM_STR functionKeyword);
+
+//! Run the look-ahead function for the next test item, without waiting for it
+/*!
+ * Called by a test function once it does not need the DUT any more, typically after its last capture.
+ * The look-ahead function runs on a TestManager thread; TM_Run() waits for it before the next test function.
+ *
+ * \param[in] technologyID The registered technology ID
+ *
+ * \return TM_ERR_OK if the look-ahead function has been started
+ * \return TM_ERR_INVALID_TECHNOLOGY_ID The specified Technology ID is invalid
+ * \return TM_ERR_NO_VALUE_DEFINED No next item, or no look-ahead function installed
+ * \return TM_ERR_FUNCTION_ERROR The thread could not be created
+ */
+TM_API TM_RETURN __stdcall TM_StartLookAhead(TM_ID technologyID);
+
+//! Wait for the look-ahead function started by TM_StartLookAhead()
+/*!
+ * A test function that started the look-ahead function calls it before it controls the DUT again, e.g. to
+ * stop the DUT after an error.
+ *
+ * \param[in] technologyID The registered technology ID
+ * \param[out] functionReturn Return value of the look-ahead function, 0 if none was running
+ *
+ * \return TM_ERR_OK if no errors
+ * \return TM_ERR_INVALID_TECHNOLOGY_ID The specified Technology ID is invalid
+ */
+TM_API TM_RETURN __stdcall TM_WaitLookAhead(TM_ID technologyID, int *functionReturn);
+
 //! Clear all input parameter containers for the specified technology
 /*!
  * \param[in] technologyID The registered technology ID
@@ -662,6 +837,39 @@ TM_API TM_RETURN __stdcall TM_GetArrayDoubleReturnPair(TM_ID technologyID,
                                                        double* paramValue,
                                                        int order);
 
+//! Copy all returns of a technology, with their units and help text, to one buffer
+/*!
+ * Replaces the TM_GetxxxReturnPair() loops for hosts where each call is expensive (LabVIEW, .NET): the buffer
+ * starts with a TM_EXPORT_HEADER, followed by one TM_EXPORT_ENTRY per return (integer, double, string, then
+ * array returns, each in name order), followed by the names, units, help text and values the entries point to.
+ * The shared iterators of TM_GetxxxReturnPair() are not used.
+ *
+ * \param[in] technologyID The registered technology ID
+ * \param[out] buffer Caller buffer, 8 byte aligned; NULL to get the size only
+ * \param[in] bufferSize Size of buffer in bytes
+ * \param[out] requiredSize Size the returns need, set in all cases
+ *
+ * \return TM_ERR_OK if no errors
+ * \return TM_ERR_INVALID_TECHNOLOGY_ID The specified Technology ID is invalid
+ * \return TM_ERR_BUFFER_TOO_SMALL buffer is NULL or smaller than requiredSize; nothing is copied
+ */
+TM_API TM_RETURN __stdcall TM_ExportReturns(TM_ID technologyID, void *buffer, int bufferSize, int *requiredSize);
+
+//! Add the input parameters of a technology from one buffer, the reverse of TM_ExportReturns()
+/*!
+ * The buffer has the TM_ExportReturns() layout; integer, double and string entries are added as with
+ * TM_AddxxxParameter(), units and help text are ignored.
+ *
+ * \param[in] technologyID The registered technology ID
+ * \param[in] buffer Buffer with the TM_ExportReturns() layout
+ * \param[in] bufferSize Size of buffer in bytes
+ *
+ * \return TM_ERR_OK if no errors
+ * \return TM_ERR_INVALID_TECHNOLOGY_ID The specified Technology ID is invalid
+ * \return TM_ERR_BUFFER_TOO_SMALL The buffer is not a valid layout; no parameter is added
+ */
+TM_API TM_RETURN __stdcall TM_ImportParameters(TM_ID technologyID, const void *buffer, int bufferSize);
+
 //! Return the description for the specified error code
 /*!
  *
@@ -920,4 +1128,136 @@ TM_API TM_RETURN __stdcall TM_GetMultiWaveformIndex(TM_STR waveformName, int *in
  */
 TM_API TM_RETURN __stdcall TM_GetSeqMeasureResults(const TM_STR dataRate, int mpsMeasureType);
 
+//! Open the structured result file of the station
+/*!
+ * Once opened, each TM_Run() appends one binary record with the technology, function keyword, all input
+ * parameters, all returns with their units, the run time, the TM_Run() return code and the DUT serial number
+ * set by TM_SetDutInfo().  Records are written by a background thread; TM_ResultReader converts the file to CSV.
+ * The layout is described in TM_ResultSink.h.
+ *
+ * \param[in] fileName Result file; appended to if it exists
+ * \param[in] stationName Station name saved in the file header of a new file
+ *
+ * \return TM_ERR_OK if no errors
+ * \return TM_ERR_FAILED_TO_OPEN_FILE if the file cannot be opened
+ *
+ * \remark Calls while the file is open are ignored.  Call TM_ResultSinkClose() before unloading TestManager: the
+ * records still queued when TestManager is unloaded are not written.
+ */
+TM_API TM_RETURN __stdcall TM_ResultSinkOpen(const TM_STR fileName, const TM_STR stationName);
+
+//! Write all pending records and close the structured result file
+/*!
+ * \return TM_ERR_OK if no errors
+ */
+TM_API TM_RETURN __stdcall TM_ResultSinkClose(void);
+
+//! Start the adaptive test-time reduction of TM_Run()
+/*!
+ * TM_Run() keeps the running mean and variance of every double return, per item: the function keyword with its
+ * integer and string parameters.  Once each return given a limit by TM_AdaptiveSetLimit() has at least minSamples
+ * results and a Cpk of at least cpkSkip, the item runs on 1 of sampleRate units only; on the other units TM_Run()
+ * returns TM_ERR_ADAPTIVE_SKIPPED without calling the test function, with the reason in the string return
+ * ADAPTIVE_SKIPPED.  A function error, a return beyond its limits, or a return more than driftSigma standard
+ * deviations from its mean runs the item on every unit again for the next recoveryUnits units.  Skips and
+ * restores are logged with their reason.  See TM_AdaptiveSetPolicy() for the default policy.
+ *
+ * \param[in] statisticsFileName Statistics of the previous runs of the station; created by TM_AdaptiveClose()
+ *
+ * \return TM_ERR_OK if no errors
+ * \return TM_ERR_FAILED_TO_OPEN_FILE if statisticsFileName is NULL
+ *
+ * \remark Items without limits always run.  Calls while the adaptive test is on are ignored.  Call
+ * TM_AdaptiveClose() before unloading TestManager: the statistics are not saved when TestManager is unloaded.
+ */
+TM_API TM_RETURN __stdcall TM_AdaptiveOpen(const TM_STR statisticsFileName);
+
+//! Save the statistics to the file given to TM_AdaptiveOpen(), and run every item again
+/*!
+ * \return TM_ERR_OK if no errors
+ * \return TM_ERR_FAILED_TO_OPEN_FILE if the statistics cannot be saved
+ */
+TM_API TM_RETURN __stdcall TM_AdaptiveClose(void);
+
+//! Set the adaptive test policy
+/*!
+ * \param[in] minSamples Results of a return needed before its item may be skipped, at least 2. Default=30
+ * \param[in] cpkSkip Lowest Cpk of the returns with limits for an item to be skipped. Default=2.0
+ * \param[in] sampleRate A skipped item runs on 1 of sampleRate units, 1 runs every item. Default=10
+ * \param[in] driftSigma Distance from the mean, in standard deviations, that restores full coverage. Default=4.0
+ * \param[in] recoveryUnits Units run at full coverage after a drift or a failure. Default=50
+ *
+ * \return TM_ERR_OK if no errors
+ */
+TM_API TM_RETURN __stdcall TM_AdaptiveSetPolicy(int minSamples, double cpkSkip, int sampleRate, double driftSigma, int recoveryUnits);
+
+//! Set the limits of a return, used by the adaptive test for all the items of the function keyword
+/*!
+ * \param[in] technologyID The registered technology ID
+ * \param[in] functionKeyword The function name
+ * \param[in] returnName The double return
+ * \param[in] lowerLimit Lower limit, NA_NUMBER if none
+ * \param[in] upperLimit Upper limit, NA_NUMBER if none; both NA_NUMBER remove the limits
+ *
+ * \return TM_ERR_OK if no errors
+ * \return TM_ERR_INVALID_TECHNOLOGY_ID The specified Technology ID is invalid
+ */
+TM_API TM_RETURN __stdcall TM_AdaptiveSetLimit(TM_ID technologyID, const TM_STR functionKeyword, const TM_STR returnName, double lowerLimit, double upperLimit);
+
+//! Replay a TM_ResultSinkOpen() result file through the adaptive test policy
+/*!
+ * The records are replayed in file order, starting from empty statistics, with the current policy and limits;
+ * the statistics of TM_AdaptiveOpen() are not changed.  The result is deterministic for a given file.
+ *
+ * \param[in] resultFileName Result file written by TM_ResultSinkOpen()
+ * \param[in] reportFileName CSV report with the runs, skips and escapes of each item, NULL if not needed
+ * \param[out] runCount Records the policy would have run
+ * \param[out] skipCount Records the policy would have skipped
+ * \param[out] escapeCount Skipped records that failed: a function error or a return beyond its limits
+ *
+ * \return TM_ERR_OK if no errors
+ * \return TM_ERR_FAILED_TO_OPEN_FILE if a file cannot be opened, or the result file is not valid
+ */
+TM_API TM_RETURN __stdcall TM_AdaptiveSimulate(const TM_STR resultFileName, const TM_STR reportFileName, int *runCount, int *skipCount, int *escapeCount);
+
+//! Start the sampled allocation profiler
+/*!
+ * Counts the allocations made through operator new by the modules linked with IQmeasure\AllocProfiler.cpp
+ * (IQmeasure, WiFi_Test, IQmeasureTest), and files them under the TM_Run() function keyword running on the
+ * allocating thread.  The counts are exact while profiling, except that the last interval of each thread may not
+ * be flushed by the stop (see TM_AllocProfilerStop()); the call sites come from about one allocation per
+ * sampleIntervalBytes allocated, randomized by +/-50%.  A module loaded before TestManager is not profiled, nor
+ * are the allocations of TestManager itself; frees are not tracked.  A new start discards the records of the
+ * previous one.
+ *
+ * \param[in] sampleIntervalBytes Average bytes allocated by a thread between two samples, 0 for 512 KB
+ *
+ * \return TM_ERR_OK if no errors
+ * \return TM_ERR_FUNCTION_NOT_SUPPORTED if no thread local storage is left for the profiler
+ */
+TM_API TM_RETURN __stdcall TM_AllocProfilerStart(int sampleIntervalBytes);
+
+//! Stop the allocation profiler; the records are kept for TM_AllocProfilerReport()
+/*!
+ * The allocations of a thread since its last sample are recorded at its next allocation while profiling, so the
+ * last TM_Run() of each thread before the stop may miss up to one sample interval of bytes.
+ *
+ * \return TM_ERR_OK if no errors
+ */
+TM_API TM_RETURN __stdcall TM_AllocProfilerStop(void);
+
+//! Write the allocation profile since TM_AllocProfilerStart() to a CSV file
+/*!
+ * The first table has the runs, allocations and bytes of each function keyword; allocations made outside TM_Run()
+ * are under "(outside TM_Run)".  The second table has the top call sites of each keyword, with the samples and the
+ * estimated bytes; a call site is the 3 innermost frames, each as module+offset, the offset being relative to the
+ * load address of the module, as in its .map file.  May be called while profiling.
+ *
+ * \param[in] fileName CSV report file
+ *
+ * \return TM_ERR_OK if no errors
+ * \return TM_ERR_FAILED_TO_OPEN_FILE if the file cannot be opened
+ */
+TM_API TM_RETURN __stdcall TM_AllocProfilerReport(const TM_STR fileName);
+
 #endif
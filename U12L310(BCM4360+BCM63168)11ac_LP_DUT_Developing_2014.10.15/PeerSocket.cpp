@@ -10,11 +10,18 @@
 
 #include "stdafx.h"
 #include "PeerSocket.h"
+#include "IQlite_Timer.h"	// TIMER_TraceScope
 #include "Tlhelp32.h"
 #include "stdio.h"
 #include <string>
+#include <iphlpapi.h>	// DeleteIpNetEntry
 using namespace std;
 #define MAXBUFSIZE 2048
+#define DUT_PROBE_BACKOFF_MIN_MS	100		// first wait between two connect probes
+#define DUT_PROBE_BACKOFF_MAX_MS	2000
+#define DUT_PROBE_CONNECT_MS		1000	// connect timeout of one probe
+#define DUT_PROBE_BANNER_MS		3000	// wait for the prompt once connected
+#define DUT_PROBE_NUDGE_MS			500		// silence before an empty line is sent
 
 SOCKET g_socket; // dut socket
 string strSocketBuf;
@@ -158,6 +165,174 @@ bool InitSocket(char *ip,int &ErrorType)
 	return TRUE;
 }
 
+// Removes the ARP cache entry of the DUT in process, instead of running "arp -d",
+// so a DUT replaced by another one with the same IP is resolved again
+bool ClearDutArpEntry(char *ip)
+{
+	MIB_IPNETROW arpRow;
+	DWORD dwIfIndex = 0;
+	IPAddr dutAddr = inet_addr(ip);
+
+	if(NO_ERROR != GetBestInterface(dutAddr,&dwIfIndex))
+	{
+		return false;
+	}
+	memset(&arpRow,0,sizeof(arpRow));
+	arpRow.dwIndex = dwIfIndex;
+	arpRow.dwAddr  = dutAddr;
+
+	DWORD dwRet = DeleteIpNetEntry(&arpRow);
+	return (NO_ERROR==dwRet || ERROR_NOT_FOUND==dwRet);
+}
+
+static DWORD DutTimeLeft(DWORD dwStart,DWORD timeoutMs)
+{
+	DWORD dwSpent = GetTickCount()-dwStart;
+	return (dwSpent<timeoutMs)? timeoutMs-dwSpent : 0;
+}
+
+static void DutTimeval(timeval *tv,DWORD timeoutMs)
+{
+	tv->tv_sec  = timeoutMs/1000;
+	tv->tv_usec = (timeoutMs%1000)*1000;
+}
+
+// Non-blocking connect, false if the DUT refuses or does not answer within timeoutMs
+static bool DutProbeConnect(SOCKET probe,sockaddr_in *addr,DWORD timeoutMs)
+{
+	if(SOCKET_ERROR==connect(probe,(SOCKADDR*)addr,sizeof(*addr)) && WSAEWOULDBLOCK!=WSAGetLastError())
+	{
+		return false;
+	}
+
+	fd_set writeSet,errorSet;
+	FD_ZERO(&writeSet);
+	FD_SET(probe,&writeSet);
+	FD_ZERO(&errorSet);
+	FD_SET(probe,&errorSet);
+	timeval tv;
+	DutTimeval(&tv,timeoutMs);
+
+	// Windows reports a failed non-blocking connect in the error set
+	return (0<select(0,NULL,&writeSet,&errorSet,&tv) && FD_ISSET(probe,&writeSet) && !FD_ISSET(probe,&errorSet));
+}
+
+// Reads the banner until keyWord shows up; one empty line is sent if the DUT stays silent
+static bool DutProbeBanner(SOCKET probe,char *keyWord,DWORD timeoutMs,string &strBanner)
+{
+	DWORD dwStart = GetTickCount();
+	bool  bNudged = false;
+
+	strBanner.clear();
+	while(0<DutTimeLeft(dwStart,timeoutMs))
+	{
+		fd_set readSet;
+		FD_ZERO(&readSet);
+		FD_SET(probe,&readSet);
+		timeval tv;
+		DutTimeval(&tv,min(DutTimeLeft(dwStart,timeoutMs),(DWORD)DUT_PROBE_NUDGE_MS));
+
+		int nReady = select(0,&readSet,NULL,NULL,&tv);
+		if(SOCKET_ERROR==nReady)
+		{
+			return false;
+		}
+		else if(0==nReady)
+		{
+			if(!bNudged)
+			{
+				send(probe,"\r\n",2,0);
+				bNudged = true;
+			}
+			continue;
+		}
+
+		char szBuf[MAXBUFSIZE+1]="";
+		int nRead = recv(probe,szBuf,MAXBUFSIZE,0);
+		if(nRead<=0)
+		{
+			return false;	// closed by the DUT, telnetd is not ready yet
+		}
+		strBanner.append(szBuf,nRead);
+		if(strBanner.find(keyWord) != string::npos)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+// Waits, within deadlineMs, for the DUT to accept a TCP connection on port and show keyWord,
+// without ping.exe: non-blocking connect probes, DUT_PROBE_BACKOFF_MIN_MS apart at first and
+// twice as far each time up to DUT_PROBE_BACKOFF_MAX_MS.
+// Like InitSocket(), the connected socket becomes g_socket and the receive thread is started;
+// strSocketBuf holds the banner.  readyMs gets the time the DUT took.
+// ErrorType: 1 create socket failed, 2 no connection before the deadline, 3 connected but no keyWord
+bool WaitDutReady(char *ip,int port,char *keyWord,DWORD deadlineMs,int &ErrorType,DWORD *readyMs)
+{
+	DWORD  dwStart   = GetTickCount();
+	DWORD  dwBackoff = DUT_PROBE_BACKOFF_MIN_MS;
+	string strBanner;
+
+	Read_ini();
+	ErrorType = 2;
+
+	sockaddr_in dutService;
+	dutService.sin_family = AF_INET;
+	dutService.sin_addr.s_addr = inet_addr( ip );
+	dutService.sin_port = htons( (u_short)port );
+
+	while(0<DutTimeLeft(dwStart,deadlineMs))
+	{
+		SOCKET probe = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+		if(INVALID_SOCKET==probe)
+		{
+			ErrorType=1;
+			return false;
+		}
+		u_long iMode = 1;
+		ioctlsocket(probe, FIONBIO, &iMode);
+
+		DWORD dwProbeStart = GetTickCount();
+		if(DutProbeConnect(probe,&dutService,min(DutTimeLeft(dwStart,deadlineMs),(DWORD)DUT_PROBE_CONNECT_MS)))
+		{
+			if(DutProbeBanner(probe,keyWord,min(DutTimeLeft(dwStart,deadlineMs),(DWORD)DUT_PROBE_BANNER_MS),strBanner))
+			{
+				iMode = 0;
+				ioctlsocket(probe, FIONBIO, &iMode);
+
+				if(h_socketThread!=NULL)
+				{
+					TerminateThread(h_socketThread,0);
+				}
+				g_socket = probe;
+				strSocketBuf = strBanner;
+				bRequestExit = false;
+				h_socketThread=CreateThread(NULL,0,_socket_receive,&g_socket,0,NULL);
+
+				if(readyMs != NULL)
+				{
+					*readyMs = GetTickCount()-dwStart;
+				}
+				ErrorType=0;
+				return true;
+			}
+			ErrorType=3;
+		}
+		closesocket(probe);
+
+		// A refused connect returns at once, wait the rest of the backoff
+		DWORD dwSpent = GetTickCount()-dwProbeStart;
+		if(dwSpent<dwBackoff)
+		{
+			Sleep(min(dwBackoff-dwSpent,DutTimeLeft(dwStart,deadlineMs)));
+		}
+		dwBackoff = min(dwBackoff*2,(DWORD)DUT_PROBE_BACKOFF_MAX_MS);
+	}
+
+	return false;
+}
+
 bool PingSpecifyIP(TCHAR* IP,int &ErrorType,int nFailCount)
 {
 	HANDLE hWritePipe  = NULL;
@@ -466,6 +641,7 @@ bool RunTelnetExe(char *ip)
 }
 bool SendSocketCmd(char *cmd, char *ret, int timeout)
 {
+	TIMER_TraceScope traceScope("PeerSocket", cmd);	// TRACE_EVENT=1 in IQlite_Timer.ini
 	try
 	{
 		strSocketBuf.clear();
@@ -533,8 +709,8 @@ int Read_ini()
 		ShowDebugInfor=GetPrivateProfileInt("Configuration","DEBUG_SHOW",0,iniPath);
 
 		ini_status = 1;  
+		fclose(iniFile);
 	}
-	fclose(iniFile);
 	return ini_status;
 }
 
@@ -607,7 +783,280 @@ int RunSpecifyExeAndRead(char* RunFileName,bool bIsShow)
 }
 
 #ifdef __CARD__
+// Command server of the USB adapter DUT: one long-lived shell runs the wl/devctl commands, instead
+// of one CreateProcess() and one pipe per command.  Each command is followed by "echo <marker>",
+// so the output of a command ends at its marker line, and SendDutCmdList() can have several
+// commands in the pipe at once.  The server is DUT_CMD_SERVER in LP_DUT_setup.ini; empty runs
+// every command as its own process, like before.
+#define DUT_CMD_SERVER_DEFAULT		"cmd.exe /Q /K"
+#define DUT_CMD_MARKER				"__LP_DUT_CMD_END_"
+#define DUT_CMD_PIPE_SIZE			65536
+#define DUT_CMD_PIPELINE_DEPTH		8		// commands written ahead of the one being read
+#define DUT_CMD_START_TIMEOUT		5000
+
+static struct
+{
+	HANDLE	hProcess;
+	HANDLE	hStdinWrite;
+	HANDLE	hStdoutRead;
+	int		nSequence;
+	bool	bDisabled;		// DUT_CMD_SERVER is empty, or the server did not start
+	string	strPending;		// output read beyond the marker of the last command
+} g_cmdServer = {NULL, NULL, NULL, 0, false, ""};
+
+static bool CmdServerWrite(char *cmd, int nSequence)
+{
+	char szLine[MAXBUFSIZE]="";
+	sprintf_s(szLine,sizeof(szLine),"%s\r\necho %s%d__\r\n",cmd,DUT_CMD_MARKER,nSequence);
+
+	DWORD dwWritten = 0;
+	return (WriteFile(g_cmdServer.hStdinWrite,szLine,(DWORD)strlen(szLine),&dwWritten,NULL) && dwWritten==strlen(szLine));
+}
+
+// Output of command nSequence, up to its marker line
+static bool CmdServerRead(int nSequence, int iTimeout, string &strOutput)
+{
+	char szMarker[64]="";
+	sprintf_s(szMarker,sizeof(szMarker),"%s%d__",DUT_CMD_MARKER,nSequence);
+	DWORD dwStart = GetTickCount();
+
+	while(true)
+	{
+		// The marker can follow output that has no line end; a server that echoes its input
+		// shows it after "echo " as well, which is not the end of the command
+		size_t pos = g_cmdServer.strPending.find(szMarker);
+		while(pos!=string::npos && pos>=5 && 0==g_cmdServer.strPending.compare(pos-5,5,"echo "))
+		{
+			pos = g_cmdServer.strPending.find(szMarker,pos+1);
+		}
+		if(pos!=string::npos)
+		{
+			size_t lineEnd = g_cmdServer.strPending.find('\n',pos);
+			if(lineEnd!=string::npos)
+			{
+				strOutput = g_cmdServer.strPending.substr(0,pos);
+				g_cmdServer.strPending.erase(0,lineEnd+1);
+				return true;
+			}
+		}
+
+		DWORD dwAvail = 0;
+		if(!PeekNamedPipe(g_cmdServer.hStdoutRead,NULL,0,NULL,&dwAvail,NULL))
+		{
+			return false;	// server exited
+		}
+		if(dwAvail>0)
+		{
+			char szBuf[4096];
+			DWORD dwRead = 0;
+			if(!ReadFile(g_cmdServer.hStdoutRead,szBuf,min(dwAvail,(DWORD)sizeof(szBuf)),&dwRead,NULL))
+			{
+				return false;
+			}
+			g_cmdServer.strPending.append(szBuf,dwRead);
+		}
+		else if(GetTickCount()-dwStart > (DWORD)iTimeout)
+		{
+			return false;
+		}
+		else
+		{
+			Sleep(1);
+		}
+	}
+}
+
+void StopDutCmdServer()
+{
+	if(g_cmdServer.hProcess!=NULL)
+	{
+		DWORD dwWritten = 0;
+		WriteFile(g_cmdServer.hStdinWrite,"exit\r\n",6,&dwWritten,NULL);
+		if(WAIT_TIMEOUT==WaitForSingleObject(g_cmdServer.hProcess,1000))
+		{
+			TerminateProcess(g_cmdServer.hProcess,1);
+		}
+		CloseHandle(g_cmdServer.hProcess);
+		CloseHandle(g_cmdServer.hStdinWrite);
+		CloseHandle(g_cmdServer.hStdoutRead);
+		g_cmdServer.hProcess    = NULL;
+		g_cmdServer.hStdinWrite = NULL;
+		g_cmdServer.hStdoutRead = NULL;
+	}
+	g_cmdServer.strPending.clear();
+}
+
+// Starts the server if it does not run, false if the commands must run as their own process
+static bool CmdServerReady()
+{
+	if(g_cmdServer.hProcess!=NULL)
+	{
+		return true;
+	}
+	if(g_cmdServer.bDisabled)
+	{
+		return false;
+	}
+
+	char iniPath[MAXBUFSIZE]="";
+	char szServer[MAXBUFSIZE]="";
+	GetCurrentDirectory (MAXBUFSIZE, iniPath);
+	sprintf_s(iniPath , MAXBUFSIZE , "%s\\%s" , iniPath , LP_DUT_INI_FILE);
+	GetPrivateProfileString("Configuration","DUT_CMD_SERVER",DUT_CMD_SERVER_DEFAULT,szServer,sizeof(szServer),iniPath);
+	if(szServer[0]=='\0')
+	{
+		g_cmdServer.bDisabled = true;
+		return false;
+	}
+
+	SECURITY_ATTRIBUTES sa;
+	ZeroMemory(&sa,sizeof(SECURITY_ATTRIBUTES));
+	sa.nLength=sizeof(SECURITY_ATTRIBUTES);
+	sa.bInheritHandle=true;
+
+	HANDLE hStdinRead=NULL, hStdoutWrite=NULL;
+	if(!CreatePipe(&hStdinRead,&g_cmdServer.hStdinWrite,&sa,DUT_CMD_PIPE_SIZE))
+	{
+		printf("CreatePipe failed!\n");
+		g_cmdServer.bDisabled = true;
+		return false;
+	}
+	if(!CreatePipe(&g_cmdServer.hStdoutRead,&hStdoutWrite,&sa,DUT_CMD_PIPE_SIZE))
+	{
+		printf("CreatePipe failed!\n");
+		CloseHandle(hStdinRead);
+		CloseHandle(g_cmdServer.hStdinWrite);
+		g_cmdServer.hStdinWrite = NULL;
+		g_cmdServer.bDisabled = true;
+		return false;
+	}
+	// Only the ends of the server are inherited
+	SetHandleInformation(g_cmdServer.hStdinWrite,HANDLE_FLAG_INHERIT,0);
+	SetHandleInformation(g_cmdServer.hStdoutRead,HANDLE_FLAG_INHERIT,0);
+
+	PROCESS_INFORMATION pi;
+	STARTUPINFO si;
+	ZeroMemory(&si,sizeof(STARTUPINFO));
+	ZeroMemory(&pi,sizeof(PROCESS_INFORMATION));
+	si.cb=sizeof(STARTUPINFO);
+	si.dwFlags = STARTF_USESHOWWINDOW | STARTF_USESTDHANDLES;
+	si.hStdInput=hStdinRead;
+	si.hStdOutput=hStdoutWrite;
+	si.hStdError=hStdoutWrite;
+	si.wShowWindow=SW_HIDE;
+
+	BOOL bCreated = CreateProcess(NULL,szServer,NULL,NULL,true,CREATE_NO_WINDOW,NULL,NULL,&si,&pi);
+	CloseHandle(hStdinRead);
+	CloseHandle(hStdoutWrite);
+	if(!bCreated)
+	{
+		printf("CreateProcess(%s) failed! GetLastError()=%d\n",szServer,GetLastError());
+		CloseHandle(g_cmdServer.hStdinWrite);
+		CloseHandle(g_cmdServer.hStdoutRead);
+		g_cmdServer.hStdinWrite = NULL;
+		g_cmdServer.hStdoutRead = NULL;
+		g_cmdServer.bDisabled = true;
+		return false;
+	}
+	CloseHandle(pi.hThread);
+	g_cmdServer.hProcess = pi.hProcess;
+
+	// Skips the banner of the server
+	string strBanner;
+	int nSequence = ++g_cmdServer.nSequence;
+	if(!CmdServerWrite("",nSequence) || !CmdServerRead(nSequence,DUT_CMD_START_TIMEOUT,strBanner))
+	{
+		printf("Command server %s does not answer, commands run as their own process\n",szServer);
+		StopDutCmdServer();
+		g_cmdServer.bDisabled = true;
+		return false;
+	}
+
+	return true;
+}
+
 bool SendDutCmd(char *cmd, char *ret, int iTimeout)
+{
+	TIMER_TraceScope traceScope("PeerSocket", cmd);	// TRACE_EVENT=1 in IQlite_Timer.ini
+
+	if(!CmdServerReady())
+	{
+		return SendDutCmdProcess(cmd,ret,iTimeout);
+	}
+
+	strSocketBuf.clear();
+	printf("%s\n",cmd);	// show the test commands.
+
+	int nSequence = ++g_cmdServer.nSequence;
+	string strOutput;
+	if(!CmdServerWrite(cmd,nSequence) || !CmdServerRead(nSequence,iTimeout,strOutput))
+	{
+		// The output is out of step with the commands now, the next command starts a new server
+		printf("Command server lost %s\n",cmd);
+		StopDutCmdServer();
+		return false;
+	}
+	printf("%s",strOutput.c_str());
+	strSocketBuf = strOutput;
+
+	if(ret == NULL)
+		return true;
+
+	return (strSocketBuf.find(ret) != string::npos);
+}
+
+// Runs cmds in order without waiting for each output, false if one did not complete
+bool SendDutCmdList(char *cmds[], int cmdCount, int iTimeout)
+{
+	if(!CmdServerReady())
+	{
+		bool bAllDone = true;
+		for(int i=0;i<cmdCount;i++)
+		{
+			bAllDone = SendDutCmdProcess(cmds[i],NULL,iTimeout) && bAllDone;
+		}
+		return bAllDone;
+	}
+
+	TIMER_TraceScope traceScope("PeerSocket", "SendDutCmdList");	// TRACE_EVENT=1 in IQlite_Timer.ini
+	DWORD dwStart = GetTickCount();
+	int nFirst = g_cmdServer.nSequence+1;
+	int nSent = 0, nDone = 0;
+
+	strSocketBuf.clear();
+	while(nDone<cmdCount)
+	{
+		while(nSent<cmdCount && nSent-nDone<DUT_CMD_PIPELINE_DEPTH)
+		{
+			printf("%s\n",cmds[nSent]);	// show the test commands.
+			if(!CmdServerWrite(cmds[nSent],++g_cmdServer.nSequence))
+			{
+				printf("Command server lost %s\n",cmds[nSent]);
+				StopDutCmdServer();
+				return false;
+			}
+			nSent++;
+		}
+
+		string strOutput;
+		if(!CmdServerRead(nFirst+nDone,iTimeout,strOutput))
+		{
+			printf("Command server lost %s\n",cmds[nDone]);
+			StopDutCmdServer();
+			return false;
+		}
+		printf("%s",strOutput.c_str());
+		strSocketBuf += strOutput;
+		nDone++;
+	}
+
+	DWORD dwSpent = GetTickCount()-dwStart;
+	printf("%d commands in %lu ms\n",cmdCount,dwSpent);
+	return true;
+}
+
+// Runs cmd as its own process, as every command did before the command server
+bool SendDutCmdProcess(char *cmd, char *ret, int iTimeout)
 {
 	HANDLE hPipeRead, hPipeWrite;
 	SECURITY_ATTRIBUTES sa;
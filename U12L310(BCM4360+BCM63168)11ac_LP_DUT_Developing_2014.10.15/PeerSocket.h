@@ -22,6 +22,8 @@ void ambit_WSACleanup();
 bool Initialize_WSA();
 bool InitSocket(TCHAR *ip,int &ErrorType);
 bool PingSpecifyIP(TCHAR* IP,int &ErrorType,int nFailCount=35);
+bool ClearDutArpEntry(char *ip);
+bool WaitDutReady(char *ip,int port,char *keyWord,DWORD deadlineMs,int &ErrorType,DWORD *readyMs=NULL);
 bool PeerCreateSocket(SOCKET *pNewSocket,int iSockType);
 bool PeerBindSocket(SOCKET BindSocket,TCHAR *szHostAddr,int iHostPort);
 bool PeerConnectSocket(SOCKET BindSocket,TCHAR *szHostAddr,int iHostPort);
@@ -42,6 +44,9 @@ int  Read_ini ();
 int RunSpecifyExeAndRead(char* RunFileName,bool bIsShow);
 #ifdef __CARD__
 bool SendDutCmd(char *cmd, char *ret=NULL, int iTimeout=5000); // add to support broadcom usb adapter wifi card control
+bool SendDutCmdList(char *cmds[], int cmdCount, int iTimeout=5000);
+bool SendDutCmdProcess(char *cmd, char *ret=NULL, int iTimeout=5000);
+void StopDutCmdServer();
 #endif
 int GetAntCombineNum(int Ant1, int Ant2, int Ant3, int Ant4);
 #endif // !defined(AFX_PEERSOCKET_H__674A623F_4C93_4AE9_84A7_568658FA724E__INCLUDED_)
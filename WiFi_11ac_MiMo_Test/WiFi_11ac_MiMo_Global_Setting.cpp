@@ -3451,6 +3451,21 @@ int InitializeGlobalSettingContainers(void)
         exit(1);
     }
 
+    setting.type = WIFI_SETTING_TYPE_INTEGER;
+    g_globalSettingParam.ANALYSIS_THREAD_NUMBER = 0;
+    if (sizeof(int)==sizeof(g_globalSettingParam.ANALYSIS_THREAD_NUMBER))    // Type_Checking
+    {
+        setting.value = (void*)&g_globalSettingParam.ANALYSIS_THREAD_NUMBER;
+        setting.unit  = "";
+		setting.helpText = "Number of host threads used by the 802.11n/ac MIMO analysis (LP_EnableMultiThread).\r\n0:Tester default;-1:One thread per host CPU core;N:N threads\r\nDefault value is 0";
+        g_globalSettingParamMap.insert( pair<string, WIFI_SETTING_STRUCT>("ANALYSIS_THREAD_NUMBER", setting) );
+    }
+    else    
+    {
+        printf("Parameter Type Error!\n");
+        exit(1);
+    }
+
 
     //setting.type = WIFI_SETTING_TYPE_INTEGER;
     //g_globalSettingParam.IQ_PM_METHOD = 0;
@@ -812,6 +812,9 @@ WIFI_11AC_MIMO_TEST_API int WiFi_11ac_MiMo_TX_Verify_Evm(void)
 #pragma endregion
 
 #pragma region Data capture
+		// Spread the MIMO analysis over the host cores (ANALYSIS_THREAD_NUMBER), a failure only falls back to the tester default
+		SetAnalysisThreadNumber();
+
 		/*------------------*
 		 * Start While Loop *
 		 *------------------*/
@@ -1272,11 +1275,35 @@ WIFI_11AC_MIMO_TEST_API int WiFi_11ac_MiMo_TX_Verify_Evm(void)
 				//else	// g_Tester_Type == IQnxn
 				{
 //					for(int i=0;i<l_txVerifyEvmReturn.SPATIAL_STREAM;i++)  
+					// Fetch the per-stream (and NStream x NVsa) results once, instead of one LP_GetScalarMeasurement() per stream/VSA
+					double evmStream[MAX_TESTER_NUM], ampErrStream[MAX_TESTER_NUM], phaseErrStream[MAX_TESTER_NUM];
+					double isolationDbMatrix[MAX_TESTER_NUM*MAX_TESTER_NUM], rxRmsPowerDbMatrix[MAX_TESTER_NUM*MAX_TESTER_NUM];
+
+					if ( 0==::LP_GetScalarMeasurementArray("evmAvgAll",      evmStream,    g_Tester_Number) ||
+						 0==::LP_GetScalarMeasurementArray("IQImbal_amplDb", ampErrStream, g_Tester_Number) )
+					{
+						LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[WiFi_11ac_MiMo] LP_GetScalarMeasurementArray() of evmAvgAll or IQImbal_amplDb return no result.\n");
+						throw logMessage;
+					}
+					else
+					{
+						// do nothing
+					}
+					::LP_GetScalarMeasurementArray("IQImbal_phaseDeg", phaseErrStream,     g_Tester_Number);
+					::LP_GetScalarMeasurementArray("isolationDb",      isolationDbMatrix,  g_Tester_Number*g_Tester_Number);
+					::LP_GetScalarMeasurementArray("rxRmsPowerDb",     rxRmsPowerDbMatrix, g_Tester_Number*g_Tester_Number);
+
+					// Over all streams
+					double freqErrorAll      = ::LP_GetScalarMeasurement("freqErrorHz",0);
+					double dataRateAll       = ::LP_GetScalarMeasurement("rateInfo_dataRateMbps", 0);
+					double phaseNoiseRmsAll  = ::LP_GetScalarMeasurement("PhaseNoiseDeg_RmsAll", 0);
+					double symbolClockErrAll = ::LP_GetScalarMeasurement("symClockErrorPpm", 0);
+
 					for(int i=0;i<g_Tester_Number;i++)  //not a good way to implement, what if the return value is changed, we should use spatial_stream. 
 					{
 						double evm;
 
-						evm = ::LP_GetScalarMeasurement("evmAvgAll",i); 
+						evm = evmStream[i]; 
 						if (evm!=INVALID_EVM) 
 						{
 							// EVM 
@@ -1287,7 +1314,7 @@ WIFI_11AC_MIMO_TEST_API int WiFi_11ac_MiMo_TX_Verify_Evm(void)
 							{
 								if(i != j)
 								{
-									isolationInTwoStreams[i][j][avgIteration-1] = 0.0 - ::LP_GetScalarMeasurement("isolationDb", (i*validVsaNum)+j); 
+									isolationInTwoStreams[i][j][avgIteration-1] = 0.0 - isolationDbMatrix[(i*validVsaNum)+j]; 
 								}
 								else
 								{
@@ -1298,7 +1325,7 @@ WIFI_11AC_MIMO_TEST_API int WiFi_11ac_MiMo_TX_Verify_Evm(void)
 							//Matrix: Nstream x NVsa, Stream in each VSA, order by prefOrderSignal
 							for(int j=0;j<validVsaNum;j++)
 							{
-								measuredPower = ::LP_GetScalarMeasurement("rxRmsPowerDb", (i*validVsaNum)+j);
+								measuredPower = rxRmsPowerDbMatrix[(i*validVsaNum)+j];
 								if (measuredPower!=NA_NUMBER)
 									measuredPower += l_txVerifyEvmParam.CABLE_LOSS_DB[prefOrderSignal[j]-1];
 								streamRmsInEachBurst[i][avgIteration-1][prefOrderSignal[j]-1]= measuredPower;
@@ -1307,7 +1334,7 @@ WIFI_11AC_MIMO_TEST_API int WiFi_11ac_MiMo_TX_Verify_Evm(void)
 							//Matrix: Nstream x NVsa, VSA in each stream
 							for(int j=0;j<validVsaNum;j++)
 							{
-								measuredPower = ::LP_GetScalarMeasurement("rxRmsPowerDb", i*validVsaNum+j);
+								measuredPower = rxRmsPowerDbMatrix[i*validVsaNum+j];
 								if (measuredPower!=NA_NUMBER)
 									measuredPower += l_txVerifyEvmParam.CABLE_LOSS_DB[prefOrderSignal[j]-1];
 								vsaRmsInEachBurst[prefOrderSignal[j]-1][avgIteration-1][i] = measuredPower;
@@ -1316,7 +1343,7 @@ WIFI_11AC_MIMO_TEST_API int WiFi_11ac_MiMo_TX_Verify_Evm(void)
 							//STREAM_POWER_IN_VSA, streamInVsa
 							for(int j=0;j<g_Tester_Number ;j++)
 							{
-								measuredPower = ::LP_GetScalarMeasurement("rxRmsPowerDb", i*validVsaNum+j);
+								measuredPower = rxRmsPowerDbMatrix[i*validVsaNum+j];
 								if (measuredPower!=NA_NUMBER)
 									measuredPower += l_txVerifyEvmParam.CABLE_LOSS_DB[prefOrderSignal[j]-1];
 								streamInVsa[i][prefOrderSignal[j]-1][avgIteration-1] = measuredPower;
@@ -1324,19 +1351,19 @@ WIFI_11AC_MIMO_TEST_API int WiFi_11ac_MiMo_TX_Verify_Evm(void)
 
 
 							// IQ Match Amplitude Error  (IQ gain imbalance in dB, per stream)
-							ampErrDb[i][avgIteration-1] = ::LP_GetScalarMeasurement("IQImbal_amplDb", i);
-							phaseErr[i][avgIteration-1] = ::LP_GetScalarMeasurement("IQImbal_phaseDeg", i);
+							ampErrDb[i][avgIteration-1] = ampErrStream[i];
+							phaseErr[i][avgIteration-1] = phaseErrStream[i];
 
 							// Frequency Error
-							freqErrorHz[i][avgIteration-1] = ::LP_GetScalarMeasurement("freqErrorHz",0);
+							freqErrorHz[i][avgIteration-1] = freqErrorAll;
 
 							// Datarate
-							l_txVerifyEvmReturn.DATA_RATE = ::LP_GetScalarMeasurement("rateInfo_dataRateMbps", 0); 
+							l_txVerifyEvmReturn.DATA_RATE = dataRateAll; 
 
 							// RMS Phase Noise, mappin the value "RMS Phase Noise" in IQsignal
-							phaseNoiseRms[i][avgIteration-1] = ::LP_GetScalarMeasurement("PhaseNoiseDeg_RmsAll", 0);
+							phaseNoiseRms[i][avgIteration-1] = phaseNoiseRmsAll;
 
-							symbolClockErr[i][avgIteration-1] = ::LP_GetScalarMeasurement("symClockErrorPpm", 0);
+							symbolClockErr[i][avgIteration-1] = symbolClockErrAll;
 						}
 					}
 				}
@@ -1534,11 +1561,35 @@ WIFI_11AC_MIMO_TEST_API int WiFi_11ac_MiMo_TX_Verify_Evm(void)
 				//else	// g_Tester_Type == IQnxn
 				{
 //					for(int i=0;i<l_txVerifyEvmReturn.SPATIAL_STREAM;i++)  
+					// Fetch the per-stream (and NStream x NVsa) results once, instead of one LP_GetScalarMeasurement() per stream/VSA
+					double evmStream[MAX_TESTER_NUM], ampErrStream[MAX_TESTER_NUM], phaseErrStream[MAX_TESTER_NUM];
+					double isolationDbMatrix[MAX_TESTER_NUM*MAX_TESTER_NUM], rxRmsPowerDbMatrix[MAX_TESTER_NUM*MAX_TESTER_NUM];
+
+					if ( 0==::LP_GetScalarMeasurementArray("evmAvgAll",      evmStream,    g_Tester_Number) ||
+						 0==::LP_GetScalarMeasurementArray("IQImbal_amplDb", ampErrStream, g_Tester_Number) )
+					{
+						LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[WiFi_11ac_MiMo] LP_GetScalarMeasurementArray() of evmAvgAll or IQImbal_amplDb return no result.\n");
+						throw logMessage;
+					}
+					else
+					{
+						// do nothing
+					}
+					::LP_GetScalarMeasurementArray("IQImbal_phaseDeg", phaseErrStream,     g_Tester_Number);
+					::LP_GetScalarMeasurementArray("isolationDb",      isolationDbMatrix,  g_Tester_Number*g_Tester_Number);
+					::LP_GetScalarMeasurementArray("rxRmsPowerDb",     rxRmsPowerDbMatrix, g_Tester_Number*g_Tester_Number);
+
+					// Over all streams
+					double freqErrorAll      = ::LP_GetScalarMeasurement("freqErrorHz",0);
+					double dataRateAll       = ::LP_GetScalarMeasurement("rateInfo_dataRateMbps", 0);
+					double phaseNoiseRmsAll  = ::LP_GetScalarMeasurement("PhaseNoiseDeg_RmsAll", 0);
+					double symbolClockErrAll = ::LP_GetScalarMeasurement("symClockErrorPpm", 0);
+
 					for(int i=0;i<g_Tester_Number;i++)  //not a good way to implement, what if the return value is changed, we should use spatial_stream. 
 					{
 						double evm;
 
-						evm = ::LP_GetScalarMeasurement("evmAvgAll",i); 
+						evm = evmStream[i]; 
 						if (evm!=INVALID_EVM) 
 						{
 							// EVM 
@@ -1549,7 +1600,7 @@ WIFI_11AC_MIMO_TEST_API int WiFi_11ac_MiMo_TX_Verify_Evm(void)
 							{
 								if(i != j)
 								{
-									isolationInTwoStreams[i][j][avgIteration-1] = 0.0 - ::LP_GetScalarMeasurement("isolationDb", (i*validVsaNum)+j); 
+									isolationInTwoStreams[i][j][avgIteration-1] = 0.0 - isolationDbMatrix[(i*validVsaNum)+j]; 
 								}
 								else
 								{
@@ -1560,7 +1611,7 @@ WIFI_11AC_MIMO_TEST_API int WiFi_11ac_MiMo_TX_Verify_Evm(void)
 							//Matrix: Nstream x NVsa, Stream in each VSA, order by prefOrderSignal
 							for(int j=0;j<validVsaNum;j++)
 							{
-								measuredPower = ::LP_GetScalarMeasurement("rxRmsPowerDb", (i*validVsaNum)+j);
+								measuredPower = rxRmsPowerDbMatrix[(i*validVsaNum)+j];
 								if (measuredPower!=NA_NUMBER)
 									measuredPower += l_txVerifyEvmParam.CABLE_LOSS_DB[prefOrderSignal[j]-1];
 								streamRmsInEachBurst[i][avgIteration-1][prefOrderSignal[j]-1]= measuredPower;
@@ -1569,7 +1620,7 @@ WIFI_11AC_MIMO_TEST_API int WiFi_11ac_MiMo_TX_Verify_Evm(void)
 							//Matrix: Nstream x NVsa, VSA in each stream
 							for(int j=0;j<validVsaNum;j++)
 							{
-								measuredPower = ::LP_GetScalarMeasurement("rxRmsPowerDb", i*validVsaNum+j);
+								measuredPower = rxRmsPowerDbMatrix[i*validVsaNum+j];
 								if (measuredPower!=NA_NUMBER)
 									measuredPower += l_txVerifyEvmParam.CABLE_LOSS_DB[prefOrderSignal[j]-1];
 								vsaRmsInEachBurst[prefOrderSignal[j]-1][avgIteration-1][i] = measuredPower;
@@ -1578,7 +1629,7 @@ WIFI_11AC_MIMO_TEST_API int WiFi_11ac_MiMo_TX_Verify_Evm(void)
 							//STREAM_POWER_IN_VSA, streamInVsa
 							for(int j=0;j<g_Tester_Number ;j++)
 							{
-								measuredPower = ::LP_GetScalarMeasurement("rxRmsPowerDb", i*validVsaNum+j);
+								measuredPower = rxRmsPowerDbMatrix[i*validVsaNum+j];
 								if (measuredPower!=NA_NUMBER)
 									measuredPower += l_txVerifyEvmParam.CABLE_LOSS_DB[prefOrderSignal[j]-1];
 								streamInVsa[i][prefOrderSignal[j]-1][avgIteration-1] = measuredPower;
@@ -1586,19 +1637,19 @@ WIFI_11AC_MIMO_TEST_API int WiFi_11ac_MiMo_TX_Verify_Evm(void)
 
 
 							// IQ Match Amplitude Error  (IQ gain imbalance in dB, per stream)
-							ampErrDb[i][avgIteration-1] = ::LP_GetScalarMeasurement("IQImbal_amplDb", i);
-							phaseErr[i][avgIteration-1] = ::LP_GetScalarMeasurement("IQImbal_phaseDeg", i);
+							ampErrDb[i][avgIteration-1] = ampErrStream[i];
+							phaseErr[i][avgIteration-1] = phaseErrStream[i];
 
 							// Frequency Error
-							freqErrorHz[i][avgIteration-1] = ::LP_GetScalarMeasurement("freqErrorHz",0);
+							freqErrorHz[i][avgIteration-1] = freqErrorAll;
 
 							// Datarate
-							l_txVerifyEvmReturn.DATA_RATE = ::LP_GetScalarMeasurement("rateInfo_dataRateMbps", 0); 
+							l_txVerifyEvmReturn.DATA_RATE = dataRateAll; 
 
 							// RMS Phase Noise, mappin the value "RMS Phase Noise" in IQsignal
-							phaseNoiseRms[i][avgIteration-1] = ::LP_GetScalarMeasurement("PhaseNoiseDeg_RmsAll", 0);
+							phaseNoiseRms[i][avgIteration-1] = phaseNoiseRmsAll;
 
-							symbolClockErr[i][avgIteration-1] = ::LP_GetScalarMeasurement("symClockErrorPpm", 0);
+							symbolClockErr[i][avgIteration-1] = symbolClockErrAll;
 						}
 					}
 				}
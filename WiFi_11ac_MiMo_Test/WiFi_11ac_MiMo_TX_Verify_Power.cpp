@@ -2,7 +2,9 @@
 #include "TestManager.h"
 #include "WiFi_11ac_MiMo_Test.h"
 #include "WiFi_11ac_MiMo_Test_Internal.h"
+#include "IQmeasure.h"
 #include "vDUT.h"
+#include <math.h>
 
 using namespace std;
 
@@ -114,6 +116,334 @@ int CheckTxPowerParameters( int *bssBW,
 						  double *peakToAvgRatio, 
 						  char* errorMsg );
 
+// Set by WiFi_TX_Verify_Power_All_Chains(), WiFi_TX_Verify_Power() then captures all chains at once
+static bool l_txVerifyPowerAllChains = false;
+
+#define ALL_CHAINS_GATE_WINDOW_US	1.0		// power averaging window of the burst detection
+#define ALL_CHAINS_GATE_DB			20.0	// windows within 20 dB of the strongest one are burst
+
+typedef struct tagAllChainsSegment
+{
+	double	*real;
+	double	*imag;
+	int		length;
+	double	sampleFreqHz;
+	int		vsaIndex;				// index of the POWER_DBM_xxx_VSAn results
+	double	cableLossDb;			// cable loss of the chain, CABLE_LOSS_DB_VSAn
+	double	startUs;				// position in the capture, for LP_SelectCaptureRangeForAnalysis()
+	double	powerAvgDb;				// burst average of |x|^2, not calibrated
+	double	powerPkDb;				// peak of |x|^2, not calibrated
+} ALL_CHAINS_SEGMENT;
+
+// Burst average and peak power of one chain, run on a thread of its own
+static DWORD WINAPI AllChainsPowerWorker(LPVOID context)
+{
+	ALL_CHAINS_SEGMENT *segment = (ALL_CHAINS_SEGMENT*)context;
+	int window = max(1, (int)(segment->sampleFreqHz*ALL_CHAINS_GATE_WINDOW_US/1e6));
+	int windowNum = segment->length/window;
+	vector<double> windowPower(windowNum, 0.0);
+	double maxWindowPower = 0, maxPower = 0;
+
+	for (int w=0;w<windowNum;w++)
+	{
+		for (int i=w*window;i<(w+1)*window;i++)
+		{
+			double power = segment->real[i]*segment->real[i] + segment->imag[i]*segment->imag[i];
+			windowPower[w] += power;
+			maxPower = max(maxPower, power);
+		}
+		windowPower[w] /= window;
+		maxWindowPower = max(maxWindowPower, windowPower[w]);
+	}
+
+	double burstPower = 0;
+	int    burstWindows = 0;
+	for (int w=0;w<windowNum;w++)
+	{
+		if ( windowPower[w]>=maxWindowPower*pow(10.0, -ALL_CHAINS_GATE_DB/10) )
+		{
+			burstPower += windowPower[w];
+			burstWindows++;
+		}
+		else
+		{
+			// do nothing
+		}
+	}
+
+	segment->powerAvgDb = (0<burstWindows && 0<burstPower) ? 10*log10(burstPower/burstWindows) : NA_NUMBER;
+	segment->powerPkDb  = (0<maxPower) ? 10*log10(maxPower) : NA_NUMBER;
+
+	return 0;
+}
+
+// MPTA ports switched for the enabled chains, the MPTA captures them one after another.  The other sets of chains,
+// such as TX1~TX4, are captured one VSA at a time by WiFi_TX_Verify_Power().
+static bool AllChainsMptaPath(int txEnabled[], TX_PATH_ENUM *txPath)
+{
+	int chainMask = (txEnabled[0]?1:0) | (txEnabled[1]?2:0) | (txEnabled[2]?4:0) | (txEnabled[3]?8:0);
+	switch (chainMask)
+	{
+	case 0x1: *txPath = eTX_PATH_1;   break;
+	case 0x2: *txPath = eTX_PATH_2;   break;
+	case 0x4: *txPath = eTX_PATH_3;   break;
+	case 0x3: *txPath = eTX_PATH_12;  break;
+	case 0x5: *txPath = eTX_PATH_13;  break;
+	case 0x7: *txPath = eTX_PATH_123; break;
+	default:  return false;
+	}
+	return true;
+}
+
+//! Captures all enabled chains at once and analyzes them in parallel
+/*!
+ * With a tester per chain, the VSAs set by LP_SetVsaNxN() capture the chains together.  With fewer testers, the
+ * MPTA switches the chains to VSA1 in one capture of samplingTimeUs per chain, chain n is returned as VSAn.
+ * The power of each chain is computed on the host on a thread per chain; the first chain is also analyzed by
+ * LP_AnalyzePower(), its result calibrates the host power of all chains to dBm at the tester port.  The returned
+ * power includes the cable loss of each chain.
+ */
+static int CaptureAllChainsPower( int txEnabled[], int vsaMappingTx[], double samplingTimeUs, double sampleFreqHz, double peakPowerDbm,
+								  double cableLossDb[], double powerAvgDbm[MAX_TESTER_NUM], double powerPkDbm[MAX_TESTER_NUM], char *errorMsg )
+{
+	int err = ERR_OK;
+	int chainNum = txEnabled[0] + txEnabled[1] + txEnabled[2] + txEnabled[3];
+	bool mptaCapture = (chainNum>g_Tester_Number);
+	TX_PATH_ENUM txPath = eTX_PATH_ALL;
+
+	if (mptaCapture)
+	{
+		if ( !::LP_MptaAvailable() )
+		{
+			sprintf_s(errorMsg, MAX_BUFFER_SIZE, "[WiFi_11ac_MiMo] %d chains need %d testers or an MPTA, %d tester(s) connected.\n", chainNum, chainNum, g_Tester_Number);
+			return -1;
+		}
+		else if ( !AllChainsMptaPath(txEnabled, &txPath) )
+		{
+			sprintf_s(errorMsg, MAX_BUFFER_SIZE, "[WiFi_11ac_MiMo] The MPTA cannot capture TX1=%d TX2=%d TX3=%d TX4=%d.\n", txEnabled[0], txEnabled[1], txEnabled[2], txEnabled[3]);
+			return -1;
+		}
+		else
+		{
+			err = ::LP_MptaEnable();
+			if (ERR_OK==err)
+			{
+				err = ::LP_MptaSetupCapture(txPath, l_txVerifyPowerParam.CH_FREQ_MHZ*1e6, peakPowerDbm, samplingTimeUs);
+				if (ERR_OK==err)
+				{
+					// The switched capture holds one segment of samplingTimeUs per chain
+					err = ::LP_VsaDataCapture( chainNum*samplingTimeUs/1000000, g_globalSettingParam.VSA_TRIGGER_TYPE, sampleFreqHz, 0 );
+				}
+				else
+				{
+					// do nothing
+				}
+				::LP_MptaDisable();
+			}
+			else
+			{
+				// do nothing
+			}
+		}
+	}
+	else
+	{
+		err = ::LP_VsaDataCapture( samplingTimeUs/1000000, g_globalSettingParam.VSA_TRIGGER_TYPE, sampleFreqHz, 0 );
+		if ( ERR_OK!=err )
+		{
+			double rxAmpl;
+			LP_Agc(&rxAmpl, TRUE);	// do auto range on all testers
+			err = ::LP_VsaDataCapture( samplingTimeUs/1000000, g_globalSettingParam.VSA_TRIGGER_TYPE, sampleFreqHz, 0 );
+		}
+		else
+		{
+			// do nothing
+		}
+	}
+	if ( ERR_OK!=err )
+	{
+		sprintf_s(errorMsg, MAX_BUFFER_SIZE, "[WiFi_11ac_MiMo] Fail to capture all chains (%s).\n", mptaCapture?"MPTA":"NxN");
+		return err;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	double	*real[MAX_TESTER_NUM] = {NULL};
+	double	*imag[MAX_TESTER_NUM] = {NULL};
+	int		length[MAX_TESTER_NUM] = {0};
+	double	captureFreqHz[MAX_TESTER_NUM] = {0};
+	err = ::LP_GetHndlDataPointers(real, imag, length, captureFreqHz, MAX_TESTER_NUM);
+	if ( ERR_OK!=err )
+	{
+		sprintf_s(errorMsg, MAX_BUFFER_SIZE, "[WiFi_11ac_MiMo] LP_GetHndlDataPointers() return error.\n");
+		return err;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	vector<ALL_CHAINS_SEGMENT> segments;
+	ALL_CHAINS_SEGMENT segment;
+	memset(&segment, 0, sizeof(segment));
+	if (mptaCapture)
+	{
+		// One segment per enabled chain, in chain order; VSAn is chain n
+		for (int i=0;i<MAX_TESTER_NUM;i++)
+		{
+			vsaMappingTx[i] = i+1;
+		}
+		int segmentLength = (int)(samplingTimeUs*captureFreqHz[0]/1e6);
+		for (int chain=0;chain<MAX_CHAIN_NUM;chain++)
+		{
+			if (txEnabled[chain])
+			{
+				int offset = (int)segments.size()*segmentLength;
+				if ( NULL==real[0] || offset+segmentLength>length[0] )
+				{
+					sprintf_s(errorMsg, MAX_BUFFER_SIZE, "[WiFi_11ac_MiMo] The MPTA capture has no segment for TX%d.\n", chain+1);
+					return -1;
+				}
+				else
+				{
+					segment.real         = real[0]+offset;
+					segment.imag         = imag[0]+offset;
+					segment.length       = segmentLength;
+					segment.sampleFreqHz = captureFreqHz[0];
+					segment.vsaIndex     = chain;
+					segment.cableLossDb  = cableLossDb[chain];
+					segment.startUs      = offset*1e6/captureFreqHz[0];
+					segments.push_back(segment);
+				}
+			}
+			else
+			{
+				// do nothing
+			}
+		}
+	}
+	else
+	{
+		for (int i=0;i<MAX_TESTER_NUM;i++)
+		{
+			if (txEnabled[vsaMappingTx[i]-1])
+			{
+				if ( NULL==real[i] || 0>=length[i] )
+				{
+					sprintf_s(errorMsg, MAX_BUFFER_SIZE, "[WiFi_11ac_MiMo] VSA%d has no capture.\n", i+1);
+					return -1;
+				}
+				else
+				{
+					segment.real         = real[i];
+					segment.imag         = imag[i];
+					segment.length       = length[i];
+					segment.sampleFreqHz = captureFreqHz[i];
+					segment.vsaIndex     = i;
+					segment.cableLossDb  = cableLossDb[i];
+					segment.startUs      = 0;
+					segments.push_back(segment);
+				}
+			}
+			else
+			{
+				// do nothing
+			}
+		}
+	}
+	if (segments.empty())
+	{
+		sprintf_s(errorMsg, MAX_BUFFER_SIZE, "[WiFi_11ac_MiMo] No chain is enabled.\n");
+		return -1;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	// The chains are independent, each one is analyzed on a thread of its own
+	vector<HANDLE> threads;
+	for (size_t i=0;i<segments.size();i++)
+	{
+		HANDLE thread = CreateThread(NULL, 0, AllChainsPowerWorker, &segments[i], 0, NULL);
+		if (NULL!=thread)
+		{
+			threads.push_back(thread);
+		}
+		else
+		{
+			AllChainsPowerWorker(&segments[i]);
+		}
+	}
+
+	// Meanwhile the tester analyzes the first chain, for the calibration
+	if (mptaCapture)
+	{
+		err = ::LP_SelectCaptureRangeForAnalysis(segments[0].startUs, samplingTimeUs);
+	}
+	else
+	{
+		err = ::LP_SetAnalysisParameterInteger("AnalyzePower", "vsaNum", segments[0].vsaIndex+1);
+	}
+	if (ERR_OK==err)
+	{
+		err = ::LP_AnalyzePower( 3.2/1000000, 15.0 );
+	}
+	else
+	{
+		// do nothing
+	}
+	double referenceAvgDbm = ::LP_GetScalarMeasurement("P_av_each_burst_dBm",0);
+	double referencePkDbm  = ::LP_GetScalarMeasurement("P_pk_each_burst_dBm",0);
+
+	if (!threads.empty())
+	{
+		WaitForMultipleObjects((DWORD)threads.size(), &threads[0], TRUE, INFINITE);
+		for (size_t i=0;i<threads.size();i++)
+		{
+			CloseHandle(threads[i]);
+		}
+	}
+	else
+	{
+		// do nothing
+	}
+
+	if ( ERR_OK!=err || -99.00>=referenceAvgDbm || NA_NUMBER==segments[0].powerAvgDb )
+	{
+		sprintf_s(errorMsg, MAX_BUFFER_SIZE, "[WiFi_11ac_MiMo] LP_AnalyzePower() of VSA%d return error.\n", segments[0].vsaIndex+1);
+		return (ERR_OK!=err) ? err : -1;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	double calibrationDb = referenceAvgDbm - segments[0].powerAvgDb;
+	for (size_t i=0;i<segments.size();i++)
+	{
+		if (NA_NUMBER==segments[i].powerAvgDb)
+		{
+			sprintf_s(errorMsg, MAX_BUFFER_SIZE, "[WiFi_11ac_MiMo] No signal on VSA%d.\n", segments[i].vsaIndex+1);
+			return -1;
+		}
+		else if (0==i)
+		{
+			powerAvgDbm[segments[i].vsaIndex] = referenceAvgDbm + segments[i].cableLossDb;
+			powerPkDbm[segments[i].vsaIndex]  = referencePkDbm  + segments[i].cableLossDb;
+		}
+		else
+		{
+			powerAvgDbm[segments[i].vsaIndex] = segments[i].powerAvgDb + calibrationDb + segments[i].cableLossDb;
+			powerPkDbm[segments[i].vsaIndex]  = segments[i].powerPkDb  + calibrationDb + segments[i].cableLossDb;
+		}
+	}
+
+	return ERR_OK;
+}
+
 
 //! WiFi TX Verify POWER
 /*!
@@ -620,6 +950,34 @@ WIFI_11AC_MIMO_TEST_API int WiFi_TX_Verify_Power(void)
 		}
 
 		
+		// The MPTA switches only some sets of chains, the others are captured one VSA at a time
+		bool allChainsCapture = l_txVerifyPowerAllChains;
+		int  allChainsNum = (txEnabled[0]?1:0) + (txEnabled[1]?1:0) + (txEnabled[2]?1:0) + (txEnabled[3]?1:0);
+		double allChainsPeakDbm = NA_NUMBER;
+		for (int chain=0;chain<MAX_CHAIN_NUM;chain++)
+		{
+			if (txEnabled[chain])
+			{
+				// Through the MPTA, all chains share VSA1: its level fits the strongest one
+				allChainsPeakDbm = max(allChainsPeakDbm, l_txVerifyPowerParam.TX_POWER_DBM-l_txVerifyPowerParam.CABLE_LOSS_DB[chain]+peakToAvgRatio);
+			}
+			else
+			{
+				// do nothing
+			}
+		}
+		TX_PATH_ENUM allChainsPath = eTX_PATH_1;
+		if ( allChainsCapture && allChainsNum>g_Tester_Number && !AllChainsMptaPath(txEnabled, &allChainsPath) )
+		{
+			allChainsCapture = false;
+			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_WARNING, "[WiFi_11ac_MiMo] The MPTA cannot capture TX1=%d TX2=%d TX3=%d TX4=%d together, the chains are captured one VSA at a time.\n",
+							 txEnabled[0], txEnabled[1], txEnabled[2], txEnabled[3]);
+		}
+		else
+		{
+			// do nothing
+		}
+
 		/*------------------------------*
 		 * Start while loop for average *
 		 *------------------------------*/
@@ -639,6 +997,48 @@ WIFI_11AC_MIMO_TEST_API int WiFi_TX_Verify_Power(void)
 			/*------------------------------------------------------------*/
 			VHTMode = 0;
 
+			if (allChainsCapture)
+			{
+				vector<double> powerAvgDbm(MAX_TESTER_NUM, NA_NUMBER), powerPkDbm(MAX_TESTER_NUM, NA_NUMBER);
+				err = CaptureAllChainsPower( txEnabled, vsaMappingTx, samplingTimeUs, sampleFreqHz, allChainsPeakDbm, l_txVerifyPowerParam.CABLE_LOSS_DB,
+											 &powerAvgDbm[0], &powerPkDbm[0], vErrorMsg );
+				if ( ERR_OK!=err )
+				{
+					sprintf_s(sigFileNameBuffer, MAX_BUFFER_SIZE, "%s_%d_%s_%s", "WiFi_TX_Power_All_Chains_Failed", l_txVerifyPowerParam.CH_FREQ_MHZ, l_txVerifyPowerParam.DATA_RATE, l_txVerifyPowerParam.CH_BANDWIDTH);
+					WiFiSaveSigFile(sigFileNameBuffer);
+					LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, vErrorMsg);
+					throw logMessage;
+				}
+				else
+				{
+					LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[WiFi_11ac_MiMo] CaptureAllChainsPower() return OK.\n");
+				}
+				if (1==g_globalSettingParam.VSA_SAVE_CAPTURE_ALWAYS)
+				{
+					sprintf_s(sigFileNameBuffer, MAX_BUFFER_SIZE, "%s_%d_%s_%s", "WiFi_TX_Power_All_Chains_SaveAlways", 
+						l_txVerifyPowerParam.CH_FREQ_MHZ, l_txVerifyPowerParam.DATA_RATE, l_txVerifyPowerParam.CH_BANDWIDTH);
+					WiFiSaveSigFile(sigFileNameBuffer);
+				}
+				else
+				{
+					// do nothing
+				}
+
+				for (int i=0;i<MAX_TESTER_NUM;i++)
+				{
+					powerRMSEachBurst[i][avgIteration] = powerAvgDbm[i];
+					powerPKEachBurst[i][avgIteration]  = powerPkDbm[i];
+				}
+				captureOK  = true;
+				analysisOK = true;
+				avgIteration++;
+				continue;
+			}
+			else
+			{
+				// do nothing
+			}
+
 			err = ::LP_VsaDataCapture( samplingTimeUs/1000000, g_globalSettingParam.VSA_TRIGGER_TYPE, sampleFreqHz, VHTMode );     
 			if ( ERR_OK!=err )
 			{
@@ -1006,6 +1406,23 @@ WIFI_11AC_MIMO_TEST_API int WiFi_TX_Verify_Power(void)
     return err;
 }
 
+//! WiFi TX Verify POWER of all chains in one capture
+/*!
+* Same input parameters and return values as WiFi_TX_Verify_Power(), the enabled chains (TX1~TX4) are captured at
+* once, by a tester per chain or through the MPTA, and analyzed in parallel instead of one TX_VERIFY_POWER per chain.
+*
+* \return 0 No error occurred
+* \return -1 Error(s) occurred.  Please see the returned error message for details
+*/
+WIFI_11AC_MIMO_TEST_API int WiFi_TX_Verify_Power_All_Chains(void)
+{
+	l_txVerifyPowerAllChains = true;
+	int err = WiFi_TX_Verify_Power();
+	l_txVerifyPowerAllChains = false;
+
+	return err;
+}
+
 int InitializeTXVerifyPowerContainers(void)
 {
     /*------------------*
@@ -99,6 +99,7 @@ WIFI_11AC_MIMO_TEST_API int WIFI_11AC_MIMO_technologyRegister()
         TM_InstallCallbackFunction(technologyID, "TX_VERIFY_MASK",       WiFi_TX_Verify_Mask);
         TM_InstallCallbackFunction(technologyID, "RX_VERIFY_PER",        WiFi_RX_Verify_Per);
         TM_InstallCallbackFunction(technologyID, "TX_VERIFY_POWER",      WiFi_TX_Verify_Power);
+        TM_InstallCallbackFunction(technologyID, "TX_VERIFY_POWER_ALL_CHAINS", WiFi_TX_Verify_Power_All_Chains);
         TM_InstallCallbackFunction(technologyID, "TX_VERIFY_SPECTRUM",   WiFi_TX_Verify_Spectrum);
 
         TM_InstallCallbackFunction(technologyID, "TX_CALIBRATION",       WiFi_TX_Calibration);        
@@ -78,6 +78,7 @@ WIFI_11AC_MIMO_TEST_API int WiFi_11ac_MiMo_TX_Verify_Evm(void);
 WIFI_11AC_MIMO_TEST_API int WiFi_RX_Verify_Per(void);
 WIFI_11AC_MIMO_TEST_API int WiFi_TX_Verify_Mask(void);
 WIFI_11AC_MIMO_TEST_API int WiFi_TX_Verify_Power(void);
+WIFI_11AC_MIMO_TEST_API int WiFi_TX_Verify_Power_All_Chains(void);
 WIFI_11AC_MIMO_TEST_API int WiFi_TX_Verify_Spectrum(void);
 WIFI_11AC_MIMO_TEST_API int WiFi_TX_Calibration(void);
 WIFI_11AC_MIMO_TEST_API int WiFi_Write_Eeprom(void);
@@ -140,6 +141,7 @@ WIFI_11AC_MIMO_TEST_API int       GetWaveformFileName(char* perfix, char* postfi
 WIFI_11AC_MIMO_TEST_API int       GetPacketNumber(int wifiMode,  char* packetFormat, int *packetNumber);
 WIFI_11AC_MIMO_TEST_API double    CalcCableLossDb(int ant1, int ant2, int ant3, int ant4, double cableLoss1, double cableLoss2, double cableLoss3, double cableLoss4);
 WIFI_11AC_MIMO_TEST_API int       WiFiSaveSigFile(char* fileName);
+WIFI_11AC_MIMO_TEST_API int       SetAnalysisThreadNumber(void);
 WIFI_11AC_MIMO_TEST_API int       CheckPathLossTable(int testID, int freqMHz, int ant01, int ant02, int ant03, int ant04, double *cableLoss, double *cableLossReturn, double *cableLossDb);
 WIFI_11AC_MIMO_TEST_API int       CheckPathLossTableExt(int testID, int freqMHz, int ant01, int ant02, int ant03, int ant04, double *cableLoss, double *cableLossReturn, double *cableLossDb, int indicatorTxRx);
 WIFI_11AC_MIMO_TEST_API int       AverageTestResult(double *resultArray, int averageTimes, int logType, double &averageResult, double &maxResult, double &minResult);
@@ -2,6 +2,7 @@
 #include "WiFi_11ac_MiMo_Test.h"
 #include "IQlite_Logger.h"
 #include "IQmeasure.h"
+#include "WiFi_RateTable.h"
 #include "math.h"
 
 using namespace std;
@@ -478,6 +479,18 @@ int  ReturnErrorMessage(char *errParameter, const char *format, ...)
 int  LogReturnMessage(char *errMsg, int sizeOfBuf, LOGGER_LEVEL level, const char *format, ...)
 {
     int  err = ERR_OK;
+
+	// Warnings and information the logger discards are not formatted, errMsg only gets the format.
+	// Errors are always formatted, the callers throw errMsg.
+	if ( g_Logger_ID>=0 && level>LOGGER_ERROR && !::LOGGER_IsEnabled(MAX_LOGGER_SOURCE, level) )
+	{
+		strncpy_s(errMsg, sizeOfBuf, format, _TRUNCATE);
+		return err;
+	}
+	else
+	{
+		// do nothing
+	}
 	
 	// Log message format ... variable argument list
 	va_list ap;
@@ -488,7 +501,7 @@ int  LogReturnMessage(char *errMsg, int sizeOfBuf, LOGGER_LEVEL level, const cha
 	// Write error message to log file
 	if (g_Logger_ID>=0)
 	{
-		err = ::LOGGER_Write(g_Logger_ID, level, errMsg);
+		err = ::LOGGER_Write(g_Logger_ID, level, "%s", errMsg);
 		// TODO: if possible, must do the error handling here
 	}
 	else
@@ -989,6 +1002,50 @@ int  WiFiSaveSigFile(char* fileName)
 	return err;
 }
 
+int  SetAnalysisThreadNumber(void)
+{
+	int    err = ERR_OK;
+	int    threadNumber = g_globalSettingParam.ANALYSIS_THREAD_NUMBER;
+	char   logMessage[MAX_BUFFER_SIZE] = {'\0'};
+
+	if (0==threadNumber)
+	{
+		// Keep the tester default
+		return ERR_OK;
+	}
+	else if (0>threadNumber)
+	{
+		SYSTEM_INFO sysInfo;
+		::GetSystemInfo(&sysInfo);
+		threadNumber = (int)sysInfo.dwNumberOfProcessors;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	if (1<threadNumber)
+	{
+		err = ::LP_EnableMultiThread(1, threadNumber);
+	}
+	else
+	{
+		err = ::LP_EnableMultiThread(0, 1);
+	}
+
+	if ( ERR_OK!=err )
+	{
+		// Not fatal, the analysis still runs with the tester default
+		LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_WARNING, "[WiFi_11ac_MiMo] LP_EnableMultiThread(%d) return error, analysis uses the tester default.\n", threadNumber);
+	}
+	else
+	{
+		LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[WiFi_11ac_MiMo] LP_EnableMultiThread(%d) return OK.\n", threadNumber);
+	}
+
+	return err;
+}
+
 int GetDefaultWaveformFileName(char* filePath,char* fileType,int wifiMode,  int streamNum_11AC,int chBW,
 							char* datarate, char* preamble, char* packetFormat, char* guardInterval, 
 							 char* waveformFileName, int bufferSize)
@@ -1007,13 +1064,16 @@ int GetDefaultWaveformFileName(char* filePath,char* fileType,int wifiMode,  int
 			 fileType = "ref";
 	 }
 
+	 // 802.11b and 802.11ag waveforms are named after the rate, which must be of the family of the mode
+	 const WIFI_RATE_DESCRIPTOR *rate = WiFiRate_FindByName(datarate);
+
 	 if ( wifiMode == WIFI_11B)		// 802.11b
 	 {
 		 if ( 0 == strcmp( datarate, "DSSS-1"))
 		 {
 			 sprintf_s(tempWaveformFileName, bufferSize, "WiFi_%s.%s", datarate, fileType);
 		 }
-		 else if ( (strstr(datarate, "DSSS")!=NULL)||(strstr(datarate, "CCK")!=NULL) )
+		 else if ( NULL!=rate && (WIFI_RATE_DSSS==rate->family || WIFI_RATE_CCK==rate->family) )
 		 {
 			 char tmpPreamble[2]; 
 			 tmpPreamble[0] = preamble[0];
@@ -1038,7 +1098,7 @@ int GetDefaultWaveformFileName(char* filePath,char* fileType,int wifiMode,  int
 	 }
 	 else if ( wifiMode ==  WIFI_11AG)		//802.11ag
 	 {
-		 if ( (strstr(datarate, "OFDM")!=NULL) )
+		 if ( NULL!=rate && WIFI_RATE_OFDM==rate->family )
 		 {
 			 sprintf_s(tempWaveformFileName, bufferSize, "WiFi_%s.%s", datarate, fileType);
 		 }
@@ -1274,42 +1334,13 @@ int  GetWaveformFileName(char* perfix, char* postfix, int wifiMode, char* bandwi
 {
     int  err = ERR_OK;
 
-	char keyword[MAX_BUFFER_SIZE] = {'\0'}, datarateString[MAX_BUFFER_SIZE] = {'\0'};
-	int  rateIndexBegin = 0, rateIndexEnd = 0;
+	char keyword[MAX_BUFFER_SIZE] = {'\0'};
 
 	map<string, WIFI_SETTING_STRUCT>::iterator inputMap_Iter;
 
-	// Find out the datarate index
-/*	if ( (wifiMode==WIFI_11B)||(wifiMode==WIFI_11AG) )
-	{
-		for (int i=0;i<MAX_BUFFER_SIZE;i++)
-		{
-			if (datarate[i] == '-')
-			{
-				rateIndexBegin = i+1;
-			}
-			else if (datarate[i] == '\0')
-			{
-				rateIndexEnd = i;
-				break;
-			}
-			else
-			{	
-				// do nothing, keep searching...
-			}
-		}
-		// Copy the datarate 
-		int rateIndex = 0;
-		for (int i=rateIndexBegin;i<=rateIndexEnd;i++)
-		{
-			datarateString[rateIndex] = datarate[i];
-			rateIndex++;
-		}
-	}
-	else	// WIFI_11N_HT20 or WIFI_11N_HT40
-	{
-		// do nothing
-	}
+	// Find out the datarate keyword, e.g. "54" for OFDM-54 (not used by 802.11n)
+/*	const WIFI_RATE_DESCRIPTOR *rate = WiFiRate_FindByName(datarate);
+	const char *datarateString = (NULL==rate) ? "" : rate->waveformKey;
 
 	// Find out the keyword of the waveform file name
 	if (wifiMode==WIFI_11B)
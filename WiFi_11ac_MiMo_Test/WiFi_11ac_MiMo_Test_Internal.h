@@ -197,6 +197,7 @@ typedef struct tagGlobalSettingParam
     int    ANALYSIS_11AC_DECODE_PSDU;
     int    ANALYSIS_11AC_FULL_PACKET_CHANNEL_EST;
 	int    ANALYSIS_11AC_FREQUENCY_CORRELATION;
+	int    ANALYSIS_THREAD_NUMBER;                  /*!< Number of host threads for MIMO analysis. 0: tester default, -1: one per host core */
 
     // Power Measurement related parameters
     //RW-20090426: removed IQ_PM_METHOD
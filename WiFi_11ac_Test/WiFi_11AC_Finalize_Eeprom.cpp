@@ -0,0 +1,262 @@
+#include "stdafx.h"
+#include "TestManager.h"
+#include "WiFi_11AC_Test.h"
+#include "WiFi_11AC_Test_Internal.h"
+#include "IQmeasure.h"
+#include "vDUT.h"
+
+// This variable is declared in WiFi_Test_Internal.cpp
+extern vDUT_ID      g_WiFi_11ac_Dut;
+extern TM_ID        g_WiFi_11ac_Test_ID;
+extern WIFI_GLOBAL_SETTING g_WiFi11ACGlobalSettingParam;
+
+using namespace std;
+
+#pragma region Define Input and Return structures (two containers and two structs)
+
+// Input Parameter Container
+map<string, WIFI_SETTING_STRUCT> l_11ACfinalizeEepromParamMap;
+
+// Return Value Container 
+map<string, WIFI_SETTING_STRUCT> l_11ACfinalizeEepromReturnMap;
+
+struct tagReturn
+{
+    char EEPROM_RETURN[MAX_BUFFER_SIZE];         /*!< A string contains information that return from EEPROM.  */
+    int    EEPROM_DUT_WRITES_SAVED;              /*!< DUT writes the write-back cache did not run, 0 without EEPROM_WRITE_BACK_CACHE. */
+    double EEPROM_FLUSH_TIME;                    /*!< Measured time of the DUT writes at finalize, 0 without EEPROM_WRITE_BACK_CACHE. */
+    char ERROR_MESSAGE[MAX_BUFFER_SIZE];         /*!< A string for error message. */
+} l_11ACfinalizeEepromReturn;
+
+void Clear11ACFinalizeEepromReturn(void)
+{
+	l_11ACfinalizeEepromParamMap.clear();
+	l_11ACfinalizeEepromReturnMap.clear();
+}
+
+#pragma endregion
+
+
+//! WIFI_11AC_Finalize_Eeprom
+/*!
+* Input Parameters
+*
+*  - Mandatory 
+*      -# None
+*
+* Return Values
+*      -# A string contains information that return from EEPROM
+*      -# A string for error message
+*
+* \return 0 No error occurred
+* \return -1 DUT failed to insert.  Please see the returned error message for details
+*/
+
+
+WIFI_11AC_TEST_API int WIFI_11AC_Finalize_Eeprom(void)
+{
+    int  err = ERR_OK;
+    int  dummyValue = 0;
+	char vErrorMsg[MAX_BUFFER_SIZE]  = {'\0'};
+	char logMessage[MAX_BUFFER_SIZE] = {'\0'};
+
+	/*---------------------------------------*
+	* Clear Return Parameters and Container *
+	*---------------------------------------*/
+	ClearReturnParameters(l_11ACfinalizeEepromReturnMap);
+
+	/*------------------------*
+	* Respond to QUERY_INPUT *
+	*------------------------*/
+	err = TM_GetIntegerParameter(g_WiFi_11ac_Test_ID, "QUERY_INPUT", &dummyValue);
+	if( ERR_OK==err )
+	{
+		RespondToQueryInput(l_11ACfinalizeEepromParamMap);
+		return err;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	/*-------------------------*
+	* Respond to QUERY_RETURN *
+	*-------------------------*/
+	err = TM_GetIntegerParameter(g_WiFi_11ac_Test_ID, "QUERY_RETURN", &dummyValue);
+	if( ERR_OK==err )
+	{
+		RespondToQueryReturn(l_11ACfinalizeEepromReturnMap);
+		return err;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	try
+	{
+		/*-----------------------------------------------------------*
+		* Both g_WiFi_11ac_Test_ID and g_WiFi_11ac_Dut need to be valid (>=0) *
+		*-----------------------------------------------------------*/
+		if( g_WiFi_11ac_Test_ID<0 || g_WiFi_11ac_Dut<0 )  
+		{
+			err = -1;
+			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[WiFi_11AC] WiFi_Test_ID or WiFi_Dut not valid. WiFi_Test_ID = %d and WiFi_Dut = %d.\n", g_WiFi_11ac_Test_ID, g_WiFi_11ac_Dut);
+			throw logMessage;
+		}
+		else
+		{
+			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[WiFi_11AC] WiFi_Test_ID = %d and WiFi_Dut = %d.\n", g_WiFi_11ac_Test_ID, g_WiFi_11ac_Dut);
+		}
+		
+		TM_ClearReturns(g_WiFi_11ac_Test_ID);
+
+        // Error return of this function is irrelevant
+        CheckDutTransmitStatus();
+
+		::vDUT_EnableEepromCache(g_WiFi_11ac_Dut, g_WiFi11ACGlobalSettingParam.EEPROM_WRITE_BACK_CACHE);
+		err = vDUT_Run(g_WiFi_11ac_Dut, "FINALIZE_EEPROM");		
+		if ( ERR_OK!=err )
+		{	// Check vDut return "ERROR_MESSAGE" or not, if "Yes", must handle it.
+			err = ::vDUT_GetStringReturn(g_WiFi_11ac_Dut, "ERROR_MESSAGE", vErrorMsg, MAX_BUFFER_SIZE);
+			if ( ERR_OK==err )	// Get "ERROR_MESSAGE" from vDut
+			{
+				err = -1;	// set err to -1, means "Error".
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, vErrorMsg);
+				throw logMessage;
+			}
+			else	// Just return normal error message in this case
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[WiFi_11AC] vDUT_Run(FINALIZE_EEPROM) return error.\n");
+				throw logMessage;
+			}
+		}
+		else
+		{
+			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[WiFi_11AC] vDUT_Run(FINALIZE_EEPROM) return OK.\n");
+		}
+
+		err = ::vDUT_GetStringReturn(g_WiFi_11ac_Dut, "EEPROM_RETURN", l_11ACfinalizeEepromReturn.EEPROM_RETURN, MAX_BUFFER_SIZE);
+		if ( ERR_OK!=err )
+		{
+			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[WiFi_11AC] No Return, Unknown EEPROM return result.\n");
+			throw logMessage;
+		}
+		else
+		{
+			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[WiFi_11AC] vDUT_GetStringReturn(EEPROM_RETURN) return OK.\n");
+		}
+
+		// Only returned with the write-back cache
+		l_11ACfinalizeEepromReturn.EEPROM_DUT_WRITES_SAVED = 0;
+		l_11ACfinalizeEepromReturn.EEPROM_FLUSH_TIME = 0;
+		::vDUT_GetIntegerReturn(g_WiFi_11ac_Dut, "EEPROM_DUT_WRITES_SAVED", &l_11ACfinalizeEepromReturn.EEPROM_DUT_WRITES_SAVED);
+		::vDUT_GetDoubleReturn (g_WiFi_11ac_Dut, "EEPROM_FLUSH_TIME", &l_11ACfinalizeEepromReturn.EEPROM_FLUSH_TIME);
+
+		/*-----------------------*
+		*  Return Test Results  *
+		*-----------------------*/
+		if (ERR_OK==err)
+		{
+			sprintf_s(l_11ACfinalizeEepromReturn.ERROR_MESSAGE, MAX_BUFFER_SIZE, "[Info] Function completed.\n");
+			ReturnTestResults(l_11ACfinalizeEepromReturnMap);
+		}
+		else
+		{
+			// do nothing
+		}
+	}
+	catch(char *msg)
+    {
+        ReturnErrorMessage(l_11ACfinalizeEepromReturn.ERROR_MESSAGE, msg);
+    }
+    catch(...)
+    {
+		ReturnErrorMessage(l_11ACfinalizeEepromReturn.ERROR_MESSAGE, "[WiFi_11AC] Unknown Error!\n");
+		err = -1;
+    }
+
+	return err;
+}
+
+int Initialize11ACFinalizeEepromContainers(void)
+{
+	/*------------------*
+	* Input Parameters: *
+	*------------------*/
+	l_11ACfinalizeEepromParamMap.clear();
+
+    WIFI_SETTING_STRUCT setting;
+    setting.unit = "";
+    setting.helpText = "";
+
+
+	/*----------------*
+	* Return Values: *
+	* ERROR_MESSAGE  *
+	*----------------*/
+	l_11ACfinalizeEepromReturnMap.clear();
+
+	// TODO: Example, add Return parameters here
+	l_11ACfinalizeEepromReturn.EEPROM_RETURN[0] = '\0';
+	setting.type = WIFI_SETTING_TYPE_STRING;
+	if (MAX_BUFFER_SIZE==sizeof(l_11ACfinalizeEepromReturn.EEPROM_RETURN))    // Type_Checking
+	{
+		setting.value       = (void*)l_11ACfinalizeEepromReturn.EEPROM_RETURN;
+		setting.unit        = "";
+		setting.helpText    = "A string contains information that return from EEPROM.";
+		l_11ACfinalizeEepromReturnMap.insert( pair<string,WIFI_SETTING_STRUCT>("EEPROM_RETURN", setting) );
+	}
+	else    
+	{
+		printf("Parameter Type Error!\n");
+		exit(1);
+	}
+
+	l_11ACfinalizeEepromReturn.EEPROM_DUT_WRITES_SAVED = 0;
+	setting.type = WIFI_SETTING_TYPE_INTEGER;
+	if (sizeof(int)==sizeof(l_11ACfinalizeEepromReturn.EEPROM_DUT_WRITES_SAVED))    // Type_Checking
+	{
+		setting.value       = (void*)&l_11ACfinalizeEepromReturn.EEPROM_DUT_WRITES_SAVED;
+		setting.unit        = "";
+		setting.helpText    = "DUT writes the write-back cache did not run, 0 without EEPROM_WRITE_BACK_CACHE.";
+		l_11ACfinalizeEepromReturnMap.insert( pair<string,WIFI_SETTING_STRUCT>("EEPROM_DUT_WRITES_SAVED", setting) );
+	}
+	else    
+	{
+		printf("Parameter Type Error!\n");
+		exit(1);
+	}
+
+	l_11ACfinalizeEepromReturn.EEPROM_FLUSH_TIME = 0;
+	setting.type = WIFI_SETTING_TYPE_DOUBLE;
+	if (sizeof(double)==sizeof(l_11ACfinalizeEepromReturn.EEPROM_FLUSH_TIME))    // Type_Checking
+	{
+		setting.value       = (void*)&l_11ACfinalizeEepromReturn.EEPROM_FLUSH_TIME;
+		setting.unit        = "sec";
+		setting.helpText    = "Measured time of the DUT writes at finalize, 0 without EEPROM_WRITE_BACK_CACHE.";
+		l_11ACfinalizeEepromReturnMap.insert( pair<string,WIFI_SETTING_STRUCT>("EEPROM_FLUSH_TIME", setting) );
+	}
+	else    
+	{
+		printf("Parameter Type Error!\n");
+		exit(1);
+	}
+
+	l_11ACfinalizeEepromReturn.ERROR_MESSAGE[0] = '\0';
+	setting.type = WIFI_SETTING_TYPE_STRING;
+	if (MAX_BUFFER_SIZE==sizeof(l_11ACfinalizeEepromReturn.ERROR_MESSAGE))    // Type_Checking
+	{
+		setting.value       = (void*)l_11ACfinalizeEepromReturn.ERROR_MESSAGE;
+		setting.unit        = "";
+		setting.helpText    = "Error message occurred";
+		l_11ACfinalizeEepromReturnMap.insert( pair<string,WIFI_SETTING_STRUCT>("ERROR_MESSAGE", setting) );
+	}
+	else    
+	{
+		printf("Parameter Type Error!\n");
+		exit(1);
+	}
+
+	return 0;
+}
@@ -3057,6 +3057,21 @@ int Initialize11ACGlobalSettingContainers(void)
         exit(1);
     }
 
+    setting.type = WIFI_SETTING_TYPE_INTEGER;
+	g_WiFi11ACGlobalSettingParam.EEPROM_WRITE_BACK_CACHE = 0;	
+    if (sizeof(int)==sizeof(g_WiFi11ACGlobalSettingParam.EEPROM_WRITE_BACK_CACHE))    // Type_Checking
+    {
+        setting.value = (void*)&g_WiFi11ACGlobalSettingParam.EEPROM_WRITE_BACK_CACHE;
+        setting.unit  = "";
+        setting.helpText  = "A flag that to let vDUT stage WRITE_EEPROM by address, answer READ_EEPROM of a staged address, and write the staged values at FINALIZE_EEPROM with one commit and a readback check, 0: OFF, 1: ON, Default=OFF";
+        g_WiFi11ACGlobalSettingParamMap.insert( pair<string, WIFI_SETTING_STRUCT>("EEPROM_WRITE_BACK_CACHE", setting) );
+    }
+    else    
+    {
+        printf("Parameter Type Error!\n");
+        exit(1);
+    }
+
     setting.type = WIFI_SETTING_TYPE_INTEGER;
 	g_WiFi11ACGlobalSettingParam.DUT_TX_SETTLE_TIME_MS = 0;	
     if (sizeof(int)==sizeof(g_WiFi11ACGlobalSettingParam.DUT_TX_SETTLE_TIME_MS))    // Type_Checking
@@ -3544,6 +3559,36 @@ int Initialize11ACGlobalSettingContainers(void)
         exit(1);
     }
 
+    setting.type = WIFI_SETTING_TYPE_INTEGER;
+    g_WiFi11ACGlobalSettingParam.EVM_MULTI_PACKET = 0;
+    if (sizeof(int)==sizeof(g_WiFi11ACGlobalSettingParam.EVM_MULTI_PACKET))    // Type_Checking
+    {
+        setting.value = (void*)&g_WiFi11ACGlobalSettingParam.EVM_MULTI_PACKET;
+        setting.unit  = "";
+        setting.helpText = "A flag to measure the EVM_AVERAGE packets from one long capture, each packet analyzed with LP_SelectCaptureRangeForAnalysis(), instead of one capture and trigger wait per packet.\r\n0: OFF, 1: ON, Default value is 0";
+        g_WiFi11ACGlobalSettingParamMap.insert( pair<string, WIFI_SETTING_STRUCT>("EVM_MULTI_PACKET", setting) );
+    }
+    else    
+    {
+        printf("Parameter Type Error!\n");
+        exit(1);
+    }
+
+    setting.type = WIFI_SETTING_TYPE_INTEGER;
+    g_WiFi11ACGlobalSettingParam.EVM_MULTI_PACKET_GAP_US = 100;
+    if (sizeof(int)==sizeof(g_WiFi11ACGlobalSettingParam.EVM_MULTI_PACKET_GAP_US))    // Type_Checking
+    {
+        setting.value = (void*)&g_WiFi11ACGlobalSettingParam.EVM_MULTI_PACKET_GAP_US;
+        setting.unit  = "us";
+        setting.helpText = "Inter-packet gap of the DUT traffic with EVM_MULTI_PACKET=1, the capture is (EVM capture time + gap) x packets.\r\nDefault value is 100";
+        g_WiFi11ACGlobalSettingParamMap.insert( pair<string, WIFI_SETTING_STRUCT>("EVM_MULTI_PACKET_GAP_US", setting) );
+    }
+    else    
+    {
+        printf("Parameter Type Error!\n");
+        exit(1);
+    }
+
     setting.type = WIFI_SETTING_TYPE_INTEGER;
     g_WiFi11ACGlobalSettingParam.EVM_SYMBOL_NUM = 18;
     if (sizeof(int)==sizeof(g_WiFi11ACGlobalSettingParam.EVM_SYMBOL_NUM))    // Type_Checking
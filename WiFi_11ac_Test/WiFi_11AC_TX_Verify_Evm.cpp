@@ -643,47 +643,99 @@ WIFI_11AC_TEST_API int WIFI_11AC_TX_Verify_Evm(void)
 		/*------------------*
 		 * Start While Loop *
 		 *------------------*/
+		int    packetNum = 0, packetIndex = 0;
+		vector< double > packetStartUs(g_WiFi11ACGlobalSettingParam.EVM_AVERAGE), packetLengthUs(g_WiFi11ACGlobalSettingParam.EVM_AVERAGE);
+
 		avgIteration = 0;
 		while ( avgIteration<g_WiFi11ACGlobalSettingParam.EVM_AVERAGE )
 		{
 			analysisOK = false;
 			captureOK  = false;
 
-		   /*----------------------------*
-			* Perform Normal VSA capture *
-			*----------------------------*/
-
-			/*------------------------------------------------------------*/
-			/*For EVM Analysis, in HT20/HT40, using normal capture     ---*/
-			/*------------------------------------------------------------*/
-
-
-			//g_WiFi11ACGlobalSettingParam.VSA_TRIGGER_TYPE
-			err = ::LP_VsaDataCapture( samplingTimeUs/1000000, g_WiFi11ACGlobalSettingParam.VSA_TRIGGER_TYPE, 160e6, VSAcaptureMode );     
-			if ( ERR_OK!=err )
+			if ( packetIndex<packetNum )
 			{
-					LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[WiFi_11AC] Fail to capture signal.\n");
-					throw logMessage;
+				// Next packet of the multi-packet capture
+				captureOK = true;
 			}
 			else
 			{
-				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[WiFi_11AC] LP_VsaDataCapture() return OK.\n");
-			}
+				// EVM_MULTI_PACKET=1: one capture long enough for the remaining packets
+				double captureTimeUs = samplingTimeUs;
+				if ( 1==g_WiFi11ACGlobalSettingParam.EVM_MULTI_PACKET && 1<(g_WiFi11ACGlobalSettingParam.EVM_AVERAGE-avgIteration) )
+				{
+					captureTimeUs = (samplingTimeUs+g_WiFi11ACGlobalSettingParam.EVM_MULTI_PACKET_GAP_US)*(g_WiFi11ACGlobalSettingParam.EVM_AVERAGE-avgIteration);
+				}
+				else
+				{
+					// do nothing
+				}
+
+			   /*----------------------------*
+				* Perform Normal VSA capture *
+				*----------------------------*/
+
+				/*------------------------------------------------------------*/
+				/*For EVM Analysis, in HT20/HT40, using normal capture     ---*/
+				/*------------------------------------------------------------*/
+
+
+				//g_WiFi11ACGlobalSettingParam.VSA_TRIGGER_TYPE
+				err = ::LP_VsaDataCapture( captureTimeUs/1000000, g_WiFi11ACGlobalSettingParam.VSA_TRIGGER_TYPE, 160e6, VSAcaptureMode );     
+				if ( ERR_OK!=err )
+				{
+						LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[WiFi_11AC] Fail to capture signal.\n");
+						throw logMessage;
+				}
+				else
+				{
+					LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[WiFi_11AC] LP_VsaDataCapture() return OK.\n");
+				}
+
 
+				/*--------------*
+				 *  Capture OK  *
+				 *--------------*/
+				captureOK = true;
+				if (1==g_WiFi11ACGlobalSettingParam.VSA_SAVE_CAPTURE_ALWAYS)
+				{
+					// TODO: must give a warning that VSA_SAVE_CAPTURE_ALWAYS is ON
+					sprintf_s(sigFileNameBuffer, MAX_BUFFER_SIZE, "%s_%d_%s_%s", "WiFi_TX_Evm_SaveAlways", l_11ACtxVerifyEvmParam.CH_FREQ_MHZ, l_11ACtxVerifyEvmParam.DATA_RATE, l_11ACtxVerifyEvmParam.CH_BANDWIDTH);
+					WiFiSaveSigFile(sigFileNameBuffer);
+				}
+				else
+				{
+					// do nothing
+				}
+
+				packetIndex = 0;
+				packetNum   = 0;
+				if ( captureTimeUs>samplingTimeUs )
+				{
+					packetNum = ::LP_GetCapturePacketRanges(captureTimeUs, &packetStartUs[0], &packetLengthUs[0], g_WiFi11ACGlobalSettingParam.EVM_AVERAGE-avgIteration);
+					LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[WiFi_11AC] %d complete packets in the %.0f us capture.\n", packetNum, captureTimeUs);
+				}
+				else
+				{
+					// do nothing
+				}
+			}
 
-			/*--------------*
-			 *  Capture OK  *
-			 *--------------*/
-			captureOK = true;
-			if (1==g_WiFi11ACGlobalSettingParam.VSA_SAVE_CAPTURE_ALWAYS)
+			if ( packetIndex<packetNum )
 			{
-				// TODO: must give a warning that VSA_SAVE_CAPTURE_ALWAYS is ON
-				sprintf_s(sigFileNameBuffer, MAX_BUFFER_SIZE, "%s_%d_%s_%s", "WiFi_TX_Evm_SaveAlways", l_11ACtxVerifyEvmParam.CH_FREQ_MHZ, l_11ACtxVerifyEvmParam.DATA_RATE, l_11ACtxVerifyEvmParam.CH_BANDWIDTH);
-				WiFiSaveSigFile(sigFileNameBuffer);
+				err = ::LP_SelectCaptureRangeForAnalysis(packetStartUs[packetIndex], packetLengthUs[packetIndex]);
+				if ( ERR_OK!=err )
+				{
+					LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[WiFi_11AC] LP_SelectCaptureRangeForAnalysis() of packet %d return error.\n", packetIndex+1);
+					throw logMessage;
+				}
+				else
+				{
+					packetIndex++;
+				}
 			}
 			else
 			{
-				// do nothing
+				// No complete packet found (or EVM_MULTI_PACKET=0), the whole capture is analyzed
 			}
 
 
@@ -91,6 +91,7 @@ WIFI_11AC_TEST_API int WIFI_11AC_technologyRegister()
         
 		TM_InstallCallbackFunction(technologyID, "READ_EEPROM",          WIFI_11AC_Read_Eeprom);
         TM_InstallCallbackFunction(technologyID, "WRITE_EEPROM",         WIFI_11AC_Write_Eeprom);	
+        TM_InstallCallbackFunction(technologyID, "FINALIZE_EEPROM",      WIFI_11AC_Finalize_Eeprom);
 
         TM_InstallCallbackFunction(technologyID, "READ_MAC_ADDRESS",     WIFI_11AC_Read_Mac_Address);
         TM_InstallCallbackFunction(technologyID, "WRITE_MAC_ADDRESS",    WIFI_11AC_Write_Mac_Address);
@@ -80,6 +80,7 @@ WIFI_11AC_TEST_API int WIFI_11AC_TX_Verify_Spectrum(void);
 WIFI_11AC_TEST_API int WIFI_11AC_TX_Calibration(void);
 WIFI_11AC_TEST_API int WIFI_11AC_Write_Eeprom(void);
 WIFI_11AC_TEST_API int WIFI_11AC_Read_Eeprom(void);
+WIFI_11AC_TEST_API int WIFI_11AC_Finalize_Eeprom(void);
 WIFI_11AC_TEST_API int WIFI_11AC_Write_BB_Register(void);
 WIFI_11AC_TEST_API int WIFI_11AC_Read_BB_Register(void);
 WIFI_11AC_TEST_API int WIFI_11AC_Write_RF_Register(void);
@@ -151,6 +151,9 @@ typedef struct tagGlobalSettingParam
 
 	int	   DUT_KEEP_TRANSMIT;						/*!< A flag that to let Dut keep Tx until the configuration changed, 0: OFF, 1: ON, Default=ON */
 
+	// Stage EEPROM writes in vDUT until FINALIZE_EEPROM, default off.
+	int	   EEPROM_WRITE_BACK_CACHE;					/*!< A flag that to let vDUT stage WRITE_EEPROM and write them at FINALIZE_EEPROM with one commit, 0: OFF, 1: ON, Default=OFF */
+
 	// DUT TX/RX settle time, default = 0 ms
 	int	   DUT_TX_SETTLE_TIME_MS;					/*!< A delay time for DUT (TX) settle, Default = 0(ms). */
 	int	   DUT_RX_SETTLE_TIME_MS;					/*!< A delay time for DUT (RX) settle, Default = 0(ms). */
@@ -230,6 +233,8 @@ typedef struct tagGlobalSettingParam
     // EVM measurement related parameters
     int    EVM_AVERAGE;
     int    EVM_SYMBOL_NUM;
+    int    EVM_MULTI_PACKET;                    /*!< A flag to take the EVM_AVERAGE packets from one long capture instead of one capture each, 0: OFF, 1: ON, Default=OFF */
+    int    EVM_MULTI_PACKET_GAP_US;             /*!< Inter-packet gap (us) of the DUT traffic, added per packet to the multi-packet capture. Default=100 */
     int    EVM_PRE_TRIG_TIME_US;
 	int    EVM_CAPTURE_TIME_11B_L_US;           /*!< Capture time for measuring 11b (long preamble) EVM.  =192+1000/11 */
 	int    EVM_CAPTURE_TIME_11B_S_US;           /*!< Capture time for measuring 11b (short preamble) EVM. =96+1000/11 */
@@ -318,6 +323,7 @@ int Initialize11ACGlobalSettingContainers(void);               // Needed by WiFi
 int Initialize11ACTXVerifyFlatnessContainers(void);            // Needed by WiFi_TX_Verify_Flatness
 int Initialize11ACReadEepromContainers(void);                  // Needed by WiFi_Read_Eeprom
 int Initialize11ACWriteEepromContainers(void);                 // Needed by WiFi_Write_Eeprom
+int Initialize11ACFinalizeEepromContainers(void);              // Needed by WiFi_Finalize_Eeprom
 int Initialize11ACWriteBBRegisterContainers(void);             // Needed by WiFi_Write_BB_Register.cpp
 int Initialize11ACReadBBRegisterContainers(void);              // Needed by WiFi_Read_BB_Register.cpp
 int Initialize11ACWriteRFRegisterContainers(void);             // Needed by WiFi_Write_RF_Register.cpp
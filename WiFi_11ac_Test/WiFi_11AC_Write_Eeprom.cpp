@@ -8,6 +8,7 @@
 // This variable is declared in WiFi_Test_Internal.cpp
 extern vDUT_ID      g_WiFi_11ac_Dut;
 extern TM_ID        g_WiFi_11ac_Test_ID;
+extern WIFI_GLOBAL_SETTING g_WiFi11ACGlobalSettingParam;
 
 using namespace std;
 
@@ -154,6 +155,7 @@ WIFI_11AC_TEST_API int WIFI_11AC_Write_Eeprom(void)
 		}
 #pragma endregion
 
+		::vDUT_EnableEepromCache(g_WiFi_11ac_Dut, g_WiFi11ACGlobalSettingParam.EEPROM_WRITE_BACK_CACHE);
 		err = vDUT_Run(g_WiFi_11ac_Dut, "WRITE_EEPROM");		
 		if ( ERR_OK!=err )
 		{	// Check vDut return "ERROR_MESSAGE" or not, if "Yes", must handle it.
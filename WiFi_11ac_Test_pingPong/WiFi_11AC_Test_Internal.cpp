@@ -2,6 +2,7 @@
 #include "WiFi_11AC_Test.h"
 #include "IQlite_Logger.h"
 #include "IQmeasure.h"
+#include "WiFi_RateTable.h"
 #include "math.h"
 //Move to stdafx.h
 //#include "lp_time.h"
@@ -453,6 +454,18 @@ WIFI_11AC_TEST_API int  ReturnErrorMessage(char *errParameter, const char *forma
 WIFI_11AC_TEST_API int  LogReturnMessage(char *errMsg, int sizeOfBuf, LOGGER_LEVEL level, const char *format, ...)
 {
     int  err = ERR_OK;
+
+	// Warnings and information the logger discards are not formatted, errMsg only gets the format.
+	// Errors are always formatted, the callers throw errMsg.
+	if ( g_WiFi_11AC_Logger_ID>=0 && level>LOGGER_ERROR && !::LOGGER_IsEnabled(LOG_IQLITE_CORE, level) )
+	{
+		strncpy_s(errMsg, sizeOfBuf, format, _TRUNCATE);
+		return err;
+	}
+	else
+	{
+		// do nothing
+	}
 	
 	// Log message format ... variable argument list
 	va_list ap;
@@ -463,7 +476,7 @@ WIFI_11AC_TEST_API int  LogReturnMessage(char *errMsg, int sizeOfBuf, LOGGER_LEV
 	// Write error message to log file
 	if (g_WiFi_11AC_Logger_ID>=0)
 	{
-		err = ::LOGGER_Write_Ext(LOG_IQLITE_CORE, g_WiFi_11AC_Logger_ID, level, errMsg);
+		err = ::LOGGER_Write_Ext(LOG_IQLITE_CORE, g_WiFi_11AC_Logger_ID, level, "%s", errMsg);
 		// TODO: if possible, must do the error handling here
 	}
 	else
@@ -983,13 +996,16 @@ WIFI_11AC_TEST_API int GetDefaultWaveformFileName(char* filePath,char* fileType,
 			 fileType = "ref";
 	 }
 
+	 // 802.11b and 802.11ag waveforms are named after the rate, which must be of the family of the mode
+	 const WIFI_RATE_DESCRIPTOR *rate = WiFiRate_FindByName(datarate);
+
 	 if ( wifiMode == WIFI_11B)		// 802.11b
 	 {
 		 if ( 0 == strcmp( datarate, "DSSS-1"))
 		 {
 			 sprintf_s(tempWaveformFileName, bufferSize, "WiFi_%s.%s", datarate, fileType);
 		 }
-		 else if ( (strstr(datarate, "DSSS")!=NULL)||(strstr(datarate, "CCK")!=NULL) )
+		 else if ( NULL!=rate && (WIFI_RATE_DSSS==rate->family || WIFI_RATE_CCK==rate->family) )
 		 {
 			 char tmpPreamble[2]; 
 			 tmpPreamble[0] = preamble[0];
@@ -1014,7 +1030,7 @@ WIFI_11AC_TEST_API int GetDefaultWaveformFileName(char* filePath,char* fileType,
 	 }
 	 else if ( wifiMode ==  WIFI_11AG)		//802.11ag
 	 {
-		 if ( (strstr(datarate, "OFDM")!=NULL) )
+		 if ( NULL!=rate && WIFI_RATE_OFDM==rate->family )
 		 {
 			 sprintf_s(tempWaveformFileName, bufferSize, "WiFi_%s.%s", datarate, fileType);
 		 }
@@ -1245,42 +1261,13 @@ WIFI_11AC_TEST_API int  GetWaveformFileName(char* perfix, char* postfix, int wif
 {
     int  err = ERR_OK;
 
-	char keyword[MAX_BUFFER_SIZE] = {'\0'}, datarateString[MAX_BUFFER_SIZE] = {'\0'};
-	int  rateIndexBegin = 0, rateIndexEnd = 0;
+	char keyword[MAX_BUFFER_SIZE] = {'\0'};
 
 	map<string, WIFI_SETTING_STRUCT>::iterator inputMap_Iter;
 
-	// Find out the datarate index
-/*	if ( (wifiMode==WIFI_11B)||(wifiMode==WIFI_11AG) )
-	{
-		for (int i=0;i<MAX_BUFFER_SIZE;i++)
-		{
-			if (datarate[i] == '-')
-			{
-				rateIndexBegin = i+1;
-			}
-			else if (datarate[i] == '\0')
-			{
-				rateIndexEnd = i;
-				break;
-			}
-			else
-			{	
-				// do nothing, keep searching...
-			}
-		}
-		// Copy the datarate 
-		int rateIndex = 0;
-		for (int i=rateIndexBegin;i<=rateIndexEnd;i++)
-		{
-			datarateString[rateIndex] = datarate[i];
-			rateIndex++;
-		}
-	}
-	else	// WIFI_11N_HT20 or WIFI_11N_HT40
-	{
-		// do nothing
-	}
+	// Find out the datarate keyword, e.g. "54" for OFDM-54 (not used by 802.11n)
+/*	const WIFI_RATE_DESCRIPTOR *rate = WiFiRate_FindByName(datarate);
+	const char *datarateString = (NULL==rate) ? "" : rate->waveformKey;
 
 	// Find out the keyword of the waveform file name
 	if (wifiMode==WIFI_11B)
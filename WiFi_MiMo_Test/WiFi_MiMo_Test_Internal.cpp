@@ -2,6 +2,7 @@
 #include "WiFi_MiMo_Test.h"
 #include "IQlite_Logger.h"
 #include "IQmeasure.h"
+#include "WiFi_RateTable.h"
 #include "math.h"
 //Move to stdafx.h
 //#include "lp_time.h"
@@ -516,6 +517,18 @@ int  ReturnErrorMessage(char *errParameter, const char *format, ...)
 int  LogReturnMessage(char *errMsg, int sizeOfBuf, LOGGER_LEVEL level, const char *format, ...)
 {
     int  err = ERR_OK;
+
+	// Warnings and information the logger discards are not formatted, errMsg only gets the format.
+	// Errors are always formatted, the callers throw errMsg.
+	if ( g_Logger_ID>=0 && level>LOGGER_ERROR && !::LOGGER_IsEnabled(MAX_LOGGER_SOURCE, level) )
+	{
+		strncpy_s(errMsg, sizeOfBuf, format, _TRUNCATE);
+		return err;
+	}
+	else
+	{
+		// do nothing
+	}
 	
 	// Log message format ... variable argument list
 	va_list ap;
@@ -526,7 +539,7 @@ int  LogReturnMessage(char *errMsg, int sizeOfBuf, LOGGER_LEVEL level, const cha
 	// Write error message to log file
 	if (g_Logger_ID>=0)
 	{
-		err = ::LOGGER_Write(g_Logger_ID, level, errMsg);
+		err = ::LOGGER_Write(g_Logger_ID, level, "%s", errMsg);
 		// TODO: if possible, must do the error handling here
 	}
 	else
@@ -921,51 +934,32 @@ int  WiFiSaveSigFile(char* fileName)
 	return err;
 }
 
+// Rate part of the PER_* waveform and packet number settings, from the shared rate table.
+// Unknown rates fall back to the text after the last '-'.
+static const char* GetWaveformRateKey(const char* datarate)
+{
+	const WIFI_RATE_DESCRIPTOR *rate = WiFiRate_FindByName(datarate);
+	if ( NULL!=rate )
+	{
+		return rate->waveformKey;
+	}
+	else
+	{
+		const char *rateBegin = strrchr(datarate, '-');
+		return (NULL==rateBegin) ? datarate : rateBegin+1;
+	}
+}
+
 int  GetWaveformFileName(char* perfix, char* postfix, int wifiMode, char* bandwidth, char* datarate, char* preamble, char* packetFormat11N, char* guardInterval11N, char* waveformFileName, int bufferSize)
 {
     int  err = ERR_OK;
 
-	char keyword[MAX_BUFFER_SIZE] = {'\0'}, datarateString[MAX_BUFFER_SIZE] = {'\0'};
-	int  rateIndexBegin = 0, rateIndexEnd = 0;
+	char keyword[MAX_BUFFER_SIZE] = {'\0'};
 
 	map<string, WIFI_SETTING_STRUCT>::iterator inputMap_Iter;
 
-	// Find out the datarate index
-	if ( (wifiMode==WIFI_11B)||(wifiMode==WIFI_11AG) )
-	{
-		if ((strcmp(bandwidth,"HALF")==0) || (strcmp(bandwidth,"QUAR")==0)) {
-			// 11p 
-			// do nothing
-		} else {
-			for (int i=0;i<MAX_BUFFER_SIZE;i++)
-			{
-				if (datarate[i] == '-')
-				{
-					rateIndexBegin = i+1;
-				}
-				else if (datarate[i] == '\0')
-				{
-					rateIndexEnd = i;
-					break;
-				}
-				else
-				{	
-					// do nothing, keep searching...
-				}
-			}
-			// Copy the datarate 
-			int rateIndex = 0;
-			for (int i=rateIndexBegin;i<=rateIndexEnd;i++)
-			{
-				datarateString[rateIndex] = datarate[i];
-				rateIndex++;
-			}
-		}
-	}
-	else	// WIFI_11N_HT20 or WIFI_11N_HT40
-	{
-		// do nothing
-	}
+	// Find out the datarate keyword, e.g. "54" for OFDM-54 or "HALF-3" for 11p (not used by 802.11n)
+	const char *datarateString = GetWaveformRateKey(datarate);
 
 	// Find out the keyword of the waveform file name
 	if (wifiMode==WIFI_11B)
@@ -1098,47 +1092,12 @@ int  GetPacketNumber(int wifiMode, char* bandwidth, char* datarate, char* packet
 {
     int  err = ERR_OK;
 
-	char keyword[MAX_BUFFER_SIZE] = {'\0'}, datarateString[MAX_BUFFER_SIZE] = {'\0'};
-	int  rateIndexBegin = 0, rateIndexEnd = 0;
+	char keyword[MAX_BUFFER_SIZE] = {'\0'};
 
 	map<string, WIFI_SETTING_STRUCT>::iterator inputMap_Iter;
 
-	// Find out the datarate index
-	if ( (wifiMode==WIFI_11B)||(wifiMode==WIFI_11AG) )
-	{
-		if ((strcmp(bandwidth,"HALF")==0) || (strcmp(bandwidth,"QUAR")==0)) {
-			// 11p 
-			// do nothing
-		} else {
-			for (int i=0;i<MAX_BUFFER_SIZE;i++)
-			{
-				if (datarate[i] == '-')
-				{
-					rateIndexBegin = i+1;
-				}
-				else if (datarate[i] == '\0')
-				{
-					rateIndexEnd = i;
-					break;
-				}
-				else
-				{	
-					// do nothing, keep searching...
-				}
-			}
-			// Copy the datarate 
-			int rateIndex = 0;
-			for (int i=rateIndexBegin;i<=rateIndexEnd;i++)
-			{
-				datarateString[rateIndex] = datarate[i];
-				rateIndex++;
-			}
-		}
-	}
-	else	// WIFI_11N_HT20 or WIFI_11N_HT40
-	{
-		// do nothing
-	}
+	// Find out the datarate keyword, e.g. "54" for OFDM-54 or "HALF-3" for 11p (not used by 802.11n)
+	const char *datarateString = GetWaveformRateKey(datarate);
 
 	// Find out the keyword of the waveform file name
 	if (wifiMode==WIFI_11B)
@@ -0,0 +1,262 @@
+#include "stdafx.h"
+#include "TestManager.h"
+#include "WiFi_Test.h"
+#include "WiFi_Test_Internal.h"
+#include "IQmeasure.h"
+#include "vDUT.h"
+
+using namespace std;
+
+// DUT_LOOK_AHEAD=1: once a TX verify item has completed its last capture, WiFi_Dut_Look_Ahead() configures
+// the DUT for the next TX item (TM_SetLookAhead() of the station) while the item analyzes.  The next item
+// finds its configuration in g_dutLookAheadTxKey and skips its DUT control section.
+
+// Configuration transmitted since TX_START of WiFi_Dut_Look_Ahead(), empty if none
+char	g_dutLookAheadTxKey[MAX_BUFFER_SIZE] = {'\0'};
+DWORD	g_dutLookAheadTxStartMs = 0;
+// Configuration of the last TX verify item
+char	g_dutActiveTxKey[MAX_BUFFER_SIZE] = {'\0'};
+
+static void DutLookAheadRun(char *command, char *logMessage)
+{
+	char vErrorMsg[MAX_BUFFER_SIZE] = {'\0'};
+
+	int err = ::vDUT_Run(g_WiFi_Dut, command);
+	if ( ERR_OK!=err )
+	{	// Check vDut return "ERROR_MESSAGE" or not, if "Yes", must handle it.
+		err = ::vDUT_GetStringReturn(g_WiFi_Dut, "ERROR_MESSAGE", vErrorMsg, MAX_BUFFER_SIZE);
+		if ( ERR_OK==err )	// Get "ERROR_MESSAGE" from vDut
+		{
+			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[WiFi] Look-ahead %s", vErrorMsg);
+		}
+		else	// Just return normal error message in this case
+		{
+			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[WiFi] Look-ahead vDUT_Run(%s) return error.\n", command);
+		}
+		throw logMessage;
+	}
+	else
+	{
+		LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[WiFi] Look-ahead vDUT_Run(%s) return OK.\n", command);
+	}
+}
+
+WIFI_TEST_API void WiFiDutTxKey(char *dutTxKey, int freqMHz, char *dataRate, char *bandwidth, char *preamble, char *packetFormat11N,
+								char *guardInterval11N, double txPowerDbm, int tx1, int tx2, int tx3, int tx4)
+{
+	sprintf_s(dutTxKey, MAX_BUFFER_SIZE, "%d|%s|%s|%s|%s|%s|%.2f|%d%d%d%d", freqMHz, dataRate, bandwidth, preamble, packetFormat11N,
+			  guardInterval11N, txPowerDbm, tx1, tx2, tx3, tx4);
+}
+
+WIFI_TEST_API bool WiFiDutTxPrepared(char *dutTxKey, char *errorMsg)
+{
+	bool prepared = ( g_vDutTxActived && '\0'!=g_dutLookAheadTxKey[0] && 0==strcmp(dutTxKey, g_dutLookAheadTxKey) );
+	if ( !prepared && '\0'!=g_dutLookAheadTxKey[0] )
+	{
+		// The DUT transmits the look-ahead configuration, not the one of the previous item g_dutConfigChanged compares with
+		g_dutConfigChanged = true;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	strcpy_s(g_dutActiveTxKey, MAX_BUFFER_SIZE, dutTxKey);
+	g_dutLookAheadTxKey[0] = '\0';
+
+	if (prepared)
+	{
+		// Settle time counts from TX_START of the look-ahead, most of it has passed during the previous analysis
+		DWORD elapsedMs = GetTickCount() - g_dutLookAheadTxStartMs;
+		if ( (DWORD)g_WiFiGlobalSettingParam.DUT_TX_SETTLE_TIME_MS>elapsedMs )
+		{
+			Sleep(g_WiFiGlobalSettingParam.DUT_TX_SETTLE_TIME_MS-elapsedMs);
+		}
+		else
+		{
+			// do nothing
+		}
+		LogReturnMessage(errorMsg, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[WiFi] DUT configured by the look-ahead of the previous item %d ms ago, skip Dut control section.\n", (int)elapsedMs);
+	}
+	else
+	{
+		// do nothing
+	}
+
+	return prepared;
+}
+
+WIFI_TEST_API void WiFiStartLookAhead(char *errorMsg)
+{
+	if ( 1==g_WiFiGlobalSettingParam.DUT_LOOK_AHEAD && 1==g_WiFiGlobalSettingParam.DUT_KEEP_TRANSMIT )
+	{
+		if ( TM_ERR_OK==::TM_StartLookAhead(g_WiFi_Test_ID) )
+		{
+			LogReturnMessage(errorMsg, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[WiFi] TM_StartLookAhead() return OK.\n");
+		}
+		else
+		{
+			// No next item
+		}
+	}
+	else
+	{
+		// do nothing
+	}
+}
+
+WIFI_TEST_API void WiFiWaitLookAhead(void)
+{
+	::TM_WaitLookAhead(g_WiFi_Test_ID, NULL);
+}
+
+//! Look-ahead function of WiFi, see TM_InstallLookAheadFunction()
+/*!
+ * Runs on a TestManager thread, TM_GetxxxParameter() return the parameters of the next item.
+ * Only the TX verify items with all DUT parameters given are prepared; for the others the DUT is left as it is.
+ */
+WIFI_TEST_API int WiFi_Dut_Look_Ahead(void)
+{
+	int    err = ERR_OK;
+	char   logMessage[MAX_BUFFER_SIZE] = {'\0'};
+	char   keyword[MAX_BUFFER_SIZE] = {'\0'};
+	char   dataRate[MAX_BUFFER_SIZE] = {'\0'};
+	char   bandwidth[MAX_BUFFER_SIZE] = {'\0'};
+	char   preamble[MAX_BUFFER_SIZE] = "LONG";
+	char   packetFormat11N[MAX_BUFFER_SIZE] = "MIXED";
+	char   guardInterval11N[MAX_BUFFER_SIZE] = "LONG";
+	char   dutTxKey[MAX_BUFFER_SIZE] = {'\0'};
+	int    freqMHz = 0, tx1 = 1, tx2 = 0, tx3 = 0, tx4 = 0;
+	int    wifiMode = 0, wifiStreamNum = 0, HT40ModeOn = 0;
+	double txPowerDbm = 0.0, samplingTimeUs = 0.0;
+
+	g_dutLookAheadTxKey[0] = '\0';
+
+	try
+	{
+		::TM_GetStringParameter(g_WiFi_Test_ID, "LOOK_AHEAD_KEYWORD", keyword, MAX_BUFFER_SIZE);
+		if ( 0!=strcmp(keyword, "TX_VERIFY_EVM") && 0!=strcmp(keyword, "TX_VERIFY_POWER") && 0!=strcmp(keyword, "TX_VERIFY_MASK") )
+		{
+			return ERR_OK;
+		}
+		else if ( ERR_OK!=::TM_GetIntegerParameter(g_WiFi_Test_ID, "FREQ_MHZ", &freqMHz) ||
+				  ERR_OK!=::TM_GetStringParameter (g_WiFi_Test_ID, "DATA_RATE", dataRate, MAX_BUFFER_SIZE) ||
+				  ERR_OK!=::TM_GetStringParameter (g_WiFi_Test_ID, "BANDWIDTH", bandwidth, MAX_BUFFER_SIZE) ||
+				  ERR_OK!=::TM_GetDoubleParameter (g_WiFi_Test_ID, "TX_POWER_DBM", &txPowerDbm) ||
+				  TX_TARGET_POWER_FLAG==txPowerDbm )
+		{
+			// The TX item configures the DUT itself
+			return ERR_OK;
+		}
+		else
+		{
+			// Optional parameters, same defaults as the TX verify items
+			::TM_GetStringParameter (g_WiFi_Test_ID, "PREAMBLE", preamble, MAX_BUFFER_SIZE);
+			::TM_GetStringParameter (g_WiFi_Test_ID, "PACKET_FORMAT_11N", packetFormat11N, MAX_BUFFER_SIZE);
+			::TM_GetStringParameter (g_WiFi_Test_ID, "GUARD_INTERVAL_11N", guardInterval11N, MAX_BUFFER_SIZE);
+			::TM_GetIntegerParameter(g_WiFi_Test_ID, "TX1", &tx1);
+			::TM_GetIntegerParameter(g_WiFi_Test_ID, "TX2", &tx2);
+			::TM_GetIntegerParameter(g_WiFi_Test_ID, "TX3", &tx3);
+			::TM_GetIntegerParameter(g_WiFi_Test_ID, "TX4", &tx4);
+			::TM_GetDoubleParameter (g_WiFi_Test_ID, "SAMPLING_TIME_US", &samplingTimeUs);
+		}
+
+		WiFiDutTxKey(dutTxKey, freqMHz, dataRate, bandwidth, preamble, packetFormat11N, guardInterval11N, txPowerDbm, tx1, tx2, tx3, tx4);
+		if ( g_vDutTxActived && 0==strcmp(dutTxKey, g_dutActiveTxKey) )
+		{
+			// Same configuration as the current item, the DUT keeps transmitting
+			return ERR_OK;
+		}
+		else
+		{
+			// do nothing
+		}
+
+		err = WiFiTestMode(dataRate, bandwidth, &wifiMode, &wifiStreamNum);
+		if ( ERR_OK!=err )
+		{
+			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[WiFi] Look-ahead WiFiTestMode(%s, %s) return error.\n", dataRate, bandwidth);
+			throw logMessage;
+		}
+		else
+		{
+			// do nothing
+		}
+
+		/*---------------------------*
+		 * Configure DUT to transmit *
+		 *---------------------------*/
+		vDUT_ClearParameters(g_WiFi_Dut);
+
+		if( wifiMode==WIFI_11N_HT40 )
+		{
+			HT40ModeOn = 1;   // 1: HT40 mode;
+			vDUT_AddIntegerParameter(g_WiFi_Dut, "FREQ_MHZ",       freqMHz);
+			vDUT_AddIntegerParameter(g_WiFi_Dut, "PRIMARY_FREQ",   freqMHz-10);
+			vDUT_AddIntegerParameter(g_WiFi_Dut, "SECONDARY_FREQ", freqMHz+10);
+		}
+		else
+		{
+			HT40ModeOn = 0;   // 0: Normal 20MHz mode
+			vDUT_AddIntegerParameter(g_WiFi_Dut, "FREQ_MHZ",      freqMHz);
+		}
+
+		vDUT_AddStringParameter (g_WiFi_Dut, "PREAMBLE",		  preamble);
+		vDUT_AddStringParameter (g_WiFi_Dut, "PACKET_FORMAT_11N", packetFormat11N);
+		vDUT_AddStringParameter (g_WiFi_Dut, "GUARD_INTERVAL_11N", guardInterval11N);
+		vDUT_AddStringParameter (g_WiFi_Dut, "DATA_RATE",		  dataRate);
+		vDUT_AddStringParameter (g_WiFi_Dut, "BANDWIDTH",		  bandwidth);
+		vDUT_AddIntegerParameter(g_WiFi_Dut, "CHANNEL_BW",		  HT40ModeOn);
+		vDUT_AddIntegerParameter(g_WiFi_Dut, "TX1",				  tx1);
+		vDUT_AddIntegerParameter(g_WiFi_Dut, "TX2",				  tx2);
+		vDUT_AddIntegerParameter(g_WiFi_Dut, "TX3",				  tx3);
+		vDUT_AddIntegerParameter(g_WiFi_Dut, "TX4",				  tx4);
+		if ( 0<samplingTimeUs )
+		{
+			vDUT_AddDoubleParameter (g_WiFi_Dut, "SAMPLING_TIME_US",  samplingTimeUs);
+		}
+		else
+		{
+			// do nothing
+		}
+		vDUT_AddDoubleParameter (g_WiFi_Dut, "TX_POWER_DBM",	  txPowerDbm);
+
+		if ( g_vDutTxActived )
+		{
+			DutLookAheadRun("TX_STOP", logMessage);
+			g_vDutTxActived = false;
+		}
+		else
+		{
+			// continue Dut configuration
+		}
+
+		DutLookAheadRun("RF_SET_FREQ", logMessage);
+		DutLookAheadRun("TX_SET_BW", logMessage);
+		DutLookAheadRun("TX_SET_DATA_RATE", logMessage);
+		DutLookAheadRun("TX_SET_ANTENNA", logMessage);
+		DutLookAheadRun("TX_PRE_TX", logMessage);
+		DutLookAheadRun("TX_START", logMessage);
+
+		g_vDutTxActived = true;
+		g_dutLookAheadTxStartMs = GetTickCount();
+		strcpy_s(g_dutLookAheadTxKey, MAX_BUFFER_SIZE, dutTxKey);
+	}
+	catch(char *msg)
+	{
+		// The next item configures the DUT itself; msg is logMessage, so it is copied before logMessage is formatted again
+		char failure[MAX_BUFFER_SIZE] = {'\0'};
+		strcpy_s(failure, MAX_BUFFER_SIZE, msg);
+		err = -1;
+		g_dutLookAheadTxKey[0] = '\0';
+		LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_WARNING, "[WiFi] Look-ahead of %s failed, the item configures the DUT. %s", keyword, failure);
+	}
+	catch(...)
+	{
+		err = -1;
+		g_dutLookAheadTxKey[0] = '\0';
+		LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_WARNING, "[WiFi] Look-ahead of %s failed, the item configures the DUT.\n", keyword);
+	}
+
+	return err;
+}
@@ -18,6 +18,8 @@ map<string, WIFI_SETTING_STRUCT> l_finalizeEepromReturnMap;
 struct tagReturn
 {
     char EEPROM_RETURN[MAX_BUFFER_SIZE];         /*!< A string contains information that return from EEPROM.  */
+    int    EEPROM_DUT_WRITES_SAVED;              /*!< DUT writes the write-back cache did not run, 0 without EEPROM_WRITE_BACK_CACHE. */
+    double EEPROM_FLUSH_TIME;                    /*!< Measured time of the DUT writes at finalize, 0 without EEPROM_WRITE_BACK_CACHE. */
     char ERROR_MESSAGE[MAX_BUFFER_SIZE];         /*!< A string for error message. */
 } l_finalizeEepromReturn;
 
@@ -107,6 +109,7 @@ WIFI_TEST_API int WiFi_Finalize_Eeprom(void)
         // Error return of this function is irrelevant
         CheckDutTransmitStatus();
 
+		::vDUT_EnableEepromCache(g_WiFi_Dut, g_WiFiGlobalSettingParam.EEPROM_WRITE_BACK_CACHE);
 		err = vDUT_Run(g_WiFi_Dut, "FINALIZE_EEPROM");		
 		if ( ERR_OK!=err )
 		{	// Check vDut return "ERROR_MESSAGE" or not, if "Yes", must handle it.
@@ -139,6 +142,12 @@ WIFI_TEST_API int WiFi_Finalize_Eeprom(void)
 			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[WiFi] vDUT_GetStringReturn(EEPROM_RETURN) return OK.\n");
 		}
 
+		// Only returned with the write-back cache
+		l_finalizeEepromReturn.EEPROM_DUT_WRITES_SAVED = 0;
+		l_finalizeEepromReturn.EEPROM_FLUSH_TIME = 0;
+		::vDUT_GetIntegerReturn(g_WiFi_Dut, "EEPROM_DUT_WRITES_SAVED", &l_finalizeEepromReturn.EEPROM_DUT_WRITES_SAVED);
+		::vDUT_GetDoubleReturn (g_WiFi_Dut, "EEPROM_FLUSH_TIME", &l_finalizeEepromReturn.EEPROM_FLUSH_TIME);
+
 		/*-----------------------*
 		*  Return Test Results  *
 		*-----------------------*/
@@ -199,6 +208,36 @@ int InitializeFinalizeEepromContainers(void)
 		exit(1);
 	}
 
+	l_finalizeEepromReturn.EEPROM_DUT_WRITES_SAVED = 0;
+	setting.type = WIFI_SETTING_TYPE_INTEGER;
+	if (sizeof(int)==sizeof(l_finalizeEepromReturn.EEPROM_DUT_WRITES_SAVED))    // Type_Checking
+	{
+		setting.value       = (void*)&l_finalizeEepromReturn.EEPROM_DUT_WRITES_SAVED;
+		setting.unit        = "";
+		setting.helpText    = "DUT writes the write-back cache did not run, 0 without EEPROM_WRITE_BACK_CACHE.";
+		l_finalizeEepromReturnMap.insert( pair<string,WIFI_SETTING_STRUCT>("EEPROM_DUT_WRITES_SAVED", setting) );
+	}
+	else    
+	{
+		printf("Parameter Type Error!\n");
+		exit(1);
+	}
+
+	l_finalizeEepromReturn.EEPROM_FLUSH_TIME = 0;
+	setting.type = WIFI_SETTING_TYPE_DOUBLE;
+	if (sizeof(double)==sizeof(l_finalizeEepromReturn.EEPROM_FLUSH_TIME))    // Type_Checking
+	{
+		setting.value       = (void*)&l_finalizeEepromReturn.EEPROM_FLUSH_TIME;
+		setting.unit        = "sec";
+		setting.helpText    = "Measured time of the DUT writes at finalize, 0 without EEPROM_WRITE_BACK_CACHE.";
+		l_finalizeEepromReturnMap.insert( pair<string,WIFI_SETTING_STRUCT>("EEPROM_FLUSH_TIME", setting) );
+	}
+	else    
+	{
+		printf("Parameter Type Error!\n");
+		exit(1);
+	}
+
 	l_finalizeEepromReturn.ERROR_MESSAGE[0] = '\0';
 	setting.type = WIFI_SETTING_TYPE_STRING;
 	if (MAX_BUFFER_SIZE==sizeof(l_finalizeEepromReturn.ERROR_MESSAGE))    // Type_Checking
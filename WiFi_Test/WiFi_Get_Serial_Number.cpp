@@ -151,6 +151,8 @@ WIFI_TEST_API int WiFi_Get_Serial_Number(void)
 		{
 			LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[WiFi] vDUT_GetStringReturn(SERIAL_NUMBER) return OK.\n");
 		}
+		strcpy_s(g_WiFiDutSerialNumber, MAX_BUFFER_SIZE, l_getSerialNumberReturn.SERIAL_NUMBER);
+		::TM_SetDutInfo(l_getSerialNumberReturn.SERIAL_NUMBER);		// for the TestManager result file
 
 		/*-----------------------*
 		 *  Return Test Results  *
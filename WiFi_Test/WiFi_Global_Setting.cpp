@@ -9258,6 +9258,66 @@ int InitializeGlobalSettingContainers(void)
         printf("Parameter Type Error!\n");
         exit(1);
     }
+
+    setting.type = WIFI_SETTING_TYPE_INTEGER;
+	g_WiFiGlobalSettingParam.VSA_SAVE_CAPTURE_ARCHIVE = 0;	
+    if (sizeof(int)==sizeof(g_WiFiGlobalSettingParam.VSA_SAVE_CAPTURE_ARCHIVE))    // Type_Checking
+    {
+        setting.value = (void*)&g_WiFiGlobalSettingParam.VSA_SAVE_CAPTURE_ARCHIVE;
+        setting.unit  = "";
+        setting.helpText  = "A flag that to save captures in the background capture archive (compressed, indexed by DUT serial number and test item), 0: OFF, 1: ON, Default is 0.";
+        g_WiFiGlobalSettingParamMap.insert( pair<string, WIFI_SETTING_STRUCT>("VSA_SAVE_CAPTURE_ARCHIVE", setting) );
+    }
+    else    
+    {
+        printf("Parameter Type Error!\n");
+        exit(1);
+    }
+
+    setting.type = WIFI_SETTING_TYPE_STRING;
+    strcpy_s(g_WiFiGlobalSettingParam.VSA_SAVE_CAPTURE_ARCHIVE_PATH, MAX_BUFFER_SIZE, "./log/capture_archive");
+    if (MAX_BUFFER_SIZE==sizeof(g_WiFiGlobalSettingParam.VSA_SAVE_CAPTURE_ARCHIVE_PATH))    // Type_Checking
+    {
+        setting.value = (void*)g_WiFiGlobalSettingParam.VSA_SAVE_CAPTURE_ARCHIVE_PATH;
+        setting.unit  = "";
+        setting.helpText = "Directory of the capture archive and its capture_index.csv.\r\nDefault is ./log/capture_archive";
+        g_WiFiGlobalSettingParamMap.insert( pair<string, WIFI_SETTING_STRUCT>("VSA_SAVE_CAPTURE_ARCHIVE_PATH", setting) );
+    }
+    else    
+    {
+        printf("Parameter Type Error!\n");
+        exit(1);
+    }
+
+    setting.type = WIFI_SETTING_TYPE_INTEGER;
+	g_WiFiGlobalSettingParam.VSA_SAVE_CAPTURE_QUOTA_MB = 1024;	
+    if (sizeof(int)==sizeof(g_WiFiGlobalSettingParam.VSA_SAVE_CAPTURE_QUOTA_MB))    // Type_Checking
+    {
+        setting.value = (void*)&g_WiFiGlobalSettingParam.VSA_SAVE_CAPTURE_QUOTA_MB;
+        setting.unit  = "MB";
+        setting.helpText  = "Disk quota of the capture archive, the oldest captures are deleted when it is exceeded, 0: no quota, Default is 1024.";
+        g_WiFiGlobalSettingParamMap.insert( pair<string, WIFI_SETTING_STRUCT>("VSA_SAVE_CAPTURE_QUOTA_MB", setting) );
+    }
+    else    
+    {
+        printf("Parameter Type Error!\n");
+        exit(1);
+    }
+
+    setting.type = WIFI_SETTING_TYPE_INTEGER;
+	g_WiFiGlobalSettingParam.VSA_REF_LEVEL_LEARN = 0;	
+    if (sizeof(int)==sizeof(g_WiFiGlobalSettingParam.VSA_REF_LEVEL_LEARN))    // Type_Checking
+    {
+        setting.value = (void*)&g_WiFiGlobalSettingParam.VSA_REF_LEVEL_LEARN;
+        setting.unit  = "";
+        setting.helpText  = "A flag to set the VSA amplitude from the power measured in the previous captures of the same signal, instead of TX_POWER_DBM. A clipped or failed capture falls back to TX_POWER_DBM and the ranging capture. 0: OFF, 1: ON, Default is OFF.";
+        g_WiFiGlobalSettingParamMap.insert( pair<string, WIFI_SETTING_STRUCT>("VSA_REF_LEVEL_LEARN", setting) );
+    }
+    else    
+    {
+        printf("Parameter Type Error!\n");
+        exit(1);
+    }
     
     setting.type = WIFI_SETTING_TYPE_INTEGER;
 	g_WiFiGlobalSettingParam.DUT_KEEP_TRANSMIT = 1;	
@@ -9304,6 +9364,36 @@ int InitializeGlobalSettingContainers(void)
         exit(1);
     }
 
+    setting.type = WIFI_SETTING_TYPE_INTEGER;
+	g_WiFiGlobalSettingParam.DUT_LOOK_AHEAD = 0;	
+    if (sizeof(int)==sizeof(g_WiFiGlobalSettingParam.DUT_LOOK_AHEAD))    // Type_Checking
+    {
+        setting.value = (void*)&g_WiFiGlobalSettingParam.DUT_LOOK_AHEAD;
+        setting.unit  = "";
+        setting.helpText  = "A flag that to let Dut be configured for the next TX item (TM_SetLookAhead) while the current item analyzes, requires DUT_KEEP_TRANSMIT=1, 0: OFF, 1: ON, Default=OFF";
+        g_WiFiGlobalSettingParamMap.insert( pair<string, WIFI_SETTING_STRUCT>("DUT_LOOK_AHEAD", setting) );
+    }
+    else    
+    {
+        printf("Parameter Type Error!\n");
+        exit(1);
+    }
+
+    setting.type = WIFI_SETTING_TYPE_INTEGER;
+	g_WiFiGlobalSettingParam.EEPROM_WRITE_BACK_CACHE = 0;	
+    if (sizeof(int)==sizeof(g_WiFiGlobalSettingParam.EEPROM_WRITE_BACK_CACHE))    // Type_Checking
+    {
+        setting.value = (void*)&g_WiFiGlobalSettingParam.EEPROM_WRITE_BACK_CACHE;
+        setting.unit  = "";
+        setting.helpText  = "A flag that to let vDUT stage WRITE_EEPROM by address, answer READ_EEPROM of a staged address, and write the staged values at FINALIZE_EEPROM with one commit and a readback check, 0: OFF, 1: ON, Default=OFF";
+        g_WiFiGlobalSettingParamMap.insert( pair<string, WIFI_SETTING_STRUCT>("EEPROM_WRITE_BACK_CACHE", setting) );
+    }
+    else    
+    {
+        printf("Parameter Type Error!\n");
+        exit(1);
+    }
+
     // [802.11b] Parameters
     setting.type = WIFI_SETTING_TYPE_INTEGER;
     g_WiFiGlobalSettingParam.ANALYSIS_11B_EQ_TAPS = 1;
@@ -9773,6 +9863,81 @@ int InitializeGlobalSettingContainers(void)
         exit(1);
     }
 
+    setting.type = WIFI_SETTING_TYPE_INTEGER;
+    g_WiFiGlobalSettingParam.EVM_MULTI_PACKET = 0;
+    if (sizeof(int)==sizeof(g_WiFiGlobalSettingParam.EVM_MULTI_PACKET))    // Type_Checking
+    {
+        setting.value = (void*)&g_WiFiGlobalSettingParam.EVM_MULTI_PACKET;
+        setting.unit  = "";
+        setting.helpText = "A flag to measure the EVM_AVERAGE packets from one long capture, each packet analyzed with LP_SelectCaptureRangeForAnalysis(), instead of one capture and trigger wait per packet.\r\n0: OFF, 1: ON, Default value is 0";
+        g_WiFiGlobalSettingParamMap.insert( pair<string, WIFI_SETTING_STRUCT>("EVM_MULTI_PACKET", setting) );
+    }
+    else    
+    {
+        printf("Parameter Type Error!\n");
+        exit(1);
+    }
+
+    setting.type = WIFI_SETTING_TYPE_INTEGER;
+    g_WiFiGlobalSettingParam.EVM_MULTI_PACKET_GAP_US = 100;
+    if (sizeof(int)==sizeof(g_WiFiGlobalSettingParam.EVM_MULTI_PACKET_GAP_US))    // Type_Checking
+    {
+        setting.value = (void*)&g_WiFiGlobalSettingParam.EVM_MULTI_PACKET_GAP_US;
+        setting.unit  = "us";
+        setting.helpText = "Inter-packet gap of the DUT traffic with EVM_MULTI_PACKET=1, the capture is (EVM capture time + gap) x packets.\r\nDefault value is 100";
+        g_WiFiGlobalSettingParamMap.insert( pair<string, WIFI_SETTING_STRUCT>("EVM_MULTI_PACKET_GAP_US", setting) );
+    }
+    else    
+    {
+        printf("Parameter Type Error!\n");
+        exit(1);
+    }
+
+    setting.type = WIFI_SETTING_TYPE_INTEGER;
+    g_WiFiGlobalSettingParam.AVERAGE_EARLY_EXIT = 0;
+    if (sizeof(int)==sizeof(g_WiFiGlobalSettingParam.AVERAGE_EARLY_EXIT))    // Type_Checking
+    {
+        setting.value = (void*)&g_WiFiGlobalSettingParam.AVERAGE_EARLY_EXIT;
+        setting.unit  = "";
+        setting.helpText = "Stop the EVM_AVERAGE/PM_AVERAGE captures once the mean is beyond the limit inputs (EVM_LIMIT_DB, POWER_LIMIT_xxx_DBM) with AVERAGE_CONFIDENCE_LEVEL, 0: OFF, 1: ON.\r\nDefault value is 0";
+        g_WiFiGlobalSettingParamMap.insert( pair<string, WIFI_SETTING_STRUCT>("AVERAGE_EARLY_EXIT", setting) );
+    }
+    else    
+    {
+        printf("Parameter Type Error!\n");
+        exit(1);
+    }
+
+    setting.type = WIFI_SETTING_TYPE_DOUBLE;
+    g_WiFiGlobalSettingParam.AVERAGE_CONFIDENCE_LEVEL = 99.0;
+    if (sizeof(double)==sizeof(g_WiFiGlobalSettingParam.AVERAGE_CONFIDENCE_LEVEL))    // Type_Checking
+    {
+        setting.value = (void*)&g_WiFiGlobalSettingParam.AVERAGE_CONFIDENCE_LEVEL;
+        setting.unit  = "%";
+        setting.helpText = "Two-sided Student-t confidence level of the mean for AVERAGE_EARLY_EXIT, 95, 99 or 99.9, other values are rounded up. The interval is tested after every sample, so the wrong decision rate is up to (tests) x (100-level)/2 %.\r\nDefault value is 99";
+        g_WiFiGlobalSettingParamMap.insert( pair<string, WIFI_SETTING_STRUCT>("AVERAGE_CONFIDENCE_LEVEL", setting) );
+    }
+    else    
+    {
+        printf("Parameter Type Error!\n");
+        exit(1);
+    }
+
+    setting.type = WIFI_SETTING_TYPE_INTEGER;
+    g_WiFiGlobalSettingParam.AVERAGE_MIN_SAMPLES = 3;
+    if (sizeof(int)==sizeof(g_WiFiGlobalSettingParam.AVERAGE_MIN_SAMPLES))    // Type_Checking
+    {
+        setting.value = (void*)&g_WiFiGlobalSettingParam.AVERAGE_MIN_SAMPLES;
+        setting.unit  = "";
+        setting.helpText = "Samples averaged at least before an AVERAGE_EARLY_EXIT, at least 2.\r\nDefault value is 3";
+        g_WiFiGlobalSettingParamMap.insert( pair<string, WIFI_SETTING_STRUCT>("AVERAGE_MIN_SAMPLES", setting) );
+    }
+    else    
+    {
+        printf("Parameter Type Error!\n");
+        exit(1);
+    }
+
     setting.type = WIFI_SETTING_TYPE_INTEGER;
     g_WiFiGlobalSettingParam.EVM_SYMBOL_NUM = 18;
     if (sizeof(int)==sizeof(g_WiFiGlobalSettingParam.EVM_SYMBOL_NUM))    // Type_Checking
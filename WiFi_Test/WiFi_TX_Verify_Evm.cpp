@@ -34,6 +34,9 @@ struct tagParam
 	int    TX2;                                     /*!< DUT TX2 on/off. Default=0(off) */
 	int    TX3;                                     /*!< DUT TX3 on/off. Default=0(off) */
 	int    TX4;                                     /*!< DUT TX4 on/off. Default=0(off) */
+
+	// Optional Parameters
+	double EVM_LIMIT_DB;                            /*!< EVM limit of the item, for AVERAGE_EARLY_EXIT only. Default=NA_NUMBER(no early exit) */
 } l_txVerifyEvmParam;
 
 struct tagReturn
@@ -79,6 +82,7 @@ struct tagReturn
 	int	   SPATIAL_STREAM;
 	double DATA_RATE;
 	double CABLE_LOSS_DB[MAX_DATA_STREAM];             /*! The path loss of test system. */
+	int    AVERAGE_COUNT;                              /*!< Number of packets averaged, less than EVM_AVERAGE after an AVERAGE_EARLY_EXIT */
 
 	char   ERROR_MESSAGE[MAX_BUFFER_SIZE];
 } l_txVerifyEvmReturn;
@@ -199,6 +203,7 @@ WIFI_TEST_API int WiFi_TX_Verify_Evm(void)
 		/*----------------------*
 		 * Get input parameters *
 		 *----------------------*/
+		l_txVerifyEvmParam.EVM_LIMIT_DB = NA_NUMBER;	// the limit of the previous item is not kept
 		err = GetInputParameters(l_txVerifyEvmParamMap);
 		if ( ERR_OK!=err )
 		{
@@ -400,7 +405,16 @@ WIFI_TEST_API int WiFi_TX_Verify_Evm(void)
 		vDUT_AddDoubleParameter (g_WiFi_Dut, "TX_POWER_DBM",	  l_txVerifyEvmParam.TX_POWER_DBM);
 		TM_SetDoubleParameter(g_WiFi_Test_ID, "TX_POWER_DBM", l_txVerifyEvmParam.TX_POWER_DBM); // -cfy@sunnyvale, 2012/3/13-
 
-		if ( (g_dutConfigChanged==true)||(g_vDutTxActived==false) )
+		// The look-ahead of the previous item may have configured the DUT already
+		char dutTxKey[MAX_BUFFER_SIZE] = {'\0'};
+		WiFiDutTxKey(dutTxKey, l_txVerifyEvmParam.FREQ_MHZ, l_txVerifyEvmParam.DATA_RATE, l_txVerifyEvmParam.BANDWIDTH, l_txVerifyEvmParam.PREAMBLE, l_txVerifyEvmParam.PACKET_FORMAT_11N,
+					 l_txVerifyEvmParam.GUARD_INTERVAL_11N, l_txVerifyEvmParam.TX_POWER_DBM, l_txVerifyEvmParam.TX1, l_txVerifyEvmParam.TX2, l_txVerifyEvmParam.TX3, l_txVerifyEvmParam.TX4);
+
+		if ( WiFiDutTxPrepared(dutTxKey, logMessage) )
+		{
+			// do nothing
+		}
+		else if ( (g_dutConfigChanged==true)||(g_vDutTxActived==false) )
 		{
 			if ( g_vDutTxActived==true )
 			{
@@ -586,8 +600,13 @@ WIFI_TEST_API int WiFi_TX_Verify_Evm(void)
 		
 #pragma region Setup LP Tester and Capture
 
+			// VSA amplitude from the power this signal was captured with before (VSA_REF_LEVEL_LEARN=1), else from TX_POWER_DBM
+			char   refLevelKey[MAX_BUFFER_SIZE] = {'\0'};
+			WiFiRefLevelKey(refLevelKey, l_txVerifyEvmParam.DATA_RATE, l_txVerifyEvmParam.BANDWIDTH, l_txVerifyEvmParam.TX1, l_txVerifyEvmParam.TX2, l_txVerifyEvmParam.TX3, l_txVerifyEvmParam.TX4);
+			double vsaAmplitudeDbm = WiFiRefLevelPredict(l_txVerifyEvmParam.FREQ_MHZ, refLevelKey, l_txVerifyEvmParam.TX_POWER_DBM-cableLossDb+chainGainDb)+peakToAvgRatio;
+
 			err = ::LP_SetVsa(  l_txVerifyEvmParam.FREQ_MHZ*1e6,
-					l_txVerifyEvmParam.TX_POWER_DBM-cableLossDb+peakToAvgRatio+chainGainDb,
+					vsaAmplitudeDbm,
 					g_WiFiGlobalSettingParam.VSA_PORT,
 					0,
 					g_WiFiGlobalSettingParam.VSA_TRIGGER_LEVEL_DB,
@@ -606,57 +625,123 @@ WIFI_TEST_API int WiFi_TX_Verify_Evm(void)
 			/*------------------*
 			 * Start While Loop *
 			 *------------------*/
+			int    packetNum = 0, packetIndex = 0;
+			vector< double > packetStartUs(g_WiFiGlobalSettingParam.EVM_AVERAGE), packetLengthUs(g_WiFiGlobalSettingParam.EVM_AVERAGE);
+
 			avgIteration = 0;
 			while ( avgIteration<g_WiFiGlobalSettingParam.EVM_AVERAGE )
 			{
 				analysisOK = false;
 				captureOK  = false;
 
-				/*----------------------------*
-				 * Perform Normal VSA capture *
-				 *----------------------------*/
-				HT40ModeOn = 0;
-				err = ::LP_VsaDataCapture( samplingTimeUs/1000000, g_WiFiGlobalSettingParam.VSA_TRIGGER_TYPE, 80e6, HT40ModeOn );
-				if( ERR_OK!=err )	// capture is failed
+				if ( packetIndex<packetNum )
+				{
+					// Next packet of the multi-packet capture
+					captureOK = true;
+				}
+				else
 				{
-					double quickPower = NA_NUMBER;
-					err = QuickCaptureRetry( l_txVerifyEvmParam.FREQ_MHZ, samplingTimeUs, g_WiFiGlobalSettingParam.VSA_TRIGGER_TYPE, HT40ModeOn, &quickPower, logMessage);
-					if (ERR_OK!=err)	// QuickCaptureRetry() is failed
+					// EVM_MULTI_PACKET=1: one capture long enough for the remaining packets
+					double captureTimeUs = samplingTimeUs;
+					if ( 1==g_WiFiGlobalSettingParam.EVM_MULTI_PACKET && 1<(g_WiFiGlobalSettingParam.EVM_AVERAGE-avgIteration) )
 					{
-						// Fail Capture
-						if ( quickPower!=NA_NUMBER )
+						captureTimeUs = (samplingTimeUs+g_WiFiGlobalSettingParam.EVM_MULTI_PACKET_GAP_US)*(g_WiFiGlobalSettingParam.EVM_AVERAGE-avgIteration);
+					}
+					else
+					{
+						// do nothing
+					}
+
+					/*----------------------------*
+					 * Perform Normal VSA capture *
+					 *----------------------------*/
+					HT40ModeOn = 0;
+					err = ::LP_VsaDataCapture( captureTimeUs/1000000, g_WiFiGlobalSettingParam.VSA_TRIGGER_TYPE, 80e6, HT40ModeOn );
+					if( ERR_OK!=err )	// capture is failed
+					{
+						double quickPower = NA_NUMBER;
+						// Under range or the DUT is off its learned power, forget it; QuickCaptureRetry() sets its own amplitude
+						WiFiRefLevelForget(l_txVerifyEvmParam.FREQ_MHZ, refLevelKey);
+						vsaAmplitudeDbm = NA_NUMBER;
+						captureTimeUs   = samplingTimeUs;
+						err = QuickCaptureRetry( l_txVerifyEvmParam.FREQ_MHZ, samplingTimeUs, g_WiFiGlobalSettingParam.VSA_TRIGGER_TYPE, HT40ModeOn, &quickPower, logMessage);
+						if (ERR_OK!=err)	// QuickCaptureRetry() is failed
 						{
-							LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[WiFi] Fail to capture WiFi signal at %d MHz.\nThe DUT power (without path loss) = %.1f dBm and QuickCaptureRetry() return error.\n", l_txVerifyEvmParam.FREQ_MHZ, quickPower);
+							// Fail Capture
+							if ( quickPower!=NA_NUMBER )
+							{
+								LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[WiFi] Fail to capture WiFi signal at %d MHz.\nThe DUT power (without path loss) = %.1f dBm and QuickCaptureRetry() return error.\n", l_txVerifyEvmParam.FREQ_MHZ, quickPower);
+							}
+							else
+							{
+								LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[WiFi] Fail to capture WiFi signal at %d MHz, QuickCaptureRetry() return error.\n", l_txVerifyEvmParam.FREQ_MHZ);
+							}
+							throw logMessage;
 						}
 						else
 						{
-							LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[WiFi] Fail to capture WiFi signal at %d MHz, QuickCaptureRetry() return error.\n", l_txVerifyEvmParam.FREQ_MHZ);
+							LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[WiFi] The QuickCaptureRetry() at %d MHz return OK.\n", l_txVerifyEvmParam.FREQ_MHZ);
 						}
-						throw logMessage;
 					}
 					else
 					{
-						LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[WiFi] The QuickCaptureRetry() at %d MHz return OK.\n", l_txVerifyEvmParam.FREQ_MHZ);
+						LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[WiFi] LP_VsaDataCapture() at %d MHz return OK.\n", l_txVerifyEvmParam.FREQ_MHZ);
+					}
+
+					/*--------------*
+					 *  Capture OK  *
+					 *--------------*/
+					captureOK = true;
+					if (1==g_WiFiGlobalSettingParam.VSA_SAVE_CAPTURE_ALWAYS)
+					{
+						// TODO: must give a warning that VSA_SAVE_CAPTURE_ALWAYS is ON
+						sprintf_s(sigFileNameBuffer, MAX_BUFFER_SIZE, "%s_%d_%s_%s", "WiFi_TX_Evm_SaveAlways", l_txVerifyEvmParam.FREQ_MHZ, l_txVerifyEvmParam.DATA_RATE, l_txVerifyEvmParam.BANDWIDTH);
+						WiFiSaveSigFile(sigFileNameBuffer);
+					}
+					else
+					{
+						// do nothing
+					}
+
+					packetIndex = 0;
+					packetNum   = 0;
+					if ( captureTimeUs>samplingTimeUs )
+					{
+						packetNum = ::LP_GetCapturePacketRanges(captureTimeUs, &packetStartUs[0], &packetLengthUs[0], g_WiFiGlobalSettingParam.EVM_AVERAGE-avgIteration);
+						LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[WiFi] %d complete packets in the %.0f us capture.\n", packetNum, captureTimeUs);
+					}
+					else
+					{
+						// do nothing
+					}
+
+					// Last capture of the item, the DUT can be configured for the next item during the analysis
+					if ( avgIteration==g_WiFiGlobalSettingParam.EVM_AVERAGE-1 || packetNum>=g_WiFiGlobalSettingParam.EVM_AVERAGE-avgIteration )
+					{
+						WiFiStartLookAhead(logMessage);
+					}
+					else
+					{
+						// do nothing
 					}
-				}
-				else
-				{
-					LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[WiFi] LP_VsaDataCapture() at %d MHz return OK.\n", l_txVerifyEvmParam.FREQ_MHZ);
 				}
 
-				/*--------------*
-				 *  Capture OK  *
-				 *--------------*/
-				captureOK = true;
-				if (1==g_WiFiGlobalSettingParam.VSA_SAVE_CAPTURE_ALWAYS)
+				if ( packetIndex<packetNum )
 				{
-					// TODO: must give a warning that VSA_SAVE_CAPTURE_ALWAYS is ON
-					sprintf_s(sigFileNameBuffer, MAX_BUFFER_SIZE, "%s_%d_%s_%s", "WiFi_TX_Evm_SaveAlways", l_txVerifyEvmParam.FREQ_MHZ, l_txVerifyEvmParam.DATA_RATE, l_txVerifyEvmParam.BANDWIDTH);
-					WiFiSaveSigFile(sigFileNameBuffer);
+					err = ::LP_SelectCaptureRangeForAnalysis(packetStartUs[packetIndex], packetLengthUs[packetIndex]);
+					if ( ERR_OK!=err )
+					{
+						LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[WiFi] LP_SelectCaptureRangeForAnalysis() of packet %d return error.\n", packetIndex+1);
+						throw logMessage;
+					}
+					else
+					{
+						packetIndex++;
+					}
 				}
 				else
 				{
-					// do nothing
+					// No complete packet found (or EVM_MULTI_PACKET=0), the whole capture is analyzed
 				}
 #pragma endregion
 
@@ -867,6 +952,7 @@ WIFI_TEST_API int WiFi_TX_Verify_Evm(void)
 
 					// Power
 					rxRmsPowerDb[0][avgIteration-1] = ::LP_GetScalarMeasurement("rmsPowerNoGap",0);
+					WiFiRefLevelLearn(l_txVerifyEvmParam.FREQ_MHZ, refLevelKey, rxRmsPowerDb[0][avgIteration-1], ::LP_GetScalarMeasurement("pkPower", 0), vsaAmplitudeDbm, logMessage);
 					if ( -99.00 >= rxRmsPowerDb[0][avgIteration-1] )
 					{
 						analysisOK = false;
@@ -1028,6 +1114,30 @@ WIFI_TEST_API int WiFi_TX_Verify_Evm(void)
 					symbolClockErr[avgIteration-1] = ::LP_GetScalarMeasurement("symClockErrorPpm", 0);
 				}
 #pragma endregion
+
+				// Stop averaging once the EVM of every stream is clearly within or beyond the limit
+				if ( avgIteration<g_WiFiGlobalSettingParam.EVM_AVERAGE )
+				{
+					bool decided = (0<l_txVerifyEvmReturn.SPATIAL_STREAM);
+					for (int i=0;i<l_txVerifyEvmReturn.SPATIAL_STREAM && decided;i++)
+					{
+						decided = ::AverageDecisionReached(&evmAvgAll[i][0], avgIteration, LOG_20, NA_NUMBER, l_txVerifyEvmParam.EVM_LIMIT_DB);
+					}
+					if ( decided )
+					{
+						LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[WiFi] EVM decided against %.2f dB after %d of %d packets.\n", l_txVerifyEvmParam.EVM_LIMIT_DB, avgIteration, g_WiFiGlobalSettingParam.EVM_AVERAGE);
+						WiFiStartLookAhead(logMessage);
+						break;
+					}
+					else
+					{
+						// do nothing
+					}
+				}
+				else
+				{
+					// do nothing
+				}
 			}   // End - avgIteration
 
 #pragma region Averaging and Saving Test Result
@@ -1039,6 +1149,8 @@ WIFI_TEST_API int WiFi_TX_Verify_Evm(void)
 				double dummyAve, dummyMax, dummyMin;
 				//double dummyAvg[MAX_DATA_STREAM];
 
+				l_txVerifyEvmReturn.AVERAGE_COUNT = avgIteration;
+
 				for(int i=0;i<l_txVerifyEvmReturn.SPATIAL_STREAM;i++)
 				{
 					// Average EVM test result
@@ -1148,6 +1260,9 @@ WIFI_TEST_API int WiFi_TX_Verify_Evm(void)
 	{
 		ReturnErrorMessage(l_txVerifyEvmReturn.ERROR_MESSAGE, msg);
 
+		// The DUT is not shared with the look-ahead of the next item
+		WiFiWaitLookAhead();
+
 		if ( g_vDutTxActived )
 		{
 			int err = ERR_OK;
@@ -1164,6 +1279,9 @@ WIFI_TEST_API int WiFi_TX_Verify_Evm(void)
 		ReturnErrorMessage(l_txVerifyEvmReturn.ERROR_MESSAGE, "[WiFi] Unknown Error!\n");
 		err = -1;
 
+		// The DUT is not shared with the look-ahead of the next item
+		WiFiWaitLookAhead();
+
 		if ( g_vDutTxActived )
 		{
 			int err = ERR_OK;
@@ -2626,6 +2744,21 @@ int InitializeTXVerifyEvmContainers(void)
 		exit(1);
 	}
 
+	l_txVerifyEvmParam.EVM_LIMIT_DB = NA_NUMBER;
+	setting.type = WIFI_SETTING_TYPE_DOUBLE;
+	if (sizeof(double)==sizeof(l_txVerifyEvmParam.EVM_LIMIT_DB))    // Type_Checking
+	{
+		setting.value       = (void*)&l_txVerifyEvmParam.EVM_LIMIT_DB;
+		setting.unit        = "dB";
+		setting.helpText    = "EVM upper limit of the item. With AVERAGE_EARLY_EXIT=1, averaging stops once the EVM is clearly below or above it.\r\nDefault is no limit";
+		l_txVerifyEvmParamMap.insert( pair<string,WIFI_SETTING_STRUCT>("EVM_LIMIT_DB", setting) );
+	}
+	else
+	{
+		printf("Parameter Type Error!\n");
+		exit(1);
+	}
+
 	/*----------------*
 	 * Return Values: *
 	 * ERROR_MESSAGE  *
@@ -3106,6 +3239,21 @@ int InitializeTXVerifyEvmContainers(void)
 		}
 	}
 
+	l_txVerifyEvmReturn.AVERAGE_COUNT = (int)NA_NUMBER;
+	setting.type = WIFI_SETTING_TYPE_INTEGER;
+	if (sizeof(int)==sizeof(l_txVerifyEvmReturn.AVERAGE_COUNT))    // Type_Checking
+	{
+		setting.value       = (void*)&l_txVerifyEvmReturn.AVERAGE_COUNT;
+		setting.unit        = "";
+		setting.helpText    = "Number of packets averaged, less than EVM_AVERAGE after an AVERAGE_EARLY_EXIT";
+		l_txVerifyEvmReturnMap.insert( pair<string,WIFI_SETTING_STRUCT>("AVERAGE_COUNT", setting) );
+	}
+	else
+	{
+		printf("Parameter Type Error!\n");
+		exit(1);
+	}
+
 	l_txVerifyEvmReturn.ERROR_MESSAGE[0] = '\0';
 	setting.type = WIFI_SETTING_TYPE_STRING;
 	if (MAX_BUFFER_SIZE==sizeof(l_txVerifyEvmReturn.ERROR_MESSAGE))    // Type_Checking
@@ -513,7 +513,16 @@ WIFI_TEST_API int WiFi_TX_Verify_Mask(void)
 		}
 		/* <><~~ */
 
-		if ( (g_dutConfigChanged==true)||(g_vDutTxActived==false) )
+		// The look-ahead of the previous item may have configured the DUT already
+		char dutTxKey[MAX_BUFFER_SIZE] = {'\0'};
+		WiFiDutTxKey(dutTxKey, l_txVerifyMaskParam.FREQ_MHZ, l_txVerifyMaskParam.DATA_RATE, l_txVerifyMaskParam.BANDWIDTH, l_txVerifyMaskParam.PREAMBLE, l_txVerifyMaskParam.PACKET_FORMAT_11N,
+					 l_txVerifyMaskParam.GUARD_INTERVAL_11N, l_txVerifyMaskParam.TX_POWER_DBM, l_txVerifyMaskParam.TX1, l_txVerifyMaskParam.TX2, l_txVerifyMaskParam.TX3, l_txVerifyMaskParam.TX4);
+
+		if ( WiFiDutTxPrepared(dutTxKey, logMessage) )
+		{
+			// do nothing
+		}
+		else if ( (g_dutConfigChanged==true)||(g_vDutTxActived==false) )
 		{
 			if ( g_vDutTxActived==true )
 			{
@@ -697,8 +706,13 @@ WIFI_TEST_API int WiFi_TX_Verify_Mask(void)
 		
 #pragma region Setup LP Tester and Capture
 
+			// VSA amplitude from the power this signal was captured with before (VSA_REF_LEVEL_LEARN=1), else from TX_POWER_DBM
+			char   refLevelKey[MAX_BUFFER_SIZE] = {'\0'};
+			WiFiRefLevelKey(refLevelKey, l_txVerifyMaskParam.DATA_RATE, l_txVerifyMaskParam.BANDWIDTH, l_txVerifyMaskParam.TX1, l_txVerifyMaskParam.TX2, l_txVerifyMaskParam.TX3, l_txVerifyMaskParam.TX4);
+			double vsaAmplitudeDbm = WiFiRefLevelPredict(l_txVerifyMaskParam.FREQ_MHZ, refLevelKey, l_txVerifyMaskParam.TX_POWER_DBM-cableLossDb+chainGainDb)+peakToAvgRatio;
+
 			err = ::LP_SetVsa(  l_txVerifyMaskParam.FREQ_MHZ*1e6,
-					l_txVerifyMaskParam.TX_POWER_DBM-cableLossDb+peakToAvgRatio+chainGainDb,
+					vsaAmplitudeDbm,
 					g_WiFiGlobalSettingParam.VSA_PORT,
 					0,
 					g_WiFiGlobalSettingParam.VSA_TRIGGER_LEVEL_DB,
@@ -737,6 +751,9 @@ WIFI_TEST_API int WiFi_TX_Verify_Mask(void)
 				if( ERR_OK!=err )	// capture is failed
 				{
 					double quickPower = NA_NUMBER;
+					// Under range or the DUT is off its learned power, forget it; QuickCaptureRetry() sets its own amplitude
+					WiFiRefLevelForget(l_txVerifyMaskParam.FREQ_MHZ, refLevelKey);
+					vsaAmplitudeDbm = NA_NUMBER;
 					err = QuickCaptureRetry( l_txVerifyMaskParam.FREQ_MHZ, samplingTimeUs, g_WiFiGlobalSettingParam.VSA_TRIGGER_TYPE, HT40ModeOn, &quickPower, logMessage);
 					if (ERR_OK!=err)	// QuickCaptureRetry() is failed
 					{
@@ -778,6 +795,16 @@ WIFI_TEST_API int WiFi_TX_Verify_Mask(void)
 					// do nothing
 				}
 
+				// Last capture of the item, the DUT can be configured for the next item during the analysis
+				if ( avgIteration==g_WiFiGlobalSettingParam.MASK_FFT_AVERAGE-1 )
+				{
+					WiFiStartLookAhead(logMessage);
+				}
+				else
+				{
+					// do nothing
+				}
+
 				/*------------------*
 				 *  Power Analysis  *
 				 *------------------*/
@@ -797,6 +824,9 @@ WIFI_TEST_API int WiFi_TX_Verify_Mask(void)
 					LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[WiFi] LP_AnalyzePower() return OK.\n");
 				}
 
+				// Power at the VSA port (without path loss), for the VSA amplitude of the next capture of this signal
+				WiFiRefLevelLearn(l_txVerifyMaskParam.FREQ_MHZ, refLevelKey, ::LP_GetScalarMeasurement("P_av_no_gap_all_dBm", 0), ::LP_GetScalarMeasurement("P_peak_all_dBm", 0), vsaAmplitudeDbm, logMessage);
+
 				/*-----------------------------------------*
 				 *  Retrieve and Average analysis Results  *
 				 *-----------------------------------------*/
@@ -1031,6 +1061,9 @@ WIFI_TEST_API int WiFi_TX_Verify_Mask(void)
 	{
 		ReturnErrorMessage(l_txVerifyMaskReturn.ERROR_MESSAGE, msg);
 
+		// The DUT is not shared with the look-ahead of the next item
+		WiFiWaitLookAhead();
+
 		if ( g_vDutTxActived )
 		{
 			int err = ERR_OK;
@@ -1047,6 +1080,9 @@ WIFI_TEST_API int WiFi_TX_Verify_Mask(void)
 		ReturnErrorMessage(l_txVerifyMaskReturn.ERROR_MESSAGE, "[WiFi] Unknown Error!\n");
 		err = -1;
 
+		// The DUT is not shared with the look-ahead of the next item
+		WiFiWaitLookAhead();
+
 		if ( g_vDutTxActived )
 		{
 			int err = ERR_OK;
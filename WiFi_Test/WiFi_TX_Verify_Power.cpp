@@ -36,6 +36,10 @@ struct tagParam
 	int    TX2;                                     /*!< DUT TX2 on/off. Default=0(off) */
 	int    TX3;                                     /*!< DUT TX3 on/off. Default=0(off) */
 	int    TX4;                                     /*!< DUT TX4 on/off. Default=0(off) */
+
+	// Optional Parameters
+	double POWER_LIMIT_LOWER_DBM;                   /*!< Lower power limit of the item, for AVERAGE_EARLY_EXIT only. Default=NA_NUMBER(no limit) */
+	double POWER_LIMIT_UPPER_DBM;                   /*!< Upper power limit of the item, for AVERAGE_EARLY_EXIT only. Default=NA_NUMBER(no limit) */
 } l_txVerifyPowerParam;
 
 struct tagReturn
@@ -51,6 +55,7 @@ struct tagReturn
 	double POWER_PEAK_MIN_DBM;                      /*!< (Minimum) Peak power in dBm. */
 
 	double CABLE_LOSS_DB[MAX_DATA_STREAM];          /*! The path loss of test system. */
+	int    AVERAGE_COUNT;                           /*!< Number of captures averaged, less than PM_AVERAGE after an AVERAGE_EARLY_EXIT */
 	char   ERROR_MESSAGE[MAX_BUFFER_SIZE];
 } l_txVerifyPowerReturn;
 #pragma endregion
@@ -162,6 +167,8 @@ WIFI_TEST_API int WiFi_TX_Verify_Power(void)
 		/*----------------------*
 		 * Get input parameters *
 		 *----------------------*/
+		l_txVerifyPowerParam.POWER_LIMIT_LOWER_DBM = NA_NUMBER;	// the limits of the previous item are not kept
+		l_txVerifyPowerParam.POWER_LIMIT_UPPER_DBM = NA_NUMBER;
 		err = GetInputParameters(l_txVerifyPowerParamMap);
 		if ( ERR_OK!=err )
 		{
@@ -351,7 +358,16 @@ WIFI_TEST_API int WiFi_TX_Verify_Power(void)
 		vDUT_AddDoubleParameter (g_WiFi_Dut, "TX_POWER_DBM",	  l_txVerifyPowerParam.TX_POWER_DBM);
 		TM_SetDoubleParameter(g_WiFi_Test_ID, "TX_POWER_DBM", l_txVerifyPowerParam.TX_POWER_DBM); // -cfy@sunnyvale, 2012/3/13-
 
-		if ( (g_dutConfigChanged==true)||(g_vDutTxActived==false) )
+		// The look-ahead of the previous item may have configured the DUT already
+		char dutTxKey[MAX_BUFFER_SIZE] = {'\0'};
+		WiFiDutTxKey(dutTxKey, l_txVerifyPowerParam.FREQ_MHZ, l_txVerifyPowerParam.DATA_RATE, l_txVerifyPowerParam.BANDWIDTH, l_txVerifyPowerParam.PREAMBLE, l_txVerifyPowerParam.PACKET_FORMAT_11N,
+					 l_txVerifyPowerParam.GUARD_INTERVAL_11N, l_txVerifyPowerParam.TX_POWER_DBM, l_txVerifyPowerParam.TX1, l_txVerifyPowerParam.TX2, l_txVerifyPowerParam.TX3, l_txVerifyPowerParam.TX4);
+
+		if ( WiFiDutTxPrepared(dutTxKey, logMessage) )
+		{
+			// do nothing
+		}
+		else if ( (g_dutConfigChanged==true)||(g_vDutTxActived==false) )
 		{
 			if ( g_vDutTxActived==true )
 			{
@@ -537,8 +553,13 @@ WIFI_TEST_API int WiFi_TX_Verify_Power(void)
 		
 #pragma region Setup LP Tester and Capture
 
+			// VSA amplitude from the power this signal was captured with before (VSA_REF_LEVEL_LEARN=1), else from TX_POWER_DBM
+			char   refLevelKey[MAX_BUFFER_SIZE] = {'\0'};
+			WiFiRefLevelKey(refLevelKey, l_txVerifyPowerParam.DATA_RATE, l_txVerifyPowerParam.BANDWIDTH, l_txVerifyPowerParam.TX1, l_txVerifyPowerParam.TX2, l_txVerifyPowerParam.TX3, l_txVerifyPowerParam.TX4);
+			double vsaAmplitudeDbm = WiFiRefLevelPredict(l_txVerifyPowerParam.FREQ_MHZ, refLevelKey, l_txVerifyPowerParam.TX_POWER_DBM-cableLossDb+chainGainDb)+peakToAvgRatio;
+
 			err = ::LP_SetVsa(  l_txVerifyPowerParam.FREQ_MHZ*1e6,
-					l_txVerifyPowerParam.TX_POWER_DBM-cableLossDb+peakToAvgRatio+chainGainDb,
+					vsaAmplitudeDbm,
 					g_WiFiGlobalSettingParam.VSA_PORT,
 					0,
 					g_WiFiGlobalSettingParam.VSA_TRIGGER_LEVEL_DB,
@@ -572,6 +593,9 @@ WIFI_TEST_API int WiFi_TX_Verify_Power(void)
 				if( ERR_OK!=err )	// capture is failed
 				{
 					double quickPower = NA_NUMBER;
+					// Under range or the DUT is off its learned power, forget it; QuickCaptureRetry() sets its own amplitude
+					WiFiRefLevelForget(l_txVerifyPowerParam.FREQ_MHZ, refLevelKey);
+					vsaAmplitudeDbm = NA_NUMBER;
 					err = QuickCaptureRetry( l_txVerifyPowerParam.FREQ_MHZ, samplingTimeUs, g_WiFiGlobalSettingParam.VSA_TRIGGER_TYPE, HT40ModeOn, &quickPower, logMessage);
 					if (ERR_OK!=err)	// QuickCaptureRetry() is failed
 					{
@@ -612,6 +636,16 @@ WIFI_TEST_API int WiFi_TX_Verify_Power(void)
 					// do nothing
 				}
 
+				// Last capture of the item, the DUT can be configured for the next item during the analysis
+				if ( avgIteration==g_WiFiGlobalSettingParam.PM_AVERAGE-1 )
+				{
+					WiFiStartLookAhead(logMessage);
+				}
+				else
+				{
+					// do nothing
+				}
+
 				/*------------------*
 				 *  Power Analysis  *
 				 *------------------*/
@@ -631,6 +665,9 @@ WIFI_TEST_API int WiFi_TX_Verify_Power(void)
 					LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[WiFi] LP_AnalyzePower() return OK.\n");
 				}
 
+				// Power at the VSA port (without path loss), for the VSA amplitude of the next capture of this signal
+				WiFiRefLevelLearn(l_txVerifyPowerParam.FREQ_MHZ, refLevelKey, ::LP_GetScalarMeasurement("P_av_no_gap_all_dBm", 0), ::LP_GetScalarMeasurement("P_peak_all_dBm", 0), vsaAmplitudeDbm, logMessage);
+
 #pragma region Retrieve analysis Results
 				/*-----------------------------*
 				 *  Retrieve analysis Results  *
@@ -690,6 +727,19 @@ WIFI_TEST_API int WiFi_TX_Verify_Power(void)
 					powerPkEachBurst[avgIteration-1] = powerPkEachBurst[avgIteration-1] + l_txVerifyPowerParam.CABLE_LOSS_DB[antenaOrder-1];
 				}
 #pragma endregion
+
+				// Stop averaging once the power is clearly within or beyond the limits
+				if ( avgIteration<g_WiFiGlobalSettingParam.PM_AVERAGE &&
+					 ::AverageDecisionReached(&powerAvEachBurst[0], avgIteration, LOG_10, l_txVerifyPowerParam.POWER_LIMIT_LOWER_DBM, l_txVerifyPowerParam.POWER_LIMIT_UPPER_DBM) )
+				{
+					LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[WiFi] Power decided against the limits after %d of %d captures.\n", avgIteration, g_WiFiGlobalSettingParam.PM_AVERAGE);
+					WiFiStartLookAhead(logMessage);
+					break;
+				}
+				else
+				{
+					// do nothing
+				}
 			}   // End - avgIteration
 
 #pragma region Averaging and Saving Test Result
@@ -698,6 +748,8 @@ WIFI_TEST_API int WiFi_TX_Verify_Power(void)
 			 *----------------------------------*/
 			if ( (ERR_OK==err) && captureOK && analysisOK )
 			{
+				l_txVerifyPowerReturn.AVERAGE_COUNT = avgIteration;
+
 				// Average Power test result
 				::AverageTestResult(&powerAvEachBurst[0], avgIteration, LOG_10, l_txVerifyPowerReturn.POWER_AVERAGE_DBM, l_txVerifyPowerReturn.POWER_AVERAGE_MAX_DBM, l_txVerifyPowerReturn.POWER_AVERAGE_MIN_DBM);
 
@@ -762,6 +814,9 @@ WIFI_TEST_API int WiFi_TX_Verify_Power(void)
 	{
 		ReturnErrorMessage(l_txVerifyPowerReturn.ERROR_MESSAGE, msg);
 
+		// The DUT is not shared with the look-ahead of the next item
+		WiFiWaitLookAhead();
+
 		if ( g_vDutTxActived )
 		{
 			int err = ERR_OK;
@@ -778,6 +833,9 @@ WIFI_TEST_API int WiFi_TX_Verify_Power(void)
 		ReturnErrorMessage(l_txVerifyPowerReturn.ERROR_MESSAGE, "[WiFi] Unknown Error!\n");
 		err = -1;
 
+		// The DUT is not shared with the look-ahead of the next item
+		WiFiWaitLookAhead();
+
 		if ( g_vDutTxActived )
 		{
 			int err = ERR_OK;
@@ -1690,6 +1748,36 @@ int InitializeTXVerifyPowerContainers(void)
 		exit(1);
 	}
 
+	l_txVerifyPowerParam.POWER_LIMIT_LOWER_DBM = NA_NUMBER;
+	setting.type = WIFI_SETTING_TYPE_DOUBLE;
+	if (sizeof(double)==sizeof(l_txVerifyPowerParam.POWER_LIMIT_LOWER_DBM))    // Type_Checking
+	{
+		setting.value       = (void*)&l_txVerifyPowerParam.POWER_LIMIT_LOWER_DBM;
+		setting.unit        = "dBm";
+		setting.helpText    = "Lower power limit of the item. With AVERAGE_EARLY_EXIT=1, averaging stops once the power is clearly within or beyond the limits.\r\nDefault is no limit";
+		l_txVerifyPowerParamMap.insert( pair<string,WIFI_SETTING_STRUCT>("POWER_LIMIT_LOWER_DBM", setting) );
+	}
+	else
+	{
+		printf("Parameter Type Error!\n");
+		exit(1);
+	}
+
+	l_txVerifyPowerParam.POWER_LIMIT_UPPER_DBM = NA_NUMBER;
+	setting.type = WIFI_SETTING_TYPE_DOUBLE;
+	if (sizeof(double)==sizeof(l_txVerifyPowerParam.POWER_LIMIT_UPPER_DBM))    // Type_Checking
+	{
+		setting.value       = (void*)&l_txVerifyPowerParam.POWER_LIMIT_UPPER_DBM;
+		setting.unit        = "dBm";
+		setting.helpText    = "Upper power limit of the item. With AVERAGE_EARLY_EXIT=1, averaging stops once the power is clearly within or beyond the limits.\r\nDefault is no limit";
+		l_txVerifyPowerParamMap.insert( pair<string,WIFI_SETTING_STRUCT>("POWER_LIMIT_UPPER_DBM", setting) );
+	}
+	else
+	{
+		printf("Parameter Type Error!\n");
+		exit(1);
+	}
+
 	/*----------------*
 	 * Return Values: *
 	 * ERROR_MESSAGE  *
@@ -1823,6 +1911,21 @@ int InitializeTXVerifyPowerContainers(void)
 		}
 	}
 
+	l_txVerifyPowerReturn.AVERAGE_COUNT = (int)NA_NUMBER;
+	setting.type = WIFI_SETTING_TYPE_INTEGER;
+	if (sizeof(int)==sizeof(l_txVerifyPowerReturn.AVERAGE_COUNT))    // Type_Checking
+	{
+		setting.value       = (void*)&l_txVerifyPowerReturn.AVERAGE_COUNT;
+		setting.unit        = "";
+		setting.helpText    = "Number of captures averaged, less than PM_AVERAGE after an AVERAGE_EARLY_EXIT";
+		l_txVerifyPowerReturnMap.insert( pair<string,WIFI_SETTING_STRUCT>("AVERAGE_COUNT", setting) );
+	}
+	else
+	{
+		printf("Parameter Type Error!\n");
+		exit(1);
+	}
+
 	l_txVerifyPowerReturn.ERROR_MESSAGE[0] = '\0';
 	setting.type = WIFI_SETTING_TYPE_STRING;
 	if (MAX_BUFFER_SIZE==sizeof(l_txVerifyPowerReturn.ERROR_MESSAGE))    // Type_Checking
@@ -559,8 +559,13 @@ WIFI_TEST_API int WiFi_TX_Verify_Spectrum(void)
 		
 #pragma region Setup LP Tester and Capture
 
+			// VSA amplitude from the power this signal was captured with before (VSA_REF_LEVEL_LEARN=1), else from TX_POWER_DBM
+			char   refLevelKey[MAX_BUFFER_SIZE] = {'\0'};
+			WiFiRefLevelKey(refLevelKey, l_txVerifyFlatnessParam.DATA_RATE, l_txVerifyFlatnessParam.BANDWIDTH, l_txVerifyFlatnessParam.TX1, l_txVerifyFlatnessParam.TX2, l_txVerifyFlatnessParam.TX3, l_txVerifyFlatnessParam.TX4);
+			double vsaAmplitudeDbm = WiFiRefLevelPredict(l_txVerifyFlatnessParam.FREQ_MHZ, refLevelKey, l_txVerifyFlatnessParam.TX_POWER_DBM-cableLossDb+chainGainDb)+peakToAvgRatio;
+
 			err = ::LP_SetVsa(  l_txVerifyFlatnessParam.FREQ_MHZ*1e6,
-					l_txVerifyFlatnessParam.TX_POWER_DBM-cableLossDb+peakToAvgRatio+chainGainDb,
+					vsaAmplitudeDbm,
 					g_WiFiGlobalSettingParam.VSA_PORT,
 					0,
 					g_WiFiGlobalSettingParam.VSA_TRIGGER_LEVEL_DB,
@@ -585,6 +590,9 @@ WIFI_TEST_API int WiFi_TX_Verify_Spectrum(void)
 			if( ERR_OK!=err )	// capture is failed
 			{
 				double quickPower = NA_NUMBER;
+				// Under range or the DUT is off its learned power, forget it; QuickCaptureRetry() sets its own amplitude
+				WiFiRefLevelForget(l_txVerifyFlatnessParam.FREQ_MHZ, refLevelKey);
+				vsaAmplitudeDbm = NA_NUMBER;
 				err = QuickCaptureRetry( l_txVerifyFlatnessParam.FREQ_MHZ, samplingTimeUs, g_WiFiGlobalSettingParam.VSA_TRIGGER_TYPE, HT40ModeOn, &quickPower, logMessage);
 				if (ERR_OK!=err)	// QuickCaptureRetry() is failed
 				{
@@ -966,6 +974,16 @@ WIFI_TEST_API int WiFi_TX_Verify_Spectrum(void)
 			}
 #pragma endregion
 
+			// The 802.11a/b/g/n analysis also measures the power, the FFT of the DSSS-2 01 sequence does not
+			if ( !(wifiMode==WIFI_11B && 0==strcmp(l_txVerifyFlatnessParam.DATA_RATE, "DSSS-2") && 1==g_WiFiGlobalSettingParam.ANALYSIS_11B_FIXED_01_DATA_SEQUENCE) )
+			{
+				WiFiRefLevelLearn(l_txVerifyFlatnessParam.FREQ_MHZ, refLevelKey, ::LP_GetScalarMeasurement("rmsPowerNoGap", 0), ::LP_GetScalarMeasurement("pkPower", 0), vsaAmplitudeDbm, logMessage);
+			}
+			else
+			{
+				// do nothing
+			}
+
 #pragma region Averaging and Saving Test Result // Modified /* -cfy@sunnyvale, 2012/3/13- */
 			/*----------------------------------*
 			 * Averaging and Saving Test Result *
@@ -109,6 +109,8 @@ WIFI_TEST_API int WIFI_technologyRegister()
 
 		TM_InstallCallbackFunction(technologyID, "VDUT_DISABLED",			WiFi_vDut_Disabled);
 		TM_InstallCallbackFunction(technologyID, "VDUT_ENABLED",			WiFi_vDut_Enabled);
+
+		TM_InstallLookAheadFunction(technologyID, WiFi_Dut_Look_Ahead);
         
         g_WiFi_Test_ID = technologyID;
 		
@@ -143,6 +143,7 @@ WIFI_TEST_API int  WiFiSaveSigFile(char* fileName);
 WIFI_TEST_API int  CheckPathLossTable(int testID, int freqMHz, int ant01, int ant02, int ant03, int ant04, double *cableLoss, double *cableLossReturn, double *cableLossDb);
 WIFI_TEST_API int  CheckPathLossTableExt(int testID, int freqMHz, int ant01, int ant02, int ant03, int ant04, double *cableLoss, double *cableLossReturn, double *cableLossDb, int indicatorTxRx);
 WIFI_TEST_API int  AverageTestResult(double *resultArray, int averageTimes, int logType, double &averageResult, double &maxResult, double &minResult);
+WIFI_TEST_API bool AverageDecisionReached(double *resultArray, int averageTimes, int logType, double lowerLimit, double upperLimit);
 WIFI_TEST_API double CheckSamplingTime(int wifiMode, char *preamble11B, char *dataRate, char *packetFormat11N);
 WIFI_TEST_API double CalcCableLossDb(int ant1, int ant2, int ant3, int ant4, double cableLoss1, double cableLoss2, double cableLoss3, double cableLoss4);
 
@@ -183,6 +184,16 @@ WIFI_TEST_API void ParseSplitString(const std::string &splitteValue, const std::
 WIFI_TEST_API double CalculateIQtoP(double data_i, double data_q);
 WIFI_TEST_API int  QuickCaptureRetry(double centerFreqMHz, double samplingTimeUS, int triggerType, int ht40Mode, double *PowerDbm, char *errorMsg);
 WIFI_TEST_API int  QuickCapturePower(double centerFreqMHz, double samplingTimeUS, int triggerType, int ht40Mode, double *PowerDbm, char *errorMsg);
+WIFI_TEST_API void WiFiRefLevelKey(char *refLevelKey, char *dataRate, char *bandwidth, int tx1, int tx2, int tx3, int tx4);
+WIFI_TEST_API double WiFiRefLevelPredict(int freqMHz, char *refLevelKey, double expectedPowerDbm);
+WIFI_TEST_API void WiFiRefLevelLearn(int freqMHz, char *refLevelKey, double avgPowerDbm, double peakPowerDbm, double vsaAmplitudeDbm, char *errorMsg);
+WIFI_TEST_API void WiFiRefLevelForget(int freqMHz, char *refLevelKey);
+WIFI_TEST_API void WiFiDutTxKey(char *dutTxKey, int freqMHz, char *dataRate, char *bandwidth, char *preamble, char *packetFormat11N,
+								char *guardInterval11N, double txPowerDbm, int tx1, int tx2, int tx3, int tx4);
+WIFI_TEST_API bool WiFiDutTxPrepared(char *dutTxKey, char *errorMsg);
+WIFI_TEST_API void WiFiStartLookAhead(char *errorMsg);
+WIFI_TEST_API void WiFiWaitLookAhead(void);
+WIFI_TEST_API int WiFi_Dut_Look_Ahead(void);
 
 WIFI_TEST_API void InitializeInternalTxParameters(void);
 WIFI_TEST_API void InitializeInternalRxParameters(void);
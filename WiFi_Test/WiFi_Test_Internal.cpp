@@ -2,7 +2,9 @@
 #include "WiFi_Test.h"
 #include "IQlite_Logger.h"
 #include "IQmeasure.h"
+#include "WiFi_RateTable.h"
 #include "math.h"
+#include "float.h"
 //Move to stdafx.h
 //#include "lp_time.h"
 
@@ -24,6 +26,7 @@ int              g_WiFi_Test_timer  = -1;
 int				 g_Tester_Type      = IQ_View;
 int				 g_Tester_Number    = 0;
 int				 g_Tester_Reconnect = 0;
+char			 g_WiFiDutSerialNumber[MAX_BUFFER_SIZE] = {'\0'};
 
 
 double			 g_last_TxPower_dBm_Record = 0; // Record the Tx power used in last test item. // -cfy@sunnyvale, 2012/3/13-
@@ -245,6 +248,111 @@ WIFI_TEST_API int AverageTestResult(double *resultArray, int averageTimes, int l
     return err;
 }
 
+// Value AverageTestResult() sums for a result: the result itself (Linear), 10^(result/logType), squared for RMS_LOG_20
+static double AverageDomainValue(double result, int logType)
+{
+	if ( logType==Linear )
+	{
+		return result;
+	}
+	else if ( logType==RMS_LOG_20 )
+	{
+		return pow(pow(10, result/logType), 2);
+	}
+	else
+	{
+		return pow(10, result/logType);
+	}
+}
+
+// Result of an average of AverageDomainValue() values, as AverageTestResult() computes it
+static double AverageDomainResult(double value, int logType)
+{
+	if ( logType==Linear )
+	{
+		return value;
+	}
+	else if ( value<=0 )
+	{
+		return -DBL_MAX;
+	}
+	else if ( logType==RMS_LOG_20 )
+	{
+		return logType*log10(sqrt(value));
+	}
+	else
+	{
+		return logType*log10(value);
+	}
+}
+
+// Two-sided Student-t quantiles for 1..30 degrees of freedom; above 30 the 30 value is used, which is conservative
+#define T_QUANTILE_MAX_DOF	30
+static const double g_tQuantile95[T_QUANTILE_MAX_DOF] =
+{
+	12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+	 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+	 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+static const double g_tQuantile99[T_QUANTILE_MAX_DOF] =
+{
+	63.657, 9.925, 5.841, 4.604, 4.032, 3.707, 3.499, 3.355, 3.250, 3.169,
+	 3.106, 3.055, 3.012, 2.977, 2.947, 2.921, 2.898, 2.878, 2.861, 2.845,
+	 2.831, 2.819, 2.807, 2.797, 2.787, 2.779, 2.771, 2.763, 2.756, 2.750
+};
+static const double g_tQuantile999[T_QUANTILE_MAX_DOF] =
+{
+	636.619, 31.599, 12.924, 8.610, 6.869, 5.959, 5.408, 5.041, 4.781, 4.587,
+	  4.437,  4.318,  4.221, 4.140, 4.073, 4.015, 3.965, 3.922, 3.883, 3.850,
+	  3.819,  3.792,  3.768, 3.745, 3.725, 3.707, 3.690, 3.674, 3.659, 3.646
+};
+
+// Half width of the confidence interval of the mean in standard errors, the level is rounded up to 95, 99 or 99.9 %
+static double StudentTQuantile(int degreesOfFreedom, double confidencePercent)
+{
+	const double *table = (confidencePercent<=95.0) ? g_tQuantile95 : ( (confidencePercent<=99.0) ? g_tQuantile99 : g_tQuantile999 );
+	return table[min(max(degreesOfFreedom, 1), T_QUANTILE_MAX_DOF)-1];
+}
+
+// The interval is tested after every sample from AVERAGE_MIN_SAMPLES on, so a wrong decision has a probability of up to
+// (number of tests) x (100-AVERAGE_CONFIDENCE_LEVEL)/2 %, e.g. 8 x 0.5 % = 4 % for 99 % and 3 to 10 samples.
+WIFI_TEST_API bool AverageDecisionReached(double *resultArray, int averageTimes, int logType, double lowerLimit, double upperLimit)
+{
+	// Disabled, no limit given, or too few samples for a variance
+	if ( 1!=g_WiFiGlobalSettingParam.AVERAGE_EARLY_EXIT || (NA_NUMBER==lowerLimit && NA_NUMBER==upperLimit) ||
+		 averageTimes<max(2, g_WiFiGlobalSettingParam.AVERAGE_MIN_SAMPLES) )
+	{
+		return false;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	// Running mean and variance (Welford) in the averaging domain
+	double mean = 0.0, m2 = 0.0;
+	for (int i=0;i<averageTimes;i++)
+	{
+		if ( NA_NUMBER==resultArray[i] )
+		{
+			return false;
+		}
+		double value = AverageDomainValue(resultArray[i], logType);
+		double delta = value - mean;
+		mean += delta/(i+1);
+		m2   += delta*(value-mean);
+	}
+	double halfWidth = StudentTQuantile(averageTimes-1, g_WiFiGlobalSettingParam.AVERAGE_CONFIDENCE_LEVEL)*sqrt(m2/(averageTimes-1)/averageTimes);
+	double low  = AverageDomainResult(mean-halfWidth, logType);
+	double high = AverageDomainResult(mean+halfWidth, logType);
+
+	// The whole confidence interval is on one side of every given limit
+	bool pass = (NA_NUMBER==lowerLimit || low>lowerLimit) && (NA_NUMBER==upperLimit || high<upperLimit);
+	bool fail = (NA_NUMBER!=lowerLimit && high<lowerLimit) || (NA_NUMBER!=upperLimit && low>upperLimit);
+
+	return pass || fail;
+}
+
 WIFI_TEST_API int  RespondToQueryInput( std::map<std::string, WIFI_SETTING_STRUCT>& inputMap)
 {
     int err = ERR_OK;
@@ -494,6 +602,18 @@ WIFI_TEST_API int  ReturnErrorMessage(char *errParameter, const char *format, ..
 WIFI_TEST_API int  LogReturnMessage(char *errMsg, int sizeOfBuf, LOGGER_LEVEL level, const char *format, ...)
 {
     int  err = ERR_OK;
+
+	// Warnings and information the logger discards are not formatted, errMsg only gets the format.
+	// Errors are always formatted, the callers throw errMsg.
+	if ( g_Logger_ID>=0 && level>LOGGER_ERROR && !::LOGGER_IsEnabled(LOG_IQLITE_CORE, level) )
+	{
+		strncpy_s(errMsg, sizeOfBuf, format, _TRUNCATE);
+		return err;
+	}
+	else
+	{
+		// do nothing
+	}
 	
 	// Log message format ... variable argument list
 	va_list ap;
@@ -504,7 +624,7 @@ WIFI_TEST_API int  LogReturnMessage(char *errMsg, int sizeOfBuf, LOGGER_LEVEL le
 	// Write error message to log file
 	if (g_Logger_ID>=0)
 	{
-		err = ::LOGGER_Write_Ext(LOG_IQLITE_CORE, g_Logger_ID, level, errMsg);
+		err = ::LOGGER_Write_Ext(LOG_IQLITE_CORE, g_Logger_ID, level, "%s", errMsg);
 		// TODO: if possible, must do the error handling here
 	}
 	else
@@ -855,6 +975,29 @@ WIFI_TEST_API int  WiFiSaveSigFile(char* fileName)
 
 	if ( (1==g_WiFiGlobalSettingParam.VSA_SAVE_CAPTURE_ON_FAILED)||(1==g_WiFiGlobalSettingParam.VSA_SAVE_CAPTURE_ALWAYS))  
 	{	  
+		if (1==g_WiFiGlobalSettingParam.VSA_SAVE_CAPTURE_ARCHIVE)
+		{
+			// Only a host copy of the capture is made here, compression and disk write run in the background
+			err = ::LP_CaptureArchiveStart(g_WiFiGlobalSettingParam.VSA_SAVE_CAPTURE_ARCHIVE_PATH, g_WiFiGlobalSettingParam.VSA_SAVE_CAPTURE_QUOTA_MB);
+			if ( ERR_OK==err )
+			{
+				err = ::LP_CaptureArchiveSave(fileName, g_WiFiDutSerialNumber, fileName);
+			}
+			if ( ERR_OK!=err )
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_ERROR, "[WiFi] LP_CaptureArchiveSave(\"%s\") return error.\n", fileName);
+			}
+			else
+			{
+				LogReturnMessage(logMessage, MAX_BUFFER_SIZE, LOGGER_INFORMATION, "[WiFi] Capture archived (\"%s\").\n", fileName);
+			}
+			return err;
+		}
+		else
+		{
+			// do nothing
+		}
+
 		// -cfy@sunnyvale, 2012/3/13-
 		char c_time[MAX_BUFFER_SIZE], c_path[MAX_BUFFER_SIZE];
 #ifdef WIN32
@@ -898,49 +1041,28 @@ WIFI_TEST_API int  WiFiSaveSigFile(char* fileName)
 	return err;
 }
 
-int  GetMultiWaveformFileName(char* perfix, char* postfix, int wifiMode, char* bandwidth, char* datarate, char* preamble, char* packetFormat11N, char* guardInterval11N, char* waveformFileName, int bufferSize)
+// Rate part of the PER_* waveform and packet number settings, from the shared rate table.
+// Unknown rates fall back to the text after the last '-'.
+static const char* GetWaveformRateKey(const char* datarate)
 {
-    int  err = ERR_OK;
-
-	char datarateString[MAX_BUFFER_SIZE] = {'\0'};
-	int  rateIndexBegin = 0, rateIndexEnd = 0;
-
-	// Find out the datarate index
-	if ( (wifiMode==WIFI_11B)||(wifiMode==WIFI_11AG) )
+	const WIFI_RATE_DESCRIPTOR *rate = WiFiRate_FindByName(datarate);
+	if ( NULL!=rate )
 	{
-		if ((strcmp(bandwidth,"HALF")==0) || (strcmp(bandwidth,"QUAR")==0)) {
-			// 11p 
-			// do nothing
-		} else {
-			for (int i=0;i<MAX_BUFFER_SIZE;i++)
-			{
-				if (datarate[i] == '-')
-				{
-					rateIndexBegin = i+1;
-				}
-				else if (datarate[i] == '\0')
-				{
-					rateIndexEnd = i;
-					break;
-				}
-				else
-				{	
-					// do nothing, keep searching...
-				}
-			}
-			// Copy the datarate 
-			int rateIndex = 0;
-			for (int i=rateIndexBegin;i<=rateIndexEnd;i++)
-			{
-				datarateString[rateIndex] = datarate[i];
-				rateIndex++;
-			}
-		}
+		return rate->waveformKey;
 	}
-	else	// WIFI_11N_HT20 or WIFI_11N_HT40
+	else
 	{
-		// do nothing
+		const char *rateBegin = strrchr(datarate, '-');
+		return (NULL==rateBegin) ? datarate : rateBegin+1;
 	}
+}
+
+int  GetMultiWaveformFileName(char* perfix, char* postfix, int wifiMode, char* bandwidth, char* datarate, char* preamble, char* packetFormat11N, char* guardInterval11N, char* waveformFileName, int bufferSize)
+{
+    int  err = ERR_OK;
+
+	// Find out the datarate keyword, e.g. "54" for OFDM-54 or "HALF-3" for 11p (not used by 802.11n)
+	const char *datarateString = GetWaveformRateKey(datarate);
 
 	// Find out the keyword of the waveform file name
 	if (wifiMode==WIFI_11B)
@@ -1005,47 +1127,12 @@ WIFI_TEST_API int  GetWaveformFileName(char* perfix, char* postfix, int wifiMode
 {
     int  err = ERR_OK;
 
-	char keyword[MAX_BUFFER_SIZE] = {'\0'}, datarateString[MAX_BUFFER_SIZE] = {'\0'};
-	int  rateIndexBegin = 0, rateIndexEnd = 0;
+	char keyword[MAX_BUFFER_SIZE] = {'\0'};
 
 	map<string, WIFI_SETTING_STRUCT>::iterator inputMap_Iter;
 
-	// Find out the datarate index
-	if ( (wifiMode==WIFI_11B)||(wifiMode==WIFI_11AG) )
-	{
-		if ((strcmp(bandwidth,"HALF")==0) || (strcmp(bandwidth,"QUAR")==0)) {
-			// 11p 
-			// do nothing
-		} else {
-			for (int i=0;i<MAX_BUFFER_SIZE;i++)
-			{
-				if (datarate[i] == '-')
-				{
-					rateIndexBegin = i+1;
-				}
-				else if (datarate[i] == '\0')
-				{
-					rateIndexEnd = i;
-					break;
-				}
-				else
-				{	
-					// do nothing, keep searching...
-				}
-			}
-			// Copy the datarate 
-			int rateIndex = 0;
-			for (int i=rateIndexBegin;i<=rateIndexEnd;i++)
-			{
-				datarateString[rateIndex] = datarate[i];
-				rateIndex++;
-			}
-		}
-	}
-	else	// WIFI_11N_HT20 or WIFI_11N_HT40
-	{
-		// do nothing
-	}
+	// Find out the datarate keyword, e.g. "54" for OFDM-54 or "HALF-3" for 11p (not used by 802.11n)
+	const char *datarateString = GetWaveformRateKey(datarate);
 
 	// Find out the keyword of the waveform file name
 	if (wifiMode==WIFI_11B)
@@ -1188,47 +1275,12 @@ WIFI_TEST_API int  GetPacketNumber(int wifiMode, char* bandwidth, char* datarate
 {
     int  err = ERR_OK;
 
-	char keyword[MAX_BUFFER_SIZE] = {'\0'}, datarateString[MAX_BUFFER_SIZE] = {'\0'};
-	int  rateIndexBegin = 0, rateIndexEnd = 0;
+	char keyword[MAX_BUFFER_SIZE] = {'\0'};
 
 	map<string, WIFI_SETTING_STRUCT>::iterator inputMap_Iter;
 
-	// Find out the datarate index
-	if ( (wifiMode==WIFI_11B)||(wifiMode==WIFI_11AG) )
-	{
-		if ((strcmp(bandwidth,"HALF")==0) || (strcmp(bandwidth,"QUAR")==0)) {
-			// 11p 
-			// do nothing
-		} else {
-			for (int i=0;i<MAX_BUFFER_SIZE;i++)
-			{
-				if (datarate[i] == '-')
-				{
-					rateIndexBegin = i+1;
-				}
-				else if (datarate[i] == '\0')
-				{
-					rateIndexEnd = i;
-					break;
-				}
-				else
-				{	
-					// do nothing, keep searching...
-				}
-			}
-			// Copy the datarate 
-			int rateIndex = 0;
-			for (int i=rateIndexBegin;i<=rateIndexEnd;i++)
-			{
-				datarateString[rateIndex] = datarate[i];
-				rateIndex++;
-			}
-		}
-	}
-	else	// WIFI_11N_HT20 or WIFI_11N_HT40
-	{
-		// do nothing
-	}
+	// Find out the datarate keyword, e.g. "54" for OFDM-54 or "HALF-3" for 11p (not used by 802.11n)
+	const char *datarateString = GetWaveformRateKey(datarate);
 
 	// Find out the keyword of the waveform file name
 	if (wifiMode==WIFI_11B)
@@ -1771,13 +1823,13 @@ WIFI_TEST_API int QuickCaptureRetry(double centerFreqMHz, double samplingTimeUS,
 		/*--------------*
 		 *  Capture OK  *
 		 *--------------*/
-		//if (1==g_WiFiGlobalSettingParam.VSA_SAVE_CAPTURE_ALWAYS)
+		if (1==g_WiFiGlobalSettingParam.VSA_SAVE_CAPTURE_ALWAYS)
 		{
 			// TODO: must give a warning that VSA_SAVE_CAPTURE_ALWAYS is ON
 			sprintf_s(sigFileNameBuffer, MAX_BUFFER_SIZE, "%s_%.1f", "WiFi_Quick_Power", centerFreqMHz);
 			WiFiSaveSigFile(sigFileNameBuffer);
 		}
-		//else
+		else
 		{
 			// do nothing
 		}
@@ -1974,3 +2026,54 @@ WIFI_TEST_API int QuickCapturePower(double centerFreqMHz, double samplingTimeUS,
 	return err;
 	
 }
+
+// Key of the signal in the VSA reference level model, the frequency is added by LP_RefLevelPredict()
+WIFI_TEST_API void WiFiRefLevelKey(char *refLevelKey, char *dataRate, char *bandwidth, int tx1, int tx2, int tx3, int tx4)
+{
+	sprintf_s(refLevelKey, MAX_BUFFER_SIZE, "%s_%s_TX%d%d%d%d", dataRate, bandwidth, tx1, tx2, tx3, tx4);
+}
+
+// VSA amplitude learned from the previous captures of the signal, expectedPowerDbm if not learned yet or VSA_REF_LEVEL_LEARN=0
+WIFI_TEST_API double WiFiRefLevelPredict(int freqMHz, char *refLevelKey, double expectedPowerDbm)
+{
+	if (1==g_WiFiGlobalSettingParam.VSA_REF_LEVEL_LEARN)
+	{
+		return ::LP_RefLevelPredict(freqMHz, refLevelKey, expectedPowerDbm);
+	}
+	else
+	{
+		return expectedPowerDbm;
+	}
+}
+
+WIFI_TEST_API void WiFiRefLevelLearn(int freqMHz, char *refLevelKey, double avgPowerDbm, double peakPowerDbm, double vsaAmplitudeDbm, char *errorMsg)
+{
+	if (1==g_WiFiGlobalSettingParam.VSA_REF_LEVEL_LEARN)
+	{
+		if ( ERR_CAPTURE_FAILED==::LP_RefLevelLearn(freqMHz, refLevelKey, avgPowerDbm, peakPowerDbm, vsaAmplitudeDbm) )
+		{
+			LogReturnMessage(errorMsg, MAX_BUFFER_SIZE, LOGGER_WARNING, "[WiFi] Capture of %s at %d MHz clipped (P_peak_all_dBm = %.1f dBm, VSA amplitude = %.1f dBm), the learned reference level is dropped.\n", refLevelKey, freqMHz, peakPowerDbm, vsaAmplitudeDbm);
+		}
+		else
+		{
+			// do nothing
+		}
+	}
+	else
+	{
+		// do nothing
+	}
+}
+
+// Called when the capture did not trigger, the next capture of the signal uses TX_POWER_DBM again
+WIFI_TEST_API void WiFiRefLevelForget(int freqMHz, char *refLevelKey)
+{
+	if (1==g_WiFiGlobalSettingParam.VSA_REF_LEVEL_LEARN)
+	{
+		::LP_RefLevelForget(freqMHz, refLevelKey);
+	}
+	else
+	{
+		// do nothing
+	}
+}
@@ -996,6 +996,12 @@ typedef struct tagGlobalSettingParam
 	int	   DUT_TX_SETTLE_TIME_MS;					/*!< A delay time for DUT (TX) settle, Default = 0(ms). */
 	int	   DUT_RX_SETTLE_TIME_MS;					/*!< A delay time for DUT (RX) settle, Default = 0(ms). */
 
+	// Configure the DUT for the next TX item while the current one analyzes, default off.
+	int	   DUT_LOOK_AHEAD;							/*!< A flag that to let Dut be configured for the next TX item during the analysis, requires DUT_KEEP_TRANSMIT=1, 0: OFF, 1: ON, Default=OFF */
+
+	// Stage EEPROM writes in vDUT until FINALIZE_EEPROM, default off.
+	int	   EEPROM_WRITE_BACK_CACHE;					/*!< A flag that to let vDUT stage WRITE_EEPROM and write them at FINALIZE_EEPROM with one commit, 0: OFF, 1: ON, Default=OFF */
+
 	// For IQ2010Ext Only
 	int    VSA_SKIP_PACKET_COUNT;                   /*!< [IQ2010EXT ONLY] Skip packet count before capture. Default=100*/
 	double VSA_ACK_POWER_RMS_DBM;                   /*!< [IQ2010EXT ONLY] The DUT ACK RMS Power at the tester VSA port. Default=10*/
@@ -1009,6 +1015,10 @@ typedef struct tagGlobalSettingParam
 	int    VSA_TRIGGER_TIMEOUT_SEC;				    /*!< IQTester VSA signal trigger timeout(sec) setting used for signal capture. */
 	int    VSA_SAVE_CAPTURE_ON_FAILED;				/*!< A flag that to save "sig" file when capture failed, 0: OFF, 1: ON, Default=1 */
 	int    VSA_SAVE_CAPTURE_ALWAYS;				    /*!< A flag that to save "sig" file, always, 0: OFF, 1: ON, Default=OFF */
+	int    VSA_SAVE_CAPTURE_ARCHIVE;				/*!< A flag to save captures through the background capture archive instead of LP_SaveVsaSignalFile(), 0: OFF, 1: ON, Default=OFF */
+	char   VSA_SAVE_CAPTURE_ARCHIVE_PATH[MAX_BUFFER_SIZE];	/*!< Directory of the capture archive. Default=./log/capture_archive */
+	int    VSA_SAVE_CAPTURE_QUOTA_MB;				/*!< Disk quota of the capture archive, the oldest captures are deleted above it; 0: no quota. Default=1024 */
+	int    VSA_REF_LEVEL_LEARN;						/*!< A flag to set the VSA amplitude from the power measured in the previous captures of the same signal, 0: OFF, 1: ON, Default=OFF */
 	int    VSA_PORT;                                /*!< IQTester VSA port setting. Default=PORT_LEFT*/
     int    VSG_PORT;                                /*!< IQTester VSG port setting. Default=PORT_LEFT*/
     double VSG_MAX_POWER_11B;						/*!< Max output power of VSG for 11B signal */
@@ -1067,6 +1077,13 @@ typedef struct tagGlobalSettingParam
     // EVM measurement related parameters
     int    EVM_AVERAGE;
     int    EVM_AVERAGE_PERCENT;
+    int    EVM_MULTI_PACKET;                    /*!< A flag to take the EVM_AVERAGE packets from one long capture instead of one capture each, 0: OFF, 1: ON, Default=OFF */
+    int    EVM_MULTI_PACKET_GAP_US;             /*!< Inter-packet gap (us) of the DUT traffic, added per packet to the multi-packet capture. Default=100 */
+
+    // Early exit of EVM_AVERAGE/PM_AVERAGE, for the items given a limit
+    int    AVERAGE_EARLY_EXIT;                  /*!< A flag to stop averaging once the confidence interval of the mean is beyond the limit, 0: OFF, 1: ON, Default=OFF */
+    double AVERAGE_CONFIDENCE_LEVEL;            /*!< Two-sided Student-t confidence level of the mean, 95, 99 or 99.9 (%). Default=99 */
+    int    AVERAGE_MIN_SAMPLES;                 /*!< Samples averaged at least before an early exit, at least 2. Default=3 */
     int    EVM_SYMBOL_NUM;
 
 	// Change to the same name of MIMO and MPS file.
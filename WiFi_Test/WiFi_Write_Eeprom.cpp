@@ -155,6 +155,7 @@ WIFI_TEST_API int WiFi_Write_Eeprom(void)
 		}
 #pragma endregion
 
+		::vDUT_EnableEepromCache(g_WiFi_Dut, g_WiFiGlobalSettingParam.EEPROM_WRITE_BACK_CACHE);
 		err = vDUT_Run(g_WiFi_Dut, "WRITE_EEPROM");		
 		if ( ERR_OK!=err )
 		{	// Check vDut return "ERROR_MESSAGE" or not, if "Yes", must handle it.
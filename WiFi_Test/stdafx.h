@@ -123,6 +123,7 @@ extern int              g_WiFi_Test_timer;
 extern int				g_Tester_Type;
 extern int				g_Tester_Number;
 extern int				g_Tester_Reconnect;
+extern char				g_WiFiDutSerialNumber[MAX_BUFFER_SIZE];	// Last serial number returned by GET_SERIAL_NUMBER, for the capture archive index
 extern double			g_last_TxPower_dBm_Record; // Record the Tx power used in last test item. // -cfy@sunnyvale, 2012/3/13-
 
 extern WIFI_RECORD_PARAM g_RecordedParam;
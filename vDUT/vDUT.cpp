@@ -12,6 +12,7 @@
 //#include "lp_string.h"
 //#include "lp_stdio.h"
 #include "Version.h"
+#include "WiFi_RateTable.h"
 
 #ifdef _MANAGED
 #pragma managed(push, off)
@@ -89,10 +90,6 @@ typedef pair<string , double> doubleReturnPair;
 map <string, string> stringReturns[MAX_TECHNOLOGIES_COUNT];
 typedef pair<string , string> stringReturnPair;
 
-map <int, int> wifiChannels;
-map <string, vDUT_DATA_RATE> wifiDataRates;
-map <string, double> wifiDataRatesMbps;
-
 map <string, vector<double> > g_arrayDoubleReturns[MAX_TECHNOLOGIES_COUNT];
 typedef pair<string , vector<double> > arrayDoubleReturnPair;
 map <string, vector<double> >::iterator g_arrayDoubleReturn_Iter[MAX_TECHNOLOGIES_COUNT];
@@ -192,8 +189,6 @@ vDUT_API char* vDUT_GetErrorString(vDUT_RETURN errorNum)
 void Free_vDut_Memory()
 {
 	technologies.clear();
-	wifiChannels.clear();
-	wifiDataRates.clear();
 
 	for (int i=0;i<MAX_TECHNOLOGIES_COUNT;i++)
 	{
@@ -218,6 +213,7 @@ void Free_vDut_Memory()
  *      - READ_MAC_ADDRESS
  *      - READ_EEPROM
  *      - WRITE_EEPROM
+ *      - WRITE_EEPROM_BATCH
  *      - RF_SET_FREQ
  *      - TX_PRE_TX
  *      - TX_SET_BAND
@@ -280,6 +276,7 @@ int Initialize_vDUT()
     dutFunctions[dfIndex].insert( functionPair("WRITE_EEPROM",        callBack) );
 
     dutFunctions[dfIndex].insert( functionPair("FINALIZE_EEPROM",     callBack) );
+    dutFunctions[dfIndex].insert( functionPair("WRITE_EEPROM_BATCH",  callBack) );
     dutFunctions[dfIndex].insert( functionPair("DUMP_EEPROM",		  callBack) );
 
 
@@ -406,6 +403,7 @@ int Initialize_vDUT()
     dutFunctions[dfIndex].insert( functionPair("WRITE_EEPROM",        callBack) );
 
     dutFunctions[dfIndex].insert( functionPair("FINALIZE_EEPROM",     callBack) );
+    dutFunctions[dfIndex].insert( functionPair("WRITE_EEPROM_BATCH",  callBack) );
     dutFunctions[dfIndex].insert( functionPair("DUMP_EEPROM",		  callBack) );
 
 
@@ -523,6 +521,7 @@ int Initialize_vDUT()
     dutFunctions[dfIndex].insert( functionPair("WRITE_EEPROM",        callBack) );
 
     dutFunctions[dfIndex].insert( functionPair("FINALIZE_EEPROM",     callBack) );
+    dutFunctions[dfIndex].insert( functionPair("WRITE_EEPROM_BATCH",  callBack) );
     dutFunctions[dfIndex].insert( functionPair("DUMP_EEPROM",		  callBack) );
 
 
@@ -756,6 +755,7 @@ int Initialize_vDUT()
 	dutFunctions[dfIndex].insert( functionPair("RX_GET_MEASUREMENTS",      callBack) );
     dutFunctions[dfIndex].insert( functionPair("RX_GET_CLOCK",        callBack) );
 	dutFunctions[dfIndex].insert( functionPair("RX_GET_POSITION",      callBack) );
+	dutFunctions[dfIndex].insert( functionPair("RX_WAIT_LOCK",         callBack) );
 	dutFunctions[dfIndex].insert( functionPair("FUNCTION_FAILED",      callBack) );
 	// [Jarir Fadlullah] End: Added GPS functions for Brcm 2076 GPS
 	//////////////////////////////////////////////////////////////////
@@ -804,244 +804,7 @@ int Initialize_vDUT()
         exit(1);
     }
 
-    // Initialize the WiFi Frequency-Channel map, The formula for converting between freq in MHz is cneter freq(MHz)=5000+5xN, N=0,1,2...199
-	wifiChannels.clear();
-	wifiChannels.insert( pair<int,int>( 2412, 1   ));
-	wifiChannels.insert( pair<int,int>( 2417, 2   ));
-	wifiChannels.insert( pair<int,int>( 2422, 3   ));
-	wifiChannels.insert( pair<int,int>( 2427, 4   ));
-	wifiChannels.insert( pair<int,int>( 2432, 5   ));
-	wifiChannels.insert( pair<int,int>( 2437, 6   ));
-	wifiChannels.insert( pair<int,int>( 2442, 7   ));
-	wifiChannels.insert( pair<int,int>( 2447, 8   ));
-	wifiChannels.insert( pair<int,int>( 2452, 9   ));
-	wifiChannels.insert( pair<int,int>( 2457, 10  ));
-	wifiChannels.insert( pair<int,int>( 2462, 11  ));
-	wifiChannels.insert( pair<int,int>( 2467, 12  ));
-	wifiChannels.insert( pair<int,int>( 2472, 13  ));
-	wifiChannels.insert( pair<int,int>( 2484, 14  ));
-	wifiChannels.insert( pair<int,int>( 4920, 184 ));
-	wifiChannels.insert( pair<int,int>( 4940, 188 ));
-	wifiChannels.insert( pair<int,int>( 4960, 192 ));
-	wifiChannels.insert( pair<int,int>( 4980, 196 ));
-	wifiChannels.insert( pair<int,int>( 5040, 8   ));
-	wifiChannels.insert( pair<int,int>( 5060, 12  ));
-	wifiChannels.insert( pair<int,int>( 5080, 16  ));
-	wifiChannels.insert( pair<int,int>( 5170, 34  ));
-	wifiChannels.insert( pair<int,int>( 5180, 36  ));
-	wifiChannels.insert( pair<int,int>( 5190, 38  ));
-	wifiChannels.insert( pair<int,int>( 5200, 40  ));
-	wifiChannels.insert( pair<int,int>( 5210, 42  ));
-	wifiChannels.insert( pair<int,int>( 5220, 44  ));
-	wifiChannels.insert( pair<int,int>( 5230, 46  ));
-	wifiChannels.insert( pair<int,int>( 5240, 48  ));
-	wifiChannels.insert( pair<int,int>( 5250, 50  )); /// Add this channel number, for Brcm_43562, non BW_20_MHz channel. 
-	wifiChannels.insert( pair<int,int>( 5260, 52  ));
-    wifiChannels.insert( pair<int,int>( 5270, 54  ));
-	wifiChannels.insert( pair<int,int>( 5280, 56  ));
-	wifiChannels.insert( pair<int,int>( 5290, 58  ));  //11ac channel
-	wifiChannels.insert( pair<int,int>( 5300, 60  ));
-    wifiChannels.insert( pair<int,int>( 5310, 62  ));
-	wifiChannels.insert( pair<int,int>( 5320, 64  ));
-	wifiChannels.insert( pair<int,int>( 5330, 66  )); /// Add this channel number, for Brcm_43562, non BW_20_MHz channel. 
-	wifiChannels.insert( pair<int,int>( 5400, 80  ));  //Add this channel number, which is not defined in 11a spec, for Atheros calibration. 
-	wifiChannels.insert( pair<int,int>( 5500, 100 ));
-    wifiChannels.insert( pair<int,int>( 5510, 102 ));
-	wifiChannels.insert( pair<int,int>( 5520, 104 ));
-	wifiChannels.insert( pair<int,int>( 5530, 106 )); //11ac channel
-	wifiChannels.insert( pair<int,int>( 5540, 108 ));
-    wifiChannels.insert( pair<int,int>( 5550, 110 ));
-	wifiChannels.insert( pair<int,int>( 5560, 112 ));
-	wifiChannels.insert( pair<int,int>( 5570, 114 )); /// Add this channel number, for Brcm_43562, non BW_20_MHz channel. 
-	wifiChannels.insert( pair<int,int>( 5580, 116 ));
-    wifiChannels.insert( pair<int,int>( 5590, 118 ));
-	wifiChannels.insert( pair<int,int>( 5600, 120 ));
-	wifiChannels.insert( pair<int,int>( 5610, 122 )); //11ac channel
-	wifiChannels.insert( pair<int,int>( 5620, 124 ));
-    wifiChannels.insert( pair<int,int>( 5630, 126 ));
-	wifiChannels.insert( pair<int,int>( 5640, 128 ));
-	wifiChannels.insert( pair<int,int>( 5660, 132 ));
-    wifiChannels.insert( pair<int,int>( 5670, 134 ));
-	wifiChannels.insert( pair<int,int>( 5680, 136 ));
-	wifiChannels.insert( pair<int,int>( 5690, 138 )); //11ac channel
-	wifiChannels.insert( pair<int,int>( 5700, 140 ));
-	wifiChannels.insert( pair<int,int>( 5710, 142 ));
-	wifiChannels.insert( pair<int,int>( 5720, 144 ));  //Add this channel number, which is not defined in 11a spec, for Atheros calibration. 
-	wifiChannels.insert( pair<int,int>( 5745, 149 ));
-	wifiChannels.insert( pair<int,int>( 5755, 151 ));
-    wifiChannels.insert( pair<int,int>( 5765, 153 ));
-	wifiChannels.insert( pair<int,int>( 5775, 155 )); //11ac channel
-	wifiChannels.insert( pair<int,int>( 5785, 157 ));
-    wifiChannels.insert( pair<int,int>( 5795, 159 ));
-	wifiChannels.insert( pair<int,int>( 5805, 161 ));
-	wifiChannels.insert( pair<int,int>( 5815, 163  )); /// Add this channel number, for Brcm_43562, non BW_20_MHz channel. 
-	wifiChannels.insert( pair<int,int>( 5820, 164 ));  //Add this channel number, which is not defined in 11a spec, for Atheros calibration. 
-	wifiChannels.insert( pair<int,int>( 5825, 165 ));
-	wifiChannels.insert( pair<int,int>( 5845, 169 ));
-	wifiChannels.insert( pair<int,int>( 5865, 173 ));
-	wifiChannels.insert( pair<int,int>( 5885, 177 ));
-	wifiChannels.insert( pair<int,int>( 5905, 181 ));
-	wifiChannels.insert( pair<int,int>( 5925, 185 ));
-	wifiChannels.insert( pair<int,int>( 5945, 189 ));
-
-	// Initializes the WiFi data rate index map
-	wifiDataRates.clear();
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "DSSS-1",  DSSS1 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "DSSS-2",  DSSS2 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "CCK-5_5", CCK5_5));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "CCK-11",  CCK11 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "PBCC-22", PBCC22 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "OFDM-6",  OFDM6 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "OFDM-9",  OFDM9 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "OFDM-12", OFDM12 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "OFDM-18", OFDM18 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "OFDM-24", OFDM24 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "OFDM-36", OFDM36 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "OFDM-48", OFDM48 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "OFDM-54", OFDM54 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS0",    MCS0 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS1",    MCS1 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS2",    MCS2 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS3",    MCS3 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS4",    MCS4 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS5",    MCS5 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS6",    MCS6 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS7",    MCS7 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS8",    MCS8 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS9",    MCS9 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS10",   MCS10 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS11",   MCS11 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS12",   MCS12 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS13",   MCS13 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS14",   MCS14 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS15",   MCS15 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS16",   MCS16 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS17",   MCS17 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS18",   MCS18 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS19",   MCS19 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS20",   MCS20 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS21",   MCS21 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS22",   MCS22 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS23",   MCS23 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS24",   MCS24 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS25",   MCS25 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS26",   MCS26 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS27",   MCS27 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS28",   MCS28 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS29",   MCS29 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS30",   MCS30 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "MCS31",   MCS31 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "1DH1",   BT_1DH1 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "1DH3",   BT_1DH3 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "1DH5",   BT_1DH5 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "2DH1",   BT_2DH1 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "2DH3",   BT_2DH3 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "2DH5",   BT_2DH5 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "3DH1",   BT_3DH1 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "3DH3",   BT_3DH3 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "3DH5",   BT_3DH5 ));
-    wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "1LE",   BT_1LE ));
-	wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "HALF-3",	HALF3 ));
-	wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "HALF-4_5",	HALF4_5 ));
-	wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "HALF-6",	HALF6 ));
-	wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "HALF-9",	HALF9 ));
-	wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "HALF-12",	HALF12 ));
-	wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "HALF-18",	HALF18 ));
-	wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "HALF-24",	HALF24 ));
-	wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "HALF-27",	HALF27 ));
-	wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "QUAR-1_5",	QUAR1_5 ));
-	wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "QUAR-2_25",QUAR2_25 ));
-	wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "QUAR-3",	QUAR3 ));
-	wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "QUAR-4_5",	QUAR4_5 ));
-	wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "QUAR-6",	QUAR6 ));
-	wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "QUAR-9",	QUAR9 ));
-	wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "QUAR-12",	QUAR12 ));
-	wifiDataRates.insert( pair<string, vDUT_DATA_RATE>( "QUAR-13_5",QUAR13_5 ));
-
-    // Initializes the WiFi data rate Mbps map
-    wifiDataRatesMbps.clear();
-    wifiDataRatesMbps.insert( pair<string, double>( "DSSS-1",   1 ));
-    wifiDataRatesMbps.insert( pair<string, double>( "DSSS-2",   2 ));
-    wifiDataRatesMbps.insert( pair<string, double>( "CCK-5_5",  5.5 ));
-    wifiDataRatesMbps.insert( pair<string, double>( "CCK-11",   11 ));
-    wifiDataRatesMbps.insert( pair<string, double>( "PBCC-22",  22 ));
-    wifiDataRatesMbps.insert( pair<string, double>( "OFDM-6",   6 ));
-    wifiDataRatesMbps.insert( pair<string, double>( "OFDM-9",   9 ));
-    wifiDataRatesMbps.insert( pair<string, double>( "OFDM-12",  12 ));
-    wifiDataRatesMbps.insert( pair<string, double>( "OFDM-18",  18 ));
-    wifiDataRatesMbps.insert( pair<string, double>( "OFDM-24",  24 ));
-    wifiDataRatesMbps.insert( pair<string, double>( "OFDM-36",  36 ));
-    wifiDataRatesMbps.insert( pair<string, double>( "OFDM-48",  48 ));
-    wifiDataRatesMbps.insert( pair<string, double>( "OFDM-54",  54 ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS0_HT20",    6.5     ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS1_HT20",    13      ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS2_HT20",    19.5    ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS3_HT20",    26      ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS4_HT20",    39      ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS5_HT20",    52      ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS6_HT20",    58.5    ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS7_HT20",    65      ));
-
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS0_HT40",    13.5    ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS1_HT40",    27      ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS2_HT40",    40.5    ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS3_HT40",    54      ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS4_HT40",    81      ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS5_HT40",    108     ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS6_HT40",    121.5   ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS7_HT40",    135     ));
-
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS8_HT20",    13      ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS9_HT20",    26      ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS10_HT20",   39      ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS11_HT20",   52      ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS12_HT20",   78      ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS13_HT20",   104     ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS14_HT20",   117     ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS15_HT20",   130     ));
-
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS8_HT40",    27      ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS9_HT40",    54      ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS10_HT40",   81      ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS11_HT40",   108     ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS12_HT40",   162     ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS13_HT40",   216     ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS14_HT40",   243     ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS15_HT40",   270     ));
-
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS16_HT20",    19.5     ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS17_HT20",    39      ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS18_HT20",    58.5    ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS19_HT20",    78      ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS20_HT20",    117      ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS21_HT20",    156      ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS22_HT20",    175.5    ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS23_HT20",    195      ));
-
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS16_HT40",    40.5    ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS17_HT40",    81      ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS18_HT40",    121.5    ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS19_HT40",    162      ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS20_HT40",    243      ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS21_HT40",    324     ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS22_HT40",    364.5   ));
-    wifiDataRatesMbps.insert( pair<string, double>( "MCS23_HT40",    405     ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HALF-3",	3 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HALF-4_5",	4.5 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HALF-6",	6 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HALF-9",	9 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HALF-12",	12 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HALF-18",	18 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HALF-24",	24 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "HALF-27",	27 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "QUAR-1_5",	1.5 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "QUAR-2_25",2.25 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "QUAR-3",	3 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "QUAR-4_5",	4.5 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "QUAR-6",	6 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "QUAR-9",	9 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "QUAR-12",	12 ));
-	wifiDataRatesMbps.insert( pair<string, double>( "QUAR-13_5",13.5 ));
+    // The WiFi channel and data rate tables are static, see WiFi_RateTable.h
 
     return 0;												 
 }
@@ -1603,6 +1366,16 @@ vDUT_API vDUT_RETURN vDUT_ByPassDutControl(int vDutControlFlag)
 
 
 
+// Implemented in vDUT_EepromCache.cpp
+bool EepromCache_Run(vDUT_ID dutID, const char *functionName, vDUT_RETURN *ret);
+vDUT_RETURN RunDutFunction(vDUT_ID dutID, const vDUT_STR functionName, double *durationInMiniSec);
+
+bool DutFunctionInstalled(vDUT_ID dutID, const char *functionName)
+{
+    map <string, vDUT_CALLBACK>::iterator function_Iter = dutFunctions[dutID].find( functionName );
+    return ( function_Iter!=dutFunctions[dutID].end() && NULL!=function_Iter->second.pointerToFunction );
+}
+
 vDUT_API vDUT_RETURN vDUT_Run(vDUT_ID dutID, const vDUT_STR functionName)
 {
     vDUT_RETURN ret = vDUT_ERR_OK;
@@ -1611,6 +1384,10 @@ vDUT_API vDUT_RETURN vDUT_Run(vDUT_ID dutID, const vDUT_STR functionName)
 	{
 		return ret;
 	}
+	else if ( dutID>-1 && dutID<MAX_TECHNOLOGIES_COUNT && EepromCache_Run(dutID, functionName, &ret) )
+	{
+		return ret;
+	}
 	else
 	{
 		// do nothing
@@ -1618,6 +1395,14 @@ vDUT_API vDUT_RETURN vDUT_Run(vDUT_ID dutID, const vDUT_STR functionName)
 
 	double durationInMiniSec = 0;
 
+	return RunDutFunction(dutID, functionName, &durationInMiniSec);
+}
+
+// vDUT_Run() without the EEPROM cache, *durationInMiniSec gets the time of the DUT function
+vDUT_RETURN RunDutFunction(vDUT_ID dutID, const vDUT_STR functionName, double *durationInMiniSec)
+{
+    vDUT_RETURN ret = vDUT_ERR_OK;
+
     map <string, vDUT_CALLBACK>::iterator function_Iter;
 
     if( dutID>-1 && dutID<MAX_TECHNOLOGIES_COUNT )
@@ -1645,9 +1430,9 @@ vDUT_API vDUT_RETURN vDUT_Run(vDUT_ID dutID, const vDUT_STR functionName)
                 }
 
 				// Stop Timer
-				::TIMER_StopTimer(g_vDutTimerID[dutID], functionName, &durationInMiniSec);
+				::TIMER_StopTimer(g_vDutTimerID[dutID], functionName, durationInMiniSec);
 				// Save to log
-				::LOGGER_Write_Ext(LOG_IQLITE_VDUT, g_vDutLoggerID[dutID], LOGGER_INFORMATION, "[vDut]=>[%s],%.2f,ms\n", functionName, durationInMiniSec);
+				::LOGGER_Write_Ext(LOG_IQLITE_VDUT, g_vDutLoggerID[dutID], LOGGER_INFORMATION, "[vDut]=>[%s],%.2f,ms\n", functionName, *durationInMiniSec);
             }
             else
             {
@@ -1867,16 +1652,13 @@ vDUT_API vDUT_RETURN vDUT_WiFiConvertFrequencyToChannel(int freq, int* channel)
 {
     vDUT_RETURN ret = vDUT_ERR_OK;
 
-    map <int, int>::iterator channel_Iter;
-
-    channel_Iter = wifiChannels.find(freq);
-    if( channel_Iter!=wifiChannels.end() )
+    if( !WiFiChannel_FreqToChannel(freq, channel) )
     {
-        *channel = channel_Iter->second;
+        ret = vDUT_ERR_WIFI_FREQ_DOES_NOT_EXIST;
     }
     else
     {
-        ret = vDUT_ERR_WIFI_FREQ_DOES_NOT_EXIST;
+        // do nothing
     }
 
     return ret;
@@ -1887,30 +1669,13 @@ vDUT_API vDUT_RETURN vDUT_WiFiConvertChannelToFrequency(int channel, int *freq)
 {
     vDUT_RETURN ret = vDUT_ERR_OK;
 
-    map <int, int>::iterator freq_Iter;
-
-    freq_Iter = wifiChannels.begin();
-    if( freq_Iter!=wifiChannels.end() )
+    if( !WiFiChannel_ChannelToFreq(channel, freq) )
     {
-        while( freq_Iter!=wifiChannels.end() )
-        {
-            if ( channel==freq_Iter->second )
-            {
-                *freq = freq_Iter->first;
-                ret = vDUT_ERR_OK;
-                break;
-            }
-            else
-            {                
-                // keep searching...
-                freq_Iter++;
-                ret = vDUT_ERR_WIFI_FREQ_DOES_NOT_EXIST;
-            }
-        }
+        ret = vDUT_ERR_WIFI_FREQ_DOES_NOT_EXIST;
     }
     else
     {
-        ret = vDUT_ERR_WIFI_FREQ_DOES_NOT_EXIST;
+        // do nothing
     }
     return ret;
 }
@@ -1919,12 +1684,10 @@ vDUT_API vDUT_RETURN vDUT_WiFiConvertDataRateNameToIndex(vDUT_STR name, vDUT_DAT
 {
     vDUT_RETURN ret = vDUT_ERR_OK;
 
-    map <string, vDUT_DATA_RATE>::iterator dataRate_Iter;
-
-    dataRate_Iter = wifiDataRates.find(name);
-    if( dataRate_Iter!=wifiDataRates.end() )
+    const WIFI_RATE_DESCRIPTOR *rate = WiFiRate_FindByName(name);
+    if( NULL!=rate )
     {
-        *index = dataRate_Iter->second;
+        *index = (vDUT_DATA_RATE)rate->index;
     }
     else
     {
@@ -2049,16 +1812,13 @@ vDUT_API vDUT_RETURN vDUT_WiFiConvertDataRateNameToMbps(vDUT_STR name, double* d
 {
     vDUT_RETURN ret = vDUT_ERR_OK;
 
-    map <string, double>::iterator dataRateMbps_Iter;
-
-    dataRateMbps_Iter = wifiDataRatesMbps.find(name);
-    if( dataRateMbps_Iter!=wifiDataRatesMbps.end() )
+    if( !WiFiRate_GetMbps(name, dataRateMbps) )
     {
-        *dataRateMbps = dataRateMbps_Iter->second;
+        ret = vDUT_ERR_PARAM_DOES_NOT_EXIST;
     }
     else
     {
-        ret = vDUT_ERR_PARAM_DOES_NOT_EXIST;
+        // do nothing
     }
 
     return ret;
@@ -2069,7 +1829,6 @@ vDUT_API vDUT_RETURN vDUT_WiFiConvertPacketLengthUsToNumberOfBytes(int packetLen
     vDUT_RETURN     ret = vDUT_ERR_OK;
     double          dataRateMbps = 0;
     vDUT_DATA_RATE  dataRateIndex = OFDM54;
-    char            dataRateString[MAX_BUFFER_SIZE] = {0};
     const int       minMpduInBits = 34*8; //By running some testing looks like there is 28 Bytes in Broadcom CRC ????   34*8     //There are at least 34 bytes data in MPDU for 802.11 frame
     const int       longPreambleLengthUs = 192; 
     const int       shortPreambleLengthUs = 96; 
@@ -2077,22 +1836,28 @@ vDUT_API vDUT_RETURN vDUT_WiFiConvertPacketLengthUsToNumberOfBytes(int packetLen
     const int       dsss1MinLengthUs = 420;
     const int       dsss2MinLengthUs = 310;
     
-    ret = vDUT_WiFiConvertDataRateNameToIndex(dataRate, &dataRateIndex);
-    if (ret == vDUT_ERR_OK)
+    const WIFI_RATE_DESCRIPTOR *rate = WiFiRate_FindByName(dataRate);
+    if (NULL != rate)
     {
+        dataRateIndex = (vDUT_DATA_RATE)rate->index;
         if (dataRateIndex <= OFDM54)
         {
-            sprintf_s(dataRateString, "%s", dataRate);
+            dataRateMbps = rate->mbps;
+        }
+        else if (WIFI_RATE_HT == rate->family && bandwidth == BANDWIDTH_MODE_HT20)
+        {
+            dataRateMbps = rate->mbps;
+        }
+        else if (WIFI_RATE_HT == rate->family && bandwidth == BANDWIDTH_MODE_HT40)
+        {
+            dataRateMbps = rate->mbpsHt40;
         }
-        else if (bandwidth == BANDWIDTH_MODE_HT20)
+        else
         {
-            sprintf_s(dataRateString, "%s_HT20", dataRate);
+            dataRateMbps = 0;
         }
-        else if (bandwidth == BANDWIDTH_MODE_HT40)
-            sprintf_s(dataRateString, "%s_HT40", dataRate);
 
-        ret = vDUT_WiFiConvertDataRateNameToMbps(dataRateString, &dataRateMbps);
-        if(ret == vDUT_ERR_OK)
+        if (dataRateMbps > 0)
         {
             if (dataRateIndex <= CCK11)
             {
@@ -446,6 +446,25 @@ vDUT_API vDUT_RETURN vDUT_InstallCallbackFunction(vDUT_ID dutID, const vDUT_STR
  */
 vDUT_API vDUT_RETURN vDUT_Run(vDUT_ID dutID, const vDUT_STR functionName);
 
+//! Enable or disable the write-back cache of the DUT EEPROM
+/*!
+ * \param[in] dutID The registered DUT ID by vDUT_RegisterTechnology()
+ * \param[in] enable 1 to stage WRITE_EEPROM until FINALIZE_EEPROM, 0 to run every WRITE_EEPROM on the DUT
+ *
+ * \return vDUT_ERR_OK if the cache has been enabled or disabled
+ * \return vDUT_ERR_INVALID_DUT_ID The specified DUT ID is invalid
+ * \return vDUT_ERR_DUT_FUNCTION_ERROR Disabling the cache failed to write the staged entries
+ *
+ * \remark With the cache enabled, vDUT_Run() keeps WRITE_EEPROM by ADDRESS and answers READ_EEPROM of a kept ADDRESS.
+ *         FINALIZE_EEPROM writes the kept entries in one WRITE_EEPROM_BATCH call (ENTRIES "ADDRESS=VALUE\n...", COUNT)
+ *         if the DUT installs it, or one WRITE_EEPROM per ADDRESS, commits once and reads the entries back.
+ *         It adds the integer returns EEPROM_STAGED_WRITES, EEPROM_DUT_WRITES, EEPROM_DUT_WRITES_SAVED, EEPROM_CHECKSUM
+ *         and the double return EEPROM_FLUSH_TIME (sec, measured).  Commits are saved only if the DUT commits in
+ *         FINALIZE_EEPROM and not in WRITE_EEPROM.
+ *         Disabling the cache writes the kept entries, without a commit.
+ */
+vDUT_API vDUT_RETURN vDUT_EnableEepromCache(vDUT_ID dutID, int enable);
+
 //! Clear all parameter containers
 /*!
  * \param[in] dutID The registered DUT ID by vDUT_RegisterTechnology()
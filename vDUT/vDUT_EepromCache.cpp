@@ -0,0 +1,463 @@
+// vDUT_EepromCache.cpp : Write-back cache of the DUT EEPROM/NVRAM, see vDUT_EnableEepromCache()
+//
+// Each WRITE_EEPROM of the DUT control DLL is a flash erase/write, and often a commit, on the DUT.  With the
+// cache enabled, vDUT_Run() stages WRITE_EEPROM instead: a later write of the same ADDRESS replaces the
+// staged value, and READ_EEPROM of a staged or already read ADDRESS is answered from the cache.
+// FINALIZE_EEPROM writes the dirty entries in one WRITE_EEPROM_BATCH call (one WRITE_EEPROM per entry if the
+// DUT does not install it), runs the FINALIZE_EEPROM of the DUT once, and reads the entries back to compare
+// checksums.  FINALIZE_EEPROM returns and logs the DUT writes it did not run and the measured time of the ones
+// it did; the commits saved depend on whether the DUT commits in WRITE_EEPROM and are not estimated here.
+
+#include "stdafx.h"
+#include "vDUT.h"
+#include "IQlite_Logger.h"
+#include <ctype.h>
+#include <string>
+#include <map>
+
+using namespace std;
+
+#define EEPROM_CACHE_ENTRY_SEPARATOR	"\n"	// between the ADDRESS=VALUE pairs of WRITE_EEPROM_BATCH
+
+typedef struct tagEepromEntry
+{
+	string	value;
+	int		length;
+	bool	dirty;				// staged, not written to the DUT yet
+} vDUT_EEPROM_ENTRY;
+
+typedef struct tagEepromCache
+{
+	int		enabled;
+	map<string, vDUT_EEPROM_ENTRY> entries;
+	int		stagedWrites;		// WRITE_EEPROM since INSERT_DUT or the last FINALIZE_EEPROM
+	int		readHits;
+} vDUT_EEPROM_CACHE;
+
+static vDUT_EEPROM_CACHE g_eepromCache[MAX_TECHNOLOGIES_COUNT];
+
+// Implemented in vDUT.cpp
+extern vDUT_ID g_vDutLoggerID[MAX_TECHNOLOGIES_COUNT];
+vDUT_RETURN RunDutFunction(vDUT_ID dutID, const vDUT_STR functionName, double *durationInMiniSec);
+bool        DutFunctionInstalled(vDUT_ID dutID, const char *functionName);
+
+static string EepromNormalize(const string &value)
+{
+	size_t first = value.find_first_not_of(" \t\r\n");
+	size_t last  = value.find_last_not_of(" \t\r\n");
+	string normalized = (first==string::npos) ? string("") : value.substr(first, last-first+1);
+	for (size_t i=0;i<normalized.size();i++)
+	{
+		normalized[i] = (char)tolower((unsigned char)normalized[i]);
+	}
+	return normalized;
+}
+
+// CRC-32 of the ADDRESS=VALUE pairs, the values are compared the way the DUT may print them back
+static unsigned int EepromChecksum(unsigned int crc, const string &address, const string &value)
+{
+	string pair = address + "=" + EepromNormalize(value) + EEPROM_CACHE_ENTRY_SEPARATOR;
+	crc = ~crc;
+	for (size_t i=0;i<pair.size();i++)
+	{
+		crc ^= (unsigned char)pair[i];
+		for (int bit=0;bit<8;bit++)
+		{
+			crc = (crc>>1) ^ (0xEDB88320 & (0-(crc&1)));
+		}
+	}
+	return ~crc;
+}
+
+static string EepromStringParameter(vDUT_ID dutID, const char *paramName)
+{
+	char value[MAX_BUFFER_SIZE] = {'\0'};
+	if (vDUT_ERR_OK!=::vDUT_GetStringParameter(dutID, (vDUT_STR)paramName, value, MAX_BUFFER_SIZE))
+	{
+		value[0] = '\0';
+	}
+	else
+	{
+		// do nothing
+	}
+	return value;
+}
+
+// Writes the dirty entries, returns the number written; *dutWriteCalls and *durationInMiniSec get the DUT calls
+static vDUT_RETURN EepromFlush(vDUT_ID dutID, int *flushed, int *dutWriteCalls, double *durationInMiniSec)
+{
+	vDUT_RETURN ret = vDUT_ERR_OK;
+	vDUT_EEPROM_CACHE &cache = g_eepromCache[dutID];
+	double duration = 0;
+
+	*flushed = 0;
+	*dutWriteCalls = 0;
+	*durationInMiniSec = 0;
+
+	string batch;
+	for (map<string, vDUT_EEPROM_ENTRY>::iterator entry_Iter=cache.entries.begin(); entry_Iter!=cache.entries.end(); entry_Iter++)
+	{
+		if (entry_Iter->second.dirty)
+		{
+			batch += entry_Iter->first + "=" + entry_Iter->second.value + EEPROM_CACHE_ENTRY_SEPARATOR;
+			(*flushed)++;
+		}
+		else
+		{
+			// do nothing
+		}
+	}
+	if (0==*flushed)
+	{
+		return ret;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	if (DutFunctionInstalled(dutID, "WRITE_EEPROM_BATCH"))
+	{
+		::vDUT_ClearParameters(dutID);
+		::vDUT_AddStringParameter (dutID, "ENTRIES", (vDUT_STR)batch.c_str());
+		::vDUT_AddIntegerParameter(dutID, "COUNT",   *flushed);
+		ret = RunDutFunction(dutID, "WRITE_EEPROM_BATCH", &duration);
+		*dutWriteCalls = 1;
+		*durationInMiniSec = duration;
+	}
+	else
+	{
+		for (map<string, vDUT_EEPROM_ENTRY>::iterator entry_Iter=cache.entries.begin(); entry_Iter!=cache.entries.end() && vDUT_ERR_OK==ret; entry_Iter++)
+		{
+			if (entry_Iter->second.dirty)
+			{
+				::vDUT_ClearParameters(dutID);
+				::vDUT_AddStringParameter (dutID, "ADDRESS", (vDUT_STR)entry_Iter->first.c_str());
+				::vDUT_AddStringParameter (dutID, "VALUE",   (vDUT_STR)entry_Iter->second.value.c_str());
+				::vDUT_AddIntegerParameter(dutID, "LENGTH",  entry_Iter->second.length);
+				::vDUT_AddStringParameter (dutID, "FILE",    "");
+				ret = RunDutFunction(dutID, "WRITE_EEPROM", &duration);
+				(*dutWriteCalls)++;
+				*durationInMiniSec += duration;
+			}
+			else
+			{
+				// do nothing
+			}
+		}
+	}
+	::vDUT_ClearParameters(dutID);
+
+	if (vDUT_ERR_OK==ret)
+	{
+		for (map<string, vDUT_EEPROM_ENTRY>::iterator entry_Iter=cache.entries.begin(); entry_Iter!=cache.entries.end(); entry_Iter++)
+		{
+			entry_Iter->second.dirty = false;
+		}
+	}
+	else
+	{
+		// The entries stay dirty, the next FINALIZE_EEPROM writes them again
+	}
+
+	return ret;
+}
+
+static vDUT_RETURN EepromWrite(vDUT_ID dutID)
+{
+	vDUT_EEPROM_CACHE &cache = g_eepromCache[dutID];
+
+	string address = EepromStringParameter(dutID, "ADDRESS");
+	string file    = EepromStringParameter(dutID, "FILE");
+	if ( address.empty() || !file.empty() )
+	{
+		// A file write is not cached; the staged entries go first, so the DUT sees the writes in order
+		int flushed = 0, dutWriteCalls = 0;
+		double duration = 0;
+		string value = EepromStringParameter(dutID, "VALUE");
+		int length = 0;
+		::vDUT_GetIntegerParameter(dutID, "LENGTH", &length);
+
+		vDUT_RETURN ret = EepromFlush(dutID, &flushed, &dutWriteCalls, &duration);
+		if (vDUT_ERR_OK!=ret)
+		{
+			return ret;
+		}
+		else
+		{
+			::vDUT_AddStringParameter (dutID, "ADDRESS", (vDUT_STR)address.c_str());
+			::vDUT_AddStringParameter (dutID, "VALUE",   (vDUT_STR)value.c_str());
+			::vDUT_AddIntegerParameter(dutID, "LENGTH",  length);
+			::vDUT_AddStringParameter (dutID, "FILE",    (vDUT_STR)file.c_str());
+			cache.entries.clear();		// the file may overwrite any address
+			return RunDutFunction(dutID, "WRITE_EEPROM", &duration);
+		}
+	}
+	else
+	{
+		// do nothing
+	}
+
+	vDUT_EEPROM_ENTRY &entry = cache.entries[address];
+	entry.value  = EepromStringParameter(dutID, "VALUE");
+	entry.length = 0;
+	::vDUT_GetIntegerParameter(dutID, "LENGTH", &entry.length);
+	entry.dirty  = true;
+	cache.stagedWrites++;
+
+	::vDUT_ClearReturns(dutID);
+	::vDUT_AddStringReturn(dutID, "EEPROM_RETURN", (vDUT_STR)entry.value.c_str());
+	::LOGGER_Write_Ext(LOG_IQLITE_VDUT, g_vDutLoggerID[dutID], LOGGER_INFORMATION, "[vDut]=>EEPROM cache staged %s=%s\n", address.c_str(), entry.value.c_str());
+
+	return vDUT_ERR_OK;
+}
+
+static vDUT_RETURN EepromRead(vDUT_ID dutID)
+{
+	vDUT_EEPROM_CACHE &cache = g_eepromCache[dutID];
+	double duration = 0;
+
+	string address = EepromStringParameter(dutID, "ADDRESS");
+	string file    = EepromStringParameter(dutID, "FILE");
+	map<string, vDUT_EEPROM_ENTRY>::iterator entry_Iter = cache.entries.find(address);
+	if ( file.empty() && entry_Iter!=cache.entries.end() )
+	{
+		cache.readHits++;
+		::vDUT_ClearReturns(dutID);
+		::vDUT_AddStringReturn(dutID, "EEPROM_RETURN", (vDUT_STR)entry_Iter->second.value.c_str());
+		return vDUT_ERR_OK;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	vDUT_RETURN ret = RunDutFunction(dutID, "READ_EEPROM", &duration);
+	char value[MAX_BUFFER_SIZE] = {'\0'};
+	if ( vDUT_ERR_OK==ret && !address.empty() && file.empty() &&
+		 vDUT_ERR_OK==::vDUT_GetStringReturn(dutID, "EEPROM_RETURN", value, MAX_BUFFER_SIZE) )
+	{
+		vDUT_EEPROM_ENTRY &entry = cache.entries[address];
+		entry.value  = value;
+		entry.length = 0;
+		::vDUT_GetIntegerParameter(dutID, "LENGTH", &entry.length);
+		entry.dirty  = false;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	return ret;
+}
+
+static vDUT_RETURN EepromFinalize(vDUT_ID dutID)
+{
+	vDUT_EEPROM_CACHE &cache = g_eepromCache[dutID];
+	char   errorMessage[MAX_BUFFER_SIZE] = {'\0'};
+	char   finalizeReturn[MAX_BUFFER_SIZE] = {'\0'};
+	int    flushed = 0, dutWriteCalls = 0;
+	double flushDuration = 0, duration = 0;
+
+	map<string, vDUT_EEPROM_ENTRY> written;
+	for (map<string, vDUT_EEPROM_ENTRY>::iterator entry_Iter=cache.entries.begin(); entry_Iter!=cache.entries.end(); entry_Iter++)
+	{
+		if (entry_Iter->second.dirty)
+		{
+			written.insert(*entry_Iter);
+		}
+		else
+		{
+			// do nothing
+		}
+	}
+
+	vDUT_RETURN ret = EepromFlush(dutID, &flushed, &dutWriteCalls, &flushDuration);
+	if (vDUT_ERR_OK!=ret)
+	{
+		sprintf_s(errorMessage, MAX_BUFFER_SIZE, "[vDut] EEPROM cache failed to write %d staged entries.\n", flushed);
+	}
+	else
+	{
+		// The only commit of the run
+		ret = RunDutFunction(dutID, "FINALIZE_EEPROM", &duration);
+		if (vDUT_ERR_OK!=ret)
+		{
+			::vDUT_GetStringReturn(dutID, "ERROR_MESSAGE", errorMessage, MAX_BUFFER_SIZE);
+		}
+		else
+		{
+			::vDUT_GetStringReturn(dutID, "EEPROM_RETURN", finalizeReturn, MAX_BUFFER_SIZE);
+		}
+	}
+
+	// Checksum readback of what was written
+	unsigned int writtenChecksum = 0, readbackChecksum = 0;
+	for (map<string, vDUT_EEPROM_ENTRY>::iterator entry_Iter=written.begin(); entry_Iter!=written.end(); entry_Iter++)
+	{
+		writtenChecksum = EepromChecksum(writtenChecksum, entry_Iter->first, entry_Iter->second.value);
+	}
+	if ( vDUT_ERR_OK==ret && !written.empty() && DutFunctionInstalled(dutID, "READ_EEPROM") )
+	{
+		for (map<string, vDUT_EEPROM_ENTRY>::iterator entry_Iter=written.begin(); entry_Iter!=written.end() && vDUT_ERR_OK==ret; entry_Iter++)
+		{
+			char value[MAX_BUFFER_SIZE] = {'\0'};
+			::vDUT_ClearParameters(dutID);
+			::vDUT_AddStringParameter (dutID, "ADDRESS", (vDUT_STR)entry_Iter->first.c_str());
+			::vDUT_AddIntegerParameter(dutID, "LENGTH",  entry_Iter->second.length);
+			::vDUT_AddStringParameter (dutID, "FILE",    "");
+			ret = RunDutFunction(dutID, "READ_EEPROM", &duration);
+			if (vDUT_ERR_OK==ret)
+			{
+				::vDUT_GetStringReturn(dutID, "EEPROM_RETURN", value, MAX_BUFFER_SIZE);
+				readbackChecksum = EepromChecksum(readbackChecksum, entry_Iter->first, value);
+				if ( '\0'==errorMessage[0] && EepromNormalize(value)!=EepromNormalize(entry_Iter->second.value) )
+				{
+					sprintf_s(errorMessage, MAX_BUFFER_SIZE, "[vDut] EEPROM readback of %s is %s, %s was written.\n", entry_Iter->first.c_str(), value, entry_Iter->second.value.c_str());
+				}
+				else
+				{
+					// do nothing
+				}
+			}
+			else
+			{
+				sprintf_s(errorMessage, MAX_BUFFER_SIZE, "[vDut] EEPROM readback of %s failed.\n", entry_Iter->first.c_str());
+			}
+		}
+		::vDUT_ClearParameters(dutID);
+		if ( vDUT_ERR_OK==ret && writtenChecksum!=readbackChecksum )
+		{
+			ret = vDUT_ERR_DUT_FUNCTION_ERROR;
+		}
+		else
+		{
+			// do nothing
+		}
+	}
+	else
+	{
+		readbackChecksum = writtenChecksum;		// nothing to read back
+	}
+
+	// Without the cache every staged WRITE_EEPROM would have been a DUT write
+	int    writesSaved  = cache.stagedWrites-dutWriteCalls;
+	double flushSeconds = flushDuration/1000.0;
+	if (writesSaved<0)
+	{
+		writesSaved = 0;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	::vDUT_ClearReturns(dutID);
+	::vDUT_AddStringReturn (dutID, "EEPROM_RETURN",         finalizeReturn);
+	::vDUT_AddIntegerReturn(dutID, "EEPROM_STAGED_WRITES",  cache.stagedWrites);
+	::vDUT_AddIntegerReturn(dutID, "EEPROM_DUT_WRITES",     dutWriteCalls);
+	::vDUT_AddIntegerReturn(dutID, "EEPROM_DUT_WRITES_SAVED", writesSaved);
+	::vDUT_AddDoubleReturn (dutID, "EEPROM_FLUSH_TIME",       flushSeconds);
+	::vDUT_AddIntegerReturn(dutID, "EEPROM_CHECKSUM",       (int)readbackChecksum);
+	if ('\0'!=errorMessage[0])
+	{
+		::vDUT_AddStringReturn(dutID, "ERROR_MESSAGE", errorMessage);
+		ret = (vDUT_ERR_OK==ret) ? vDUT_ERR_DUT_FUNCTION_ERROR : ret;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	::LOGGER_Write_Ext(LOG_IQLITE_VDUT, g_vDutLoggerID[dutID], LOGGER_INFORMATION,
+					   "[vDut]=>EEPROM cache: %d writes staged, %d entries in %d DUT writes (%.2f s), %d DUT writes saved, %d read hits, checksum 0x%08X\n",
+					   cache.stagedWrites, flushed, dutWriteCalls, flushSeconds, writesSaved, cache.readHits, readbackChecksum);
+
+	if (vDUT_ERR_OK==ret)
+	{
+		cache.stagedWrites = 0;
+		cache.readHits     = 0;
+	}
+	else
+	{
+		// do nothing
+	}
+
+	return ret;
+}
+
+// Called by vDUT_Run(), true if the cache ran the function; *ret then has its result
+bool EepromCache_Run(vDUT_ID dutID, const char *functionName, vDUT_RETURN *ret)
+{
+	vDUT_EEPROM_CACHE &cache = g_eepromCache[dutID];
+	string function = functionName;
+
+	if ( "INSERT_DUT"==function || "REMOVE_DUT"==function )
+	{
+		// Another DUT, nothing of the cache applies to it
+		int dirty = 0;
+		for (map<string, vDUT_EEPROM_ENTRY>::iterator entry_Iter=cache.entries.begin(); entry_Iter!=cache.entries.end(); entry_Iter++)
+		{
+			dirty += entry_Iter->second.dirty ? 1 : 0;
+		}
+		if (0<dirty)
+		{
+			::LOGGER_Write_Ext(LOG_IQLITE_VDUT, g_vDutLoggerID[dutID], LOGGER_WARNING, "[vDut]=>EEPROM cache dropped %d staged entries, FINALIZE_EEPROM did not run.\n", dirty);
+		}
+		else
+		{
+			// do nothing
+		}
+		cache.entries.clear();
+		cache.stagedWrites = 0;
+		cache.readHits     = 0;
+		return false;
+	}
+	else if (!cache.enabled)
+	{
+		return false;
+	}
+	else if ( "WRITE_EEPROM"==function && DutFunctionInstalled(dutID, "WRITE_EEPROM") )
+	{
+		*ret = EepromWrite(dutID);
+		return true;
+	}
+	else if ( "READ_EEPROM"==function && DutFunctionInstalled(dutID, "READ_EEPROM") )
+	{
+		*ret = EepromRead(dutID);
+		return true;
+	}
+	else if ( "FINALIZE_EEPROM"==function && DutFunctionInstalled(dutID, "FINALIZE_EEPROM") )
+	{
+		*ret = EepromFinalize(dutID);
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+vDUT_API vDUT_RETURN vDUT_EnableEepromCache(vDUT_ID dutID, int enable)
+{
+	if ( dutID<0 || dutID>=MAX_TECHNOLOGIES_COUNT )
+	{
+		return vDUT_ERR_INVALID_DUT_ID;
+	}
+	else if ( g_eepromCache[dutID].enabled && !enable )
+	{
+		// The staged entries are written, without a commit
+		int flushed = 0, dutWriteCalls = 0;
+		double duration = 0;
+		vDUT_RETURN ret = EepromFlush(dutID, &flushed, &dutWriteCalls, &duration);
+		g_eepromCache[dutID].enabled = 0;
+		g_eepromCache[dutID].entries.clear();
+		return ret;
+	}
+	else
+	{
+		g_eepromCache[dutID].enabled = enable ? 1 : 0;
+	}
+
+	return vDUT_ERR_OK;
+}